@@ -42,6 +42,10 @@ namespace Common
 #include <pwd.h>
 #include <grp.h>
 #include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
 #include <signal.h>
 #include "PAL.h" // from prod/src/inc/clr
 
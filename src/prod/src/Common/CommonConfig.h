@@ -64,6 +64,10 @@ namespace Common
         DEPRECATED_CONFIG_ENTRY(uint, L"Common", EventLoopConcurrency, 0, Common::ConfigEntryUpgradePolicy::Static);
         // Cleanup delay for fd context used in event loop
         DEPRECATED_CONFIG_ENTRY(Common::TimeSpan, L"Common", EventLoopCleanupDelay, Common::TimeSpan::FromSeconds(120), Common::ConfigEntryUpgradePolicy::Static, Common::TimeSpanGreaterThan(Common::TimeSpan::Zero));
+        // Use io_uring instead of epoll for readiness notification in event loops, linux only. Sockets are still read and written by the callbacks. Falls back to epoll when the kernel does not support io_uring
+        INTERNAL_CONFIG_ENTRY(bool, L"Common", EventLoopUseIoUring, false, Common::ConfigEntryUpgradePolicy::Static);
+        // Submission queue size of each io_uring event loop
+        INTERNAL_CONFIG_ENTRY(uint, L"Common", EventLoopIoUringEntries, 256, Common::ConfigEntryUpgradePolicy::Static, Common::InRange<uint>(8, 4096));
 #endif
         // Switch to support upgrade and downgrade scenarios without trace loss for transitioning into Structured traces in linux using config upgrade
         // TODO - remove after transition to structured traces is complete
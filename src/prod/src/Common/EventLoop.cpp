@@ -24,6 +24,22 @@ namespace
         defaultPool = new EventLoopPool(L"Default");
         return TRUE;
     }
+
+    // io_uring polls are always one shot and level triggered
+    uint PollEvents(uint events)
+    {
+        return events & ~(EPOLLONESHOT | EPOLLET);
+    }
+
+    bool IsOpSupported(io_uring_probe const * probe, uint8_t op)
+    {
+        return (op < probe->ops_len) && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    int IoUringEnter(int ringFd, uint toSubmit, uint minComplete, uint flags)
+    {
+        return syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0);
+    }
 }
 
 EventLoopPool* EventLoopPool::GetDefault()
@@ -39,7 +55,7 @@ EventLoopPool* EventLoopPool::GetDefault()
     return defaultPool; 
 }
 
-EventLoopPool::EventLoopPool(wstring const & tag, uint concurrency)
+EventLoopPool::EventLoopPool(wstring const & tag, uint concurrency, EventLoop::Backend backend)
     : id_(tag.empty()? wformatString("{0}", TextTraceThis) : wformatString("{0}.{1}", tag, TextTraceThis))
     , assignmentIndex_(0)
 {
@@ -61,8 +77,15 @@ EventLoopPool::EventLoopPool(wstring const & tag, uint concurrency)
     pool_.reserve(concurrency);
     for(uint i = 0; i < concurrency; ++i)
     {
-        pool_.emplace_back(make_unique<EventLoop>());
+        pool_.emplace_back(make_unique<EventLoop>(backend));
     }
+
+    EventLoopPool::WriteInfo(TracePool, id_, "created: useIoUring = {0}", ActiveBackend() == EventLoop::Backend::IoUring);
+}
+
+EventLoop::Backend EventLoopPool::ActiveBackend() const
+{
+    return pool_.front()->ActiveBackend();
 }
 
 void EventLoopPool::SetSchedParam(int policy, int priority)
@@ -120,6 +143,10 @@ public:
     void FireEvent(uint event);
     void Close(bool waitForCallback);
 
+    // io_uring only: at most one poll is outstanding per context, like a one shot epoll registration
+    bool TryArm();
+    void Disarm();
+
     void WriteTo(Common::TextWriter & w, Common::FormatOptions const &) const;
 
 private:
@@ -131,10 +158,23 @@ private:
     const Callback cb_;
     const bool dispatchEventAsync_;
     std::atomic_int cbRunning_ {1};
+    std::atomic_bool pollArmed_ {false};
     ManualResetEvent closedEvent_;
 };
 
-EventLoop::EventLoop() : id_(wformatString("{0}", TextTraceThis)), fdMapSize_(0)
+EventLoop::EventLoop(Backend backend)
+    : id_(wformatString("{0}", TextTraceThis))
+    , backend_(backend)
+    , epfd_(-1)
+    , ringFd_(-1)
+    , ringClosed_(false)
+    , sqRing_(nullptr)
+    , sqRingSize_(0)
+    , cqRing_(nullptr)
+    , cqRingSize_(0)
+    , sqes_(nullptr)
+    , sqesSize_(0)
+    , fdMapSize_(0)
 {
     Setup();
 }
@@ -146,9 +186,23 @@ EventLoop::~EventLoop()
 
 void EventLoop::Setup()
 {
-    epfd_ = epoll_create1(EPOLL_CLOEXEC);
-    ASSERT_IF(epfd_ < 0, "epoll_create failed: {0}", errno);
-    reportList_.resize(eventListCapacity);
+    if (backend_ == Backend::Default)
+    {
+        backend_ = CommonConfig::GetConfig().EventLoopUseIoUring ? Backend::IoUring : Backend::Epoll;
+    }
+
+    if ((backend_ == Backend::IoUring) && !SetupIoUring())
+    {
+        CleanupIoUring();
+        backend_ = Backend::Epoll;
+    }
+
+    if (backend_ == Backend::Epoll)
+    {
+        epfd_ = epoll_create1(EPOLL_CLOEXEC);
+        ASSERT_IF(epfd_ < 0, "epoll_create failed: {0}", errno);
+        reportList_.resize(eventListCapacity);
+    }
 
     pthread_attr_t pthreadAttr;
     Invariant(pthread_attr_init(&pthreadAttr) == 0);
@@ -158,6 +212,121 @@ void EventLoop::Setup()
     pthread_attr_destroy(&pthreadAttr);
 }
 
+bool EventLoop::SetupIoUring()
+{
+    io_uring_params params = {};
+    ringFd_ = syscall(__NR_io_uring_setup, CommonConfig::GetConfig().EventLoopIoUringEntries, &params);
+    if (ringFd_ < 0)
+    {
+        WriteWarning(TraceLoop, id_, "io_uring_setup failed: {0}, falling back to epoll", errno);
+        return false;
+    }
+
+    // a poll armed by Activate must not be lost when the completion queue overflows
+    if (!(params.features & IORING_FEAT_NODROP))
+    {
+        WriteWarning(TraceLoop, id_, "io_uring does not support IORING_FEAT_NODROP, falling back to epoll");
+        return false;
+    }
+
+    vector<char> probeBuffer(sizeof(io_uring_probe) + (IORING_OP_LAST * sizeof(io_uring_probe_op)), 0);
+    auto probe = reinterpret_cast<io_uring_probe*>(probeBuffer.data());
+    if ((syscall(__NR_io_uring_register, ringFd_, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) < 0) ||
+        !IsOpSupported(probe, IORING_OP_POLL_ADD) ||
+        !IsOpSupported(probe, IORING_OP_POLL_REMOVE))
+    {
+        WriteWarning(TraceLoop, id_, "io_uring does not support poll operations, falling back to epoll");
+        return false;
+    }
+
+    sqRingSize_ = params.sq_off.array + (params.sq_entries * sizeof(uint));
+    cqRingSize_ = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+    bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap)
+    {
+        sqRingSize_ = cqRingSize_ = __max(sqRingSize_, cqRingSize_);
+    }
+
+    auto mapped = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+    if (mapped == MAP_FAILED)
+    {
+        WriteWarning(TraceLoop, id_, "io_uring submission queue mmap failed: {0}, falling back to epoll", errno);
+        return false;
+    }
+
+    sqRing_ = mapped;
+
+    if (singleMmap)
+    {
+        cqRing_ = sqRing_;
+    }
+    else
+    {
+        mapped = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_CQ_RING);
+        if (mapped == MAP_FAILED)
+        {
+            WriteWarning(TraceLoop, id_, "io_uring completion queue mmap failed: {0}, falling back to epoll", errno);
+            return false;
+        }
+
+        cqRing_ = mapped;
+    }
+
+    sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    mapped = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES);
+    if (mapped == MAP_FAILED)
+    {
+        WriteWarning(TraceLoop, id_, "io_uring submission queue entries mmap failed: {0}, falling back to epoll", errno);
+        return false;
+    }
+
+    sqes_ = (io_uring_sqe*)mapped;
+
+    auto sq = (char*)sqRing_;
+    sqHead_ = (uint*)(sq + params.sq_off.head);
+    sqTail_ = (uint*)(sq + params.sq_off.tail);
+    sqMask_ = *(uint*)(sq + params.sq_off.ring_mask);
+    sqEntries_ = *(uint*)(sq + params.sq_off.ring_entries);
+    sqArray_ = (uint*)(sq + params.sq_off.array);
+
+    auto cq = (char*)cqRing_;
+    cqHead_ = (uint*)(cq + params.cq_off.head);
+    cqTail_ = (uint*)(cq + params.cq_off.tail);
+    cqMask_ = *(uint*)(cq + params.cq_off.ring_mask);
+    cqes_ = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    WriteInfo(TraceLoop, id_, "io_uring created: sq_entries = {0}, cq_entries = {1}", params.sq_entries, params.cq_entries);
+    return true;
+}
+
+void EventLoop::CleanupIoUring()
+{
+    if (sqes_)
+    {
+        munmap(sqes_, sqesSize_);
+        sqes_ = nullptr;
+    }
+
+    if (cqRing_ && (cqRing_ != sqRing_))
+    {
+        munmap(cqRing_, cqRingSize_);
+    }
+
+    cqRing_ = nullptr;
+
+    if (sqRing_)
+    {
+        munmap(sqRing_, sqRingSize_);
+        sqRing_ = nullptr;
+    }
+
+    if (ringFd_ >= 0)
+    {
+        close(ringFd_);
+        ringFd_ = -1;
+    }
+}
+
 void EventLoop::SetSchedParam(int policy, int priority)
 {
     sched_param param = { priority };
@@ -177,7 +346,16 @@ void EventLoop::SetSchedParam(int policy, int priority)
 
 void* EventLoop::PthreadFunc(void *arg)
 {
-    ((EventLoop*)arg)->Loop();
+    auto loop = (EventLoop*)arg;
+    if (loop->backend_ == Backend::IoUring)
+    {
+        loop->LoopIoUring();
+    }
+    else
+    {
+        loop->Loop();
+    }
+
     return nullptr;
 }
 
@@ -238,9 +416,148 @@ void EventLoop::Loop()
     WriteInfo(TraceLoop, id_,"event loop ended");
 }
 
+uint EventLoop::PendingSubmissionCount() const
+{
+    return __atomic_load_n(sqTail_, __ATOMIC_ACQUIRE) - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+}
+
+void EventLoop::LoopIoUring()
+{
+    WriteInfo(TraceLoop, id_, "starting io_uring event loop");
+
+    for(;;)
+    {
+        // submits the polls re-armed while the previous batch was dispatched and waits for the next batch
+        auto entered = IoUringEnter(ringFd_, PendingSubmissionCount(), 1, IORING_ENTER_GETEVENTS);
+        if (entered < 0)
+        {
+            auto err = errno;
+            if (err == EINTR) continue;
+
+            if (ringClosed_)
+            {
+                // ringFd_ was closed by Cleanup, the descriptor number may even have been reused
+                WriteInfo(TraceLoop, id_, "io_uring_enter failed after ring is closed: {0}", err);
+                break;
+            }
+
+            // EBUSY means completions are backlogged in the kernel and EAGAIN that the kernel is short of
+            // memory for requests, reap completions before submitting more. Anything else leaves registered
+            // descriptors without notification, which must not go unnoticed
+            ASSERT_IF((err != EBUSY) && (err != EAGAIN), "io_uring_enter failed: {0}", err);
+        }
+
+        auto head = *cqHead_;
+        auto tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+
+        WriteNoise(
+            TraceLoop,
+            id_,
+            "io_uring_enter reported {0} completions on {1} registered descriptor(s)",
+            tail - head,
+            fdMapSize_);
+
+        for(; head != tail; ++head)
+        {
+            io_uring_cqe const & cqe = cqes_[head & cqMask_];
+            FdContext* fdc = (FdContext*)(cqe.user_data);
+            auto res = cqe.res;
+
+            // completions of IORING_OP_POLL_REMOVE carry no context, polls removed by UnregisterFd are cancelled
+            if ((fdc == nullptr) || (res == -ECANCELED)) continue;
+
+            fdc->Disarm();
+
+            uint evt = (res < 0) ? EPOLLERR : (uint)res;
+            auto errOrHup = IsFdClosedOrInError(evt);
+            WriteTrace(
+                errOrHup ? LogLevel::Info : LogLevel::Noise,
+                TraceLoop,
+                id_,
+                "events {0:x} reported on {1}, EPOLLIN={2},EPOLLOUT={3},EPOLLHUP={4},EPOLLERR={5}, res={6}",
+                evt,
+                *fdc,
+                bool(evt & EPOLLIN),
+                bool(evt & EPOLLOUT),
+                bool(evt & EPOLLHUP),
+                bool(evt & EPOLLERR),
+                res);
+
+            fdc->FireEvent(evt);
+        }
+
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+    }
+
+    WriteInfo(TraceLoop, id_,"event loop ended");
+}
+
+ErrorCode EventLoop::QueuePoll_CallerHoldingLock(uint8_t opcode, FdContext* fdc, uint events)
+{
+    ErrorCode error;
+    if (PendingSubmissionCount() == sqEntries_)
+    {
+        // submission queue is full, flush it before queueing more
+        if (SubmitPending_CallerHoldingLock() < 0)
+        {
+            error = ErrorCode::FromErrno();
+            WriteWarning(TraceLoop, id_, "io_uring_enter failed to flush submission queue: {0}", error);
+            return error;
+        }
+    }
+
+    auto tail = *sqTail_;
+    auto index = tail & sqMask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+
+    if (opcode == IORING_OP_POLL_ADD)
+    {
+        sqe->fd = fdc->Fd();
+        sqe->poll32_events = events;
+        sqe->user_data = (uint64)fdc;
+    }
+    else
+    {
+        // IORING_OP_POLL_REMOVE finds the poll by its user_data
+        sqe->fd = -1;
+        sqe->addr = (uint64)fdc;
+        sqe->user_data = 0;
+    }
+
+    sqArray_[index] = index;
+    __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+    return error;
+}
+
+int EventLoop::SubmitPending_CallerHoldingLock()
+{
+    auto pending = PendingSubmissionCount();
+    if (pending == 0) return 0;
+
+    int submitted;
+    do
+    {
+        submitted = IoUringEnter(ringFd_, pending, 0, 0);
+    } while ((submitted < 0) && (errno == EINTR));
+
+    return submitted;
+}
+
 void EventLoop::Cleanup()
 {
-    close(epfd_);
+    if (backend_ == Backend::IoUring)
+    {
+        // ring mappings are left in place, the detached loop thread may still be blocked in io_uring_enter
+        ringClosed_ = true;
+        close(ringFd_);
+    }
+    else
+    {
+        close(epfd_);
+    }
+
     fdMap_.clear();
     fdMapSize_ = fdMap_.size();
 }
@@ -254,6 +571,13 @@ EventLoop::FdContext* EventLoop::RegisterFd(int fd, uint events, bool dispatchEv
         auto inserted = fdMap_.emplace(make_pair(fd, ctx));
         fdMapSize_ = fdMap_.size();
         Invariant(inserted.second);
+
+        if (backend_ == Backend::IoUring)
+        {
+            // nothing to register with io_uring until Activate queues a poll
+            WriteInfo(TraceLoop, id_, "RegisterFd: ctx={0}", *ctx);
+            return ctx.get();
+        }
     
         epoll_event ev;
         ev.events = 0;
@@ -271,6 +595,11 @@ ErrorCode EventLoop::Activate(FdContext* fdc)
 {
     WriteNoise(TraceLoop, id_, "Activate({0})", *fdc);
 
+    if (backend_ == Backend::IoUring)
+    {
+        return ActivateIoUring(fdc);
+    }
+
     epoll_event ev = { .events = fdc->Events()};
     ev.data.ptr = fdc;
 
@@ -286,6 +615,39 @@ ErrorCode EventLoop::Activate(FdContext* fdc)
     return error;
 }
 
+ErrorCode EventLoop::ActivateIoUring(FdContext* fdc)
+{
+    if (!fdc->TryArm())
+    {
+        // a poll is already outstanding, same as EPOLL_CTL_MOD on an armed descriptor
+        return ErrorCode();
+    }
+
+    AcquireExclusiveLock grab(ringLock_);
+
+    auto error = QueuePoll_CallerHoldingLock(IORING_OP_POLL_ADD, fdc, PollEvents(fdc->Events()));
+    if (!error.IsSuccess())
+    {
+        fdc->Disarm();
+        return error;
+    }
+
+    // on the loop thread, the poll is submitted by the io_uring_enter that waits for the next batch
+    if (pthread_equal(pthread_self(), tid_))
+    {
+        return error;
+    }
+
+    if (SubmitPending_CallerHoldingLock() < 0)
+    {
+        // the poll stays queued and goes out with the next io_uring_enter
+        error = ErrorCode::FromErrno();
+        WriteWarning(TraceLoop, id_, "io_uring_enter failed to submit poll: {0}", error);
+    }
+
+    return error;
+}
+
 void EventLoop::UnregisterFd(FdContext* fdc, bool waitForCallback)
 {
     WriteInfo(TraceLoop, id_, "UnregisterFd({0}), waitForCallback={1}", *fdc, waitForCallback);
@@ -312,7 +674,18 @@ void EventLoop::UnregisterFd(FdContext* fdc, bool waitForCallback)
         fdMap_.erase(iter);
         fdMapSize_ = fdMap_.size();
 
-        epoll_ctl(epfd_, EPOLL_CTL_DEL, fdc->Fd(), nullptr);
+        if (backend_ == Backend::IoUring)
+        {
+            AcquireExclusiveLock grabRing(ringLock_);
+            if (QueuePoll_CallerHoldingLock(IORING_OP_POLL_REMOVE, fdc, 0).IsSuccess())
+            {
+                SubmitPending_CallerHoldingLock();
+            }
+        }
+        else
+        {
+            epoll_ctl(epfd_, EPOLL_CTL_DEL, fdc->Fd(), nullptr);
+        }
     }
 
     //Keep ctx alive a little longer in case an event is being or about to be reported
@@ -372,6 +745,16 @@ void EventLoop::FdContext::FireEvent(uint events)
     RunCallback(events);
 }
 
+bool EventLoop::FdContext::TryArm()
+{
+    return !pollArmed_.exchange(true);
+}
+
+void EventLoop::FdContext::Disarm()
+{
+    pollArmed_ = false;
+}
+
 void EventLoop::FdContext::RunCallback(uint events)
 {
     cb_(fd_, events);
@@ -12,7 +12,14 @@ namespace Common
     public:
         typedef std::function<void(int fd, uint event)> Callback;
 
-        EventLoop();
+        enum class Backend
+        {
+            Default, // EventLoopUseIoUring in CommonConfig decides
+            Epoll,
+            IoUring,
+        };
+
+        explicit EventLoop(Backend backend = Backend::Default);
         ~EventLoop();
 
         class FdContext;
@@ -25,6 +32,9 @@ namespace Common
 
         void SetSchedParam(int policy, int priority);
 
+        // the backend in use, which is Epoll when io_uring is requested but not supported
+        Backend ActiveBackend() const { return backend_; }
+
     private:
         typedef std::unordered_map<int, std::shared_ptr<FdContext>> FdMap;
 
@@ -33,9 +43,44 @@ namespace Common
         void Loop();
         static void* PthreadFunc(void*);
 
+        bool SetupIoUring();
+        void CleanupIoUring();
+        void LoopIoUring();
+        Common::ErrorCode ActivateIoUring(FdContext* fdc);
+        Common::ErrorCode QueuePoll_CallerHoldingLock(uint8_t opcode, FdContext* fdc, uint events);
+        int SubmitPending_CallerHoldingLock();
+        uint PendingSubmissionCount() const;
+
         Common::RwLock lock_;
         std::wstring id_;
+        Backend backend_;
         int epfd_;
+
+        // io_uring state, only used when backend_ is IoUring. The ring only replaces readiness notification:
+        // it carries IORING_OP_POLL_ADD/POLL_REMOVE and callbacks still do their own send/recv, so there are
+        // no data SQEs or registered buffers. Submission queue entries are filled under ringLock_; re-arms on
+        // the loop thread are left for the next io_uring_enter made by the loop, so a batch of completions is
+        // re-armed with the same system call that waits for the next batch
+        Common::ExclusiveLock ringLock_;
+        int ringFd_;
+        // set by Cleanup before ringFd_ is closed, io_uring_enter failing after that ends the loop
+        volatile bool ringClosed_;
+        void* sqRing_;
+        size_t sqRingSize_;
+        void* cqRing_;
+        size_t cqRingSize_;
+        io_uring_sqe* sqes_;
+        size_t sqesSize_;
+        uint* sqHead_;
+        uint* sqTail_;
+        uint sqMask_;
+        uint sqEntries_;
+        uint* sqArray_;
+        uint* cqHead_;
+        uint* cqTail_;
+        uint cqMask_;
+        io_uring_cqe* cqes_;
+
         pthread_t tid_;
         FdMap fdMap_;
         volatile size_t fdMapSize_;
@@ -47,13 +92,16 @@ namespace Common
     public:
         EventLoopPool(
             std::wstring const & tag = L"",
-            uint concurrency = 0);
+            uint concurrency = 0,
+            EventLoop::Backend backend = EventLoop::Backend::Default);
 
         EventLoop& Assign();
         void AssignPair(EventLoop** inLoop, EventLoop** outLoop);
 
         void SetSchedParam(int policy, int priority);
 
+        EventLoop::Backend ActiveBackend() const;
+
         static EventLoopPool* GetDefault(); 
 
     private:
@@ -8,7 +8,7 @@
 namespace TxnReplicator
 {
 
-#define TR_GLOBAL_SETTINGS_COUNT 10
+#define TR_GLOBAL_SETTINGS_COUNT 19
 #define TR_OVERRIDABLE_STATIC_SETTINGS_COUNT 9
 #define TR_OVERRIDABLE_DYNAMIC_SETTINGS_COUNT 11
 #define TR_OVERRIDABLE_SETTINGS_COUNT (TR_OVERRIDABLE_STATIC_SETTINGS_COUNT + TR_OVERRIDABLE_DYNAMIC_SETTINGS_COUNT)
@@ -78,6 +78,24 @@ namespace TxnReplicator
             int64 get_FlushedRecordsTraceVectorSize() const; \
             std::wstring get_DispatchingMode() const; \
             __declspec(property(get=get_DispatchingMode)) std::wstring DispatchingMode; \
+            __declspec(property(get=get_FlushLatencyTargetInMilliseconds)) int64 FlushLatencyTargetInMilliseconds; \
+            int64 get_FlushLatencyTargetInMilliseconds() const; \
+            __declspec(property(get=get_MaxFlushBatchSizeInKB)) int64 MaxFlushBatchSizeInKB; \
+            int64 get_MaxFlushBatchSizeInKB() const; \
+            __declspec(property(get=get_MaxFlushCoalescingDelayInMilliseconds)) int64 MaxFlushCoalescingDelayInMilliseconds; \
+            int64 get_MaxFlushCoalescingDelayInMilliseconds() const; \
+            __declspec(property(get=get_ReplicationCompressionCodec)) int64 ReplicationCompressionCodec; \
+            int64 get_ReplicationCompressionCodec() const; \
+            __declspec(property(get=get_MinCompressionSizeInBytes)) int64 MinCompressionSizeInBytes; \
+            int64 get_MinCompressionSizeInBytes() const; \
+            __declspec(property(get=get_BackupCompressionCodec)) int64 BackupCompressionCodec; \
+            int64 get_BackupCompressionCodec() const; \
+            __declspec(property(get=get_RestoreReadAheadSizeInKb)) int64 RestoreReadAheadSizeInKb; \
+            int64 get_RestoreReadAheadSizeInKb() const; \
+            __declspec(property(get=get_StoreValueCacheSizeInMB)) int64 StoreValueCacheSizeInMB; \
+            int64 get_StoreValueCacheSizeInMB() const; \
+            __declspec(property(get=get_StoreMappedReadBudgetInMB)) int64 StoreMappedReadBudgetInMB; \
+            int64 get_StoreMappedReadBudgetInMB() const; \
 
 #define DEFINE_GET_TR_CONFIG_METHOD() \
             void GetTransactionalReplicatorSettingsStructValues(TxnReplicator::TRConfigValues & config) const \
@@ -137,6 +155,15 @@ namespace TxnReplicator
             double test_LogDelayRatio_; \
             double test_LogDelayProcessExitRatio_; \
             std::wstring dispatchingMode_; \
+            int64 flushLatencyTargetInMilliseconds_; \
+            int64 maxFlushBatchSizeInKB_; \
+            int64 maxFlushCoalescingDelayInMilliseconds_; \
+            int64 replicationCompressionCodec_; \
+            int64 minCompressionSizeInBytes_; \
+            int64 backupCompressionCodec_; \
+            int64 restoreReadAheadSizeInKb_; \
+            int64 storeValueCacheSizeInMB_; \
+            int64 storeMappedReadBudgetInMB_; \
 
 /*ProgressVectorMaxEntires is set to the maximum number of records that can be traced*/
 #define TR_CONFIG_PROPERTIES(section_name)\
@@ -165,6 +192,15 @@ namespace TxnReplicator
             INTERNAL_CONFIG_ENTRY(uint, section_name, SerializationVersion, 0, Common::ConfigEntryUpgradePolicy::Static); \
             INTERNAL_CONFIG_ENTRY(bool, section_name, EnableIncrementalBackupsAcrossReplicas, false, Common::ConfigEntryUpgradePolicy::Static); \
             INTERNAL_CONFIG_ENTRY(std::wstring, section_name, DispatchingMode, L"", Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, FlushLatencyTargetInMilliseconds, 0, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, MaxFlushBatchSizeInKB, 4096, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, MaxFlushCoalescingDelayInMilliseconds, 2, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, ReplicationCompressionCodec, 0, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, MinCompressionSizeInBytes, 1024, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, BackupCompressionCodec, 0, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, RestoreReadAheadSizeInKb, 65536, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, StoreValueCacheSizeInMB, 0, Common::ConfigEntryUpgradePolicy::Static); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, StoreMappedReadBudgetInMB, 0, Common::ConfigEntryUpgradePolicy::Static); \
             TEST_CONFIG_ENTRY(std::wstring, section_name, Test_LoggingEngine, L"ktl", Common::ConfigEntryUpgradePolicy::NotAllowed); \
             TEST_CONFIG_ENTRY(uint, section_name, Test_LogMinDelayIntervalMilliseconds, 0, Common::ConfigEntryUpgradePolicy::Dynamic); \
             TEST_CONFIG_ENTRY(uint, section_name, Test_LogMaxDelayIntervalMilliseconds, 0, Common::ConfigEntryUpgradePolicy::Dynamic); \
@@ -198,6 +234,15 @@ namespace TxnReplicator
             INTERNAL_CONFIG_ENTRY(uint, section_name, FlushedRecordsTraceVectorSize, 32, Common::ConfigEntryUpgradePolicy::Static); \
             INTERNAL_CONFIG_ENTRY(Common::TimeSpan, section_name, TruncationInterval, Common::TimeSpan::FromSeconds(0), Common::ConfigEntryUpgradePolicy::Dynamic); \
             INTERNAL_CONFIG_ENTRY(std::wstring, section_name, DispatchingMode, L"", Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, FlushLatencyTargetInMilliseconds, 0, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, MaxFlushBatchSizeInKB, 4096, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, MaxFlushCoalescingDelayInMilliseconds, 2, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, ReplicationCompressionCodec, 0, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, MinCompressionSizeInBytes, 1024, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, BackupCompressionCodec, 0, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, RestoreReadAheadSizeInKb, 65536, Common::ConfigEntryUpgradePolicy::Dynamic); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, StoreValueCacheSizeInMB, 0, Common::ConfigEntryUpgradePolicy::Static); \
+            INTERNAL_CONFIG_ENTRY(uint, section_name, StoreMappedReadBudgetInMB, 0, Common::ConfigEntryUpgradePolicy::Static); \
             TEST_CONFIG_ENTRY(std::wstring, section_name, Test_LoggingEngine, L"ktl", Common::ConfigEntryUpgradePolicy::NotAllowed); \
             TEST_CONFIG_ENTRY(uint, section_name, Test_LogMinDelayIntervalMilliseconds, 0, Common::ConfigEntryUpgradePolicy::Dynamic); \
             TEST_CONFIG_ENTRY(uint, section_name, Test_LogMaxDelayIntervalMilliseconds, 0, Common::ConfigEntryUpgradePolicy::Dynamic); \
@@ -0,0 +1,121 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+using namespace Transport;
+using namespace Common;
+using namespace std;
+
+namespace
+{
+    // !!! Append only: the position of an action is its id on the wire, and the table size is the version !!!
+    // !!! advertised to peers. Do NOT delete, reorder or insert entries.                                 !!!
+    wchar_t const * const WellKnownActions[] =
+    {
+        // Federation
+        L"Ping",
+        L"LockRenew",
+        L"RoutingAck",
+        L"BroadcastAck",
+        L"MulticastAck",
+        L"EdgeProbe",
+        L"TokenProbe",
+        L"TokenEcho",
+        L"UpdateRequest",
+        L"UpdateReply",
+        L"VotePing",
+        L"VotePingReply",
+        L"VoteRenewRequest",
+        L"VoteRenewReply",
+        L"LivenessUpdate",
+        L"ArbitrateKeepAlive",
+
+        // Replication
+        L"ReplicationOperation",
+        L"ReplicationOperationBody",
+        L"ReplicationAck",
+        L"CopyOperation",
+        L"CopyContextOperation",
+        L"CopyContextAckAction",
+        L"StartCopy",
+        L"RequestAck",
+
+        // Transport
+        L"Reconnect",
+    };
+
+    uint16 const WellKnownActionCount = static_cast<uint16>(sizeof(WellKnownActions) / sizeof(WellKnownActions[0]));
+
+    unordered_map<wstring, uint16> CreateActionIdMap()
+    {
+        unordered_map<wstring, uint16> map;
+        for (uint16 i = 0; i < WellKnownActionCount; ++i)
+        {
+            auto inserted = map.emplace(WellKnownActions[i], i);
+            Invariant(inserted.second);
+        }
+
+        return map;
+    }
+}
+
+uint16 CompactHeaderEncoding::LocalVersion()
+{
+    return TransportConfig::GetConfig().CompactMessageHeadersEnabled ? WellKnownActionCount : 0;
+}
+
+bool CompactHeaderEncoding::TryGetActionId(wstring const & action, uint16 version, __out uint16 & actionId)
+{
+    static unordered_map<wstring, uint16> const actionIdMap = CreateActionIdMap();
+
+    auto iter = actionIdMap.find(action);
+    if ((iter == actionIdMap.cend()) || (iter->second >= version))
+    {
+        return false;
+    }
+
+    actionId = iter->second;
+    return true;
+}
+
+bool CompactHeaderEncoding::TryGetAction(uint16 actionId, __out wstring & action)
+{
+    if (actionId >= WellKnownActionCount)
+    {
+        return false;
+    }
+
+    action = WellKnownActions[actionId];
+    return true;
+}
+
+MessageHeaderId::Enum CompactHeaderEncoding::GetCompactId(MessageHeaderId::Enum id)
+{
+    switch (id)
+    {
+    case MessageHeaderId::Action: return MessageHeaderId::CompactAction;
+    case MessageHeaderId::Actor: return MessageHeaderId::CompactActor;
+    case MessageHeaderId::MessageId: return MessageHeaderId::CompactMessageId;
+    case MessageHeaderId::RelatesTo: return MessageHeaderId::CompactRelatesTo;
+    case MessageHeaderId::FabricActivity: return MessageHeaderId::CompactFabricActivity;
+    case MessageHeaderId::Timeout: return MessageHeaderId::CompactTimeout;
+    default: return MessageHeaderId::INVALID_SYSTEM_HEADER_ID;
+    }
+}
+
+bool CompactHeaderEncoding::TryGetEncodedId(MessageHeaderId::Enum compactId, __out MessageHeaderId::Enum & id)
+{
+    switch (compactId)
+    {
+    case MessageHeaderId::CompactAction: id = MessageHeaderId::Action; return true;
+    case MessageHeaderId::CompactActor: id = MessageHeaderId::Actor; return true;
+    case MessageHeaderId::CompactMessageId: id = MessageHeaderId::MessageId; return true;
+    case MessageHeaderId::CompactRelatesTo: id = MessageHeaderId::RelatesTo; return true;
+    case MessageHeaderId::CompactFabricActivity: id = MessageHeaderId::FabricActivity; return true;
+    case MessageHeaderId::CompactTimeout: id = MessageHeaderId::Timeout; return true;
+    default: return false;
+    }
+}
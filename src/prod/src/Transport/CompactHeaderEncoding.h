@@ -0,0 +1,45 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Transport
+{
+    //
+    // Fixed layout binary encodings of the hot transport headers. A compact header is written under its own
+    // MessageHeaderId, e.g. CompactAction, and is read back under the id of the header it encodes, so readers
+    // of MessageHeaders see an ordinary ActionHeader. Compact headers are only sent to peers that advertised a
+    // non-zero compact header version in their ListenInstance, see MessageHeaders::EncodeForPeer.
+    //
+    class CompactHeaderEncoding
+    {
+    public:
+        // Version advertised to peers: the number of well-known actions, or 0 when compact headers are disabled
+        static uint16 LocalVersion();
+
+        // Well-known actions are sent as their index in a static, append-only table. An action is only sent
+        // compact when its id is known to both sides, i.e. below the smaller of the two versions.
+        static bool TryGetActionId(std::wstring const & action, uint16 version, __out uint16 & actionId);
+        static bool TryGetAction(uint16 actionId, __out std::wstring & action);
+
+        // Returns INVALID_SYSTEM_HEADER_ID for headers that have no compact encoding
+        static MessageHeaderId::Enum GetCompactId(MessageHeaderId::Enum id);
+        static bool TryGetEncodedId(MessageHeaderId::Enum compactId, __out MessageHeaderId::Enum & id);
+
+#pragma pack(push, 1)
+        struct MessageIdBody
+        {
+            ::GUID Guid;
+            DWORD Index;
+        };
+
+        struct ActivityIdBody
+        {
+            ::GUID Guid;
+            uint64 Index;
+        };
+#pragma pack(pop)
+    };
+}
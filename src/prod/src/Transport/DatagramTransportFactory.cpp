@@ -53,3 +53,14 @@ IDatagramTransportSPtr DatagramTransportFactory::CreateUnreliable(
 {
     return make_shared<UnreliableTransport>(root, innerTransport);
 }
+
+#ifdef PLATFORM_UNIX
+
+IDatagramTransportSPtr DatagramTransportFactory::CreateSharedMemoryIpc(
+    IDatagramTransportSPtr const & innerTransport,
+    bool isServer)
+{
+    return make_shared<IpcSharedMemoryTransport>(innerTransport, isServer);
+}
+
+#endif
@@ -27,5 +27,12 @@ namespace Transport
         static IDatagramTransportSPtr CreateUnreliable(
             Common::ComponentRoot const & root,
             IDatagramTransportSPtr const & innerTransport);
+
+#ifdef PLATFORM_UNIX
+        // Carries IPC between processes on the same machine through shared memory, see IpcSharedMemoryTransport
+        static IDatagramTransportSPtr CreateSharedMemoryIpc(
+            IDatagramTransportSPtr const & innerTransport,
+            bool isServer);
+#endif
     };
 }
@@ -79,6 +79,7 @@ namespace Transport
         virtual size_t IncomingFrameSizeLimit() const = 0;
         virtual size_t OutgoingFrameSizeLimit() const = 0;
         virtual void OnRemoteFrameSizeLimit(size_t remoteIncomingMax) = 0;
+        virtual void OnRemoteCompactHeaderVersion(uint16 remoteVersion) = 0;
 
         virtual void PurgeExpiredOutgoingMessages(Common::StopwatchTime now) = 0;
 
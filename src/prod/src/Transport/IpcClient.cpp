@@ -23,6 +23,14 @@ namespace
     {
         IDatagramTransportSPtr transport = DatagramTransportFactory::CreateTcpClient(clientId, owner + L".IpcClient");
 
+#ifdef PLATFORM_UNIX
+        if (TransportConfig::GetConfig().IpcSharedMemoryEnabled)
+        {
+            IpcClient::WriteInfo(TraceType, "Shared memory transport client enabled for IPC");
+            transport = DatagramTransportFactory::CreateSharedMemoryIpc(transport, false);
+        }
+#endif
+
         //Support for Unreliable transport for request reply over IPC
         if (useUnreliableTransport && TransportConfig::GetConfig().UseUnreliableForRequestReply)
         {
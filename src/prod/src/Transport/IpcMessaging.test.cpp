@@ -87,6 +87,71 @@ namespace Transport
     }
 #endif
 
+#ifdef PLATFORM_UNIX
+    BOOST_AUTO_TEST_CASE(SharedMemoryNegotiateRequestReplyTest)
+    {
+        ENTER;
+
+        KFinally([this] { Cleanup(); });
+
+        auto & config = TransportConfig::GetConfig();
+        auto savedSharedMemoryEnabled = config.IpcSharedMemoryEnabled;
+        config.IpcSharedMemoryEnabled = true;
+        KFinally([&] { config.IpcSharedMemoryEnabled = savedSharedMemoryEnabled; });
+
+        // same security settings as the IpcServer of FabricNode and the IpcClient of ApplicationHost
+        auto& server = root_->server_;
+        std::wstring serverListenAddress = TTestUtil::GetListenAddress();
+        server = OpenServer(serverListenAddress, true);
+
+        bool lastRequestThroughSharedMemory = false;
+        server->RegisterMessageHandler(
+            serverSideActor_,
+            [&] (MessageUPtr &, IpcReceiverContextUPtr & context)
+            {
+                lastRequestThroughSharedMemory = IpcSharedMemoryTransport::IsSharedMemoryTarget(*context->ReplyTarget);
+                context->Reply(CreateServerMessage(clientSideActor_));
+            },
+            true/*dispatchOnTransportThread*/);
+
+        auto client = OpenClient(L"client0", serverListenAddress, true);
+        root_->clients_.push_back(client);
+
+        auto sendRequest = [&]
+        {
+            ManualResetEvent replied(false);
+            client->BeginRequest(
+                CreateClientMessage(serverSideActor_),
+                TimeSpan::FromSeconds(30),
+                [client, &replied] (AsyncOperationSPtr const & operation)
+                {
+                    MessageUPtr reply;
+                    ErrorCode endRequestErrorCode = client->EndRequest(operation, reply);
+                    VERIFY_IS_TRUE(endRequestErrorCode.IsSuccess());
+                    replied.Set();
+                },
+                Common::AsyncOperationSPtr());
+
+            VERIFY_IS_TRUE(replied.WaitOne(TimeSpan::FromSeconds(30)));
+            return lastRequestThroughSharedMemory;
+        };
+
+        // requests go through TCP until the server acknowledges the shared memory handshake
+        int tcpRequestCount = 0;
+        while (!sendRequest())
+        {
+            VERIFY_IS_TRUE(++ tcpRequestCount < 1000);
+        }
+
+        for (int i = 0; i < 10; ++ i)
+        {
+            VERIFY_IS_TRUE(sendRequest());
+        }
+
+        LEAVE;
+    }
+#endif
+
     BOOST_AUTO_TEST_CASE(InvalidAddressTest)
     {
         ENTER;
@@ -28,6 +28,14 @@ namespace
 
         auto transport = DatagramTransportFactory::CreateTcp(transportListenAddress, serverId, owner + L".IpcServer");
 
+#ifdef PLATFORM_UNIX
+        if (TransportConfig::GetConfig().IpcSharedMemoryEnabled)
+        {
+            IpcServer::WriteInfo(TraceType, "Shared memory transport server enabled for IPC");
+            transport = DatagramTransportFactory::CreateSharedMemoryIpc(transport, true);
+        }
+#endif
+
         //Support for Unreliable transport for request reply over IPC
         if (useUnreliableTransport && TransportConfig::GetConfig().UseUnreliableForRequestReply)
         {
@@ -0,0 +1,348 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#include <boost/test/unit_test.hpp>
+#include "Common/boost-taef.h"
+#include "TestCommon.h"
+
+namespace Transport
+{
+    using namespace Common;
+    using namespace std;
+
+    //
+    // Producer and consumer rings over the same region, the way the two processes of a channel see it
+    //
+    class IpcSharedMemoryRingTest
+    {
+    protected:
+        static const uint Capacity = 4096;
+
+        // ring control block layout: tail, then head, each on its own cache line
+        static const size_t TailOffset = 0;
+        static const size_t HeadOffset = 64;
+
+        IpcSharedMemoryRingTest()
+            : region_((IpcSharedMemoryRing::RegionSize(Capacity) + sizeof(uint64) - 1) / sizeof(uint64))
+            , producer_(region_.data(), Capacity)
+            , consumer_(region_.data(), Capacity)
+        {
+        }
+
+        static MessageUPtr CreateMessage(size_t bodySize)
+        {
+            auto message = make_unique<Message>(TestMessageBody(bodySize));
+            message->Headers.Add(ActorHeader(Actor::IpcTestActor1));
+            message->Headers.Add(MessageIdHeader());
+            message->Headers.CompactIfNeeded();
+            return message;
+        }
+
+        static void VerifyMessage(MessageUPtr & message, size_t bodySize)
+        {
+            VERIFY_IS_TRUE(message != nullptr);
+            VERIFY_IS_TRUE(message->Actor == Actor::IpcTestActor1);
+
+            TestMessageBody body;
+            VERIFY_IS_TRUE(message->GetBody(body));
+            VERIFY_ARE_EQUAL2(body.size(), bodySize);
+            VERIFY_IS_TRUE(body.Verify());
+        }
+
+        static vector<byte> Serialize(Message & message)
+        {
+            return IpcSharedMemoryRing::Serialize(message, message.SerializedHeaderSize(), message.SerializedBodySize());
+        }
+
+        bool TryWriteMessage(Message & message)
+        {
+            return producer_.TryWriteMessage(message, message.SerializedHeaderSize(), message.SerializedBodySize());
+        }
+
+        bool TryRead(__out MessageUPtr & message, __out ErrorCode & error, size_t maxMessageSize = 0)
+        {
+            message.reset();
+            error = ErrorCode();
+            return consumer_.TryRead(maxMessageSize, partial_, message, error);
+        }
+
+        uint64 & PublishedTail() { return *reinterpret_cast<uint64*>(reinterpret_cast<byte*>(region_.data()) + TailOffset); }
+        uint64 & PublishedHead() { return *reinterpret_cast<uint64*>(reinterpret_cast<byte*>(region_.data()) + HeadOffset); }
+
+        // the data area follows the control block
+        byte * Data() { return reinterpret_cast<byte*>(region_.data()) + IpcSharedMemoryRing::RegionSize(Capacity) - Capacity; }
+
+        vector<uint64> region_;
+        IpcSharedMemoryRing producer_;
+        IpcSharedMemoryRing consumer_;
+        vector<byte> partial_;
+    };
+
+    const uint IpcSharedMemoryRingTest::Capacity;
+    const size_t IpcSharedMemoryRingTest::TailOffset;
+    const size_t IpcSharedMemoryRingTest::HeadOffset;
+
+    BOOST_FIXTURE_TEST_SUITE2(IpcSharedMemoryRingTests, IpcSharedMemoryRingTest)
+
+    BOOST_AUTO_TEST_CASE(WriteAndRead)
+    {
+        ENTER;
+
+        MessageUPtr message;
+        ErrorCode error;
+        VERIFY_IS_FALSE(TryRead(message, error));
+
+        for (size_t bodySize : { 0, 1, 100, 1000 })
+        {
+            auto sent = CreateMessage(bodySize);
+            VERIFY_IS_TRUE(TryWriteMessage(*sent));
+
+            VERIFY_IS_TRUE(TryRead(message, error));
+            VERIFY_IS_TRUE(error.IsSuccess());
+            VerifyMessage(message, bodySize);
+            VERIFY_IS_TRUE(partial_.empty());
+        }
+
+        VERIFY_IS_FALSE(TryRead(message, error));
+
+        LEAVE;
+    }
+
+    BOOST_AUTO_TEST_CASE(FragmentationAndReassembly)
+    {
+        ENTER;
+
+        // several times the capacity, so it can only go through the ring in fragments
+        size_t const bodySize = 3 * Capacity;
+        auto sent = CreateMessage(bodySize);
+        VERIFY_IS_FALSE(TryWriteMessage(*sent));
+
+        auto payload = Serialize(*sent);
+        size_t offset = 0;
+        size_t fragmentCount = 0;
+        MessageUPtr message;
+        ErrorCode error;
+        while (!message)
+        {
+            size_t written = 0;
+            if (offset < payload.size())
+            {
+                VERIFY_IS_TRUE(producer_.WriteFragment(payload.data() + offset, payload.size() - offset, written).IsSuccess());
+                VERIFY_IS_TRUE(written > 0);
+                offset += written;
+                ++ fragmentCount;
+            }
+
+            VERIFY_IS_TRUE(TryRead(message, error));
+            VERIFY_IS_TRUE(error.IsSuccess());
+            VERIFY_ARE_EQUAL2(message == nullptr, offset < payload.size());
+        }
+
+        VERIFY_IS_TRUE(fragmentCount > 3);
+        VerifyMessage(message, bodySize);
+        VERIFY_IS_TRUE(partial_.empty());
+        VERIFY_IS_FALSE(TryRead(message, error));
+
+        // messages that fit still go in one record after reassembly
+        auto next = CreateMessage(100);
+        VERIFY_IS_TRUE(TryWriteMessage(*next));
+        VERIFY_IS_TRUE(TryRead(message, error));
+        VERIFY_IS_TRUE(error.IsSuccess());
+        VerifyMessage(message, 100);
+
+        LEAVE;
+    }
+
+    BOOST_AUTO_TEST_CASE(FullRingWaitAndWake)
+    {
+        ENTER;
+
+        size_t const bodySize = 3 * Capacity;
+        auto sent = CreateMessage(bodySize);
+        auto payload = Serialize(*sent);
+
+        // fill the ring
+        size_t offset = 0;
+        size_t written = 0;
+        do
+        {
+            VERIFY_IS_TRUE(producer_.WriteFragment(payload.data() + offset, payload.size() - offset, written).IsSuccess());
+            offset += written;
+        } while (written > 0);
+
+        VERIFY_IS_TRUE(offset < payload.size());
+        VERIFY_IS_FALSE(producer_.ShouldWakeConsumer());
+
+        // the producer goes to wait, reading a record frees space and wakes it up exactly once
+        VERIFY_IS_TRUE(producer_.PrepareProducerWait(payload.size() - offset));
+
+        MessageUPtr message;
+        ErrorCode error;
+        VERIFY_IS_TRUE(TryRead(message, error));
+        VERIFY_IS_TRUE(error.IsSuccess());
+        VERIFY_IS_TRUE(consumer_.ShouldWakeProducer());
+        VERIFY_IS_FALSE(consumer_.ShouldWakeProducer());
+
+        // space was freed before the producer went to wait again, so it must not wait
+        VERIFY_IS_FALSE(producer_.PrepareProducerWait(payload.size() - offset));
+
+        // the consumer drains the ring and goes to wait, records written afterwards wake it up exactly once
+        while (TryRead(message, error))
+        {
+            VERIFY_IS_TRUE(error.IsSuccess());
+            VERIFY_IS_TRUE(message == nullptr);
+        }
+
+        VERIFY_IS_TRUE(consumer_.PrepareConsumerWait());
+
+        while (offset < payload.size())
+        {
+            VERIFY_IS_TRUE(producer_.WriteFragment(payload.data() + offset, payload.size() - offset, written).IsSuccess());
+            VERIFY_IS_TRUE(written > 0);
+            offset += written;
+
+            VERIFY_IS_TRUE(producer_.ShouldWakeConsumer());
+            VERIFY_IS_FALSE(producer_.ShouldWakeConsumer());
+
+            // records arrived, so the consumer must not wait
+            VERIFY_IS_FALSE(consumer_.PrepareConsumerWait());
+
+            while (TryRead(message, error) && !message)
+            {
+                VERIFY_IS_TRUE(error.IsSuccess());
+            }
+
+            VERIFY_IS_TRUE(consumer_.PrepareConsumerWait());
+        }
+
+        VerifyMessage(message, bodySize);
+
+        LEAVE;
+    }
+
+    BOOST_AUTO_TEST_CASE(RejectInvalidProducerPosition)
+    {
+        ENTER;
+
+        MessageUPtr message;
+        ErrorCode error;
+
+        // tail beyond the capacity of the ring
+        PublishedTail() = Capacity + 8;
+        VERIFY_IS_TRUE(TryRead(message, error));
+        VERIFY_IS_TRUE(error.IsError(ErrorCodeValue::InvalidMessage));
+        VERIFY_IS_TRUE(message == nullptr);
+
+        // tail behind the head
+        PublishedTail() = 0;
+        auto sent = CreateMessage(100);
+        VERIFY_IS_TRUE(TryWriteMessage(*sent));
+        VERIFY_IS_TRUE(TryRead(message, error));
+        VERIFY_IS_TRUE(error.IsSuccess());
+
+        PublishedTail() = 8;
+        VERIFY_IS_TRUE(TryRead(message, error));
+        VERIFY_IS_TRUE(error.IsError(ErrorCodeValue::InvalidMessage));
+
+        LEAVE;
+    }
+
+    BOOST_AUTO_TEST_CASE(RejectInvalidConsumerPosition)
+    {
+        ENTER;
+
+        auto sent = CreateMessage(100);
+        VERIFY_IS_TRUE(TryWriteMessage(*sent));
+
+        // head beyond the tail of the producer
+        PublishedHead() = PublishedTail() + 8;
+
+        VERIFY_IS_FALSE(TryWriteMessage(*sent));
+
+        auto payload = Serialize(*sent);
+        size_t written = 0;
+        VERIFY_IS_TRUE(producer_.WriteFragment(payload.data(), payload.size(), written).IsError(ErrorCodeValue::InvalidMessage));
+        VERIFY_ARE_EQUAL2(written, 0u);
+        VERIFY_IS_FALSE(producer_.PrepareProducerWait(payload.size()));
+
+        LEAVE;
+    }
+
+    BOOST_AUTO_TEST_CASE(RejectInvalidRecordLength)
+    {
+        ENTER;
+
+        MessageUPtr message;
+        ErrorCode error;
+
+        for (uint length : { 0u, Capacity, numeric_limits<uint>::max() - 4 })
+        {
+            // a fresh ring for each case, the ring cannot be used after an error
+            fill(region_.begin(), region_.end(), 0);
+            IpcSharedMemoryRing producer(region_.data(), Capacity);
+            IpcSharedMemoryRing consumer(region_.data(), Capacity);
+
+            auto sent = CreateMessage(100);
+            VERIFY_IS_TRUE(producer.TryWriteMessage(*sent, sent->SerializedHeaderSize(), sent->SerializedBodySize()));
+
+            // the first field of the record header is the length
+            memcpy(Data(), &length, sizeof(length));
+
+            partial_.clear();
+            VERIFY_IS_TRUE(consumer.TryRead(0, partial_, message, error));
+            VERIFY_IS_TRUE(error.IsError(ErrorCodeValue::InvalidMessage));
+            VERIFY_IS_TRUE(message == nullptr);
+        }
+
+        // the payload does not add up to the sizes in its prefix
+        {
+            fill(region_.begin(), region_.end(), 0);
+            IpcSharedMemoryRing producer(region_.data(), Capacity);
+            IpcSharedMemoryRing consumer(region_.data(), Capacity);
+
+            auto sent = CreateMessage(100);
+            VERIFY_IS_TRUE(producer.TryWriteMessage(*sent, sent->SerializedHeaderSize(), sent->SerializedBodySize()));
+
+            // the body size follows the record header and the header size
+            uint bodySize = sent->SerializedBodySize() + 1;
+            memcpy(Data() + 3 * sizeof(uint), &bodySize, sizeof(bodySize));
+
+            partial_.clear();
+            VERIFY_IS_TRUE(consumer.TryRead(0, partial_, message, error));
+            VERIFY_IS_TRUE(error.IsError(ErrorCodeValue::InvalidMessage));
+            VERIFY_IS_TRUE(message == nullptr);
+        }
+
+        LEAVE;
+    }
+
+    BOOST_AUTO_TEST_CASE(RejectMessageTooLarge)
+    {
+        ENTER;
+
+        MessageUPtr message;
+        ErrorCode error;
+
+        auto sent = CreateMessage(1000);
+        VERIFY_IS_TRUE(TryWriteMessage(*sent));
+        VERIFY_IS_TRUE(TryRead(message, error, 100));
+        VERIFY_IS_TRUE(error.IsError(ErrorCodeValue::MessageTooLarge));
+
+        // fragments are rejected as soon as they add up to more than the limit
+        auto large = CreateMessage(3 * Capacity);
+        auto payload = Serialize(*large);
+        size_t written = 0;
+        VERIFY_IS_TRUE(producer_.WriteFragment(payload.data(), payload.size(), written).IsSuccess());
+        VERIFY_IS_TRUE(written < payload.size());
+        VERIFY_IS_TRUE(TryRead(message, error, 1000));
+        VERIFY_IS_TRUE(error.IsError(ErrorCodeValue::MessageTooLarge));
+
+        LEAVE;
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+}
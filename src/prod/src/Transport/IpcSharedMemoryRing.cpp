@@ -0,0 +1,331 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+using namespace Transport;
+using namespace Common;
+using namespace std;
+
+const size_t IpcSharedMemoryRing::CacheLineSize;
+const uint IpcSharedMemoryRing::LastFragment;
+const size_t IpcSharedMemoryRing::MinFragmentLength;
+
+IpcSharedMemoryRing::IpcSharedMemoryRing(void * region, uint capacity)
+    : control_(reinterpret_cast<ControlBlock*>(region))
+    , data_(reinterpret_cast<byte*>(region) + sizeof(ControlBlock))
+    , capacity_(capacity)
+    , mask_(capacity - 1)
+    , head_(0)
+    , tail_(0)
+{
+    static_assert(sizeof(std::atomic<uint64>) == sizeof(uint64), "ring positions must be lock free in shared memory");
+    Invariant(IsValidCapacity(capacity));
+}
+
+size_t IpcSharedMemoryRing::RegionSize(uint capacity)
+{
+    return sizeof(ControlBlock) + capacity;
+}
+
+bool IpcSharedMemoryRing::IsValidCapacity(uint capacity)
+{
+    return (capacity >= 2 * MinFragmentLength) && ((capacity & (capacity - 1)) == 0);
+}
+
+size_t IpcSharedMemoryRing::RecordSize(size_t payloadLength)
+{
+    return sizeof(RecordHeader) + ((payloadLength + 7) & ~size_t(7));
+}
+
+bool IpcSharedMemoryRing::IsValidRange(uint64 head, uint64 tail) const
+{
+    return (head <= tail) && (tail - head <= capacity_);
+}
+
+bool IpcSharedMemoryRing::TryGetFreeSpace(__out size_t & freeSpace) const
+{
+    // the consumer is in another process, its position is only trusted within the ring
+    uint64 head = control_->Head.load(std::memory_order_acquire);
+    if (!IsValidRange(head, tail_))
+    {
+        return false;
+    }
+
+    freeSpace = capacity_ - static_cast<size_t>(tail_ - head);
+    return true;
+}
+
+void IpcSharedMemoryRing::Publish(uint64 tail)
+{
+    tail_ = tail;
+    control_->Tail.store(tail, std::memory_order_release);
+}
+
+void IpcSharedMemoryRing::CopyIn(uint64 position, void const * source, size_t count)
+{
+    ASSERT_IF(count > capacity_, "copy of {0} bytes exceeds ring capacity {1}", count, capacity_);
+    auto offset = static_cast<size_t>(position & mask_);
+    auto first = std::min(count, capacity_ - offset);
+    memcpy(data_ + offset, source, first);
+    if (first < count)
+    {
+        memcpy(data_, reinterpret_cast<byte const*>(source) + first, count - first);
+    }
+}
+
+void IpcSharedMemoryRing::CopyOut(uint64 position, void * destination, size_t count) const
+{
+    ASSERT_IF(count > capacity_, "copy of {0} bytes exceeds ring capacity {1}", count, capacity_);
+    auto offset = static_cast<size_t>(position & mask_);
+    auto first = std::min(count, capacity_ - offset);
+    memcpy(destination, data_ + offset, first);
+    if (first < count)
+    {
+        memcpy(reinterpret_cast<byte*>(destination) + first, data_, count - first);
+    }
+}
+
+void IpcSharedMemoryRing::CopyOut(uint64 position, ByteBique & destination, size_t count) const
+{
+    ASSERT_IF(count > capacity_, "copy of {0} bytes exceeds ring capacity {1}", count, capacity_);
+    BiqueWriteStream stream(destination);
+    auto offset = static_cast<size_t>(position & mask_);
+    auto first = std::min(count, capacity_ - offset);
+    stream.WriteBytes(data_ + offset, first);
+    if (first < count)
+    {
+        stream.WriteBytes(data_, count - first);
+    }
+}
+
+bool IpcSharedMemoryRing::TryWriteMessage(Message & message, uint headerSize, uint bodySize)
+{
+    size_t payloadLength = sizeof(MessagePrefix) + headerSize + bodySize;
+    size_t freeSpace;
+    if (!TryGetFreeSpace(freeSpace) || (RecordSize(payloadLength) > freeSpace))
+    {
+        return false;
+    }
+
+    uint64 tail = tail_;
+
+    RecordHeader record = { static_cast<uint>(payloadLength), LastFragment };
+    CopyIn(tail, &record, sizeof(record));
+    uint64 position = tail + sizeof(record);
+
+    MessagePrefix prefix = { headerSize, bodySize };
+    CopyIn(position, &prefix, sizeof(prefix));
+    position += sizeof(prefix);
+
+    for (auto chunk = message.BeginHeaderChunks(); chunk != message.EndHeaderChunks(); ++chunk)
+    {
+        CopyIn(position, chunk->cbegin(), chunk->size());
+        position += chunk->size();
+    }
+
+    for (auto chunk = message.BeginBodyChunks(); chunk != message.EndBodyChunks(); ++chunk)
+    {
+        CopyIn(position, chunk->cbegin(), chunk->size());
+        position += chunk->size();
+    }
+
+    Publish(tail + RecordSize(payloadLength));
+    return true;
+}
+
+ErrorCode IpcSharedMemoryRing::WriteFragment(byte const * payload, size_t length, __out size_t & written)
+{
+    written = 0;
+
+    size_t freeSpace;
+    if (!TryGetFreeSpace(freeSpace))
+    {
+        return ErrorCodeValue::InvalidMessage;
+    }
+
+    // avoid slicing a message into many tiny records when the consumer is only slightly behind
+    if (freeSpace < sizeof(RecordHeader) + std::min(length, MinFragmentLength))
+    {
+        return ErrorCode();
+    }
+
+    // the record is padded to 8 bytes, which must fit in the free space as well
+    auto count = std::min(length, (freeSpace - sizeof(RecordHeader)) & ~size_t(7));
+    RecordHeader record = { static_cast<uint>(count), (count == length) ? LastFragment : 0 };
+    CopyIn(tail_, &record, sizeof(record));
+    CopyIn(tail_ + sizeof(record), payload, count);
+
+    Publish(tail_ + RecordSize(count));
+    written = count;
+    return ErrorCode();
+}
+
+bool IpcSharedMemoryRing::PrepareProducerWait(size_t length)
+{
+    control_->ProducerWaiting.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    size_t freeSpace;
+    return TryGetFreeSpace(freeSpace) && (freeSpace < sizeof(RecordHeader) + std::min(length, MinFragmentLength));
+}
+
+bool IpcSharedMemoryRing::ShouldWakeConsumer()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return control_->ConsumerWaiting.load(std::memory_order_relaxed) && control_->ConsumerWaiting.exchange(0);
+}
+
+vector<byte> IpcSharedMemoryRing::Serialize(Message & message, uint headerSize, uint bodySize)
+{
+    vector<byte> payload;
+    payload.reserve(sizeof(MessagePrefix) + headerSize + bodySize);
+
+    MessagePrefix prefix = { headerSize, bodySize };
+    auto prefixBytes = reinterpret_cast<byte const*>(&prefix);
+    payload.insert(payload.end(), prefixBytes, prefixBytes + sizeof(prefix));
+
+    for (auto chunk = message.BeginHeaderChunks(); chunk != message.EndHeaderChunks(); ++chunk)
+    {
+        payload.insert(payload.end(), chunk->cbegin(), chunk->cend());
+    }
+
+    for (auto chunk = message.BeginBodyChunks(); chunk != message.EndBodyChunks(); ++chunk)
+    {
+        payload.insert(payload.end(), chunk->cbegin(), chunk->cend());
+    }
+
+    return payload;
+}
+
+bool IpcSharedMemoryRing::TryRead(
+    size_t maxMessageSize,
+    __inout vector<byte> & partial,
+    __out MessageUPtr & message,
+    __out ErrorCode & error)
+{
+    uint64 head = head_;
+    uint64 tail = control_->Tail.load(std::memory_order_acquire);
+    if (head == tail)
+    {
+        return false;
+    }
+
+    // the producer is in another process, do not trust its position or record lengths any further than the ring
+    if (!IsValidRange(head, tail) || (tail - head < sizeof(RecordHeader)))
+    {
+        error = ErrorCodeValue::InvalidMessage;
+        return true;
+    }
+
+    RecordHeader record;
+    CopyOut(head, &record, sizeof(record));
+
+    auto recordSize = RecordSize(record.Length);
+    if ((record.Length == 0) || (recordSize > capacity_) || (recordSize > tail - head))
+    {
+        error = ErrorCodeValue::InvalidMessage;
+        return true;
+    }
+
+    uint64 position = head + sizeof(record);
+    if ((record.Flags & LastFragment) && partial.empty())
+    {
+        error = ReadMessage(position, record.Length, maxMessageSize, message);
+    }
+    else if ((maxMessageSize > 0) && (partial.size() + record.Length > sizeof(MessagePrefix) + maxMessageSize))
+    {
+        error = ErrorCodeValue::MessageTooLarge;
+    }
+    else
+    {
+        auto offset = partial.size();
+        partial.resize(offset + record.Length);
+        CopyOut(position, partial.data() + offset, record.Length);
+
+        if (record.Flags & LastFragment)
+        {
+            error = CreateMessage(partial, message);
+            partial.clear();
+        }
+    }
+
+    head_ = head + recordSize;
+    control_->Head.store(head_, std::memory_order_release);
+    return true;
+}
+
+ErrorCode IpcSharedMemoryRing::ReadMessage(uint64 position, size_t length, size_t maxMessageSize, __out MessageUPtr & message) const
+{
+    if (length < sizeof(MessagePrefix))
+    {
+        return ErrorCodeValue::InvalidMessage;
+    }
+
+    MessagePrefix prefix;
+    CopyOut(position, &prefix, sizeof(prefix));
+    if (sizeof(prefix) + static_cast<size_t>(prefix.HeaderSize) + prefix.BodySize != length)
+    {
+        return ErrorCodeValue::InvalidMessage;
+    }
+
+    if ((maxMessageSize > 0) && (length - sizeof(prefix) > maxMessageSize))
+    {
+        return ErrorCodeValue::MessageTooLarge;
+    }
+
+    position += sizeof(prefix);
+
+    ByteBique headers;
+    CopyOut(position, headers, prefix.HeaderSize);
+
+    ByteBique body;
+    CopyOut(position + prefix.HeaderSize, body, prefix.BodySize);
+
+    message = make_unique<Message>(ByteBiqueRange(std::move(headers)), ByteBiqueRange(std::move(body)), Stopwatch::Now());
+    return ErrorCode();
+}
+
+ErrorCode IpcSharedMemoryRing::CreateMessage(vector<byte> const & payload, __out MessageUPtr & message)
+{
+    if (payload.size() < sizeof(MessagePrefix))
+    {
+        return ErrorCodeValue::InvalidMessage;
+    }
+
+    MessagePrefix prefix;
+    memcpy(&prefix, payload.data(), sizeof(prefix));
+    if (sizeof(prefix) + static_cast<size_t>(prefix.HeaderSize) + prefix.BodySize != payload.size())
+    {
+        return ErrorCodeValue::InvalidMessage;
+    }
+
+    auto headerBytes = payload.data() + sizeof(prefix);
+
+    ByteBique headers;
+    BiqueWriteStream headerStream(headers);
+    headerStream.WriteBytes(headerBytes, prefix.HeaderSize);
+
+    ByteBique body;
+    BiqueWriteStream bodyStream(body);
+    bodyStream.WriteBytes(headerBytes + prefix.HeaderSize, prefix.BodySize);
+
+    message = make_unique<Message>(ByteBiqueRange(std::move(headers)), ByteBiqueRange(std::move(body)), Stopwatch::Now());
+    return ErrorCode();
+}
+
+bool IpcSharedMemoryRing::PrepareConsumerWait()
+{
+    control_->ConsumerWaiting.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    return control_->Tail.load(std::memory_order_acquire) == head_;
+}
+
+bool IpcSharedMemoryRing::ShouldWakeProducer()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return control_->ProducerWaiting.load(std::memory_order_relaxed) && control_->ProducerWaiting.exchange(0);
+}
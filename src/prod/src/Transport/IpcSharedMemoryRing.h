@@ -0,0 +1,115 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Transport
+{
+    //
+    // Single producer, single consumer ring of messages in memory shared by two processes. The ring is a control
+    // block followed by a power of two data area, head and tail are free running byte positions. Each record is
+    // [uint32 length][uint32 flags][payload] padded to 8 bytes, the payload of a message is
+    // [uint32 headerSize][uint32 bodySize][headers][body] and is split across records when it does not fit in
+    // the free space. The waiting flags let each side skip the eventfd wakeup unless the other side is about to
+    // block. The control block relies on the shared memory being zero filled when it is created. Each side keeps
+    // its own position locally and checks the position published by the peer process before using it.
+    //
+    class IpcSharedMemoryRing
+    {
+        DENY_COPY(IpcSharedMemoryRing);
+
+    public:
+        IpcSharedMemoryRing(void * region, uint capacity);
+
+        static size_t RegionSize(uint capacity);
+        static bool IsValidCapacity(uint capacity);
+
+        // Producer side, callers must serialize calls
+
+        // Writes the whole message as a single record, returns false if there is not enough free space or the
+        // consumer position is invalid, WriteFragment reports the latter
+        bool TryWriteMessage(Message & message, uint headerSize, uint bodySize);
+
+        // Writes the leading part of a serialized message payload as one record. Fails with InvalidMessage if the
+        // consumer position is invalid, the ring cannot be used any more in that case.
+        Common::ErrorCode WriteFragment(byte const * payload, size_t length, __out size_t & written);
+
+        // Marks the producer as waiting, returns false if space for the next fragment was freed in the meantime
+        // or the consumer position is invalid
+        bool PrepareProducerWait(size_t length);
+
+        // Returns true if the consumer went to wait and must be woken up for records written so far
+        bool ShouldWakeConsumer();
+
+        static std::vector<byte> Serialize(Message & message, uint headerSize, uint bodySize);
+
+        // Consumer side, callers must serialize calls
+
+        // Returns false if the ring is empty. A complete message is returned in message, fragments are accumulated
+        // in partial until the last one arrives. The ring cannot be used any more once error is set, which includes
+        // an invalid producer position or record length.
+        bool TryRead(
+            size_t maxMessageSize,
+            __inout std::vector<byte> & partial,
+            __out MessageUPtr & message,
+            __out Common::ErrorCode & error);
+
+        // Marks the consumer as waiting, returns false if records arrived in the meantime
+        bool PrepareConsumerWait();
+
+        // Returns true if the producer went to wait for space and must be woken up
+        bool ShouldWakeProducer();
+
+    private:
+        static const size_t CacheLineSize = 64;
+        static const uint LastFragment = 0x1;
+        static const size_t MinFragmentLength = 1024;
+
+        struct ControlBlock
+        {
+            std::atomic<uint64> Tail;
+            byte TailPadding[CacheLineSize - sizeof(std::atomic<uint64>)];
+            std::atomic<uint64> Head;
+            byte HeadPadding[CacheLineSize - sizeof(std::atomic<uint64>)];
+            std::atomic<uint> ConsumerWaiting;
+            byte ConsumerWaitingPadding[CacheLineSize - sizeof(std::atomic<uint>)];
+            std::atomic<uint> ProducerWaiting;
+            byte ProducerWaitingPadding[CacheLineSize - sizeof(std::atomic<uint>)];
+        };
+
+        struct RecordHeader
+        {
+            uint Length;
+            uint Flags;
+        };
+
+        struct MessagePrefix
+        {
+            uint HeaderSize;
+            uint BodySize;
+        };
+
+        static size_t RecordSize(size_t payloadLength);
+        bool IsValidRange(uint64 head, uint64 tail) const;
+        bool TryGetFreeSpace(__out size_t & freeSpace) const;
+        void Publish(uint64 tail);
+
+        void CopyIn(uint64 position, void const * source, size_t count);
+        void CopyOut(uint64 position, void * destination, size_t count) const;
+        void CopyOut(uint64 position, ByteBique & destination, size_t count) const;
+
+        Common::ErrorCode ReadMessage(uint64 position, size_t length, size_t maxMessageSize, __out MessageUPtr & message) const;
+        static Common::ErrorCode CreateMessage(std::vector<byte> const & payload, __out MessageUPtr & message);
+
+        ControlBlock * control_;
+        byte * data_;
+        uint capacity_;
+        uint64 mask_;
+
+        // Positions owned by this side, the copies in the control block are only written
+        uint64 head_;
+        uint64 tail_;
+    };
+}
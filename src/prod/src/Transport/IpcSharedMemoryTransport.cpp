@@ -0,0 +1,1626 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+using namespace Transport;
+using namespace Common;
+using namespace std;
+
+static const StringLiteral TraceType("IpcSharedMemory");
+
+namespace
+{
+    uint const HandshakeMagic = 0x4d485346; // "FSHM"
+    uint const HandshakeVersion = 1;
+
+    // Sent by the client along with the memfd, the client eventfd and the server eventfd
+    struct Handshake
+    {
+        uint Magic;
+        uint Version;
+        uint RingCapacity;
+        uint ProcessId;
+    };
+
+    int const HandshakeFdCount = 3;
+
+    // Sent back by the server once it has mapped the shared memory, the client keeps using TCP until then
+    struct HandshakeAck
+    {
+        uint Magic;
+        uint Version;
+    };
+
+    void CloseFd(int & fd)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+}
+
+//
+// One client connected through shared memory. The ring written by the client comes first in the shared memory,
+// followed by the ring written by the server.
+//
+class IpcSharedMemoryTransport::Channel
+    : public enable_shared_from_this<Channel>
+    , public TextTraceComponent<TraceTaskCodes::Transport>
+{
+    DENY_COPY(Channel);
+
+public:
+    Channel(
+        weak_ptr<IpcSharedMemoryTransport> const & owner,
+        wstring const & traceId,
+        EventLoop & eventLoop,
+        bool dispatchReadAsync,
+        size_t maxIncomingMessageSize,
+        ULONG sendQueueLimit);
+
+    ~Channel();
+
+    wstring const & TraceId() const { return traceId_; }
+    bool IsEstablished() const;
+
+    // Client side, sets up shared memory and hands it over to the server listening on socketName, the channel
+    // is established when the server acknowledges it
+    ErrorCode Connect(string const & socketName, uint ringCapacity, ISendTarget::SPtr const & serverTarget);
+
+    // Server side, takes over a socket accepted from a client, shared memory is set up on handshake
+    void Accept(int socketFd, ISendTarget::SPtr const & target);
+
+    // Registers with the event loop, the channel closes itself on failure
+    void Start();
+
+    ErrorCode Send(MessageUPtr && message, TimeSpan expiration);
+    void SetSendQueueLimit(ULONG limitInBytes);
+    void Close(ErrorCode const & fault);
+
+private:
+    // Send status of messages that left pending_, reported once the lock is released
+    typedef vector<pair<MessageUPtr, ErrorCode>> SendCompletions;
+
+    struct PendingMessage
+    {
+        PendingMessage(vector<byte> && buffer, StopwatchTime expiration, MessageUPtr && message)
+            : Buffer(std::move(buffer)), Expiration(expiration), Message(std::move(message))
+        {
+        }
+
+        vector<byte> Buffer;
+        StopwatchTime Expiration;
+
+        // only kept when it has a send status callback
+        MessageUPtr Message;
+    };
+
+    static StopwatchTime GetExpirationTime(TimeSpan expiration);
+    static void CompleteSends(SendCompletions & completions);
+
+    ErrorCode Map(int memFd, uint ringCapacity);
+    ErrorCode ReceiveHandshake_CallerHoldingLock(__out bool & completed);
+    ErrorCode ReceiveHandshakeAck_CallerHoldingLock(__out bool & completed);
+    void RegisterEventFd_CallerHoldingLock();
+
+    void OnSocketEvent(int fd, uint events);
+    void OnEventFd(int fd, uint events);
+    bool ReadIncoming();
+    void PurgeExpired_CallerHoldingLock(__inout SendCompletions & completions);
+    ErrorCode Flush_CallerHoldingLock(__out bool & wakePeer, __inout SendCompletions & completions);
+    void SignalPeer();
+    void SignalSelf();
+    void Cleanup();
+
+    weak_ptr<IpcSharedMemoryTransport> const owner_;
+    wstring const traceId_;
+    EventLoop & eventLoop_;
+    bool const dispatchReadAsync_;
+    size_t const maxIncomingMessageSize_;
+    ISendTarget::SPtr target_;
+
+    MUTABLE_RWLOCK(Transport.IpcSharedMemoryChannel, lock_);
+    bool isServer_;
+    bool established_;
+    bool closed_;
+    int socketFd_;
+    int localEventFd_;
+    int peerEventFd_;
+    void * region_;
+    size_t regionSize_;
+    unique_ptr<IpcSharedMemoryRing> inRing_;
+    unique_ptr<IpcSharedMemoryRing> outRing_;
+    EventLoop::FdContext* socketFdContext_;
+    EventLoop::FdContext* eventFdContext_;
+
+    // Serialized messages waiting for space in outRing_, the front one may be partially written. Bounded by
+    // sendQueueLimit_ and dropped on expiration the same way as the TCP send queue.
+    deque<PendingMessage> pending_;
+    size_t pendingOffset_;
+    size_t pendingBytes_;
+    ULONG sendQueueLimit_;
+
+    // Payload of the message being reassembled from inRing_, only accessed by the eventfd callback
+    vector<byte> partial_;
+};
+
+//
+// Reply target of messages received by the server from a channel
+//
+class IpcSharedMemoryTransport::ChannelSendTarget : public ISendTarget
+{
+    DENY_COPY(ChannelSendTarget);
+
+public:
+    ChannelSendTarget(ChannelSPtr const & channel, wstring const & localAddress, wstring const & address)
+        : channel_(channel), localAddress_(localAddress), address_(address)
+    {
+    }
+
+    ErrorCode SendOneWay(MessageUPtr && message, TimeSpan expiration, TransportPriority::Enum) override
+    {
+        auto channel = channel_.lock();
+        if (!channel)
+        {
+            message->OnSendStatus(ErrorCodeValue::ObjectClosed, std::move(message));
+            return ErrorCodeValue::ObjectClosed;
+        }
+
+        return channel->Send(std::move(message), expiration);
+    }
+
+    wstring const & Address() const override { return address_; }
+    wstring const & LocalAddress() const override { return localAddress_; }
+    wstring const & Id() const override { return id_; }
+    wstring const & TraceId() const override { return address_; }
+
+    bool IsAnonymous() const override { return true; }
+
+    void Reset() override
+    {
+        if (auto channel = channel_.lock())
+        {
+            channel->Close(ErrorCodeValue::OperationCanceled);
+        }
+    }
+
+    size_t ConnectionCount() const override { return channel_.expired() ? 0 : 1; }
+
+private:
+    weak_ptr<Channel> const channel_;
+    wstring const localAddress_;
+    wstring const address_;
+    wstring const id_;
+};
+
+IpcSharedMemoryTransport::Channel::Channel(
+    weak_ptr<IpcSharedMemoryTransport> const & owner,
+    wstring const & traceId,
+    EventLoop & eventLoop,
+    bool dispatchReadAsync,
+    size_t maxIncomingMessageSize,
+    ULONG sendQueueLimit)
+    : owner_(owner)
+    , traceId_(traceId)
+    , eventLoop_(eventLoop)
+    , dispatchReadAsync_(dispatchReadAsync)
+    , maxIncomingMessageSize_(maxIncomingMessageSize)
+    , isServer_(false)
+    , established_(false)
+    , closed_(false)
+    , socketFd_(-1)
+    , localEventFd_(-1)
+    , peerEventFd_(-1)
+    , region_(nullptr)
+    , regionSize_(0)
+    , socketFdContext_(nullptr)
+    , eventFdContext_(nullptr)
+    , pendingOffset_(0)
+    , pendingBytes_(0)
+    , sendQueueLimit_(sendQueueLimit)
+{
+}
+
+IpcSharedMemoryTransport::Channel::~Channel()
+{
+    inRing_.reset();
+    outRing_.reset();
+    if (region_)
+    {
+        munmap(region_, regionSize_);
+    }
+
+    CloseFd(socketFd_);
+    CloseFd(localEventFd_);
+    CloseFd(peerEventFd_);
+}
+
+bool IpcSharedMemoryTransport::Channel::IsEstablished() const
+{
+    AcquireReadLock grab(lock_);
+    return established_;
+}
+
+ErrorCode IpcSharedMemoryTransport::Channel::Map(int memFd, uint ringCapacity)
+{
+    if (!IpcSharedMemoryRing::IsValidCapacity(ringCapacity))
+    {
+        WriteWarning(TraceType, traceId_, "invalid ring capacity {0}", ringCapacity);
+        return ErrorCodeValue::InvalidArgument;
+    }
+
+    auto ringRegionSize = IpcSharedMemoryRing::RegionSize(ringCapacity);
+    auto regionSize = 2 * ringRegionSize;
+
+    // the size must not change while the region is mapped, or the next ring access raises SIGBUS
+    auto seals = fcntl(memFd, F_GET_SEALS);
+    if (seals < 0)
+    {
+        auto error = ErrorCode::FromErrno();
+        WriteWarning(TraceType, traceId_, "failed to get shared memory seals: {0}", error);
+        return error;
+    }
+
+    if ((seals & (F_SEAL_SHRINK | F_SEAL_GROW)) != (F_SEAL_SHRINK | F_SEAL_GROW))
+    {
+        WriteWarning(TraceType, traceId_, "shared memory is not sealed against resizing: seals = {0:x}", seals);
+        return ErrorCodeValue::InvalidArgument;
+    }
+
+    struct stat memFdStat;
+    if (fstat(memFd, &memFdStat) < 0)
+    {
+        return ErrorCode::FromErrno();
+    }
+
+    if (static_cast<size_t>(memFdStat.st_size) != regionSize)
+    {
+        WriteWarning(TraceType, traceId_, "shared memory size {0} does not match {1}", memFdStat.st_size, regionSize);
+        return ErrorCodeValue::InvalidArgument;
+    }
+
+    auto region = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, memFd, 0);
+    if (region == MAP_FAILED)
+    {
+        auto error = ErrorCode::FromErrno();
+        WriteWarning(TraceType, traceId_, "mmap failed: {0}", error);
+        return error;
+    }
+
+    region_ = region;
+    regionSize_ = regionSize;
+
+    auto clientRing = make_unique<IpcSharedMemoryRing>(region, ringCapacity);
+    auto serverRing = make_unique<IpcSharedMemoryRing>(reinterpret_cast<byte*>(region) + ringRegionSize, ringCapacity);
+    inRing_ = isServer_ ? std::move(clientRing) : std::move(serverRing);
+    outRing_ = isServer_ ? std::move(serverRing) : std::move(clientRing);
+    return ErrorCode();
+}
+
+ErrorCode IpcSharedMemoryTransport::Channel::Connect(string const & socketName, uint ringCapacity, ISendTarget::SPtr const & serverTarget)
+{
+    target_ = serverTarget;
+
+    int memFd = static_cast<int>(syscall(SYS_memfd_create, "ServiceFabric.Ipc", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+    if (memFd < 0)
+    {
+        auto error = ErrorCode::FromErrno();
+        WriteInfo(TraceType, traceId_, "memfd_create failed: {0}", error);
+        return error;
+    }
+
+    KFinally([&] { CloseFd(memFd); });
+
+    if (ftruncate(memFd, 2 * IpcSharedMemoryRing::RegionSize(ringCapacity)) < 0)
+    {
+        auto error = ErrorCode::FromErrno();
+        WriteWarning(TraceType, traceId_, "ftruncate failed: {0}", error);
+        return error;
+    }
+
+    if (fcntl(memFd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0)
+    {
+        auto error = ErrorCode::FromErrno();
+        WriteWarning(TraceType, traceId_, "failed to seal shared memory: {0}", error);
+        return error;
+    }
+
+    auto error = Map(memFd, ringCapacity);
+    if (!error.IsSuccess())
+    {
+        return error;
+    }
+
+    localEventFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    peerEventFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ((localEventFd_ < 0) || (peerEventFd_ < 0))
+    {
+        error = ErrorCode::FromErrno();
+        WriteWarning(TraceType, traceId_, "eventfd failed: {0}", error);
+        return error;
+    }
+
+    socketFd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socketFd_ < 0)
+    {
+        error = ErrorCode::FromErrno();
+        WriteWarning(TraceType, traceId_, "socket failed: {0}", error);
+        return error;
+    }
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, socketName.data(), socketName.size());
+    auto addressLength = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + socketName.size());
+
+    // unix domain stream connect completes synchronously unless the listen backlog is full, which is
+    // treated as not available
+    if (connect(socketFd_, reinterpret_cast<sockaddr*>(&address), addressLength) < 0)
+    {
+        error = ErrorCode::FromErrno();
+        WriteInfo(TraceType, traceId_, "connect failed: {0}", error);
+        return error;
+    }
+
+    Handshake handshake = { HandshakeMagic, HandshakeVersion, ringCapacity, static_cast<uint>(GetCurrentProcessId()) };
+    iovec iov = { &handshake, sizeof(handshake) };
+
+    union
+    {
+        cmsghdr header;
+        char buffer[CMSG_SPACE(HandshakeFdCount * sizeof(int))];
+    } control = {};
+
+    msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+
+    int fds[HandshakeFdCount] = { memFd, localEventFd_, peerEventFd_ };
+    auto cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    if (sendmsg(socketFd_, &msg, MSG_NOSIGNAL) != sizeof(handshake))
+    {
+        error = ErrorCode::FromErrno();
+        WriteWarning(TraceType, traceId_, "sendmsg failed: {0}", error);
+        return error;
+    }
+
+    return ErrorCode();
+}
+
+void IpcSharedMemoryTransport::Channel::Accept(int socketFd, ISendTarget::SPtr const & target)
+{
+    isServer_ = true;
+    socketFd_ = socketFd;
+    target_ = target;
+}
+
+void IpcSharedMemoryTransport::Channel::Start()
+{
+    ErrorCode error;
+    {
+        AcquireWriteLock grab(lock_);
+        if (closed_)
+        {
+            return;
+        }
+
+        socketFdContext_ = eventLoop_.RegisterFd(
+            socketFd_,
+            EPOLLIN | EPOLLRDHUP,
+            dispatchReadAsync_,
+            [this] (int fd, uint events) { OnSocketEvent(fd, events); });
+
+        error = eventLoop_.Activate(socketFdContext_);
+    }
+
+    if (!error.IsSuccess())
+    {
+        Close(error);
+    }
+}
+
+void IpcSharedMemoryTransport::Channel::RegisterEventFd_CallerHoldingLock()
+{
+    eventFdContext_ = eventLoop_.RegisterFd(
+        localEventFd_,
+        EPOLLIN,
+        dispatchReadAsync_,
+        [this] (int fd, uint events) { OnEventFd(fd, events); });
+
+    // the peer only signals when it sees this side waiting, the first callback drains whatever was written
+    // before and marks this side as waiting
+    SignalSelf();
+
+    auto error = eventLoop_.Activate(eventFdContext_);
+    if (!error.IsSuccess())
+    {
+        WriteWarning(TraceType, traceId_, "failed to activate eventfd: {0}", error);
+        shutdown(socketFd_, SHUT_RDWR);
+    }
+}
+
+ErrorCode IpcSharedMemoryTransport::Channel::ReceiveHandshake_CallerHoldingLock(__out bool & completed)
+{
+    completed = false;
+
+    Handshake handshake = {};
+    iovec iov = { &handshake, sizeof(handshake) };
+
+    union
+    {
+        cmsghdr header;
+        char buffer[CMSG_SPACE(HandshakeFdCount * sizeof(int))];
+    } control = {};
+
+    msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+
+    auto received = recvmsg(socketFd_, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+    if (received < 0)
+    {
+        return ((errno == EAGAIN) || (errno == EWOULDBLOCK)) ? ErrorCode() : ErrorCode::FromErrno();
+    }
+
+    int fds[HandshakeFdCount] = { -1, -1, -1 };
+    size_t fdCount = 0;
+    for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+        if ((cmsg->cmsg_level != SOL_SOCKET) || (cmsg->cmsg_type != SCM_RIGHTS)) continue;
+
+        auto count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < count; ++i)
+        {
+            int fd;
+            memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+            if (fdCount < HandshakeFdCount)
+            {
+                fds[fdCount++] = fd;
+            }
+            else
+            {
+                close(fd);
+            }
+        }
+    }
+
+    int memFd = fds[0];
+    KFinally([&] { CloseFd(memFd); });
+    localEventFd_ = fds[2];
+    peerEventFd_ = fds[1];
+
+    if ((received != sizeof(handshake)) ||
+        (fdCount != HandshakeFdCount) ||
+        (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) ||
+        (handshake.Magic != HandshakeMagic) ||
+        (handshake.Version != HandshakeVersion))
+    {
+        WriteWarning(
+            TraceType, traceId_,
+            "invalid handshake: received = {0}, fdCount = {1}, flags = {2:x}, magic = {3:x}, version = {4}",
+            received, fdCount, msg.msg_flags, handshake.Magic, handshake.Version);
+
+        return ErrorCodeValue::InvalidMessage;
+    }
+
+    auto error = Map(memFd, handshake.RingCapacity);
+    if (!error.IsSuccess())
+    {
+        return error;
+    }
+
+    // the socket buffer is empty at this point, so this never blocks
+    HandshakeAck ack = { HandshakeMagic, HandshakeVersion };
+    if (send(socketFd_, &ack, sizeof(ack), MSG_DONTWAIT | MSG_NOSIGNAL) != sizeof(ack))
+    {
+        error = ErrorCode::FromErrno();
+        WriteWarning(TraceType, traceId_, "failed to send handshake ack: {0}", error);
+        return error;
+    }
+
+    WriteInfo(
+        TraceType, traceId_,
+        "established with client process {0}, ring capacity = {1}",
+        handshake.ProcessId, handshake.RingCapacity);
+
+    established_ = true;
+    completed = true;
+    return ErrorCode();
+}
+
+ErrorCode IpcSharedMemoryTransport::Channel::ReceiveHandshakeAck_CallerHoldingLock(__out bool & completed)
+{
+    completed = false;
+
+    HandshakeAck ack = {};
+    auto received = recv(socketFd_, &ack, sizeof(ack), MSG_DONTWAIT);
+    if (received < 0)
+    {
+        return ((errno == EAGAIN) || (errno == EWOULDBLOCK)) ? ErrorCode() : ErrorCode::FromErrno();
+    }
+
+    if (received == 0)
+    {
+        // the server closes the socket without acknowledging when it rejects this process
+        WriteInfo(TraceType, traceId_, "server closed the socket during handshake");
+        return ErrorCodeValue::ConnectionDenied;
+    }
+
+    if ((received != sizeof(ack)) || (ack.Magic != HandshakeMagic) || (ack.Version != HandshakeVersion))
+    {
+        WriteWarning(
+            TraceType, traceId_,
+            "invalid handshake ack: received = {0}, magic = {1:x}, version = {2}",
+            received, ack.Magic, ack.Version);
+
+        return ErrorCodeValue::InvalidMessage;
+    }
+
+    WriteInfo(TraceType, traceId_, "established with server");
+
+    established_ = true;
+    completed = true;
+    return ErrorCode();
+}
+
+void IpcSharedMemoryTransport::Channel::OnSocketEvent(int fd, uint events)
+{
+    Invariant(fd == socketFd_);
+
+    ErrorCode handshakeError;
+    {
+        AcquireWriteLock grab(lock_);
+        if (closed_)
+        {
+            return;
+        }
+
+        if (!established_ && !EventLoop::IsFdClosedOrInError(events))
+        {
+            bool completed;
+            handshakeError = isServer_ ? ReceiveHandshake_CallerHoldingLock(completed) : ReceiveHandshakeAck_CallerHoldingLock(completed);
+            if (handshakeError.IsSuccess())
+            {
+                if (completed)
+                {
+                    RegisterEventFd_CallerHoldingLock();
+                }
+
+                eventLoop_.Activate(socketFdContext_);
+                return;
+            }
+        }
+    }
+
+    if (!handshakeError.IsSuccess())
+    {
+        Close(handshakeError);
+        return;
+    }
+
+    // nothing but the handshake and its ack is ever sent over the socket, it only becomes readable when the
+    // peer goes away
+    byte buffer[64];
+    auto received = recv(socketFd_, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (received > 0)
+    {
+        WriteWarning(TraceType, traceId_, "ignoring {0} unexpected bytes on socket", received);
+        eventLoop_.Activate(socketFdContext_);
+        return;
+    }
+
+    if ((received < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)) && !EventLoop::IsFdClosedOrInError(events))
+    {
+        eventLoop_.Activate(socketFdContext_);
+        return;
+    }
+
+    Close(ErrorCodeValue::ConnectionClosedByRemoteEnd);
+}
+
+void IpcSharedMemoryTransport::Channel::OnEventFd(int fd, uint events)
+{
+    Invariant(fd == localEventFd_);
+
+    uint64 count;
+    if ((read(localEventFd_, &count, sizeof(count)) < 0) && (errno != EAGAIN))
+    {
+        Close(ErrorCode::FromErrno());
+        return;
+    }
+
+    if (!ReadIncoming())
+    {
+        return;
+    }
+
+    // the peer also signals when it frees space in the ring pending_ is waiting for
+    ErrorCode error;
+    SendCompletions completions;
+    {
+        AcquireWriteLock grab(lock_);
+        if (closed_)
+        {
+            return;
+        }
+
+        bool wakePeer = false;
+        error = Flush_CallerHoldingLock(wakePeer, completions);
+        if (wakePeer)
+        {
+            SignalPeer();
+        }
+    }
+
+    CompleteSends(completions);
+
+    if (!error.IsSuccess())
+    {
+        WriteWarning(TraceType, traceId_, "failed to write outgoing message: {0}", error);
+        Close(error);
+        return;
+    }
+
+    error = eventLoop_.Activate(eventFdContext_);
+    if (!error.IsSuccess())
+    {
+        Close(error);
+    }
+}
+
+bool IpcSharedMemoryTransport::Channel::ReadIncoming()
+{
+    auto owner = owner_.lock();
+    if (!owner)
+    {
+        return false;
+    }
+
+    for (;;)
+    {
+        MessageUPtr message;
+        ErrorCode error;
+        while (inRing_->TryRead(maxIncomingMessageSize_, partial_, message, error))
+        {
+            if (!error.IsSuccess())
+            {
+                WriteWarning(TraceType, traceId_, "failed to read incoming message: {0}", error);
+                Close(error);
+                return false;
+            }
+
+            if (inRing_->ShouldWakeProducer())
+            {
+                SignalPeer();
+            }
+
+            if (message)
+            {
+                owner->OnChannelMessage(message, target_);
+                message.reset();
+            }
+
+            AcquireReadLock grab(lock_);
+            if (closed_)
+            {
+                return false;
+            }
+        }
+
+        if (inRing_->PrepareConsumerWait())
+        {
+            return true;
+        }
+    }
+}
+
+ErrorCode IpcSharedMemoryTransport::Channel::Send(MessageUPtr && message, TimeSpan expiration)
+{
+    if (!message->IsValid)
+    {
+        message->OnSendStatus(ErrorCodeValue::InvalidMessage, std::move(message));
+        return ErrorCodeValue::InvalidMessage;
+    }
+
+    message->Headers.CompactIfNeeded();
+    auto headerSize = message->SerializedHeaderSize();
+    auto bodySize = message->SerializedBodySize();
+
+    ErrorCode error;
+    bool faulted = false;
+    SendCompletions completions;
+    {
+        AcquireWriteLock grab(lock_);
+
+        bool wakePeer = false;
+        if (closed_)
+        {
+            error = ErrorCodeValue::ObjectClosed;
+        }
+        else if (pending_.empty() && outRing_->TryWriteMessage(*message, headerSize, bodySize))
+        {
+            wakePeer = outRing_->ShouldWakeConsumer();
+        }
+        else
+        {
+            PurgeExpired_CallerHoldingLock(completions);
+
+            auto buffer = IpcSharedMemoryRing::Serialize(*message, headerSize, bodySize);
+            if ((sendQueueLimit_ > 0) && (pendingBytes_ + buffer.size() > sendQueueLimit_))
+            {
+                WriteWarning(
+                    TraceType, traceId_,
+                    "send queue full: pending = {0} messages of {1} bytes, limit = {2}, dropping {3} of {4} bytes",
+                    pending_.size(), pendingBytes_, sendQueueLimit_, message->TraceId(), buffer.size());
+
+                error = ErrorCodeValue::TransportSendQueueFull;
+            }
+            else
+            {
+                pendingBytes_ += buffer.size();
+                pending_.emplace_back(
+                    std::move(buffer),
+                    GetExpirationTime(expiration),
+                    message->HasSendStatusCallback() ? std::move(message) : nullptr);
+
+                error = Flush_CallerHoldingLock(wakePeer, completions);
+                faulted = !error.IsSuccess();
+            }
+        }
+
+        if (wakePeer)
+        {
+            SignalPeer();
+        }
+    }
+
+    CompleteSends(completions);
+
+    if (faulted)
+    {
+        WriteWarning(TraceType, traceId_, "failed to write outgoing message: {0}", error);
+        Close(error);
+    }
+
+    // queued messages get their send status when they leave pending_
+    if (message)
+    {
+        message->OnSendStatus(error, std::move(message));
+    }
+
+    return error;
+}
+
+void IpcSharedMemoryTransport::Channel::SetSendQueueLimit(ULONG limitInBytes)
+{
+    AcquireWriteLock grab(lock_);
+    sendQueueLimit_ = limitInBytes;
+}
+
+StopwatchTime IpcSharedMemoryTransport::Channel::GetExpirationTime(TimeSpan expiration)
+{
+    if (expiration == TimeSpan::MaxValue)
+    {
+        return StopwatchTime::MaxValue;
+    }
+
+    auto now = Stopwatch::Now();
+    auto expirationTime = now + expiration;
+    return (expirationTime < now) ? StopwatchTime::MaxValue : expirationTime;
+}
+
+void IpcSharedMemoryTransport::Channel::CompleteSends(SendCompletions & completions)
+{
+    for (auto & completion : completions)
+    {
+        completion.first->OnSendStatus(completion.second, std::move(completion.first));
+    }
+
+    completions.clear();
+}
+
+void IpcSharedMemoryTransport::Channel::PurgeExpired_CallerHoldingLock(__inout SendCompletions & completions)
+{
+    auto now = Stopwatch::Now();
+    size_t expiredCount = 0;
+
+    // a partially written message has to be finished for the peer to find the next record
+    auto iter = pending_.begin();
+    if ((iter != pending_.end()) && (pendingOffset_ > 0))
+    {
+        ++ iter;
+    }
+
+    while (iter != pending_.end())
+    {
+        if (iter->Expiration > now)
+        {
+            ++ iter;
+            continue;
+        }
+
+        ++ expiredCount;
+        pendingBytes_ -= iter->Buffer.size();
+        if (iter->Message)
+        {
+            completions.emplace_back(std::move(iter->Message), ErrorCodeValue::MessageExpired);
+        }
+
+        iter = pending_.erase(iter);
+    }
+
+    if (expiredCount > 0)
+    {
+        WriteInfo(TraceType, traceId_, "dropped {0} expired outgoing messages", expiredCount);
+    }
+}
+
+ErrorCode IpcSharedMemoryTransport::Channel::Flush_CallerHoldingLock(__out bool & wakePeer, __inout SendCompletions & completions)
+{
+    wakePeer = false;
+
+    PurgeExpired_CallerHoldingLock(completions);
+
+    bool written = false;
+    while (!pending_.empty())
+    {
+        auto & front = pending_.front();
+        auto remaining = front.Buffer.size() - pendingOffset_;
+        size_t count;
+        auto error = outRing_->WriteFragment(front.Buffer.data() + pendingOffset_, remaining, count);
+        if (!error.IsSuccess())
+        {
+            return error;
+        }
+
+        if (count == 0)
+        {
+            if (outRing_->PrepareProducerWait(remaining))
+            {
+                break;
+            }
+
+            continue;
+        }
+
+        written = true;
+        pendingOffset_ += count;
+        if (pendingOffset_ == front.Buffer.size())
+        {
+            pendingBytes_ -= front.Buffer.size();
+            if (front.Message)
+            {
+                completions.emplace_back(std::move(front.Message), ErrorCode());
+            }
+
+            pending_.pop_front();
+            pendingOffset_ = 0;
+        }
+    }
+
+    wakePeer = written && outRing_->ShouldWakeConsumer();
+    return ErrorCode();
+}
+
+void IpcSharedMemoryTransport::Channel::SignalPeer()
+{
+    uint64 one = 1;
+    if ((write(peerEventFd_, &one, sizeof(one)) < 0) && (errno != EAGAIN))
+    {
+        WriteWarning(TraceType, traceId_, "failed to signal peer: {0}", ErrorCode::FromErrno());
+    }
+}
+
+void IpcSharedMemoryTransport::Channel::SignalSelf()
+{
+    uint64 one = 1;
+    if ((write(localEventFd_, &one, sizeof(one)) < 0) && (errno != EAGAIN))
+    {
+        WriteWarning(TraceType, traceId_, "failed to signal eventfd: {0}", ErrorCode::FromErrno());
+    }
+}
+
+void IpcSharedMemoryTransport::Channel::Close(ErrorCode const & fault)
+{
+    auto sendError = fault.IsSuccess() ? ErrorCode(ErrorCodeValue::OperationCanceled) : fault;
+    SendCompletions completions;
+    {
+        AcquireWriteLock grab(lock_);
+        if (closed_)
+        {
+            return;
+        }
+
+        closed_ = true;
+        for (auto & pending : pending_)
+        {
+            if (pending.Message)
+            {
+                completions.emplace_back(std::move(pending.Message), sendError);
+            }
+        }
+
+        pending_.clear();
+        pendingBytes_ = 0;
+    }
+
+    WriteInfo(TraceType, traceId_, "closing: {0}", fault);
+
+    CompleteSends(completions);
+
+    // let the peer see the close right away, the descriptor itself is released in Cleanup
+    shutdown(socketFd_, SHUT_RDWR);
+
+    if (auto owner = owner_.lock())
+    {
+        owner->OnChannelClosed(*this, target_, fault);
+    }
+
+    // Close may be called on an event loop callback, which must return before the descriptors are unregistered
+    auto thisSPtr = shared_from_this();
+    Threadpool::Post([thisSPtr] { thisSPtr->Cleanup(); });
+}
+
+void IpcSharedMemoryTransport::Channel::Cleanup()
+{
+    EventLoop::FdContext* socketFdContext = nullptr;
+    {
+        AcquireWriteLock grab(lock_);
+        swap(socketFdContext, socketFdContext_);
+    }
+
+    // the eventfd is registered on the socket callback during handshake, so the socket goes first
+    if (socketFdContext)
+    {
+        eventLoop_.UnregisterFd(socketFdContext, true);
+    }
+
+    EventLoop::FdContext* eventFdContext = nullptr;
+    {
+        AcquireWriteLock grab(lock_);
+        swap(eventFdContext, eventFdContext_);
+    }
+
+    if (eventFdContext)
+    {
+        eventLoop_.UnregisterFd(eventFdContext, true);
+    }
+
+    AcquireWriteLock grab(lock_);
+
+    inRing_.reset();
+    outRing_.reset();
+    if (region_)
+    {
+        munmap(region_, regionSize_);
+        region_ = nullptr;
+    }
+
+    CloseFd(socketFd_);
+    CloseFd(localEventFd_);
+    CloseFd(peerEventFd_);
+}
+
+IpcSharedMemoryTransport::IpcSharedMemoryTransport(IDatagramTransportSPtr const & innerTransport, bool isServer)
+    : innerTransport_(innerTransport)
+    , isServer_(isServer)
+    , ringCapacity_(TransportConfig::GetConfig().IpcSharedMemoryRingSize)
+    , innerDisconnectHHandler_(DisconnectEvent::InvalidHHandler)
+    , started_(false)
+    , stopping_(false)
+    , eventLoopDispatchReadAsync_(true)
+    , maxIncomingMessageSize_(0)
+    , perTargetSendQueueLimit_(TransportConfig::GetConfig().DefaultSendQueueSizeLimit)
+    , outgoingMessageExpiration_(
+        (TransportConfig::GetConfig().DefaultOutgoingMessageExpiration > TimeSpan::Zero) ?
+        TransportConfig::GetConfig().DefaultOutgoingMessageExpiration :
+        TimeSpan::MaxValue)
+    , listenFd_(-1)
+    , listenEventLoop_(nullptr)
+    , listenFdContext_(nullptr)
+{
+    ASSERT_IF(!innerTransport_, "the inner transport is invalid");
+}
+
+IpcSharedMemoryTransport::~IpcSharedMemoryTransport()
+{
+    Stop();
+}
+
+bool IpcSharedMemoryTransport::IsSharedMemoryTarget(ISendTarget const & target)
+{
+    return dynamic_cast<ChannelSendTarget const*>(&target) != nullptr;
+}
+
+bool IpcSharedMemoryTransport::IsSharedMemoryAllowed() const
+{
+    auto security = innerTransport_->Security();
+    if (!security || (security->SecurityProvider == SecurityProvider::None))
+    {
+        return true;
+    }
+
+    // Windows credentials are not checked on Linux (see TransportSecurity::Set), so connections
+    // with them are authorized the same way as non-secure ones, by the peer uid check in OnAccept
+    return security->UsingWindowsCredential();
+}
+
+string IpcSharedMemoryTransport::GetSocketName(wstring const & listenAddress)
+{
+    // abstract namespace, no file to clean up if the process goes away
+    string socketName(1, '\0');
+    socketName += "ServiceFabric.Ipc.";
+    socketName += StringUtility::Utf16ToUtf8(listenAddress);
+    return socketName;
+}
+
+ErrorCode IpcSharedMemoryTransport::Start(bool completeStart)
+{
+    auto error = innerTransport_->Start(completeStart);
+    if (!error.IsSuccess())
+    {
+        return error;
+    }
+
+    weak_ptr<IpcSharedMemoryTransport> thisWPtr = shared_from_this();
+    auto hHandler = innerTransport_->RegisterDisconnectEvent([thisWPtr] (DisconnectEventArgs const & args)
+    {
+        if (auto thisSPtr = thisWPtr.lock())
+        {
+            thisSPtr->OnInnerDisconnect(args);
+        }
+    });
+
+    {
+        AcquireWriteLock grab(lock_);
+        innerDisconnectHHandler_ = hHandler;
+        started_ = true;
+    }
+
+    if (isServer_)
+    {
+        error = StartListen();
+        if (!error.IsSuccess())
+        {
+            // clients fall back to TCP when they cannot connect
+            WriteWarning(TraceType, TraceId(), "shared memory is not available to clients: {0}", error);
+        }
+    }
+
+    return ErrorCode();
+}
+
+ErrorCode IpcSharedMemoryTransport::CompleteStart()
+{
+    return innerTransport_->CompleteStart();
+}
+
+void IpcSharedMemoryTransport::Stop(TimeSpan timeout)
+{
+    vector<ChannelSPtr> channels;
+    DisconnectHHandler hHandler;
+    {
+        AcquireWriteLock grab(lock_);
+        if (stopping_)
+        {
+            return;
+        }
+
+        stopping_ = true;
+        channels = TakeChannels_CallerHoldingLock();
+        tcpOnlyTargets_.clear();
+        connectionFaultHandler_ = nullptr;
+        hHandler = innerDisconnectHHandler_;
+    }
+
+    StopListen();
+
+    for (auto const & channel : channels)
+    {
+        channel->Close(ErrorCodeValue::ObjectClosed);
+    }
+
+    if (hHandler != DisconnectEvent::InvalidHHandler)
+    {
+        innerTransport_->UnregisterDisconnectEvent(hHandler);
+    }
+
+    disconnectEvent_.Close();
+    innerTransport_->Stop(timeout);
+}
+
+vector<IpcSharedMemoryTransport::ChannelSPtr> IpcSharedMemoryTransport::TakeChannels_CallerHoldingLock()
+{
+    vector<ChannelSPtr> channels;
+    channels.reserve(channels_.size());
+    for (auto const & entry : channels_)
+    {
+        channels.push_back(entry.second);
+    }
+
+    channels_.clear();
+    return channels;
+}
+
+ErrorCode IpcSharedMemoryTransport::StartListen()
+{
+    if (!IsSharedMemoryAllowed())
+    {
+        WriteInfo(TraceType, TraceId(), "shared memory is not used with {0}", innerTransport_->Security()->SecurityProvider);
+        return ErrorCode();
+    }
+
+    auto socketName = GetSocketName(innerTransport_->ListenAddress());
+    sockaddr_un address = {};
+    if (socketName.size() > sizeof(address.sun_path))
+    {
+        return ErrorCodeValue::InvalidAddress;
+    }
+
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, socketName.data(), socketName.size());
+    auto addressLength = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + socketName.size());
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0)
+    {
+        return ErrorCode::FromErrno();
+    }
+
+    if ((bind(listenFd, reinterpret_cast<sockaddr*>(&address), addressLength) < 0) ||
+        (listen(listenFd, SOMAXCONN) < 0))
+    {
+        auto error = ErrorCode::FromErrno();
+        close(listenFd);
+        return error;
+    }
+
+    AcquireWriteLock grab(lock_);
+    if (stopping_)
+    {
+        close(listenFd);
+        return ErrorCodeValue::ObjectClosed;
+    }
+
+    listenFd_ = listenFd;
+    listenEventLoop_ = &(innerTransport_->EventLoops()->Assign());
+    listenFdContext_ = listenEventLoop_->RegisterFd(
+        listenFd_,
+        EPOLLIN,
+        true,
+        [this] (int sd, uint events) { OnAccept(sd, events); });
+
+    WriteInfo(TraceType, TraceId(), "listening for shared memory clients of {0}", ListenAddress());
+    return listenEventLoop_->Activate(listenFdContext_);
+}
+
+void IpcSharedMemoryTransport::StopListen()
+{
+    if (listenFdContext_)
+    {
+        listenEventLoop_->UnregisterFd(listenFdContext_, true);
+        listenFdContext_ = nullptr;
+    }
+
+    CloseFd(listenFd_);
+}
+
+void IpcSharedMemoryTransport::OnAccept(int sd, uint events)
+{
+    Invariant(sd == listenFd_);
+
+    if (events & EPOLLERR)
+    {
+        WriteError(TraceType, TraceId(), "events = {0:x}, EPOLLERR set on shared memory listen socket", events);
+        return;
+    }
+
+    for (;;)
+    {
+        int acceptedFd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (acceptedFd < 0)
+        {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+            {
+                WriteWarning(TraceType, TraceId(), "accept failed: {0}", ErrorCode::FromErrno());
+            }
+
+            break;
+        }
+
+        ucred credentials = {};
+        socklen_t credentialsLength = sizeof(credentials);
+        if (getsockopt(acceptedFd, SOL_SOCKET, SO_PEERCRED, &credentials, &credentialsLength) < 0)
+        {
+            WriteWarning(TraceType, TraceId(), "failed to get peer credentials: {0}", ErrorCode::FromErrno());
+            close(acceptedFd);
+            continue;
+        }
+
+        // only processes running as the same user as this one or as root may share memory with it
+        if ((credentials.uid != geteuid()) && (credentials.uid != 0))
+        {
+            WriteWarning(
+                TraceType, TraceId(),
+                "rejecting shared memory client: pid = {0}, uid = {1}, expected uid = {2}",
+                credentials.pid, credentials.uid, geteuid());
+
+            close(acceptedFd);
+            continue;
+        }
+
+        auto address = wformatString("{0}/{1}", ListenAddress(), credentials.pid);
+        ChannelSPtr channel;
+        {
+            AcquireWriteLock grab(lock_);
+            if (stopping_)
+            {
+                close(acceptedFd);
+                return;
+            }
+
+            channel = make_shared<Channel>(
+                shared_from_this(),
+                wformatString("{0}-{1}", TraceId(), address),
+                innerTransport_->EventLoops()->Assign(),
+                eventLoopDispatchReadAsync_,
+                maxIncomingMessageSize_,
+                perTargetSendQueueLimit_);
+
+            auto target = make_shared<ChannelSendTarget>(channel, ListenAddress(), address);
+            channel->Accept(acceptedFd, target);
+            channels_.emplace(target.get(), channel);
+        }
+
+        // transports with SSL never listen, checked again in case security was set after Start
+        if (!IsSharedMemoryAllowed())
+        {
+            channel->Close(ErrorCodeValue::ConnectionDenied);
+            continue;
+        }
+
+        channel->Start();
+    }
+
+    listenEventLoop_->Activate(listenFdContext_);
+}
+
+IpcSharedMemoryTransport::ChannelSPtr IpcSharedMemoryTransport::GetOrCreateClientChannel(ISendTarget::SPtr const & target)
+{
+    ChannelSPtr channel;
+    {
+        AcquireReadLock grab(lock_);
+
+        if (!started_ || stopping_)
+        {
+            return nullptr;
+        }
+
+        auto iter = channels_.find(target.get());
+        if (iter != channels_.cend())
+        {
+            channel = iter->second;
+        }
+        else if (tcpOnlyTargets_.find(target.get()) != tcpOnlyTargets_.cend())
+        {
+            return nullptr;
+        }
+    }
+
+    if (channel)
+    {
+        // messages keep going through TCP until the server acknowledges the handshake
+        return channel->IsEstablished() ? channel : nullptr;
+    }
+
+    {
+        AcquireWriteLock grab(lock_);
+
+        if (stopping_)
+        {
+            return nullptr;
+        }
+
+        if (channels_.find(target.get()) != channels_.cend())
+        {
+            return nullptr;
+        }
+
+        if (tcpOnlyTargets_.find(target.get()) != tcpOnlyTargets_.cend())
+        {
+            return nullptr;
+        }
+
+        auto error = CreateClientChannel(target, channel);
+        if (!error.IsSuccess())
+        {
+            WriteInfo(TraceType, TraceId(), "using TCP to {0}, shared memory not available: {1}", target->Address(), error);
+            tcpOnlyTargets_.emplace(target.get(), target);
+            return nullptr;
+        }
+
+        channels_.emplace(target.get(), channel);
+    }
+
+    channel->Start();
+    return nullptr;
+}
+
+ErrorCode IpcSharedMemoryTransport::CreateClientChannel(ISendTarget::SPtr const & target, __out ChannelSPtr & channel)
+{
+    if (!IsSharedMemoryAllowed())
+    {
+        return ErrorCodeValue::ConnectionDenied;
+    }
+
+    channel = make_shared<Channel>(
+        shared_from_this(),
+        wformatString("{0}-{1}", TraceId(), target->Address()),
+        innerTransport_->EventLoops()->Assign(),
+        eventLoopDispatchReadAsync_,
+        maxIncomingMessageSize_,
+        perTargetSendQueueLimit_);
+
+    auto error = channel->Connect(GetSocketName(target->Address()), ringCapacity_, target);
+    if (!error.IsSuccess())
+    {
+        channel.reset();
+        return error;
+    }
+
+    WriteInfo(TraceType, channel->TraceId(), "sent shared memory handshake, ring capacity = {0}", ringCapacity_);
+    return error;
+}
+
+ErrorCode IpcSharedMemoryTransport::SendOneWay(
+    ISendTarget::SPtr const & target,
+    MessageUPtr && message,
+    TimeSpan expiration,
+    TransportPriority::Enum priority)
+{
+    if (target)
+    {
+        auto channelExpiration = (expiration != TimeSpan::MaxValue) ? expiration : outgoingMessageExpiration_;
+        if (isServer_)
+        {
+            auto channelTarget = dynamic_cast<ChannelSendTarget*>(target.get());
+            if (channelTarget)
+            {
+                return channelTarget->SendOneWay(std::move(message), channelExpiration, priority);
+            }
+        }
+        else
+        {
+            auto channel = GetOrCreateClientChannel(target);
+            if (channel)
+            {
+                return channel->Send(std::move(message), channelExpiration);
+            }
+        }
+    }
+
+    return innerTransport_->SendOneWay(target, std::move(message), expiration, priority);
+}
+
+void IpcSharedMemoryTransport::OnChannelMessage(MessageUPtr & message, ISendTarget::SPtr const & sender)
+{
+    MessageHandlerSPtr handler;
+    {
+        AcquireReadLock grab(lock_);
+        handler = handler_;
+    }
+
+    if (handler)
+    {
+        (*handler)(message, sender);
+    }
+}
+
+void IpcSharedMemoryTransport::OnChannelClosed(Channel const & channel, ISendTarget::SPtr const & target, ErrorCode const & fault)
+{
+    auto established = channel.IsEstablished();
+
+    ConnectionFaultHandler handler;
+    {
+        AcquireWriteLock grab(lock_);
+
+        auto iter = channels_.find(target.get());
+        if ((iter == channels_.cend()) || (iter->second.get() != &channel))
+        {
+            return;
+        }
+
+        channels_.erase(iter);
+        if (stopping_)
+        {
+            return;
+        }
+
+        if (!established)
+        {
+            // nothing was sent through the channel yet, the server rejected it or went away during handshake,
+            // so stay on TCP instead of setting up shared memory again on every send
+            if (!isServer_)
+            {
+                WriteInfo(TraceType, channel.TraceId(), "using TCP, shared memory handshake failed: {0}", fault);
+                tcpOnlyTargets_.emplace(target.get(), target);
+            }
+
+            return;
+        }
+
+        handler = connectionFaultHandler_;
+    }
+
+    WriteInfo(TraceType, channel.TraceId(), "shared memory channel faulted: {0}", fault);
+
+    if (handler)
+    {
+        handler(*target, fault);
+    }
+
+    disconnectEvent_.Fire(DisconnectEventArgs(target.get(), fault));
+}
+
+void IpcSharedMemoryTransport::OnInnerDisconnect(DisconnectEventArgs const & args)
+{
+    {
+        // retry shared memory on the next send after TCP reconnects, the server may have come back with it
+        AcquireWriteLock grab(lock_);
+        tcpOnlyTargets_.erase(args.Target);
+    }
+
+    disconnectEvent_.Fire(args);
+}
+
+void IpcSharedMemoryTransport::SetMessageHandler(MessageHandler const & handler)
+{
+    {
+        AcquireWriteLock grab(lock_);
+        handler_ = make_shared<MessageHandler>(handler);
+    }
+
+    innerTransport_->SetMessageHandler(handler);
+}
+
+ISendTarget::SPtr IpcSharedMemoryTransport::Resolve(
+    wstring const & address,
+    wstring const & targetId,
+    wstring const & sspiTarget,
+    uint64 instance)
+{
+    return innerTransport_->Resolve(address, targetId, sspiTarget, instance);
+}
+
+size_t IpcSharedMemoryTransport::SendTargetCount() const
+{
+    size_t channelCount = 0;
+    if (isServer_)
+    {
+        AcquireReadLock grab(lock_);
+        channelCount = channels_.size();
+    }
+
+    return innerTransport_->SendTargetCount() + channelCount;
+}
+
+IDatagramTransport::DisconnectHHandler IpcSharedMemoryTransport::RegisterDisconnectEvent(DisconnectEventHandler eventHandler)
+{
+    AcquireWriteLock grab(lock_);
+
+    if (stopping_) return DisconnectEvent::InvalidHHandler;
+
+    return disconnectEvent_.Add(eventHandler);
+}
+
+bool IpcSharedMemoryTransport::UnregisterDisconnectEvent(DisconnectHHandler hHandler)
+{
+    AcquireWriteLock grab(lock_);
+    return disconnectEvent_.Remove(hHandler);
+}
+
+void IpcSharedMemoryTransport::SetConnectionFaultHandler(ConnectionFaultHandler const & handler)
+{
+    {
+        AcquireWriteLock grab(lock_);
+        if (stopping_) return;
+
+        connectionFaultHandler_ = handler;
+    }
+
+    innerTransport_->SetConnectionFaultHandler(handler);
+}
+
+void IpcSharedMemoryTransport::RemoveConnectionFaultHandler()
+{
+    {
+        AcquireWriteLock grab(lock_);
+        connectionFaultHandler_ = nullptr;
+    }
+
+    innerTransport_->RemoveConnectionFaultHandler();
+}
+
+ErrorCode IpcSharedMemoryTransport::SetPerTargetSendQueueLimit(ULONG limitInBytes)
+{
+    vector<ChannelSPtr> channels;
+    {
+        AcquireWriteLock grab(lock_);
+        perTargetSendQueueLimit_ = limitInBytes;
+        for (auto const & entry : channels_)
+        {
+            channels.push_back(entry.second);
+        }
+    }
+
+    for (auto const & channel : channels)
+    {
+        channel->SetSendQueueLimit(limitInBytes);
+    }
+
+    return innerTransport_->SetPerTargetSendQueueLimit(limitInBytes);
+}
+
+ErrorCode IpcSharedMemoryTransport::SetOutgoingMessageExpiration(TimeSpan expiration)
+{
+    auto error = innerTransport_->SetOutgoingMessageExpiration(expiration);
+    if (error.IsSuccess())
+    {
+        outgoingMessageExpiration_ = (expiration > TimeSpan::Zero) ? expiration : TimeSpan::MaxValue;
+    }
+
+    return error;
+}
+
+void IpcSharedMemoryTransport::SetMaxIncomingFrameSize(ULONG value)
+{
+    {
+        AcquireWriteLock grab(lock_);
+        maxIncomingMessageSize_ = value;
+    }
+
+    innerTransport_->SetMaxIncomingFrameSize(value);
+}
+
+void IpcSharedMemoryTransport::SetEventLoopReadDispatch(bool asyncDispatch)
+{
+    {
+        AcquireWriteLock grab(lock_);
+        eventLoopDispatchReadAsync_ = asyncDispatch;
+    }
+
+    innerTransport_->SetEventLoopReadDispatch(asyncDispatch);
+}
+
+void IpcSharedMemoryTransport::Test_Reset()
+{
+    vector<ChannelSPtr> channels;
+    {
+        AcquireWriteLock grab(lock_);
+        for (auto const & entry : channels_)
+        {
+            channels.push_back(entry.second);
+        }
+    }
+
+    for (auto const & channel : channels)
+    {
+        channel->Close(ErrorCodeValue::OperationCanceled);
+    }
+
+    innerTransport_->Test_Reset();
+}
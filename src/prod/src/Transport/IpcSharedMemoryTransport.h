@@ -0,0 +1,165 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Transport
+{
+    //
+    // Decorator of the TCP transport used by IpcClient and IpcServer, which carries messages between a client and
+    // the server through a pair of IpcSharedMemoryRing in a memfd mapped by both processes, with one eventfd per
+    // process for wakeups. On its first send to the server, the client creates the memfd and eventfds and passes
+    // them over the server's abstract unix socket, and keeps sending through TCP until the server acknowledges.
+    // The socket then stays open for both sides to detect the other going away. Non-secure transports and those
+    // with Windows credentials, which are not checked on Linux, use shared memory and only accept peers running
+    // as the same user or root. SSL traffic goes through the inner transport.
+    //
+    class IpcSharedMemoryTransport
+        : public IDatagramTransport
+        , public std::enable_shared_from_this<IpcSharedMemoryTransport>
+        , public Common::TextTraceComponent<Common::TraceTaskCodes::Transport>
+    {
+        DENY_COPY(IpcSharedMemoryTransport);
+
+    public:
+        IpcSharedMemoryTransport(IDatagramTransportSPtr const & innerTransport, bool isServer);
+        ~IpcSharedMemoryTransport() override;
+
+        Common::ErrorCode Start(bool completeStart = true) override;
+        Common::ErrorCode CompleteStart() override;
+        void Stop(Common::TimeSpan timeout = Common::TimeSpan::Zero) override;
+
+        std::wstring const & get_IdString() const override { return innerTransport_->get_IdString(); }
+        std::wstring const & TraceId() const override { return innerTransport_->TraceId(); }
+
+        void SetInstance(uint64 instance) override { innerTransport_->SetInstance(instance); }
+
+        TransportSecuritySPtr Security() const override { return innerTransport_->Security(); }
+        Common::ErrorCode SetSecurity(SecuritySettings const & securitySettings) override { return innerTransport_->SetSecurity(securitySettings); }
+
+        void SetFrameHeaderErrorChecking(bool enabled) override { innerTransport_->SetFrameHeaderErrorChecking(enabled); }
+        void SetMessageErrorChecking(bool enabled) override { innerTransport_->SetMessageErrorChecking(enabled); }
+
+        void DisableSecureSessionExpiration() override { innerTransport_->DisableSecureSessionExpiration(); }
+
+        void DisableThrottle() override { innerTransport_->DisableThrottle(); }
+        void AllowThrottleReplyMessage() override { innerTransport_->AllowThrottleReplyMessage(); }
+
+        void DisableListenInstanceMessage() override { innerTransport_->DisableListenInstanceMessage(); }
+
+        void SetMessageHandler(MessageHandler const & handler) override;
+
+        size_t SendTargetCount() const override;
+
+        Common::ErrorCode SendOneWay(
+            ISendTarget::SPtr const & target,
+            MessageUPtr && message,
+            Common::TimeSpan expiration = Common::TimeSpan::MaxValue,
+            TransportPriority::Enum = TransportPriority::Normal) override;
+
+        DisconnectHHandler RegisterDisconnectEvent(DisconnectEventHandler eventHandler) override;
+        bool UnregisterDisconnectEvent(DisconnectHHandler hHandler) override;
+
+        void SetConnectionAcceptedHandler(ConnectionAcceptedHandler const & handler) override { innerTransport_->SetConnectionAcceptedHandler(handler); }
+        void RemoveConnectionAcceptedHandler() override { innerTransport_->RemoveConnectionAcceptedHandler(); }
+
+        void SetConnectionFaultHandler(ConnectionFaultHandler const & handler) override;
+        void RemoveConnectionFaultHandler() override;
+
+        std::wstring const & ListenAddress() const override { return innerTransport_->ListenAddress(); }
+
+        Common::ErrorCode SetPerTargetSendQueueLimit(ULONG limitInBytes) override;
+        Common::ErrorCode SetOutgoingMessageExpiration(Common::TimeSpan expiration) override;
+
+        void SetClaimsRetrievalMetadata(ClaimsRetrievalMetadata && metadata) override { innerTransport_->SetClaimsRetrievalMetadata(std::move(metadata)); }
+        void SetClaimsRetrievalHandler(TransportSecurity::ClaimsRetrievalHandler const & handler) override { innerTransport_->SetClaimsRetrievalHandler(handler); }
+        void RemoveClaimsRetrievalHandler() override { innerTransport_->RemoveClaimsRetrievalHandler(); }
+
+        void SetClaimsHandler(TransportSecurity::ClaimsHandler const & handler) override { innerTransport_->SetClaimsHandler(handler); }
+        void RemoveClaimsHandler() override { innerTransport_->RemoveClaimsHandler(); }
+
+        void SetMaxIncomingFrameSize(ULONG value) override;
+        void SetMaxOutgoingFrameSize(ULONG value) override { innerTransport_->SetMaxOutgoingFrameSize(value); }
+
+        Common::TimeSpan ConnectionOpenTimeout() const override { return innerTransport_->ConnectionOpenTimeout(); }
+        void SetConnectionOpenTimeout(Common::TimeSpan timeout) override { innerTransport_->SetConnectionOpenTimeout(timeout); }
+        Common::TimeSpan ConnectionIdleTimeout() const override { return innerTransport_->ConnectionIdleTimeout(); }
+        void SetConnectionIdleTimeout(Common::TimeSpan idleTimeout) override { innerTransport_->SetConnectionIdleTimeout(idleTimeout); }
+        Common::TimeSpan KeepAliveTimeout() const override { return innerTransport_->KeepAliveTimeout(); }
+        void SetKeepAliveTimeout(Common::TimeSpan timeout) override { innerTransport_->SetKeepAliveTimeout(timeout); }
+
+        void EnableInboundActivityTracing() override { innerTransport_->EnableInboundActivityTracing(); }
+
+        void DisableAllPerMessageTraces() override { innerTransport_->DisableAllPerMessageTraces(); }
+
+        Common::EventLoopPool* EventLoops() const override { return innerTransport_->EventLoops(); }
+        void SetEventLoopPool(Common::EventLoopPool* pool) override { innerTransport_->SetEventLoopPool(pool); }
+        void SetEventLoopReadDispatch(bool asyncDispatch) override;
+        void SetEventLoopWriteDispatch(bool asyncDispatch) override { innerTransport_->SetEventLoopWriteDispatch(asyncDispatch); }
+
+        void SetBufferFactory(std::unique_ptr<IBufferFactory> && bufferFactory) override { innerTransport_->SetBufferFactory(std::move(bufferFactory)); }
+
+        void Test_Reset() override;
+
+        // True for reply targets of messages a server received through shared memory
+        static bool IsSharedMemoryTarget(ISendTarget const & target);
+
+    private:
+        class Channel;
+        class ChannelSendTarget;
+        typedef std::shared_ptr<Channel> ChannelSPtr;
+
+        ISendTarget::SPtr Resolve(
+            std::wstring const & address,
+            std::wstring const & targetId,
+            std::wstring const & sspiTarget,
+            uint64 instance) override;
+
+        bool IsSharedMemoryAllowed() const;
+        static std::string GetSocketName(std::wstring const & listenAddress);
+
+        Common::ErrorCode StartListen();
+        void StopListen();
+        void OnAccept(int fd, uint events);
+
+        ChannelSPtr GetOrCreateClientChannel(ISendTarget::SPtr const & target);
+        Common::ErrorCode CreateClientChannel(ISendTarget::SPtr const & target, __out ChannelSPtr & channel);
+
+        void OnChannelMessage(MessageUPtr & message, ISendTarget::SPtr const & sender);
+        void OnChannelClosed(Channel const & channel, ISendTarget::SPtr const & target, Common::ErrorCode const & fault);
+        void OnInnerDisconnect(DisconnectEventArgs const & args);
+
+        std::vector<ChannelSPtr> TakeChannels_CallerHoldingLock();
+
+        IDatagramTransportSPtr const innerTransport_;
+        bool const isServer_;
+        uint const ringCapacity_;
+
+        MUTABLE_RWLOCK(Transport.IpcSharedMemoryTransport, lock_);
+        MessageHandlerSPtr handler_;
+        ConnectionFaultHandler connectionFaultHandler_;
+        DisconnectEvent disconnectEvent_;
+        DisconnectHHandler innerDisconnectHHandler_;
+        bool started_;
+        bool stopping_;
+        bool eventLoopDispatchReadAsync_;
+        ULONG maxIncomingMessageSize_;
+        ULONG perTargetSendQueueLimit_;
+
+        // Set before Start like the one of the inner transport, so not protected by lock_
+        Common::TimeSpan outgoingMessageExpiration_;
+
+        // Keyed by the TCP target of the server on a client and by the target of each channel on a server
+        std::unordered_map<ISendTarget const*, ChannelSPtr> channels_;
+
+        // Server targets that failed to set up shared memory or did not acknowledge the handshake, they use TCP
+        // until their next disconnect
+        std::unordered_map<ISendTarget const*, ISendTarget::SPtr> tcpOnlyTargets_;
+
+        int listenFd_;
+        Common::EventLoop* listenEventLoop_;
+        Common::EventLoop::FdContext* listenFdContext_;
+    };
+}
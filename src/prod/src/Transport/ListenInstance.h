@@ -22,6 +22,10 @@ namespace Transport
         // For duplicate connection elimination
         Common::Guid const & Nonce() const { return nonce_; }
 
+        // Compact message header version supported by the listener, see CompactHeaderEncoding
+        uint16 CompactHeaderVersion() const { return compactHeaderVersion_; }
+        void SetCompactHeaderVersion(uint16 version) { compactHeaderVersion_ = version; }
+
         bool operator == (const ListenInstance & rhs) const
         {
             return
@@ -39,11 +43,12 @@ namespace Transport
         static std::string AddField(Common::TraceEvent & traceEvent, std::string const & name);
         void FillEventData(Common::TraceEventContext & context) const;
 
-        FABRIC_FIELDS_03(address_, instance_, nonce_);
+        FABRIC_FIELDS_04(address_, instance_, nonce_, compactHeaderVersion_);
 
     private:
         std::wstring address_;
         uint64 instance_;
         Common::Guid nonce_;
+        uint16 compactHeaderVersion_ = 0;
     };
 }
@@ -1967,6 +1967,127 @@ namespace Transport
         LEAVE;
     }
 
+    void VerifyHotHeaders(
+        MessageHeaders & headers,
+        wstring const & action,
+        Actor::Enum actor,
+        MessageId const & messageId,
+        ActivityId const & activityId,
+        TimeSpan timeout)
+    {
+        VERIFY_IS_TRUE(headers.Action == action);
+        VERIFY_IS_TRUE(headers.Actor == actor);
+        VERIFY_IS_TRUE(headers.MessageId.Guid.Equals(messageId.Guid));
+        VERIFY_IS_TRUE(headers.MessageId.Index == messageId.Index);
+        VERIFY_IS_TRUE(headers.RelatesTo.Guid.Equals(messageId.Guid));
+        VERIFY_IS_TRUE(headers.RelatesTo.Index == messageId.Index);
+        VERIFY_IS_TRUE(headers.ExpectsReply);
+
+        FabricActivityHeader activityHeader;
+        VERIFY_IS_TRUE(headers.TryReadFirst(activityHeader));
+        VERIFY_IS_TRUE(activityHeader.Guid.Equals(activityId.Guid));
+        VERIFY_IS_TRUE(activityHeader.ActivityId.Index == activityId.Index);
+
+        TimeoutHeader timeoutHeader;
+        VERIFY_IS_TRUE(headers.TryReadFirst(timeoutHeader));
+        VERIFY_IS_TRUE(timeoutHeader.Timeout == timeout);
+
+        VERIFY_IS_TRUE(headers.IsValid);
+    }
+
+    void AddHotHeaders(
+        MessageHeaders & headers,
+        wstring const & action,
+        Actor::Enum actor,
+        MessageId const & messageId,
+        ActivityId const & activityId,
+        TimeSpan timeout)
+    {
+        headers.Add(ActionHeader(action));
+        headers.Add(ActorHeader(actor));
+        headers.Add(MessageIdHeader(messageId));
+        headers.Add(RelatesToHeader(messageId));
+        headers.Add(ExpectsReplyHeader(true));
+        headers.Add(FabricActivityHeader(activityId));
+        headers.Add(TimeoutHeader(timeout));
+    }
+
+    BOOST_AUTO_TEST_CASE(CompactHeaderEncodingTest)
+    {
+        ENTER;
+
+        wstring action(L"RoutingAck");
+        uint16 actionId;
+        VERIFY_IS_TRUE(CompactHeaderEncoding::TryGetActionId(action, numeric_limits<uint16>::max(), actionId));
+        VERIFY_IS_FALSE(CompactHeaderEncoding::TryGetActionId(L"MyAction", numeric_limits<uint16>::max(), actionId));
+
+        Actor::Enum actor = Actor::Enum::GenericTestActor;
+        MessageId messageId(Common::Guid::NewGuid(), 5);
+        ActivityId activityId(ActivityId(Common::Guid::NewGuid()), 7);
+        TimeSpan timeout = TimeSpan::FromSeconds(13);
+
+        Message message;
+        AddHotHeaders(message.Headers, action, actor, messageId, activityId, timeout);
+        auto standardSize = message.Headers.SerializedSize();
+
+        VERIFY_ARE_EQUAL2(message.Headers.EncodeForPeer(actionId + 1), STATUS_SUCCESS);
+        Trace.WriteInfo(TraceType, "compact: {0}", message.Headers);
+        VERIFY_IS_TRUE(message.Headers.HasCompactHeaders);
+        VERIFY_IS_TRUE(message.Headers.SerializedSize() < standardSize);
+        VerifyHotHeaders(message.Headers, action, actor, messageId, activityId, timeout);
+
+        // Sending again to a peer with the same version leaves the headers as they are
+        auto compactSize = message.Headers.SerializedSize();
+        VERIFY_ARE_EQUAL2(message.Headers.EncodeForPeer(actionId + 1), STATUS_SUCCESS);
+        VERIFY_ARE_EQUAL2(message.Headers.SerializedSize(), compactSize);
+        VERIFY_IS_TRUE(message.Headers.HasCompactHeaders);
+
+        // Simulate receiving the compact headers
+        ByteBique received;
+        for (auto iter = message.Headers.Begin(); iter != message.Headers.End(); ++iter)
+        {
+            received.append(iter->Start(), iter->ByteTotalInStream());
+        }
+
+        MessageHeaders incomingHeaders(std::move(ByteBiqueRange(std::move(received))), MessageHeaders::NullReceiveTime());
+        VERIFY_IS_TRUE(incomingHeaders.HasCompactHeaders);
+        VerifyHotHeaders(incomingHeaders, action, actor, messageId, activityId, timeout);
+
+        // Forwarding to a peer that does not know the action only expands the action header
+        VERIFY_ARE_EQUAL2(incomingHeaders.EncodeForPeer(actionId), STATUS_SUCCESS);
+        VERIFY_IS_TRUE(incomingHeaders.HasCompactHeaders);
+        for (auto iter = incomingHeaders.Begin(); iter != incomingHeaders.End(); ++iter)
+        {
+            bool hasCompactEncoding = CompactHeaderEncoding::GetCompactId(iter->Id()) != MessageHeaderId::INVALID_SYSTEM_HEADER_ID;
+            VERIFY_IS_TRUE(iter->IsCompact() == (hasCompactEncoding && (iter->Id() != MessageHeaderId::Action)));
+        }
+
+        VerifyHotHeaders(incomingHeaders, action, actor, messageId, activityId, timeout);
+
+        // Forwarding to a peer without compact header support expands all headers
+        VERIFY_ARE_EQUAL2(incomingHeaders.EncodeForPeer(0), STATUS_SUCCESS);
+        VERIFY_IS_FALSE(incomingHeaders.HasCompactHeaders);
+        VERIFY_ARE_EQUAL2(incomingHeaders.SerializedSize(), standardSize);
+        for (auto iter = incomingHeaders.Begin(); iter != incomingHeaders.End(); ++iter)
+        {
+            VERIFY_IS_FALSE(iter->IsCompact());
+        }
+
+        VerifyHotHeaders(incomingHeaders, action, actor, messageId, activityId, timeout);
+
+        // Unknown actions are always sent in the standard encoding
+        Message other;
+        AddHotHeaders(other.Headers, L"MyAction", actor, messageId, activityId, timeout);
+        VERIFY_ARE_EQUAL2(other.Headers.EncodeForPeer(actionId + 1), STATUS_SUCCESS);
+        VerifyHotHeaders(other.Headers, L"MyAction", actor, messageId, activityId, timeout);
+
+        TestRemoveAll(message.Headers);
+        TestRemoveAll(incomingHeaders);
+        TestRemoveAll(other.Headers);
+
+        LEAVE;
+    }
+
     struct  VersionableMessageSample : public Serialization::FabricSerializable
     {
         ULONG id_;
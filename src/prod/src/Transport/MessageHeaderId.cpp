@@ -119,6 +119,12 @@ namespace Transport
             case UpgradeComposeDeploymentRequest: w << "UpgradeComposeDeploymentRequest"; return;
             case CreateVolumeRequest: w << "CreateVolumeRequest"; return;
             case FileUploadCreateRequest: w << "FileUploadCreateRequest"; return;
+            case CompactAction: w << "CompactAction"; return;
+            case CompactActor: w << "CompactActor"; return;
+            case CompactMessageId: w << "CompactMessageId"; return;
+            case CompactRelatesTo: w << "CompactRelatesTo"; return;
+            case CompactFabricActivity: w << "CompactFabricActivity"; return;
+            case CompactTimeout: w << "CompactTimeout"; return;
 
             // Header IDs for tests follow this line.
             case Example: w << "Example"; return;
@@ -146,6 +146,14 @@ namespace Transport
             CreateVolumeRequest = 0x804e,
             FileUploadCreateRequest = 0x804f,
 
+            // Compact encodings of transport and common headers, see CompactHeaderEncoding.h
+            CompactAction = 0x8050,
+            CompactActor = 0x8051,
+            CompactMessageId = 0x8052,
+            CompactRelatesTo = 0x8053,
+            CompactFabricActivity = 0x8054,
+            CompactTimeout = 0x8055,
+
             // Add new internal message header ids must be explicitly defined
             // ----------------------------------------------------------------
             // Header IDs for tests follow this line.
@@ -98,6 +98,8 @@ void MessageHeaders::MakeSharedBuffers(
 
 NTSTATUS MessageHeaders::Add(KBuffer const& buffer, bool addingCommonHeaders)
 {
+    peerEncodingValid_ = false;
+
     auto status = CheckSizeLimitBeforeAdd(buffer.QuerySize());
     if (!NT_SUCCESS(status)) return status;
 
@@ -114,6 +116,8 @@ NTSTATUS MessageHeaders::Add(KBuffer const& buffer, bool addingCommonHeaders)
 
 NTSTATUS MessageHeaders::Add(Serialization::IFabricSerializableStream const& serializedHeaders, bool addingCommonHeaders)
 {
+    peerEncodingValid_ = false;
+
     auto status = CheckSizeLimitBeforeAdd(serializedHeaders.Size());
     if (!NT_SUCCESS(status)) return status;
 
@@ -339,6 +343,114 @@ bool MessageHeaders::HeaderReference::TryDeserializeInternal(Serialization::IFab
     return true;
 }
 
+bool MessageHeaders::HeaderReference::ReadCompactBody(void * body, size_t size)
+{
+    if (!this->IsValid)
+    {
+        Common::Assert::TestAssert();
+        return false;
+    }
+
+    if (serializedHeaderObjectSize_ != size)
+    {
+        Fault(STATUS_INVALID_PARAMETER);
+        trace.MessageHeaderDeserializationFailure(TraceThis, this->Status);
+        return false;
+    }
+
+    this->bufferStream_->SeekToBookmark();
+    this->bufferStream_->SeekForward(sizeof(MessageHeaderId::Enum) + sizeof(MessageHeaderSize));
+    this->bufferStream_->ReadBytes(body, size);
+    if (!this->bufferStream_->IsValid)
+    {
+        Fault(this->bufferStream_->Status);
+        trace.MessageHeaderDeserializationFailure(TraceThis, this->Status);
+        return false;
+    }
+
+    return true;
+}
+
+bool MessageHeaders::HeaderReference::TryDeserializeCompact(ActionHeader & header)
+{
+    uint16 actionId;
+    if (!ReadCompactBody(&actionId, sizeof(actionId)))
+    {
+        return false;
+    }
+
+    wstring action;
+    if (!CompactHeaderEncoding::TryGetAction(actionId, action))
+    {
+        Fault(STATUS_INVALID_PARAMETER);
+        trace.MessageHeaderDeserializationFailure(TraceThis, this->Status);
+        return false;
+    }
+
+    header = ActionHeader(move(action));
+    return true;
+}
+
+bool MessageHeaders::HeaderReference::TryDeserializeCompact(ActorHeader & header)
+{
+    uint16 actor;
+    if (!ReadCompactBody(&actor, sizeof(actor)))
+    {
+        return false;
+    }
+
+    header = ActorHeader(static_cast<Actor::Enum>(actor));
+    return true;
+}
+
+bool MessageHeaders::HeaderReference::TryDeserializeCompact(MessageIdHeader & header)
+{
+    CompactHeaderEncoding::MessageIdBody body;
+    if (!ReadCompactBody(&body, sizeof(body)))
+    {
+        return false;
+    }
+
+    header = MessageIdHeader(Transport::MessageId(Common::Guid(body.Guid), body.Index));
+    return true;
+}
+
+bool MessageHeaders::HeaderReference::TryDeserializeCompact(RelatesToHeader & header)
+{
+    CompactHeaderEncoding::MessageIdBody body;
+    if (!ReadCompactBody(&body, sizeof(body)))
+    {
+        return false;
+    }
+
+    header = RelatesToHeader(Transport::MessageId(Common::Guid(body.Guid), body.Index));
+    return true;
+}
+
+bool MessageHeaders::HeaderReference::TryDeserializeCompact(FabricActivityHeader & header)
+{
+    CompactHeaderEncoding::ActivityIdBody body;
+    if (!ReadCompactBody(&body, sizeof(body)))
+    {
+        return false;
+    }
+
+    header = FabricActivityHeader(Common::ActivityId(Common::ActivityId(Common::Guid(body.Guid)), body.Index));
+    return true;
+}
+
+bool MessageHeaders::HeaderReference::TryDeserializeCompact(TimeoutHeader & header)
+{
+    int64 ticks;
+    if (!ReadCompactBody(&ticks, sizeof(ticks)))
+    {
+        return false;
+    }
+
+    header = TimeoutHeader(TimeSpan::FromTicks(ticks));
+    return true;
+}
+
 MessageHeaders::HeaderIterator::HeaderIterator(const BiqueRangeStream& first, const BiqueRangeStream& second, MessageHeaders & parent)
     : parent_(parent),
     first_(first),
@@ -522,7 +634,7 @@ void MessageHeaders::HeaderIterator::OnFault(NTSTATUS status)
 }
 
 MessageHeaders::HeaderReference::HeaderReference(HeaderIterator* headerIterator, BiqueRangeStream* biqueStream, size_t skippedBytes)
-    : headerIterator_(headerIterator), bufferStream_(biqueStream), start_(biqueStream->GetBookmark()), deletedBytesBetweenThisAndPredecessor_(skippedBytes)
+    : headerIterator_(headerIterator), bufferStream_(biqueStream), compact_(false), start_(biqueStream->GetBookmark()), deletedBytesBetweenThisAndPredecessor_(skippedBytes)
 {
     while (!bufferStream_->Eos())
     {
@@ -560,6 +672,8 @@ MessageHeaders::HeaderReference::HeaderReference(HeaderIterator* headerIterator,
             continue;
         }
 
+        // Compact headers are reported under the id of the header they encode
+        compact_ = CompactHeaderEncoding::TryGetEncodedId(id_, id_);
         return;
     }
 
@@ -634,8 +748,279 @@ void MessageHeaders::Compact()
     this->deletedHeaderByteCount_ = 0;
 }
 
+NTSTATUS MessageHeaders::EncodeForPeer(uint16 compactHeaderVersion)
+{
+    // retries and later sends to peers with the same version reuse the encoding until headers change
+    if (peerEncodingValid_ && (peerEncodingVersion_ == compactHeaderVersion))
+    {
+        return STATUS_SUCCESS;
+    }
+
+    if ((compactHeaderVersion > 0) || hasCompactHeaders_)
+    {
+        // Headers shared with clones are left as they are unless the peer cannot read them, compacting them
+        // would copy the shared headers once per clone. Only the non-shared headers are rewritten otherwise.
+        bool rewriteShared = false;
+        bool rewriteNonShared = false;
+        for (auto iter = Begin(); this->IsValid && iter != End(); ++iter)
+        {
+            if (!NeedsReencoding(*iter, compactHeaderVersion))
+            {
+                continue;
+            }
+
+            if (!iter.InFirstStream())
+            {
+                rewriteNonShared = true;
+            }
+            else if (iter->IsCompact())
+            {
+                rewriteShared = true;
+                break;
+            }
+        }
+
+        if (!this->IsValid) return this->Status;
+
+        NTSTATUS status = STATUS_SUCCESS;
+        if (rewriteShared)
+        {
+            status = RewriteAllForPeer(compactHeaderVersion);
+        }
+        else if (rewriteNonShared)
+        {
+            status = RewriteNonSharedForPeer(compactHeaderVersion);
+        }
+
+        if (!NT_SUCCESS(status)) return status;
+    }
+
+    peerEncodingVersion_ = compactHeaderVersion;
+    peerEncodingValid_ = true;
+    return STATUS_SUCCESS;
+}
+
+bool MessageHeaders::NeedsReencoding(HeaderReference & header, uint16 compactHeaderVersion) const
+{
+    uint16 actionId;
+    if (header.IsCompact())
+    {
+        // compact actions are only readable by peers whose action table includes them
+        return
+            (compactHeaderVersion == 0) ||
+            ((header.Id() == MessageHeaderId::Action) && !CompactHeaderEncoding::TryGetActionId(action_, compactHeaderVersion, actionId));
+    }
+
+    return
+        (compactHeaderVersion > 0) &&
+        (CompactHeaderEncoding::GetCompactId(header.Id()) != MessageHeaderId::INVALID_SYSTEM_HEADER_ID) &&
+        ((header.Id() != MessageHeaderId::Action) || CompactHeaderEncoding::TryGetActionId(action_, compactHeaderVersion, actionId));
+}
+
+NTSTATUS MessageHeaders::AppendForPeer(ByteBique & encoded, HeaderReference & header, uint16 compactHeaderVersion, __inout bool & hasCompactHeaders)
+{
+    if ((compactHeaderVersion > 0) && TryAppendCompact(encoded, header, compactHeaderVersion))
+    {
+        hasCompactHeaders = true;
+        return STATUS_SUCCESS;
+    }
+
+    if (!this->IsValid) return this->Status;
+
+    if (header.IsCompact())
+    {
+        return AppendExpanded(encoded, header);
+    }
+
+    encoded.append(header.Start(), header.ByteTotalInStream());
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS MessageHeaders::RewriteNonSharedForPeer(uint16 compactHeaderVersion)
+{
+    ByteBique encoded(outgoingChunkSize_);
+    bool hasCompactHeaders = false;
+    size_t nonSharedHeaderBytes = 0;
+
+    // iterating headers skips deleted headers, which are dropped from the rewritten headers
+    for (auto iter = Begin(); this->IsValid && iter != End(); ++iter)
+    {
+        if (iter.InFirstStream())
+        {
+            hasCompactHeaders = hasCompactHeaders || iter->IsCompact();
+            continue;
+        }
+
+        nonSharedHeaderBytes += iter->ByteTotalInStream();
+        if (!NeedsReencoding(*iter, compactHeaderVersion))
+        {
+            hasCompactHeaders = hasCompactHeaders || iter->IsCompact();
+            encoded.append(iter->Start(), iter->ByteTotalInStream());
+            continue;
+        }
+
+        auto status = AppendForPeer(encoded, *iter, compactHeaderVersion, hasCompactHeaders);
+        if (!NT_SUCCESS(status))
+        {
+            return status;
+        }
+    }
+
+    if (!this->IsValid) return this->Status;
+
+    deletedHeaderByteCount_ -= (nonSharedHeaders_.size() - nonSharedHeaderBytes);
+    nonSharedHeaders_ = std::move(encoded);
+    hasCompactHeaders_ = hasCompactHeaders;
+
+    CheckSize();
+    return this->Status;
+}
+
+NTSTATUS MessageHeaders::RewriteAllForPeer(uint16 compactHeaderVersion)
+{
+    //okay to rewrite "cloned" messages, as sharedHeaders_ is completed replaced, like Compact()
+    ByteBique encoded(outgoingChunkSize_);
+    bool hasCompactHeaders = false;
+
+    // iterating headers skips deleted headers
+    for (auto iter = Begin(); this->IsValid && iter != End(); ++iter)
+    {
+        auto status = AppendForPeer(encoded, *iter, compactHeaderVersion, hasCompactHeaders);
+        if (!NT_SUCCESS(status))
+        {
+            return status;
+        }
+    }
+
+    if (!this->IsValid) return this->Status;
+
+    sharedHeaders_ = std::move(ByteBiqueRange(std::move(encoded)));
+    nonSharedHeaders_.truncate_before(nonSharedHeaders_.end());
+    deletedHeaderByteCount_ = 0;
+    hasCompactHeaders_ = hasCompactHeaders;
+
+    CheckSize();
+    return this->Status;
+}
+
+bool MessageHeaders::TryAppendCompact(ByteBique & encoded, HeaderReference & header, uint16 compactHeaderVersion)
+{
+    auto compactId = CompactHeaderEncoding::GetCompactId(header.Id());
+    if (compactId == MessageHeaderId::INVALID_SYSTEM_HEADER_ID)
+    {
+        return false;
+    }
+
+    // Action ids are versioned, all other compact encodings can be forwarded as is
+    if (header.IsCompact() && (header.Id() != MessageHeaderId::Action))
+    {
+        encoded.append(header.Start(), header.ByteTotalInStream());
+        return true;
+    }
+
+    switch (header.Id())
+    {
+    case MessageHeaderId::Action:
+        {
+            uint16 actionId;
+            if (!CompactHeaderEncoding::TryGetActionId(action_, compactHeaderVersion, actionId))
+            {
+                return false;
+            }
+
+            AppendCompact(encoded, compactId, &actionId, sizeof(actionId));
+            return true;
+        }
+    case MessageHeaderId::Actor:
+        {
+            uint16 actor = static_cast<uint16>(actor_);
+            AppendCompact(encoded, compactId, &actor, sizeof(actor));
+            return true;
+        }
+    case MessageHeaderId::MessageId:
+        {
+            CompactHeaderEncoding::MessageIdBody body = { messageId_.Guid.AsGUID(), messageId_.Index };
+            AppendCompact(encoded, compactId, &body, sizeof(body));
+            return true;
+        }
+    case MessageHeaderId::RelatesTo:
+        {
+            CompactHeaderEncoding::MessageIdBody body = { relatesTo_.Guid.AsGUID(), relatesTo_.Index };
+            AppendCompact(encoded, compactId, &body, sizeof(body));
+            return true;
+        }
+    case MessageHeaderId::FabricActivity:
+        {
+            FabricActivityHeader activityHeader = header.Deserialize<FabricActivityHeader>();
+            if (!header.IsValid) return false;
+
+            CompactHeaderEncoding::ActivityIdBody body = { activityHeader.Guid.AsGUID(), activityHeader.ActivityId.Index };
+            AppendCompact(encoded, compactId, &body, sizeof(body));
+            return true;
+        }
+    case MessageHeaderId::Timeout:
+        {
+            TimeoutHeader timeoutHeader = header.Deserialize<TimeoutHeader>();
+            if (!header.IsValid) return false;
+
+            int64 ticks = timeoutHeader.Timeout.Ticks;
+            AppendCompact(encoded, compactId, &ticks, sizeof(ticks));
+            return true;
+        }
+    default:
+        return false;
+    }
+}
+
+NTSTATUS MessageHeaders::AppendExpanded(ByteBique & encoded, HeaderReference & header)
+{
+    auto stream = Common::FabricSerializer::CreateSerializableStream();
+    NTSTATUS status = STATUS_SUCCESS;
+
+    switch (header.Id())
+    {
+    case MessageHeaderId::Action:
+        status = Serialize(*stream, header.Deserialize<ActionHeader>(), MessageHeaderId::Action);
+        break;
+    case MessageHeaderId::Actor:
+        status = Serialize(*stream, header.Deserialize<ActorHeader>(), MessageHeaderId::Actor);
+        break;
+    case MessageHeaderId::MessageId:
+        status = Serialize(*stream, header.Deserialize<MessageIdHeader>(), MessageHeaderId::MessageId);
+        break;
+    case MessageHeaderId::RelatesTo:
+        status = Serialize(*stream, header.Deserialize<RelatesToHeader>(), MessageHeaderId::RelatesTo);
+        break;
+    case MessageHeaderId::FabricActivity:
+        status = Serialize(*stream, header.Deserialize<FabricActivityHeader>(), MessageHeaderId::FabricActivity);
+        break;
+    case MessageHeaderId::Timeout:
+        status = Serialize(*stream, header.Deserialize<TimeoutHeader>(), MessageHeaderId::Timeout);
+        break;
+    default:
+        Assert::CodingError("unexpected compact header {0}", header.Id());
+    }
+
+    if (!this->IsValid) return this->Status;
+    if (NT_ERROR(status)) return status;
+
+    BiqueWriteStream bws(encoded);
+    return Add(bws, *stream);
+}
+
+void MessageHeaders::AppendCompact(ByteBique & encoded, MessageHeaderId::Enum compactId, void const * body, MessageHeaderSize size)
+{
+    BiqueWriteStream bws(encoded);
+    bws.SeekToEnd();
+    bws << compactId;
+    bws << size;
+    bws.WriteBytes(body, size);
+}
+
 void MessageHeaders::AppendFrom(MessageHeaders & other)
 {
+    peerEncodingValid_ = false;
+
     // Checkpoint other headers
     other.CheckPoint();
     other.deletedHeaderByteCount_ = 0; // all headers in "other" will be moved to "this"
@@ -652,6 +1037,7 @@ void MessageHeaders::AppendFrom(MessageHeaders & other)
 
 void MessageHeaders::SetShared(ByteBique & buffers, bool setCommonHeaders)
 {
+    peerEncodingValid_ = false;
     sharedHeaders_ = ByteBiqueRange(buffers.begin(), buffers.end(), true);
     CheckSize();
     if (setCommonHeaders)
@@ -671,6 +1057,7 @@ void MessageHeaders::Replace(ByteBiqueRange && otherRange)
 
 void MessageHeaders::ReplaceUnsafe(ByteBiqueRange && headers)
 {
+    peerEncodingValid_ = false;
     sharedHeaders_ = std::move(ByteBiqueRange(std::move(headers)));
     nonSharedHeaders_.truncate_before(nonSharedHeaders_.end());
     CheckSize();
@@ -734,6 +1121,7 @@ MessageHeaders::HeaderIterator& MessageHeaders::Remove(HeaderIterator& iter)
     }
 
     this->deletedHeaderByteCount_ += iter->ByteTotalInStream();
+    peerEncodingValid_ = false;
 
     return iter.Remove();
 }
@@ -744,6 +1132,7 @@ void MessageHeaders::RemoveAll()
     nonSharedHeaders_.truncate_before(nonSharedHeaders_.end());
 
     deletedHeaderByteCount_ = 0;
+    peerEncodingValid_ = false;
     ResetCommonHeaders();
 }
 
@@ -760,6 +1149,7 @@ void MessageHeaders::ResetCommonHeaders()
     faultErrorCodeValue_ = Common::ErrorCodeValue::Success;
     hasFaultBody_ = false;
     isUncorrelatedReply_ = false;
+    hasCompactHeaders_ = false;
 }
 
 NTSTATUS MessageHeaders::UpdateCommonHeaders()
@@ -770,6 +1160,11 @@ NTSTATUS MessageHeaders::UpdateCommonHeaders()
     HeaderIterator iter = Begin();
     for ( ; this->IsValid && iter != End(); ++ iter)
     {
+        if (iter->IsCompact())
+        {
+            hasCompactHeaders_ = true;
+        }
+
         switch (iter->Id())
         {
         case MessageHeaderId::Action:
@@ -934,6 +1329,7 @@ void MessageHeaders::CopyFrom(const MessageHeaders & other)
     recvTime_ = other.recvTime_;
 
     // todo, leikong, the assumption is there is no shared header, may need to clear first
+    peerEncodingValid_ = false;
     nonSharedHeaders_.append(other.nonSharedHeaders_.begin(), other.nonSharedHeaders_.size());
     nonSharedHeaders_.append(other.sharedHeaders_.Begin, other.sharedHeaders_.End - other.sharedHeaders_.Begin);
     UpdateCommonHeaders();
@@ -942,6 +1338,7 @@ void MessageHeaders::CopyFrom(const MessageHeaders & other)
 void MessageHeaders::CopyNonSharedHeadersFrom(const MessageHeaders & other)
 {
     CODING_ERROR_ASSERT(nonSharedHeaders_.empty());
+    peerEncodingValid_ = false;
     nonSharedHeaders_.append(other.nonSharedHeaders_.begin(), other.nonSharedHeaders_.size());
 
     UpdateCommonHeaders();
@@ -53,6 +53,7 @@ namespace Transport
         __declspec(property(get=get_HasFaultBody)) bool HasFaultBody;
         __declspec(property(get=get_IsUncorrelatedReply)) bool IsUncorrelatedReply;
         __declspec(property(get=get_DeletedHeaderByteCount)) size_t DeletedHeaderByteCount;
+        __declspec(property(get=get_HasCompactHeaders)) bool HasCompactHeaders;
 
         std::wstring const & get_Action() const;
         Actor::Enum get_Actor() const;
@@ -67,6 +68,7 @@ namespace Transport
         bool get_HasFaultBody() const;
         bool get_IsUncorrelatedReply() const;
         size_t get_DeletedHeaderByteCount() const;
+        bool get_HasCompactHeaders() const;
 
         // Support iteration over headers.
         class HeaderIterator;
@@ -112,6 +114,13 @@ namespace Transport
 
         void AppendFrom(MessageHeaders & headers);
 
+        // Rewrites the headers in the encoding negotiated with a connection peer: headers with a compact encoding
+        // are written compact when compactHeaderVersion is non-zero, and compact headers, e.g. on messages received
+        // from another node, are written back in their serializable form for peers that do not support them.
+        // Only headers that need it are rewritten, and nothing is rewritten again for the same version until the
+        // headers change.
+        NTSTATUS EncodeForPeer(uint16 compactHeaderVersion);
+
         // Replace the current headers with new ones. This is used for security (encrypting and decrypting).
         // If header doesn't currently exist, then just add it.
         template <class T> void Replace(T const & header);
@@ -212,6 +221,9 @@ namespace Transport
 
             template <class T> bool TryDeserialize(T & result);
 
+            // Whether the header is in its compact encoding, Id() is the id of the header it encodes
+            bool IsCompact() const;
+
             void WriteTo(Common::TextWriter & w, Common::FormatOptions const &) const;
         private:
             virtual void OnFault(NTSTATUS status);
@@ -219,9 +231,26 @@ namespace Transport
         private:
             bool TryDeserializeInternal(Serialization::IFabricSerializable* header);
 
+            bool TryDeserializeCompact(ActionHeader & header);
+            bool TryDeserializeCompact(ActorHeader & header);
+            bool TryDeserializeCompact(MessageIdHeader & header);
+            bool TryDeserializeCompact(RelatesToHeader & header);
+            bool TryDeserializeCompact(FabricActivityHeader & header);
+            bool TryDeserializeCompact(TimeoutHeader & header);
+
+            // Other headers have no compact encoding
+            template <class T> bool TryDeserializeCompact(T &)
+            {
+                Fault(STATUS_INVALID_PARAMETER);
+                return false;
+            }
+
+            bool ReadCompactBody(void * body, size_t size);
+
             HeaderIterator* headerIterator_;
             BiqueRangeStream* bufferStream_;
             MessageHeaderId::Enum id_;
+            bool compact_;
 
             // The total number of bytes occupied in the stream, serialzed MessageHeader object plus type and size fields
             size_t byteTotalInStream_; // Cannot use MessageHeaderSize as type due to possible overflow
@@ -299,6 +328,14 @@ namespace Transport
 
         NTSTATUS FinalizeIdempotentHeader();
 
+        bool NeedsReencoding(HeaderReference & header, uint16 compactHeaderVersion) const;
+        NTSTATUS AppendForPeer(ByteBique & encoded, HeaderReference & header, uint16 compactHeaderVersion, __inout bool & hasCompactHeaders);
+        NTSTATUS RewriteNonSharedForPeer(uint16 compactHeaderVersion);
+        NTSTATUS RewriteAllForPeer(uint16 compactHeaderVersion);
+        bool TryAppendCompact(ByteBique & encoded, HeaderReference & header, uint16 compactHeaderVersion);
+        NTSTATUS AppendExpanded(ByteBique & encoded, HeaderReference & header);
+        static void AppendCompact(ByteBique & encoded, MessageHeaderId::Enum compactId, void const * body, MessageHeaderSize size);
+
         static const size_t defaultOutgoingChunkSize_ = 1024;
         static size_t outgoingChunkSize_;
         static size_t MessageHeaders::compactThreshold_;
@@ -317,8 +354,13 @@ namespace Transport
         bool hasFaultBody_ = false;
         bool isUncorrelatedReply_ = false;
         bool isReply_ = false; // Need this extra field since relatesTo_ can be reset when security is enabled
+        bool hasCompactHeaders_ = false;
         bool checkpointDone_ = false;
 
+        // compact header version the headers were last encoded for by EncodeForPeer, valid until headers change
+        uint16 peerEncodingVersion_ = 0;
+        bool peerEncodingValid_ = false;
+
         Common::ErrorCodeValue::Enum faultErrorCodeValue_ = Common::ErrorCodeValue::Success;
         size_t deletedHeaderByteCount_ = 0;
 
@@ -561,6 +603,11 @@ namespace Transport
         return deletedBytesBetweenThisAndPredecessor_;
     }
 
+    inline bool MessageHeaders::HeaderReference::IsCompact() const
+    {
+        return compact_;
+    }
+
     template <class T>
     T MessageHeaders::HeaderReference::Deserialize()
     {
@@ -575,7 +622,8 @@ namespace Transport
     {
         ASSERT_IF(T::Id != this->id_, "MessageHeader Id mismatch!");
 
-        if (!TryDeserializeInternal(&t))
+        bool deserialized = compact_ ? TryDeserializeCompact(t) : TryDeserializeInternal(&t);
+        if (!deserialized)
         {
             t = T();
             return false;
@@ -673,4 +721,9 @@ namespace Transport
     {
         return this->deletedHeaderByteCount_;
     }
+
+    inline bool MessageHeaders::get_HasCompactHeaders() const
+    {
+        return hasCompactHeaders_;
+    }
 }
@@ -31,14 +31,21 @@ public:
     static void CleanupTest(bool uninstallCerts);
 
     static void RunRecvBufferSizeTests(SecurityProvider::Enum secProvider);
+    static void RunRequestTableTests();
     static void SetShouldQueueReceivedMessage(bool value);
 
+#ifdef PLATFORM_UNIX
+    static void RunEventLoopBackendTests(SecurityProvider::Enum secProvider);
+    static void RunIpcSharedMemoryTests();
+#endif
+
 private:
     void StartListener();
     void StartClient();
     void StartClientOnRemoteComputer();
     void WaitForResult(FileWriter & sw);
     static void PrintUsageAndExit();
+    static TimeSpan GetProcessCpuTime();
 
     IDatagramTransportSPtr listener_;
     SecurityProvider::Enum securityProvider_;
@@ -46,6 +53,8 @@ private:
     atomic_uint64 recvBytes_{0};
     PerfTestParameters testParameters_;
     Stopwatch stopwatch_;
+    TimeSpan cpuTimeAtStart_;
+    TimeSpan cpuTimeAtStop_;
     AutoResetEvent allReceived_;
     TimeSpan testTimeout_;
 
@@ -61,6 +70,11 @@ private:
     static uint messageSizeMax_;
     static bool shouldQueueReceivedMessage_;
 
+#ifdef PLATFORM_UNIX
+    static vector<EventLoop::Backend> eventLoopBackends_;
+    static EventLoopPool* eventLoopPool_;
+#endif
+
     static uint runCount_;
 };
 
@@ -97,6 +111,16 @@ bool PerfTest::shouldQueueReceivedMessage_ = qrDefault;
 
 uint PerfTest::runCount_ = 0;
 
+#ifdef PLATFORM_UNIX
+vector<EventLoop::Backend> PerfTest::eventLoopBackends_ = { EventLoop::Backend::Epoll, EventLoop::Backend::IoUring };
+EventLoopPool* PerfTest::eventLoopPool_ = nullptr;
+
+static wstring EventLoopBackendName(EventLoop::Backend backend)
+{
+    return (backend == EventLoop::Backend::IoUring) ? L"io_uring" : L"epoll";
+}
+#endif
+
 static const wstring clientExeName(L"Transport.PerfTest.Client.exe");
 static const wstring certSetupExe(L"RingCertSetup.exe");
 static const wstring lib0(L"FabricResources.dll");
@@ -157,6 +181,21 @@ void wmain(int argc, wchar_t* argv[])
 
     PerfTest::SetupTest(certs);
 
+    PerfTest::RunRequestTableTests();
+
+#ifdef PLATFORM_UNIX
+    PerfTest::RunIpcSharedMemoryTests();
+
+    if (securityProviderSet)
+    {
+        PerfTest::RunEventLoopBackendTests(securityProvider);
+    }
+    else
+    {
+        PerfTest::RunEventLoopBackendTests(SecurityProvider::None);
+        PerfTest::RunEventLoopBackendTests(SecurityProvider::Ssl);
+    }
+#else
     if (securityProviderSet)
     {
         PerfTest::RunRecvBufferSizeTests(securityProvider);
@@ -166,6 +205,7 @@ void wmain(int argc, wchar_t* argv[])
         PerfTest::RunRecvBufferSizeTests(SecurityProvider::None);
         PerfTest::RunRecvBufferSizeTests(SecurityProvider::Ssl);
     }
+#endif
 
     PerfTest::CleanupTest(certs);
 }
@@ -205,6 +245,13 @@ void PerfTest::StartListener()
         SecuritySettings securitySettings = TTestUtil::CreateTestSecuritySettings(securityProvider_, protectionLevel);
         Invariant(listener_->SetSecurity(securitySettings).IsSuccess());
 
+#ifdef PLATFORM_UNIX
+        if (eventLoopPool_)
+        {
+            listener_->SetEventLoopPool(eventLoopPool_);
+        }
+#endif
+
         auto root = make_shared<TestRoot>(); // make it real!
         listener_->SetMessageHandler([this, root](MessageUPtr & receivedMsg, ISendTarget::SPtr const & st)
         {
@@ -220,6 +267,7 @@ void PerfTest::StartListener()
 
             if (after == 2)
             {
+                cpuTimeAtStart_ = GetProcessCpuTime();
                 stopwatch_.Start();
                 if (after < (testParameters_.MessageCount() + 1))
                 {
@@ -230,6 +278,7 @@ void PerfTest::StartListener()
             if (after == (testParameters_.MessageCount() + 1))
             {
                 stopwatch_.Stop();
+                cpuTimeAtStop_ = GetProcessCpuTime();
                 allReceived_.Set();
 
                 // stop sending side
@@ -325,9 +374,16 @@ void PerfTest::WaitForResult(FileWriter & fw)
     auto totalReceivedBytes = recvBytes_.load();
     auto recvRate = (totalReceivedBytes * 8.0) / elapsedMilliseconds / 1000.0;
     console.WriteLine(">>> received: {0} bytes", totalReceivedBytes);
-    console.WriteLine(">>> receive rate: {0} mbps\n\n", recvRate);
+    console.WriteLine(">>> receive rate: {0} mbps", recvRate);
+
+    // the first message carries no payload of the test and is not timed
+    auto timedMessageCount = testParameters_.MessageCount() - 1;
+    auto messageRate = timedMessageCount * 1000.0 / elapsedMilliseconds;
+    auto cpuMicrosecondsPerMessage = (cpuTimeAtStop_ - cpuTimeAtStart_).Ticks / 10.0 / timedMessageCount;
+    console.WriteLine(">>> message rate: {0} messages/s", messageRate);
+    console.WriteLine(">>> listener process cpu: {0} us/message\n\n", cpuMicrosecondsPerMessage);
 
-    fw.Write(",{0},{1}", elapsedMilliseconds, recvRate);
+    fw.Write(",{0},{1},{2},{3}", elapsedMilliseconds, recvRate, messageRate, cpuMicrosecondsPerMessage);
 
     listener_->Stop();
     listener_.reset();
@@ -344,6 +400,281 @@ void PerfTest::Run(FileWriter & fw)
     WaitForResult(fw);
 }
 
+TimeSpan PerfTest::GetProcessCpuTime()
+{
+#ifdef PLATFORM_UNIX
+    rusage usage = {};
+    Invariant(getrusage(RUSAGE_SELF, &usage) == 0);
+    auto microseconds =
+        (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL +
+        usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+
+    return TimeSpan::FromTicks(microseconds * 10);
+#else
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    Invariant(::GetProcessTimes(::GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime));
+    ULARGE_INTEGER kernel = { kernelTime.dwLowDateTime, kernelTime.dwHighDateTime };
+    ULARGE_INTEGER user = { userTime.dwLowDateTime, userTime.dwHighDateTime };
+
+    return TimeSpan::FromTicks(kernel.QuadPart + user.QuadPart);
+#endif
+}
+
+#ifdef PLATFORM_UNIX
+
+void PerfTest::RunEventLoopBackendTests(SecurityProvider::Enum secProvider)
+{
+    for (auto backend : eventLoopBackends_)
+    {
+        // loop threads are detached and never exit, so the pools live until the process exits
+        eventLoopPool_ = new EventLoopPool(wformatString("PerfTest.{0}", EventLoopBackendName(backend)), 0, backend);
+
+        console.WriteLine("=========================================================");
+        console.WriteLine(
+            "event loop backend = {0}, requested = {1}",
+            EventLoopBackendName(eventLoopPool_->ActiveBackend()),
+            EventLoopBackendName(backend));
+
+        if (eventLoopPool_->ActiveBackend() != backend)
+        {
+            console.WriteLine("!!! {0} is not supported by this kernel, skipping !!!", EventLoopBackendName(backend));
+            continue;
+        }
+
+        RunRecvBufferSizeTests(secProvider);
+    }
+
+    eventLoopPool_ = nullptr;
+}
+
+#endif
+
+template <class TInsertRemove>
+static double MeasureInsertRemove(size_t threadCount, size_t operationsPerThread, TInsertRemove const & insertRemove)
+{
+    atomic_uint64 ready(0);
+    ManualResetEvent start(false);
+    vector<std::thread> threads;
+
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back([&]
+        {
+            ++ready;
+            start.WaitOne();
+
+            for (size_t j = 0; j < operationsPerThread; ++j)
+            {
+                insertRemove(MessageId());
+            }
+        });
+    }
+
+    while (ready.load() < threadCount)
+    {
+        Sleep(1);
+    }
+
+    Stopwatch stopwatch;
+    stopwatch.Start();
+    start.Set();
+
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    stopwatch.Stop();
+    return (threadCount * operationsPerThread) / stopwatch.Elapsed.TotalSeconds();
+}
+
+// insert/remove pairs per second, striped RequestTable vs. single lock map
+void PerfTest::RunRequestTableTests()
+{
+#ifdef DBG
+    const size_t operationsPerThread = 5000;
+#else
+    const size_t operationsPerThread = 50000;
+#endif
+
+    console.WriteLine("=========================================================");
+    console.WriteLine("request table, operations per thread = {0}", operationsPerThread);
+    console.WriteLine("=========================================================");
+
+    RequestTable table;
+    SynchronizedMap<MessageId, RequestAsyncOperationSPtr> singleLockMap;
+    auto operation = make_shared<RequestAsyncOperation>(table, MessageId(), TimeSpan::MaxValue, [](AsyncOperationSPtr const &) {}, AsyncOperationSPtr());
+
+    for (size_t threadCount = 1; threadCount <= 64; threadCount *= 2)
+    {
+        auto stripedRate = MeasureInsertRemove(threadCount, operationsPerThread, [&](MessageId const & id)
+        {
+            RequestAsyncOperationSPtr removed;
+            table.TryInsertEntry(id, operation);
+            table.TryRemoveEntry(id, removed);
+        });
+
+        auto singleLockRate = MeasureInsertRemove(threadCount, operationsPerThread, [&](MessageId const & id)
+        {
+            RequestAsyncOperationSPtr removed;
+            singleLockMap.TryAdd(id, operation);
+            singleLockMap.TryGetAndRemove(id, removed);
+        });
+
+        console.WriteLine(
+            "threads = {0}, striped = {1}/s, single lock = {2}/s",
+            threadCount,
+            static_cast<uint64>(stripedRate),
+            static_cast<uint64>(singleLockRate));
+
+        Invariant(table.Count() == 0);
+        Invariant(singleLockMap.Count() == 0);
+    }
+
+    table.Close();
+}
+
+#ifdef PLATFORM_UNIX
+
+static MessageUPtr CreateIpcMessage(Actor::Enum actor)
+{
+    auto message = make_unique<Message>();
+    message->Headers.Add(MessageIdHeader());
+    message->Headers.Add(ActorHeader(actor));
+    return message;
+}
+
+// IpcClient requests to an IpcServer, with the Negotiate security settings FabricNode and ApplicationHost use
+static void MeasureIpcRequestReply(bool useSharedMemory, __out TimeSpan & roundTripLatency, __out int64 & requestsPerSecond)
+{
+    const uint roundTripCount = 2000;
+    const LONG window = 64;
+    const uint batchCount = 200;
+
+    auto & config = TransportConfig::GetConfig();
+    auto savedSharedMemoryEnabled = config.IpcSharedMemoryEnabled;
+    config.IpcSharedMemoryEnabled = useSharedMemory;
+    KFinally([&] { config.IpcSharedMemoryEnabled = savedSharedMemoryEnabled; });
+
+    auto root = make_shared<TestRoot>();
+    auto listenAddress = TTestUtil::GetListenAddress();
+    auto server = make_shared<IpcServer>(
+        *root,
+        listenAddress,
+        L"",
+        L"PerfTest",
+        false /* disallow use of unreliable transport */,
+        L"PerfTest");
+
+    SecuritySettings serverSecuritySettings;
+    Invariant(SecuritySettings::CreateNegotiateServer(L"", serverSecuritySettings).IsSuccess());
+    Invariant(server->SetSecurity(serverSecuritySettings).IsSuccess());
+    Invariant(server->Open().IsSuccess());
+
+    Common::atomic_bool lastPathMatched(false);
+    server->RegisterMessageHandler(
+        Actor::IpcTestActor1,
+        [&] (MessageUPtr &, IpcReceiverContextUPtr & context)
+        {
+            lastPathMatched.store(IpcSharedMemoryTransport::IsSharedMemoryTarget(*context->ReplyTarget) == useSharedMemory);
+            context->Reply(CreateIpcMessage(Actor::IpcTestActor2));
+        },
+        true/*dispatchOnTransportThread*/);
+
+    auto client = make_shared<IpcClient>(*root, L"client0", listenAddress, false /* disallow use of unreliable transport */, L"PerfTest");
+
+    SecuritySettings clientSecuritySettings;
+    Invariant(SecuritySettings::CreateNegotiateClient(TransportSecurity().LocalWindowsIdentity(), clientSecuritySettings).IsSuccess());
+    client->SecuritySettings = clientSecuritySettings;
+    Invariant(client->Open().IsSuccess());
+
+    auto sendRequest = [&] (std::function<void()> const & onReply)
+    {
+        client->BeginRequest(
+            CreateIpcMessage(Actor::IpcTestActor1),
+            TimeSpan::FromSeconds(30),
+            [client, onReply] (AsyncOperationSPtr const & operation)
+            {
+                MessageUPtr reply;
+                Invariant(client->EndRequest(operation, reply).IsSuccess());
+                onReply();
+            },
+            AsyncOperationSPtr());
+    };
+
+    // the first requests set up the connection and go through TCP until the shared memory handshake is
+    // acknowledged, keep them out of the measurements
+    do
+    {
+        ManualResetEvent warmedUp(false);
+        sendRequest([&] { warmedUp.Set(); });
+        Invariant(warmedUp.WaitOne(TimeSpan::FromSeconds(30)));
+    } while (!lastPathMatched.load());
+
+    // one request outstanding at a time
+    Stopwatch stopwatch;
+    stopwatch.Start();
+    for (uint i = 0; i < roundTripCount; ++i)
+    {
+        ManualResetEvent replied(false);
+        sendRequest([&] { replied.Set(); });
+        Invariant(replied.WaitOne(TimeSpan::FromSeconds(30)));
+    }
+
+    stopwatch.Stop();
+    roundTripLatency = TimeSpan::FromTicks(stopwatch.ElapsedTicks / roundTripCount);
+
+    // window requests outstanding at a time
+    stopwatch.Restart();
+    for (uint i = 0; i < batchCount; ++i)
+    {
+        Common::atomic_long pendingCount(window);
+        ManualResetEvent batchReplied(false);
+        for (LONG j = 0; j < window; ++j)
+        {
+            sendRequest([&] { if (--pendingCount == 0) { batchReplied.Set(); } });
+        }
+
+        Invariant(batchReplied.WaitOne(TimeSpan::FromSeconds(30)));
+    }
+
+    stopwatch.Stop();
+    requestsPerSecond = (batchCount * window * 1000000LL) / std::max<int64>(stopwatch.ElapsedMicroseconds, 1);
+
+    Invariant(lastPathMatched.load());
+
+    client->Close();
+    server->Close();
+}
+
+// request/reply round trip latency and throughput, IPC through TCP vs. shared memory
+void PerfTest::RunIpcSharedMemoryTests()
+{
+    console.WriteLine("=========================================================");
+    console.WriteLine("IPC request/reply, TCP vs. shared memory");
+    console.WriteLine("=========================================================");
+
+    TimeSpan tcpLatency;
+    int64 tcpRequestsPerSecond;
+    MeasureIpcRequestReply(false, tcpLatency, tcpRequestsPerSecond);
+
+    TimeSpan sharedMemoryLatency;
+    int64 sharedMemoryRequestsPerSecond;
+    MeasureIpcRequestReply(true, sharedMemoryLatency, sharedMemoryRequestsPerSecond);
+
+    console.WriteLine(
+        "round trip latency: tcp = {0}us, shared memory = {1}us",
+        tcpLatency.Ticks / 10,
+        sharedMemoryLatency.Ticks / 10);
+
+    console.WriteLine(
+        "throughput: tcp = {0} requests/s, shared memory = {1} requests/s",
+        tcpRequestsPerSecond,
+        sharedMemoryRequestsPerSecond);
+}
+
+#endif
+
 void PerfTest::RunRecvBufferSizeTests(SecurityProvider::Enum secProvider)
 {
     console.WriteLine("=========================================================");
@@ -353,9 +684,15 @@ void PerfTest::RunRecvBufferSizeTests(SecurityProvider::Enum secProvider)
 
     for (uint clientThreadCount = clientThreadMin_; clientThreadCount <= clientThreadMax_; ++clientThreadCount)
     {
+#ifdef PLATFORM_UNIX
+        wstring outputFile = wformatString(
+            "PerfTest-QueueReceived@{0}_ClientThread@{1}_Sec@{2}_EventLoop@{3}.csv",
+            shouldQueueReceivedMessage_, clientThreadCount, secProvider, EventLoopBackendName(eventLoopPool_->ActiveBackend()));
+#else
         wstring outputFile = wformatString(
             "PerfTest-QueueReceived@{0}_ClientThread@{1}_Sec@{2}.csv",
             shouldQueueReceivedMessage_, clientThreadCount, secProvider);
+#endif
 
         console.WriteLine("+++++++++++++++++++++++++++++++++++++++++++++++++++++++++");
         console.WriteLine("client thread count = {0}", clientThreadCount);
@@ -425,6 +762,7 @@ static const wstring mminArg = L"-mmin";
 static const wstring mmaxArg = L"-mmax";
 static const wstring qrArg = L"-qr";
 static const wstring securityArg = L"-security";
+static const wstring eventLoopArg = L"-eventLoop";
 
 void PerfTest::ParseCmdline(int argc, wchar_t* argv[])
 {
@@ -581,6 +919,26 @@ void PerfTest::ParseCmdline(int argc, wchar_t* argv[])
             continue;
         }
 
+#ifdef PLATFORM_UNIX
+        if (StringUtility::AreEqualCaseInsensitive(tokens.front(), eventLoopArg))
+        {
+            if (StringUtility::AreEqualCaseInsensitive(tokens[1], L"epoll"))
+            {
+                eventLoopBackends_ = { EventLoop::Backend::Epoll };
+            }
+            else if (StringUtility::AreEqualCaseInsensitive(tokens[1], L"io_uring"))
+            {
+                eventLoopBackends_ = { EventLoop::Backend::IoUring };
+            }
+            else
+            {
+                console.WriteLine("Failed to parse '{0}' as event loop backend", tokens[1]); 
+                PrintUsageAndExit();
+            }
+            continue;
+        }
+#endif
+
         PrintUsageAndExit();
     }
 
@@ -619,6 +977,9 @@ void PerfTest::PrintUsageAndExit()
     console.WriteLine("{0}:maximal message size, default to {1}", mmaxArg, msizeMaxDefault);
     console.WriteLine("{0}:whether to queue received messages, default to {1}", qrArg, qrDefault);
     console.WriteLine("{0}:security provider, by default, all providers will be used", securityArg);
+#ifdef PLATFORM_UNIX
+    console.WriteLine("{0}:event loop backend, epoll or io_uring, by default, both backends will be compared", eventLoopArg);
+#endif
 
     ::ExitProcess(1);
 }
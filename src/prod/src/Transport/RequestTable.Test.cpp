@@ -237,5 +237,56 @@ namespace TransportUnitTest
         VERIFY_IS_TRUE(callbackFired.WaitOne(TimeSpan::FromSeconds(5)));
     }
 
+    BOOST_AUTO_TEST_CASE(StripedTableTest)
+    {
+        RequestTable table;
+        auto operation = make_shared<RequestAsyncOperation>(table, MessageId(), TimeSpan::MaxValue, [](AsyncOperationSPtr const &) {}, AsyncOperationSPtr());
+
+        // enough entries to grow every stripe several times
+        vector<MessageId> messageIds;
+        for (int i = 0; i < 10000; ++i)
+        {
+            messageIds.push_back(MessageId());
+            VERIFY_IS_TRUE(table.TryInsertEntry(messageIds.back(), operation).IsSuccess());
+        }
+
+        VERIFY_ARE_EQUAL2(table.Count(), messageIds.size());
+
+        // remove every third entry, backward shift deletion must keep the rest reachable
+        for (size_t i = 0; i < messageIds.size(); i += 3)
+        {
+            RequestAsyncOperationSPtr removed;
+            VERIFY_IS_TRUE(table.TryRemoveEntry(messageIds[i], removed));
+            VERIFY_IS_TRUE(removed == operation);
+            VERIFY_IS_FALSE(table.TryRemoveEntry(messageIds[i], removed));
+        }
+
+        auto removedByPredicate = table.RemoveIf([](pair<MessageId, RequestAsyncOperationSPtr> const & entry)
+        {
+            return (entry.first.Index % 2) == 0;
+        });
+
+        for (auto const & entry : removedByPredicate)
+        {
+            VERIFY_IS_TRUE((entry.first.Index % 2) == 0);
+            VERIFY_IS_TRUE(entry.second == operation);
+        }
+
+        size_t remaining = 0;
+        for (size_t i = 0; i < messageIds.size(); ++i)
+        {
+            RequestAsyncOperationSPtr removed;
+            bool expected = ((i % 3) != 0) && ((messageIds[i].Index % 2) != 0);
+            VERIFY_ARE_EQUAL2(table.TryRemoveEntry(messageIds[i], removed), expected);
+            remaining += expected ? 1 : 0;
+        }
+
+        VERIFY_ARE_EQUAL2(removedByPredicate.size() + remaining + (messageIds.size() + 2) / 3, messageIds.size());
+        VERIFY_ARE_EQUAL2(table.Count(), 0);
+
+        table.Close();
+        VERIFY_IS_TRUE(table.TryInsertEntry(MessageId(), operation).IsError(ErrorCodeValue::ObjectClosed));
+    }
+
     BOOST_AUTO_TEST_SUITE_END()
 }
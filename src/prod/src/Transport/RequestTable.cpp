@@ -10,13 +10,42 @@ using namespace Common;
 
 static Common::StringLiteral const TraceType("RequestTable");
 
-RequestTable::RequestTable() : table_()
+namespace
 {
+    size_t const InitialStripeCapacity = 16; // must be a power of 2
+    int const StripeIndexShift = 58; // top 6 bits of the hash select one of the 64 stripes
+}
+
+RequestTable::RequestTable()
+{
+    static_assert((StripeCount >> (64 - StripeIndexShift)) == 1, "StripeIndexShift must match StripeCount");
+}
+
+uint64 RequestTable::GetHash(Transport::MessageId const & messageId)
+{
+    // Local message ids share the process guid and differ in index, so both need to be mixed into the bits used
+    // for stripe and slot selection. Finalizer from MurmurHash3.
+    uint64 guidWords[2];
+    memcpy(guidWords, &messageId.Guid.AsGUID(), sizeof(guidWords));
+
+    uint64 hash = guidWords[0] ^ (guidWords[1] * 0x9E3779B97F4A7C15ull) ^ messageId.Index;
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+RequestTable::Stripe & RequestTable::GetStripe(uint64 hash)
+{
+    return stripes_[hash >> StripeIndexShift];
 }
 
 ErrorCode RequestTable::TryInsertEntry(Transport::MessageId const & messageId, RequestAsyncOperationSPtr & entry)
 {
-    auto error = this->table_.TryAdd(messageId, entry);
+    auto hash = GetHash(messageId);
+    auto error = GetStripe(hash).TryAdd(messageId, hash, entry);
     if (!error.IsSuccess())
     {
         if (error.IsError(ErrorCodeValue::ObjectClosed))
@@ -35,12 +64,19 @@ ErrorCode RequestTable::TryInsertEntry(Transport::MessageId const & messageId, R
 
 bool RequestTable::TryRemoveEntry(Transport::MessageId const & messageId, RequestAsyncOperationSPtr & operation)
 {
-    return this->table_.TryGetAndRemove(messageId, operation);
+    auto hash = GetHash(messageId);
+    return GetStripe(hash).TryGetAndRemove(messageId, hash, operation);
 }
 
 std::vector<std::pair<Transport::MessageId, RequestAsyncOperationSPtr>> RequestTable::RemoveIf(std::function<bool(std::pair<MessageId, RequestAsyncOperationSPtr> const&)> const & predicate)
 {
-    return table_.RemoveIf(predicate);
+    std::vector<std::pair<Transport::MessageId, RequestAsyncOperationSPtr>> removed;
+    for (auto & stripe : stripes_)
+    {
+        stripe.RemoveIf(predicate, removed);
+    }
+
+    return removed;
 }
 
 bool RequestTable::OnReplyMessage(Transport::Message & reply)
@@ -72,9 +108,168 @@ bool RequestTable::OnReplyMessage(Transport::Message & reply)
 
 void RequestTable::Close()
 {
-    auto tableCopy = this->table_.Close();
-    for(auto iter = tableCopy.begin(); iter != tableCopy.end(); ++ iter)
+    std::vector<RequestAsyncOperationSPtr> operations;
+    for (auto & stripe : stripes_)
+    {
+        stripe.Close(operations);
+    }
+
+    // Cancel outside stripe locks, cancelled operations remove themselves from the table
+    for(auto iter = operations.begin(); iter != operations.end(); ++ iter)
+    {
+        (*iter)->Cancel();
+    }
+}
+
+size_t RequestTable::Count() const
+{
+    size_t count = 0;
+    for (auto const & stripe : stripes_)
+    {
+        count += stripe.Count();
+    }
+
+    return count;
+}
+
+RequestTable::Stripe::Stripe() : slots_(), count_(0), closed_(false)
+{
+}
+
+ErrorCode RequestTable::Stripe::TryAdd(Transport::MessageId const & messageId, uint64 hash, RequestAsyncOperationSPtr const & operation)
+{
+    AcquireWriteLock grab(lock_);
+    if (closed_) return ErrorCodeValue::ObjectClosed;
+
+    size_t mask = slots_.size() - 1;
+    for (size_t i = hash & mask; !slots_.empty() && slots_[i].Operation; i = (i + 1) & mask)
+    {
+        if ((slots_[i].Hash == hash) && (slots_[i].Id == messageId))
+        {
+            return ErrorCodeValue::AlreadyExists;
+        }
+    }
+
+    // keep load factor at or below 1/2 so that probe sequences stay short
+    if ((count_ + 1) * 2 > slots_.size())
+    {
+        Grow_CallerHoldingLock();
+    }
+
+    Insert_CallerHoldingLock(Slot(messageId, hash, operation));
+    ++count_;
+    return ErrorCodeValue::Success;
+}
+
+bool RequestTable::Stripe::TryGetAndRemove(Transport::MessageId const & messageId, uint64 hash, __out RequestAsyncOperationSPtr & operation)
+{
+    AcquireWriteLock grab(lock_);
+
+    size_t mask = slots_.size() - 1;
+    for (size_t i = hash & mask; !slots_.empty() && slots_[i].Operation; i = (i + 1) & mask)
+    {
+        if ((slots_[i].Hash == hash) && (slots_[i].Id == messageId))
+        {
+            operation = std::move(slots_[i].Operation);
+            RemoveAt_CallerHoldingLock(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void RequestTable::Stripe::RemoveIf(
+    std::function<bool(std::pair<MessageId, RequestAsyncOperationSPtr> const&)> const & predicate,
+    __inout std::vector<std::pair<Transport::MessageId, RequestAsyncOperationSPtr>> & removed)
+{
+    AcquireWriteLock grab(lock_);
+
+    for (size_t i = 0; i < slots_.size();)
     {
-        iter->second->Cancel();
+        if (slots_[i].Operation)
+        {
+            auto entry = std::make_pair(slots_[i].Id, slots_[i].Operation);
+            if (predicate(entry))
+            {
+                removed.emplace_back(std::move(entry));
+                slots_[i].Operation.reset();
+                RemoveAt_CallerHoldingLock(i);
+
+                // backward shift may have moved a later entry into slot i
+                continue;
+            }
+        }
+
+        ++i;
+    }
+}
+
+void RequestTable::Stripe::Close(__inout std::vector<RequestAsyncOperationSPtr> & operations)
+{
+    AcquireWriteLock grab(lock_);
+
+    closed_ = true;
+    for (auto & slot : slots_)
+    {
+        if (slot.Operation)
+        {
+            operations.emplace_back(std::move(slot.Operation));
+        }
+    }
+
+    count_ = 0;
+}
+
+size_t RequestTable::Stripe::Count() const
+{
+    AcquireReadLock grab(lock_);
+    return count_;
+}
+
+void RequestTable::Stripe::Insert_CallerHoldingLock(Slot && slot)
+{
+    size_t mask = slots_.size() - 1;
+    size_t i = slot.Hash & mask;
+    while (slots_[i].Operation)
+    {
+        i = (i + 1) & mask;
+    }
+
+    slots_[i] = std::move(slot);
+}
+
+void RequestTable::Stripe::RemoveAt_CallerHoldingLock(size_t index)
+{
+    // Backward shift deletion: move later entries of the probe sequence into the hole, unless that would move an
+    // entry before its home slot, so that lookups never need tombstones.
+    size_t mask = slots_.size() - 1;
+    size_t hole = index;
+    for (size_t i = (hole + 1) & mask; slots_[i].Operation; i = (i + 1) & mask)
+    {
+        size_t home = slots_[i].Hash & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            slots_[hole] = std::move(slots_[i]);
+            slots_[i].Operation.reset();
+            hole = i;
+        }
+    }
+
+    slots_[hole].Operation.reset();
+    --count_;
+}
+
+void RequestTable::Stripe::Grow_CallerHoldingLock()
+{
+    std::vector<Slot> old(slots_.empty() ? InitialStripeCapacity : slots_.size() * 2);
+    old.swap(slots_);
+
+    for (auto & slot : old)
+    {
+        if (slot.Operation)
+        {
+            Insert_CallerHoldingLock(std::move(slot));
+        }
     }
 }
@@ -7,6 +7,11 @@
 
 namespace Transport
 {
+    //
+    // Pending requests keyed by MessageId. The table is split into lock stripes selected by the MessageId hash, so
+    // requests and replies for different messages rarely contend. Each stripe is an open addressing table with
+    // linear probing and backward shift deletion, slots are reused and only allocated when a stripe grows.
+    //
     class RequestTable : Common::TextTraceComponent<Common::TraceTaskCodes::Transport>
     {
         DENY_COPY(RequestTable);
@@ -24,7 +29,48 @@ namespace Transport
 
         void Close();
 
+        size_t Count() const;
+
     private:
-        Common::SynchronizedMap<Transport::MessageId, RequestAsyncOperationSPtr> table_;
+        struct Slot
+        {
+            Slot() : Id(Common::Guid::Empty(), 0), Hash(0) { }
+            Slot(Transport::MessageId const & id, uint64 hash, RequestAsyncOperationSPtr const & operation)
+                : Id(id), Hash(hash), Operation(operation) { }
+
+            Transport::MessageId Id;
+            uint64 Hash;
+            RequestAsyncOperationSPtr Operation; // empty slot if null
+        };
+
+        class DECLSPEC_CACHEALIGN Stripe
+        {
+        public:
+            Stripe();
+
+            Common::ErrorCode TryAdd(Transport::MessageId const & messageId, uint64 hash, RequestAsyncOperationSPtr const & operation);
+            bool TryGetAndRemove(Transport::MessageId const & messageId, uint64 hash, __out RequestAsyncOperationSPtr & operation);
+            void RemoveIf(
+                std::function<bool(std::pair<MessageId, RequestAsyncOperationSPtr> const&)> const & predicate,
+                __inout std::vector<std::pair<Transport::MessageId, RequestAsyncOperationSPtr>> & removed);
+            void Close(__inout std::vector<RequestAsyncOperationSPtr> & operations);
+            size_t Count() const;
+
+        private:
+            void Insert_CallerHoldingLock(Slot && slot);
+            void RemoveAt_CallerHoldingLock(size_t index);
+            void Grow_CallerHoldingLock();
+
+            MUTABLE_RWLOCK(Transport.RequestTable, lock_);
+            std::vector<Slot> slots_;
+            size_t count_;
+            bool closed_;
+        };
+
+        static uint64 GetHash(Transport::MessageId const & messageId);
+        Stripe & GetStripe(uint64 hash);
+
+        static const size_t StripeCount = 64;
+        Stripe stripes_[StripeCount];
     };
 }
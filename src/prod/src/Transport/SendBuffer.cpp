@@ -247,6 +247,14 @@ ErrorCode SendBuffer::EnqueueMessage(MessageUPtr && message, TimeSpan expiration
 
 ErrorCode SendBuffer::Enqueue(MessageUPtr && message, TimeSpan expiration, bool shouldEncrypt)
 {
+    auto status = message->Headers.EncodeForPeer(connection_->compactHeaderVersion_);
+    if (!NT_SUCCESS(status))
+    {
+        auto error = ErrorCode::FromNtStatus(status);
+        message->OnSendStatus(error, move(message));
+        return error;
+    }
+
     if (shouldAddSecNegoHeader_)
     {
         shouldAddSecNegoHeader_ = false;
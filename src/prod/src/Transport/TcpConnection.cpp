@@ -207,6 +207,7 @@ bool TcpConnection::Initialize(
         transport->ListenAddress(),
         transport->Instance(),
         ListenSideNonce());
+    localListenInstance_.SetCompactHeaderVersion(CompactHeaderEncoding::LocalVersion());
 
     shouldTraceInboundActivity_ = transport->ShouldTraceInboundActivity();
     allowThrottleReplyMessage_ = transport->AllowedToThrottleReply();
@@ -425,6 +426,17 @@ void TcpConnection::OnRemoteFrameSizeLimit(size_t remoteIncomingMax)
     }
 }
 
+void TcpConnection::OnRemoteCompactHeaderVersion(uint16 remoteVersion)
+{
+    AcquireWriteLock lockInScope(lock_);
+
+    compactHeaderVersion_ = std::min(localListenInstance_.CompactHeaderVersion(), remoteVersion);
+    WriteInfo(
+        TraceType, traceId_,
+        "OnRemoteCompactHeaderVersion: local={0}, remote={1}, negotiated={2}",
+        localListenInstance_.CompactHeaderVersion(), remoteVersion, compactHeaderVersion_);
+}
+
 void TcpConnection::DisableOutgoingFrameSizeLimit()
 {
     //TcpFrameHeader::FrameSizeHardLimit() means limit is disabled,
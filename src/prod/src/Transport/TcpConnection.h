@@ -106,6 +106,7 @@ namespace Transport
         size_t IncomingFrameSizeLimit() const override { return maxIncomingFrameSizeInBytes_; }
         size_t OutgoingFrameSizeLimit() const override { return maxOutgoingFrameSizeInBytes_; }
         void OnRemoteFrameSizeLimit(size_t remoteIncomingMax) override;
+        void OnRemoteCompactHeaderVersion(uint16 remoteVersion) override;
 
         void PurgeExpiredOutgoingMessages(Common::StopwatchTime now) override;
 
@@ -256,6 +257,7 @@ namespace Transport
 
         size_t maxIncomingFrameSizeInBytes_ = TcpFrameHeader::FrameSizeHardLimit();
         size_t maxOutgoingFrameSizeInBytes_ = TcpFrameHeader::FrameSizeHardLimit();
+        uint16 compactHeaderVersion_ = 0; // negotiated with remote listen instance, 0 until then
         const ULONG receiveChunkSize_;
         ULONG receiveBufferToReserve_ = 0;
 
@@ -488,6 +488,7 @@ void TcpDatagramTransport::OnListenInstanceMessage(
         return;
     }
 
+    connection.OnRemoteCompactHeaderVersion(remoteListenInstance.CompactHeaderVersion());
     connection.OnConnectionReady();
 
 #ifdef DBG
@@ -49,6 +49,7 @@
 #include "BiqueChunkIterator.h"
 #include "BiqueRangeStream.h"
 #include "BiqueWriteStream.h"
+#include "CompactHeaderEncoding.h"
 
 #include "MessageHeaders.h"
 #include "MessageHeadersCollection.h"
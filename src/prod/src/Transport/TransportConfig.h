@@ -114,6 +114,13 @@ namespace Transport
         // The time Ipc server and client connection needs to remain idle before TCP starts sending keepalive probes.
         INTERNAL_CONFIG_ENTRY(Common::TimeSpan, L"Transport", IpcKeepaliveIdleTime, Common::TimeSpan::FromSeconds(5), Common::ConfigEntryUpgradePolicy::Static);
 
+        // Carry non-secure IPC through shared memory rings with eventfd wakeups instead of loopback TCP, Linux only.
+        // IpcClient falls back to TCP when the IpcServer does not accept shared memory clients.
+        INTERNAL_CONFIG_ENTRY(bool, L"Transport", IpcSharedMemoryEnabled, false, Common::ConfigEntryUpgradePolicy::Static);
+        // Size in bytes of each of the two rings shared by an IpcClient and IpcServer, must be a power of two.
+        // Messages that do not fit are passed through the ring in fragments.
+        INTERNAL_CONFIG_ENTRY(uint, L"Transport", IpcSharedMemoryRingSize, 1024*1024, Common::ConfigEntryUpgradePolicy::Static);
+
         // Default close delay for scheduled close
         DEPRECATED_CONFIG_ENTRY(Common::TimeSpan, L"Transport", DefaultCloseDelay, Common::TimeSpan::FromSeconds(60), Common::ConfigEntryUpgradePolicy::Dynamic, Common::TimeSpanNoLessThan(Common::TimeSpan::Zero));
 
@@ -150,6 +157,9 @@ namespace Transport
         // For testing IPv6 usage.  If true, transport will fail open if the endpoint is not an IPv6 address
         TEST_CONFIG_ENTRY(bool, L"Transport", TestOnlyValidateIPv6Usage, false, Common::ConfigEntryUpgradePolicy::Static);
 
+        // Whether to send hot message headers in their compact binary encoding to peers that support it
+        INTERNAL_CONFIG_ENTRY(bool, L"Transport", CompactMessageHeadersEnabled, false, Common::ConfigEntryUpgradePolicy::Static);
+
         // Default setting for error checking on frame header in non-secure mode, component setting overrides this
         PUBLIC_CONFIG_ENTRY(bool, L"Transport", FrameHeaderErrorCheckingEnabled, true, Common::ConfigEntryUpgradePolicy::Static);
 
@@ -579,7 +579,8 @@ void TransportSecurity::ReportCertHealthIfNeeded_LockHeld(bool newCredentialLoad
 wstring const & TransportSecurity::LocalWindowsIdentity()
 {
     ASSERT_IFNOT(this->SecurityProvider == SecurityProvider::None, "Not implemented");
-    return L"";
+    static wstring const emptyIdentity;
+    return emptyIdentity;
 }
 
 bool TransportSecurity::RunningAsMachineAccount()
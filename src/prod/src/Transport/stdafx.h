@@ -16,6 +16,12 @@
 #include <ifaddrs.h>
 #include <sys/uio.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <linux/memfd.h>
+#include <atomic>
 #include <openssl/bio.h>
 #include <openssl/err.h>
 #include <openssl/evp.h>
@@ -56,6 +62,10 @@
 #include "Transport/TcpDatagramTransport.h"
 #include "Transport/MemoryTransport.h"
 #include "Transport/UnreliableTransport.h"
+#ifdef PLATFORM_UNIX
+#include "Transport/IpcSharedMemoryRing.h"
+#include "Transport/IpcSharedMemoryTransport.h"
+#endif
 #include "Transport/PerfCounters.h"
 #include "Transport/Throttle.h"
 #include "Transport/ListenSocket.h"
@@ -480,6 +480,30 @@ ktl::Awaitable<NTSTATUS> FileLogicalLog::AppendAsync(
     co_return STATUS_SUCCESS;
 }
 
+// write API, takes write lock
+ktl::Awaitable<NTSTATUS> FileLogicalLog::AppendAsync(
+    __in OperationData const & Buffers,
+    __in CancellationToken const &
+    )
+{
+    NTSTATUS status;
+
+    BOOL acquired = co_await writeStreamLock_->AcquireWriteLockAsync(defaultLockTimeoutMs_);
+    CODING_ERROR_ASSERT(acquired);
+
+    KFinally([&] {writeStreamLock_->ReleaseWriteLock(); });
+
+    for (ULONG32 i = 0; i < Buffers.BufferCount; i++)
+    {
+        KBuffer::CSPtr buffer = Buffers[i];
+
+        status = co_await writeStream_->WriteAsync(*buffer, 0, buffer->QuerySize());
+        VERIFY_SUCCESS_CORETURN(status, "writeStream_->WriteAsync");
+    }
+
+    co_return STATUS_SUCCESS;
+}
+
 // write API, takes write lock
 ktl::Awaitable<NTSTATUS> FileLogicalLog::FlushAsync(
     __in CancellationToken const &
@@ -178,6 +178,24 @@ namespace Data
                 __in ULONG count,
                 __in ktl::CancellationToken const & cancellationToken) = 0;
 
+            /// <summary>
+            /// Write all buffers of the operation data, in order, to the current stream at WriteLocation, advancing the position within
+            /// this stream by the total number of bytes written. Equivalent to calling AppendAsync() for each buffer, but the
+            /// buffers are only read once while they are written and the call completes synchronously unless a flush is needed
+            /// 
+            /// Known Exceptions:
+            /// 
+            ///     System.Fabric.FabricException
+            ///     FabricObjectClosedException
+            ///     System.IOException
+            ///     
+            /// </summary>
+            /// <param name="operationData">source buffers for the bytes to be written</param>
+            /// <param name="cancellationToken">Used to cancel the AppendAsync operation</param>
+            virtual ktl::Awaitable<NTSTATUS> AppendAsync(
+                __in Utilities::OperationData const & operationData,
+                __in ktl::CancellationToken const & cancellationToken) = 0;
+
             /// <summary>
             /// Cause any new buffered data from AppendAsync() to be written to the underlying device
             /// 
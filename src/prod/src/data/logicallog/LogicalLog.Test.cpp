@@ -408,6 +408,101 @@ namespace LogTests
             VERIFY_STATUS_SUCCESS("LogManagerHandle::CloseAsync", status);
         }
 
+        VOID AppendOperationDataTest()
+        {
+            NTSTATUS status;
+
+            ILogManagerHandle::SPtr logManager;
+            status = CreateAndOpenLogManager(logManager);
+            VERIFY_STATUS_SUCCESS("CreateAndOpenLogManager", status);
+
+            KString::SPtr physicalLogName;
+            GenerateUniqueFilename(physicalLogName);
+
+            KGuid physicalLogId;
+            physicalLogId.CreateNew();
+
+            // Don't care if this fails
+            SyncAwait(logManager->DeletePhysicalLogAsync(*physicalLogName, physicalLogId, CancellationToken::None));
+
+            IPhysicalLogHandle::SPtr physicalLog;
+            status = CreatePhysicalLog(*logManager, physicalLogId, *physicalLogName, physicalLog);
+            VERIFY_STATUS_SUCCESS("CreatePhysicalLog", status);
+
+            KString::SPtr logicalLogName;
+            GenerateUniqueFilename(logicalLogName);
+            KGuid logicalLogId;
+            logicalLogId.CreateNew();
+            ILogicalLog::SPtr logicalLog;
+            status = CreateLogicalLog(*physicalLog, logicalLogId, *logicalLogName, logicalLog);
+            VERIFY_STATUS_SUCCESS("CreateLogicalLog", status);
+
+            // Small headers around large payloads, with the largest one spanning several write buffers
+            const UCHAR recordSize = 251;
+            LONG bufferSizes[] = { 4, 1, 4, 100, 4, 4000, 4, (1024 * 1024) + 7, 4, 37 };
+
+            Utilities::OperationData::SPtr operationData = Utilities::OperationData::Create(GetThisAllocator());
+            LONGLONG totalSize = 0;
+
+            for (ULONG i = 0; i < ARRAYSIZE(bufferSizes); i++)
+            {
+                KBuffer::SPtr buf;
+                PUCHAR bufferPtr;
+                AllocBuffer(bufferSizes[i], buf, bufferPtr);
+                BuildDataBuffer(*buf, totalSize, 0, recordSize);
+
+                operationData->Append(*buf);
+                totalSize += bufferSizes[i];
+            }
+
+            status = SyncAwait(logicalLog->AppendAsync(*operationData, CancellationToken::None));
+            VERIFY_STATUS_SUCCESS("AppendAsync", status);
+            VERIFY_ARE_EQUAL(totalSize, logicalLog->WritePosition);
+
+            status = SyncAwait(logicalLog->FlushWithMarkerAsync(CancellationToken::None));
+            VERIFY_STATUS_SUCCESS("FlushWithMarkerAsync", status);
+
+            // Close and reopen so that the data is read back from disk and its checksums are verified
+            status = SyncAwait(logicalLog->CloseAsync(CancellationToken::None));
+            VERIFY_STATUS_SUCCESS("LogicalLog::CloseAsync", status);
+
+            status = OpenLogicalLog(*physicalLog, logicalLogId, *logicalLogName, logicalLog);
+            VERIFY_STATUS_SUCCESS("OpenLogicalLog", status);
+            VERIFY_ARE_EQUAL(totalSize, logicalLog->WritePosition);
+
+            KBuffer::SPtr readBuffer;
+            PUCHAR readBufferPtr;
+            AllocBuffer(static_cast<LONG>(totalSize), readBuffer, readBufferPtr);
+
+            LONG totalRead = 0;
+            while (totalRead < totalSize)
+            {
+                LONG bytesRead;
+                status = SyncAwait(logicalLog->ReadAsync(bytesRead, *readBuffer, totalRead, static_cast<ULONG>(totalSize - totalRead), 0, CancellationToken::None));
+                VERIFY_STATUS_SUCCESS("LogicalLog::ReadAsync", status);
+                VERIFY_IS_TRUE(bytesRead > 0);
+
+                totalRead += bytesRead;
+            }
+
+            ValidateDataBuffer(*readBuffer, static_cast<ULONG>(totalSize), 0, 0, 0, recordSize);
+
+            // Cleanup
+            status = SyncAwait(logicalLog->CloseAsync(CancellationToken::None));
+            VERIFY_STATUS_SUCCESS("LogicalLog::CloseAsync", status);
+            logicalLog = nullptr;
+
+            status = SyncAwait(physicalLog->CloseAsync(CancellationToken::None));
+            VERIFY_STATUS_SUCCESS("PhysicalLogHandle::CloseAsync", status);
+            physicalLog = nullptr;
+
+            status = SyncAwait(logManager->DeletePhysicalLogAsync(*physicalLogName, physicalLogId, CancellationToken::None));
+            VERIFY_STATUS_SUCCESS("LogManagerHandle::DeletePhysicalLogAsync", status);
+
+            status = SyncAwait(logManager->CloseAsync(CancellationToken::None));
+            VERIFY_STATUS_SUCCESS("LogManagerHandle::CloseAsync", status);
+        }
+
         VOID BasicTest()
         {
             NTSTATUS status;
@@ -1812,6 +1907,17 @@ namespace LogTests
     }
 #endif
 
+#if !defined(UDRIVER)
+    BOOST_AUTO_TEST_CASE(LogicalLog_AppendOperationData_InProc)
+    {
+        ktlLoggerMode_ = KtlLoggerMode::InProc;
+        TEST_TRACE_BEGIN("LogicalLog_AppendOperationData_InProc")
+        {
+            testContext_->AppendOperationDataTest();
+        }
+    }
+#endif
+
 #if !defined(UDRIVER)
     // This test case is in-proc only, as deleting the shared log when the last logical log within it is deleted
     // is disabled for out-of-proc (system shared) cases
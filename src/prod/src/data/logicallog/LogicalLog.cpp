@@ -1617,6 +1617,66 @@ LogicalLog::AppendAsync(
     co_return STATUS_SUCCESS;
 }
 
+Awaitable<NTSTATUS>
+LogicalLog::AppendAsync(
+    __in Utilities::OperationData const & operationData,
+    __in CancellationToken const & cancellationToken)
+{
+    KCoService$ApiEntry(TRUE);
+
+    NTSTATUS status;
+
+    // Each buffer is copied straight into the write buffer; the write buffer checksums it while it is being copied
+    for (ULONG32 i = 0; i < operationData.BufferCount; i++)
+    {
+        KBuffer::CSPtr buffer = operationData[i];
+        BYTE const * source = static_cast<BYTE const *>(buffer->GetBuffer());
+        ULONG count = buffer->QuerySize();
+        LONG offset = 0;
+
+        while (count > 0)
+        {
+            ULONG bytesWritten;
+            status = writeBuffer_->Put(bytesWritten, source, offset, count);
+            if (!NT_SUCCESS(status))
+            {
+                WriteError(
+                    TraceComponent,
+                    "{0} - AppendAsync - Failed to put into writebuffer. buffer: {1}, bufferCount: {2}, offset: {3}, count: {4}, status: {5}",
+                    TraceId,
+                    i,
+                    operationData.BufferCount,
+                    offset,
+                    count,
+                    status);
+
+                co_return status;
+            }
+
+            count -= bytesWritten;
+            offset += bytesWritten;
+            nextWritePosition_ += bytesWritten;
+
+            if (count > 0)
+            {
+                status = co_await InternalFlushAsync(false, cancellationToken);
+                if (!NT_SUCCESS(status))
+                {
+                    WriteError(
+                        TraceComponent,
+                        "{0} - AppendAsync - InternalFlushAsync failed. Status: {1}",
+                        TraceId,
+                        status);
+
+                    co_return status;
+                }
+            }
+        }
+    }
+
+    co_return STATUS_SUCCESS;
+}
+
 Awaitable<NTSTATUS>
 LogicalLog::DelayBeforeFlush(__in CancellationToken const &)
 {
@@ -132,6 +132,10 @@ namespace Data
                 __in ULONG count,
                 __in ktl::CancellationToken const & cancellationToken) override;
 
+            ktl::Awaitable<NTSTATUS> AppendAsync(
+                __in Utilities::OperationData const & operationData,
+                __in ktl::CancellationToken const & cancellationToken) override;
+
             ktl::Awaitable<NTSTATUS> FlushAsync(__in ktl::CancellationToken const & cancellationToken) override;
 
             ktl::Awaitable<NTSTATUS> FlushWithMarkerAsync(__in ktl::CancellationToken const & cancellationToken) override;
@@ -24,6 +24,7 @@ LogicalLogBuffer::LogicalLogBuffer(
     , streamBlockHeader_(nullptr)
     , pageAlignedKIoBufferView_(nullptr)
     , offsetToData_(ULONG_MAX)
+    , dataCrc_(0)
 {
     NTSTATUS status = STATUS_SUCCESS;
 
@@ -69,6 +70,7 @@ LogicalLogBuffer::LogicalLogBuffer(
     , KShared()
     , PartitionedReplicaTraceComponent(prId)
     , metadataSize_(blockMetadataSize)
+    , dataCrc_(0)
 {
     NTSTATUS status = STATUS_SUCCESS;
     BOOLEAN res = TRUE;
@@ -448,9 +450,15 @@ NTSTATUS LogicalLogBuffer::Put(
     NTSTATUS status = STATUS_SUCCESS;
 
     ULONG todo = min(size, combinedBufferStream_.Length - combinedBufferStream_.Position);
-    if (todo > 0)
+    ULONG done = 0;
+
+    // The data checksum is computed piece by piece right after each piece is copied, while the source is still in the cache,
+    // instead of reading all of the data again when the buffer is sealed
+    while (done < todo)
     {
-        status = combinedBufferStream_.Put(toWrite, todo);
+        ULONG piece = min(todo - done, CopyAndChecksumPieceSize);
+
+        status = combinedBufferStream_.Put(toWrite + done, piece);
         if (!NT_SUCCESS(status))
         {
             WriteWarning(
@@ -465,6 +473,9 @@ NTSTATUS LogicalLogBuffer::Put(
 
             return status;
         }
+
+        dataCrc_ = KChecksum::Crc64(toWrite + done, piece, dataCrc_);
+        done += piece;
     }
 
     bytesWritten = todo;
@@ -557,29 +568,6 @@ NTSTATUS LogicalLogBuffer::Get(
     return STATUS_SUCCESS;
 }
 
-class CrcIterator
-{
-public:
-
-    CrcIterator() : dataCrc_(0) {}
-
-    NTSTATUS
-    HashFunc(
-        __in PVOID ioBufferFragment,
-        __inout ULONG& fragmentSize)
-    {
-        dataCrc_ = KChecksum::Crc64(ioBufferFragment, fragmentSize, dataCrc_);
-        return STATUS_SUCCESS;
-    }
-
-    __declspec(property(get = get_DataCrc)) ULONGLONG DataCrc;
-    ULONGLONG get_DataCrc() const { return dataCrc_; }
-
-private:
-
-    ULONGLONG dataCrc_;
-};
-
 NTSTATUS LogicalLogBuffer::SealForWrite(
     __in LONGLONG currentHeadTruncationPoint,
     __in BOOLEAN isBarrier,
@@ -594,7 +582,7 @@ NTSTATUS LogicalLogBuffer::SealForWrite(
 
     ULONG trimSize = 0;
     ULONG dataResidingOutsideMetadata = 0;
-    CrcIterator crcIterator;
+    ULONGLONG dataCrc = 0;
 
     metadataBlockHeader_->Flags = isBarrier ? KLogicalLogInformation::MetadataBlockHeader::IsEndOfLogicalRecord : 0;
 
@@ -616,13 +604,9 @@ NTSTATUS LogicalLogBuffer::SealForWrite(
         // space reserved by the physical logger
         //
         metadataSize = KLogicalLogInformation::FixedMetadataSize - metadataSize_;
-        BOOLEAN res = combinedBufferStream_.PositionTo(offsetToData_);
-        KInvariant(res);
 
-        // todo: fix this typo in KIoBufferStream...
-        KIoBufferStream::InterationCallback localHashFunc(&crcIterator, &CrcIterator::HashFunc);
-        status = combinedBufferStream_.Iterate(localHashFunc, streamBlockHeader_->DataSize);
-        KInvariant(NT_SUCCESS(status));
+        // All data got here through Put(), which checksummed it in stream order while copying it
+        dataCrc = dataCrc_;
 
         //
         // Compute the number of data blocks that are needed to hold the data that is within the payload 
@@ -646,7 +630,7 @@ NTSTATUS LogicalLogBuffer::SealForWrite(
             return status;
         }
     }
-    streamBlockHeader_->DataCRC64 = crcIterator.DataCrc;
+    streamBlockHeader_->DataCRC64 = dataCrc;
 
     // Now compute blk heard crc
     streamBlockHeader_->HeaderCRC64 = KChecksum::Crc64(streamBlockHeader_, sizeof(KLogicalLogInformation::StreamBlockHeader));
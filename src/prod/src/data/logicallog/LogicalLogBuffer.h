@@ -128,6 +128,9 @@ namespace Data
 
             const ULONG MetadataBlockSize = 4096;
 
+            // Put() copies and checksums data in pieces of this size so that each piece is checksummed while it is still cached
+            static const ULONG CopyAndChecksumPieceSize = 16 * 1024;
+
             KIoBuffer::SPtr metadataKIoBuffer_;
             KIoBuffer::SPtr pageAlignedKIoBuffer_;
             KIoBuffer::SPtr pageAlignedKIoBufferView_;
@@ -138,6 +141,9 @@ namespace Data
             KLogicalLogInformation::StreamBlockHeader* streamBlockHeader_;
             KLogicalLogInformation::MetadataBlockHeader* metadataBlockHeader_;
             KIoBufferView::SPtr combinedView_;
+
+            // CRC64 of all data put into a write buffer so far
+            ULONGLONG dataCrc_;
         };
     }
 }
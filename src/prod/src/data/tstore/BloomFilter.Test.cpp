@@ -0,0 +1,130 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#include <boost/test/unit_test.hpp>
+#include "Common/boost-taef.h"
+
+namespace TStoreTests
+{
+    using namespace ktl;
+    using namespace Data::TStore;
+    using namespace Data::Utilities;
+
+    class BloomFilterTest
+    {
+    public:
+        BloomFilterTest()
+        {
+            NTSTATUS status = KtlSystem::Initialize(FALSE, &ktlSystem_);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            ktlSystem_->SetStrictAllocationChecks(TRUE);
+        }
+
+        ~BloomFilterTest()
+        {
+            ktlSystem_->Shutdown();
+        }
+
+        KAllocator& GetAllocator()
+        {
+            return ktlSystem_->NonPagedAllocator();
+        }
+
+        ULONG64 GetKeyHash(__in LONG64 key)
+        {
+            return BloomFilter::GetKeyHash(reinterpret_cast<byte const *>(&key), sizeof(key));
+        }
+
+        BloomFilter::SPtr CreateFilter(__in LONG64 keyCount)
+        {
+            BloomFilter::SPtr filterSPtr = nullptr;
+            NTSTATUS status = BloomFilter::Create(keyCount, BloomFilter::DefaultBitsPerKey, GetAllocator(), filterSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            for (LONG64 key = 0; key < keyCount; key++)
+            {
+                filterSPtr->Add(GetKeyHash(key));
+            }
+
+            return filterSPtr;
+        }
+
+    private:
+        KtlSystem* ktlSystem_;
+    };
+
+    BOOST_FIXTURE_TEST_SUITE(BloomFilterTestSuite, BloomFilterTest)
+
+    BOOST_AUTO_TEST_CASE(BloomFilter_AddedKeys_ShouldAlwaysBeFound)
+    {
+        LONG64 keyCount = 10000;
+        BloomFilter::SPtr filterSPtr = CreateFilter(keyCount);
+
+        for (LONG64 key = 0; key < keyCount; key++)
+        {
+            CODING_ERROR_ASSERT(filterSPtr->MayContain(GetKeyHash(key)));
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(BloomFilter_AbsentKeys_FalsePositiveRateShouldBeLow)
+    {
+        LONG64 keyCount = 10000;
+        BloomFilter::SPtr filterSPtr = CreateFilter(keyCount);
+
+        ULONG32 falsePositives = 0;
+        for (LONG64 key = keyCount; key < 2 * keyCount; key++)
+        {
+            if (filterSPtr->MayContain(GetKeyHash(key)))
+            {
+                falsePositives++;
+            }
+        }
+
+        // 10 bits per key gives roughly 1%; allow generous slack.
+        CODING_ERROR_ASSERT(falsePositives < keyCount * 3 / 100);
+    }
+
+    BOOST_AUTO_TEST_CASE(BloomFilter_EmptyFilter_ShouldNotContainAnyKey)
+    {
+        BloomFilter::SPtr filterSPtr = CreateFilter(0);
+        CODING_ERROR_ASSERT(filterSPtr->BitCount == 64);
+
+        for (LONG64 key = 0; key < 100; key++)
+        {
+            CODING_ERROR_ASSERT(filterSPtr->MayContain(GetKeyHash(key)) == false);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(BloomFilter_WriteRead_ShouldRoundTrip)
+    {
+        LONG64 keyCount = 1000;
+        BloomFilter::SPtr filterSPtr = CreateFilter(keyCount);
+
+        BinaryWriter writer(GetAllocator());
+        filterSPtr->Write(writer);
+        ULONG32 size = writer.Position;
+
+        KBuffer::SPtr bufferSPtr = writer.GetBuffer(0);
+        BinaryReader reader(*bufferSPtr, GetAllocator());
+
+        BlockHandle::SPtr handleSPtr = nullptr;
+        NTSTATUS status = BlockHandle::Create(0, size, GetAllocator(), handleSPtr);
+        CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+        BloomFilter::SPtr readFilterSPtr = BloomFilter::Read(reader, *handleSPtr, GetAllocator());
+        CODING_ERROR_ASSERT(readFilterSPtr->BitCount == filterSPtr->BitCount);
+        CODING_ERROR_ASSERT(readFilterSPtr->HashFunctionCount == filterSPtr->HashFunctionCount);
+
+        for (LONG64 key = 0; key < 2 * keyCount; key++)
+        {
+            ULONG64 keyHash = GetKeyHash(key);
+            CODING_ERROR_ASSERT(readFilterSPtr->MayContain(keyHash) == filterSPtr->MayContain(keyHash));
+        }
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+}
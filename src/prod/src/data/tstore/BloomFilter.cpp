@@ -0,0 +1,174 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#define BLOOMFILTER_TAG 'flBS'
+
+using namespace Data::TStore;
+using namespace Data::Utilities;
+
+BloomFilter::BloomFilter(
+    __in ULONG64 bitCount,
+    __in ULONG32 hashFunctionCount)
+    : bitCount_(bitCount),
+    hashFunctionCount_(hashFunctionCount),
+    bitsSPtr_(nullptr)
+{
+    ASSERT_IFNOT(bitCount_ > 0 && bitCount_ % BitsPerWord == 0, "Invalid bloom filter bit count {0}", bitCount_);
+    ASSERT_IFNOT(bitCount_ / 8 <= MAXULONG, "Bloom filter bit count {0} is too large", bitCount_);
+
+    NTSTATUS status = KBuffer::Create(static_cast<ULONG>(bitCount_ / 8), bitsSPtr_, GetThisAllocator(), BLOOMFILTER_TAG);
+    if (!NT_SUCCESS(status))
+    {
+        this->SetConstructorStatus(status);
+        return;
+    }
+
+    RtlZeroMemory(bitsSPtr_->GetBuffer(), bitsSPtr_->QuerySize());
+}
+
+BloomFilter::~BloomFilter()
+{
+}
+
+NTSTATUS BloomFilter::Create(
+    __in ULONG64 expectedKeyCount,
+    __in ULONG32 bitsPerKey,
+    __in KAllocator& allocator,
+    __out BloomFilter::SPtr& result)
+{
+    NTSTATUS status;
+
+    if (bitsPerKey == 0)
+    {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    // Round up to whole 64 bit words, with at least one word so that tiny files still get a usable filter.
+    ULONG64 bitCount = expectedKeyCount * bitsPerKey;
+    bitCount = ((bitCount + BitsPerWord - 1) / BitsPerWord) * BitsPerWord;
+    if (bitCount < BitsPerWord)
+    {
+        bitCount = BitsPerWord;
+    }
+
+    // k = ln(2) * bits per key minimizes the false positive rate.
+    ULONG32 hashFunctionCount = static_cast<ULONG32>(bitsPerKey * 69 / 100);
+    if (hashFunctionCount < 1)
+    {
+        hashFunctionCount = 1;
+    }
+    else if (hashFunctionCount > MaxHashFunctionCount)
+    {
+        hashFunctionCount = MaxHashFunctionCount;
+    }
+
+    SPtr output = _new(BLOOMFILTER_TAG, allocator) BloomFilter(bitCount, hashFunctionCount);
+
+    if (!output)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    status = output->Status();
+    if (!NT_SUCCESS(status))
+    {
+        return status;
+    }
+
+    result = Ktl::Move(output);
+    return STATUS_SUCCESS;
+}
+
+ULONG64 BloomFilter::GetKeyHash(
+    __in_opt byte const * keyBytes,
+    __in ULONG32 count)
+{
+    ASSERT_IF(keyBytes == nullptr && count > 0, "Key bytes cannot be null for a key of size {0}", count);
+    return CRC64::ToCRC64(keyBytes, 0, count);
+}
+
+void BloomFilter::Add(__in ULONG64 keyHash)
+{
+    ULONG64 * words = static_cast<ULONG64 *>(bitsSPtr_->GetBuffer());
+
+    // Double hashing: probe i is at (h + i * delta) mod m.
+    ULONG64 hash = keyHash;
+    ULONG64 delta = (keyHash >> 33) | (keyHash << 31);
+    for (ULONG32 i = 0; i < hashFunctionCount_; i++)
+    {
+        ULONG64 bit = hash % bitCount_;
+        words[bit / BitsPerWord] |= (1ULL << (bit % BitsPerWord));
+        hash += delta;
+    }
+}
+
+bool BloomFilter::MayContain(__in ULONG64 keyHash) const
+{
+    ULONG64 const * words = static_cast<ULONG64 const *>(bitsSPtr_->GetBuffer());
+
+    ULONG64 hash = keyHash;
+    ULONG64 delta = (keyHash >> 33) | (keyHash << 31);
+    for (ULONG32 i = 0; i < hashFunctionCount_; i++)
+    {
+        ULONG64 bit = hash % bitCount_;
+        if ((words[bit / BitsPerWord] & (1ULL << (bit % BitsPerWord))) == 0)
+        {
+            return false;
+        }
+
+        hash += delta;
+    }
+
+    return true;
+}
+
+void BloomFilter::Write(__in BinaryWriter& writer)
+{
+    ByteAlignedReaderWriterHelper::AssertIfNotAligned(writer.Position);
+
+    writer.Write(hashFunctionCount_);
+    ByteAlignedReaderWriterHelper::WritePaddingUntilAligned(writer); // RESERVED
+    writer.Write(bitCount_);
+    writer.Write(*bitsSPtr_);
+
+    ByteAlignedReaderWriterHelper::AssertIfNotAligned(writer.Position);
+}
+
+BloomFilter::SPtr BloomFilter::Read(
+    __in BinaryReader& reader,
+    __in BlockHandle const & handle,
+    __in KAllocator& allocator)
+{
+    reader.Position = static_cast<ULONG32>(handle.Offset);
+
+    ULONG32 hashFunctionCount = 0;
+    reader.Read(hashFunctionCount);
+    ByteAlignedReaderWriterHelper::ReadPaddingUntilAligned(reader);
+
+    ULONG64 bitCount = 0;
+    reader.Read(bitCount);
+
+    if (hashFunctionCount == 0 ||
+        hashFunctionCount > MaxHashFunctionCount ||
+        bitCount == 0 ||
+        bitCount % BitsPerWord != 0 ||
+        reader.Position + (bitCount / 8) != handle.EndOffset())
+    {
+        throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+    }
+
+    SPtr output = _new(BLOOMFILTER_TAG, allocator) BloomFilter(bitCount, hashFunctionCount);
+    if (!output)
+    {
+        throw ktl::Exception(STATUS_INSUFFICIENT_RESOURCES);
+    }
+
+    Diagnostics::Validate(output->Status());
+
+    reader.Read(static_cast<ULONG>(bitCount / 8), output->bitsSPtr_);
+    return output;
+}
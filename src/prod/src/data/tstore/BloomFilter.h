@@ -0,0 +1,94 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace TStore
+    {
+        //
+        // Bloom filter over the keys of a key checkpoint file.
+        // Keys are identified by the CRC64 of their serialized bytes (the same hash used for the key lock resource name),
+        // and probe positions are derived from that hash by double hashing.
+        // A negative answer from MayContain is exact; a positive answer may be a false positive.
+        //
+        class BloomFilter :
+            public KObject<BloomFilter>,
+            public KShared<BloomFilter>
+        {
+            K_FORCE_SHARED(BloomFilter)
+
+        public:
+
+            //
+            // Default number of filter bits per key. 10 bits per key gives roughly a 1% false positive rate.
+            //
+            static const ULONG32 DefaultBitsPerKey = 10;
+
+            static const ULONG32 MaxHashFunctionCount = 30;
+
+            static NTSTATUS Create(
+                __in ULONG64 expectedKeyCount,
+                __in ULONG32 bitsPerKey,
+                __in KAllocator& allocator,
+                __out BloomFilter::SPtr& result);
+
+            //
+            // Hash of the given serialized key, to be passed to Add and MayContain.
+            //
+            static ULONG64 GetKeyHash(
+                __in_opt byte const * keyBytes,
+                __in ULONG32 count);
+
+            __declspec(property(get = get_BitCount)) ULONG64 BitCount;
+            ULONG64 get_BitCount() const
+            {
+                return bitCount_;
+            }
+
+            __declspec(property(get = get_HashFunctionCount)) ULONG32 HashFunctionCount;
+            ULONG32 get_HashFunctionCount() const
+            {
+                return hashFunctionCount_;
+            }
+
+            void Add(__in ULONG64 keyHash);
+
+            bool MayContain(__in ULONG64 keyHash) const;
+
+            //
+            // Serialize the filter into the given stream.
+            // The data is written is 8 bytes aligned.
+            // Name                Type        Size
+            //
+            // HashFunctionCount   int         4
+            // RESERVED                        4
+            // BitCount            long        8
+            // Bits                byte[]      BitCount / 8
+            //
+            // BitCount is always a multiple of 64.
+            //
+            void Write(__in BinaryWriter& writer);
+
+            static BloomFilter::SPtr Read(
+                __in BinaryReader& reader,
+                __in BlockHandle const & handle,
+                __in KAllocator& allocator);
+
+        private:
+
+            static const ULONG32 BitsPerWord = 64;
+
+            BloomFilter(
+                __in ULONG64 bitCount,
+                __in ULONG32 hashFunctionCount);
+
+            ULONG64 bitCount_;
+            ULONG32 hashFunctionCount_;
+            KBuffer::SPtr bitsSPtr_;
+        };
+    }
+}
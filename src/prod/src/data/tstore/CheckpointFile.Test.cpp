@@ -204,7 +204,7 @@ namespace TStoreTests
             CODING_ERROR_ASSERT(NT_SUCCESS(status));
             int key = startVal++;
             valueSPtr->SetVersionSequenceNumber(startVal++);
-            valueSPtr->SetValueSize(startVal++);
+            valueSPtr->SetOnDiskValueSize(startVal++);
             valueSPtr->SetValueChecksum(startVal++);
             valueSPtr->SetOffset(startVal++, *CreateTraceComponent());
             VersionedItem<int>::SPtr item(&(*valueSPtr));
@@ -222,7 +222,7 @@ namespace TStoreTests
             KeyData<int, int>::SPtr keyDataSPtr = fileSPtr->ReadKey<int, int>(br, stateSerializer);
             CODING_ERROR_ASSERT(keyDataSPtr->get_Key() == startVal++);
             CODING_ERROR_ASSERT(keyDataSPtr->get_Value()->GetVersionSequenceNumber() == startVal++);
-            CODING_ERROR_ASSERT(keyDataSPtr->get_Value()->GetValueSize() == startVal++);
+            CODING_ERROR_ASSERT(keyDataSPtr->get_Value()->GetOnDiskValueSize() == startVal++);
             CODING_ERROR_ASSERT(keyDataSPtr->get_Value()->GetValueChecksum() == startVal++);
             CODING_ERROR_ASSERT(keyDataSPtr->get_Value()->GetOffset() == startVal++);
             CODING_ERROR_ASSERT(keyDataSPtr->get_Value()->GetRecordKind() == RecordKind::InsertedVersion);
@@ -324,7 +324,7 @@ namespace TStoreTests
                 CODING_ERROR_ASSERT(IsSameBufferValue(*val, *(items.Current().Value->GetValue())));
 
                 CODING_ERROR_ASSERT(keyDataSPtr->Value->GetVersionSequenceNumber() == itemSPtr->GetVersionSequenceNumber());
-                CODING_ERROR_ASSERT(keyDataSPtr->Value->GetValueSize() == itemSPtr->GetValueSize());
+                CODING_ERROR_ASSERT(keyDataSPtr->Value->GetOnDiskValueSize() == itemSPtr->GetOnDiskValueSize());
                 CODING_ERROR_ASSERT(keyDataSPtr->Value->GetValueChecksum() == itemSPtr->GetValueChecksum());
                 CODING_ERROR_ASSERT(keyDataSPtr->Value->GetOffset() == itemSPtr->GetOffset());
                 CODING_ERROR_ASSERT(keyDataSPtr->Value->GetRecordKind() == itemSPtr->GetRecordKind());
@@ -413,7 +413,7 @@ namespace TStoreTests
                 CODING_ERROR_ASSERT(NT_SUCCESS(status));
                 KBuffer::SPtr key = MakeCustomSizeBufferWithIntVal(keySerializedSize, startVal++);
                 valueSPtr->SetVersionSequenceNumber(startVal++);
-                valueSPtr->SetValueSize(startVal++);
+                valueSPtr->SetOnDiskValueSize(startVal++);
                 valueSPtr->SetValueChecksum(startVal++);
                 valueSPtr->SetOffset(startVal++, *CreateTraceComponent());
                 VersionedItem<int>::SPtr item(&(*valueSPtr));
@@ -437,7 +437,7 @@ namespace TStoreTests
                 CODING_ERROR_ASSERT(IsSameBufferValue(*(keyDataSPtr->Key), *MakeCustomSizeBufferWithIntVal(keySerializedSize, startVal++)));
 
                 CODING_ERROR_ASSERT(keyDataSPtr->Value->GetVersionSequenceNumber() == startVal++);
-                CODING_ERROR_ASSERT(keyDataSPtr->Value->GetValueSize() == startVal++);
+                CODING_ERROR_ASSERT(keyDataSPtr->Value->GetOnDiskValueSize() == startVal++);
                 CODING_ERROR_ASSERT(keyDataSPtr->Value->GetValueChecksum() == startVal++);
                 CODING_ERROR_ASSERT(keyDataSPtr->Value->GetOffset() == startVal++);
                 CODING_ERROR_ASSERT(keyDataSPtr->Value->GetRecordKind() == RecordKind::InsertedVersion);
@@ -1352,6 +1352,72 @@ namespace TStoreTests
             co_return;
         }
 
+        ktl::Awaitable<void> ValueCheckpointFile_Write100CompressedValuesAndReadFromReopenedFile_ShouldSucceed_Test()
+        {
+            KAllocator& allocator = GetAllocator();
+            KStringView filename = L"ValueCheckpointFile_Write100CompressedValuesAndReadFromReopenedFile_ShouldSucceed.txt";
+            KString::SPtr filePathToOpenSPtr = CreateFileString(filename, GetAllocator());
+
+            ULONG32 fileId = 10;
+            ValueCheckpointFile::SPtr fileSPtr = co_await ValueCheckpointFile::CreateAsync(*CreateTraceComponent(), *filePathToOpenSPtr, fileId, allocator);
+            fileSPtr->SetCompressionCodec(CompressionCodecId::Lz);
+
+            SharedBinaryWriter::SPtr bwSPtr = nullptr;
+            NTSTATUS status = SharedBinaryWriter::Create(allocator, bwSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            ktl::io::KFileStream::SPtr streamSPtr = co_await fileSPtr->StreamPoolSPtr->AcquireStreamAsync();
+
+            KArray<KSharedPtr<VersionedItem<int>>> itemList(allocator);
+            KArray<KBuffer::SPtr> valueList(allocator);
+            ULONG32 totalValueSize = 0;
+
+            for (int i = 0; i < 100; i++)
+            {
+                // Odd values are too small to be compressed and are stored as is.
+                ULONG32 valueSize = (i % 2 == 0) ? 512 : 8;
+                BinaryWriter br(allocator);
+                for (ULONG32 j = 0; j < valueSize; j++)
+                {
+                    br.Write(static_cast<byte>((i + j / 16) % 256));
+                }
+
+                totalValueSize += valueSize;
+                valueList.Append(br.GetBuffer(0));
+                KSharedPtr<VersionedItem<int>> itemSPtr = AddValuesInBytesWithInsertedVersionedItem(*streamSPtr, *bwSPtr, *fileSPtr, i, *br.GetBuffer(0));
+                itemList.Append(itemSPtr);
+            }
+
+            co_await fileSPtr->FlushAsync(*streamSPtr, *bwSPtr);
+            co_await fileSPtr->StreamPoolSPtr->ReleaseStreamAsync(*streamSPtr);
+
+            ValueCheckpointFile::SPtr valueCheckpointFileSPtr = co_await ValueCheckpointFile::OpenAsync(allocator, *filePathToOpenSPtr, *CreateTraceComponent());
+            CODING_ERROR_ASSERT(valueCheckpointFileSPtr != nullptr);
+            CODING_ERROR_ASSERT(valueCheckpointFileSPtr->CompressionCodec == CompressionCodecId::Lz);
+            CODING_ERROR_ASSERT(valueCheckpointFileSPtr->PropertiesSPtr->ValueCount == 100);
+            CODING_ERROR_ASSERT(valueCheckpointFileSPtr->PropertiesSPtr->ValuesHandle->get_Size() < totalValueSize);
+
+            for (int i = 0; i < 100; i++)
+            {
+                KBuffer::SPtr val = co_await valueCheckpointFileSPtr->ReadValueAsync<int>(*itemList[i]);
+                CODING_ERROR_ASSERT(*valueList[i] == *val);
+
+                // The on-disk size locates the compressed value, a loaded value is charged for its serialized size.
+                LONG32 serializedSize = static_cast<LONG32>(valueList[i]->QuerySize());
+                if (i % 2 == 0)
+                {
+                    CODING_ERROR_ASSERT(itemList[i]->GetOnDiskValueSize() < serializedSize);
+                }
+
+                CODING_ERROR_ASSERT(itemList[i]->GetValueSize() == serializedSize);
+            }
+
+            co_await fileSPtr->CloseAsync();
+            co_await valueCheckpointFileSPtr->CloseAsync();
+            RemoveFile(*filePathToOpenSPtr);
+            co_return;
+        }
+
         ktl::Awaitable<void> KeyBlockAlignedWriter_WriteOnKeyAndEnumerate_ShouldSucceed_Test()
         {
             //one int key item is 4 bytes of serialzied key size, 48 bytes data in total (44 is reserved for meta and padding)
@@ -1633,6 +1699,11 @@ namespace TStoreTests
         SyncAwait(ValueCheckpointFile_Write100KeysAndReadAndVerifyMetadataUsingBytes_ShouldSucceed_Test());
     }
 
+    BOOST_AUTO_TEST_CASE(ValueCheckpointFile_Write100CompressedValuesAndReadFromReopenedFile_ShouldSucceed)
+    {
+        SyncAwait(ValueCheckpointFile_Write100CompressedValuesAndReadFromReopenedFile_ShouldSucceed_Test());
+    }
+
     BOOST_AUTO_TEST_CASE(KeyBlockAlignedWriter_WriteOnKeyAndEnumerate_ShouldSucceed)
     {
         SyncAwait(KeyBlockAlignedWriter_WriteOnKeyAndEnumerate_ShouldSucceed_Test());
@@ -20,6 +20,7 @@ CheckpointFile::CheckpointFile(
     keyFileNameSPtr_(nullptr),
     valueFileNameSPtr_(nullptr),
     isFileSizeCached_(false),
+    valueCacheFileId_(ValueCache::AllocateFileId()),
     traceComponent_(&traceComponent)
 {
     NTSTATUS status = KString::Create(fileNameBaseSPtr_, GetThisAllocator(), filename);
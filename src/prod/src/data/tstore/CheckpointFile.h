@@ -42,6 +42,12 @@ namespace Data
                 return valueFileNameSPtr_;
             }
 
+            __declspec(property(get = get_KeyCheckpointFile)) KeyCheckpointFile::SPtr KeyCheckpointFileSPtr;
+            KeyCheckpointFile::SPtr get_KeyCheckpointFile() const
+            {
+                return keyCheckpointFileSPtr_;
+            }
+
             __declspec(property(get = get_KeyCount)) ULONG64 KeyCount;
             ULONG64 get_KeyCount() const
             {
@@ -72,6 +78,35 @@ namespace Data
                 return valueCheckpointFileSPtr_->PropertiesSPtr->ValuesHandle;
             }
 
+            __declspec(property(get = get_ValueCompressionCodec)) CompressionCodecId::Enum ValueCompressionCodec;
+            CompressionCodecId::Enum get_ValueCompressionCodec() const
+            {
+                return valueCheckpointFileSPtr_->CompressionCodec;
+            }
+
+            //
+            // Returns false only if the key with the given hash is definitely not in this checkpoint file.
+            //
+            bool MayContainKey(__in ULONG64 keyHash) const
+            {
+                return keyCheckpointFileSPtr_->MayContainKey(keyHash);
+            }
+
+            __declspec(property(get = get_HasBloomFilter)) bool HasBloomFilter;
+            bool get_HasBloomFilter() const
+            {
+                return keyCheckpointFileSPtr_->BloomFilterSPtr != nullptr;
+            }
+
+            //
+            // Process unique id of this file in the shared ValueCache.
+            //
+            __declspec(property(get = get_ValueCacheFileId)) ULONG64 ValueCacheFileId;
+            ULONG64 get_ValueCacheFileId() const
+            {
+                return valueCacheFileId_;
+            }
+
             ktl::Awaitable<ULONG64> GetTotalFileSizeAsync(__in KAllocator& allocator);
 
             //
@@ -98,7 +133,8 @@ namespace Data
                __in KAllocator& allocator,
                __in StoreTraceComponent & traceComponent,
                __in StorePerformanceCountersSPtr & perfCounters,
-               __in bool isValueAReferenceType)
+               __in bool isValueAReferenceType,
+               __in CompressionCodecId::Enum valueCompressionCodec = CompressionCodecId::None)
             {
                 SharedException::CSPtr exceptionSPtr = nullptr;
                 KSharedPtr<IEnumerator<KeyValuePair<TKey, KSharedPtr<VersionedItem<TValue>>>>> sortedItemDataSPtr(&sortedItemData);
@@ -117,6 +153,7 @@ namespace Data
 
                 KSharedPtr<KeyCheckpointFile> keyFileSPtr = co_await KeyCheckpointFile::CreateAsync(traceComponent, *keyFileNameSPtr, isValueAReferenceType, fileId, allocator);
                 ValueCheckpointFile::SPtr valueFileSPtr = co_await ValueCheckpointFile::CreateAsync(traceComponent, *valueFileNameSPtr, fileId, allocator);
+                valueFileSPtr->SetCompressionCodec(valueCompressionCodec);
 
                 KSharedPtr<CheckpointFile> checkpointFileSPtr = nullptr;
                 status = CheckpointFile::Create(filename, *keyFileSPtr, *valueFileSPtr, traceComponent, allocator, checkpointFileSPtr);
@@ -197,6 +234,14 @@ namespace Data
                 co_return checkpointFileSPtr;
             }
 
+            //
+            // Serve subsequent value reads from a mapping of the value file, charged against the given budget.
+            //
+            void EnableMappedReads(__in MappedFileBudget & budget)
+            {
+                valueCheckpointFileSPtr_->EnableMappedReads(budget);
+            }
+
             //
             // Read the given value from disk.
             //
@@ -217,15 +262,35 @@ namespace Data
                 return valueCheckpointFileSPtr_->ReadValueAsync(item);
             }
 
+            //
+            // Read the given values from disk, in the order of the given items.
+            //
+            template<typename TValue>
+            ktl::Awaitable<KSharedPtr<KSharedArray<KBuffer::SPtr>>> ReadValuesAsync(__in KSharedArray<KSharedPtr<VersionedItem<TValue>>>& items)
+            {
+                return valueCheckpointFileSPtr_->ReadValuesAsync(items);
+            }
+
             template<typename TKey, typename TValue>
             KSharedPtr<KeyCheckpointFileAsyncEnumerator<TKey, TValue>> GetAsyncEnumerator(
                 __in Data::StateManager::IStateSerializer<TKey>& keySerializer)
+            {
+                return GetAsyncEnumerator<TKey, TValue>(keySerializer, keyCheckpointFileSPtr_->PropertiesSPtr->KeysHandle->Offset);
+            }
+
+            //
+            // Enumerates the keys from the key block at the given offset to the end of the file.
+            //
+            template<typename TKey, typename TValue>
+            KSharedPtr<KeyCheckpointFileAsyncEnumerator<TKey, TValue>> GetAsyncEnumerator(
+                __in Data::StateManager::IStateSerializer<TKey>& keySerializer,
+                __in ULONG64 startOffset)
             {
                  KSharedPtr<KeyCheckpointFileAsyncEnumerator<TKey, TValue>> enumeratorSPtr = nullptr;
                  NTSTATUS status = KeyCheckpointFileAsyncEnumerator<TKey, TValue>::Create(
                      *keyCheckpointFileSPtr_,
                      keySerializer,
-                     keyCheckpointFileSPtr_->PropertiesSPtr->KeysHandle->Offset,
+                     startOffset,
                      keyCheckpointFileSPtr_->PropertiesSPtr->KeysHandle->EndOffset(),
                      *traceComponent_,
                      GetThisAllocator(),
@@ -259,6 +324,7 @@ namespace Data
             KSharedPtr<ValueCheckpointFile> valueCheckpointFileSPtr_;
             ULONG64 cachedFileSize_;
             bool isFileSizeCached_;
+            ULONG64 valueCacheFileId_;
             
             StoreTraceComponent::SPtr traceComponent_;
         };
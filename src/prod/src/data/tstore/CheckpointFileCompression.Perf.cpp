@@ -0,0 +1,302 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#include <boost/test/unit_test.hpp>
+#include "Common/boost-taef.h"
+#include "TStoreTestBase.h"
+
+#define ALLOC_TAG 'ccPT'
+
+namespace TStoreTests
+{
+    using namespace ktl;
+    using namespace Data::Utilities;
+
+    //
+    // Compares value checkpoint files written with and without value compression:
+    // bytes written to disk, write time and the latency of reading values back from a reopened file.
+    //
+    class CheckpointFileCompressionPerfTest
+    {
+    public:
+        Common::CommonConfig config; // load the config object as it's needed for the tracing to work
+
+        CheckpointFileCompressionPerfTest()
+        {
+            NTSTATUS status;
+            status = KtlSystem::Initialize(FALSE, &ktlSystem_);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            ktlSystem_->SetStrictAllocationChecks(TRUE);
+        }
+
+        ~CheckpointFileCompressionPerfTest()
+        {
+            ktlSystem_->Shutdown();
+        }
+
+        KAllocator& GetAllocator()
+        {
+            return ktlSystem_->NonPagedAllocator();
+        }
+
+        //
+        // Values look like small serialized records: a repeated template with a quarter of the bytes random.
+        //
+        KBuffer::SPtr CreateValue(__in ULONG32 sizeInBytes, __in Common::Random & random)
+        {
+            static const char Template[] = "{\"name\":\"item\",\"state\":\"active\"}";
+            const ULONG32 templateLength = sizeof(Template) - 1;
+
+            KBuffer::SPtr resultSPtr = nullptr;
+            NTSTATUS status = KBuffer::Create(sizeInBytes, resultSPtr, GetAllocator());
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            byte* buffer = static_cast<byte *>(resultSPtr->GetBuffer());
+            for (ULONG32 i = 0; i < sizeInBytes; i++)
+            {
+                buffer[i] = (i % 4 == 3) ? static_cast<byte>(random.Next()) : static_cast<byte>(Template[i % templateLength]);
+            }
+
+            return resultSPtr;
+        }
+
+        KBuffer::SPtr CreateKey(__in ULONG32 index)
+        {
+            KBuffer::SPtr resultSPtr = nullptr;
+            NTSTATUS status = KBuffer::Create(sizeof(ULONG32), resultSPtr, GetAllocator());
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            // Big endian, so that the buffer comparer orders keys by index.
+            byte* buffer = static_cast<byte *>(resultSPtr->GetBuffer());
+            buffer[0] = static_cast<byte>(index >> 24);
+            buffer[1] = static_cast<byte>(index >> 16);
+            buffer[2] = static_cast<byte>(index >> 8);
+            buffer[3] = static_cast<byte>(index);
+            return resultSPtr;
+        }
+
+        KString::SPtr CreateFileString(__in KStringView const & name)
+        {
+            KAllocator& allocator = GetAllocator();
+            KString::SPtr fileName;
+
+            WCHAR currentDirectoryPathCharArray[MAX_PATH];
+            GetCurrentDirectory(MAX_PATH, currentDirectoryPathCharArray);
+
+#if !defined(PLATFORM_UNIX)
+            NTSTATUS status = KString::Create(fileName, allocator, L"\\??\\");
+#else
+            NTSTATUS status = KString::Create(fileName, allocator, L"");
+#endif
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            BOOLEAN concatSuccess = fileName->Concat(currentDirectoryPathCharArray);
+            CODING_ERROR_ASSERT(concatSuccess == TRUE);
+
+            concatSuccess = fileName->Concat(Common::Path::GetPathSeparatorWstr().c_str());
+            CODING_ERROR_ASSERT(concatSuccess == TRUE);
+
+            concatSuccess = fileName->Concat(name);
+            CODING_ERROR_ASSERT(concatSuccess == TRUE);
+
+            return fileName.RawPtr();
+        }
+
+        KBufferSerializer::SPtr CreateBufferSerializer()
+        {
+            KBufferSerializer::SPtr valueSerializerSPtr;
+            auto status = KBufferSerializer::Create(GetAllocator(), valueSerializerSPtr);
+            KInvariant(NT_SUCCESS(status));
+
+            return valueSerializerSPtr;
+        }
+
+        StoreTraceComponent::SPtr CreateTraceComponent()
+        {
+            KGuid guid;
+            guid.CreateNew();
+            ::FABRIC_REPLICA_ID replicaId = 1;
+            int stateProviderId = 1;
+
+            StoreTraceComponent::SPtr traceComponent = nullptr;
+            NTSTATUS status = StoreTraceComponent::Create(guid, replicaId, stateProviderId, GetAllocator(), traceComponent);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            return traceComponent;
+        }
+
+        KSharedPtr<IEnumerator<KeyValuePair<KBuffer::SPtr, KSharedPtr<VersionedItem<KBuffer::SPtr>>>>> GetEnumerator(
+            __in KSharedArray<KeyValuePair<KSharedPtr<KBuffer>, KSharedPtr<VersionedItem<KSharedPtr<KBuffer>>>>> const & items)
+        {
+            KSharedPtr<ArrayKeyVersionedItemEnumerator<KBuffer::SPtr, KBuffer::SPtr>> arrayEnumeratorSPtr = nullptr;
+            NTSTATUS status = ArrayKeyVersionedItemEnumerator<KBuffer::SPtr, KBuffer::SPtr>::Create(items, GetAllocator(), arrayEnumeratorSPtr);
+            KInvariant(NT_SUCCESS(status));
+
+            KSharedPtr<IEnumerator<KeyValuePair<KBuffer::SPtr, KSharedPtr<VersionedItem<KBuffer::SPtr>>>>> enumeratorSPtr =
+                static_cast<IEnumerator<KeyValuePair<KBuffer::SPtr, KSharedPtr<VersionedItem<KBuffer::SPtr>>>> *>(arrayEnumeratorSPtr.RawPtr());
+
+            KInvariant(enumeratorSPtr != nullptr);
+            return enumeratorSPtr;
+        }
+
+        VersionedItem<KBuffer::SPtr>::SPtr CreateInsertedVersionedItem(
+            __in KBuffer & buffer,
+            __in LONG64 versionSequenceNumber)
+        {
+            InsertedVersionedItem<KBuffer::SPtr>::SPtr itemSPtr = nullptr;
+            NTSTATUS status = InsertedVersionedItem<KBuffer::SPtr>::Create(GetAllocator(), itemSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            KBuffer::SPtr bufferSPtr = &buffer;
+            itemSPtr->InitializeOnApply(versionSequenceNumber, bufferSPtr);
+            itemSPtr->SetValueSize(bufferSPtr->QuerySize());
+
+            return static_cast<VersionedItem<KBuffer::SPtr> *>(itemSPtr.RawPtr());
+        }
+
+        KSharedArray<KeyValuePair<KBuffer::SPtr, VersionedItem<KBuffer::SPtr>::SPtr>>::SPtr CreateItems(
+            __in ULONG32 numItems,
+            __in ULONG32 valueSize)
+        {
+            KSharedArray<KeyValuePair<KBuffer::SPtr, VersionedItem<KBuffer::SPtr>::SPtr>>::SPtr resultSPtr =
+                _new(ALLOC_TAG, GetAllocator()) KSharedArray<KeyValuePair<KBuffer::SPtr, VersionedItem<KBuffer::SPtr>::SPtr>>();
+            CODING_ERROR_ASSERT(resultSPtr != nullptr);
+
+            // Same seed for every run, so that the compressed and uncompressed files hold identical values.
+            Common::Random random(42);
+            for (ULONG32 i = 0; i < numItems; i++)
+            {
+                KBuffer::SPtr keySPtr = CreateKey(i);
+                KBuffer::SPtr valueSPtr = CreateValue(valueSize, random);
+                auto itemSPtr = CreateInsertedVersionedItem(*valueSPtr, i + 1);
+                resultSPtr->Append(KeyValuePair<KBuffer::SPtr, VersionedItem<KBuffer::SPtr>::SPtr>(keySPtr, itemSPtr));
+            }
+
+            return resultSPtr;
+        }
+
+        LONG64 GetFileSize(__in KString const & fileName)
+        {
+            LONG64 size = 0;
+            Common::ErrorCode error = Common::File::GetSize(std::wstring(static_cast<LPCWSTR>(fileName)), size);
+            CODING_ERROR_ASSERT(error.IsSuccess());
+            return size;
+        }
+
+        void WriteReadValues(
+            __in KStringView const & testName,
+            __in CompressionCodecId::Enum codecId,
+            __in ULONG32 numItems,
+            __in ULONG32 valueSize)
+        {
+            TRACE_TEST();
+
+            auto itemsSPtr = CreateItems(numItems, valueSize);
+            KString::SPtr filenameSPtr = CreateFileString(testName);
+            auto bufferSerializerSPtr = CreateBufferSerializer();
+            StorePerformanceCountersSPtr perfCounters = nullptr;
+
+            Common::Stopwatch writeStopwatch;
+            writeStopwatch.Start();
+            CheckpointFile::SPtr writtenFileSPtr = SyncAwait(CheckpointFile::CreateAsync<KBuffer::SPtr, KBuffer::SPtr>(
+                1,
+                *filenameSPtr,
+                *GetEnumerator(*itemsSPtr),
+                *bufferSerializerSPtr,
+                *bufferSerializerSPtr,
+                1,
+                GetAllocator(),
+                *CreateTraceComponent(),
+                perfCounters,
+                true,
+                codecId));
+            writeStopwatch.Stop();
+
+            KString::SPtr keyFileNameSPtr = writtenFileSPtr->KeyCheckpointFileNameSPtr;
+            KString::SPtr valueFileNameSPtr = writtenFileSPtr->ValueCheckpointFileNameSPtr;
+            SyncAwait(writtenFileSPtr->CloseAsync());
+
+            LONG64 valueFileSize = GetFileSize(*valueFileNameSPtr);
+
+            // Reopen the file, so that reads go through the codec recorded in the file properties.
+            KStringView filename(*filenameSPtr);
+            CheckpointFile::SPtr checkpointFileSPtr = SyncAwait(CheckpointFile::OpenAsync(filename, *CreateTraceComponent(), GetAllocator(), true));
+            CODING_ERROR_ASSERT(checkpointFileSPtr->ValueCompressionCodec == codecId);
+
+            std::vector<LONG64> readLatencies;
+            readLatencies.reserve(numItems);
+
+            for (ULONG32 i = 0; i < numItems; i++)
+            {
+                auto item = (*itemsSPtr)[i];
+
+                Common::Stopwatch readStopwatch;
+                readStopwatch.Start();
+                KBuffer::SPtr valueSPtr = SyncAwait(checkpointFileSPtr->ReadValueAsync<KBuffer::SPtr>(*item.Value, *bufferSerializerSPtr));
+                readStopwatch.Stop();
+
+                readLatencies.push_back(readStopwatch.ElapsedMicroseconds);
+                CODING_ERROR_ASSERT(valueSPtr->QuerySize() == valueSize);
+                CODING_ERROR_ASSERT(memcmp(valueSPtr->GetBuffer(), item.Value->GetValue()->GetBuffer(), valueSize) == 0);
+            }
+
+            std::sort(readLatencies.begin(), readLatencies.end());
+            LONG64 totalLatency = 0;
+            for (LONG64 latency : readLatencies)
+            {
+                totalLatency += latency;
+            }
+
+            Trace.WriteInfo(
+                BoostTestTrace,
+                "Codec {0}: wrote {1} values of {2} bytes in {3} ms. Value file bytes: {4} ({5} bytes of values). Read latency us: avg {6} p50 {7} p99 {8}",
+                static_cast<ULONG32>(codecId),
+                numItems,
+                valueSize,
+                writeStopwatch.ElapsedMilliseconds,
+                valueFileSize,
+                static_cast<ULONG64>(numItems) * valueSize,
+                totalLatency / numItems,
+                readLatencies[numItems / 2],
+                readLatencies[(numItems * 99) / 100]);
+
+            SyncAwait(checkpointFileSPtr->CloseAsync());
+            Common::File::Delete(keyFileNameSPtr->operator LPCWSTR());
+            Common::File::Delete(valueFileNameSPtr->operator LPCWSTR());
+        }
+
+        void CompareCodecs(
+            __in ULONG32 numItems,
+            __in ULONG32 valueSize)
+        {
+            WriteReadValues(L"CheckpointFileCompression_None", CompressionCodecId::None, numItems, valueSize);
+            WriteReadValues(L"CheckpointFileCompression_Lz", CompressionCodecId::Lz, numItems, valueSize);
+        }
+
+    private:
+        KtlSystem* ktlSystem_;
+    };
+
+    BOOST_FIXTURE_TEST_SUITE(CheckpointFileCompressionPerfTestSuite, CheckpointFileCompressionPerfTest)
+
+    BOOST_AUTO_TEST_CASE(CheckpointFileCompression_10K_100Bytes)
+    {
+        CompareCodecs(10000, 100);
+    }
+
+    BOOST_AUTO_TEST_CASE(CheckpointFileCompression_100K_1KB, *boost::unit_test::label("perf-cit"))
+    {
+        CompareCodecs(100000, 1024);
+    }
+
+    BOOST_AUTO_TEST_CASE(CheckpointFileCompression_10K_16KB)
+    {
+        CompareCodecs(10000, 16 * 1024);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+}
@@ -0,0 +1,67 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#define CLOCKPOLICY_TAG 'lcVS'
+
+using namespace Data::TStore;
+
+ClockEvictionPolicy::ClockEvictionPolicy()
+    : clockList_(ValueCacheEntry::PolicyListEntryOffset)
+{
+}
+
+ClockEvictionPolicy::~ClockEvictionPolicy()
+{
+}
+
+NTSTATUS ClockEvictionPolicy::Create(
+    __in KAllocator & allocator,
+    __out ClockEvictionPolicy::SPtr & result)
+{
+    result = _new(CLOCKPOLICY_TAG, allocator) ClockEvictionPolicy();
+
+    if (!result)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+void ClockEvictionPolicy::OnInsert(__in ValueCacheEntry & entry)
+{
+    // New entries go right behind the hand, so they get a full revolution before they are considered.
+    entry.PolicyState = 0;
+    clockList_.AppendTail(&entry);
+}
+
+void ClockEvictionPolicy::OnHit(__in ValueCacheEntry & entry)
+{
+    entry.PolicyState = Referenced;
+}
+
+void ClockEvictionPolicy::OnRemove(__in ValueCacheEntry & entry)
+{
+    clockList_.Remove(&entry);
+}
+
+ValueCacheEntry * ClockEvictionPolicy::SelectVictim()
+{
+    // Terminates within one revolution since every pass clears the referenced bit.
+    while (true)
+    {
+        ValueCacheEntry * candidate = clockList_.PeekHead();
+        if (candidate == nullptr || candidate->PolicyState != Referenced)
+        {
+            return candidate;
+        }
+
+        candidate->PolicyState = 0;
+        clockList_.RemoveHead();
+        clockList_.AppendTail(candidate);
+    }
+}
@@ -0,0 +1,52 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace TStore
+    {
+        //
+        // CLOCK (second chance).
+        // A hit only sets the referenced bit of the entry, so lookups never reorder the list.
+        // The hand passes over referenced entries once, clearing the bit, before they can be evicted.
+        //
+        class ClockEvictionPolicy
+            : public IValueCacheEvictionPolicy
+            , public KObject<ClockEvictionPolicy>
+            , public KShared<ClockEvictionPolicy>
+        {
+            K_FORCE_SHARED(ClockEvictionPolicy)
+            K_SHARED_INTERFACE_IMP(IValueCacheEvictionPolicy)
+
+        public:
+
+            static NTSTATUS Create(
+                __in KAllocator & allocator,
+                __out ClockEvictionPolicy::SPtr & result);
+
+            ValueCacheEvictionPolicyKind::Enum get_Kind() const override
+            {
+                return ValueCacheEvictionPolicyKind::Clock;
+            }
+
+            void OnInsert(__in ValueCacheEntry & entry) override;
+
+            void OnHit(__in ValueCacheEntry & entry) override;
+
+            void OnRemove(__in ValueCacheEntry & entry) override;
+
+            ValueCacheEntry * SelectVictim() override;
+
+        private:
+
+            static const ULONG32 Referenced = 1;
+
+            // The head of the list is the position of the hand.
+            KNodeList<ValueCacheEntry> clockList_;
+        };
+    }
+}
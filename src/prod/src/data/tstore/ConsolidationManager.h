@@ -710,8 +710,250 @@ namespace Data
                 __in ktl::CancellationToken const cancellationToken)
             {
                 StoreEventSource::Events->ConsolidationManagerMergeAsync(traceComponent_->PartitionId, traceComponent_->TraceTag, L"started");
-                
+
+                MetadataTable::SPtr mergeTableSPtr = &mergeTable;
+                KSharedPtr<ConsolidatedStoreComponent<TKey, TValue>> newConsolidatedStateSPtr = &newConsolidatedState;
+                KSharedArray<ULONG32>::SPtr listOfFileIdsSPtr = &listOfFileIds;
+                StorePerformanceCountersSPtr perfCountersSPtr = perfCounters;
+
                 PostMergeMetadataTableInformation::SPtr mergeMetadataTableInformationSPtr = nullptr;
+
+                // Key hashes are only needed if some file in the merge table has a bloom filter.
+                bool useBloomFilters = false;
+                auto bloomFilterTableEnumeratorSPtr = mergeTableSPtr->Table->GetEnumerator();
+                while (bloomFilterTableEnumeratorSPtr->MoveNext())
+                {
+                    auto checkpointFileSPtr = bloomFilterTableEnumeratorSPtr->Current().Value->CheckpointFileSPtr;
+                    if (checkpointFileSPtr != nullptr && checkpointFileSPtr->HasBloomFilter)
+                    {
+                        useBloomFilters = true;
+                        break;
+                    }
+                }
+
+                // Every range file shares one logical time stamp. Their keys do not overlap, so it only orders them against the other files.
+                auto logicalTimeStamp = consolidationProviderSPtr_->IncrementFileStamp();
+
+                KSharedPtr<KSharedArray<TKey>> splitKeysSPtr = co_await GetMergeSplitKeysAsync(*mergeTableSPtr, *listOfFileIdsSPtr);
+                ULONG32 rangeCount = splitKeysSPtr->Count() + 1;
+
+                KSharedArray<FileMetadata::SPtr>::SPtr newMergedFilesSPtr = _new(CONSOLIDATIONMANAGER_TAG, this->GetThisAllocator()) KSharedArray<FileMetadata::SPtr>();
+                Diagnostics::Validate(newMergedFilesSPtr);
+
+                NTSTATUS status = STATUS_SUCCESS;
+
+                if (rangeCount == 1)
+                {
+                    FileMetadata::SPtr mergedFileMetadataSPtr = co_await MergeKeyRangeAsync(
+                        *mergeTableSPtr,
+                        *listOfFileIdsSPtr,
+                        *newConsolidatedStateSPtr,
+                        *splitKeysSPtr,
+                        0,
+                        logicalTimeStamp,
+                        useBloomFilters,
+                        perfCountersSPtr,
+                        cancellationToken);
+
+                    if (mergedFileMetadataSPtr != nullptr)
+                    {
+                        status = newMergedFilesSPtr->Append(mergedFileMetadataSPtr);
+                        STORE_ASSERT(NT_SUCCESS(status), "unable to append merged file to list of merged files");
+                    }
+                }
+                else
+                {
+                    StoreEventSource::Events->ConsolidationManagerMergeAsync(traceComponent_->PartitionId, traceComponent_->TraceTag, L"partitioned");
+
+                    KSharedArray<ktl::Awaitable<FileMetadata::SPtr>>::SPtr rangeTasksSPtr = _new(CONSOLIDATIONMANAGER_TAG, this->GetThisAllocator()) KSharedArray<ktl::Awaitable<FileMetadata::SPtr>>();
+                    Diagnostics::Validate(rangeTasksSPtr);
+
+                    for (ULONG32 rangeIndex = 0; rangeIndex < rangeCount; rangeIndex++)
+                    {
+                        status = rangeTasksSPtr->Append(MergeKeyRangeOnThreadPoolAsync(
+                            *mergeTableSPtr,
+                            *listOfFileIdsSPtr,
+                            *newConsolidatedStateSPtr,
+                            *splitKeysSPtr,
+                            rangeIndex,
+                            logicalTimeStamp,
+                            useBloomFilters,
+                            perfCountersSPtr,
+                            cancellationToken));
+                        STORE_ASSERT(NT_SUCCESS(status), "unable to append range merge task");
+                    }
+
+                    // Wait for every range, even after one fails, so that no range is still reading the merged files when merge returns.
+                    SharedException::CSPtr exceptionCSPtr = nullptr;
+                    for (ULONG32 rangeIndex = 0; rangeIndex < rangeCount; rangeIndex++)
+                    {
+                        try
+                        {
+                            FileMetadata::SPtr mergedFileMetadataSPtr = co_await (*rangeTasksSPtr)[rangeIndex];
+                            if (mergedFileMetadataSPtr != nullptr)
+                            {
+                                status = newMergedFilesSPtr->Append(mergedFileMetadataSPtr);
+                                STORE_ASSERT(NT_SUCCESS(status), "unable to append merged file to list of merged files");
+                            }
+                        }
+                        catch (ktl::Exception const & e)
+                        {
+                            if (exceptionCSPtr == nullptr)
+                            {
+                                exceptionCSPtr = SharedException::Create(e, this->GetThisAllocator());
+                            }
+                        }
+                    }
+
+                    if (exceptionCSPtr != nullptr)
+                    {
+                        // Files of the ranges that completed are not in any metadata table yet, so nothing else will remove them.
+                        for (ULONG32 i = 0; i < newMergedFilesSPtr->Count(); i++)
+                        {
+                            CheckpointFile::SPtr checkpointFileSPtr = (*newMergedFilesSPtr)[i]->CheckpointFileSPtr;
+                            co_await checkpointFileSPtr->CloseAsync();
+                            Common::File::Delete(checkpointFileSPtr->KeyCheckpointFileNameSPtr->operator LPCWSTR(), true);
+                            Common::File::Delete(checkpointFileSPtr->ValueCheckpointFileNameSPtr->operator LPCWSTR(), true);
+                        }
+
+                        auto exec = exceptionCSPtr->Info;
+                        throw exec;
+                    }
+                }
+
+                KSharedArray<ULONG32>::SPtr deletedFileIds = _new(CONSOLIDATIONMANAGER_TAG, this->GetThisAllocator()) KSharedArray<ULONG32>();
+                Diagnostics::Validate(deletedFileIds);
+                for (ULONG32 i = 0; i < listOfFileIdsSPtr->Count(); i++)
+                {
+                    status = deletedFileIds->Append((*listOfFileIdsSPtr)[i]);
+                    STORE_ASSERT(NT_SUCCESS(status), "unable to append file id to deleted file ids list");
+                }
+
+                // there could be deleted filed ids w/o a new merged file depending on invalid entries
+                status = PostMergeMetadataTableInformation::Create(*deletedFileIds, *newMergedFilesSPtr, this->GetThisAllocator(), mergeMetadataTableInformationSPtr);
+                Diagnostics::Validate(status);
+
+                if (newMergedFilesSPtr->Count() > 0)
+                {
+                    MetadataTable::SPtr mergedMetadataTableSPtr;
+                    MetadataTable::Create(this->GetThisAllocator(), mergedMetadataTableSPtr);
+                    for (ULONG32 i = 0; i < newMergedFilesSPtr->Count(); i++)
+                    {
+                        FileMetadata::SPtr mergedFileMetadataSPtr = (*newMergedFilesSPtr)[i];
+                        mergedMetadataTableSPtr->Table->Add(mergedFileMetadataSPtr->FileId, mergedFileMetadataSPtr);
+                    }
+
+                    consolidationProviderSPtr_->MergeMetadataTableSPtr = mergedMetadataTableSPtr;
+                }
+
+                STORE_ASSERT(mergeMetadataTableInformationSPtr != nullptr, "mergeMetadataTableInformationSPtr != nullptr");
+                STORE_ASSERT(mergeMetadataTableInformationSPtr->DeletedFileIdsSPtr != nullptr, "mergeMetadataTableInformationSPtr->DeletedFileIdsSPtr != nullptr");
+
+                StoreEventSource::Events->ConsolidationManagerMergeAsync(traceComponent_->PartitionId, traceComponent_->TraceTag, L"completed");
+
+                co_return mergeMetadataTableInformationSPtr;
+            }
+
+            //
+            // Picks the keys that split the merge into ranges, at most MergeDegreeOfParallelism of them.
+            // Returns no keys when the merge should be done as a single range.
+            //
+            ktl::Awaitable<KSharedPtr<KSharedArray<TKey>>> GetMergeSplitKeysAsync(
+                __in MetadataTable & mergeTable,
+                __in KSharedArray<ULONG32> & listOfFileIds)
+            {
+                MetadataTable::SPtr mergeTableSPtr = &mergeTable;
+                KSharedArray<ULONG32>::SPtr listOfFileIdsSPtr = &listOfFileIds;
+
+                // The largest file samples the key space most finely, so the split keys are taken from its blocks.
+                FileMetadata::SPtr largestFileMetadataSPtr = nullptr;
+                for (ULONG32 i = 0; i < listOfFileIdsSPtr->Count(); i++)
+                {
+                    FileMetadata::SPtr fileMetadataSPtr = nullptr;
+                    bool found = mergeTableSPtr->Table->TryGetValue((*listOfFileIdsSPtr)[i], fileMetadataSPtr);
+                    STORE_ASSERT(found, "fileId {1} should be in merge table", (*listOfFileIdsSPtr)[i]);
+
+                    if (largestFileMetadataSPtr == nullptr || fileMetadataSPtr->CheckpointFileSPtr->KeyCount > largestFileMetadataSPtr->CheckpointFileSPtr->KeyCount)
+                    {
+                        largestFileMetadataSPtr = fileMetadataSPtr;
+                    }
+                }
+
+                ULONG64 rangeCount = consolidationProviderSPtr_->MergeDegreeOfParallelism;
+                if (largestFileMetadataSPtr != nullptr)
+                {
+                    // Each range writes its own file pair, which is not worth it for a small range.
+                    ULONG64 maxRangeCount = largestFileMetadataSPtr->CheckpointFileSPtr->KeyCount / MinimumKeysPerMergeRange;
+                    if (rangeCount > maxRangeCount)
+                    {
+                        rangeCount = maxRangeCount;
+                    }
+                }
+
+                if (rangeCount <= 1)
+                {
+                    KSharedPtr<KSharedArray<TKey>> noSplitKeysSPtr = _new(CONSOLIDATIONMANAGER_TAG, this->GetThisAllocator()) KSharedArray<TKey>();
+                    Diagnostics::Validate(noSplitKeysSPtr);
+                    co_return noSplitKeysSPtr;
+                }
+
+                KSharedPtr<KeyRangePartitioner<TKey, TValue>> partitionerSPtr = nullptr;
+                NTSTATUS status = KeyRangePartitioner<TKey, TValue>::Create(
+                    *consolidationProviderSPtr_->KeyConverterSPtr,
+                    *consolidationProviderSPtr_->KeyComparerSPtr,
+                    *traceComponent_,
+                    this->GetThisAllocator(),
+                    partitionerSPtr);
+                Diagnostics::Validate(status);
+
+                KeyCheckpointFile::SPtr keyCheckpointFileSPtr = largestFileMetadataSPtr->CheckpointFileSPtr->KeyCheckpointFileSPtr;
+                KSharedPtr<KSharedArray<TKey>> splitKeysSPtr = co_await partitionerSPtr->GetSplitKeysAsync(*keyCheckpointFileSPtr, static_cast<ULONG32>(rangeCount));
+                co_return splitKeysSPtr;
+            }
+
+            ktl::Awaitable<FileMetadata::SPtr> MergeKeyRangeOnThreadPoolAsync(
+                __in MetadataTable & mergeTable,
+                __in KSharedArray<ULONG32> & listOfFileIds,
+                __in ConsolidatedStoreComponent<TKey, TValue> & newConsolidatedState,
+                __in KSharedArray<TKey> & splitKeys,
+                __in ULONG32 rangeIndex,
+                __in ULONG64 logicalTimeStamp,
+                __in bool useBloomFilters,
+                __in StorePerformanceCountersSPtr perfCounters,
+                __in ktl::CancellationToken const cancellationToken)
+            {
+                co_await ktl::CorHelper::ThreadPoolThread(this->GetThisKtlSystem().DefaultThreadPool());
+
+                FileMetadata::SPtr mergedFileMetadataSPtr = co_await MergeKeyRangeAsync(
+                    mergeTable,
+                    listOfFileIds,
+                    newConsolidatedState,
+                    splitKeys,
+                    rangeIndex,
+                    logicalTimeStamp,
+                    useBloomFilters,
+                    perfCounters,
+                    cancellationToken);
+
+                co_return mergedFileMetadataSPtr;
+            }
+
+            //
+            // K-way merges the keys of range rangeIndex, [splitKeys[rangeIndex - 1], splitKeys[rangeIndex]), into a new checkpoint file.
+            // Returns null if no key in the range needs to be written.
+            //
+            ktl::Awaitable<FileMetadata::SPtr> MergeKeyRangeAsync(
+                __in MetadataTable & mergeTable,
+                __in KSharedArray<ULONG32> & listOfFileIds,
+                __in ConsolidatedStoreComponent<TKey, TValue> & newConsolidatedState,
+                __in KSharedArray<TKey> & splitKeys,
+                __in ULONG32 rangeIndex,
+                __in ULONG64 logicalTimeStamp,
+                __in bool useBloomFilters,
+                __in StorePerformanceCountersSPtr perfCounters,
+                __in ktl::CancellationToken const cancellationToken)
+            {
+                FileMetadata::SPtr mergedFileMetadataSPtr = nullptr;
                 KArray<KSharedPtr<KeyCheckpointFileAsyncEnumerator<TKey, TValue>>> enumerators(this->GetThisAllocator());
                 SharedException::CSPtr exceptionCSPtr;
 
@@ -730,14 +972,41 @@ namespace Data
                     MetadataTable::SPtr mergeTableSPtr = &mergeTable;
                     KSharedPtr<ConsolidatedStoreComponent<TKey, TValue>> newConsolidatedStateSPtr = &newConsolidatedState;
                     KSharedArray<ULONG32>::SPtr listOfFileIdsSPtr = &listOfFileIds;
+                    KSharedPtr<KSharedArray<TKey>> splitKeysSPtr = &splitKeys;
+
+                    bool hasLowerBound = rangeIndex > 0;
+                    bool hasUpperBound = rangeIndex < splitKeysSPtr->Count();
+                    KSharedPtr<IComparer<TKey>> keyComparerSPtr = consolidationProviderSPtr_->KeyComparerSPtr;
 
-                    // TODO: trace
-                    FileMetadata::SPtr mergedFileMetadataSPtr = nullptr;
-                    
                     KPriorityQueue<KSharedPtr<KeyCheckpointFileAsyncEnumerator<TKey, TValue>>> priorityQueue(
                         this->GetThisAllocator(),
                         KeyCheckpointFileAsyncEnumerator<TKey, TValue>::CompareEnumerators);
 
+                    // Files being merged that carry a key bloom filter, used to measure the filter false positive rate.
+                    KArray<FileMetadata::SPtr> bloomFilterMergeFiles(this->GetThisAllocator());
+
+                    // Ids of the files being merged that contain the key currently being merged.
+                    KArray<ULONG32> containingFileIds(this->GetThisAllocator());
+
+                    // Serializes each merged key for hashing, reused across the keys of this range.
+                    BinaryWriter keyWriter(this->GetThisAllocator());
+
+                    ULONG64 bloomFilterAbsentKeyProbes = 0;
+                    ULONG64 bloomFilterFalsePositives = 0;
+
+                    KSharedPtr<KeyRangePartitioner<TKey, TValue>> partitionerSPtr = nullptr;
+                    NTSTATUS status = STATUS_SUCCESS;
+                    if (hasLowerBound)
+                    {
+                        status = KeyRangePartitioner<TKey, TValue>::Create(
+                            *consolidationProviderSPtr_->KeyConverterSPtr,
+                            *keyComparerSPtr,
+                            *traceComponent_,
+                            this->GetThisAllocator(),
+                            partitionerSPtr);
+                        Diagnostics::Validate(status);
+                    }
+
                     // Get Enumerators for each file from the MetadataTable
                     for (ULONG32 i = 0; i < listOfFileIdsSPtr->Count(); i++)
                     {
@@ -746,23 +1015,50 @@ namespace Data
                         bool found = mergeTableSPtr->Table->TryGetValue(fileId, fileMetadataSPtr);
                         STORE_ASSERT(found, "fileId {1} should be in merge table", fileId);
 
-                        auto enumeratorSPtr = fileMetadataSPtr->CheckpointFileSPtr->GetAsyncEnumerator<TKey, TValue>(*consolidationProviderSPtr_->KeyConverterSPtr);
+                        if (fileMetadataSPtr->CheckpointFileSPtr->HasBloomFilter)
+                        {
+                            auto appendStatus = bloomFilterMergeFiles.Append(fileMetadataSPtr);
+                            STORE_ASSERT(NT_SUCCESS(appendStatus), "unable to append file metadata to list of bloom filter files");
+                        }
+
+                        // Skip the blocks that hold only keys below the range.
+                        ULONG64 startOffset = fileMetadataSPtr->CheckpointFileSPtr->KeyBlockHandleSPtr->Offset;
+                        if (hasLowerBound)
+                        {
+                            startOffset = co_await partitionerSPtr->FindStartOffsetAsync(
+                                *fileMetadataSPtr->CheckpointFileSPtr->KeyCheckpointFileSPtr,
+                                (*splitKeysSPtr)[rangeIndex - 1]);
+                        }
+
+                        auto enumeratorSPtr = fileMetadataSPtr->CheckpointFileSPtr->GetAsyncEnumerator<TKey, TValue>(*consolidationProviderSPtr_->KeyConverterSPtr, startOffset);
                         STORE_ASSERT(enumeratorSPtr != nullptr, "key checkpoint file enumerator should not be null");
-                        enumeratorSPtr->KeyComparerSPtr = *consolidationProviderSPtr_->KeyComparerSPtr;
+                        enumeratorSPtr->KeyComparerSPtr = *keyComparerSPtr;
+
+                        // Track the enumerator before priming it so that it is closed if priming throws.
+                        status = enumerators.Append(enumeratorSPtr);
+                        STORE_ASSERT(NT_SUCCESS(status), "unable to append enumerator to list of enumerators");
 
-                        // Prime the enumerator so it can be compared
+                        // Prime the enumerator with its first key in the range so it can be compared
                         auto hasNext = co_await enumeratorSPtr->MoveNextAsync(cancellationToken);
-                        STORE_ASSERT(hasNext, "enumerator should not be empty");
+                        STORE_ASSERT(hasNext || hasLowerBound || hasUpperBound, "enumerator should not be empty");
 
-                        // Merge cannot be interrupted before enumerator is added here so races here can be ignored
-                        auto status = enumerators.Append(enumeratorSPtr);
-                        STORE_ASSERT(NT_SUCCESS(status), "unable to append enumerator to list of enumerators");
-                        priorityQueue.Push(enumeratorSPtr);
+                        while (hasNext && hasLowerBound && keyComparerSPtr->Compare(enumeratorSPtr->GetCurrent()->Key, (*splitKeysSPtr)[rangeIndex - 1]) < 0)
+                        {
+                            hasNext = co_await enumeratorSPtr->MoveNextAsync(cancellationToken);
+                        }
+
+                        if (!hasNext || (hasUpperBound && keyComparerSPtr->Compare(enumeratorSPtr->GetCurrent()->Key, (*splitKeysSPtr)[rangeIndex]) >= 0))
+                        {
+                            // The file has no keys in this range.
+                            co_await enumeratorSPtr->CloseAsync();
+                            continue;
+                        }
+
+                        status = priorityQueue.Push(enumeratorSPtr);
+                        STORE_ASSERT(NT_SUCCESS(status), "unable to push enumerator to priority queue");
                     }
 
                     // Start writing a new filename
-                    auto logicalTimeStamp = consolidationProviderSPtr_->IncrementFileStamp();
-                    
                     KString::SPtr fileNameSPtr = nullptr;
 
                     auto fileId = co_await CreateNewCheckpointFilesAsync(fileNameSPtr, keyFileSPtr, valueFileSPtr);
@@ -772,7 +1068,7 @@ namespace Data
                     isOpened = true;
 
                     SharedBinaryWriter::SPtr keyMemoryBufferSPtr = nullptr;
-                    NTSTATUS status = SharedBinaryWriter::Create(this->GetThisAllocator(), keyMemoryBufferSPtr);
+                    status = SharedBinaryWriter::Create(this->GetThisAllocator(), keyMemoryBufferSPtr);
                     Diagnostics::Validate(status);
 
                     SharedBinaryWriter::SPtr valueMemoryBufferSPtr = nullptr;
@@ -809,6 +1105,16 @@ namespace Data
                         auto valueToWriteSPtr = enumeratorSPtr->GetCurrent()->Value;
                         LONG64 timestampForValueToWrite = enumeratorSPtr->GetCurrent()->LogicalTimeStamp;
 
+                        // The smallest remaining key belongs to the next range, so this range is done.
+                        if (hasUpperBound && keyComparerSPtr->Compare(keyToWrite, (*splitKeysSPtr)[rangeIndex]) >= 0)
+                        {
+                            break;
+                        }
+
+                        containingFileIds.Clear();
+                        status = containingFileIds.Append(valueToWriteSPtr->GetFileId());
+                        STORE_ASSERT(NT_SUCCESS(status), "unable to append file id to containing file ids");
+
                         // Ignore all duplicate keys with smaller LSNs
                         while (true)
                         {
@@ -832,6 +1138,9 @@ namespace Data
                             STORE_ASSERT(popped, "priority queue should not be empty");
                             STORE_ASSERT(poppedEnumerator != nullptr, "popped enumerator should not be null");
 
+                            status = containingFileIds.Append(poppedEnumerator->GetCurrent()->Value->GetFileId());
+                            STORE_ASSERT(NT_SUCCESS(status), "unable to append file id to containing file ids");
+
                             // Verify the item being skipped has an earlier LSN than the one being returned.
                             auto skipLsn = poppedEnumerator->GetCurrent()->Value->GetVersionSequenceNumber();
                             STORE_ASSERT(skipLsn <= valueToWriteSPtr->GetVersionSequenceNumber(), "Enumeration is returning a key with an earlier LSN. skipLsn={1} lsn={2}", skipLsn, valueToWriteSPtr->GetVersionSequenceNumber());
@@ -847,6 +1156,28 @@ namespace Data
                             }
                         }
 
+                        ULONG64 keyHash = 0;
+                        if (useBloomFilters)
+                        {
+                            keyHash = GetKeyHash(keyToWrite, keyWriter);
+
+                            // Every merged file that did not yield this key is known not to contain it,
+                            // so a positive answer from its filter is a false positive.
+                            for (ULONG32 i = 0; i < bloomFilterMergeFiles.Count(); i++)
+                            {
+                                if (ListContainsId(containingFileIds, bloomFilterMergeFiles[i]->FileId))
+                                {
+                                    continue;
+                                }
+
+                                bloomFilterAbsentKeyProbes++;
+                                if (bloomFilterMergeFiles[i]->CheckpointFileSPtr->MayContainKey(keyHash))
+                                {
+                                    bloomFilterFalsePositives++;
+                                }
+                            }
+                        }
+
                         auto latestValueSPtr = newConsolidatedStateSPtr->Read(keyToWrite);
                         bool shouldKeyBeWritten = false;
                         bool shouldWriteSerializedValue = false;
@@ -873,6 +1204,13 @@ namespace Data
                                     // If fileid is part of the merge list, then skip writing the delete key onto the merged file
                                     if (!ListContainsId(*listOfFileIdsSPtr, fMetadataSPtr->FileId))
                                     {
+                                        // A bloom filter miss proves the older file does not hold the key, so there is nothing for the delete to shadow.
+                                        CheckpointFile::SPtr olderCheckpointFileSPtr = fMetadataSPtr->CheckpointFileSPtr;
+                                        if (useBloomFilters && olderCheckpointFileSPtr != nullptr && !olderCheckpointFileSPtr->MayContainKey(keyHash))
+                                        {
+                                            continue;
+                                        }
+
                                         // If there is any file with a logical time stamp lesser than the time stamp of the delete record 
                                         // and it is not part of the merge list, it should be written
                                         shouldKeyBeWritten = true;
@@ -960,6 +1298,12 @@ namespace Data
                         }
                     }
 
+                    if (perfCounters != nullptr && bloomFilterAbsentKeyProbes > 0)
+                    {
+                        perfCounters->BloomFilterFalsePositiveRate.IncrementBy(bloomFilterFalsePositives);
+                        perfCounters->BloomFilterFalsePositiveRateBase.IncrementBy(bloomFilterAbsentKeyProbes);
+                    }
+
                     if (!fileIsEmpty)
                     {
                        auto fullFileNameSPtr = CombinePaths(*consolidationProviderSPtr_->WorkingDirectoryCSPtr, *fileNameSPtr, L"");
@@ -996,35 +1340,16 @@ namespace Data
                        ULONG64 writeBytes = co_await checkpointFileSPtr->GetTotalFileSizeAsync(this->GetThisAllocator());
                        ULONG64 writeBytesPerSecond = checkpointPerfCounterWriter.UpdatePerformanceCounter(writeBytes);
 
+                       consolidationProviderSPtr_->MergeHelperSPtr->OnMergeFileWritten(writeBytes);
+                       if (perfCounters != nullptr)
+                       {
+                           perfCounters->WriteAmplification.IncrementBy(writeBytes);
+                       }
+
                        StoreEventSource::Events->CheckpointFileWriteBytesPerSec(
                            traceComponent_->PartitionId, traceComponent_->TraceTag,
                            writeBytesPerSecond);
                     }
-
-                    KSharedArray<ULONG32>::SPtr deletedFileIds = _new(CONSOLIDATIONMANAGER_TAG, this->GetThisAllocator()) KSharedArray<ULONG32>();
-                    Diagnostics::Validate(deletedFileIds);
-                    for (ULONG32 i = 0; i < listOfFileIdsSPtr->Count(); i++)
-                    {
-                        status = deletedFileIds->Append((*listOfFileIdsSPtr)[i]);
-                        STORE_ASSERT(NT_SUCCESS(status), "unable to append file id to deleted file ids list");
-                    }
-
-                    if (mergedFileMetadataSPtr != nullptr)
-                    {
-                        status = PostMergeMetadataTableInformation::Create(*deletedFileIds, mergedFileMetadataSPtr, this->GetThisAllocator(), mergeMetadataTableInformationSPtr);
-                        Diagnostics::Validate(status);
-
-                        MetadataTable::SPtr mergedMetadataTableSPtr;
-                        MetadataTable::Create(this->GetThisAllocator(), mergedMetadataTableSPtr);
-                        mergedMetadataTableSPtr->Table->Add(mergedFileMetadataSPtr->FileId, mergedFileMetadataSPtr);
-                        consolidationProviderSPtr_->MergeMetadataTableSPtr = mergedMetadataTableSPtr;
-                    }
-                    else
-                    {
-                        // there could be deleted filed ids w/o a new merged file depending on invalid entries
-                        status = PostMergeMetadataTableInformation::Create(*deletedFileIds, nullptr, this->GetThisAllocator(), mergeMetadataTableInformationSPtr);
-                        Diagnostics::Validate(status);
-                    }
                 }
                 catch (ktl::Exception const & e)
                 {
@@ -1061,12 +1386,7 @@ namespace Data
                     throw exec;
                 }
 
-                STORE_ASSERT(mergeMetadataTableInformationSPtr != nullptr, "mergeMetadataTableInformationSPtr != nullptr");
-                STORE_ASSERT(mergeMetadataTableInformationSPtr->DeletedFileIdsSPtr != nullptr, "mergeMetadataTableInformationSPtr->DeletedFileIdsSPtr != nullptr");
-
-                StoreEventSource::Events->ConsolidationManagerMergeAsync(traceComponent_->PartitionId, traceComponent_->TraceTag, L"completed");
-
-                co_return mergeMetadataTableInformationSPtr;
+                co_return mergedFileMetadataSPtr;
             }
 
            void MovePreviousVersionItemsToSnapshotContainerIfNeeded(__in ULONG32 highestIndex, __in MetadataTable& metadataTable)
@@ -1180,6 +1500,7 @@ namespace Data
 
                keyFileSPtr = co_await KeyCheckpointFile::CreateAsync(*traceComponent_, *keyFileNameSPtr, consolidationProviderSPtr_->IsValueAReferenceType, fileId, this->GetThisAllocator());
                valueFileSPtr = co_await ValueCheckpointFile::CreateAsync(*traceComponent_, *valueFileNameSPtr, fileId, this->GetThisAllocator());
+               valueFileSPtr->SetCompressionCodec(consolidationProviderSPtr_->ValueCompressionCodec);
 
                co_return fileId;
            }
@@ -1201,7 +1522,25 @@ namespace Data
                return filePathSPtr;
            }
 
-           bool ListContainsId(__in KSharedArray<ULONG32> & list, __in ULONG32 item)
+           //
+           // Hash of the serialized key, matching the hashes recorded in key checkpoint file bloom filters.
+           //
+           ULONG64 GetKeyHash(
+               __in TKey & key,
+               __in BinaryWriter & writer)
+           {
+               writer.Position = 0;
+               consolidationProviderSPtr_->KeyConverterSPtr->Write(key, writer);
+               if (writer.Position == 0)
+               {
+                   return BloomFilter::GetKeyHash(nullptr, 0);
+               }
+
+               KBuffer::SPtr keyBytesSPtr = writer.GetBuffer(0);
+               return BloomFilter::GetKeyHash(static_cast<byte const *>(keyBytesSPtr->GetBuffer()), writer.Position);
+           }
+
+           bool ListContainsId(__in KArray<ULONG32> const & list, __in ULONG32 item)
            {
                for (ULONG32 i = 0; i < list.Count(); i++)
                {
@@ -1230,6 +1569,11 @@ namespace Data
                __in IConsolidationProvider<TKey, TValue> & consolidationProvider, 
                __in StoreTraceComponent & traceComponent);
 
+            //
+            // A merge is only split into key ranges of at least this many keys of its largest file.
+            //
+            static const ULONG64 MinimumKeysPerMergeRange = 4096;
+
             KSharedPtr<IConsolidationProvider<TKey, TValue>> consolidationProviderSPtr_;
             ThreadSafeSPtrCache<AggregatedStoreComponent<TKey, TValue>> aggregatedStoreComponentSPtr_;
             KSharedPtr<AggregatedStoreComponent<TKey, TValue>> newAggregatedStoreComponentSPtr_;
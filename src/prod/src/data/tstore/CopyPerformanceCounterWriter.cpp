@@ -12,6 +12,7 @@ CopyPerformanceCounterWriter::CopyPerformanceCounterWriter(__in StorePerformance
     , totalDiskTransferBytes_(0)
     , totalDiskTransferTicks_(0)
     , deltaDiskTransferBytes_(0)
+    , deltaDiskTransferTicks_(0)
 {
 
 }
@@ -32,9 +33,22 @@ void CopyPerformanceCounterWriter::StopMeasurement(__in ULONG32 bytesTransferred
     }
 }
 
+void CopyPerformanceCounterWriter::AddMeasurement(
+    __in ULONG32 bytesTransferred,
+    __in ULONG64 ticks)
+{
+    deltaDiskTransferTicks_ += ticks;
+    deltaDiskTransferBytes_ += static_cast<ULONG64>(bytesTransferred);
+
+    if (deltaDiskTransferBytes_ >= DiskTransferBytesThreshold)
+    {
+        UpdatePerformanceCounter();
+    }
+}
+
 void CopyPerformanceCounterWriter::UpdatePerformanceCounter()
 {
-    auto deltaDiskTransferTicks = static_cast<ULONG64>(diskTransferWatch_.ElapsedTicks);
+    auto deltaDiskTransferTicks = deltaDiskTransferTicks_ + static_cast<ULONG64>(diskTransferWatch_.ElapsedTicks);
 
     if (this->IsEnabled() && deltaDiskTransferBytes_ > 0)
     {
@@ -45,6 +59,7 @@ void CopyPerformanceCounterWriter::UpdatePerformanceCounter()
     totalDiskTransferTicks_ += deltaDiskTransferTicks;
     diskTransferWatch_.Reset();
     deltaDiskTransferBytes_ = 0;
+    deltaDiskTransferTicks_ = 0;
 }
 
 ULONG64 CopyPerformanceCounterWriter::GetBytesPerSecond(__in ULONG64 bytes, __in ULONG64 ticks)
@@ -20,13 +20,18 @@ namespace Data
             {
                 return GetBytesPerSecond(
                     totalDiskTransferBytes_ + deltaDiskTransferBytes_,
-                    totalDiskTransferTicks_ + static_cast<ULONG64>(diskTransferWatch_.ElapsedTicks));
+                    totalDiskTransferTicks_ + deltaDiskTransferTicks_ + static_cast<ULONG64>(diskTransferWatch_.ElapsedTicks));
             }
 
             void StartMeasurement();
 
             void StopMeasurement(__in ULONG32 bytesTransferred = 0);
 
+            // Records a transfer that was timed by the caller, e.g. a read made ahead of the copy
+            void AddMeasurement(
+                __in ULONG32 bytesTransferred,
+                __in ULONG64 ticks);
+
             void UpdatePerformanceCounter();
 
         private:
@@ -36,6 +41,7 @@ namespace Data
             ULONG64 totalDiskTransferBytes_;
             ULONG64 totalDiskTransferTicks_;
             ULONG64 deltaDiskTransferBytes_;
+            ULONG64 deltaDiskTransferTicks_;
             Common::Stopwatch diskTransferWatch_;
         };
     }
@@ -92,6 +92,16 @@ namespace Data
                 throw ktl::Exception(SF_STATUS_INVALID_OPERATION); 
             }
 
+            virtual int GetOnDiskValueSize() const
+            {
+                return 0;
+            }
+
+            virtual void SetOnDiskValueSize(__in int)
+            {
+                throw ktl::Exception(SF_STATUS_INVALID_OPERATION); 
+            }
+
             virtual ULONG64 GetValueChecksum() const 
             {
                 throw ktl::Exception(SF_STATUS_INVALID_OPERATION);
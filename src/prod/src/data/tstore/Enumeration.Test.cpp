@@ -223,6 +223,8 @@ namespace TStoreTests
 
       Common::CommonConfig config; // load the config object as its needed for the tracing to work
 
+      ULONG32 keyFilterCallCount_ = 0;
+
 #pragma region test functions
     public:
         ktl::Awaitable<void> WriteSetStoreComponent_GetSortedKeyEnumerable_ShouldBeSorted_Test()
@@ -1679,6 +1681,84 @@ namespace TStoreTests
             co_return;
         }
 
+        bool IsEvenKey(__in KString::SPtr const & key)
+        {
+            keyFilterCallCount_++;
+
+            LPCWSTR keyString = *key;
+            WCHAR lastDigit = keyString[wcslen(keyString) - 1];
+            return (lastDigit - L'0') % 2 == 0;
+        }
+
+        ReadMode SelectReadMode(__in KString::SPtr const & key)
+        {
+            // Keys ending in 4 or 8 only need the key and version.
+            LPCWSTR keyString = *key;
+            WCHAR lastDigit = keyString[wcslen(keyString) - 1];
+            return (lastDigit == L'4' || lastDigit == L'8') ? ReadMode::Off : ReadMode::ReadValue;
+        }
+
+        ktl::Awaitable<void> Enumerate_ConsolidatedDifferentialKeyValues_WithKeyFilter_ShouldSucceed_Test()
+        {
+            {
+                auto txn = CreateWriteTransaction();
+                for (ULONG32 i = 1; i <= 9; i++)
+                {
+                    co_await Store->AddAsync(*txn->StoreTransactionSPtr, CreateString(i), CreateBuffer(i), DefaultTimeout, CancellationToken::None);
+                }
+                co_await txn->CommitAsync();
+            }
+
+            co_await CheckpointAsync();
+
+            {
+                auto txn = CreateWriteTransaction();
+                for (ULONG32 i = 10; i <= 12; i++)
+                {
+                    co_await Store->AddAsync(*txn->StoreTransactionSPtr, CreateString(i), CreateBuffer(i), DefaultTimeout, CancellationToken::None);
+                }
+                co_await txn->CommitAsync();
+            }
+
+            {
+                auto txn = CreateWriteTransaction();
+                txn->StoreTransactionSPtr->ReadIsolationLevel = StoreTransactionReadIsolationLevel::Enum::Snapshot;
+
+                IStore<KString::SPtr, KBuffer::SPtr>::KeyFilterFunctionType keyFilter(this, &EnumerationTest::IsEvenKey);
+                IStore<KString::SPtr, KBuffer::SPtr>::ValueReadModeFunctionType valueReadModeSelector(this, &EnumerationTest::SelectReadMode);
+
+                KString::SPtr firstKey = CreateString(2);
+                KString::SPtr lastKey;
+                keyFilterCallCount_ = 0;
+
+                auto enumerator = co_await Store->CreateEnumeratorAsync(*txn->StoreTransactionSPtr, firstKey, true, lastKey, false, keyFilter, valueReadModeSelector);
+
+                ULONG32 expectedKey = 2;
+                while (co_await enumerator->MoveNextAsync(CancellationToken::None))
+                {
+                    KeyValuePair<KString::SPtr, KeyValuePair<LONG64, KBuffer::SPtr>> current = enumerator->GetCurrent();
+                    CODING_ERROR_ASSERT(Store->KeyComparerSPtr->Compare(current.Key, CreateString(expectedKey)) == 0);
+
+                    if (SelectReadMode(current.Key) != ReadMode::Off)
+                    {
+                        KBuffer::SPtr currentValue = current.Value.Value;
+                        KBuffer::SPtr expectedValue = CreateBuffer(expectedKey);
+                        CODING_ERROR_ASSERT(SingleElementBufferEquals(currentValue, expectedValue));
+                    }
+
+                    expectedKey += 2;
+                }
+
+                CODING_ERROR_ASSERT(expectedKey == 14);
+
+                // Every key in the range is offered to the filter exactly once.
+                CODING_ERROR_ASSERT(keyFilterCallCount_ == 11);
+
+                co_await txn->AbortAsync();
+            }
+            co_return;
+        }
+
         ktl::Awaitable<void> Enumerate_SnapshotKeyValues_FromConsolidation_ShouldSucceed_Test()
         {
             {
@@ -4025,6 +4105,11 @@ namespace TStoreTests
         SyncAwait(Enumerate_ConsolidatedKeyValues_ShouldSucceed_Test());
     }
 
+    BOOST_AUTO_TEST_CASE(Enumerate_ConsolidatedDifferentialKeyValues_WithKeyFilter_ShouldSucceed)
+    {
+        SyncAwait(Enumerate_ConsolidatedDifferentialKeyValues_WithKeyFilter_ShouldSucceed_Test());
+    }
+
     BOOST_AUTO_TEST_CASE(Enumerate_SnapshotKeyValues_FromConsolidation_ShouldSucceed)
     {
         SyncAwait(Enumerate_SnapshotKeyValues_FromConsolidation_ShouldSucceed_Test());
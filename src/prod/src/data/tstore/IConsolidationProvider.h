@@ -64,6 +64,12 @@ namespace Data
             __declspec(property(get = get_EnableSweep)) bool EnableSweep;
             virtual bool get_EnableSweep() const = 0;
 
+            __declspec(property(get = get_ValueCompressionCodec)) CompressionCodecId::Enum ValueCompressionCodec;
+            virtual CompressionCodecId::Enum get_ValueCompressionCodec() const = 0;
+
+            __declspec(property(get = get_MergeDegreeOfParallelism)) ULONG32 MergeDegreeOfParallelism;
+            virtual ULONG32 get_MergeDegreeOfParallelism() const = 0;
+
             __declspec(property(get = get_MergeHelper)) MergeHelper::SPtr MergeHelperSPtr;
             virtual MergeHelper::SPtr get_MergeHelper() const = 0;
 
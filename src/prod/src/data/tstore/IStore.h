@@ -16,6 +16,16 @@ namespace Data
             
         public:
 
+            //
+            // Decides from the key alone whether an enumerated item is returned. Evaluated before the item is locked or its value is read.
+            //
+            typedef KDelegate<bool(TKey const & key)> KeyFilterFunctionType;
+
+            //
+            // Chooses how the value of an enumerated item is read. ReadMode::Off returns the key and version without touching the value.
+            //
+            typedef KDelegate<ReadMode(TKey const & key)> ValueReadModeFunctionType;
+
             virtual bool CreateOrFindTransaction(
                 __in TxnReplicator::TransactionBase& replicatorTransaction,
                 __out KSharedPtr<IStoreTransaction<TKey, TValue>>& result) = 0;
@@ -49,6 +59,18 @@ namespace Data
                 __out KeyValuePair<LONG64, TValue>& value,
                 __in ktl::CancellationToken const & cancellationToken) = 0;
 
+            //
+            // Reads a batch of keys. found and values are filled in the order of the keys; a key that is not found has found set to false.
+            // The result is the same as calling ConditionalGetAsync for each key in turn within the transaction.
+            //
+            virtual ktl::Awaitable<void> TryGetValuesAsync(
+                __in IStoreTransaction<TKey, TValue>& storeTransaction,
+                __in KSharedArray<TKey> const & keys,
+                __in Common::TimeSpan timeout, // If less than 0, then assumes infinite timeout
+                __out KSharedArray<bool>& found,
+                __out KSharedArray<KeyValuePair<LONG64, TValue>>& values,
+                __in ktl::CancellationToken const & cancellationToken) = 0;
+
             virtual ktl::Awaitable<bool> ContainsKeyAsync(
                 __in IStoreTransaction<TKey, TValue>& storeTransaction,
                 __in TKey key,
@@ -67,6 +89,15 @@ namespace Data
                 __in bool useLastKey,
                 __in ReadMode readMode=ReadMode::ReadValue) = 0;
 
+            virtual ktl::Awaitable<KSharedPtr<Utilities::IAsyncEnumerator<KeyValuePair<TKey, KeyValuePair<LONG64, TValue>>>>> CreateEnumeratorAsync(
+                __in IStoreTransaction<TKey, TValue> & storeTransaction,
+                __in TKey firstKey,
+                __in bool useFirstKey,
+                __in TKey lastKey,
+                __in bool useLastKey,
+                __in KeyFilterFunctionType keyFilter,
+                __in ValueReadModeFunctionType valueReadModeSelector) = 0;
+
             virtual ktl::Awaitable<KSharedPtr<Data::IEnumerator<TKey>>> CreateKeyEnumeratorAsync(
                 __in IStoreTransaction<TKey, TValue> & storeTransaction) = 0;
 
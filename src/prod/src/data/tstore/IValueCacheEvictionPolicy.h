@@ -0,0 +1,58 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace TStore
+    {
+        namespace ValueCacheEvictionPolicyKind
+        {
+            enum Enum : ULONG32
+            {
+                SegmentedLru = 0,
+                Clock = 1
+            };
+        }
+
+        //
+        // Decides which entry of a ValueCache shard is evicted next.
+        // The shard calls the policy under its lock, so implementations do not need to be thread safe.
+        // Policies keep their bookkeeping in the PolicyListEntry and PolicyState fields of the entry and must not hold references to it;
+        // the shard keeps every entry alive until after OnRemove.
+        //
+        interface IValueCacheEvictionPolicy
+        {
+            K_SHARED_INTERFACE(IValueCacheEvictionPolicy)
+
+        public:
+
+            __declspec(property(get = get_Kind)) ValueCacheEvictionPolicyKind::Enum Kind;
+            virtual ValueCacheEvictionPolicyKind::Enum get_Kind() const = 0;
+
+            //
+            // Called once the entry has been added to the shard.
+            //
+            virtual void OnInsert(__in ValueCacheEntry & entry) = 0;
+
+            //
+            // Called when a lookup finds the entry.
+            //
+            virtual void OnHit(__in ValueCacheEntry & entry) = 0;
+
+            //
+            // Called before the entry leaves the shard, whether it was chosen by SelectVictim or not.
+            //
+            virtual void OnRemove(__in ValueCacheEntry & entry) = 0;
+
+            //
+            // Returns the entry that should be evicted next, or nullptr if the policy tracks no entries.
+            // The entry stays tracked until OnRemove is called for it.
+            //
+            virtual ValueCacheEntry * SelectVictim() = 0;
+        };
+    }
+}
@@ -19,12 +19,21 @@ KeyCheckpointFile::KeyCheckpointFile(
     __in StoreTraceComponent & component) : 
     isValueAReferenceType_(isValueAReferenceType),
     filenameSPtr_(&filename),
+    keyHashes_(GetThisAllocator()),
+    bloomFilterSPtr_(nullptr),
     fileSPtr_(&file),
     traceComponent_(&component)
 {
+    NTSTATUS status = keyHashes_.Status();
+    if (!NT_SUCCESS(status))
+    {
+        this->SetConstructorStatus(status);
+        return;
+    }
+
     StreamPool::StreamFactoryType fileStreamFactoryDelegate;
     fileStreamFactoryDelegate.Bind(this, &KeyCheckpointFile::CreateFileStreamAsync);
-    NTSTATUS status = StreamPool::Create(fileStreamFactoryDelegate, GetThisAllocator(), streamPool_);
+    status = StreamPool::Create(fileStreamFactoryDelegate, GetThisAllocator(), streamPool_);
     if (!NT_SUCCESS(status))
     {
         this->SetConstructorStatus(status);
@@ -49,6 +58,8 @@ KeyCheckpointFile::KeyCheckpointFile(
     __in StoreTraceComponent & traceComponent) : 
     isValueAReferenceType_(isValueAReferenceType),
     filenameSPtr_(&filename),
+    keyHashes_(GetThisAllocator()),
+    bloomFilterSPtr_(nullptr),
     fileSPtr_(&file),
     traceComponent_(&traceComponent)
 {
@@ -262,6 +273,9 @@ ktl::Awaitable<void> KeyCheckpointFile::FlushAsync(
     Diagnostics::Validate(status);
     propertiesSPtr_->KeysHandle = *keysHandleSPtr;
 
+    // Write the bloom filter block between the keys and the properties.
+    co_await WriteBloomFilterAsync(*fileStreamSPtr);
+
     // Write the Properties.
     BlockHandle::SPtr propertiesHandleSPtr = nullptr;
     FileBlock<KeyCheckpointFileProperties::SPtr>::SerializerFunc propfunc(propertiesSPtr_.RawPtr(), &KeyCheckpointFileProperties::Write);
@@ -304,6 +318,56 @@ ktl::Awaitable<void> KeyCheckpointFile::FlushMemoryBufferAsync(
 }
 
 
+void KeyCheckpointFile::AddKeyHash(
+    __in BinaryWriter& memoryBuffer,
+    __in ULONG keyPosition,
+    __in ULONG keySize)
+{
+    ULONG64 keyHash = 0;
+    if (keySize == 0)
+    {
+        keyHash = BloomFilter::GetKeyHash(nullptr, 0);
+    }
+    else
+    {
+        KBuffer::SPtr keyBytesSPtr = memoryBuffer.GetBuffer(keyPosition, keySize);
+        keyHash = BloomFilter::GetKeyHash(static_cast<byte const *>(keyBytesSPtr->GetBuffer()), keySize);
+    }
+
+    NTSTATUS status = keyHashes_.Append(keyHash);
+    Diagnostics::Validate(status);
+}
+
+ktl::Awaitable<void> KeyCheckpointFile::WriteBloomFilterAsync(__in ktl::io::KFileStream& fileStream)
+{
+    ktl::io::KFileStream::SPtr fileStreamSPtr(&fileStream);
+
+    if (keyHashes_.Count() == 0)
+    {
+        co_return;
+    }
+
+    BloomFilter::SPtr bloomFilterSPtr = nullptr;
+    NTSTATUS status = BloomFilter::Create(keyHashes_.Count(), BloomFilter::DefaultBitsPerKey, GetThisAllocator(), bloomFilterSPtr);
+    Diagnostics::Validate(status);
+
+    for (ULONG32 i = 0; i < keyHashes_.Count(); i++)
+    {
+        bloomFilterSPtr->Add(keyHashes_[i]);
+    }
+
+    BlockHandle::SPtr bloomFilterHandleSPtr = nullptr;
+    FileBlock<BloomFilter::SPtr>::SerializerFunc bloomFilterFunc(bloomFilterSPtr.RawPtr(), &BloomFilter::Write);
+    status = co_await FileBlock<BloomFilter::SPtr>::WriteBlockAsync(*fileStreamSPtr, bloomFilterFunc, GetThisAllocator(), ktl::CancellationToken::None, bloomFilterHandleSPtr);
+    STORE_ASSERT(NT_SUCCESS(status), "Failed to write file block for key checkpoint file bloom filter. Status: {1}", status);
+
+    propertiesSPtr_->BloomFilterHandle = *bloomFilterHandleSPtr;
+    bloomFilterSPtr_ = bloomFilterSPtr;
+
+    // The hashes are no longer needed once the filter is built.
+    keyHashes_.Clear();
+}
+
 ktl::Awaitable<void> KeyCheckpointFile::ReadMetadataAsync()
 {
     ktl::io::KFileStream::SPtr filestreamSPtr= nullptr;
@@ -347,6 +411,20 @@ ktl::Awaitable<void> KeyCheckpointFile::ReadMetadataAsync()
             propFunc,
             GetThisAllocator(),
             ktl::CancellationToken::None);
+
+        // Files written before bloom filters were introduced do not have one.
+        BlockHandle::SPtr bloomFilterHandleSPtr = propertiesSPtr_->BloomFilterHandle;
+        if (bloomFilterHandleSPtr != nullptr)
+        {
+            FileBlock<BloomFilter::SPtr>::DeserializerFunc bloomFilterFunc(&BloomFilter::Read);
+
+            bloomFilterSPtr_ = co_await FileBlock<BloomFilter::SPtr>::ReadBlockAsync(
+                *filestreamSPtr,
+                *bloomFilterHandleSPtr,
+                bloomFilterFunc,
+                GetThisAllocator(),
+                ktl::CancellationToken::None);
+        }
     }
     catch (ktl::Exception const& e)
     {
@@ -110,6 +110,24 @@ namespace Data
                 return streamPool_;
             }
 
+            //
+            // Bloom filter over the keys in this file, or null if the file was written without one.
+            //
+            __declspec(property(get = get_BloomFilter)) BloomFilter::SPtr BloomFilterSPtr;
+            BloomFilter::SPtr get_BloomFilter() const
+            {
+                return bloomFilterSPtr_;
+            }
+
+            //
+            // Returns false only if the key with the given hash (see BloomFilter::GetKeyHash) is definitely not in this file.
+            // Files without a bloom filter may contain any key.
+            //
+            bool MayContainKey(__in ULONG64 keyHash) const
+            {
+                return bloomFilterSPtr_ == nullptr || bloomFilterSPtr_->MayContain(keyHash);
+            }
+
             //
             // Opens a KeyCheckpointFile from the given file.
             // The file to open that contains an existing checkpoint file.</param>
@@ -322,7 +340,7 @@ namespace Data
                     // Deleted items don't have a value.  We only serialize value properties for non-deleted items.
                     memoryBuffer.Write(item.Value->GetOffset()); // value offset
                     memoryBuffer.Write(item.Value->GetValueChecksum()); // value checksum
-                    memoryBuffer.Write(item.Value->GetValueSize()); // value size
+                    memoryBuffer.Write(item.Value->GetOnDiskValueSize()); // value size
                     ByteAlignedReaderWriterHelper::WritePaddingUntilAligned(memoryBuffer); // RESERVED
                 }
 
@@ -331,6 +349,8 @@ namespace Data
                 ULONG keyEndPosition = memoryBuffer.Position;
                 STORE_ASSERT(keyEndPosition >= keyPosition, "keyEndPosition={1} >= keyPosition={2}", keyEndPosition, keyPosition);
 
+                AddKeyHash(memoryBuffer, keyPosition, keyEndPosition - keyPosition);
+
                 memoryBuffer.Position = recordPosition;
                 memoryBuffer.Write(static_cast<ULONG32>(keyEndPosition - keyPosition));
                 memoryBuffer.Position = keyEndPosition;
@@ -342,6 +362,19 @@ namespace Data
                 propertiesSPtr_->KeyCount = propertiesSPtr_->KeyCount + 1;
             }
 
+            //
+            // Records the hash of a serialized key so that the bloom filter can be sized and built on flush.
+            //
+            void AddKeyHash(
+                __in BinaryWriter& memoryBuffer,
+                __in ULONG keyPosition,
+                __in ULONG keySize);
+
+            //
+            // Builds the bloom filter from the recorded key hashes and writes it as a checksummed block.
+            //
+            ktl::Awaitable<void> WriteBloomFilterAsync(__in ktl::io::KFileStream& fileStream);
+
             //
             // Deserializes the metadata (footer, properties, etc.) for this checkpoint file.
             //
@@ -363,6 +396,13 @@ namespace Data
 
             KeyCheckpointFileProperties::SPtr propertiesSPtr_;
 
+            //
+            // Hashes of the keys written so far. Only populated while the file is being written.
+            //
+            KArray<ULONG64> keyHashes_;
+
+            BloomFilter::SPtr bloomFilterSPtr_;
+
             KBlockFile::SPtr fileSPtr_;
 
             StreamPool::SPtr streamPool_;
@@ -69,11 +69,29 @@ namespace Data
 
             ktl::Awaitable<void> CloseAsync()
             {
+                // The chunk being read ahead still uses the file stream.
+                if (readAheadPending_)
+                {
+                    readAheadPending_ = false;
+
+                    try
+                    {
+                        co_await readAheadTask_;
+                    }
+                    catch (ktl::Exception const &)
+                    {
+                        // The chunk is no longer needed, so its failure does not matter.
+                    }
+                }
+
                 if (fileStreamSPtr_ != nullptr && fileStreamSPtr_->IsOpen())
                 {
                     co_await keyCheckpointFileSPtr_->StreamPoolSPtr->ReleaseStreamAsync(*fileStreamSPtr_);
                     fileStreamSPtr_ = nullptr;
                 }
+
+                // Unmaps the keys and returns their bytes to the budget.
+                mappedViewSPtr_ = nullptr;
             }
 
             void Dispose()
@@ -85,6 +103,30 @@ namespace Data
             {
             }
 
+            //
+            // Reads and parses the next chunk on the thread pool while the caller consumes the current one.
+            // Must be called before the first MoveNextAsync. At most one chunk is read ahead, so the memory used stays bounded.
+            //
+            void EnableReadAhead(__in ULONG32 readChunkSize)
+            {
+                STORE_ASSERT(stateZero_, "read ahead must be enabled before enumeration starts");
+                STORE_ASSERT(readChunkSize > 0, "readChunkSize={1} should be positive", readChunkSize);
+                STORE_ASSERT(readChunkSize % BlockAlignedWriter<TKey, TValue>::DefaultBlockAlignmentSize == 0, "readChunkSize={1} should be block aligned", readChunkSize);
+
+                readChunkSize_ = readChunkSize;
+                readAhead_ = true;
+            }
+
+            //
+            // Reads the keys from a mapping of the file instead of its stream pool, if the mapping fits in the given budget.
+            // Must be called before the first MoveNextAsync. The mapping is held until the enumerator is closed.
+            //
+            void EnableMappedReads(__in MappedFileBudget & budget)
+            {
+                STORE_ASSERT(stateZero_, "mapped reads must be enabled before enumeration starts");
+                mappedFileBudgetSPtr_ = &budget;
+            }
+
             //todo: fix the interface to change int to ULONG
             int Compare(__in KeyCheckpointFileAsyncEnumerator<TKey, TValue>& other) const
             {
@@ -155,10 +197,31 @@ namespace Data
                     // Assert file stream is null;
                     STORE_ASSERT(fileStreamSPtr_ == nullptr, "fileStreamSPtr_ == nullptr");
 
-                    fileStreamSPtr_ = co_await keyCheckpointFileSPtr_->StreamPoolSPtr->AcquireStreamAsync();
-                    STORE_ASSERT(fileStreamSPtr_ != nullptr, "fileStreamSPtr_ != nullptr");
+                    if (mappedFileBudgetSPtr_ != nullptr && endOffset_ > startOffset_)
+                    {
+                        // Any failure to map, including a full budget, falls back to the stream.
+                        status = MappedFileView::Create(
+                            *keyCheckpointFileSPtr_->FileName,
+                            endOffset_,
+                            true,
+                            *mappedFileBudgetSPtr_,
+                            this->GetThisAllocator(),
+                            mappedViewSPtr_);
+                        if (!NT_SUCCESS(status))
+                        {
+                            mappedViewSPtr_ = nullptr;
+                        }
+                    }
+
+                    if (mappedViewSPtr_ == nullptr)
+                    {
+                        fileStreamSPtr_ = co_await keyCheckpointFileSPtr_->StreamPoolSPtr->AcquireStreamAsync();
+                        STORE_ASSERT(fileStreamSPtr_ != nullptr, "fileStreamSPtr_ != nullptr");
+
+                        fileStreamSPtr_->Position = startOffset_;
+                    }
 
-                    fileStreamSPtr_->Position = startOffset_;
+                    position_ = startOffset_;
                     bool result = co_await ReadChunkAsync();
 
                     if (result)
@@ -168,7 +231,7 @@ namespace Data
                     }
                     else
                     {
-                        STORE_ASSERT(keyCount_ == keyCheckpointFileSPtr_->PropertiesSPtr->KeyCount, "Key Counts differ. actual={1} expected={2}", keyCount_, keyCheckpointFileSPtr_->PropertiesSPtr->KeyCount);
+                        AssertAllKeysRead();
                         co_return false;
                     }
                 }
@@ -193,7 +256,7 @@ namespace Data
                         }
                         else
                         {
-                            STORE_ASSERT(keyCount_ == keyCheckpointFileSPtr_->PropertiesSPtr->KeyCount, "Key counts differ. actual={1} expected={2}", keyCount_, keyCheckpointFileSPtr_->PropertiesSPtr->KeyCount);
+                            AssertAllKeysRead();
                             co_return false;
                         }
                     }
@@ -202,28 +265,88 @@ namespace Data
 
         private:
 
+            void AssertAllKeysRead()
+            {
+                // Enumerators started part way into the file, such as those of a key range merge, only see a suffix of the keys.
+                if (startOffset_ != keyCheckpointFileSPtr_->PropertiesSPtr->KeysHandle->Offset)
+                {
+                    return;
+                }
+
+                STORE_ASSERT(keyCount_ == keyCheckpointFileSPtr_->PropertiesSPtr->KeyCount, "Key counts differ. actual={1} expected={2}", keyCount_, keyCheckpointFileSPtr_->PropertiesSPtr->KeyCount);
+            }
+
             ktl::Awaitable<bool> ReadChunkAsync()
             {
-                itemsBufferSPtr_->Clear();
+                KSharedPtr<KSharedArray<KSharedPtr<KeyData<TKey, TValue>>>> itemsSPtr = nullptr;
+
+                if (readAhead_)
+                {
+                    if (!readAheadPending_)
+                    {
+                        readAheadTask_ = ReadAndParseChunkOnThreadPoolAsync();
+                    }
+
+                    readAheadPending_ = false;
+                    itemsSPtr = co_await readAheadTask_;
+
+                    // Start on the next chunk while the caller works through this one.
+                    if (itemsSPtr != nullptr)
+                    {
+                        readAheadTask_ = ReadAndParseChunkOnThreadPoolAsync();
+                        readAheadPending_ = true;
+                    }
+                }
+                else
+                {
+                    itemsSPtr = co_await ReadAndParseChunkAsync();
+                }
+
                 index_ = 0;
 
+                if (itemsSPtr == nullptr)
+                {
+                    itemsBufferSPtr_->Clear();
+                    co_return false;
+                }
+
+                itemsBufferSPtr_ = itemsSPtr;
+
+                // Track the number of keys returned.
+                keyCount_ += itemsBufferSPtr_->Count();
+                co_return true;
+            }
+
+            ktl::Awaitable<KSharedPtr<KSharedArray<KSharedPtr<KeyData<TKey, TValue>>>>> ReadAndParseChunkOnThreadPoolAsync()
+            {
+                KShared$ApiEntry();
+
+                co_await ktl::CorHelper::ThreadPoolThread(this->GetThisKtlSystem().DefaultThreadPool());
+                co_return co_await ReadAndParseChunkAsync();
+            }
+
+            //
+            // Returns the keys of the next chunk, or null once the end offset is reached.
+            // Only one call may be outstanding at a time since it reads through the shared file stream and memory buffer.
+            //
+            ktl::Awaitable<KSharedPtr<KSharedArray<KSharedPtr<KeyData<TKey, TValue>>>>> ReadAndParseChunkAsync()
+            {
                 // Pick a chunk size that is a multiple of 4k lesser than the end offset.
                 ULONG chunkSize = static_cast<ULONG>(GetChunkSize());
                 if (chunkSize == 0)
                 {
-                    co_return false;
+                    co_return nullptr;
                 }
 
+                KSharedPtr<KSharedArray<KSharedPtr<KeyData<TKey, TValue>>>> itemsSPtr = _new(KEYCHECKPOINTASYNCENUMERATOR_TAG, this->GetThisAllocator()) KSharedArray<KSharedPtr<KeyData<TKey, TValue>>>();
+                STORE_ASSERT(itemsSPtr != nullptr, "itemsSPtr should not be null");
+
                 // Read the entire chunk (plus the checksum and next chunk size) into memory.
                 NTSTATUS status = KBuffer::Create(chunkSize, memoryStreamSPtr_, this->GetThisAllocator());
                 Diagnostics::Validate(status);
 
                 ULONG startPosition = 0;
-                ULONG bytesRead = 0;
-    
-                status = co_await fileStreamSPtr_->ReadAsync(*memoryStreamSPtr_, bytesRead, startPosition, chunkSize);
-                STORE_ASSERT(NT_SUCCESS(status), "Failed to read from filestream. status={1}", status);
-                STORE_ASSERT(bytesRead == chunkSize, "bytesRead={1} != chunkSize={2}", bytesRead, chunkSize);
+                co_await ReadIntoMemoryStreamAsync(startPosition, chunkSize);
 
                 //need sharedreader because the while loop may adjust the br buffer which requires reader to be recreated.
                 KSharedPtr<SharedBinaryReader> brSPtr = nullptr;
@@ -245,10 +368,7 @@ namespace Data
                         STORE_ASSERT(remainder == 0, "remainder={1} should be 0", remainder);
 
                         memoryStreamSPtr_->SetSize(chunkSize + remainingBlockSize, true);
-                        bytesRead = 0;
-                        status = co_await fileStreamSPtr_->ReadAsync(*memoryStreamSPtr_, bytesRead, chunkSize, remainingBlockSize);
-                        STORE_ASSERT(NT_SUCCESS(status), "Failed to read from filestream. status={1}", status);
-                        STORE_ASSERT(bytesRead == remainingBlockSize, "bytesRead={1} != remainingBlockSize={2}", bytesRead, remainingBlockSize);
+                        co_await ReadIntoMemoryStreamAsync(chunkSize, remainingBlockSize);
                         chunkSize = chunkSize + remainingBlockSize;
 
                         //create the binary reader again to update its base stream and keep the current position.
@@ -263,7 +383,7 @@ namespace Data
 
                     for (ULONG i = 0; i < keysFromBlockSPtr->Count(); i++)
                     {
-                        itemsBufferSPtr_->Append((*keysFromBlockSPtr)[i]);
+                        itemsSPtr->Append((*keysFromBlockSPtr)[i]);
                     }
 
                     // Move the reader ahead to the next block, if possible, else reset and break.
@@ -275,11 +395,30 @@ namespace Data
                     }
                 }
 
-                // Track the number of keys returned.
-                keyCount_ += itemsBufferSPtr_->Count();
+                STORE_ASSERT(itemsSPtr->Count() > 0, "items buffer count={1} should be 0", itemsSPtr->Count());
+                co_return itemsSPtr;
+            }
 
-                STORE_ASSERT(itemsBufferSPtr_->Count() > 0, "items buffer count={1} should be 0", itemsBufferSPtr_->Count());
-                co_return true;
+            //
+            // Reads the next count bytes of the file into the memory stream at the given offset, from the mapping if there is one.
+            //
+            ktl::Awaitable<void> ReadIntoMemoryStreamAsync(
+                __in ULONG bufferOffset,
+                __in ULONG count)
+            {
+                if (mappedViewSPtr_ != nullptr)
+                {
+                    byte const * bytes = mappedViewSPtr_->GetBytes(position_, count);
+                    KMemCpySafe(static_cast<byte *>(memoryStreamSPtr_->GetBuffer()) + bufferOffset, count, bytes, count);
+                    position_ += count;
+                    co_return;
+                }
+
+                ULONG bytesRead = 0;
+                NTSTATUS status = co_await fileStreamSPtr_->ReadAsync(*memoryStreamSPtr_, bytesRead, bufferOffset, count);
+                STORE_ASSERT(NT_SUCCESS(status), "Failed to read from filestream. status={1}", status);
+                STORE_ASSERT(bytesRead == count, "bytesRead={1} != count={2}", bytesRead, count);
+                position_ += count;
             }
 
             KSharedPtr<KSharedArray<KSharedPtr<KeyData<TKey, TValue>>>> ReadBlock(
@@ -317,22 +456,22 @@ namespace Data
 
             ULONG64 GetChunkSize()
             {
-                // Get chunk size of 64k if available, else remaining size.
-                if (static_cast<ULONG64>(fileStreamSPtr_->Position) < endOffset_)
+                // Get chunk size of readChunkSize_ if available, else remaining size.
+                if (position_ < endOffset_)
                 {
-                    ULONG64 remainingSize = endOffset_ - fileStreamSPtr_->Position;
+                    ULONG64 remainingSize = endOffset_ - position_;
 
-                    if (remainingSize < ReadChunkSize)
+                    if (remainingSize < readChunkSize_)
                     {
                         return remainingSize;
                     }
                     else
                     {
-                        return ReadChunkSize;
+                        return readChunkSize_;
                     }
                 }
 
-                STORE_ASSERT(static_cast<ULONG64>(fileStreamSPtr_->Position) == endOffset_, "file stream position={1} != endOffset_={2}", static_cast<ULONG64>(fileStreamSPtr_->Position), endOffset_);
+                STORE_ASSERT(position_ == endOffset_, "read position={1} != endOffset_={2}", position_, endOffset_);
                 return 0;
             }
 
@@ -369,9 +508,20 @@ namespace Data
             KSharedPtr<KSharedArray<KSharedPtr<KeyData<TKey, TValue>>>> itemsBufferSPtr_;
             KSharedPtr<KBuffer> memoryStreamSPtr_;
             KSharedPtr<ktl::io::KFileStream> fileStreamSPtr_;
+            MappedFileBudget::SPtr mappedFileBudgetSPtr_;
+            MappedFileView::SPtr mappedViewSPtr_;
+
+            // Offset in the file of the next byte to read, through the mapping or the file stream.
+            ULONG64 position_;
+
             KSharedPtr<Data::StateManager::IStateSerializer<TKey>> keySerializerSPtr_;
             KSharedPtr<IComparer<TKey>> keyComparerSPtr_;
 
+            ULONG32 readChunkSize_;
+            bool readAhead_;
+            bool readAheadPending_;
+            ktl::Awaitable<KSharedPtr<KSharedArray<KSharedPtr<KeyData<TKey, TValue>>>>> readAheadTask_;
+
             StoreTraceComponent::SPtr traceComponent_;
 
         };
@@ -393,8 +543,14 @@ namespace Data
             stateZero_(true),
             itemsBufferSPtr_(nullptr),
             fileStreamSPtr_(nullptr),
+            mappedFileBudgetSPtr_(nullptr),
+            mappedViewSPtr_(nullptr),
+            position_(startOffset),
             keyComparerSPtr_(nullptr),
-            memoryStreamSPtr_(nullptr)
+            memoryStreamSPtr_(nullptr),
+            readChunkSize_(ReadChunkSize),
+            readAhead_(false),
+            readAheadPending_(false)
         {
         }
 
@@ -13,7 +13,8 @@ using namespace Data::Utilities;
 KeyCheckpointFileProperties::KeyCheckpointFileProperties()
     :keysHandleSPtr_(nullptr),
     keyCount_(0),
-    fileId_(0)
+    fileId_(0),
+    bloomFilterHandleSPtr_(nullptr)
 {
 }
 
@@ -66,6 +67,16 @@ void KeyCheckpointFileProperties::Write(__in BinaryWriter& writer)
     writer.Write(fileId_);
     ByteAlignedReaderWriterHelper::WritePaddingUntilAligned(writer);
 
+    // 'BloomFilterHandle' - BlockHandle
+    // Older readers skip unknown properties, so the filter does not change the file version.
+    if (bloomFilterHandleSPtr_ != nullptr)
+    {
+        writer.Write(static_cast<LONG32>(PropertyId::BloomFilterHandleProp));
+        VarInt::Write(writer, BlockHandle::SerializedSize());
+        ByteAlignedReaderWriterHelper::WritePaddingUntilAligned(writer);
+        bloomFilterHandleSPtr_->Write(writer);
+    }
+
     ByteAlignedReaderWriterHelper::AssertIfNotAligned(writer.Position);
 }
 
@@ -90,6 +101,10 @@ void KeyCheckpointFileProperties::ReadProperty(
         ByteAlignedReaderWriterHelper::ReadPaddingUntilAligned(reader);
         break;
 
+    case PropertyId::BloomFilterHandleProp:
+        bloomFilterHandleSPtr_ = BlockHandle::Read(reader, GetThisAllocator());
+        break;
+
     default:
         FilePropertySection::ReadProperty(reader, property, valueSize);
         break;
@@ -51,6 +51,18 @@ namespace Data
                 fileId_ = value;
             }
 
+            //
+            // Location of the key bloom filter block, or null if the file was written without one.
+            //
+            __declspec(property(get = get_BloomFilterHandle, put = set_BloomFilterHandle)) BlockHandle::SPtr BloomFilterHandle;
+            BlockHandle::SPtr get_BloomFilterHandle() const
+            {
+                return bloomFilterHandleSPtr_;
+            }
+            void set_BloomFilterHandle(__in BlockHandle& value)
+            {
+                bloomFilterHandleSPtr_ = &value;
+            }
 
             //
             // Serialize KeyCheckpointFileProperties into the given stream.
@@ -73,6 +85,12 @@ namespace Data
             // FileId          bytes       4
             // RESERVED                    4
             // 
+            // (Optional)
+            // BloomFilterHandle.PID  int  4
+            // SerializedSize  VarInt      1
+            // RESERVED                    3
+            // BloomFilterHandle bytes     16
+            // 
             void Write(__in BinaryWriter& writer) override;
 
             //
@@ -90,11 +108,13 @@ namespace Data
                 KeysHandleProp = 1,
                 KeyCountProp = 2,
                 FileIdProp = 3,
+                BloomFilterHandleProp = 4,
             };
 
             ULONG64 keyCount_;
             ULONG32 fileId_;
             BlockHandle::SPtr keysHandleSPtr_;
+            BlockHandle::SPtr bloomFilterHandleSPtr_;
 
         };
     }
@@ -0,0 +1,308 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+#define KEYRANGEPARTITIONER_TAG 'prRK'
+
+namespace Data
+{
+    namespace TStore
+    {
+        //
+        // Splits the key space of sorted key checkpoint files into ranges so that each range can be merged independently.
+        // Key blocks start on 4k boundaries with a KeyChunkMetadata header and end with a checksum over the block,
+        // so the first key of any block can be found with a handful of small reads instead of scanning the file.
+        //
+        template<typename TKey, typename TValue>
+        class KeyRangePartitioner :
+            public KObject<KeyRangePartitioner<TKey, TValue>>,
+            public KShared<KeyRangePartitioner<TKey, TValue>>
+        {
+            K_FORCE_SHARED(KeyRangePartitioner)
+
+        public:
+
+            static NTSTATUS Create(
+                __in Data::StateManager::IStateSerializer<TKey> & keySerializer,
+                __in IComparer<TKey> & keyComparer,
+                __in StoreTraceComponent & traceComponent,
+                __in KAllocator & allocator,
+                __out SPtr & result)
+            {
+                NTSTATUS status;
+
+                SPtr output = _new(KEYRANGEPARTITIONER_TAG, allocator) KeyRangePartitioner(keySerializer, keyComparer, traceComponent);
+
+                if (!output)
+                {
+                    return STATUS_INSUFFICIENT_RESOURCES;
+                }
+
+                status = output->Status();
+                if (!NT_SUCCESS(status))
+                {
+                    return status;
+                }
+
+                result = Ktl::Move(output);
+                return STATUS_SUCCESS;
+            }
+
+            //
+            // Returns at most rangeCount - 1 strictly ascending split keys, taken from the first keys of blocks evenly spaced through the file.
+            // Range i holds the keys in [split[i - 1], split[i]), with the first and last ranges unbounded below and above.
+            //
+            ktl::Awaitable<KSharedPtr<KSharedArray<TKey>>> GetSplitKeysAsync(
+                __in KeyCheckpointFile & keyCheckpointFile,
+                __in ULONG32 rangeCount)
+            {
+                KeyCheckpointFile::SPtr keyCheckpointFileSPtr = &keyCheckpointFile;
+
+                KSharedPtr<KSharedArray<TKey>> splitKeysSPtr = _new(KEYRANGEPARTITIONER_TAG, this->GetThisAllocator()) KSharedArray<TKey>();
+                Diagnostics::Validate(splitKeysSPtr);
+
+                ULONG64 keysStartOffset = keyCheckpointFileSPtr->PropertiesSPtr->KeysHandle->Offset;
+                ULONG64 keysEndOffset = keyCheckpointFileSPtr->PropertiesSPtr->KeysHandle->EndOffset();
+                ULONG64 pageCount = (keysEndOffset - keysStartOffset) / BlockSize;
+                if (rangeCount <= 1 || pageCount < rangeCount)
+                {
+                    co_return splitKeysSPtr;
+                }
+
+                ktl::io::KFileStream::SPtr fileStreamSPtr = nullptr;
+                SharedException::CSPtr exceptionCSPtr = nullptr;
+
+                try
+                {
+                    fileStreamSPtr = co_await keyCheckpointFileSPtr->StreamPoolSPtr->AcquireStreamAsync();
+
+                    for (ULONG32 i = 1; i < rangeCount; i++)
+                    {
+                        ULONG64 pageOffset = keysStartOffset + ((pageCount * i) / rangeCount) * BlockSize;
+                        ULONG64 blockOffset = 0;
+                        TKey firstKey = TKey();
+
+                        bool found = co_await TryReadNextBlockFirstKeyAsync(*keyCheckpointFileSPtr, *fileStreamSPtr, pageOffset, keysEndOffset, blockOffset, firstKey);
+                        if (!found)
+                        {
+                            break;
+                        }
+
+                        // Neighbouring probes can land on the same block.
+                        ULONG32 count = splitKeysSPtr->Count();
+                        if (count > 0 && keyComparerSPtr_->Compare(firstKey, (*splitKeysSPtr)[count - 1]) <= 0)
+                        {
+                            continue;
+                        }
+
+                        NTSTATUS status = splitKeysSPtr->Append(firstKey);
+                        Diagnostics::Validate(status);
+                    }
+                }
+                catch (ktl::Exception const & e)
+                {
+                    exceptionCSPtr = SharedException::Create(e, this->GetThisAllocator());
+                }
+
+                if (fileStreamSPtr != nullptr)
+                {
+                    co_await keyCheckpointFileSPtr->StreamPoolSPtr->ReleaseStreamAsync(*fileStreamSPtr);
+                }
+
+                if (exceptionCSPtr != nullptr)
+                {
+                    auto exec = exceptionCSPtr->Info;
+                    throw exec;
+                }
+
+                co_return splitKeysSPtr;
+            }
+
+            //
+            // Returns the offset of a block that starts before every key in the file that is greater than or equal to the given key.
+            // Enumerating from this offset yields at most one block worth of keys smaller than the given key.
+            //
+            ktl::Awaitable<ULONG64> FindStartOffsetAsync(
+                __in KeyCheckpointFile & keyCheckpointFile,
+                __in TKey key)
+            {
+                KeyCheckpointFile::SPtr keyCheckpointFileSPtr = &keyCheckpointFile;
+
+                ULONG64 keysStartOffset = keyCheckpointFileSPtr->PropertiesSPtr->KeysHandle->Offset;
+                ULONG64 keysEndOffset = keyCheckpointFileSPtr->PropertiesSPtr->KeysHandle->EndOffset();
+                STORE_ASSERT(keysStartOffset % BlockSize == 0, "keys start offset {1} should be block aligned", keysStartOffset);
+
+                // The first block always starts at the beginning of the keys.
+                ULONG64 startOffset = keysStartOffset;
+
+                ktl::io::KFileStream::SPtr fileStreamSPtr = nullptr;
+                SharedException::CSPtr exceptionCSPtr = nullptr;
+
+                try
+                {
+                    fileStreamSPtr = co_await keyCheckpointFileSPtr->StreamPoolSPtr->AcquireStreamAsync();
+
+                    // Binary search over pages for the last block whose first key is smaller than the given key.
+                    // A probe that lands inside a large block moves on to the next block start, so probes stay ordered by key.
+                    ULONG64 low = 0;
+                    ULONG64 high = (keysEndOffset - keysStartOffset) / BlockSize;
+                    while (low < high)
+                    {
+                        ULONG64 middle = low + (high - low) / 2;
+                        ULONG64 blockOffset = 0;
+                        TKey firstKey = TKey();
+
+                        bool found = co_await TryReadNextBlockFirstKeyAsync(
+                            *keyCheckpointFileSPtr,
+                            *fileStreamSPtr,
+                            keysStartOffset + middle * BlockSize,
+                            keysEndOffset,
+                            blockOffset,
+                            firstKey);
+
+                        if (found && keyComparerSPtr_->Compare(firstKey, key) < 0)
+                        {
+                            startOffset = blockOffset;
+                            low = (blockOffset - keysStartOffset) / BlockSize + 1;
+                        }
+                        else
+                        {
+                            high = middle;
+                        }
+                    }
+                }
+                catch (ktl::Exception const & e)
+                {
+                    exceptionCSPtr = SharedException::Create(e, this->GetThisAllocator());
+                }
+
+                if (fileStreamSPtr != nullptr)
+                {
+                    co_await keyCheckpointFileSPtr->StreamPoolSPtr->ReleaseStreamAsync(*fileStreamSPtr);
+                }
+
+                if (exceptionCSPtr != nullptr)
+                {
+                    auto exec = exceptionCSPtr->Info;
+                    throw exec;
+                }
+
+                co_return startOffset;
+            }
+
+        private:
+
+            //
+            // Finds the first valid block that starts at or after the given page and reads its first key.
+            // Pages inside a block larger than 4k hold key bytes rather than a header; they fail the size or checksum check and are skipped.
+            //
+            ktl::Awaitable<bool> TryReadNextBlockFirstKeyAsync(
+                __in KeyCheckpointFile & keyCheckpointFile,
+                __in ktl::io::KFileStream & fileStream,
+                __in ULONG64 pageOffset,
+                __in ULONG64 endOffset,
+                __out ULONG64 & blockOffset,
+                __out TKey & firstKey)
+            {
+                for (ULONG64 offset = pageOffset; offset < endOffset; offset += BlockSize)
+                {
+                    KBuffer::SPtr bufferSPtr = nullptr;
+                    NTSTATUS status = KBuffer::Create(BlockSize, bufferSPtr, this->GetThisAllocator());
+                    Diagnostics::Validate(status);
+
+                    ULONG bytesRead = 0;
+                    fileStream.Position = offset;
+                    status = co_await fileStream.ReadAsync(*bufferSPtr, bytesRead, 0, BlockSize);
+                    STORE_ASSERT(NT_SUCCESS(status), "Failed to read from filestream. status={1}", status);
+                    STORE_ASSERT(bytesRead == BlockSize, "bytesRead={1} != BlockSize={2}", bytesRead, BlockSize);
+
+                    ULONG32 blockSize = 0;
+                    {
+                        BinaryReader headerReader(*bufferSPtr, this->GetThisAllocator());
+                        KeyChunkMetadata blockMetadata = KeyChunkMetadata::Read(headerReader);
+                        blockSize = blockMetadata.BlockSize;
+                    }
+
+                    if (blockSize < KeyChunkMetadata::Size + sizeof(ULONG64) || blockSize > MaxProbeBlockSize)
+                    {
+                        continue;
+                    }
+
+                    ULONG32 alignedBlockSize = ((blockSize + BlockSize - 1) / BlockSize) * BlockSize;
+                    if (offset + alignedBlockSize > endOffset)
+                    {
+                        continue;
+                    }
+
+                    if (alignedBlockSize > BlockSize)
+                    {
+                        status = bufferSPtr->SetSize(alignedBlockSize, TRUE);
+                        Diagnostics::Validate(status);
+
+                        ULONG remainingBlockSize = alignedBlockSize - BlockSize;
+                        bytesRead = 0;
+                        status = co_await fileStream.ReadAsync(*bufferSPtr, bytesRead, BlockSize, remainingBlockSize);
+                        STORE_ASSERT(NT_SUCCESS(status), "Failed to read from filestream. status={1}", status);
+                        STORE_ASSERT(bytesRead == remainingBlockSize, "bytesRead={1} != remainingBlockSize={2}", bytesRead, remainingBlockSize);
+                    }
+
+                    BinaryReader reader(*bufferSPtr, this->GetThisAllocator());
+                    reader.Position = blockSize - sizeof(ULONG64);
+                    ULONG64 expectedChecksum = 0;
+                    reader.Read(expectedChecksum);
+
+                    ULONG64 actualChecksum = CRC64::ToCRC64(*bufferSPtr, 0, blockSize - sizeof(ULONG64));
+                    if (actualChecksum != expectedChecksum)
+                    {
+                        continue;
+                    }
+
+                    reader.Position = KeyChunkMetadata::Size;
+                    KSharedPtr<KeyData<TKey, TValue>> keyDataSPtr = keyCheckpointFile.ReadKey<TKey, TValue>(reader, *keySerializerSPtr_);
+
+                    blockOffset = offset;
+                    firstKey = keyDataSPtr->Key;
+                    co_return true;
+                }
+
+                co_return false;
+            }
+
+            KeyRangePartitioner(
+                __in Data::StateManager::IStateSerializer<TKey> & keySerializer,
+                __in IComparer<TKey> & keyComparer,
+                __in StoreTraceComponent & traceComponent);
+
+            static const ULONG32 BlockSize = BlockAlignedWriter<TKey, TValue>::DefaultBlockAlignmentSize;
+
+            //
+            // Blocks only grow past 4k to hold a large key. A probe skips anything bigger than this rather than
+            // reading a bogus size from the middle of such a block; skipping a real block only makes a range start earlier.
+            //
+            static const ULONG32 MaxProbeBlockSize = 64 * 1024;
+
+            KSharedPtr<Data::StateManager::IStateSerializer<TKey>> keySerializerSPtr_;
+            KSharedPtr<IComparer<TKey>> keyComparerSPtr_;
+            StoreTraceComponent::SPtr traceComponent_;
+        };
+
+        template<typename TKey, typename TValue>
+        KeyRangePartitioner<TKey, TValue>::KeyRangePartitioner(
+            __in Data::StateManager::IStateSerializer<TKey> & keySerializer,
+            __in IComparer<TKey> & keyComparer,
+            __in StoreTraceComponent & traceComponent)
+            : keySerializerSPtr_(&keySerializer),
+            keyComparerSPtr_(&keyComparer),
+            traceComponent_(&traceComponent)
+        {
+        }
+
+        template<typename TKey, typename TValue>
+        KeyRangePartitioner<TKey, TValue>::~KeyRangePartitioner()
+        {
+        }
+    }
+}
@@ -0,0 +1,133 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#define MAPPEDFILEBUDGET_TAG 'bfMS'
+
+using namespace Data::TStore;
+
+KSpinLock MappedFileBudget::processBudgetLock_;
+MappedFileBudget * MappedFileBudget::processBudget_ = nullptr;
+KWeakRef<MappedFileBudget>::SPtr MappedFileBudget::processBudgetWRef_ = nullptr;
+
+MappedFileBudget::MappedFileBudget(__in ULONG64 capacityInBytes)
+    : capacityInBytes_(capacityInBytes),
+    size_(0),
+    refusedCount_(0)
+{
+}
+
+MappedFileBudget::~MappedFileBudget()
+{
+    ASSERT_IFNOT(size_ == 0, "All mappings should be released before the budget is destructed. Size={0}", size_);
+
+    K_LOCK_BLOCK(processBudgetLock_)
+    {
+        if (processBudget_ == this)
+        {
+            processBudget_ = nullptr;
+            processBudgetWRef_ = nullptr;
+        }
+    }
+}
+
+NTSTATUS MappedFileBudget::Create(
+    __in ULONG64 capacityInBytes,
+    __in KAllocator & allocator,
+    __out MappedFileBudget::SPtr & result)
+{
+    if (capacityInBytes == 0 || capacityInBytes > MAXLONG64)
+    {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    result = _new(MAPPEDFILEBUDGET_TAG, allocator) MappedFileBudget(capacityInBytes);
+
+    if (!result)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    if (!NT_SUCCESS(result->Status()))
+    {
+        // Null Result while fetching failure status with no extra AddRefs or Releases
+        return (SPtr(Ktl::Move(result)))->Status();
+    }
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS MappedFileBudget::GetOrCreateProcessBudget(
+    __in ULONG64 capacityInBytes,
+    __in KAllocator & allocator,
+    __out MappedFileBudget::SPtr & result)
+{
+    // A budget is never released under the lock, since its destructor takes the lock.
+    result = nullptr;
+
+    K_LOCK_BLOCK(processBudgetLock_)
+    {
+        if (processBudgetWRef_ != nullptr)
+        {
+            result = processBudgetWRef_->TryGetTarget();
+        }
+    }
+
+    if (result != nullptr)
+    {
+        return STATUS_SUCCESS;
+    }
+
+    MappedFileBudget::SPtr budgetSPtr = nullptr;
+    NTSTATUS status = Create(capacityInBytes, allocator, budgetSPtr);
+    if (!NT_SUCCESS(status))
+    {
+        return status;
+    }
+
+    K_LOCK_BLOCK(processBudgetLock_)
+    {
+        // Another store may have created the budget meanwhile.
+        if (processBudgetWRef_ != nullptr)
+        {
+            result = processBudgetWRef_->TryGetTarget();
+        }
+
+        if (result == nullptr)
+        {
+            processBudget_ = budgetSPtr.RawPtr();
+            processBudgetWRef_ = budgetSPtr->GetWeakRef();
+            result = budgetSPtr;
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
+
+bool MappedFileBudget::TryCharge(__in ULONG64 sizeInBytes)
+{
+    while (true)
+    {
+        LONG64 currentSize = size_;
+        if (sizeInBytes > capacityInBytes_ - static_cast<ULONG64>(currentSize))
+        {
+            InterlockedIncrement64(&refusedCount_);
+            return false;
+        }
+
+        LONG64 newSize = currentSize + static_cast<LONG64>(sizeInBytes);
+        if (InterlockedCompareExchange64(&size_, newSize, currentSize) == currentSize)
+        {
+            return true;
+        }
+    }
+}
+
+void MappedFileBudget::Release(__in ULONG64 sizeInBytes)
+{
+    LONG64 newSize = InterlockedAdd64(&size_, -static_cast<LONG64>(sizeInBytes));
+    ASSERT_IFNOT(newSize >= 0, "Released more bytes than were charged. Size={0}", newSize);
+}
@@ -0,0 +1,83 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace TStore
+    {
+        //
+        // Process wide limit on the bytes of checkpoint files mapped into memory for reads, shared by any number of stores.
+        // A file whose mapping does not fit keeps being read through its stream pool.
+        //
+        class MappedFileBudget :
+            public KObject<MappedFileBudget>,
+            public KShared<MappedFileBudget>,
+            public KWeakRefType<MappedFileBudget>
+        {
+            K_FORCE_SHARED(MappedFileBudget)
+
+        public:
+
+            static NTSTATUS Create(
+                __in ULONG64 capacityInBytes,
+                __in KAllocator & allocator,
+                __out MappedFileBudget::SPtr & result);
+
+            //
+            // Returns the budget shared by every store in the process, creating it with the given capacity when no store or file holds it.
+            // A budget already in use keeps its capacity until it is released.
+            //
+            static NTSTATUS GetOrCreateProcessBudget(
+                __in ULONG64 capacityInBytes,
+                __in KAllocator & allocator,
+                __out MappedFileBudget::SPtr & result);
+
+            __declspec(property(get = get_CapacityInBytes)) ULONG64 CapacityInBytes;
+            ULONG64 get_CapacityInBytes() const
+            {
+                return capacityInBytes_;
+            }
+
+            //
+            // Bytes currently mapped against the budget.
+            //
+            __declspec(property(get = get_Size)) ULONG64 Size;
+            ULONG64 get_Size() const
+            {
+                return static_cast<ULONG64>(size_);
+            }
+
+            //
+            // Number of mappings refused because they did not fit.
+            //
+            __declspec(property(get = get_RefusedCount)) LONG64 RefusedCount;
+            LONG64 get_RefusedCount() const
+            {
+                return refusedCount_;
+            }
+
+            //
+            // Charges the given number of bytes if they fit in the remaining budget.
+            //
+            bool TryCharge(__in ULONG64 sizeInBytes);
+
+            void Release(__in ULONG64 sizeInBytes);
+
+        private:
+
+            MappedFileBudget(__in ULONG64 capacityInBytes);
+
+            static KSpinLock processBudgetLock_;
+            static MappedFileBudget * processBudget_;
+            static KWeakRef<MappedFileBudget>::SPtr processBudgetWRef_;
+
+            ULONG64 capacityInBytes_;
+            volatile LONG64 size_;
+            volatile LONG64 refusedCount_;
+        };
+    }
+}
@@ -0,0 +1,152 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#if defined(PLATFORM_UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define MAPPEDFILEVIEW_TAG 'vfMS'
+
+using namespace Data::TStore;
+
+MappedFileView::MappedFileView(
+    __in ULONG64 length,
+    __in MappedFileBudget & budget)
+    : budgetSPtr_(&budget),
+    length_(length),
+    chargedSize_(0),
+    baseAddress_(nullptr)
+{
+}
+
+MappedFileView::~MappedFileView()
+{
+#if defined(PLATFORM_UNIX)
+    if (baseAddress_ != nullptr)
+    {
+        munmap(baseAddress_, static_cast<size_t>(length_));
+        baseAddress_ = nullptr;
+    }
+#endif
+
+    if (chargedSize_ > 0)
+    {
+        budgetSPtr_->Release(chargedSize_);
+        chargedSize_ = 0;
+    }
+}
+
+NTSTATUS MappedFileView::Create(
+    __in KString const & filename,
+    __in ULONG64 length,
+    __in bool isSequentialAccess,
+    __in MappedFileBudget & budget,
+    __in KAllocator & allocator,
+    __out MappedFileView::SPtr & result)
+{
+#if defined(PLATFORM_UNIX)
+    if (length == 0)
+    {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    SPtr output = _new(MAPPEDFILEVIEW_TAG, allocator) MappedFileView(length, budget);
+
+    if (!output)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    NTSTATUS status = output->Status();
+    if (!NT_SUCCESS(status))
+    {
+        return status;
+    }
+
+    status = output->Map(filename, isSequentialAccess);
+    if (!NT_SUCCESS(status))
+    {
+        return status;
+    }
+
+    result = Ktl::Move(output);
+    return STATUS_SUCCESS;
+#else
+    UNREFERENCED_PARAMETER(filename);
+    UNREFERENCED_PARAMETER(length);
+    UNREFERENCED_PARAMETER(isSequentialAccess);
+    UNREFERENCED_PARAMETER(budget);
+    UNREFERENCED_PARAMETER(allocator);
+    UNREFERENCED_PARAMETER(result);
+    return STATUS_NOT_SUPPORTED;
+#endif
+}
+
+byte const * MappedFileView::GetBytes(
+    __in ULONG64 offset,
+    __in ULONG32 count) const
+{
+    if (offset > length_ || count > length_ - offset)
+    {
+        throw ktl::Exception(K_STATUS_OUT_OF_BOUNDS);
+    }
+
+    return baseAddress_ + offset;
+}
+
+NTSTATUS MappedFileView::Map(
+    __in KString const & filename,
+    __in bool isSequentialAccess)
+{
+#if defined(PLATFORM_UNIX)
+    // Charge before any system call so that a full budget costs nothing.
+    ULONG64 chargedSize = ((length_ + PageSize - 1) / PageSize) * PageSize;
+    if (!budgetSPtr_->TryCharge(chargedSize))
+    {
+        return STATUS_QUOTA_EXCEEDED;
+    }
+
+    chargedSize_ = chargedSize;
+
+    std::string path;
+    Common::StringUtility::Utf16ToUtf8(std::wstring(static_cast<LPCWSTR>(filename)), path);
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return STATUS_OBJECT_NAME_NOT_FOUND;
+    }
+
+    KFinally([&] { close(fd); });
+
+    // Never map past the end of the file; touching such a page raises SIGBUS instead of failing the read.
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || static_cast<ULONG64>(fileStat.st_size) < length_)
+    {
+        return STATUS_INTERNAL_DB_CORRUPTION;
+    }
+
+    void * address = mmap(nullptr, static_cast<size_t>(length_), PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    // Values are looked up by key, whereas keys are read start to end.
+    madvise(address, static_cast<size_t>(length_), isSequentialAccess ? MADV_SEQUENTIAL : MADV_RANDOM);
+
+    baseAddress_ = static_cast<byte *>(address);
+    return STATUS_SUCCESS;
+#else
+    UNREFERENCED_PARAMETER(filename);
+    UNREFERENCED_PARAMETER(isSequentialAccess);
+    return STATUS_NOT_SUPPORTED;
+#endif
+}
@@ -0,0 +1,71 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace TStore
+    {
+        //
+        // Read only mapping of the first Length bytes of an immutable checkpoint file.
+        // Readers hold a reference for as long as they use the bytes, so the file can be closed while reads are in flight;
+        // the mapping is removed and its bytes returned to the budget when the last reference goes away.
+        //
+        // Checkpoint files are never truncated or rewritten once flushed, which is what makes reading them through a mapping safe.
+        //
+        class MappedFileView :
+            public KObject<MappedFileView>,
+            public KShared<MappedFileView>
+        {
+            K_FORCE_SHARED(MappedFileView)
+
+        public:
+
+            //
+            // Maps the file, charging its length rounded up to whole pages against the budget.
+            // Returns STATUS_QUOTA_EXCEEDED if the mapping does not fit, and STATUS_NOT_SUPPORTED on platforms without mapped reads.
+            //
+            static NTSTATUS Create(
+                __in KString const & filename,
+                __in ULONG64 length,
+                __in bool isSequentialAccess,
+                __in MappedFileBudget & budget,
+                __in KAllocator & allocator,
+                __out MappedFileView::SPtr & result);
+
+            __declspec(property(get = get_Length)) ULONG64 Length;
+            ULONG64 get_Length() const
+            {
+                return length_;
+            }
+
+            //
+            // Returns the mapped bytes of the given range of the file without copying them.
+            // Throws K_STATUS_OUT_OF_BOUNDS if the range is not within the mapping.
+            //
+            byte const * GetBytes(
+                __in ULONG64 offset,
+                __in ULONG32 count) const;
+
+        private:
+
+            static const ULONG64 PageSize = 4 * 1024;
+
+            MappedFileView(
+                __in ULONG64 length,
+                __in MappedFileBudget & budget);
+
+            NTSTATUS Map(
+                __in KString const & filename,
+                __in bool isSequentialAccess);
+
+            MappedFileBudget::SPtr budgetSPtr_;
+            ULONG64 length_;
+            ULONG64 chargedSize_;
+            byte * baseAddress_;
+        };
+    }
+}
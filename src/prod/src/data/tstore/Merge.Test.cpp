@@ -657,6 +657,32 @@ namespace TStoreTests
             co_return;
         }
 
+        ktl::Awaitable<void> AddAndCheckpointAsync(__in ULONG32 seed, __in KBuffer::SPtr value)
+        {
+            {
+                auto txn = CreateWriteTransaction();
+                co_await Store->AddAsync(*txn->StoreTransactionSPtr, CreateString(seed), value, DefaultTimeout, CancellationToken::None);
+                co_await txn->CommitAsync();
+            }
+
+            co_await CheckpointAsync();
+        }
+
+        void SetupSizeTieredMerge()
+        {
+            SizeTieredMergeConfiguration::SPtr sizeTieredConfigSPtr = nullptr;
+            auto status = SizeTieredMergeConfiguration::Create(GetAllocator(), sizeTieredConfigSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            // Tiers line up with the file count policy's file types: under 1 MB, under 16 MB, ...
+            sizeTieredConfigSPtr->TierSizeMultiplier = 16;
+            sizeTieredConfigSPtr->MinFilesPerMerge = 3;
+
+            Store->MergeHelperSPtr->SizeTieredMergeConfigurationSPtr = *sizeTieredConfigSPtr;
+            Store->MergeHelperSPtr->CurrentMergePolicy = MergePolicy::SizeTiered;
+            Store->ConsolidationManagerSPtr->NumberOfDeltasToBeConsolidated = 1;
+        }
+
         bool IsMergePolicyEnabled(MergePolicy input, MergePolicy expected)
         {
             auto flagValue = static_cast<ULONG32>(input) & static_cast<ULONG32>(expected);
@@ -838,6 +864,105 @@ namespace TStoreTests
             co_return;
         }
 
+        ktl::Awaitable<void> VerifyParallelMergeKeysAsync(__in ULONG32 numKeys)
+        {
+            for (ULONG32 i = 0; i < numKeys; i++)
+            {
+                byte expectedFill = i % 6 == 0 ? 0xcc : (i % 3 == 0 ? 0xbb : 0xaa);
+                co_await VerifyKeyExistsAsync(CreateString(i), CreateBuffer(expectedFill));
+            }
+
+            co_return;
+        }
+
+        ktl::Awaitable<void> Merge2Files_ParallelKeyRanges_ShouldSucceed_Test()
+        {
+            auto fileNamesSPtr = CreateStringHashSet();
+            ULONG32 numKeys = 20000;
+
+            Store->MergeHelperSPtr->MergeFilesCountThreshold = 2;
+            Store->MergeHelperSPtr->NumberOfInvalidEntries = 1;
+            Store->ConsolidationManagerSPtr->NumberOfDeltasToBeConsolidated = 1;
+            Store->MergeDegreeOfParallelism = 4;
+
+            {
+                auto txn = CreateWriteTransaction();
+                for (ULONG32 i = 0; i < numKeys; i++)
+                {
+                    co_await Store->AddAsync(*txn->StoreTransactionSPtr, CreateString(i), CreateBuffer(0xaa), DefaultTimeout, CancellationToken::None);
+                }
+
+                co_await txn->CommitAsync();
+            }
+
+            co_await CheckpointAsync(*Store);
+            AddFileNames(*fileNamesSPtr);
+
+            {
+                auto txn = CreateWriteTransaction();
+                for (ULONG32 i = 0; i < numKeys; i += 3)
+                {
+                    co_await Store->ConditionalUpdateAsync(*txn->StoreTransactionSPtr, CreateString(i), CreateBuffer(0xbb), DefaultTimeout, CancellationToken::None);
+                }
+
+                co_await txn->CommitAsync();
+            }
+
+            co_await CheckpointAsync(*Store);
+            AddFileNames(*fileNamesSPtr);
+
+            // Invalidates entries of both earlier files, so they are merged together
+            {
+                auto txn = CreateWriteTransaction();
+                for (ULONG32 i = 0; i < numKeys; i += 6)
+                {
+                    co_await Store->ConditionalUpdateAsync(*txn->StoreTransactionSPtr, CreateString(i), CreateBuffer(0xcc), DefaultTimeout, CancellationToken::None);
+                }
+
+                co_await txn->CommitAsync();
+            }
+
+            co_await CheckpointAsync(*Store);
+
+            RemoveFileNames(*fileNamesSPtr);
+            VerifyInvalidFilesAreDeleted(*fileNamesSPtr);
+
+            // The two files are merged into one file per key range. The range files share one logical time stamp,
+            // so the table holds exactly two stamps: one for the new checkpoint file and one for all the range files.
+            LONG64 firstTimeStamp = -1;
+            LONG64 secondTimeStamp = -1;
+            ULONG32 firstCount = 0;
+            ULONG32 secondCount = 0;
+            auto enumeratorSPtr = Store->CurrentMetadataTableSPtr->Table->GetEnumerator();
+            while (enumeratorSPtr->MoveNext())
+            {
+                LONG64 timeStamp = enumeratorSPtr->Current().Value->LogicalTimeStamp;
+                if (firstCount == 0 || timeStamp == firstTimeStamp)
+                {
+                    firstTimeStamp = timeStamp;
+                    firstCount++;
+                }
+                else
+                {
+                    CODING_ERROR_ASSERT(secondCount == 0 || timeStamp == secondTimeStamp);
+                    secondTimeStamp = timeStamp;
+                    secondCount++;
+                }
+            }
+
+            ULONG32 checkpointFileCount = firstCount < secondCount ? firstCount : secondCount;
+            ULONG32 rangeFileCount = firstCount < secondCount ? secondCount : firstCount;
+            CODING_ERROR_ASSERT(checkpointFileCount == 1);
+            CODING_ERROR_ASSERT(rangeFileCount > 1);
+
+            co_await VerifyParallelMergeKeysAsync(numKeys);
+
+            co_await CloseAndReOpenStoreAsync();
+
+            co_await VerifyParallelMergeKeysAsync(numKeys);
+            co_return;
+        }
+
         ktl::Awaitable<void> Merge3Files_ToNewFile_WithRepeatingEntries_ShouldSucceed_Test()
         {
             auto fileNamesSPtr = CreateStringHashSet();
@@ -1232,6 +1357,112 @@ namespace TStoreTests
             co_return;
         }
 
+        ktl::Awaitable<void> Merge_WithDeletedKey_BloomFilterMiss_ShouldNotBeInMergedFile_Test()
+        {
+            // Set MergeFilesCountThreshold to 2
+            Store->MergeHelperSPtr->MergeFilesCountThreshold = 2;
+            Store->MergeHelperSPtr->NumberOfInvalidEntries = 2;
+            Store->ConsolidationManagerSPtr->NumberOfDeltasToBeConsolidated = 1;
+
+            auto key0 = CreateString(0);
+            auto key1 = CreateString(1);
+            auto key2 = CreateString(2);
+            auto key3 = CreateString(3);
+            auto key4 = CreateString(4);
+            auto key5 = CreateString(5);
+
+            auto value = CreateBuffer(0xad);
+            auto updateValue = CreateBuffer(0x45);
+
+            // Add key0, which is never updated so its file is not merged
+            {
+                auto txn = CreateWriteTransaction();
+                co_await Store->AddAsync(*txn->StoreTransactionSPtr, key0, value, DefaultTimeout, CancellationToken::None);
+                co_await txn->CommitAsync();
+            }
+
+            co_await CheckpointAsync();
+            CODING_ERROR_ASSERT(Store->CurrentMetadataTableSPtr->Table->Count == 1);
+
+            auto enumerator = Store->CurrentMetadataTableSPtr->Table->GetEnumerator();
+            CODING_ERROR_ASSERT(enumerator->MoveNext());
+            FileMetadata::SPtr olderFileMetadataSPtr = enumerator->Current().Value;
+
+            // The older file's bloom filter must rule key1 out for the delete to be dropped
+            BinaryWriter keyWriter(GetAllocator());
+            Store->KeyConverterSPtr->Write(key1, keyWriter);
+            KBuffer::SPtr keyBytesSPtr = keyWriter.GetBuffer(0);
+            ULONG64 key1Hash = BloomFilter::GetKeyHash(static_cast<byte const *>(keyBytesSPtr->GetBuffer()), keyWriter.Position);
+            CODING_ERROR_ASSERT(olderFileMetadataSPtr->CheckpointFileSPtr->HasBloomFilter);
+            CODING_ERROR_ASSERT(!olderFileMetadataSPtr->CheckpointFileSPtr->MayContainKey(key1Hash));
+
+            // Add key1, key2 and key3
+            {
+                auto txn = CreateWriteTransaction();
+                co_await Store->AddAsync(*txn->StoreTransactionSPtr, key1, value, DefaultTimeout, CancellationToken::None);
+                co_await Store->AddAsync(*txn->StoreTransactionSPtr, key2, value, DefaultTimeout, CancellationToken::None);
+                co_await Store->AddAsync(*txn->StoreTransactionSPtr, key3, value, DefaultTimeout, CancellationToken::None);
+                co_await txn->CommitAsync();
+            }
+
+            co_await CheckpointAsync();
+
+            // Delete key1 and add key4, key5
+            {
+                auto txn = CreateWriteTransaction();
+                bool removed = co_await Store->ConditionalRemoveAsync(*txn->StoreTransactionSPtr, key1, DefaultTimeout, CancellationToken::None);
+                CODING_ERROR_ASSERT(removed);
+                co_await Store->AddAsync(*txn->StoreTransactionSPtr, key4, value, DefaultTimeout, CancellationToken::None);
+                co_await Store->AddAsync(*txn->StoreTransactionSPtr, key5, value, DefaultTimeout, CancellationToken::None);
+                co_await txn->CommitAsync();
+            }
+
+            co_await CheckpointAsync();
+
+            // Update key2, key3, key4, and key5
+            {
+                auto txn = CreateWriteTransaction();
+                co_await Store->ConditionalUpdateAsync(*txn->StoreTransactionSPtr, key2, updateValue, DefaultTimeout, CancellationToken::None);
+                co_await Store->ConditionalUpdateAsync(*txn->StoreTransactionSPtr, key3, updateValue, DefaultTimeout, CancellationToken::None);
+                co_await Store->ConditionalUpdateAsync(*txn->StoreTransactionSPtr, key4, updateValue, DefaultTimeout, CancellationToken::None);
+                co_await Store->ConditionalUpdateAsync(*txn->StoreTransactionSPtr, key5, updateValue, DefaultTimeout, CancellationToken::None);
+                co_await txn->CommitAsync();
+            }
+
+            // Consolidate to merge the files holding key1 and its delete
+            co_await CheckpointAsync();
+
+            // Assert that the number of files is 3 (1 latest file, 1 merged file and the file containing key0)
+            CODING_ERROR_ASSERT(3 == Store->CurrentMetadataTableSPtr->Table->Count);
+            FileMetadata::SPtr unmergedFileMetadataSPtr = nullptr;
+            CODING_ERROR_ASSERT(Store->CurrentMetadataTableSPtr->Table->TryGetValue(olderFileMetadataSPtr->FileId, unmergedFileMetadataSPtr));
+
+            // Without the bloom filter the delete would be kept to shadow key1 in the unmerged older file
+            enumerator = Store->CurrentMetadataTableSPtr->Table->GetEnumerator();
+            while (enumerator->MoveNext())
+            {
+                auto keyEnumerator = enumerator->Current().Value->CheckpointFileSPtr->GetAsyncEnumerator<KString::SPtr, KBuffer::SPtr>(*Store->KeyConverterSPtr);
+                while (co_await keyEnumerator->MoveNextAsync(CancellationToken::None))
+                {
+                    CODING_ERROR_ASSERT(Store->KeyComparerSPtr->Compare(keyEnumerator->GetCurrent()->Key, key1) != 0);
+                }
+
+                co_await keyEnumerator->CloseAsync();
+            }
+
+            co_await VerifyKeyExistsAsync(key0, value);
+            co_await VerifyKeyDoesNotExistInStoresAsync(key1);
+            co_await VerifyKeyExistsAsync(key2, updateValue);
+
+            co_await CloseAndReOpenStoreAsync();
+            Store->ConsolidationManagerSPtr->NumberOfDeltasToBeConsolidated = 1;
+
+            co_await VerifyKeyExistsAsync(key0, value);
+            co_await VerifyKeyDoesNotExistInStoresAsync(key1);
+            co_await VerifyKeyExistsAsync(key2, updateValue);
+            co_return;
+        }
+
         ktl::Awaitable<void> Merge_WithDuplicateDeletedKeys_ShouldSucceed_Test()
         {
             // Set MergeFileCountThreshold to 2
@@ -1447,6 +1678,67 @@ namespace TStoreTests
             co_return;
         }
 
+        ktl::Awaitable<void> SizeTieredMerge_SmallestTierFull_MergesOnlyThatTier_Test()
+        {
+            Store->EnableBackgroundConsolidation = false;
+            SetupSizeTieredMerge();
+
+            auto verySmallBuffer = CreateBuffer(0xc2, FileCountMergeConfiguration::DefaultVerySmallFileSizeThreshold / 3);
+            auto smallBuffer = CreateBuffer(0xb6, FileCountMergeConfiguration::DefaultSmallFileSizeThreshold / 3);
+
+            // Tier 1: 1 file
+            co_await AddAndCheckpointAsync(1, smallBuffer);
+            CODING_ERROR_ASSERT(1 == Store->CurrentMetadataTableSPtr->Table->Count);
+            CODING_ERROR_ASSERT(Store->MergeHelperSPtr->BytesRewritten == 0);
+
+            // Tier 0: 2 files, Tier 1: 1 file
+            co_await AddAndCheckpointAsync(2, verySmallBuffer);
+            co_await AddAndCheckpointAsync(3, verySmallBuffer);
+            CODING_ERROR_ASSERT(3 == Store->CurrentMetadataTableSPtr->Table->Count);
+
+            // Tier 0 is full. Tier 1 would only hold two files after the merge, so it is left alone.
+            co_await AddAndCheckpointAsync(4, verySmallBuffer);
+            CODING_ERROR_ASSERT(2 == Store->CurrentMetadataTableSPtr->Table->Count);
+
+            CODING_ERROR_ASSERT(Store->MergeHelperSPtr->BytesIngested > 0);
+            CODING_ERROR_ASSERT(Store->MergeHelperSPtr->BytesRewritten > 0);
+            CODING_ERROR_ASSERT(Store->MergeHelperSPtr->BytesRewritten < Store->MergeHelperSPtr->BytesIngested);
+            CODING_ERROR_ASSERT(Store->MergeHelperSPtr->WriteAmplification > 1.0);
+
+            for (ULONG32 i = 1; i <= 4; i++)
+            {
+                co_await VerifyKeyExistsAsync(CreateString(i), i == 1 ? smallBuffer : verySmallBuffer);
+            }
+
+            co_return;
+        }
+
+        ktl::Awaitable<void> SizeTieredMerge_NextTierAboutToFill_MergesAdjacentTiers_Test()
+        {
+            Store->EnableBackgroundConsolidation = false;
+            SetupSizeTieredMerge();
+
+            auto verySmallBuffer = CreateBuffer(0xc2, FileCountMergeConfiguration::DefaultVerySmallFileSizeThreshold / 3);
+            auto smallBuffer = CreateBuffer(0xb6, FileCountMergeConfiguration::DefaultSmallFileSizeThreshold / 3);
+
+            // Tier 0: 2 files, Tier 1: 2 files
+            co_await AddAndCheckpointAsync(1, smallBuffer);
+            co_await AddAndCheckpointAsync(2, smallBuffer);
+            co_await AddAndCheckpointAsync(3, verySmallBuffer);
+            co_await AddAndCheckpointAsync(4, verySmallBuffer);
+            CODING_ERROR_ASSERT(4 == Store->CurrentMetadataTableSPtr->Table->Count);
+
+            // Tier 0 is full, and its merged file would fill tier 1, so both tiers are merged together.
+            co_await AddAndCheckpointAsync(5, verySmallBuffer);
+            CODING_ERROR_ASSERT(1 == Store->CurrentMetadataTableSPtr->Table->Count);
+
+            // Everything ingested has been rewritten exactly once.
+            CODING_ERROR_ASSERT(Store->MergeHelperSPtr->BytesRewritten > 0);
+            CODING_ERROR_ASSERT(Store->MergeHelperSPtr->WriteAmplification < 2.1);
+
+            co_return;
+        }
+
         ktl::Awaitable<void> FileCountMerge_NoOpCheckpoint_MergeStillRuns_MergePolicyFileCount_ShouldSucceed_Test()
         {
             Store->EnableBackgroundConsolidation = false;
@@ -2478,6 +2770,11 @@ namespace TStoreTests
         SyncAwait(Merge3Files_ToNewFile_ShouldSucceed_Test());
     }
 
+    BOOST_AUTO_TEST_CASE(Merge2Files_ParallelKeyRanges_ShouldSucceed)
+    {
+        SyncAwait(Merge2Files_ParallelKeyRanges_ShouldSucceed_Test());
+    }
+
     BOOST_AUTO_TEST_CASE(Merge3Files_ToNewFile_WithRepeatingEntries_ShouldSucceed)
     {
         SyncAwait(Merge3Files_ToNewFile_WithRepeatingEntries_ShouldSucceed_Test());
@@ -2498,6 +2795,11 @@ namespace TStoreTests
         SyncAwait(Merge_WithDeletedKey_ShouldBeInMergedFile_ShouldSucceed_Test());
     }
 
+    BOOST_AUTO_TEST_CASE(Merge_WithDeletedKey_BloomFilterMiss_ShouldNotBeInMergedFile)
+    {
+        SyncAwait(Merge_WithDeletedKey_BloomFilterMiss_ShouldNotBeInMergedFile_Test());
+    }
+
     BOOST_AUTO_TEST_CASE(Merge_WithDuplicateDeletedKeys_ShouldSucceed)
     {
         SyncAwait(Merge_WithDuplicateDeletedKeys_ShouldSucceed_Test());
@@ -2553,6 +2855,16 @@ namespace TStoreTests
         SyncAwait(FileCountMerge_Upgrade_MoreThanThresholdNumberOfFilesForOneFileType_MergeThreeAtATime_MergePolicyAll_ShouldSucceed_Test());
     }
 
+    BOOST_AUTO_TEST_CASE(SizeTieredMerge_SmallestTierFull_MergesOnlyThatTier)
+    {
+        SyncAwait(SizeTieredMerge_SmallestTierFull_MergesOnlyThatTier_Test());
+    }
+
+    BOOST_AUTO_TEST_CASE(SizeTieredMerge_NextTierAboutToFill_MergesAdjacentTiers)
+    {
+        SyncAwait(SizeTieredMerge_NextTierAboutToFill_MergesAdjacentTiers_Test());
+    }
+
     BOOST_AUTO_TEST_CASE(Merge_WithBackgroundConsolidation_ShouldSucceed)
     {
         SyncAwait(Merge_WithBackgroundConsolidation_ShouldSucceed_Test());
@@ -15,10 +15,15 @@ ULONG MyHashFunction(ULONG32& Val)
 
 MergeHelper::MergeHelper()
     : fileTypeToMergeList_(nullptr),
-    mergePolicy_(MergePolicy::All)
+    mergePolicy_(MergePolicy::All),
+    bytesIngested_(0),
+    bytesRewritten_(0)
 {
     NTSTATUS status = FileCountMergeConfiguration::Create(this->GetThisAllocator(), fileCountMergeConfigurationSPtr_);
     Diagnostics::Validate(status);
+
+    status = SizeTieredMergeConfiguration::Create(this->GetThisAllocator(), sizeTieredMergeConfigurationSPtr_);
+    Diagnostics::Validate(status);
     
     ULONG32Comparer::SPtr comparerSPtr;
     status = ULONG32Comparer::Create(this->GetThisAllocator(), comparerSPtr);
@@ -83,7 +88,16 @@ ktl::Awaitable<bool> MergeHelper::ShouldMerge(
         co_return false;
     }
 
-    if (IsMergePolicyEnabled(MergePolicy::FileCount))
+    if (IsMergePolicyEnabled(MergePolicy::SizeTiered))
+    {
+        bool hasVal = co_await ShouldMergeDueToSizeTieredPolicy(mergeTable, mergeList);
+
+        if (hasVal)
+        {
+            co_return true;
+        }
+    }
+    else if (IsMergePolicyEnabled(MergePolicy::FileCount))
     {
         bool hasVal = co_await ShouldMergeDueToFileCountPolicy(mergeTable, mergeList);
 
@@ -256,6 +270,111 @@ ktl::Awaitable<bool> MergeHelper::ShouldMergeDueToFileCountPolicy(
     co_return false;
 }
 
+ktl::Awaitable<bool> MergeHelper::ShouldMergeDueToSizeTieredPolicy(
+    __in MetadataTable& mergeTable,
+    __out KSharedArray<ULONG32>::SPtr& filesToBeMerged)
+{
+    ULONG32 minFilesPerMerge = sizeTieredMergeConfigurationSPtr_->MinFilesPerMerge;
+    ULONG32 maxFilesPerMerge = sizeTieredMergeConfigurationSPtr_->MaxFilesPerMerge;
+    if (mergeTable.Table->Count < minFilesPerMerge)
+    {
+        co_return false;
+    }
+
+    // Files ordered by tier, then oldest first.
+    KSharedArray<TieredFile>::SPtr tieredFiles = _new(MERGEHELPER_TAG, GetThisAllocator()) KSharedArray<TieredFile>();
+    ASSERT_IFNOT(tieredFiles != nullptr, "tiered file list should not be null");
+
+    auto enumeratorSPtr = mergeTable.Table->GetEnumerator();
+    while (enumeratorSPtr->MoveNext())
+    {
+        auto currentItem = enumeratorSPtr->Current();
+        FileMetadata::SPtr fileMetadataSPtr = currentItem.Value;
+
+        ULONG64 fileSize = co_await fileMetadataSPtr->GetFileSizeAsync();
+
+        TieredFile tieredFile;
+        tieredFile.FileId = currentItem.Key;
+        tieredFile.Tier = sizeTieredMergeConfigurationSPtr_->GetTier(fileSize);
+        tieredFile.LogicalTimeStamp = fileMetadataSPtr->LogicalTimeStamp;
+
+        ULONG32 position = tieredFiles->Count();
+        while (position > 0)
+        {
+            TieredFile & previous = (*tieredFiles)[position - 1];
+            if (previous.Tier < tieredFile.Tier ||
+                (previous.Tier == tieredFile.Tier && previous.LogicalTimeStamp <= tieredFile.LogicalTimeStamp))
+            {
+                break;
+            }
+
+            position--;
+        }
+
+        auto status = tieredFiles->InsertAt(position, tieredFile);
+        ASSERT_IFNOT(NT_SUCCESS(status), "Unable to insert file into tiered file list");
+    }
+
+    // Merge the smallest tier that is full. Smaller tiers fill up faster, and merging them first keeps every file
+    // from being rewritten more than once per tier it passes through.
+    ULONG32 tierStart = 0;
+    while (tierStart < tieredFiles->Count())
+    {
+        ULONG32 tier = (*tieredFiles)[tierStart].Tier;
+        ULONG32 tierEnd = tierStart;
+        while (tierEnd < tieredFiles->Count() && (*tieredFiles)[tierEnd].Tier == tier)
+        {
+            tierEnd++;
+        }
+
+        if (tierEnd - tierStart >= minFilesPerMerge)
+        {
+            // The merged file lands in the next tier, or further if the tier skipped one.
+            // When that next tier is one file short of being full, merging it now saves rewriting the new file again right away.
+            ULONG32 mergeEnd = tierEnd;
+            if (tierEnd < tieredFiles->Count() && (*tieredFiles)[tierEnd].Tier == tier + 1)
+            {
+                ULONG32 nextTierEnd = tierEnd;
+                while (nextTierEnd < tieredFiles->Count() && (*tieredFiles)[nextTierEnd].Tier == tier + 1)
+                {
+                    nextTierEnd++;
+                }
+
+                if (nextTierEnd - tierEnd + 1 >= minFilesPerMerge)
+                {
+                    mergeEnd = nextTierEnd;
+                }
+            }
+
+            KSharedArray<ULONG32>::SPtr fileIds = _new(MERGEHELPER_TAG, GetThisAllocator()) KSharedArray<ULONG32>();
+            ASSERT_IFNOT(fileIds != nullptr, "list should not be null");
+
+            for (ULONG32 i = tierStart; i < mergeEnd && fileIds->Count() < maxFilesPerMerge; i++)
+            {
+                auto status = fileIds->Append((*tieredFiles)[i].FileId);
+                ASSERT_IFNOT(NT_SUCCESS(status), "Unable to append file id to merge list");
+            }
+
+            filesToBeMerged = fileIds;
+            co_return true;
+        }
+
+        tierStart = tierEnd;
+    }
+
+    co_return false;
+}
+
+void MergeHelper::OnCheckpointFileWritten(__in ULONG64 fileSize)
+{
+    InterlockedAdd64(&bytesIngested_, static_cast<LONG64>(fileSize));
+}
+
+void MergeHelper::OnMergeFileWritten(__in ULONG64 fileSize)
+{
+    InterlockedAdd64(&bytesRewritten_, static_cast<LONG64>(fileSize));
+}
+
 ktl::Awaitable<bool> MergeHelper::ShouldMergeForSizeOnDiskPolicy(__in MetadataTable& mergeTable)
 {
     ULONG numberOfDeltaDifferentialStates = 3;
@@ -81,6 +81,55 @@ namespace Data
                 fileCountMergeConfigurationSPtr_ = &config;
             }
 
+            __declspec (property(get = get_SizeTieredMergeConfiguration, put = set_SizeTieredMergeConfiguration)) SizeTieredMergeConfiguration::SPtr SizeTieredMergeConfigurationSPtr;
+            SizeTieredMergeConfiguration::SPtr get_SizeTieredMergeConfiguration()
+            {
+                return sizeTieredMergeConfigurationSPtr_;
+            }
+
+            void set_SizeTieredMergeConfiguration(__in SizeTieredMergeConfiguration & config)
+            {
+                sizeTieredMergeConfigurationSPtr_ = &config;
+            }
+
+            //
+            // Bytes written to checkpoint files by checkpoints since the store was opened.
+            //
+            __declspec (property(get = get_BytesIngested)) ULONG64 BytesIngested;
+            ULONG64 get_BytesIngested() const
+            {
+                return static_cast<ULONG64>(bytesIngested_);
+            }
+
+            //
+            // Bytes written to checkpoint files by merges since the store was opened.
+            //
+            __declspec (property(get = get_BytesRewritten)) ULONG64 BytesRewritten;
+            ULONG64 get_BytesRewritten() const
+            {
+                return static_cast<ULONG64>(bytesRewritten_);
+            }
+
+            //
+            // Total bytes written to checkpoint files for every byte written by checkpoints.
+            // One means nothing has been merged; every merge adds the size of the files it wrote.
+            //
+            __declspec (property(get = get_WriteAmplification)) double WriteAmplification;
+            double get_WriteAmplification() const
+            {
+                ULONG64 bytesIngested = BytesIngested;
+                if (bytesIngested == 0)
+                {
+                    return 1.0;
+                }
+
+                return static_cast<double>(bytesIngested + BytesRewritten) / bytesIngested;
+            }
+
+            void OnCheckpointFileWritten(__in ULONG64 fileSize);
+
+            void OnMergeFileWritten(__in ULONG64 fileSize);
+
             // Default is zero.
             ULONG32 NumberOfInvalidEntries;
 
@@ -105,11 +154,22 @@ namespace Data
                 return ~key;
             }
 
+            struct TieredFile
+            {
+                ULONG32 FileId;
+                ULONG32 Tier;
+                LONG64 LogicalTimeStamp;
+            };
+
 
             ktl::Awaitable<bool> ShouldMergeDueToFileCountPolicy(
                 __in MetadataTable& mergeTable,
                 __out KSharedArray<ULONG32>::SPtr& filesToBeMerged);
 
+            ktl::Awaitable<bool> ShouldMergeDueToSizeTieredPolicy(
+                __in MetadataTable& mergeTable,
+                __out KSharedArray<ULONG32>::SPtr& filesToBeMerged);
+
             ktl::Awaitable<bool> ShouldMergeForSizeOnDiskPolicy(__in MetadataTable& mergeTable);
 
             bool IsFileQualifiedForInvalidEntriesMergePolicy(__in Data::KeyValuePair<ULONG32, FileMetadata::SPtr> item);
@@ -143,6 +203,14 @@ namespace Data
             // Gets or sets the file count merge configuration.  File count merge configruation.
             FileCountMergeConfiguration::SPtr fileCountMergeConfigurationSPtr_;
 
+            SizeTieredMergeConfiguration::SPtr sizeTieredMergeConfigurationSPtr_;
+
+            //
+            // Write amplification accounting. Merges of different key ranges report their files concurrently.
+            //
+            volatile LONG64 bytesIngested_;
+            volatile LONG64 bytesRewritten_;
+
             //
             // Invalid Entries Merge Policy Configuration
             //
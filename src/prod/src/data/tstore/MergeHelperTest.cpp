@@ -163,6 +163,43 @@ namespace TStoreTests
             CODING_ERROR_ASSERT((*mergeList)[0] == 1);
             co_return;
         }
+
+        ktl::Awaitable<void> SizeTieredConfiguration_GetTier_ShouldGrowByMultiplier_Test()
+        {
+            SizeTieredMergeConfiguration::SPtr configSPtr = nullptr;
+            auto status = SizeTieredMergeConfiguration::Create(GetAllocator(), configSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            ULONG64 baseSize = SizeTieredMergeConfiguration::DefaultBaseTierSizeThreshold;
+            ULONG64 multiplier = SizeTieredMergeConfiguration::DefaultTierSizeMultiplier;
+
+            CODING_ERROR_ASSERT(configSPtr->GetTier(0) == 0);
+            CODING_ERROR_ASSERT(configSPtr->GetTier(baseSize - 1) == 0);
+            CODING_ERROR_ASSERT(configSPtr->GetTier(baseSize) == 1);
+            CODING_ERROR_ASSERT(configSPtr->GetTier(baseSize * multiplier - 1) == 1);
+            CODING_ERROR_ASSERT(configSPtr->GetTier(baseSize * multiplier) == 2);
+            CODING_ERROR_ASSERT(configSPtr->GetTier(MAXULONG64) > 2);
+            co_return;
+        }
+
+        ktl::Awaitable<void> WriteAmplification_MergedBytes_ShouldBeRelativeToIngestedBytes_Test()
+        {
+            MergeHelper::SPtr mergeHelperSPtr = nullptr;
+            auto status = MergeHelper::Create(GetAllocator(), mergeHelperSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            CODING_ERROR_ASSERT(mergeHelperSPtr->WriteAmplification == 1.0);
+
+            mergeHelperSPtr->OnCheckpointFileWritten(100);
+            mergeHelperSPtr->OnCheckpointFileWritten(100);
+            CODING_ERROR_ASSERT(mergeHelperSPtr->WriteAmplification == 1.0);
+
+            mergeHelperSPtr->OnMergeFileWritten(150);
+            CODING_ERROR_ASSERT(mergeHelperSPtr->BytesIngested == 200);
+            CODING_ERROR_ASSERT(mergeHelperSPtr->BytesRewritten == 150);
+            CODING_ERROR_ASSERT(mergeHelperSPtr->WriteAmplification == 1.75);
+            co_return;
+        }
     #pragma endregion
     };
 
@@ -193,6 +230,16 @@ namespace TStoreTests
         SyncAwait(InvalidEntriesPolicy_MergeListExceedsMergeFilesCountThreshold_ShouldMerge_Test());
     }
     
+    BOOST_AUTO_TEST_CASE(SizeTieredConfiguration_GetTier_ShouldGrowByMultiplier)
+    {
+        SyncAwait(SizeTieredConfiguration_GetTier_ShouldGrowByMultiplier_Test());
+    }
+
+    BOOST_AUTO_TEST_CASE(WriteAmplification_MergedBytes_ShouldBeRelativeToIngestedBytes)
+    {
+        SyncAwait(WriteAmplification_MergedBytes_ShouldBeRelativeToIngestedBytes_Test());
+    }
+
     // This test requires additonal setup to work correctly
     //BOOST_AUTO_TEST_CASE(FileCountPolicy_OneFileTypeFileCountExceedsConfigThread_ShouldMerge)
     //{
@@ -28,8 +28,14 @@ namespace Data
             // all of them if there there is at least 1 invalid or deleted entry among them.
             SizeOnDisk = 1 << 3,
 
-            // Enables all merge policies.
-            All = INT_MAX
+            // Flag used to enable Size Tiered Merge Policy
+            // This policy groups files into tiers by size and merges the oldest files of a tier once it holds enough of them,
+            // together with the next tier when the merged file would fill it. It replaces the File Count Merge Policy when both are enabled.
+            SizeTiered = 1 << 4,
+
+            // Enables the invalid entries, deleted entries, file count and size on disk merge policies.
+            // Size tiered merge changes how files accumulate, so it is only enabled explicitly.
+            All = InvalidEntries | DeletedEntries | FileCount | SizeOnDisk
         };
     }
 }
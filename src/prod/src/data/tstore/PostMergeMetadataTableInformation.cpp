@@ -10,12 +10,12 @@ using namespace Data::TStore;
 
 NTSTATUS PostMergeMetadataTableInformation::Create(
     __in KSharedArray<ULONG32> & deletedFileIds,
-    __in FileMetadata::SPtr newMergedFileSPtr, // Can be null
+    __in KSharedArray<FileMetadata::SPtr> & newMergedFiles, // Can be empty
     __in KAllocator & allocator,
     __out SPtr & result)
 {
     NTSTATUS status;
-    SPtr output = _new(POSTMERGEMETADATAINFO_TAG, allocator) PostMergeMetadataTableInformation(deletedFileIds, newMergedFileSPtr);
+    SPtr output = _new(POSTMERGEMETADATAINFO_TAG, allocator) PostMergeMetadataTableInformation(deletedFileIds, newMergedFiles);
 
     if (!output)
     {
@@ -34,9 +34,9 @@ NTSTATUS PostMergeMetadataTableInformation::Create(
 
 PostMergeMetadataTableInformation::PostMergeMetadataTableInformation(
     __in KSharedArray<ULONG32> & deletedFileIds, 
-    __in FileMetadata::SPtr  newMergedFileSPtr) // Can be null
+    __in KSharedArray<FileMetadata::SPtr> & newMergedFiles) // Can be empty
     : deletedFileIdsSPtr_(&deletedFileIds),
-    newMergedFileSPtr_(newMergedFileSPtr)
+    newMergedFilesSPtr_(&newMergedFiles)
 {
 }
 
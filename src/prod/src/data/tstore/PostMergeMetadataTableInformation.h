@@ -20,7 +20,7 @@ namespace Data
         public:
             static NTSTATUS Create(
                 __in KSharedArray<ULONG32> & deletedFileIds,
-                __in FileMetadata::SPtr newMergedFileSPtr, // Can be null
+                __in KSharedArray<FileMetadata::SPtr> & newMergedFiles, // Can be empty
                 __in KAllocator & allocator,
                 __out SPtr & result);
 
@@ -30,17 +30,20 @@ namespace Data
                 return deletedFileIdsSPtr_;
             }
 
-            __declspec(property(get = get_NewMergedFile)) FileMetadata::SPtr NewMergedFileSPtr;
-            FileMetadata::SPtr get_NewMergedFile() const
+            //
+            // Files written by the merge, one per merged key range. Their key ranges do not overlap.
+            //
+            __declspec(property(get = get_NewMergedFiles)) KSharedArray<FileMetadata::SPtr>::SPtr NewMergedFilesSPtr;
+            KSharedArray<FileMetadata::SPtr>::SPtr get_NewMergedFiles() const
             {
-                return newMergedFileSPtr_;
+                return newMergedFilesSPtr_;
             }
 
         private:
-            PostMergeMetadataTableInformation(__in KSharedArray<ULONG32> & deletedFileIds, __in FileMetadata::SPtr  newMergedFileSPtr);
+            PostMergeMetadataTableInformation(__in KSharedArray<ULONG32> & deletedFileIds, __in KSharedArray<FileMetadata::SPtr> & newMergedFiles);
 
             KSharedArray<ULONG32>::SPtr deletedFileIdsSPtr_;
-            FileMetadata::SPtr newMergedFileSPtr_;
+            KSharedArray<FileMetadata::SPtr>::SPtr newMergedFilesSPtr_;
         };
     }
 }
@@ -0,0 +1,139 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#include <boost/test/unit_test.hpp>
+#include "Common/boost-taef.h"
+#include "TStoreTestBase.h"
+
+#define ALLOC_TAG 'rcPT'
+
+namespace TStoreTests
+{
+    using namespace ktl;
+    using namespace Data::Utilities;
+
+    class RecoveryPerfTest : public TStorePerfTestBase<KBuffer::SPtr, KBuffer::SPtr, KBufferComparer, KBufferSerializer, KBufferSerializer>
+    {
+    public:
+        typedef KeyValuePair<KBuffer::SPtr, KBuffer::SPtr> BufferPair;
+
+        RecoveryPerfTest()
+        {
+            Setup(1, KBufferComparer::Hash);
+        }
+
+        ~RecoveryPerfTest()
+        {
+            Cleanup();
+        }
+
+        //
+        // Measures how long it takes to reopen a store whose state is spread over the given number of checkpoint files.
+        // Values are not loaded, so the time is dominated by rebuilding the consolidated index from the key files.
+        //
+        void RecoveryOpenTimeTest(
+            __in ULONG32 totalKeys,
+            __in ULONG32 numFiles,
+            __in ULONG32 keySizeInBytes,
+            __in ULONG32 valueSizeInBytes,
+            __in ULONG32 numIterations)
+        {
+            TRACE_TEST();
+
+            CODING_ERROR_ASSERT(totalKeys % numFiles == 0);
+            ULONG32 keysPerFile = totalKeys / numFiles;
+
+            // Keep every checkpoint file around so recovery has to merge all of them.
+            Store->MergeHelperSPtr->CurrentMergePolicy = MergePolicy::None;
+
+            // Create items ahead of time
+            KSharedArray<BufferPair>::SPtr itemsSPtr = _new(ALLOC_TAG, GetAllocator()) KSharedArray<BufferPair>();
+            for (ULONG32 i = 0; i < totalKeys; i++)
+            {
+                auto key = CreateBuffer(keySizeInBytes, i);
+                auto value = CreateBuffer(valueSizeInBytes, i);
+                BufferPair pair(key, value);
+                itemsSPtr->Append(pair);
+            }
+
+            ULONG32 offset = 0;
+            for (ULONG32 i = 0; i < numFiles; i++)
+            {
+                SyncAwait(AddKeysAsync(*itemsSPtr, offset, keysPerFile));
+                Checkpoint();
+                offset += keysPerFile;
+            }
+
+            CODING_ERROR_ASSERT(Store->Count == totalKeys);
+
+            Store->ShouldLoadValuesOnRecovery = false;
+
+            LONG64 totalRecoveryTime = 0;
+            LONG64 maxRecoveryTime = 0;
+            for (ULONG32 i = 0; i < numIterations; i++)
+            {
+                LONG64 recoveryTime = CloseAndReOpenStore();
+                CODING_ERROR_ASSERT(Store->Count == totalKeys);
+
+                totalRecoveryTime += recoveryTime;
+                if (recoveryTime > maxRecoveryTime)
+                {
+                    maxRecoveryTime = recoveryTime;
+                }
+            }
+
+            Trace.WriteInfo(
+                BoostTestTrace,
+                "RecoveryPerfTest: Total Keys: {0}; Files: {1}; Key Size: {2}; Value Size: {3}; Iterations: {4}; Average Open: {5} ms; Max Open: {6} ms",
+                totalKeys,
+                numFiles,
+                keySizeInBytes,
+                valueSizeInBytes,
+                numIterations,
+                totalRecoveryTime / numIterations,
+                maxRecoveryTime);
+        }
+
+        Common::CommonConfig config; // load the config object as it's needed for the tracing to work
+    };
+
+    BOOST_FIXTURE_TEST_SUITE(RecoveryPerfTestSuite, RecoveryPerfTest)
+
+    // Naming Convention: RecoveryPerfTest_{num keys}_{num files}_{key size}
+
+    BOOST_AUTO_TEST_CASE(RecoveryPerfTest_100K_1File_100bytes)
+    {
+        RecoveryOpenTimeTest(100000, 1, 100, 8, 3);
+    }
+
+    BOOST_AUTO_TEST_CASE(RecoveryPerfTest_100K_10Files_100bytes)
+    {
+        RecoveryOpenTimeTest(100000, 10, 100, 8, 3);
+    }
+
+    BOOST_AUTO_TEST_CASE(RecoveryPerfTest_100K_100Files_100bytes)
+    {
+        RecoveryOpenTimeTest(100000, 100, 100, 8, 3);
+    }
+
+    BOOST_AUTO_TEST_CASE(RecoveryPerfTest_1M_1File_100bytes, *boost::unit_test::label("perf-cit"))
+    {
+        RecoveryOpenTimeTest(1000000, 1, 100, 8, 3);
+    }
+
+    BOOST_AUTO_TEST_CASE(RecoveryPerfTest_1M_10Files_100bytes, *boost::unit_test::label("perf-cit"))
+    {
+        RecoveryOpenTimeTest(1000000, 10, 100, 8, 3);
+    }
+
+    BOOST_AUTO_TEST_CASE(RecoveryPerfTest_1M_100Files_100bytes, *boost::unit_test::label("perf-cit"))
+    {
+        RecoveryOpenTimeTest(1000000, 100, 100, 8, 3);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+}
@@ -55,6 +55,19 @@ namespace Data
                 return fileId_;
             }
 
+            //
+            // Budget for mapping the recovered checkpoint files into memory. Null reads them through their streams.
+            //
+            __declspec(property(get = get_MappedReadBudget, put = set_MappedReadBudget)) MappedFileBudget::SPtr MappedReadBudget;
+            MappedFileBudget::SPtr get_MappedReadBudget() const
+            {
+                return mappedFileBudgetSPtr_;
+            }
+            void set_MappedReadBudget(__in MappedFileBudget::SPtr budget)
+            {
+                mappedFileBudgetSPtr_ = budget;
+            }
+
             __declspec(property(get = get_TotalKeyCount)) LONG64 TotalKeyCount;
             LONG64 get_TotalKeyCount() const
             {
@@ -92,11 +105,16 @@ namespace Data
                   _new(RECOVERY_COMPONENT_TAG, this->GetThisAllocator()) KSharedArray<KSharedPtr<KeyCheckpointFileAsyncEnumerator<TKey, TValue>>>();
                keyCheckpointFileListSPtr->Reserve(table->Count);
 
+               KSharedArray<ktl::Awaitable<KSharedPtr<KeyCheckpointFileAsyncEnumerator<TKey, TValue>>>>::SPtr openTasksSPtr =
+                  _new(RECOVERY_COMPONENT_TAG, this->GetThisAllocator()) KSharedArray<ktl::Awaitable<KSharedPtr<KeyCheckpointFileAsyncEnumerator<TKey, TValue>>>>();
+               Diagnostics::Validate(openTasksSPtr);
+
                KSharedPtr<IEnumerator<KeyValuePair<ULONG32, FileMetadata::SPtr>>> enumeratorSPtr = table->GetEnumerator();
                SharedException::CSPtr exception = nullptr;
 
                try
                {
+                   // Checkpoint files are independent of each other, so open them and read their first chunk of keys concurrently.
                    while (enumeratorSPtr->MoveNext())
                    {
                        FileMetadata::SPtr fileMetadataSPtr = enumeratorSPtr->Current().Value;
@@ -121,18 +139,45 @@ namespace Data
                        result = checkpointFileName->Concat(*fileMetadataSPtr->FileName);
                        STORE_ASSERT(result, "Unable to concat path string");
 
-                       CheckpointFile::SPtr checkpointFileSPtr = co_await CheckpointFile::OpenAsync(*checkpointFileName, *traceComponent_, this->GetThisAllocator(), isValueReferenceType_);
-                       fileMetadataSPtr->CheckpointFileSPtr = *checkpointFileSPtr;
-                       keyCheckpointFileListSPtr->Append(fileMetadataSPtr->CheckpointFileSPtr->GetAsyncEnumerator<TKey, TValue>(*keySerializerSPtr_));
+                       status = openTasksSPtr->Append(OpenKeyCheckpointFileAsync(*fileMetadataSPtr, *checkpointFileName, cancellationToken));
+                       Diagnostics::Validate(status);
                    }
-
-                   co_await MergeAsync(keyCheckpointFileListSPtr, cancellationToken);
                }
                catch (ktl::Exception const& e)
                {
                    exception = SharedException::Create(e, this->GetThisAllocator());
                }
 
+               // Every started open must be awaited, even after a failure, so that its enumerator can be closed.
+               for (ULONG i = 0; i < openTasksSPtr->Count(); i++)
+               {
+                   try
+                   {
+                       KSharedPtr<KeyCheckpointFileAsyncEnumerator<TKey, TValue>> keyCheckpointEnumeratorSPtr = co_await (*openTasksSPtr)[i];
+                       auto status = keyCheckpointFileListSPtr->Append(keyCheckpointEnumeratorSPtr);
+                       Diagnostics::Validate(status);
+                   }
+                   catch (ktl::Exception const& e)
+                   {
+                       if (exception == nullptr)
+                       {
+                           exception = SharedException::Create(e, this->GetThisAllocator());
+                       }
+                   }
+               }
+
+               if (exception == nullptr)
+               {
+                   try
+                   {
+                       co_await MergeAsync(keyCheckpointFileListSPtr, cancellationToken);
+                   }
+                   catch (ktl::Exception const& e)
+                   {
+                       exception = SharedException::Create(e, this->GetThisAllocator());
+                   }
+               }
+
                if (exception != nullptr)
                {
                    for (ULONG i = 0; i < keyCheckpointFileListSPtr->Count(); i++)
@@ -159,6 +204,61 @@ namespace Data
                     STORE_ASSERT(comparison < 0, "previous item must be larger than current item");
                 }
             }
+
+            //
+            // Opens one checkpoint file on the thread pool and positions its key enumerator on the first key.
+            // Keys are read ahead in large chunks and parsed off the merge path, so the merge only pays for the comparisons.
+            //
+            ktl::Awaitable<KSharedPtr<KeyCheckpointFileAsyncEnumerator<TKey, TValue>>> OpenKeyCheckpointFileAsync(
+                __in FileMetadata & fileMetadata,
+                __in KString & checkpointFileName,
+                __in ktl::CancellationToken const cancellationToken)
+            {
+                KShared$ApiEntry();
+
+                FileMetadata::SPtr fileMetadataSPtr = &fileMetadata;
+                KString::SPtr checkpointFileNameSPtr = &checkpointFileName;
+
+                co_await ktl::CorHelper::ThreadPoolThread(this->GetThisKtlSystem().DefaultThreadPool());
+
+                CheckpointFile::SPtr checkpointFileSPtr = co_await CheckpointFile::OpenAsync(*checkpointFileNameSPtr, *traceComponent_, this->GetThisAllocator(), isValueReferenceType_);
+                fileMetadataSPtr->CheckpointFileSPtr = *checkpointFileSPtr;
+
+                KSharedPtr<KeyCheckpointFileAsyncEnumerator<TKey, TValue>> keyCheckpointEnumeratorSPtr = fileMetadataSPtr->CheckpointFileSPtr->GetAsyncEnumerator<TKey, TValue>(*keySerializerSPtr_);
+                keyCheckpointEnumeratorSPtr->KeyComparerSPtr = *comparerSPtr_;
+                keyCheckpointEnumeratorSPtr->EnableReadAhead(RecoveryReadChunkSize);
+
+                if (mappedFileBudgetSPtr_ != nullptr)
+                {
+                    // The keys are only mapped while they are merged; the values stay mapped for the reads that follow recovery.
+                    keyCheckpointEnumeratorSPtr->EnableMappedReads(*mappedFileBudgetSPtr_);
+                    checkpointFileSPtr->EnableMappedReads(*mappedFileBudgetSPtr_);
+                }
+
+                SharedException::CSPtr exception = nullptr;
+
+                try
+                {
+                    // Move the enumerator once to make it point at the first item
+                    co_await keyCheckpointEnumeratorSPtr->MoveNextAsync(cancellationToken);
+                }
+                catch (ktl::Exception const& e)
+                {
+                    exception = SharedException::Create(e, this->GetThisAllocator());
+                }
+
+                if (exception != nullptr)
+                {
+                    co_await keyCheckpointEnumeratorSPtr->CloseAsync();
+
+                    //clang compiler error, needs to assign before throw.
+                    auto ex = exception->Info;
+                    throw ex;
+                }
+
+                co_return keyCheckpointEnumeratorSPtr;
+            }
+
             ktl::Awaitable<void> MergeAsync(
                 __in KSharedPtr<KSharedArray<KSharedPtr<KeyCheckpointFileAsyncEnumerator<TKey, TValue>>>>& keyCheckpointFileListSPtr,
                 __in ktl::CancellationToken const & cancellationToken)
@@ -170,15 +270,14 @@ namespace Data
                 StoreEventSource::Events->RecoveryStoreComponentMergeKeyCheckpointFilesAsync(traceComponent_->PartitionId, traceComponent_->TraceTag, L"starting", -1);
                 LONG64 count = 0;
 
-                // Get Enumerators for each file from the MetadataTable
+                // Enumerators were already moved to their first item when their files were opened.
                 for (ULONG i = 0; i < keyCheckpointFileListSPtr->Count(); i++)
                 {
                     KSharedPtr<KeyCheckpointFileAsyncEnumerator<TKey, TValue>> keyCheckpointEnumeratorSPtr = (*keyCheckpointFileListSPtr)[i];
-                    
-                    keyCheckpointEnumeratorSPtr->KeyComparerSPtr = *comparerSPtr_;
-
-                    // Move the enumerator once to make it point at the first item
-                    co_await keyCheckpointEnumeratorSPtr->MoveNextAsync(cancellationToken);
+                    if (keyCheckpointEnumeratorSPtr->GetCurrent() == nullptr)
+                    {
+                        continue;
+                    }
 
                     priorityQueue.Push(keyCheckpointEnumeratorSPtr);
                 }
@@ -270,6 +369,11 @@ namespace Data
                 __in Data::StateManager::IStateSerializer<TKey>& keySerializer,
                 __in bool isValueReferenceType);
 
+            //
+            // Recovery reads every key of every file once, so it reads much larger chunks than the 32k used elsewhere.
+            //
+            static const ULONG32 RecoveryReadChunkSize = 1024 * 1024;
+
             ULONG32 fileId_;
             LONG64 logicalCheckpointFileTimeStamp_;
             bool isValueReferenceType_;
@@ -278,6 +382,7 @@ namespace Data
             KSharedPtr<Data::StateManager::IStateSerializer<TKey>> keySerializerSPtr_;
             KSharedPtr<KSharedArray<KeyValuePair<TKey, KSharedPtr<VersionedItem<TValue>>>>> componentSPtr_;
             KSharedPtr<IComparer<TKey>> comparerSPtr_;
+            MappedFileBudget::SPtr mappedFileBudgetSPtr_;
 
             LONG64 totalKeyCount_;
             LONG64 totalKeySize_;
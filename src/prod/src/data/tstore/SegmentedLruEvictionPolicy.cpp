@@ -0,0 +1,91 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#define SEGMENTEDLRU_TAG 'ulSS'
+
+using namespace Data::TStore;
+
+SegmentedLruEvictionPolicy::SegmentedLruEvictionPolicy(__in ULONG64 capacityInBytes)
+    : probationList_(ValueCacheEntry::PolicyListEntryOffset),
+    protectedList_(ValueCacheEntry::PolicyListEntryOffset),
+    protectedCapacity_(capacityInBytes / 100 * ProtectedPercentage),
+    protectedSize_(0)
+{
+}
+
+SegmentedLruEvictionPolicy::~SegmentedLruEvictionPolicy()
+{
+}
+
+NTSTATUS SegmentedLruEvictionPolicy::Create(
+    __in ULONG64 capacityInBytes,
+    __in KAllocator & allocator,
+    __out SegmentedLruEvictionPolicy::SPtr & result)
+{
+    result = _new(SEGMENTEDLRU_TAG, allocator) SegmentedLruEvictionPolicy(capacityInBytes);
+
+    if (!result)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+void SegmentedLruEvictionPolicy::OnInsert(__in ValueCacheEntry & entry)
+{
+    entry.PolicyState = Probation;
+    probationList_.AppendTail(&entry);
+}
+
+void SegmentedLruEvictionPolicy::OnHit(__in ValueCacheEntry & entry)
+{
+    if (entry.PolicyState == Protected)
+    {
+        protectedList_.Remove(&entry);
+        protectedList_.AppendTail(&entry);
+        return;
+    }
+
+    probationList_.Remove(&entry);
+    entry.PolicyState = Protected;
+    protectedList_.AppendTail(&entry);
+    protectedSize_ += entry.Charge;
+
+    // Keep the most recently promoted entry even if it alone exceeds the protected capacity.
+    while (protectedSize_ > protectedCapacity_ && protectedList_.Count() > 1)
+    {
+        ValueCacheEntry * demoted = protectedList_.RemoveHead();
+        protectedSize_ -= demoted->Charge;
+        demoted->PolicyState = Probation;
+        probationList_.AppendTail(demoted);
+    }
+}
+
+void SegmentedLruEvictionPolicy::OnRemove(__in ValueCacheEntry & entry)
+{
+    if (entry.PolicyState == Protected)
+    {
+        protectedList_.Remove(&entry);
+        protectedSize_ -= entry.Charge;
+    }
+    else
+    {
+        probationList_.Remove(&entry);
+    }
+}
+
+ValueCacheEntry * SegmentedLruEvictionPolicy::SelectVictim()
+{
+    ValueCacheEntry * victim = probationList_.PeekHead();
+    if (victim != nullptr)
+    {
+        return victim;
+    }
+
+    return protectedList_.PeekHead();
+}
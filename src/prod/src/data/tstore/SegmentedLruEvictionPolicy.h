@@ -0,0 +1,69 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace TStore
+    {
+        //
+        // Segmented LRU.
+        // New entries start in the probation segment and are promoted to the protected segment on their first hit.
+        // The protected segment is bounded to a fraction of the shard capacity; its least recently used entries are demoted back to probation.
+        // Victims are taken from the probation segment first, so values read once (scans, files that were merged away) never push out values that are read repeatedly.
+        //
+        class SegmentedLruEvictionPolicy
+            : public IValueCacheEvictionPolicy
+            , public KObject<SegmentedLruEvictionPolicy>
+            , public KShared<SegmentedLruEvictionPolicy>
+        {
+            K_FORCE_SHARED(SegmentedLruEvictionPolicy)
+            K_SHARED_INTERFACE_IMP(IValueCacheEvictionPolicy)
+
+        public:
+
+            //
+            // Percentage of the shard capacity the protected segment may use.
+            //
+            static const ULONG32 ProtectedPercentage = 80;
+
+            static NTSTATUS Create(
+                __in ULONG64 capacityInBytes,
+                __in KAllocator & allocator,
+                __out SegmentedLruEvictionPolicy::SPtr & result);
+
+            ValueCacheEvictionPolicyKind::Enum get_Kind() const override
+            {
+                return ValueCacheEvictionPolicyKind::SegmentedLru;
+            }
+
+            void OnInsert(__in ValueCacheEntry & entry) override;
+
+            void OnHit(__in ValueCacheEntry & entry) override;
+
+            void OnRemove(__in ValueCacheEntry & entry) override;
+
+            ValueCacheEntry * SelectVictim() override;
+
+        private:
+
+            enum Segment : ULONG32
+            {
+                Probation = 0,
+                Protected = 1
+            };
+
+            SegmentedLruEvictionPolicy(__in ULONG64 capacityInBytes);
+
+            // Lists are ordered from least to most recently used.
+            KNodeList<ValueCacheEntry> probationList_;
+            KNodeList<ValueCacheEntry> protectedList_;
+
+            ULONG64 protectedCapacity_;
+            ULONG64 protectedSize_;
+        };
+    }
+}
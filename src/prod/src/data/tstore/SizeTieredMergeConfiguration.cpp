@@ -0,0 +1,67 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+#define SizeTieredMergeConfiguration_Tag 'cmTS'
+
+using namespace Data::TStore;
+
+NTSTATUS
+SizeTieredMergeConfiguration::Create(__in KAllocator& allocator, __out SPtr& result)
+{
+    NTSTATUS status;
+
+    SPtr output = _new(SizeTieredMergeConfiguration_Tag, allocator) SizeTieredMergeConfiguration();
+
+    if (!output)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    status = output->Status();
+    if (!NT_SUCCESS(status))
+    {
+        return status;
+    }
+
+    result = Ktl::Move(output);
+    return STATUS_SUCCESS;
+}
+
+SizeTieredMergeConfiguration::SizeTieredMergeConfiguration()
+    : baseTierSizeThreshold_(DefaultBaseTierSizeThreshold),
+    tierSizeMultiplier_(DefaultTierSizeMultiplier),
+    minFilesPerMerge_(DefaultMinFilesPerMerge),
+    maxFilesPerMerge_(DefaultMaxFilesPerMerge)
+{
+}
+
+SizeTieredMergeConfiguration::~SizeTieredMergeConfiguration()
+{
+}
+
+ULONG32 SizeTieredMergeConfiguration::GetTier(__in ULONG64 fileSize) const
+{
+    ASSERT_IFNOT(baseTierSizeThreshold_ > 0, "Base tier size threshold should be greater than zero");
+    ASSERT_IFNOT(tierSizeMultiplier_ > 1, "Tier size multiplier {0} should be greater than one", tierSizeMultiplier_);
+
+    ULONG32 tier = 0;
+    ULONG64 tierSizeThreshold = baseTierSizeThreshold_;
+
+    while (fileSize >= tierSizeThreshold)
+    {
+        tier++;
+
+        // Stop growing the threshold before it overflows; every larger file shares the last tier.
+        if (tierSizeThreshold > MAXULONG64 / tierSizeMultiplier_)
+        {
+            break;
+        }
+
+        tierSizeThreshold *= tierSizeMultiplier_;
+    }
+
+    return tier;
+}
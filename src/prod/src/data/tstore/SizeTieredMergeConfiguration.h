@@ -0,0 +1,96 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace TStore
+    {
+        //
+        // Configuration of the size tiered merge policy.
+        // Files smaller than the base tier size are in tier 0, and every following tier holds files up to TierSizeMultiplier times larger.
+        //
+        class SizeTieredMergeConfiguration : public KObject<SizeTieredMergeConfiguration>, public KShared<SizeTieredMergeConfiguration>
+        {
+            K_FORCE_SHARED(SizeTieredMergeConfiguration)
+
+        public:
+            //
+            // Files below this size are in tier 0: 1 MB
+            //
+            static const ULONG64 DefaultBaseTierSizeThreshold = 1024 * 1024;
+
+            //
+            // Size ratio between neighbouring tiers.
+            //
+            static const ULONG32 DefaultTierSizeMultiplier = 4;
+
+            //
+            // Number of files a tier needs before it is merged.
+            //
+            static const ULONG32 DefaultMinFilesPerMerge = 4;
+
+            //
+            // Upper bound on the number of files merged at once, so a single merge cannot rewrite the whole store.
+            //
+            static const ULONG32 DefaultMaxFilesPerMerge = 16;
+
+            static NTSTATUS Create(__in KAllocator& allocator, __out SPtr& result);
+
+            __declspec (property(get = get_BaseTierSizeThreshold, put = set_BaseTierSizeThreshold)) ULONG64 BaseTierSizeThreshold;
+            ULONG64 get_BaseTierSizeThreshold() const
+            {
+                return baseTierSizeThreshold_;
+            }
+
+            void set_BaseTierSizeThreshold(__in ULONG64 value)
+            {
+                baseTierSizeThreshold_ = value;
+            }
+
+            __declspec (property(get = get_TierSizeMultiplier, put = set_TierSizeMultiplier)) ULONG32 TierSizeMultiplier;
+            ULONG32 get_TierSizeMultiplier() const
+            {
+                return tierSizeMultiplier_;
+            }
+
+            void set_TierSizeMultiplier(__in ULONG32 value)
+            {
+                tierSizeMultiplier_ = value;
+            }
+
+            __declspec (property(get = get_MinFilesPerMerge, put = set_MinFilesPerMerge)) ULONG32 MinFilesPerMerge;
+            ULONG32 get_MinFilesPerMerge() const
+            {
+                return minFilesPerMerge_;
+            }
+
+            void set_MinFilesPerMerge(__in ULONG32 value)
+            {
+                minFilesPerMerge_ = value;
+            }
+
+            __declspec (property(get = get_MaxFilesPerMerge, put = set_MaxFilesPerMerge)) ULONG32 MaxFilesPerMerge;
+            ULONG32 get_MaxFilesPerMerge() const
+            {
+                return maxFilesPerMerge_;
+            }
+
+            void set_MaxFilesPerMerge(__in ULONG32 value)
+            {
+                maxFilesPerMerge_ = value;
+            }
+
+            ULONG32 GetTier(__in ULONG64 fileSize) const;
+
+        private:
+            ULONG64 baseTierSizeThreshold_;
+            ULONG32 tierSizeMultiplier_;
+            ULONG32 minFilesPerMerge_;
+            ULONG32 maxFilesPerMerge_;
+        };
+    }
+}
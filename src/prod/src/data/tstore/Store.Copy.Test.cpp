@@ -667,6 +667,44 @@ namespace TStoreTests
             co_return;
         }
 
+        ktl::Awaitable<void> Copy_MultipleCheckpoints_OneFileInFlight_ShouldSucceed_Test()
+        {
+            ULONG32 numItems = 100;
+            ULONG32 checkpointFrequency = 10;
+            StoreCopyStream::MaxFilesInFlight = 1;
+
+            // Setup - 100 items over ~10 checkpoints
+            co_await PopulateStoreAsync(numItems, checkpointFrequency);
+
+            auto secondaryStore = co_await CreateSecondaryAsync();
+            co_await FullCopyToSecondaryAsync(*secondaryStore);
+
+            co_await VerifyStateAsync(*Stores, numItems);
+
+            StoreCopyStream::MaxFilesInFlight = 4;
+            co_return;
+        }
+
+        ktl::Awaitable<void> Copy_MultipleCheckpoints_4KBChunks_ManyFilesInFlight_ShouldSucceed_Test()
+        {
+            ULONG32 numItems = 100;
+            ULONG32 checkpointFrequency = 10;
+            StoreCopyStream::CopyChunkSize = 4192;
+            StoreCopyStream::MaxFilesInFlight = 64;
+
+            // Setup - 100 items over ~10 checkpoints, all files prefetched at once
+            co_await PopulateStoreAsync(numItems, checkpointFrequency);
+
+            auto secondaryStore = co_await CreateSecondaryAsync();
+            co_await FullCopyToSecondaryAsync(*secondaryStore);
+
+            co_await VerifyStateAsync(*Stores, numItems);
+
+            StoreCopyStream::CopyChunkSize = 500 * 1024;
+            StoreCopyStream::MaxFilesInFlight = 4;
+            co_return;
+        }
+
         ktl::Awaitable<void> Copy_MultipleSecondaries_Sequential_ShouldSucceed_Test()
         {
             ULONG32 numItems = 100;
@@ -1571,6 +1609,16 @@ namespace TStoreTests
         SyncAwait(Copy_MultipleCheckpoints_ShouldSucceed_Test());
     }
 
+    BOOST_AUTO_TEST_CASE(Copy_MultipleCheckpoints_OneFileInFlight_ShouldSucceed)
+    {
+        SyncAwait(Copy_MultipleCheckpoints_OneFileInFlight_ShouldSucceed_Test());
+    }
+
+    BOOST_AUTO_TEST_CASE(Copy_MultipleCheckpoints_4KBChunks_ManyFilesInFlight_ShouldSucceed)
+    {
+        SyncAwait(Copy_MultipleCheckpoints_4KBChunks_ManyFilesInFlight_ShouldSucceed_Test());
+    }
+
     BOOST_AUTO_TEST_CASE(Copy_MultipleSecondaries_Sequential_ShouldSucceed)
     {
         SyncAwait(Copy_MultipleSecondaries_Sequential_ShouldSucceed_Test());
@@ -403,6 +403,160 @@ namespace TStoreTests
             co_return;
         }
 
+        ktl::Awaitable<void> CheckpointRecoverRead_WithSharedValueCache_ShouldNotLoadValueIntoMemory_Test()
+        {
+            LONG64 key = 17;
+            KString::SPtr value = CreateString(L"value");
+
+            {
+                auto txn = CreateWriteTransaction();
+                co_await Store->AddAsync(*txn->StoreTransactionSPtr, key, value, DefaultTimeout, ktl::CancellationToken::None);
+                co_await txn->CommitAsync();
+            }
+
+            co_await CheckpointAsync();
+            co_await CloseAndReOpenStoreAsync();
+            SweepConsolidatedState();
+            SweepConsolidatedState();
+
+            ValueCache::SPtr valueCacheSPtr = nullptr;
+            NTSTATUS status = ValueCache::Create(1024 * 1024, ValueCacheEvictionPolicyKind::SegmentedLru, GetAllocator(), valueCacheSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            Store->SharedValueCache = valueCacheSPtr;
+
+            LONG64 expectedSize = GetKeysAndMetadataSize(Store->GetEstimatedKeySize(), 0, 1);
+
+            co_await VerifyKeyExistsAsync(*Store, key, nullptr, value, StoreSweepTest::EqualityFunction);
+            co_await VerifyKeyExistsAsync(*Store, key, nullptr, value, StoreSweepTest::EqualityFunction);
+
+            // The value is served from the shared cache and never becomes resident on the versioned item.
+            VersionedItem<KString::SPtr>::SPtr versionedItem = Store->ConsolidationManagerSPtr->Read(key);
+            CODING_ERROR_ASSERT(versionedItem->GetValue() == nullptr);
+            CODING_ERROR_ASSERT(expectedSize == Store->Size);
+
+            CODING_ERROR_ASSERT(valueCacheSPtr->Count == 1);
+            CODING_ERROR_ASSERT(valueCacheSPtr->MissCount == 1);
+            CODING_ERROR_ASSERT(valueCacheSPtr->HitCount == 1);
+            co_return;
+        }
+
+        ktl::Awaitable<void> CheckpointRecoverSweepRead_WithMappedReads_ShouldSucceed_Test(__in ULONG64 budgetInBytes)
+        {
+            for (LONG64 key = 0; key < 100; key++)
+            {
+                auto txn = CreateWriteTransaction();
+                co_await Store->AddAsync(*txn->StoreTransactionSPtr, key, CreateString(static_cast<ULONG>(key)), DefaultTimeout, ktl::CancellationToken::None);
+                co_await txn->CommitAsync();
+            }
+
+            co_await CheckpointAsync();
+            co_await CloseAndReOpenStoreAsync();
+            SweepConsolidatedState();
+            SweepConsolidatedState();
+
+            MappedFileBudget::SPtr budgetSPtr = nullptr;
+            NTSTATUS status = MappedFileBudget::Create(budgetInBytes, GetAllocator(), budgetSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            Store->MappedReadBudget = budgetSPtr;
+
+            for (LONG64 key = 0; key < 100; key++)
+            {
+                co_await VerifyKeyExistsAsync(*Store, key, nullptr, CreateString(static_cast<ULONG>(key)), StoreSweepTest::EqualityFunction);
+            }
+
+#if defined(PLATFORM_UNIX)
+            // A mapping that does not fit is refused, and the reads above went through the file stream instead.
+            bool fits = budgetSPtr->Size > 0;
+            CODING_ERROR_ASSERT(fits == (budgetSPtr->RefusedCount == 0));
+#else
+            CODING_ERROR_ASSERT(budgetSPtr->Size == 0);
+#endif
+            co_return;
+        }
+
+        ktl::Awaitable<void> VerifyTryGetValuesMatchesSingleReadsAsync(
+            __in WriteTransaction<LONG64, KString::SPtr> & txn,
+            __in KSharedArray<LONG64> & keys)
+        {
+            KSharedArray<bool>::SPtr foundSPtr = _new(ALLOC_TAG, GetAllocator()) KSharedArray<bool>();
+            KSharedArray<KeyValuePair<LONG64, KString::SPtr>>::SPtr valuesSPtr = _new(ALLOC_TAG, GetAllocator()) KSharedArray<KeyValuePair<LONG64, KString::SPtr>>();
+
+            co_await Store->TryGetValuesAsync(*txn.StoreTransactionSPtr, keys, DefaultTimeout, *foundSPtr, *valuesSPtr, ktl::CancellationToken::None);
+            CODING_ERROR_ASSERT(foundSPtr->Count() == keys.Count());
+            CODING_ERROR_ASSERT(valuesSPtr->Count() == keys.Count());
+
+            for (ULONG32 i = 0; i < keys.Count(); i++)
+            {
+                KeyValuePair<LONG64, KString::SPtr> expectedValue;
+                bool expectedFound = co_await Store->ConditionalGetAsync(*txn.StoreTransactionSPtr, keys[i], DefaultTimeout, expectedValue, ktl::CancellationToken::None);
+
+                CODING_ERROR_ASSERT((*foundSPtr)[i] == expectedFound);
+                if (expectedFound)
+                {
+                    CODING_ERROR_ASSERT((*valuesSPtr)[i].Key == expectedValue.Key);
+                    CODING_ERROR_ASSERT(EqualityFunction((*valuesSPtr)[i].Value, expectedValue.Value));
+                }
+            }
+
+            co_return;
+        }
+
+        ktl::Awaitable<void> CheckpointRecoverSweep_TryGetValues_ShouldMatchSingleReads_Test()
+        {
+            for (LONG64 key = 0; key < 100; key++)
+            {
+                auto txn = CreateWriteTransaction();
+                co_await Store->AddAsync(*txn->StoreTransactionSPtr, key, CreateString(static_cast<ULONG>(key)), DefaultTimeout, ktl::CancellationToken::None);
+                co_await txn->CommitAsync();
+            }
+
+            // Move every value out of memory so that the batch has to read them from the value checkpoint file.
+            co_await CheckpointAsync();
+            co_await CloseAndReOpenStoreAsync();
+            SweepConsolidatedState();
+            SweepConsolidatedState();
+
+            // Keep some keys in differential state.
+            {
+                auto txn = CreateWriteTransaction();
+                co_await Store->ConditionalUpdateAsync(*txn->StoreTransactionSPtr, 10, CreateString(L"updated"), DefaultTimeout, ktl::CancellationToken::None);
+                co_await Store->ConditionalRemoveAsync(*txn->StoreTransactionSPtr, 11, DefaultTimeout, ktl::CancellationToken::None);
+                co_await txn->CommitAsync();
+            }
+
+            // Unsorted, with duplicates, missing keys and keys from every component.
+            KSharedArray<LONG64>::SPtr keysSPtr = _new(ALLOC_TAG, GetAllocator()) KSharedArray<LONG64>();
+            LONG64 keys[] = { 97, 3, 10, 11, 500, 3, 42, 20, 21, 22, 99, 0, 12, 13 };
+            for (LONG64 key : keys)
+            {
+                keysSPtr->Append(key);
+            }
+
+            {
+                auto txn = CreateWriteTransaction();
+                txn->StoreTransactionSPtr->ReadIsolationLevel = StoreTransactionReadIsolationLevel::Snapshot;
+                co_await VerifyTryGetValuesMatchesSingleReadsAsync(*txn, *keysSPtr);
+                co_await txn->AbortAsync();
+            }
+
+            SweepConsolidatedState();
+            SweepConsolidatedState();
+
+            {
+                auto txn = CreateWriteTransaction();
+                co_await Store->ConditionalUpdateAsync(*txn->StoreTransactionSPtr, 12, CreateString(L"written"), DefaultTimeout, ktl::CancellationToken::None);
+                co_await Store->ConditionalRemoveAsync(*txn->StoreTransactionSPtr, 13, DefaultTimeout, ktl::CancellationToken::None);
+
+                co_await VerifyTryGetValuesMatchesSingleReadsAsync(*txn, *keysSPtr);
+                co_await txn->AbortAsync();
+            }
+
+            // The batch caches the values it loads, just like single reads.
+            VersionedItem<KString::SPtr>::SPtr versionedItem = Store->ConsolidationManagerSPtr->Read(42);
+            CODING_ERROR_ASSERT(versionedItem->GetValue() != nullptr);
+            co_return;
+        }
+
         ktl::Awaitable<void> CheckpointWithSweep_ItemsInOldConsolidatedState_ShouldBeSwept_Test()
         {
             Store->EnableSweep = true;
@@ -832,6 +986,26 @@ namespace TStoreTests
     {
         SyncAwait(CheckpointRecoverSweepRead_ShouldSucceed_Test());
     }
+
+    BOOST_AUTO_TEST_CASE(CheckpointRecoverRead_WithSharedValueCache_ShouldNotLoadValueIntoMemory)
+    {
+        SyncAwait(CheckpointRecoverRead_WithSharedValueCache_ShouldNotLoadValueIntoMemory_Test());
+    }
+
+    BOOST_AUTO_TEST_CASE(CheckpointRecoverSweep_TryGetValues_ShouldMatchSingleReads)
+    {
+        SyncAwait(CheckpointRecoverSweep_TryGetValues_ShouldMatchSingleReads_Test());
+    }
+
+    BOOST_AUTO_TEST_CASE(CheckpointRecoverSweepRead_WithMappedReads_ShouldSucceed)
+    {
+        SyncAwait(CheckpointRecoverSweepRead_WithMappedReads_ShouldSucceed_Test(1024 * 1024));
+    }
+
+    BOOST_AUTO_TEST_CASE(CheckpointRecoverSweepRead_WithMappedReadBudgetExceeded_ShouldFallBackToStreamReads)
+    {
+        SyncAwait(CheckpointRecoverSweepRead_WithMappedReads_ShouldSucceed_Test(1));
+    }
 #pragma endregion
 
 #pragma region Store Sweep tests
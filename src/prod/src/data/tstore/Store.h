@@ -316,6 +316,76 @@ namespace Data
                 enableSweep_ = enable;
             }
 
+            //
+            // Codec used to compress the values of checkpoint files written from now on. Existing files keep their codec.
+            //
+            __declspec(property(get = get_ValueCompressionCodec, put = set_ValueCompressionCodec)) CompressionCodecId::Enum ValueCompressionCodec;
+            CompressionCodecId::Enum get_ValueCompressionCodec() const override
+            {
+                return valueCompressionCodec_;
+            }
+            void set_ValueCompressionCodec(__in CompressionCodecId::Enum codecId)
+            {
+                valueCompressionCodec_ = codecId;
+            }
+
+            //
+            // Upper bound on the number of key ranges a merge is split into, each merged on its own thread into its own checkpoint file.
+            // One keeps the single file merge.
+            //
+            __declspec(property(get = get_MergeDegreeOfParallelism, put = set_MergeDegreeOfParallelism)) ULONG32 MergeDegreeOfParallelism;
+            ULONG32 get_MergeDegreeOfParallelism() const override
+            {
+                return mergeDegreeOfParallelism_;
+            }
+            void set_MergeDegreeOfParallelism(__in ULONG32 degreeOfParallelism)
+            {
+                STORE_ASSERT(degreeOfParallelism > 0, "merge degree of parallelism {1} should be positive", degreeOfParallelism);
+                mergeDegreeOfParallelism_ = degreeOfParallelism;
+            }
+
+            //
+            // Process wide cache used for reads with ReadMode::CacheResult instead of keeping the value resident on the versioned item.
+            // Attached at open when the StoreValueCacheSizeInMB config is set, unless a cache was set before.
+            // Null keeps values resident and leaves eviction to sweep.
+            //
+            __declspec(property(get = get_SharedValueCache, put = set_SharedValueCache)) ValueCache::SPtr SharedValueCache;
+            ValueCache::SPtr get_SharedValueCache() const
+            {
+                return valueCacheSPtr_;
+            }
+            void set_SharedValueCache(__in ValueCache::SPtr valueCache)
+            {
+                valueCacheSPtr_ = valueCache;
+            }
+
+            //
+            // Process wide budget for mapping value checkpoint files into memory, so that reads of them skip the async file IO.
+            // Attached at open when the StoreMappedReadBudgetInMB config is set, unless a budget was set before.
+            // Setting it later enables the files already in the current metadata table. Null reads every value through the checkpoint file streams.
+            //
+            __declspec(property(get = get_MappedReadBudget, put = set_MappedReadBudget)) MappedFileBudget::SPtr MappedReadBudget;
+            MappedFileBudget::SPtr get_MappedReadBudget() const
+            {
+                return mappedFileBudgetSPtr_;
+            }
+            void set_MappedReadBudget(__in MappedFileBudget::SPtr budget)
+            {
+                mappedFileBudgetSPtr_ = budget;
+
+                MetadataTable::SPtr metadataTableSPtr = currentMetadataTableSPtr_.Get();
+                if (metadataTableSPtr == nullptr)
+                {
+                    return;
+                }
+
+                IEnumerator<KeyValuePair<ULONG32, FileMetadata::SPtr>>::SPtr enumerator = metadataTableSPtr->Table->GetEnumerator();
+                while (enumerator->MoveNext())
+                {
+                    EnableMappedReads(*enumerator->Current().Value);
+                }
+            }
+
             __declspec(property(get = get_SweepTask, put = set_SweepTask)) ktl::AwaitableCompletionSource<bool>::SPtr SweepTaskSourceSPtr;
             ktl::AwaitableCompletionSource<bool>::SPtr get_SweepTask()
             {
@@ -968,6 +1038,194 @@ namespace Data
                 }
             }
 
+            ktl::Awaitable<void> TryGetValuesAsync(
+                __in IStoreTransaction<TKey, TValue>& storeTransaction,
+                __in KSharedArray<TKey> const & keys,
+                __in Common::TimeSpan timeout,
+                __out KSharedArray<bool>& found,
+                __out KSharedArray<KeyValuePair<LONG64, TValue>>& values,
+                __in ktl::CancellationToken const & cancellationToken) override
+            {
+                ApiEntry();
+
+                KSharedPtr<StoreTransaction<TKey, TValue>> storeTransactionSPtr = static_cast<StoreTransaction<TKey, TValue>*>(&storeTransaction);
+                KSharedPtr<KSharedArray<TKey> const> keysCSPtr = &keys;
+                KSharedPtr<KSharedArray<bool>> foundSPtr = &found;
+                KSharedPtr<KSharedArray<KeyValuePair<LONG64, TValue>>> valuesSPtr = &values;
+                ReadMode readMode = ReadMode::CacheResult;
+                ULONG64 keyLockResourceNameHash = 0;
+
+                try
+                {
+                    foundSPtr->Clear();
+                    valuesSPtr->Clear();
+                    for (ULONG32 i = 0; i < keysCSPtr->Count(); i++)
+                    {
+                        NTSTATUS status = foundSPtr->Append(false);
+                        Diagnostics::Validate(status);
+                        status = valuesSPtr->Append(KeyValuePair<LONG64, TValue>());
+                        Diagnostics::Validate(status);
+                    }
+
+                    if (keysCSPtr->Count() == 0)
+                    {
+                        co_return;
+                    }
+
+                    ThrowIfFaulted(*storeTransactionSPtr);
+                    ThrowIfNotReadable(*storeTransactionSPtr);
+
+                    Common::TimeSpan primeLockTimeout = timeout;
+                    if (primeLockTimeout < Common::TimeSpan::Zero)
+                    {
+                        primeLockTimeout = Common::TimeSpan::MaxValue;
+                    }
+                    co_await storeTransactionSPtr->AcquirePrimeLockAsync(*lockManager_, LockMode::Shared, primeLockTimeout, false);
+
+                    // If the operation was cancelled during the lock wait, then terminate
+                    cancellationToken.ThrowIfCancellationRequested();
+
+                    ThrowIfFaulted(*storeTransactionSPtr);
+
+                    // Visit the keys in key order, so that concurrent batches take their key locks in the same order.
+                    KSharedPtr<KSharedArray<KeyValuePair<TKey, ULONG32>>> sortedKeysSPtr = _new(STORE_TAG, this->GetThisAllocator()) KSharedArray<KeyValuePair<TKey, ULONG32>>();
+                    Diagnostics::Validate(sortedKeysSPtr);
+                    for (ULONG32 i = 0; i < keysCSPtr->Count(); i++)
+                    {
+                        NTSTATUS status = sortedKeysSPtr->Append(KeyValuePair<TKey, ULONG32>((*keysCSPtr)[i], i));
+                        Diagnostics::Validate(status);
+                    }
+
+                    typename SortedItemComparer<TKey, ULONG32>::SPtr sortedKeyComparerSPtr = nullptr;
+                    NTSTATUS status = SortedItemComparer<TKey, ULONG32>::Create(*keyComparerSPtr_, this->GetThisAllocator(), sortedKeyComparerSPtr);
+                    Diagnostics::Validate(status);
+                    Sorter<KeyValuePair<TKey, ULONG32>>::QuickSort(true, *sortedKeyComparerSPtr, sortedKeysSPtr);
+
+                    LONG64 visibilitySequenceNumber = Constants::InvalidLsn;
+                    if (storeTransactionSPtr->ReadIsolationLevel == StoreTransactionReadIsolationLevel::Enum::Snapshot)
+                    {
+                        TxnReplicator::Transaction::SPtr transaction = static_cast<TxnReplicator::Transaction *>(storeTransactionSPtr->ReplicatorTransaction.RawPtr());
+                        Diagnostics::Validate(co_await transaction->GetVisibilitySequenceNumberAsync(visibilitySequenceNumber));
+                    }
+                    else
+                    {
+                        STORE_ASSERT(storeTransactionSPtr->ReadIsolationLevel == StoreTransactionReadIsolationLevel::Enum::ReadRepeatable,
+                            "store transaction should be read committed or repeatable read");
+                    }
+
+                    KSharedPtr<WriteSetStoreComponent<TKey, TValue>> writesetSPtr = nullptr;
+                    if (!storeTransactionSPtr->IsWriteSetEmpty)
+                    {
+                        writesetSPtr = storeTransactionSPtr->GetComponent(func_);
+                        STORE_ASSERT(writesetSPtr != nullptr, "writeset != nullptr");
+                    }
+
+                    // Versioned item each key resolved to, indexed like the keys. Null if the key does not exist or was answered by the write set.
+                    KSharedPtr<KSharedArray<KSharedPtr<VersionedItem<TValue>>>> versionedItemsSPtr = _new(STORE_TAG, this->GetThisAllocator()) KSharedArray<KSharedPtr<VersionedItem<TValue>>>();
+                    Diagnostics::Validate(versionedItemsSPtr);
+
+                    // Keys whose values are only on disk. They are loaded together once every key has been resolved.
+                    KSharedPtr<KSharedArray<ULONG32>> deferredIndexesSPtr = _new(STORE_TAG, this->GetThisAllocator()) KSharedArray<ULONG32>();
+                    Diagnostics::Validate(deferredIndexesSPtr);
+
+                    for (ULONG32 i = 0; i < keysCSPtr->Count(); i++)
+                    {
+                        status = versionedItemsSPtr->Append(nullptr);
+                        Diagnostics::Validate(status);
+                    }
+
+                    for (ULONG32 sortedIndex = 0; sortedIndex < sortedKeysSPtr->Count(); sortedIndex++)
+                    {
+                        TKey key = (*sortedKeysSPtr)[sortedIndex].Key;
+                        ULONG32 index = (*sortedKeysSPtr)[sortedIndex].Value;
+
+                        auto keyBytes = GetKeyBytes(key);
+                        keyLockResourceNameHash = GetHash(*keyBytes);
+
+                        if (writesetSPtr != nullptr)
+                        {
+                            KSharedPtr<VersionedItem<TValue>> writesetItemSPtr = writesetSPtr->Read(key);
+                            if (writesetItemSPtr != nullptr)
+                            {
+                                // Safe to get the value from versioned item since it is in the write set
+                                (*valuesSPtr)[index].Key = writesetItemSPtr->GetVersionSequenceNumber();
+                                if (writesetItemSPtr->GetRecordKind() != RecordKind::DeletedVersion)
+                                {
+                                    (*valuesSPtr)[index].Value = writesetItemSPtr->GetValue();
+                                    (*foundSPtr)[index] = true;
+                                }
+
+                                continue;
+                            }
+                        }
+
+                        KSharedPtr<StoreComponentReadResult<TValue>> readResultSPtr = nullptr;
+                        bool valueLoadDeferred = false;
+
+                        if (storeTransactionSPtr->ReadIsolationLevel == StoreTransactionReadIsolationLevel::Enum::Snapshot)
+                        {
+                            readResultSPtr = co_await TryGetValueForReadOnlyTransactionsAsync(key, visibilitySequenceNumber, true, readMode, cancellationToken, &valueLoadDeferred);
+                            ThrowIfFaulted(*storeTransactionSPtr);
+                        }
+                        else
+                        {
+                            // Equal keys are adjacent once sorted, and the transaction already holds the lock of the previous one.
+                            if (sortedIndex == 0 || keyComparerSPtr_->Compare((*sortedKeysSPtr)[sortedIndex - 1].Key, key) != 0)
+                            {
+                                co_await AcquireKeyReadLockAsync(*lockManager_, keyLockResourceNameHash, *storeTransactionSPtr, timeout);
+
+                                // If the operation was cancelled during the lock wait, then terminate
+                                cancellationToken.ThrowIfCancellationRequested();
+                            }
+
+                            readResultSPtr = co_await TryGetValueForReadOnlyTransactionsAsync(key, Constants::InvalidLsn, false, readMode, cancellationToken, &valueLoadDeferred);
+                        }
+
+                        KSharedPtr<VersionedItem<TValue>> versionedItemSPtr = readResultSPtr->VersionedItem;
+                        (*versionedItemsSPtr)[index] = versionedItemSPtr;
+
+                        if (versionedItemSPtr == nullptr || versionedItemSPtr->GetRecordKind() == RecordKind::DeletedVersion)
+                        {
+                            StoreEventSource::Events->StoreTryGetValueAsyncNotFound(
+                                traceComponent_->PartitionId, traceComponent_->TraceTag,
+                                storeTransactionSPtr->Id,
+                                keyLockResourceNameHash,
+                                static_cast<ULONG32>(storeTransactionSPtr->ReadIsolationLevel),
+                                -1,
+                                versionedItemSPtr == nullptr ? L"keydoesnotexist" : L"keyfounddeleted");
+                            continue;
+                        }
+
+                        (*valuesSPtr)[index].Key = versionedItemSPtr->GetVersionSequenceNumber();
+                        (*foundSPtr)[index] = true;
+
+                        if (valueLoadDeferred)
+                        {
+                            status = deferredIndexesSPtr->Append(index);
+                            Diagnostics::Validate(status);
+                        }
+                        else
+                        {
+                            STORE_ASSERT(readResultSPtr->HasValue(), "Read result should have a value");
+                            (*valuesSPtr)[index].Value = readResultSPtr->Value;
+                        }
+                    }
+
+                    if (deferredIndexesSPtr->Count() > 0)
+                    {
+                        co_await LoadDeferredValuesAsync(*keysCSPtr, *versionedItemsSPtr, *deferredIndexesSPtr, visibilitySequenceNumber, readMode, *valuesSPtr, cancellationToken);
+                    }
+
+                    // Make sure a read does not start in primary role and completes in secondary role.
+                    ThrowIfNotReadable(*storeTransactionSPtr);
+                }
+                catch (ktl::Exception const & e)
+                {
+                    TraceException(L"TryGetValuesAsync", e, storeTransactionSPtr->Id, keyLockResourceNameHash);
+                    throw;
+                }
+            }
+
             ktl::Awaitable<void> BackupCheckpointAsync(
                 __in KString const & backupDirectory,
                 __in ktl::CancellationToken const & cancellationToken) override
@@ -1355,6 +1613,45 @@ namespace Data
                 }
             }
 
+            //
+            // Enumerates the keys in the range that pass keyFilter. The filter runs on the in-memory keys, so keys it rejects are never locked
+            // and their values are never read. valueReadModeSelector picks the ReadMode of each returned item; if it is not bound, values are read.
+            //
+            ktl::Awaitable<KSharedPtr<IAsyncEnumerator<KeyValuePair<TKey, KeyValuePair<LONG64, TValue>>>>> CreateEnumeratorAsync(
+                __in IStoreTransaction<TKey, TValue> & storeTransaction,
+                __in TKey firstKey,
+                __in bool useFirstKey,
+                __in TKey lastKey,
+                __in bool useLastKey,
+                __in typename IStore<TKey, TValue>::KeyFilterFunctionType keyFilter,
+                __in typename IStore<TKey, TValue>::ValueReadModeFunctionType valueReadModeSelector) override
+            {
+                ApiEntry();
+
+                if (!EnableEnumerationWithRepeatableRead && storeTransaction.ReadIsolationLevel != StoreTransactionReadIsolationLevel::Snapshot)
+                {
+                    throw ktl::Exception(SF_STATUS_INVALID_OPERATION);
+                }
+
+                if (useFirstKey && useLastKey)
+                {
+                    if (keyComparerSPtr_->Compare(firstKey, lastKey) > 0)
+                    {
+                        throw ktl::Exception(STATUS_INVALID_PARAMETER_4);
+                    }
+                }
+
+                try
+                {
+                    return CreateKeyValueEnumeratorAsync(storeTransaction, firstKey, useFirstKey, lastKey, useLastKey, ReadMode::ReadValue, keyFilter, valueReadModeSelector);
+                }
+                catch (ktl::Exception const & e)
+                {
+                    TraceException(L"CreateEnumeratorAsync", e);
+                    throw;
+                }
+            }
+
 
 #pragma region ISweepProvider
 
@@ -2728,6 +3025,26 @@ namespace Data
 
                 co_await lockManager_->OpenAsync();
 
+                if (valueCacheSPtr_ == nullptr)
+                {
+                    ULONG64 valueCacheSizeInBytes = GetReplicator()->StoreValueCacheSizeInBytes;
+                    if (valueCacheSizeInBytes > 0)
+                    {
+                        // Caching is best effort; without the cache, values stay resident until sweep.
+                        ValueCache::GetOrCreateProcessCache(valueCacheSizeInBytes, GetThisAllocator(), valueCacheSPtr_);
+                    }
+                }
+
+                if (mappedFileBudgetSPtr_ == nullptr)
+                {
+                    ULONG64 mappedReadBudgetInBytes = GetReplicator()->StoreMappedReadBudgetInBytes;
+                    if (mappedReadBudgetInBytes > 0)
+                    {
+                        // Without the budget, values are read through the checkpoint file streams.
+                        MappedFileBudget::GetOrCreateProcessBudget(mappedReadBudgetInBytes, GetThisAllocator(), mappedFileBudgetSPtr_);
+                    }
+                }
+
                 if (hasPersistedState_)
                 {
                     STORE_ASSERT(Common::Directory::Exists(WorkingDirectoryCSPtr->operator LPCWSTR()), "working directory should exist");
@@ -2774,7 +3091,8 @@ namespace Data
                 __in LONG64 visibilitySequenceNumber,
                 __in bool includeSnapshotContainer,
                 __in ReadMode readMode,
-                __in ktl::CancellationToken const & cancellationToken)
+                __in ktl::CancellationToken const & cancellationToken,
+                __out_opt bool * valueLoadDeferred = nullptr)
             {
                 bool itemPresentInSnapshotComponent = false;
                 KSharedPtr<StoreComponentReadResult<TValue>> readResultSPtr = nullptr;
@@ -2833,18 +3151,22 @@ namespace Data
 
                     if (!itemPresentInSnapshotComponent)
                     {
-                        readResultSPtr = co_await ReadFromConsolidatedStateAsync(key, visibilitySequenceNumber, readMode, cancellationToken);
+                        readResultSPtr = co_await ReadFromConsolidatedStateAsync(key, visibilitySequenceNumber, readMode, cancellationToken, valueLoadDeferred);
                     }
                 }
 
                 co_return readResultSPtr;
             }
 
+            //
+            // If valueLoadDeferred is given, a value that is not in memory is not loaded; the flag is set and the caller loads it.
+            //
             ktl::Awaitable<KSharedPtr<StoreComponentReadResult<TValue>>> ReadFromConsolidatedStateAsync(
                 __in TKey & key,
                 __in LONG64 visibilitySequenceNumber,
                 __in ReadMode readMode,
-                __in ktl::CancellationToken const & cancellationToken)
+                __in ktl::CancellationToken const & cancellationToken,
+                __out_opt bool * valueLoadDeferred = nullptr)
             {
                 KSharedPtr<VersionedItem<TValue>> versionedItem = nullptr;
                 TValue value = TValue();
@@ -2886,10 +3208,17 @@ namespace Data
 
                     if (shouldValueBeLoaded)
                     {
+                        if (valueLoadDeferred != nullptr)
+                        {
+                            *valueLoadDeferred = true;
+                            break;
+                        }
+
                         bool hasValue = co_await TryLoadValueAsync(*versionedItem, readMode, value);
                         if (hasValue)
                         {
-                            if (readMode == ReadMode::CacheResult)
+                            // Values served through the shared value cache are charged to its budget, not to the store.
+                            if (readMode == ReadMode::CacheResult && valueCacheSPtr_ == nullptr)
                             {
                                 // If there are multiple loads in progress there could be some overcounting here - not worth locking for it.
                                 consolidationManagerSPtr_->AddToMemorySize(versionedItem->GetValueSize());
@@ -2976,20 +3305,20 @@ namespace Data
                         // Order is important. Check the merge table first and then next
                         if (useMergeTable && cachedMergeMetadataTableSPtr != nullptr && cachedMergeMetadataTableSPtr->Table->ContainsKey(versionedItemSPtr->GetFileId()))
                         {
-                            value = co_await versionedItemSPtr->GetValueAsync(*cachedMergeMetadataTableSPtr, *valueConverterSPtr_, readMode, *traceComponent_, ktl::CancellationToken::None);
+                            value = co_await LoadValueAsync(*cachedMergeMetadataTableSPtr, *versionedItemSPtr, readMode);
                         }
                         else
                         {
                             // Load from next metadata table
                             if (useNextTable && cachedNextMetadataTableSPtr != nullptr && cachedNextMetadataTableSPtr->Table->ContainsKey(versionedItemSPtr->GetFileId()))
                             {
-                                value = co_await versionedItemSPtr->GetValueAsync(*cachedNextMetadataTableSPtr, *valueConverterSPtr_, readMode, *traceComponent_, ktl::CancellationToken::None);
+                                value = co_await LoadValueAsync(*cachedNextMetadataTableSPtr, *versionedItemSPtr, readMode);
                             }
                             else if (useCurrentTable)
                             {
                                 // Load using current metadata table
                                 STORE_ASSERT(cachedCurrentMetadataTableSPtr->Table->ContainsKey(versionedItemSPtr->GetFileId()), "Current metadata table must contain the file id");
-                                value = co_await versionedItemSPtr->GetValueAsync(*cachedCurrentMetadataTableSPtr, *valueConverterSPtr_, readMode, *traceComponent_, ktl::CancellationToken::None);
+                                value = co_await LoadValueAsync(*cachedCurrentMetadataTableSPtr, *versionedItemSPtr, readMode);
                             }
                         }
                     }
@@ -3025,6 +3354,368 @@ namespace Data
                 co_return successful;
             }
 
+            //
+            // Loads the values of keys that TryGetValuesAsync resolved to consolidated items that are not in memory.
+            //
+            ktl::Awaitable<void> LoadDeferredValuesAsync(
+                __in KSharedArray<TKey> const & keys,
+                __in KSharedArray<KSharedPtr<VersionedItem<TValue>>> & versionedItems,
+                __in KSharedArray<ULONG32> & deferredIndexes,
+                __in LONG64 visibilitySequenceNumber,
+                __in ReadMode readMode,
+                __inout KSharedArray<KeyValuePair<LONG64, TValue>> & values,
+                __in ktl::CancellationToken const & cancellationToken)
+            {
+                KSharedPtr<KSharedArray<TKey> const> keysCSPtr = &keys;
+                KSharedPtr<KSharedArray<KSharedPtr<VersionedItem<TValue>>>> versionedItemsSPtr = &versionedItems;
+                KSharedPtr<KSharedArray<ULONG32>> deferredIndexesSPtr = &deferredIndexes;
+                KSharedPtr<KSharedArray<KeyValuePair<LONG64, TValue>>> valuesSPtr = &values;
+
+                KSharedPtr<KSharedArray<KSharedPtr<VersionedItem<TValue>>>> itemsSPtr = _new(STORE_TAG, this->GetThisAllocator()) KSharedArray<KSharedPtr<VersionedItem<TValue>>>();
+                Diagnostics::Validate(itemsSPtr);
+                for (ULONG32 i = 0; i < deferredIndexesSPtr->Count(); i++)
+                {
+                    NTSTATUS status = itemsSPtr->Append((*versionedItemsSPtr)[(*deferredIndexesSPtr)[i]]);
+                    Diagnostics::Validate(status);
+                }
+
+                KSharedPtr<KSharedArray<TValue>> loadedValuesSPtr = _new(STORE_TAG, this->GetThisAllocator()) KSharedArray<TValue>();
+                Diagnostics::Validate(loadedValuesSPtr);
+
+                bool loaded = co_await TryLoadValuesAsync(*itemsSPtr, readMode, *loadedValuesSPtr);
+                if (loaded)
+                {
+                    for (ULONG32 i = 0; i < deferredIndexesSPtr->Count(); i++)
+                    {
+                        (*valuesSPtr)[(*deferredIndexesSPtr)[i]].Value = (*loadedValuesSPtr)[i];
+
+                        // Values served through the shared value cache are charged to its budget, not to the store.
+                        if (readMode == ReadMode::CacheResult && valueCacheSPtr_ == nullptr)
+                        {
+                            consolidationManagerSPtr_->AddToMemorySize((*itemsSPtr)[i]->GetValueSize());
+                        }
+                    }
+
+                    co_return;
+                }
+
+                // A metadata table went away while the values were being located, so some items may have moved to newer files.
+                // Fall back to reading the keys one at a time, which re-reads the versioned item and retries like a single read.
+                for (ULONG32 i = 0; i < deferredIndexesSPtr->Count(); i++)
+                {
+                    ULONG32 index = (*deferredIndexesSPtr)[i];
+                    TKey key = (*keysCSPtr)[index];
+
+                    KSharedPtr<StoreComponentReadResult<TValue>> readResultSPtr = co_await ReadFromConsolidatedStateAsync(key, visibilitySequenceNumber, readMode, cancellationToken);
+                    STORE_ASSERT(readResultSPtr->VersionedItem != nullptr, "Versioned item should not be null");
+                    STORE_ASSERT(readResultSPtr->HasValue(), "Read result should have a value");
+                    (*valuesSPtr)[index].Value = readResultSPtr->Value;
+                }
+            }
+
+            //
+            // Batched form of TryLoadValueAsync. Values are returned in the order of the given items.
+            // The metadata tables are referenced once for the whole batch and each checkpoint file is read once, in offset order.
+            //
+            ktl::Awaitable<bool> TryLoadValuesAsync(
+                __in KSharedArray<KSharedPtr<VersionedItem<TValue>>> & items,
+                __in ReadMode readMode,
+                __out KSharedArray<TValue> & values)
+            {
+                KSharedPtr<KSharedArray<KSharedPtr<VersionedItem<TValue>>>> itemsSPtr = &items;
+                KSharedPtr<KSharedArray<TValue>> valuesSPtr = &values;
+
+                SharedException::CSPtr exceptionCSPtr = nullptr;
+                bool currentAddRefSucceeded = false;
+                bool nextAddRefSucceeded = false;
+                bool mergeAddRefSucceeded = false;
+                bool successful = true;
+
+                // Snap the tables in the order of current first and then next, like TryLoadValueAsync.
+                MetadataTable::SPtr cachedCurrentMetadataTableSPtr = currentMetadataTableSPtr_.Get();
+                STORE_ASSERT(cachedCurrentMetadataTableSPtr != nullptr, "current metadata table cannot be null");
+
+                MetadataTable::SPtr cachedNextMetadataTableSPtr = nextMetadataTableSPtr_.Get();
+                MetadataTable::SPtr cachedMergeMetadataTableSPtr = mergeMetadataTableSPtr_.Get();
+
+                try
+                {
+                    valuesSPtr->Clear();
+                    for (ULONG32 i = 0; i < itemsSPtr->Count(); i++)
+                    {
+                        NTSTATUS status = valuesSPtr->Append(TValue());
+                        Diagnostics::Validate(status);
+                    }
+
+                    currentAddRefSucceeded = cachedCurrentMetadataTableSPtr->TryAddReference();
+                    successful = currentAddRefSucceeded;
+
+                    if (successful && cachedNextMetadataTableSPtr != nullptr)
+                    {
+                        nextAddRefSucceeded = cachedNextMetadataTableSPtr->TryAddReference();
+                        successful = nextAddRefSucceeded;
+                    }
+
+                    if (successful && cachedMergeMetadataTableSPtr != nullptr)
+                    {
+                        mergeAddRefSucceeded = cachedMergeMetadataTableSPtr->TryAddReference();
+                        successful = mergeAddRefSucceeded;
+                    }
+
+                    if (successful)
+                    {
+                        // Group the items by the checkpoint file that holds their value.
+                        KSharedPtr<KSharedArray<FileMetadata::SPtr>> filesSPtr = _new(STORE_TAG, this->GetThisAllocator()) KSharedArray<FileMetadata::SPtr>();
+                        Diagnostics::Validate(filesSPtr);
+                        KSharedPtr<KSharedArray<KSharedPtr<KSharedArray<ULONG32>>>> fileItemIndexesSPtr = _new(STORE_TAG, this->GetThisAllocator()) KSharedArray<KSharedPtr<KSharedArray<ULONG32>>>();
+                        Diagnostics::Validate(fileItemIndexesSPtr);
+
+                        for (ULONG32 i = 0; i < itemsSPtr->Count(); i++)
+                        {
+                            VersionedItem<TValue> & versionedItem = *(*itemsSPtr)[i];
+                            STORE_ASSERT(versionedItem.GetRecordKind() != RecordKind::DeletedVersion, "Versioned item should not be a deleted kind");
+                            ULONG32 fileId = versionedItem.GetFileId();
+
+                            // Order is important. Check the merge table first and then next
+                            MetadataTable::SPtr metadataTableSPtr = cachedCurrentMetadataTableSPtr;
+                            if (mergeAddRefSucceeded && cachedMergeMetadataTableSPtr->Table->ContainsKey(fileId))
+                            {
+                                metadataTableSPtr = cachedMergeMetadataTableSPtr;
+                            }
+                            else if (nextAddRefSucceeded && cachedNextMetadataTableSPtr->Table->ContainsKey(fileId))
+                            {
+                                metadataTableSPtr = cachedNextMetadataTableSPtr;
+                            }
+
+                            FileMetadata::SPtr fileMetadataSPtr = nullptr;
+                            bool found = metadataTableSPtr->Table->TryGetValue(fileId, fileMetadataSPtr);
+                            if (!found)
+                            {
+                                throw ktl::Exception(SF_STATUS_INVALID_OPERATION);
+                            }
+
+                            STORE_ASSERT(fileMetadataSPtr->CheckpointFileSPtr != nullptr, "Checkpoint file with id {1} does not exist in memory", fileId);
+
+                            ULONG32 fileIndex = 0;
+                            while (fileIndex < filesSPtr->Count() && (*filesSPtr)[fileIndex] != fileMetadataSPtr)
+                            {
+                                fileIndex++;
+                            }
+
+                            if (fileIndex == filesSPtr->Count())
+                            {
+                                NTSTATUS status = filesSPtr->Append(fileMetadataSPtr);
+                                Diagnostics::Validate(status);
+
+                                KSharedPtr<KSharedArray<ULONG32>> itemIndexesSPtr = _new(STORE_TAG, this->GetThisAllocator()) KSharedArray<ULONG32>();
+                                Diagnostics::Validate(itemIndexesSPtr);
+                                status = fileItemIndexesSPtr->Append(itemIndexesSPtr);
+                                Diagnostics::Validate(status);
+                            }
+
+                            NTSTATUS status = (*fileItemIndexesSPtr)[fileIndex]->Append(i);
+                            Diagnostics::Validate(status);
+                        }
+
+                        for (ULONG32 fileIndex = 0; fileIndex < filesSPtr->Count(); fileIndex++)
+                        {
+                            co_await LoadValuesFromFileAsync(*(*filesSPtr)[fileIndex], *itemsSPtr, *(*fileItemIndexesSPtr)[fileIndex], readMode, *valuesSPtr);
+                        }
+                    }
+                }
+                catch (ktl::Exception const & e)
+                {
+                    TraceException(L"TryLoadValuesAsync", e);
+                    exceptionCSPtr = SharedException::Create(e, this->GetThisAllocator());
+                    successful = false;
+                }
+
+                if (currentAddRefSucceeded)
+                {
+                    co_await cachedCurrentMetadataTableSPtr->ReleaseReferenceAsync();
+                }
+
+                if (nextAddRefSucceeded)
+                {
+                    co_await cachedNextMetadataTableSPtr->ReleaseReferenceAsync();
+                }
+
+                if (mergeAddRefSucceeded)
+                {
+                    co_await cachedMergeMetadataTableSPtr->ReleaseReferenceAsync();
+                }
+
+                if (exceptionCSPtr != nullptr)
+                {
+                    auto exec = exceptionCSPtr->Info;
+                    throw exec;
+                }
+
+                co_return successful;
+            }
+
+            ktl::Awaitable<void> LoadValuesFromFileAsync(
+                __in FileMetadata & fileMetadata,
+                __in KSharedArray<KSharedPtr<VersionedItem<TValue>>> & items,
+                __in KSharedArray<ULONG32> & itemIndexes,
+                __in ReadMode readMode,
+                __inout KSharedArray<TValue> & values)
+            {
+                FileMetadata::SPtr fileMetadataSPtr = &fileMetadata;
+                KSharedPtr<KSharedArray<KSharedPtr<VersionedItem<TValue>>>> itemsSPtr = &items;
+                KSharedPtr<KSharedArray<ULONG32>> itemIndexesSPtr = &itemIndexes;
+                KSharedPtr<KSharedArray<TValue>> valuesSPtr = &values;
+
+                bool useValueCache = valueCacheSPtr_ != nullptr && readMode == ReadMode::CacheResult;
+
+                KSharedPtr<KSharedArray<KSharedPtr<VersionedItem<TValue>>>> itemsToReadSPtr = _new(STORE_TAG, this->GetThisAllocator()) KSharedArray<KSharedPtr<VersionedItem<TValue>>>();
+                Diagnostics::Validate(itemsToReadSPtr);
+                KSharedPtr<KSharedArray<ULONG32>> indexesToReadSPtr = _new(STORE_TAG, this->GetThisAllocator()) KSharedArray<ULONG32>();
+                Diagnostics::Validate(indexesToReadSPtr);
+
+                for (ULONG32 i = 0; i < itemIndexesSPtr->Count(); i++)
+                {
+                    ULONG32 index = (*itemIndexesSPtr)[i];
+                    KSharedPtr<VersionedItem<TValue>> versionedItemSPtr = (*itemsSPtr)[index];
+
+                    if (useValueCache)
+                    {
+                        ValueCacheKey key(fileMetadataSPtr->CheckpointFileSPtr->ValueCacheFileId, versionedItemSPtr->GetOffset());
+                        KBuffer::SPtr bytesSPtr = nullptr;
+                        bool hit = valueCacheSPtr_->TryGet(key, bytesSPtr);
+
+                        if (perfCounters_ != nullptr)
+                        {
+                            if (hit)
+                            {
+                                perfCounters_->ValueCacheHitRatio.Increment();
+                            }
+
+                            perfCounters_->ValueCacheHitRatioBase.Increment();
+                        }
+
+                        if (hit)
+                        {
+                            Utilities::BinaryReader reader(*bytesSPtr, this->GetThisAllocator());
+                            (*valuesSPtr)[index] = valueConverterSPtr_->Read(reader);
+                            continue;
+                        }
+                    }
+
+                    NTSTATUS status = itemsToReadSPtr->Append(versionedItemSPtr);
+                    Diagnostics::Validate(status);
+                    status = indexesToReadSPtr->Append(index);
+                    Diagnostics::Validate(status);
+                }
+
+                if (itemsToReadSPtr->Count() == 0)
+                {
+                    co_return;
+                }
+
+                KSharedPtr<KSharedArray<KBuffer::SPtr>> bytesArraySPtr = co_await fileMetadataSPtr->CheckpointFileSPtr->ReadValuesAsync(*itemsToReadSPtr);
+
+                for (ULONG32 i = 0; i < itemsToReadSPtr->Count(); i++)
+                {
+                    KSharedPtr<VersionedItem<TValue>> versionedItemSPtr = (*itemsToReadSPtr)[i];
+                    KBuffer::SPtr bytesSPtr = (*bytesArraySPtr)[i];
+
+                    Utilities::BinaryReader reader(*bytesSPtr, this->GetThisAllocator());
+                    TValue value = valueConverterSPtr_->Read(reader);
+                    (*valuesSPtr)[(*indexesToReadSPtr)[i]] = value;
+
+                    if (useValueCache)
+                    {
+                        // The versioned item is left as it is, so the value stays out of the store memory size and sweep never sees it.
+                        ValueCacheKey key(fileMetadataSPtr->CheckpointFileSPtr->ValueCacheFileId, versionedItemSPtr->GetOffset());
+                        ULONG32 evicted = valueCacheSPtr_->Add(key, *bytesSPtr);
+
+                        if (perfCounters_ != nullptr && evicted > 0)
+                        {
+                            perfCounters_->ValueCacheEvictions.IncrementBy(evicted);
+                        }
+                    }
+                    else if (readMode == ReadMode::CacheResult)
+                    {
+                        versionedItemSPtr->AcquireLock();
+                        KFinally([&] { versionedItemSPtr->ReleaseLock(*traceComponent_); });
+
+                        // Always call set and get within the lock - if TValue is a shared ptr its access should be protected.
+                        versionedItemSPtr->SetValue(value);
+
+                        // Update in memory after setting value
+                        versionedItemSPtr->SetIsInMemory(true);
+
+                        // Set in use only after updating the value
+                        versionedItemSPtr->SetInUse(true);
+                    }
+                }
+            }
+
+            //
+            // Lets the checkpoint file serve its reads from a mapping, if the store has a mapping budget.
+            // Called once per file, when the file is added to the metadata table; recovery enables the files it loads.
+            //
+            void EnableMappedReads(__in FileMetadata & fileMetadata)
+            {
+                if (mappedFileBudgetSPtr_ != nullptr && fileMetadata.CheckpointFileSPtr != nullptr)
+                {
+                    fileMetadata.CheckpointFileSPtr->EnableMappedReads(*mappedFileBudgetSPtr_);
+                }
+            }
+
+            ktl::Awaitable<TValue> LoadValueAsync(
+                __in MetadataTable & metadataTable,
+                __in VersionedItem<TValue> & versionedItem,
+                __in ReadMode readMode)
+            {
+                MetadataTable::SPtr metadataTableSPtr = &metadataTable;
+                KSharedPtr<VersionedItem<TValue>> versionedItemSPtr = &versionedItem;
+
+                if (valueCacheSPtr_ == nullptr || readMode != ReadMode::CacheResult)
+                {
+                    TValue value = co_await versionedItemSPtr->GetValueAsync(*metadataTableSPtr, *valueConverterSPtr_, readMode, *traceComponent_, ktl::CancellationToken::None);
+                    co_return value;
+                }
+
+                FileMetadata::SPtr fileMetadataSPtr = nullptr;
+                bool found = metadataTableSPtr->Table->TryGetValue(versionedItemSPtr->GetFileId(), fileMetadataSPtr);
+                if (!found)
+                {
+                    throw ktl::Exception(SF_STATUS_INVALID_OPERATION);
+                }
+
+                STORE_ASSERT(fileMetadataSPtr->CheckpointFileSPtr != nullptr, "Checkpoint file with id {1} does not exist in memory", versionedItemSPtr->GetFileId());
+
+                // The versioned item is left as it is, so the value stays out of the store memory size and sweep never sees it.
+                ValueCacheKey key(fileMetadataSPtr->CheckpointFileSPtr->ValueCacheFileId, versionedItemSPtr->GetOffset());
+                KBuffer::SPtr bytesSPtr = nullptr;
+                bool hit = valueCacheSPtr_->TryGet(key, bytesSPtr);
+                if (!hit)
+                {
+                    bytesSPtr = co_await fileMetadataSPtr->CheckpointFileSPtr->ReadValueAsync(*versionedItemSPtr);
+                    ULONG32 evicted = valueCacheSPtr_->Add(key, *bytesSPtr);
+
+                    if (perfCounters_ != nullptr && evicted > 0)
+                    {
+                        perfCounters_->ValueCacheEvictions.IncrementBy(evicted);
+                    }
+                }
+
+                if (perfCounters_ != nullptr)
+                {
+                    if (hit)
+                    {
+                        perfCounters_->ValueCacheHitRatio.Increment();
+                    }
+
+                    perfCounters_->ValueCacheHitRatioBase.Increment();
+                }
+
+                Utilities::BinaryReader reader(*bytesSPtr, this->GetThisAllocator());
+                co_return valueConverterSPtr_->Read(reader);
+            }
+
             ktl::Awaitable<void> CheckpointAsync(__in ktl::CancellationToken const & cancellationToken)
             {
                 // Acquire prime lock for checkpointing.
@@ -3127,10 +3818,19 @@ namespace Data
                             this->GetThisAllocator(),
                             *traceComponent_,
                             perfCounters_,
-                            true);
+                            true,
+                            valueCompressionCodec_);
 
                         ASSERT_IF(checkpointFileSPtr == nullptr, "Checkpoint file cannot be null");
 
+                        ULONG64 checkpointFileSize = co_await checkpointFileSPtr->GetTotalFileSizeAsync(this->GetThisAllocator());
+                        mergeHelperSPtr_->OnCheckpointFileWritten(checkpointFileSize);
+                        if (perfCounters_ != nullptr)
+                        {
+                            perfCounters_->WriteAmplification.IncrementBy(checkpointFileSize);
+                            perfCounters_->WriteAmplificationBase.IncrementBy(checkpointFileSize);
+                        }
+
                         KSharedPtr<KString> keyFileNameSPtr = nullptr;
                         status = KString::Create(keyFileNameSPtr, this->GetThisAllocator(), fileName);
                         Diagnostics::Validate(status);
@@ -3152,6 +3852,7 @@ namespace Data
                         Diagnostics::Validate(status);
 
                         fileMetadataSPtr->CheckpointFileSPtr = *checkpointFileSPtr;
+                        EnableMappedReads(*fileMetadataSPtr);
 
                         // Populate next metadata table
                         MetadataTable::SPtr tempMetadataTableSPtr = nullptr;
@@ -3313,9 +4014,11 @@ namespace Data
 
                 if (mergeMetadataTableInformationSPtr != nullptr)
                 {
-                    if (mergeMetadataTableInformationSPtr->NewMergedFileSPtr != nullptr)
+                    auto newMergedFilesSPtr = mergeMetadataTableInformationSPtr->NewMergedFilesSPtr;
+                    for (ULONG32 i = 0; i < newMergedFilesSPtr->Count(); i++)
                     {
-                        auto fileMetadataSPtr = mergeMetadataTableInformationSPtr->NewMergedFileSPtr;
+                        auto fileMetadataSPtr = (*newMergedFilesSPtr)[i];
+                        EnableMappedReads(*fileMetadataSPtr);
                         MetadataManager::AddFile(*tmpMetadataTable.Table, fileMetadataSPtr->FileId, *fileMetadataSPtr);
                     }
 
@@ -4525,6 +5228,7 @@ namespace Data
 
                 STORE_ASSERT(isClosing_ == false, "Store should not be closing during recovery");
 
+                recoveryComponentSPtr->MappedReadBudget = mappedFileBudgetSPtr_;
                 co_await recoveryComponentSPtr->RecoverAsync(cancellationToken);
                 auto cachedEstimator = keySizeEstimatorSPtr_.Get();
                 auto averageKeySize = recoveryComponentSPtr->TotalKeyCount > 0 ? recoveryComponentSPtr->TotalKeySize / recoveryComponentSPtr->TotalKeyCount : 0;
@@ -4834,7 +5538,9 @@ namespace Data
                 __in bool useFirstKey,
                 __in TKey & lastKey,
                 __in bool useLastKey,
-                __in ReadMode readMode)
+                __in ReadMode readMode,
+                __in typename IStore<TKey, TValue>::KeyFilterFunctionType keyFilter = typename IStore<TKey, TValue>::KeyFilterFunctionType(),
+                __in typename IStore<TKey, TValue>::ValueReadModeFunctionType valueReadModeSelector = typename IStore<TKey, TValue>::ValueReadModeFunctionType())
             {
                 KSharedPtr<IStoreTransaction<TKey, TValue>> storeTransactionSPtr = &storeTransaction;
                 TKey snapFirstKey = firstKey;
@@ -4850,6 +5556,8 @@ namespace Data
                     *keyEnumerator,
                     *storeTransactionSPtr,
                     readMode,
+                    keyFilter,
+                    valueReadModeSelector,
                     this->GetThisAllocator(),
                     enumeratorSPtr);
                 Diagnostics::Validate(status);
@@ -5398,6 +6106,10 @@ namespace Data
             bool shouldLoadValuesInRecovery_;
             ULONG32 numberOfInflightRecoveryTasks_;
             bool wasCopyAborted_;
+            CompressionCodecId::Enum valueCompressionCodec_;
+            ULONG32 mergeDegreeOfParallelism_;
+            ValueCache::SPtr valueCacheSPtr_ = nullptr;
+            MappedFileBudget::SPtr mappedFileBudgetSPtr_ = nullptr;
             KString::SPtr langTypeInfo_;
             KString::SPtr lang_;
             LONG64 keySize_ = -1;
@@ -5436,6 +6148,8 @@ namespace Data
             shouldLoadValuesInRecovery_(false),
             numberOfInflightRecoveryTasks_(1),
             wasCopyAborted_(false),
+            valueCompressionCodec_(CompressionCodecId::None),
+            mergeDegreeOfParallelism_(1),
             dictionaryChangeHandlerMask_(DictionaryChangeEventMask::Enum::All),
             hasPersistedState_(true)
         {
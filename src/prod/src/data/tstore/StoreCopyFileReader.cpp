@@ -0,0 +1,294 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+using namespace ktl;
+using namespace Data::TStore;
+using namespace Common;
+
+NTSTATUS StoreCopyFileReader::Create(
+    __in KStringView const & filename,
+    __in ULONG32 fileId,
+    __in byte startMarker,
+    __in byte writeMarker,
+    __in byte endMarker,
+    __in ULONG32 chunkSize,
+    __in StoreTraceComponent & traceComponent,
+    __in KAllocator & allocator,
+    __out SPtr & result)
+{
+    NTSTATUS status;
+
+    SPtr output = _new(STORE_COPY_FILE_READER_TAG, allocator) StoreCopyFileReader(
+        filename,
+        fileId,
+        startMarker,
+        writeMarker,
+        endMarker,
+        chunkSize,
+        traceComponent);
+
+    if (!output)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    status = output->Status();
+    if (!NT_SUCCESS(status))
+    {
+        return status;
+    }
+
+    result = Ktl::Move(output);
+    return STATUS_SUCCESS;
+}
+
+StoreCopyFileReader::StoreCopyFileReader(
+    __in KStringView const & filename,
+    __in ULONG32 fileId,
+    __in byte startMarker,
+    __in byte writeMarker,
+    __in byte endMarker,
+    __in ULONG32 chunkSize,
+    __in StoreTraceComponent & traceComponent) :
+    filenameSPtr_(nullptr),
+    fileId_(fileId),
+    startMarker_(startMarker),
+    writeMarker_(writeMarker),
+    endMarker_(endMarker),
+    chunkSize_(chunkSize),
+    fileSPtr_(nullptr),
+    fileStreamSPtr_(nullptr),
+    isPrefetching_(false),
+    prefetchReadTicks_(0),
+    isFirstRead_(true),
+    isStartSent_(false),
+    isCompleted_(false),
+    traceComponent_(&traceComponent)
+{
+    NTSTATUS status = KString::Create(filenameSPtr_, this->GetThisAllocator(), filename);
+    if (!NT_SUCCESS(status))
+    {
+        this->SetConstructorStatus(status);
+    }
+}
+
+StoreCopyFileReader::~StoreCopyFileReader()
+{
+}
+
+void StoreCopyFileReader::StartPrefetch()
+{
+    if (isPrefetching_ || isCompleted_)
+    {
+        return;
+    }
+
+    prefetchAwaitable_ = ReadNextChunkAsync();
+    isPrefetching_ = true;
+}
+
+ktl::Awaitable<OperationData::CSPtr> StoreCopyFileReader::GetNextAsync(
+    __out bool & completed,
+    __out ULONG32 & bytesRead,
+    __out ULONG64 & diskReadTicks)
+{
+    KShared$ApiEntry();
+
+    STORE_ASSERT(!isCompleted_, "Unexpected copy error. File {1} has already been copied", filenameSPtr_->operator LPCWSTR());
+
+    completed = false;
+    bytesRead = 0;
+    diskReadTicks = 0;
+
+    StartPrefetch();
+    isPrefetching_ = false;
+    KBuffer::SPtr chunkSPtr = co_await prefetchAwaitable_;
+    diskReadTicks = prefetchReadTicks_;
+
+    if (!isStartSent_)
+    {
+        isStartSent_ = true;
+        STORE_ASSERT(chunkSPtr != nullptr, "Unexpected copy error. First chunk of file {1} is null", filenameSPtr_->operator LPCWSTR());
+
+        bytesRead = chunkSPtr->QuerySize() - sizeof(ULONG32) - 1;
+
+        // Read the next chunk while this one is being sent.
+        StartPrefetch();
+
+        StoreEventSource::Events->StoreCopyStreamCopyStageCheckpointChunkStart(
+            traceComponent_->PartitionId,
+            traceComponent_->TraceTag,
+            ToStringLiteral(*filenameSPtr_),
+            startMarker_,
+            chunkSPtr->QuerySize(),
+            fileId_);
+
+        co_return CreateOperationData(*chunkSPtr);
+    }
+
+    if (chunkSPtr != nullptr)
+    {
+        bytesRead = chunkSPtr->QuerySize() - 1;
+
+        StartPrefetch();
+
+        StoreEventSource::Events->StoreCopyStreamCopyStageCheckpointChunkWrite(
+            traceComponent_->PartitionId,
+            traceComponent_->TraceTag,
+            ToStringLiteral(*filenameSPtr_),
+            writeMarker_,
+            chunkSPtr->QuerySize());
+
+        co_return CreateOperationData(*chunkSPtr);
+    }
+
+    // There is no more data in the file. Send the end of file marker.
+    isCompleted_ = true;
+    completed = true;
+    co_await CloseAsync();
+
+    KBuffer::SPtr operationDataBufferSPtr;
+    NTSTATUS status = KBuffer::Create(sizeof(byte), operationDataBufferSPtr, GetThisAllocator());
+    Diagnostics::Validate(status);
+
+    byte* data = static_cast<byte *>(operationDataBufferSPtr->GetBuffer());
+    *data = endMarker_;
+
+    StoreEventSource::Events->StoreCopyStreamCopyStageCheckpointChunkEnd(
+        traceComponent_->PartitionId,
+        traceComponent_->TraceTag,
+        ToStringLiteral(*filenameSPtr_),
+        endMarker_);
+
+    co_return CreateOperationData(*operationDataBufferSPtr);
+}
+
+ktl::Awaitable<void> StoreCopyFileReader::CloseAsync()
+{
+    KShared$ApiEntry();
+
+    isCompleted_ = true;
+
+    if (isPrefetching_)
+    {
+        isPrefetching_ = false;
+
+        try
+        {
+            co_await prefetchAwaitable_;
+        }
+        catch (ktl::Exception const &)
+        {
+            // The chunk is discarded, so neither is its failure of interest.
+        }
+    }
+
+    if (fileStreamSPtr_ != nullptr)
+    {
+        NTSTATUS status = co_await fileStreamSPtr_->CloseAsync();
+        Diagnostics::Validate(status);
+        fileStreamSPtr_ = nullptr;
+    }
+
+    if (fileSPtr_ != nullptr)
+    {
+        fileSPtr_->Close();
+        fileSPtr_ = nullptr;
+    }
+}
+
+ktl::Awaitable<void> StoreCopyFileReader::OpenAsync()
+{
+    STORE_ASSERT(File::Exists(filenameSPtr_->operator LPCWSTR()), "Unexpected copy error. Expected file {1} does not exist", filenameSPtr_->operator LPCWSTR());
+
+    StoreEventSource::Events->StoreCopyStreamCopyStageCheckpointChunkOpen(traceComponent_->PartitionId, traceComponent_->TraceTag, ToStringLiteral(*filenameSPtr_));
+
+    KWString pathWString(GetThisAllocator(), *filenameSPtr_);
+    auto createOptions = KBlockFile::CreateOptions::eShareRead | KBlockFile::CreateOptions::eShareWrite | KBlockFile::CreateOptions::eInheritFileSecurity;
+
+    NTSTATUS status = co_await KBlockFile::CreateSparseFileAsync(
+        pathWString,
+        TRUE,
+        KBlockFile::CreateDisposition::eOpenExisting,
+        static_cast<KBlockFile::CreateOptions>(createOptions),
+        fileSPtr_,
+        nullptr,
+        GetThisAllocator(),
+        STORE_COPY_FILE_READER_TAG);
+    STORE_ASSERT(NT_SUCCESS(status), "Unable to open file {1}", filenameSPtr_->operator LPCWSTR());
+
+    status = ktl::io::KFileStream::Create(fileStreamSPtr_, GetThisAllocator());
+    Diagnostics::Validate(status);
+
+    status = co_await fileStreamSPtr_->OpenAsync(*fileSPtr_);
+    STORE_ASSERT(NT_SUCCESS(status), "Unable to open file stream for file {1}", filenameSPtr_->operator LPCWSTR());
+}
+
+ktl::Awaitable<KBuffer::SPtr> StoreCopyFileReader::ReadNextChunkAsync()
+{
+    KShared$ApiEntry();
+
+    if (fileStreamSPtr_ == nullptr)
+    {
+        co_await OpenAsync();
+    }
+
+    // The start operation also carries the file id; every chunk ends with its operation marker.
+    bool isFirstChunk = isFirstRead_;
+    isFirstRead_ = false;
+    ULONG trailerSize = isFirstChunk ? sizeof(ULONG32) + 1 : 1;
+
+    KBuffer::SPtr chunkSPtr = nullptr;
+    NTSTATUS status = KBuffer::Create(chunkSize_ + trailerSize, chunkSPtr, GetThisAllocator(), STORE_COPY_FILE_READER_TAG);
+    Diagnostics::Validate(status);
+
+    ULONG bytesRead = 0;
+    Stopwatch readWatch;
+    readWatch.Start();
+    status = co_await fileStreamSPtr_->ReadAsync(*chunkSPtr, bytesRead, 0, chunkSize_);
+    readWatch.Stop();
+    prefetchReadTicks_ = static_cast<ULONG64>(readWatch.ElapsedTicks);
+    STORE_ASSERT(NT_SUCCESS(status), "Unable to read chunk of file stream for file {1}", filenameSPtr_->operator LPCWSTR());
+
+    if (bytesRead == 0 && !isFirstChunk)
+    {
+        co_return nullptr;
+    }
+
+    if (bytesRead < chunkSize_)
+    {
+        // Only the last chunk of a file is short; trim it so the marker is the last byte of the operation.
+        KBuffer::SPtr trimmedChunkSPtr = nullptr;
+        status = KBuffer::Create(bytesRead + trailerSize, trimmedChunkSPtr, GetThisAllocator(), STORE_COPY_FILE_READER_TAG);
+        Diagnostics::Validate(status);
+
+        trimmedChunkSPtr->CopyFrom(0, *chunkSPtr, 0, bytesRead);
+        chunkSPtr = Ktl::Move(trimmedChunkSPtr);
+    }
+
+    byte* data = static_cast<byte *>(chunkSPtr->GetBuffer());
+    if (isFirstChunk)
+    {
+        memcpy(data + bytesRead, &fileId_, sizeof(ULONG32));
+        data[bytesRead + sizeof(ULONG32)] = startMarker_;
+    }
+    else
+    {
+        data[bytesRead] = writeMarker_;
+    }
+
+    co_return chunkSPtr;
+}
+
+OperationData::CSPtr StoreCopyFileReader::CreateOperationData(__in KBuffer & buffer)
+{
+    OperationData::SPtr resultSPtr = OperationData::Create(GetThisAllocator());
+    resultSPtr->Append(buffer);
+
+    OperationData::CSPtr resultCSPtr = resultSPtr.RawPtr();
+    return resultCSPtr;
+}
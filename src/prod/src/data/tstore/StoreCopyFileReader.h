@@ -0,0 +1,101 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+#define STORE_COPY_FILE_READER_TAG 'rfCS'
+
+namespace Data
+{
+    namespace TStore
+    {
+        //
+        // Turns one checkpoint file into the copy operations that ship it: a start operation carrying the first chunk,
+        // write operations for the remaining chunks and an end operation.
+        // The next chunk is read while the previous one is being sent, so disk reads overlap with the network.
+        // At most one read is outstanding per file.
+        //
+        class StoreCopyFileReader
+            : public KObject<StoreCopyFileReader>
+            , public KShared<StoreCopyFileReader>
+        {
+            K_FORCE_SHARED(StoreCopyFileReader)
+
+        public:
+            static NTSTATUS Create(
+                __in KStringView const & filename,
+                __in ULONG32 fileId,
+                __in byte startMarker,
+                __in byte writeMarker,
+                __in byte endMarker,
+                __in ULONG32 chunkSize,
+                __in StoreTraceComponent & traceComponent,
+                __in KAllocator & allocator,
+                __out SPtr & result);
+
+            __declspec(property(get = get_StartMarker)) byte StartMarker;
+            byte get_StartMarker() const
+            {
+                return startMarker_;
+            }
+
+            //
+            // Opens the file and starts reading its first chunk, if that has not been started yet.
+            //
+            void StartPrefetch();
+
+            //
+            // Returns the next copy operation of the file. Completed is set with the end operation, after which the file is closed.
+            // BytesRead is the number of file bytes carried by the operation and DiskReadTicks the time spent reading them from disk,
+            // which is not the time GetNextAsync waited for them when the read was made ahead.
+            //
+            ktl::Awaitable<OperationData::CSPtr> GetNextAsync(
+                __out bool & completed,
+                __out ULONG32 & bytesRead,
+                __out ULONG64 & diskReadTicks);
+
+            //
+            // Waits for any outstanding read and closes the file.
+            //
+            ktl::Awaitable<void> CloseAsync();
+
+        private:
+            ktl::Awaitable<KBuffer::SPtr> ReadNextChunkAsync();
+            ktl::Awaitable<void> OpenAsync();
+
+            OperationData::CSPtr CreateOperationData(__in KBuffer & buffer);
+
+            StoreCopyFileReader(
+                __in KStringView const & filename,
+                __in ULONG32 fileId,
+                __in byte startMarker,
+                __in byte writeMarker,
+                __in byte endMarker,
+                __in ULONG32 chunkSize,
+                __in StoreTraceComponent & traceComponent);
+
+            KString::SPtr filenameSPtr_;
+            ULONG32 fileId_;
+            byte startMarker_;
+            byte writeMarker_;
+            byte endMarker_;
+            ULONG32 chunkSize_;
+
+            KBlockFile::SPtr fileSPtr_;
+            ktl::io::KFileStream::SPtr fileStreamSPtr_;
+
+            // Read of the next chunk. Only valid while isPrefetching_ is set; a null chunk marks the end of the file.
+            ktl::Awaitable<KBuffer::SPtr> prefetchAwaitable_;
+            bool isPrefetching_;
+            // Disk read time of the chunk read by prefetchAwaitable_
+            ULONG64 prefetchReadTicks_;
+            bool isFirstRead_;
+            bool isStartSent_;
+            bool isCompleted_;
+
+            StoreTraceComponent::SPtr traceComponent_;
+        };
+    }
+}
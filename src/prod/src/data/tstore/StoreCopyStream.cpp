@@ -10,6 +10,7 @@ using namespace Data::TStore;
 using namespace Common;
 
 ULONG32 StoreCopyStream::CopyChunkSize = 500 * 1024;
+ULONG32 StoreCopyStream::MaxFilesInFlight = 4;
 
 NTSTATUS StoreCopyStream::Create(
     __in IStoreCopyProvider & copyProvider,
@@ -48,15 +49,19 @@ StoreCopyStream::StoreCopyStream(
     copyStage_(CopyStage::Enum::Version),
     snapshotOfMetadataTableSPtr_(nullptr),
     snapshotOfMetadataTableEnumeratorSPtr_(nullptr),
-    currentFileStreamSPtr_(nullptr),
-    copyDataBufferSPtr_(nullptr),
+    fileReadersSPtr_(nullptr),
     isClosed_(false),
     traceComponent_(&traceComponent),
     perfCounterWriter_(perfCounters)
 {
-    ULONG bufferSize = CopyChunkSize + sizeof(ULONG32) + 1;
-    NTSTATUS status = KBuffer::Create(bufferSize, copyDataBufferSPtr_, this->GetThisAllocator());
-    Diagnostics::Validate(status);
+    fileReadersSPtr_ = _new(STORE_COPY_STREAM_TAG, this->GetThisAllocator()) KSharedArray<StoreCopyFileReader::SPtr>();
+    if (!fileReadersSPtr_)
+    {
+        this->SetConstructorStatus(STATUS_INSUFFICIENT_RESOURCES);
+        return;
+    }
+
+    this->SetConstructorStatus(fileReadersSPtr_->Status());
 }
 
 StoreCopyStream::~StoreCopyStream()
@@ -93,13 +98,9 @@ ktl::Awaitable<NTSTATUS> StoreCopyStream::GetNextAsync(
             break;
         }
         case CopyStage::Enum::KeyFile:
-        {
-            result = co_await OnCopyStageKeyFileAsync();
-            break;
-        }
         case CopyStage::Enum::ValueFile:
         {
-            result = co_await OnCopyStageValueFileAsync();
+            result = co_await OnCopyStageCheckpointFileAsync();
             break;
         }
         case CopyStage::Enum::Complete:
@@ -136,18 +137,15 @@ ktl::Awaitable<void> StoreCopyStream::CloseAsync()
         }
 
         copyProviderSPtr_ = nullptr;
-        if (currentFileStreamSPtr_ != nullptr)
-        {
-            NTSTATUS status = co_await currentFileStreamSPtr_->CloseAsync();
-            Diagnostics::Validate(status);
-            currentFileStreamSPtr_ = nullptr;
-        }
 
-        if (currentFileSPtr_ != nullptr)
+        // Readers may still have a chunk read outstanding; wait for it before the files are closed.
+        for (ULONG i = 0; i < fileReadersSPtr_->Count(); i++)
         {
-            currentFileSPtr_->Close();
+            co_await (*fileReadersSPtr_)[i]->CloseAsync();
         }
 
+        fileReadersSPtr_->Clear();
+
         snapshotOfMetadataTableEnumeratorSPtr_ = nullptr;
 
         if (snapshotOfMetadataTableSPtr_ != nullptr)
@@ -242,15 +240,11 @@ ktl::Awaitable<OperationData::CSPtr> StoreCopyStream::OnCopyStageMetadataTableAs
         // Consistency checks.
         STORE_ASSERT(snapshotOfMetadataTableSPtr_ != nullptr, "Unexpected copy error. Master table to be copied is null.");
 
+        // Start reading the first checkpoint files while the metadata table is being sent.
+        QueueFileReaders();
+
         // Next copy stage
-        if (snapshotOfMetadataTableEnumeratorSPtr_->MoveNext())
-        {
-            copyStage_ = CopyStage::Enum::KeyFile;
-        }
-        else
-        {
-            copyStage_ = CopyStage::Enum::Complete;
-        }
+        SetCheckpointFileCopyStage();
 
         MemoryBuffer::SPtr memoryStream = nullptr;
         auto status = MemoryBuffer::Create(GetThisAllocator(), memoryStream);
@@ -288,79 +282,38 @@ ktl::Awaitable<OperationData::CSPtr> StoreCopyStream::OnCopyStageMetadataTableAs
     }
 }
 
-ktl::Awaitable<OperationData::CSPtr> StoreCopyStream::OnCopyStageKeyFileAsync()
+ktl::Awaitable<OperationData::CSPtr> StoreCopyStream::OnCopyStageCheckpointFileAsync()
 {
     SharedException::CSPtr exceptionCSPtr = nullptr;
 
-    try 
+    try
     {
-        auto shortFileName = snapshotOfMetadataTableEnumeratorSPtr_->Current().Value->FileName;
-        auto keyCheckpointFilePath = GetKeyCheckpointFilePath(*shortFileName);
-
-        byte copyOperationStartKeyFile = StoreCopyOperation::Enum::StartKeyFile;
-        byte copyOperationWriteKeyFile = StoreCopyOperation::Enum::WriteKeyFile;
-        byte copyOperationEndKeyFile = StoreCopyOperation::Enum::EndKeyFile;
+        STORE_ASSERT(fileReadersSPtr_->Count() > 0, "Unexpected copy error. No checkpoint file to copy in stage {1}", static_cast<int>(copyStage_));
+        StoreCopyFileReader::SPtr fileReaderSPtr = (*fileReadersSPtr_)[0];
 
         bool completed = false;
-        auto operationData = co_await CreateCheckpointFileChunkOperationData(*keyCheckpointFilePath, copyOperationStartKeyFile, copyOperationWriteKeyFile, copyOperationEndKeyFile, completed);
+        ULONG32 bytesRead = 0;
+        ULONG64 diskReadTicks = 0;
 
-        // CreateCheckpointFileChunkOperationData will set completed to true if there is no more data to transmit
-        if (completed)
-        {
-            copyStage_ = CopyStage::Enum::ValueFile;
-        }
+        // The chunk was usually read while the previous operation was sent, so the disk read is timed by the reader rather than the wait here.
+        auto operationData = co_await fileReaderSPtr->GetNextAsync(completed, bytesRead, diskReadTicks);
+        perfCounterWriter_.AddMeasurement(bytesRead, diskReadTicks);
 
-        co_return operationData;
-    }
-    catch (ktl::Exception const & e)
-    {
-        TraceException(L"OnCopyStageKeyFileAsync", e);
-        exceptionCSPtr = SharedException::Create(e, GetThisAllocator());
-    }
-
-    if (exceptionCSPtr != nullptr)
-    {
-        co_await CloseAsync();
-        auto exec = exceptionCSPtr->Info;
-        throw exec;
-    }
-}
-
-ktl::Awaitable<OperationData::CSPtr> StoreCopyStream::OnCopyStageValueFileAsync()
-{
-    SharedException::CSPtr exceptionCSPtr = nullptr;
-
-    try {
-        auto shortFileName = snapshotOfMetadataTableEnumeratorSPtr_->Current().Value->FileName;
-        auto valueCheckpointFilePath = GetValueCheckpointFilePath(*shortFileName);
-
-        byte copyOperationStartValueFile = StoreCopyOperation::Enum::StartValueFile;
-        byte copyOperationWriteValueFile = StoreCopyOperation::Enum::WriteValueFile;
-        byte copyOperationEndValueFile = StoreCopyOperation::Enum::EndValueFile;
-
-        bool completed = false;
-        auto operationData = co_await CreateCheckpointFileChunkOperationData(*valueCheckpointFilePath, copyOperationStartValueFile, copyOperationWriteValueFile, copyOperationEndValueFile, completed);
-
-        // CreateCheckpointFileChunkOperationData will set completed to true if there is no more data to transmit
+        // GetNextAsync will set completed to true once the end of file operation is returned
         if (completed)
         {
-            // Check if the are more files
-            if (snapshotOfMetadataTableEnumeratorSPtr_->MoveNext())
-            {
-                // More files
-                copyStage_ = CopyStage::Enum::KeyFile;
-            }
-            else
-            {
-                copyStage_ = CopyStage::Enum::Complete;
-            }
+            BOOLEAN removed = fileReadersSPtr_->Remove(0);
+            STORE_ASSERT(removed == TRUE, "Unexpected copy error. Failed to remove the copied file reader");
+
+            QueueFileReaders();
+            SetCheckpointFileCopyStage();
         }
 
         co_return operationData;
     }
     catch (ktl::Exception const & e)
     {
-        TraceException(L"OnCopyStageValueFileAsync", e);
+        TraceException(L"OnCopyStageCheckpointFileAsync", e);
         exceptionCSPtr = SharedException::Create(e, GetThisAllocator());
     }
 
@@ -452,161 +405,70 @@ KString::SPtr StoreCopyStream::GetValueCheckpointFilePath(__in KStringView & fil
     return filepath;
 }
 
-ktl::Awaitable<KBlockFile::SPtr> StoreCopyStream::OpenFileAsync(__in KStringView & filename)
+void StoreCopyStream::QueueFileReaders()
 {
-    ktl::io::KFileStream::SPtr fileStreamSPtr = nullptr;
-    KWString pathWString(GetThisAllocator(), filename);
-    KBlockFile::SPtr blockFileSPtr;
-    
-    auto createOptions = KBlockFile::CreateOptions::eShareRead | KBlockFile::CreateOptions::eShareWrite | KBlockFile::CreateOptions::eInheritFileSecurity;
+    ULONG32 maxFilesInFlight = MaxFilesInFlight > 0 ? MaxFilesInFlight : 1;
 
-    try
+    // Files are queued in pairs, key file then value file, in the order the metadata table enumerates them.
+    while (fileReadersSPtr_->Count() < maxFilesInFlight && snapshotOfMetadataTableEnumeratorSPtr_->MoveNext())
     {
-        auto status = co_await KBlockFile::CreateSparseFileAsync(
-            pathWString,
-            TRUE,
-            KBlockFile::CreateDisposition::eOpenExisting,
-            static_cast<KBlockFile::CreateOptions>(createOptions),
-            blockFileSPtr,
-            nullptr,
+        FileMetadata::SPtr fileMetadataSPtr = snapshotOfMetadataTableEnumeratorSPtr_->Current().Value;
+        auto shortFileName = fileMetadataSPtr->FileName;
+
+        StoreCopyFileReader::SPtr keyFileReaderSPtr = nullptr;
+        NTSTATUS status = StoreCopyFileReader::Create(
+            *GetKeyCheckpointFilePath(*shortFileName),
+            fileMetadataSPtr->FileId,
+            StoreCopyOperation::Enum::StartKeyFile,
+            StoreCopyOperation::Enum::WriteKeyFile,
+            StoreCopyOperation::Enum::EndKeyFile,
+            CopyChunkSize,
+            *traceComponent_,
             GetThisAllocator(),
-            STORE_COPY_STREAM_TAG);
+            keyFileReaderSPtr);
+        Diagnostics::Validate(status);
 
-        STORE_ASSERT(NT_SUCCESS(status), "Unable to open file {1}", filename.operator LPCWSTR());
-    }
-    catch (ktl::Exception const &)
-    {
-        if (blockFileSPtr != nullptr)
-        {
-            blockFileSPtr->Close();
-        }
+        StoreCopyFileReader::SPtr valueFileReaderSPtr = nullptr;
+        status = StoreCopyFileReader::Create(
+            *GetValueCheckpointFilePath(*shortFileName),
+            fileMetadataSPtr->FileId,
+            StoreCopyOperation::Enum::StartValueFile,
+            StoreCopyOperation::Enum::WriteValueFile,
+            StoreCopyOperation::Enum::EndValueFile,
+            CopyChunkSize,
+            *traceComponent_,
+            GetThisAllocator(),
+            valueFileReaderSPtr);
+        Diagnostics::Validate(status);
 
-        throw;
+        status = fileReadersSPtr_->Append(keyFileReaderSPtr);
+        Diagnostics::Validate(status);
+        status = fileReadersSPtr_->Append(valueFileReaderSPtr);
+        Diagnostics::Validate(status);
     }
 
-    co_return blockFileSPtr;
+    for (ULONG i = 0; i < fileReadersSPtr_->Count() && i < maxFilesInFlight; i++)
+    {
+        (*fileReadersSPtr_)[i]->StartPrefetch();
+    }
 }
 
-ktl::Awaitable<OperationData::CSPtr> StoreCopyStream::CreateCheckpointFileChunkOperationData(
-    __in KStringView & filename,
-    __in byte startMarker,
-    __in byte writeMarker,
-    __in byte endMarker,
-    __out bool & completed)
+void StoreCopyStream::SetCheckpointFileCopyStage()
 {
-    KString::SPtr filenameSPtr = nullptr;
-    KString::Create(filenameSPtr, GetThisAllocator(), filename);
-
-    ULONG bytesRead = 0;
-
-    completed = false;
-
-    // If we don't have the current file stream opened, this is the first table chunk.
-    if (currentFileStreamSPtr_ == nullptr)
+    if (fileReadersSPtr_->Count() == 0)
     {
-        STORE_ASSERT(File::Exists(filenameSPtr->operator LPCWSTR()), "Unexpected copy error. Expected file {1} does not exist", filenameSPtr->operator LPCWSTR());
-
-        StoreEventSource::Events->StoreCopyStreamCopyStageCheckpointChunkOpen(traceComponent_->PartitionId, traceComponent_->TraceTag, ToStringLiteral(*filenameSPtr));
-
-        currentFileSPtr_ = co_await OpenFileAsync(*filenameSPtr);
-        ktl::io::KFileStream::Create(currentFileStreamSPtr_, GetThisAllocator());
-        NTSTATUS status = co_await currentFileStreamSPtr_->OpenAsync(*currentFileSPtr_);
-        STORE_ASSERT(NT_SUCCESS(status), "Unable to open file stream for file {1}", filename.operator LPCWSTR());
-
-        // Send the start of file operation data.
-        perfCounterWriter_.StartMeasurement();
-        status = co_await currentFileStreamSPtr_->ReadAsync(*copyDataBufferSPtr_, bytesRead, 0, CopyChunkSize);
-        perfCounterWriter_.StopMeasurement(bytesRead);
-        STORE_ASSERT(NT_SUCCESS(status), "Unable to read start of file stream for file {1}", filenameSPtr->operator LPCWSTR());
-
-        MemoryBuffer::SPtr streamSPtr = nullptr;
-        status = MemoryBuffer::Create(*copyDataBufferSPtr_, GetThisAllocator(), streamSPtr);
-        Diagnostics::Validate(status);
-        streamSPtr->Position = bytesRead;
-
-        auto filemetaDataSPtr = snapshotOfMetadataTableEnumeratorSPtr_->Current().Value;
-        status = co_await streamSPtr->WriteAsync(filemetaDataSPtr->FileId);
-        STORE_ASSERT(NT_SUCCESS(status), "Unable to write file ID {1} for file {2} to in-memory stream", filemetaDataSPtr->FileId, filenameSPtr->operator LPCWSTR());
-
-        status = co_await streamSPtr->WriteAsync(startMarker);
-        STORE_ASSERT(NT_SUCCESS(status), "Unable to write start marker {1} for file {2} to in-memory stream", startMarker, filenameSPtr->operator LPCWSTR());
-
-        StoreEventSource::Events->StoreCopyStreamCopyStageCheckpointChunkStart(
-            traceComponent_->PartitionId,
-            traceComponent_->TraceTag,
-            ToStringLiteral(*filenameSPtr),
-            startMarker,
-            bytesRead + sizeof(ULONG32) + 1,
-            filemetaDataSPtr->FileId);
-
-        KBuffer::SPtr operationDataBufferSPtr;
-        status = KBuffer::CreateOrCopyFrom(operationDataBufferSPtr, *copyDataBufferSPtr_, 0, bytesRead + sizeof(ULONG32) + 1, GetThisAllocator());
-        Diagnostics::Validate(status);
-
-        OperationData::SPtr resultSPtr = OperationData::Create(GetThisAllocator());
-        resultSPtr->Append(*operationDataBufferSPtr);
-
-        OperationData::CSPtr resultCSPtr = resultSPtr.RawPtr();
-        co_return resultCSPtr;
+        copyStage_ = CopyStage::Enum::Complete;
+        return;
     }
 
-    // The start of the current file has been sent. Check if there are more chunks to be sent (if the stream is at the end, this will return zero).
-    perfCounterWriter_.StartMeasurement();
-    auto status = co_await currentFileStreamSPtr_->ReadAsync(*copyDataBufferSPtr_, bytesRead, 0, CopyChunkSize);
-    perfCounterWriter_.StopMeasurement(bytesRead);
-    STORE_ASSERT(NT_SUCCESS(status), "Unable to read chunk of file stream for file {1}", filenameSPtr->operator LPCWSTR());
-
-    if (bytesRead > 0)
+    if ((*fileReadersSPtr_)[0]->StartMarker == StoreCopyOperation::Enum::StartKeyFile)
     {
-        // Send the partial table file operation data
-        byte* data = static_cast<byte *>(copyDataBufferSPtr_->GetBuffer());
-        data[bytesRead] = writeMarker;
-
-        StoreEventSource::Events->StoreCopyStreamCopyStageCheckpointChunkWrite(
-            traceComponent_->PartitionId,
-            traceComponent_->TraceTag,
-            ToStringLiteral(*filenameSPtr),
-            writeMarker,
-            bytesRead + 1);
-
-        KBuffer::SPtr operationDataBufferSPtr;
-        auto lStatus = KBuffer::CreateOrCopyFrom(operationDataBufferSPtr, *copyDataBufferSPtr_, 0, bytesRead + 1, GetThisAllocator());
-        Diagnostics::Validate(lStatus);
-
-        OperationData::SPtr resultSPtr = OperationData::Create(GetThisAllocator());
-        resultSPtr->Append(*operationDataBufferSPtr);
-
-        OperationData::CSPtr resultCSPtr = resultSPtr.RawPtr();
-        co_return resultCSPtr;
+        copyStage_ = CopyStage::Enum::KeyFile;
+    }
+    else
+    {
+        copyStage_ = CopyStage::Enum::ValueFile;
     }
-
-    // There is no more data in the current file. Send the end of file marker
-    status = co_await currentFileStreamSPtr_->CloseAsync();
-    Diagnostics::Validate(status);
-    currentFileStreamSPtr_ = nullptr;
-    currentFileSPtr_->Close();
-    currentFileSPtr_ = nullptr;
-    completed = true;
-
-    KBuffer::SPtr operationDataBufferSPtr;
-    status = KBuffer::Create(sizeof(byte), operationDataBufferSPtr, GetThisAllocator());
-    Diagnostics::Validate(status);
-
-    byte* data = static_cast<byte *>(operationDataBufferSPtr->GetBuffer());
-    *data = endMarker;
-
-    StoreEventSource::Events->StoreCopyStreamCopyStageCheckpointChunkEnd(
-        traceComponent_->PartitionId,
-        traceComponent_->TraceTag,
-        ToStringLiteral(*filenameSPtr),
-        endMarker);
-     
-    // Send the end of file operation data
-    OperationData::SPtr resultSPtr = OperationData::Create(GetThisAllocator());
-    resultSPtr->Append(*operationDataBufferSPtr);
-
-    OperationData::CSPtr resultCSPtr = resultSPtr.RawPtr();
-    co_return resultCSPtr;
 }
 
 void StoreCopyStream::TraceException(__in KStringView const & methodName, __in ktl::Exception const & exception)
@@ -19,6 +19,12 @@ namespace Data
         public:
             static ULONG32 CopyChunkSize; // Exposed for testing, normally 500KB
 
+            //
+            // Number of checkpoint files read ahead of the file being sent, counting that file. Each holds at most one chunk.
+            // Exposed for testing, normally 4.
+            //
+            static ULONG32 MaxFilesInFlight;
+
             static NTSTATUS Create(
                 __in IStoreCopyProvider & copyProvider,
                 __in StoreTraceComponent & traceComponent,
@@ -62,21 +68,15 @@ namespace Data
         private:
             ktl::Awaitable<OperationData::CSPtr> OnCopyStageVersionAsync();
             ktl::Awaitable<OperationData::CSPtr> OnCopyStageMetadataTableAsync();
-            ktl::Awaitable<OperationData::CSPtr> OnCopyStageKeyFileAsync();
-            ktl::Awaitable<OperationData::CSPtr> OnCopyStageValueFileAsync();
+            ktl::Awaitable<OperationData::CSPtr> OnCopyStageCheckpointFileAsync();
             ktl::Awaitable<OperationData::CSPtr> OnCopyStageCompleteAsync();
             
             KString::SPtr CombineWithWorkingDirectoryPath(__in KStringView & filename);
             KString::SPtr GetKeyCheckpointFilePath(__in KStringView & filename);
             KString::SPtr GetValueCheckpointFilePath(__in KStringView & filename);
 
-            ktl::Awaitable<KBlockFile::SPtr> OpenFileAsync(__in KStringView & filename);
-            ktl::Awaitable<OperationData::CSPtr> CreateCheckpointFileChunkOperationData(
-                __in KStringView & filename, 
-                __in byte startMarker, 
-                __in byte writeMarker, 
-                __in byte endMarker,
-                __out bool & completed);
+            void QueueFileReaders();
+            void SetCheckpointFileCopyStage();
 
             void TraceException(__in KStringView const & methodName, __in ktl::Exception const & exception);
 
@@ -89,9 +89,9 @@ namespace Data
             CopyStage::Enum copyStage_;
             MetadataTable::SPtr snapshotOfMetadataTableSPtr_;
             IEnumerator<KeyValuePair<ULONG32, FileMetadata::SPtr>>::SPtr snapshotOfMetadataTableEnumeratorSPtr_;
-            ktl::io::KFileStream::SPtr currentFileStreamSPtr_;
-            KBlockFile::SPtr currentFileSPtr_;
-            KBuffer::SPtr copyDataBufferSPtr_;
+
+            // Readers of the files still to be sent, in the order they are sent. The first one is being sent, the others are prefetching.
+            KSharedArray<StoreCopyFileReader::SPtr>::SPtr fileReadersSPtr_;
             bool isClosed_;
 
             StoreTraceComponent::SPtr traceComponent_;
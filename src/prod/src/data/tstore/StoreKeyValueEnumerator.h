@@ -28,10 +28,12 @@ namespace Data
                 __in IEnumerator<TKey> & keys,
                 __in IStoreTransaction<TKey, TValue> & storeTransaction,
                 __in ReadMode readMode,
+                __in typename IStore<TKey, TValue>::KeyFilterFunctionType keyFilter,
+                __in typename IStore<TKey, TValue>::ValueReadModeFunctionType valueReadModeSelector,
                 __in KAllocator & allocator,
                 __out KSharedPtr<IAsyncEnumerator<KeyValuePair<TKey, KeyValuePair<LONG64, TValue>>>> & result)
             {
-                result = _new(COMPONENTKEYENUMERATOR_TAG, allocator) StoreKeyValueEnumerator(store, keyComparer, keys, storeTransaction, readMode);
+                result = _new(COMPONENTKEYENUMERATOR_TAG, allocator) StoreKeyValueEnumerator(store, keyComparer, keys, storeTransaction, readMode, keyFilter, valueReadModeSelector);
                 if (!result)
                 {
                     return STATUS_INSUFFICIENT_RESOURCES;
@@ -69,6 +71,19 @@ namespace Data
                         continue;
                     }
 
+                    // Rejected keys are skipped before they are locked or their values are read.
+                    if (keyFilter_ && !keyFilter_(key))
+                    {
+                        cancellationToken.ThrowIfCancellationRequested();
+                        continue;
+                    }
+
+                    ReadMode readMode = readMode_;
+                    if (valueReadModeSelector_)
+                    {
+                        readMode = valueReadModeSelector_(key);
+                    }
+
                     KSharedPtr<Store<TKey, TValue>> storeSPtr = static_cast<Store<TKey, TValue> *>(storeSPtr_.RawPtr());
 
                     KeyValuePair<LONG64, TValue> kvpair;
@@ -77,7 +92,7 @@ namespace Data
                         key, 
                         Common::TimeSpan::FromSeconds(Constants::EnumerationGetValueTimeoutSeconds), 
                         kvpair, 
-                        readMode_,
+                        readMode,
                         ktl::CancellationToken::None);
 
                     if (exists)
@@ -117,12 +132,16 @@ namespace Data
                 __in IComparer<TKey> & keyComparer,
                 __in IEnumerator<TKey> & keys,
                 __in IStoreTransaction<TKey, TValue> & storeTransaction,
-                __in ReadMode readMode) :
+                __in ReadMode readMode,
+                __in typename IStore<TKey, TValue>::KeyFilterFunctionType keyFilter,
+                __in typename IStore<TKey, TValue>::ValueReadModeFunctionType valueReadModeSelector) :
                 keysEnumeratorSPtr_(&keys),
                 storeTransactionSPtr_(&storeTransaction),
                 storeSPtr_(&store),
                 keyComparerSPtr_(&keyComparer),
-                readMode_(readMode)
+                readMode_(readMode),
+                keyFilter_(keyFilter),
+                valueReadModeSelector_(valueReadModeSelector)
             {
             }
 
@@ -131,6 +150,8 @@ namespace Data
             KSharedPtr<IStore<TKey, TValue>> storeSPtr_;
             KSharedPtr<IComparer<TKey>> keyComparerSPtr_;
             ReadMode readMode_;
+            typename IStore<TKey, TValue>::KeyFilterFunctionType keyFilter_;
+            typename IStore<TKey, TValue>::ValueReadModeFunctionType valueReadModeSelector_;
 
             bool isDone_ = false;
             KeyValuePair<TKey, KeyValuePair<LONG64, TValue>> current_;
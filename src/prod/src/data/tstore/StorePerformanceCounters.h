@@ -46,6 +46,47 @@ namespace Data
                     Common::PerformanceCounterType::RawData64,
                     L"Store Copy Disk Transfer Bytes/sec",
                     L"Number of disk bytes read (on primary) or written (on secondary) per second on store copy")
+                COUNTER_DEFINITION_WITH_BASE(
+                    6,
+                    7,
+                    Common::PerformanceCounterType::RawFraction64,
+                    L"Key Checkpoint File Bloom Filter False Positive Rate",
+                    L"Fraction of key checkpoint file bloom filter probes for absent keys that returned a false positive")
+                COUNTER_DEFINITION(
+                    7,
+                    Common::PerformanceCounterType::RawBase64,
+                    L"Key Checkpoint File Bloom Filter False Positive Rate Base",
+                    L"Number of key checkpoint file bloom filter probes for keys known to be absent from the file",
+                    noDisplay)
+                COUNTER_DEFINITION_WITH_BASE(
+                    8,
+                    9,
+                    Common::PerformanceCounterType::RawFraction64,
+                    L"Value Cache Hit Ratio",
+                    L"Fraction of value loads by the store that were served from the shared value cache")
+                COUNTER_DEFINITION(
+                    9,
+                    Common::PerformanceCounterType::RawBase64,
+                    L"Value Cache Hit Ratio Base",
+                    L"Number of value loads by the store that consulted the shared value cache",
+                    noDisplay)
+                COUNTER_DEFINITION(
+                    10,
+                    Common::PerformanceCounterType::RawData64,
+                    L"Value Cache Evictions",
+                    L"Number of values evicted from the shared value cache to make room for values loaded by the store")
+                COUNTER_DEFINITION_WITH_BASE(
+                    11,
+                    12,
+                    Common::PerformanceCounterType::RawFraction64,
+                    L"Checkpoint File Write Amplification",
+                    L"Bytes written to checkpoint files by checkpoints and merges, as a percentage of the bytes written by checkpoints alone")
+                COUNTER_DEFINITION(
+                    12,
+                    Common::PerformanceCounterType::RawBase64,
+                    L"Checkpoint File Write Amplification Base",
+                    L"Number of bytes written to checkpoint files by checkpoints",
+                    noDisplay)
             END_COUNTER_SET_DEFINITION()
 
             DECLARE_COUNTER_INSTANCE(ItemCount)
@@ -53,6 +94,13 @@ namespace Data
             DECLARE_COUNTER_INSTANCE(MemorySize)
             DECLARE_COUNTER_INSTANCE(CheckpointFileWriteBytesPerSec)
             DECLARE_COUNTER_INSTANCE(CopyDiskTransferBytesPerSec)
+            DECLARE_COUNTER_INSTANCE(BloomFilterFalsePositiveRate)
+            DECLARE_COUNTER_INSTANCE(BloomFilterFalsePositiveRateBase)
+            DECLARE_COUNTER_INSTANCE(ValueCacheHitRatio)
+            DECLARE_COUNTER_INSTANCE(ValueCacheHitRatioBase)
+            DECLARE_COUNTER_INSTANCE(ValueCacheEvictions)
+            DECLARE_COUNTER_INSTANCE(WriteAmplification)
+            DECLARE_COUNTER_INSTANCE(WriteAmplificationBase)
 
             BEGIN_COUNTER_SET_INSTANCE(StorePerformanceCounters)
                 DEFINE_COUNTER_INSTANCE(ItemCount, 1)
@@ -60,6 +108,13 @@ namespace Data
                 DEFINE_COUNTER_INSTANCE(MemorySize, 3)
                 DEFINE_COUNTER_INSTANCE(CheckpointFileWriteBytesPerSec, 4)
                 DEFINE_COUNTER_INSTANCE(CopyDiskTransferBytesPerSec, 5)
+                DEFINE_COUNTER_INSTANCE(BloomFilterFalsePositiveRate, 6)
+                DEFINE_COUNTER_INSTANCE(BloomFilterFalsePositiveRateBase, 7)
+                DEFINE_COUNTER_INSTANCE(ValueCacheHitRatio, 8)
+                DEFINE_COUNTER_INSTANCE(ValueCacheHitRatioBase, 9)
+                DEFINE_COUNTER_INSTANCE(ValueCacheEvictions, 10)
+                DEFINE_COUNTER_INSTANCE(WriteAmplification, 11)
+                DEFINE_COUNTER_INSTANCE(WriteAmplificationBase, 12)
             END_COUNTER_SET_INSTANCE()
 
         public:
@@ -0,0 +1,798 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+#define STOREWORKLOADPERFTESTBASE_TAG 'lwTS'
+
+#include <fstream>
+#include <iomanip>
+
+namespace TStoreTests
+{
+    using namespace ktl;
+    using namespace Data;
+    using namespace Data::TStore;
+
+    namespace WorkloadOperation
+    {
+        enum Enum
+        {
+            Read = 0,
+            Update = 1,
+            Insert = 2,
+            Scan = 3,
+            ReadModifyWrite = 4,
+            Count = 5
+        };
+
+        inline char const * ToString(__in Enum operation)
+        {
+            switch (operation)
+            {
+            case Read: return "read";
+            case Update: return "update";
+            case Insert: return "insert";
+            case Scan: return "scan";
+            case ReadModifyWrite: return "readModifyWrite";
+            default: return "unknown";
+            }
+        }
+    }
+
+    namespace WorkloadKeyDistribution
+    {
+        enum Enum
+        {
+            // Every loaded key is equally likely.
+            Uniform = 0,
+
+            // A few keys are hot. Popularity is scattered over the key space rather than clustered at the low keys.
+            Zipfian = 1,
+
+            // Like Zipfian, but the most recently inserted keys are the hot ones.
+            Latest = 2
+        };
+
+        inline char const * ToString(__in Enum distribution)
+        {
+            switch (distribution)
+            {
+            case Uniform: return "uniform";
+            case Zipfian: return "zipfian";
+            case Latest: return "latest";
+            default: return "unknown";
+            }
+        }
+    }
+
+    namespace WorkloadValueSizeDistribution
+    {
+        enum Enum
+        {
+            Constant = 0,
+            Uniform = 1
+        };
+    }
+
+    //
+    // Describes a YCSB style workload: how many keys are loaded, the mix of operations run against them,
+    // which keys the operations pick and how large the written values are.
+    // Each operation runs in its own transaction, and NumTasks transactions are in flight at any time.
+    //
+    struct WorkloadSpec
+    {
+        std::string Name;
+        ULONG32 RecordCount = 100'000;
+        Common::TimeSpan Duration = Common::TimeSpan::FromSeconds(10);
+        ULONG32 NumTasks = 16;
+
+        double ReadProportion = 0;
+        double UpdateProportion = 0;
+        double InsertProportion = 0;
+        double ScanProportion = 0;
+        double ReadModifyWriteProportion = 0;
+
+        WorkloadKeyDistribution::Enum KeyDistribution = WorkloadKeyDistribution::Zipfian;
+        double ZipfianConstant = 0.99;
+
+        WorkloadValueSizeDistribution::Enum ValueSizeDistribution = WorkloadValueSizeDistribution::Constant;
+        ULONG32 MinValueSize = 1000;
+        ULONG32 MaxValueSize = 1000;
+
+        // Scans read a uniformly chosen number of items between one and this.
+        ULONG32 MaxScanLength = 100;
+
+        // Checkpoint and reopen without loading values after the load phase, so reads start out served from the checkpoint files.
+        bool ReadFromDisk = false;
+
+        //
+        // The YCSB core workloads A to F, with 1000 byte values.
+        //
+        static WorkloadSpec CoreWorkload(__in char workload)
+        {
+            WorkloadSpec spec;
+            spec.Name = std::string("ycsb-") + workload;
+
+            switch (workload)
+            {
+            case 'A':
+                // Update heavy.
+                spec.ReadProportion = 0.5;
+                spec.UpdateProportion = 0.5;
+                break;
+            case 'B':
+                // Read mostly.
+                spec.ReadProportion = 0.95;
+                spec.UpdateProportion = 0.05;
+                break;
+            case 'C':
+                // Read only.
+                spec.ReadProportion = 1.0;
+                break;
+            case 'D':
+                // Read latest.
+                spec.ReadProportion = 0.95;
+                spec.InsertProportion = 0.05;
+                spec.KeyDistribution = WorkloadKeyDistribution::Latest;
+                break;
+            case 'E':
+                // Short ranges.
+                spec.ScanProportion = 0.95;
+                spec.InsertProportion = 0.05;
+                break;
+            case 'F':
+                // Read, modify, write.
+                spec.ReadProportion = 0.5;
+                spec.ReadModifyWriteProportion = 0.5;
+                break;
+            default:
+                CODING_ERROR_ASSERT(false);
+            }
+
+            return spec;
+        }
+    };
+
+    //
+    // Latency histogram in the style of HdrHistogram, over whole microseconds.
+    // Values below SubBucketCount are counted exactly. Every power of two above that is split into SubBucketCount / 2 linear buckets,
+    // so any reported value is within 1 / 64 of the recorded one, with a fixed ~30KB footprint from a microsecond to centuries.
+    //
+    class LatencyHistogram
+    {
+    public:
+
+        LatencyHistogram()
+            : counts_(BucketCount, 0),
+            totalCount_(0),
+            totalValue_(0),
+            maxValue_(0)
+        {
+        }
+
+        __declspec(property(get = get_TotalCount)) ULONG64 TotalCount;
+        ULONG64 get_TotalCount() const
+        {
+            return totalCount_;
+        }
+
+        __declspec(property(get = get_MaxValue)) ULONG64 MaxValue;
+        ULONG64 get_MaxValue() const
+        {
+            return maxValue_;
+        }
+
+        __declspec(property(get = get_Mean)) double Mean;
+        double get_Mean() const
+        {
+            return totalCount_ == 0 ? 0 : totalValue_ / totalCount_;
+        }
+
+        void Record(__in ULONG64 value)
+        {
+            counts_[GetIndex(value)]++;
+            totalCount_++;
+            totalValue_ += static_cast<double>(value);
+            if (value > maxValue_)
+            {
+                maxValue_ = value;
+            }
+        }
+
+        void Merge(__in LatencyHistogram const & other)
+        {
+            for (ULONG32 i = 0; i < BucketCount; i++)
+            {
+                counts_[i] += other.counts_[i];
+            }
+
+            totalCount_ += other.totalCount_;
+            totalValue_ += other.totalValue_;
+            if (other.maxValue_ > maxValue_)
+            {
+                maxValue_ = other.maxValue_;
+            }
+        }
+
+        //
+        // Returns the highest value equivalent to the one below which the given percentage of the recorded values fall.
+        //
+        ULONG64 GetValueAtPercentile(__in double percentile) const
+        {
+            if (totalCount_ == 0)
+            {
+                return 0;
+            }
+
+            ULONG64 countAtPercentile = static_cast<ULONG64>((percentile / 100.0) * totalCount_ + 0.5);
+            if (countAtPercentile == 0)
+            {
+                countAtPercentile = 1;
+            }
+
+            ULONG64 runningCount = 0;
+            for (ULONG32 i = 0; i < BucketCount; i++)
+            {
+                runningCount += counts_[i];
+                if (runningCount >= countAtPercentile)
+                {
+                    ULONG64 value = GetHighestEquivalentValue(i);
+                    return value < maxValue_ ? value : maxValue_;
+                }
+            }
+
+            return maxValue_;
+        }
+
+    private:
+
+        static const ULONG32 SubBucketBits = 7;
+        static const ULONG32 SubBucketCount = 1 << SubBucketBits;
+        static const ULONG32 SubBucketHalfCount = SubBucketCount / 2;
+        static const ULONG32 BucketCount = SubBucketCount + (64 - SubBucketBits) * SubBucketHalfCount;
+
+        static ULONG32 GetIndex(__in ULONG64 value)
+        {
+            if (value < SubBucketCount)
+            {
+                return static_cast<ULONG32>(value);
+            }
+
+            ULONG32 highestBit = 0;
+            while ((value >> (highestBit + 1)) != 0)
+            {
+                highestBit++;
+            }
+
+            // Shift the value down so that it lands in the upper half of the sub buckets.
+            ULONG32 shift = highestBit - (SubBucketBits - 1);
+            ULONG32 subBucket = static_cast<ULONG32>(value >> shift);
+            return SubBucketCount + (shift - 1) * SubBucketHalfCount + (subBucket - SubBucketHalfCount);
+        }
+
+        static ULONG64 GetHighestEquivalentValue(__in ULONG32 index)
+        {
+            if (index < SubBucketCount)
+            {
+                return index;
+            }
+
+            ULONG32 offset = index - SubBucketCount;
+            ULONG32 shift = offset / SubBucketHalfCount + 1;
+            ULONG64 subBucket = offset % SubBucketHalfCount + SubBucketHalfCount;
+            return (subBucket << shift) + (1ULL << shift) - 1;
+        }
+
+        std::vector<ULONG64> counts_;
+        ULONG64 totalCount_;
+        double totalValue_;
+        ULONG64 maxValue_;
+    };
+
+    //
+    // Picks key numbers in [0, itemCount) following the given distribution.
+    // Zipfian follows Gray et al., "Quickly Generating Billion-Record Synthetic Databases", as YCSB does,
+    // and scatters the popular items over the key space with an FNV hash.
+    // The constants are computed once, so one chooser is shared by all tasks, each drawing from its own random numbers.
+    //
+    class WorkloadKeyChooser
+    {
+    public:
+
+        WorkloadKeyChooser(
+            __in WorkloadKeyDistribution::Enum distribution,
+            __in ULONG64 itemCount,
+            __in double zipfianConstant)
+            : distribution_(distribution),
+            itemCount_(itemCount),
+            theta_(zipfianConstant),
+            zetaN_(0),
+            alpha_(0),
+            eta_(0)
+        {
+            CODING_ERROR_ASSERT(itemCount_ > 0);
+
+            if (distribution_ != WorkloadKeyDistribution::Uniform)
+            {
+                zetaN_ = Zeta(itemCount_, theta_);
+                alpha_ = 1.0 / (1.0 - theta_);
+                eta_ = (1.0 - pow(2.0 / itemCount_, 1.0 - theta_)) / (1.0 - Zeta(2, theta_) / zetaN_);
+            }
+        }
+
+        //
+        // Returns the key number for the given uniform random number in [0, 1).
+        // Latest keys count back from the highest key inserted so far.
+        //
+        ULONG64 Next(
+            __in double random,
+            __in ULONG64 highestKey) const
+        {
+            switch (distribution_)
+            {
+            case WorkloadKeyDistribution::Uniform:
+                return static_cast<ULONG64>(random * itemCount_);
+            case WorkloadKeyDistribution::Zipfian:
+                return FnvHash64(NextZipfian(random)) % itemCount_;
+            default:
+            {
+                ULONG64 rank = NextZipfian(random);
+                return rank > highestKey ? 0 : highestKey - rank;
+            }
+            }
+        }
+
+    private:
+
+        static double Zeta(
+            __in ULONG64 count,
+            __in double theta)
+        {
+            double sum = 0;
+            for (ULONG64 i = 1; i <= count; i++)
+            {
+                sum += 1.0 / pow(static_cast<double>(i), theta);
+            }
+
+            return sum;
+        }
+
+        static ULONG64 FnvHash64(__in ULONG64 value)
+        {
+            ULONG64 hash = 0xCBF29CE484222325ULL;
+            for (ULONG32 i = 0; i < sizeof(ULONG64); i++)
+            {
+                hash ^= (value >> (i * 8)) & 0xFF;
+                hash *= 0x100000001B3ULL;
+            }
+
+            return hash;
+        }
+
+        ULONG64 NextZipfian(__in double random) const
+        {
+            double uz = random * zetaN_;
+            if (uz < 1.0)
+            {
+                return 0;
+            }
+
+            if (uz < 1.0 + pow(0.5, theta_))
+            {
+                return 1;
+            }
+
+            ULONG64 rank = static_cast<ULONG64>(itemCount_ * pow(eta_ * random - eta_ + 1.0, alpha_));
+            return rank < itemCount_ ? rank : itemCount_ - 1;
+        }
+
+        WorkloadKeyDistribution::Enum distribution_;
+        ULONG64 itemCount_;
+        double theta_;
+        double zetaN_;
+        double alpha_;
+        double eta_;
+    };
+
+    //
+    // Runs a WorkloadSpec against the store of the test and reports throughput and per operation latency percentiles.
+    // The report is a single JSON line written to the trace and appended to the file named by the
+    // TSTORE_PERF_RESULTS_FILE environment variable when it is set, so results can be compared between builds.
+    //
+    template<typename TKey, typename TValue, typename TKeyComparer, typename TKeySerializer, typename TValueSerializer>
+    class TStoreWorkloadPerfTestBase : public TStorePerfTestBase<TKey, TValue, TKeyComparer, TKeySerializer, TValueSerializer>
+    {
+    public:
+
+        //
+        // Maps a key number from the workload onto a store key. Must preserve the order of the key numbers, so scans see consecutive keys.
+        //
+        virtual TKey CreateWorkloadKey(__in ULONG64 keyNumber) = 0;
+
+        virtual TValue CreateWorkloadValue(
+            __in ULONG32 sizeInBytes,
+            __in ULONG64 keyNumber) = 0;
+
+        void RunWorkload(__in WorkloadSpec const & spec)
+        {
+            double totalProportion = spec.ReadProportion + spec.UpdateProportion + spec.InsertProportion + spec.ScanProportion + spec.ReadModifyWriteProportion;
+            CODING_ERROR_ASSERT(totalProportion > 0.999 && totalProportion < 1.001);
+            CODING_ERROR_ASSERT(spec.RecordCount > 0);
+            CODING_ERROR_ASSERT(spec.NumTasks > 0);
+            CODING_ERROR_ASSERT(spec.MinValueSize <= spec.MaxValueSize);
+
+            SyncAwait(LoadAsync(spec));
+
+            if (spec.ReadFromDisk)
+            {
+                this->Checkpoint();
+                this->Store->ShouldLoadValuesOnRecovery = false;
+                this->CloseAndReOpenStore();
+            }
+
+            SyncAwait(RunAsync(spec));
+        }
+
+    private:
+
+        struct TaskResult
+        {
+            LatencyHistogram Histograms[WorkloadOperation::Count];
+            ULONG64 FailedCount = 0;
+        };
+
+        ktl::Awaitable<void> LoadAsync(__in WorkloadSpec const & spec)
+        {
+            KSharedArray<ktl::Awaitable<void>>::SPtr tasksSPtr = _new(STOREWORKLOADPERFTESTBASE_TAG, this->GetAllocator()) KSharedArray<ktl::Awaitable<void>>();
+
+            Common::Stopwatch stopwatch;
+            stopwatch.Start();
+
+            for (ULONG32 i = 0; i < spec.NumTasks; i++)
+            {
+                tasksSPtr->Append(LoadKeysAsync(spec, i));
+            }
+
+            co_await StoreUtilities::WhenAll(*tasksSPtr, this->GetAllocator());
+            stopwatch.Stop();
+
+            nextInsertKey_ = spec.RecordCount;
+
+            Trace.WriteInfo("Perf", "Workload {0}: loaded {1} keys in {2} ms", spec.Name, spec.RecordCount, stopwatch.ElapsedMilliseconds);
+        }
+
+        ktl::Awaitable<void> LoadKeysAsync(
+            __in WorkloadSpec const & spec,
+            __in ULONG32 taskIndex)
+        {
+            co_await CorHelper::ThreadPoolThread(this->GetAllocator().GetKtlSystem().DefaultThreadPool());
+
+            Common::Random random(static_cast<int>(taskIndex) + 1);
+
+            // Task i loads every NumTasks'th key, committing in batches to keep the load phase short.
+            ULONG32 keysInTransaction = 0;
+            auto txn = this->CreateWriteTransaction();
+            for (ULONG64 keyNumber = taskIndex; keyNumber < spec.RecordCount; keyNumber += spec.NumTasks)
+            {
+                co_await this->Store->AddAsync(
+                    *txn->StoreTransactionSPtr,
+                    CreateWorkloadKey(keyNumber),
+                    CreateWorkloadValue(ChooseValueSize(spec, random), keyNumber),
+                    this->DefaultTimeout,
+                    ktl::CancellationToken::None);
+
+                if (++keysInTransaction == LoadBatchSize)
+                {
+                    co_await txn->CommitAsync();
+                    txn = this->CreateWriteTransaction();
+                    keysInTransaction = 0;
+                }
+            }
+
+            co_await txn->CommitAsync();
+        }
+
+        ktl::Awaitable<void> RunAsync(__in WorkloadSpec const & spec)
+        {
+            WorkloadKeyChooser keyChooser(spec.KeyDistribution, spec.RecordCount, spec.ZipfianConstant);
+            std::vector<TaskResult> results(spec.NumTasks);
+
+            ktl::AwaitableCompletionSource<void>::SPtr startSignalSPtr = nullptr;
+            NTSTATUS status = ktl::AwaitableCompletionSource<void>::Create(this->GetAllocator(), STOREWORKLOADPERFTESTBASE_TAG, startSignalSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            ktl::CancellationTokenSource::SPtr tokenSourceSPtr = nullptr;
+            status = ktl::CancellationTokenSource::Create(this->GetAllocator(), STOREWORKLOADPERFTESTBASE_TAG, tokenSourceSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            KSharedArray<ktl::Awaitable<void>>::SPtr tasksSPtr = _new(STOREWORKLOADPERFTESTBASE_TAG, this->GetAllocator()) KSharedArray<ktl::Awaitable<void>>();
+            for (ULONG32 i = 0; i < spec.NumTasks; i++)
+            {
+                tasksSPtr->Append(RunWorkloadTaskAsync(spec, keyChooser, i, results[i], *startSignalSPtr, tokenSourceSPtr->Token));
+            }
+
+            Common::Stopwatch stopwatch;
+            stopwatch.Start();
+            startSignalSPtr->Set();
+
+            // Offloading cancellation to Common Threadpool because current KTL
+            // threadpool may starve this coroutine from running
+            Common::Threadpool::Post([tokenSourceSPtr] {
+                tokenSourceSPtr->Cancel();
+            }, spec.Duration);
+
+            for (ULONG32 i = 0; i < spec.NumTasks; i++)
+            {
+                co_await (*tasksSPtr)[i];
+            }
+
+            stopwatch.Stop();
+
+            TaskResult total;
+            for (ULONG32 i = 0; i < spec.NumTasks; i++)
+            {
+                for (ULONG32 operation = 0; operation < WorkloadOperation::Count; operation++)
+                {
+                    total.Histograms[operation].Merge(results[i].Histograms[operation]);
+                }
+
+                total.FailedCount += results[i].FailedCount;
+            }
+
+            ReportResult(spec, total, stopwatch.ElapsedMilliseconds);
+        }
+
+        ktl::Awaitable<void> RunWorkloadTaskAsync(
+            __in WorkloadSpec const & spec,
+            __in WorkloadKeyChooser const & keyChooser,
+            __in ULONG32 taskIndex,
+            __out TaskResult & result,
+            __in ktl::AwaitableCompletionSource<void> & startSignal,
+            __in ktl::CancellationToken const cancellationToken)
+        {
+            co_await CorHelper::ThreadPoolThread(this->GetAllocator().GetKtlSystem().DefaultThreadPool());
+
+            Common::Random random(static_cast<int>(taskIndex) + 1);
+
+            co_await startSignal.GetAwaitable();
+
+            while (!cancellationToken.IsCancellationRequested)
+            {
+                WorkloadOperation::Enum operation = ChooseOperation(spec, random.NextDouble());
+
+                Common::Stopwatch stopwatch;
+                stopwatch.Start();
+
+                bool succeeded = co_await RunOperationAsync(spec, keyChooser, operation, random);
+
+                stopwatch.Stop();
+
+                if (succeeded)
+                {
+                    result.Histograms[operation].Record(static_cast<ULONG64>(stopwatch.ElapsedMicroseconds));
+                }
+                else
+                {
+                    result.FailedCount++;
+                }
+            }
+        }
+
+        ktl::Awaitable<bool> RunOperationAsync(
+            __in WorkloadSpec const & spec,
+            __in WorkloadKeyChooser const & keyChooser,
+            __in WorkloadOperation::Enum operation,
+            __in Common::Random & random)
+        {
+            // Key numbers handed out to inserts are only readable once the insert commits; racing for the latest few is harmless.
+            ULONG64 highestKey = static_cast<ULONG64>(nextInsertKey_) - 1;
+            ULONG64 keyNumber = operation == WorkloadOperation::Insert
+                ? static_cast<ULONG64>(InterlockedIncrement64(&nextInsertKey_)) - 1
+                : keyChooser.Next(random.NextDouble(), highestKey);
+
+            TKey key = CreateWorkloadKey(keyNumber);
+            auto txn = this->CreateWriteTransaction();
+            bool succeeded = true;
+
+            try
+            {
+                switch (operation)
+                {
+                case WorkloadOperation::Read:
+                {
+                    KeyValuePair<LONG64, TValue> value;
+                    co_await this->Store->ConditionalGetAsync(*txn->StoreTransactionSPtr, key, this->DefaultTimeout, value, ktl::CancellationToken::None);
+                    co_await txn->AbortAsync();
+                    break;
+                }
+                case WorkloadOperation::Update:
+                {
+                    co_await this->Store->ConditionalUpdateAsync(
+                        *txn->StoreTransactionSPtr,
+                        key,
+                        CreateWorkloadValue(ChooseValueSize(spec, random), keyNumber),
+                        this->DefaultTimeout,
+                        ktl::CancellationToken::None);
+                    co_await txn->CommitAsync();
+                    break;
+                }
+                case WorkloadOperation::Insert:
+                {
+                    co_await this->Store->AddAsync(
+                        *txn->StoreTransactionSPtr,
+                        key,
+                        CreateWorkloadValue(ChooseValueSize(spec, random), keyNumber),
+                        this->DefaultTimeout,
+                        ktl::CancellationToken::None);
+                    co_await txn->CommitAsync();
+                    break;
+                }
+                case WorkloadOperation::Scan:
+                {
+                    ULONG32 scanLength = static_cast<ULONG32>(random.NextDouble() * spec.MaxScanLength) + 1;
+                    txn->StoreTransactionSPtr->ReadIsolationLevel = StoreTransactionReadIsolationLevel::Snapshot;
+
+                    auto enumeratorSPtr = co_await this->Store->CreateEnumeratorAsync(*txn->StoreTransactionSPtr, key, true, TKey(), false);
+                    for (ULONG32 i = 0; i < scanLength; i++)
+                    {
+                        bool hasNext = co_await enumeratorSPtr->MoveNextAsync(ktl::CancellationToken::None);
+                        if (!hasNext)
+                        {
+                            break;
+                        }
+                    }
+
+                    co_await txn->AbortAsync();
+                    break;
+                }
+                case WorkloadOperation::ReadModifyWrite:
+                {
+                    KeyValuePair<LONG64, TValue> value;
+                    co_await this->Store->ConditionalGetAsync(*txn->StoreTransactionSPtr, key, this->DefaultTimeout, value, ktl::CancellationToken::None);
+                    co_await this->Store->ConditionalUpdateAsync(
+                        *txn->StoreTransactionSPtr,
+                        key,
+                        CreateWorkloadValue(ChooseValueSize(spec, random), keyNumber),
+                        this->DefaultTimeout,
+                        ktl::CancellationToken::None);
+                    co_await txn->CommitAsync();
+                    break;
+                }
+                default:
+                    CODING_ERROR_ASSERT(false);
+                }
+            }
+            catch (ktl::Exception const &)
+            {
+                // Lock timeouts on hot keys are part of the workload; they are counted rather than failing the run.
+                succeeded = false;
+            }
+
+            if (!succeeded)
+            {
+                try
+                {
+                    co_await txn->AbortAsync();
+                }
+                catch (ktl::Exception const &)
+                {
+                    // The transaction may already have been completed when the operation failed.
+                }
+            }
+
+            co_return succeeded;
+        }
+
+        static WorkloadOperation::Enum ChooseOperation(
+            __in WorkloadSpec const & spec,
+            __in double random)
+        {
+            double threshold = spec.ReadProportion;
+            if (random < threshold)
+            {
+                return WorkloadOperation::Read;
+            }
+
+            threshold += spec.UpdateProportion;
+            if (random < threshold)
+            {
+                return WorkloadOperation::Update;
+            }
+
+            threshold += spec.InsertProportion;
+            if (random < threshold)
+            {
+                return WorkloadOperation::Insert;
+            }
+
+            threshold += spec.ScanProportion;
+            if (random < threshold)
+            {
+                return WorkloadOperation::Scan;
+            }
+
+            return WorkloadOperation::ReadModifyWrite;
+        }
+
+        static ULONG32 ChooseValueSize(
+            __in WorkloadSpec const & spec,
+            __in Common::Random & random)
+        {
+            if (spec.ValueSizeDistribution == WorkloadValueSizeDistribution::Constant || spec.MinValueSize == spec.MaxValueSize)
+            {
+                return spec.MinValueSize;
+            }
+
+            return spec.MinValueSize + static_cast<ULONG32>(random.NextDouble() * (spec.MaxValueSize - spec.MinValueSize + 1));
+        }
+
+        void ReportResult(
+            __in WorkloadSpec const & spec,
+            __in TaskResult const & total,
+            __in LONG64 elapsedMilliseconds)
+        {
+            ULONG64 operationCount = 0;
+            for (ULONG32 operation = 0; operation < WorkloadOperation::Count; operation++)
+            {
+                operationCount += total.Histograms[operation].TotalCount;
+            }
+
+            double elapsedSeconds = elapsedMilliseconds > 0 ? elapsedMilliseconds / 1000.0 : 1.0;
+
+            std::ostringstream output;
+            output << std::fixed << std::setprecision(1);
+            output << "{\"workload\":\"" << spec.Name << "\""
+                << ",\"recordCount\":" << spec.RecordCount
+                << ",\"tasks\":" << spec.NumTasks
+                << ",\"keyDistribution\":\"" << WorkloadKeyDistribution::ToString(spec.KeyDistribution) << "\""
+                << ",\"minValueSize\":" << spec.MinValueSize
+                << ",\"maxValueSize\":" << spec.MaxValueSize
+                << ",\"readFromDisk\":" << (spec.ReadFromDisk ? "true" : "false")
+                << ",\"elapsedMs\":" << elapsedMilliseconds
+                << ",\"operations\":" << operationCount
+                << ",\"failed\":" << total.FailedCount
+                << ",\"throughputOpsPerSec\":" << operationCount / elapsedSeconds
+                << ",\"latencyUs\":{";
+
+            bool first = true;
+            for (ULONG32 operation = 0; operation < WorkloadOperation::Count; operation++)
+            {
+                LatencyHistogram const & histogram = total.Histograms[operation];
+                if (histogram.TotalCount == 0)
+                {
+                    continue;
+                }
+
+                output << (first ? "" : ",")
+                    << "\"" << WorkloadOperation::ToString(static_cast<WorkloadOperation::Enum>(operation)) << "\":{"
+                    << "\"count\":" << histogram.TotalCount
+                    << ",\"mean\":" << histogram.Mean
+                    << ",\"p50\":" << histogram.GetValueAtPercentile(50)
+                    << ",\"p90\":" << histogram.GetValueAtPercentile(90)
+                    << ",\"p99\":" << histogram.GetValueAtPercentile(99)
+                    << ",\"p99.9\":" << histogram.GetValueAtPercentile(99.9)
+                    << ",\"max\":" << histogram.MaxValue
+                    << "}";
+                first = false;
+            }
+
+            output << "}}";
+
+            std::string result = output.str();
+            Trace.WriteInfo("Perf", "Workload result: {0}", result);
+
+            char const * resultsFile = std::getenv("TSTORE_PERF_RESULTS_FILE");
+            if (resultsFile != nullptr && resultsFile[0] != '\0')
+            {
+                std::ofstream resultsStream(resultsFile, std::ios::app);
+                resultsStream << result << std::endl;
+            }
+        }
+
+        static const ULONG32 LoadBatchSize = 100;
+
+        volatile LONG64 nextInsertKey_ = 0;
+    };
+}
@@ -90,7 +90,9 @@ namespace Data
                 this->versionSequenceNumber_ = versionSequenceNumber;
                 this->fileId_ = fileId;
                 this->valueOffset_ = fileOffset;
+                // The serialized size of a compressed value is only known once it is loaded, until then the on-disk size stands in for it.
                 this->valueSize_ = valueSize;
+                this->onDiskValueSize_ = valueSize;
                 this->valueChecksum_ = valueChecksum;
                 this->SetInUse(false);
                 this->SetIsInMemory(false);
@@ -0,0 +1,251 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#include <boost/test/unit_test.hpp>
+#include "Common/boost-taef.h"
+
+namespace TStoreTests
+{
+    using namespace ktl;
+    using namespace Data::TStore;
+    using namespace Data::Utilities;
+
+    class ValueCacheTest
+    {
+    public:
+        ValueCacheTest()
+        {
+            NTSTATUS status = KtlSystem::Initialize(FALSE, &ktlSystem_);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            ktlSystem_->SetStrictAllocationChecks(TRUE);
+        }
+
+        ~ValueCacheTest()
+        {
+            ktlSystem_->Shutdown();
+        }
+
+        KAllocator& GetAllocator()
+        {
+            return ktlSystem_->NonPagedAllocator();
+        }
+
+        ValueCache::SPtr CreateCache(
+            __in ULONG64 capacityInBytes,
+            __in ValueCacheEvictionPolicyKind::Enum policyKind)
+        {
+            ValueCache::SPtr cacheSPtr = nullptr;
+            NTSTATUS status = ValueCache::Create(capacityInBytes, policyKind, GetAllocator(), cacheSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            return cacheSPtr;
+        }
+
+        KBuffer::SPtr CreateValue(
+            __in ULONG32 size,
+            __in byte fill)
+        {
+            KBuffer::SPtr bufferSPtr = nullptr;
+            NTSTATUS status = KBuffer::Create(size, bufferSPtr, GetAllocator());
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            memset(bufferSPtr->GetBuffer(), fill, size);
+            return bufferSPtr;
+        }
+
+        void AddValue(
+            __in ValueCache & cache,
+            __in ULONG64 fileId,
+            __in LONG64 offset)
+        {
+            KBuffer::SPtr valueSPtr = CreateValue(ValueSize, static_cast<byte>(offset));
+            cache.Add(ValueCacheKey(fileId, offset), *valueSPtr);
+        }
+
+        bool Contains(
+            __in ValueCache & cache,
+            __in ULONG64 fileId,
+            __in LONG64 offset)
+        {
+            KBuffer::SPtr valueSPtr = nullptr;
+            bool found = cache.TryGet(ValueCacheKey(fileId, offset), valueSPtr);
+            if (found)
+            {
+                CODING_ERROR_ASSERT(valueSPtr->QuerySize() == ValueSize);
+                CODING_ERROR_ASSERT(static_cast<byte *>(valueSPtr->GetBuffer())[0] == static_cast<byte>(offset));
+            }
+
+            return found;
+        }
+
+        void VerifyBudgetIsEnforced(__in ValueCacheEvictionPolicyKind::Enum policyKind)
+        {
+            ULONG64 capacity = 64 * 1024;
+            ValueCache::SPtr cacheSPtr = CreateCache(capacity, policyKind);
+
+            for (LONG64 offset = 0; offset < 10000; offset++)
+            {
+                AddValue(*cacheSPtr, 1, offset * ValueSize);
+                CODING_ERROR_ASSERT(cacheSPtr->Size <= capacity);
+            }
+
+            CODING_ERROR_ASSERT(cacheSPtr->Count > 0);
+            CODING_ERROR_ASSERT(cacheSPtr->EvictionCount > 0);
+            CODING_ERROR_ASSERT(cacheSPtr->Count + cacheSPtr->EvictionCount == 10000);
+
+            cacheSPtr->Clear();
+            CODING_ERROR_ASSERT(cacheSPtr->Size == 0);
+            CODING_ERROR_ASSERT(cacheSPtr->Count == 0);
+        }
+
+        void VerifyHotValuesSurviveScan(__in ValueCacheEvictionPolicyKind::Enum policyKind)
+        {
+            ValueCache::SPtr cacheSPtr = CreateCache(1024 * 1024, policyKind);
+
+            LONG64 hotCount = 32;
+            for (LONG64 offset = 0; offset < hotCount; offset++)
+            {
+                AddValue(*cacheSPtr, 1, offset);
+            }
+
+            // Values read once are cheaper to lose than values read repeatedly.
+            for (LONG64 scanOffset = 0; scanOffset < 20000; scanOffset++)
+            {
+                if (scanOffset % 100 == 0)
+                {
+                    for (LONG64 offset = 0; offset < hotCount; offset++)
+                    {
+                        CODING_ERROR_ASSERT(Contains(*cacheSPtr, 1, offset));
+                    }
+                }
+
+                AddValue(*cacheSPtr, 2, scanOffset);
+            }
+
+            for (LONG64 offset = 0; offset < hotCount; offset++)
+            {
+                CODING_ERROR_ASSERT(Contains(*cacheSPtr, 1, offset));
+            }
+
+            CODING_ERROR_ASSERT(cacheSPtr->EvictionCount > 0);
+        }
+
+        static const ULONG32 ValueSize = 100;
+
+    private:
+        KtlSystem* ktlSystem_;
+    };
+
+    BOOST_FIXTURE_TEST_SUITE(ValueCacheTestSuite, ValueCacheTest)
+
+    BOOST_AUTO_TEST_CASE(ValueCache_AddThenGet_ShouldHit)
+    {
+        ValueCache::SPtr cacheSPtr = CreateCache(1024 * 1024, ValueCacheEvictionPolicyKind::SegmentedLru);
+
+        CODING_ERROR_ASSERT(!Contains(*cacheSPtr, 1, 0));
+        CODING_ERROR_ASSERT(cacheSPtr->MissCount == 1);
+
+        AddValue(*cacheSPtr, 1, 0);
+        AddValue(*cacheSPtr, 2, 0);
+
+        CODING_ERROR_ASSERT(Contains(*cacheSPtr, 1, 0));
+        CODING_ERROR_ASSERT(Contains(*cacheSPtr, 2, 0));
+        CODING_ERROR_ASSERT(!Contains(*cacheSPtr, 3, 0));
+        CODING_ERROR_ASSERT(!Contains(*cacheSPtr, 1, 1));
+
+        CODING_ERROR_ASSERT(cacheSPtr->HitCount == 2);
+        CODING_ERROR_ASSERT(cacheSPtr->MissCount == 3);
+        CODING_ERROR_ASSERT(cacheSPtr->Count == 2);
+        CODING_ERROR_ASSERT(cacheSPtr->EvictionCount == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(ValueCache_AddSameKeyTwice_ShouldKeepFirstValue)
+    {
+        ValueCache::SPtr cacheSPtr = CreateCache(1024 * 1024, ValueCacheEvictionPolicyKind::SegmentedLru);
+
+        AddValue(*cacheSPtr, 1, 7);
+        ULONG64 size = cacheSPtr->Size;
+
+        KBuffer::SPtr otherSPtr = CreateValue(ValueSize * 2, 0);
+        cacheSPtr->Add(ValueCacheKey(1, 7), *otherSPtr);
+
+        CODING_ERROR_ASSERT(cacheSPtr->Count == 1);
+        CODING_ERROR_ASSERT(cacheSPtr->Size == size);
+        CODING_ERROR_ASSERT(Contains(*cacheSPtr, 1, 7));
+    }
+
+    BOOST_AUTO_TEST_CASE(ValueCache_ValueLargerThanShard_ShouldNotBeCached)
+    {
+        ValueCache::SPtr cacheSPtr = CreateCache(ValueCache::ShardCount * 1024, ValueCacheEvictionPolicyKind::SegmentedLru);
+
+        KBuffer::SPtr valueSPtr = CreateValue(2048, 1);
+        CODING_ERROR_ASSERT(cacheSPtr->Add(ValueCacheKey(1, 0), *valueSPtr) == 0);
+
+        KBuffer::SPtr resultSPtr = nullptr;
+        CODING_ERROR_ASSERT(!cacheSPtr->TryGet(ValueCacheKey(1, 0), resultSPtr));
+        CODING_ERROR_ASSERT(cacheSPtr->Size == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(ValueCache_SegmentedLru_ShouldStayWithinBudget)
+    {
+        VerifyBudgetIsEnforced(ValueCacheEvictionPolicyKind::SegmentedLru);
+    }
+
+    BOOST_AUTO_TEST_CASE(ValueCache_Clock_ShouldStayWithinBudget)
+    {
+        VerifyBudgetIsEnforced(ValueCacheEvictionPolicyKind::Clock);
+    }
+
+    BOOST_AUTO_TEST_CASE(ValueCache_SegmentedLru_HotValuesShouldSurviveScan)
+    {
+        VerifyHotValuesSurviveScan(ValueCacheEvictionPolicyKind::SegmentedLru);
+    }
+
+    BOOST_AUTO_TEST_CASE(ValueCache_Clock_HotValuesShouldSurviveScan)
+    {
+        VerifyHotValuesSurviveScan(ValueCacheEvictionPolicyKind::Clock);
+    }
+
+    BOOST_AUTO_TEST_CASE(ValueCache_AllocateFileId_ShouldBeUnique)
+    {
+        ULONG64 first = ValueCache::AllocateFileId();
+        ULONG64 second = ValueCache::AllocateFileId();
+        CODING_ERROR_ASSERT(first != 0);
+        CODING_ERROR_ASSERT(second > first);
+    }
+
+    BOOST_AUTO_TEST_CASE(ValueCache_ProcessCache_ShouldBeSharedWhileHeld)
+    {
+        ValueCache::SPtr firstSPtr = nullptr;
+        NTSTATUS status = ValueCache::GetOrCreateProcessCache(1024 * 1024, GetAllocator(), firstSPtr);
+        CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+        ValueCache::SPtr secondSPtr = nullptr;
+        status = ValueCache::GetOrCreateProcessCache(2 * 1024 * 1024, GetAllocator(), secondSPtr);
+        CODING_ERROR_ASSERT(NT_SUCCESS(status));
+        CODING_ERROR_ASSERT(firstSPtr.RawPtr() == secondSPtr.RawPtr());
+        CODING_ERROR_ASSERT(secondSPtr->CapacityInBytes == 1024 * 1024);
+
+        firstSPtr = nullptr;
+        secondSPtr = nullptr;
+
+        status = ValueCache::GetOrCreateProcessCache(2 * 1024 * 1024, GetAllocator(), firstSPtr);
+        CODING_ERROR_ASSERT(NT_SUCCESS(status));
+        CODING_ERROR_ASSERT(firstSPtr->CapacityInBytes == 2 * 1024 * 1024);
+    }
+
+    BOOST_AUTO_TEST_CASE(ValueCacheEvictionPolicyFactory_UnknownKind_ShouldNotBeSupported)
+    {
+        IValueCacheEvictionPolicy::SPtr policySPtr = nullptr;
+        NTSTATUS status = ValueCacheEvictionPolicyFactory::Create(static_cast<ValueCacheEvictionPolicyKind::Enum>(1000), 1024, GetAllocator(), policySPtr);
+        CODING_ERROR_ASSERT(status == STATUS_NOT_SUPPORTED);
+
+        ValueCache::SPtr cacheSPtr = nullptr;
+        status = ValueCache::Create(1024 * 1024, static_cast<ValueCacheEvictionPolicyKind::Enum>(1000), GetAllocator(), cacheSPtr);
+        CODING_ERROR_ASSERT(status == STATUS_NOT_SUPPORTED);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+}
@@ -0,0 +1,357 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#define VALUECACHE_TAG 'acVS'
+
+using namespace Data::TStore;
+
+volatile LONG64 ValueCache::nextFileId_ = 0;
+KSpinLock ValueCache::processCacheLock_;
+ValueCache * ValueCache::processCache_ = nullptr;
+KWeakRef<ValueCache>::SPtr ValueCache::processCacheWRef_ = nullptr;
+
+ValueCache::ValueCache(
+    __in ULONG64 capacityInBytes,
+    __in ValueCacheEvictionPolicyKind::Enum policyKind)
+    : capacityInBytes_(capacityInBytes),
+    policyKind_(policyKind),
+    shards_(GetThisAllocator(), ShardCount),
+    hitCount_(0),
+    missCount_(0),
+    evictionCount_(0)
+{
+    NTSTATUS status = shards_.Status();
+    if (!NT_SUCCESS(status))
+    {
+        this->SetConstructorStatus(status);
+        return;
+    }
+
+    for (ULONG32 i = 0; i < ShardCount; i++)
+    {
+        Shard::SPtr shardSPtr = nullptr;
+        status = Shard::Create(capacityInBytes_ / ShardCount, policyKind_, GetThisAllocator(), shardSPtr);
+        if (!NT_SUCCESS(status))
+        {
+            this->SetConstructorStatus(status);
+            return;
+        }
+
+        status = shards_.Append(shardSPtr);
+        if (!NT_SUCCESS(status))
+        {
+            this->SetConstructorStatus(status);
+            return;
+        }
+    }
+}
+
+ValueCache::~ValueCache()
+{
+    K_LOCK_BLOCK(processCacheLock_)
+    {
+        if (processCache_ == this)
+        {
+            processCache_ = nullptr;
+            processCacheWRef_ = nullptr;
+        }
+    }
+}
+
+NTSTATUS ValueCache::Create(
+    __in ULONG64 capacityInBytes,
+    __in ValueCacheEvictionPolicyKind::Enum policyKind,
+    __in KAllocator & allocator,
+    __out ValueCache::SPtr & result)
+{
+    if (capacityInBytes < ShardCount)
+    {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    result = _new(VALUECACHE_TAG, allocator) ValueCache(capacityInBytes, policyKind);
+
+    if (!result)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    if (!NT_SUCCESS(result->Status()))
+    {
+        // Null Result while fetching failure status with no extra AddRefs or Releases
+        return (SPtr(Ktl::Move(result)))->Status();
+    }
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS ValueCache::GetOrCreateProcessCache(
+    __in ULONG64 capacityInBytes,
+    __in KAllocator & allocator,
+    __out ValueCache::SPtr & result)
+{
+    // A cache is never released under the lock, since its destructor takes the lock.
+    // The weak reference is null while the last holder is releasing the cache, in which case a new cache replaces it.
+    result = nullptr;
+
+    K_LOCK_BLOCK(processCacheLock_)
+    {
+        if (processCacheWRef_ != nullptr)
+        {
+            result = processCacheWRef_->TryGetTarget();
+        }
+    }
+
+    if (result != nullptr)
+    {
+        return STATUS_SUCCESS;
+    }
+
+    ValueCache::SPtr cacheSPtr = nullptr;
+    NTSTATUS status = Create(capacityInBytes, ValueCacheEvictionPolicyKind::SegmentedLru, allocator, cacheSPtr);
+    if (!NT_SUCCESS(status))
+    {
+        return status;
+    }
+
+    K_LOCK_BLOCK(processCacheLock_)
+    {
+        // Another store may have created the cache meanwhile.
+        if (processCacheWRef_ != nullptr)
+        {
+            result = processCacheWRef_->TryGetTarget();
+        }
+
+        if (result == nullptr)
+        {
+            processCache_ = cacheSPtr.RawPtr();
+            processCacheWRef_ = cacheSPtr->GetWeakRef();
+            result = cacheSPtr;
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
+
+ULONG64 ValueCache::AllocateFileId()
+{
+    return static_cast<ULONG64>(InterlockedIncrement64(&nextFileId_));
+}
+
+ULONG64 ValueCache::get_Size() const
+{
+    ULONG64 size = 0;
+    for (ULONG32 i = 0; i < ShardCount; i++)
+    {
+        size += shards_[i]->Size;
+    }
+
+    return size;
+}
+
+ULONG64 ValueCache::get_Count() const
+{
+    ULONG64 count = 0;
+    for (ULONG32 i = 0; i < ShardCount; i++)
+    {
+        count += shards_[i]->Count;
+    }
+
+    return count;
+}
+
+bool ValueCache::TryGet(
+    __in ValueCacheKey const & key,
+    __out KBuffer::SPtr & value)
+{
+    bool found = GetShard(key).TryGet(key, value);
+    if (found)
+    {
+        InterlockedIncrement64(&hitCount_);
+    }
+    else
+    {
+        InterlockedIncrement64(&missCount_);
+    }
+
+    return found;
+}
+
+ULONG32 ValueCache::Add(
+    __in ValueCacheKey const & key,
+    __in KBuffer & value)
+{
+    // Allocate outside of the shard lock.
+    ValueCacheEntry::SPtr entrySPtr = nullptr;
+    NTSTATUS status = ValueCacheEntry::Create(key, value, GetThisAllocator(), entrySPtr);
+    if (!NT_SUCCESS(status))
+    {
+        // Caching is best effort.
+        return 0;
+    }
+
+    ULONG32 evicted = GetShard(key).Add(*entrySPtr);
+    if (evicted > 0)
+    {
+        InterlockedAdd64(&evictionCount_, evicted);
+    }
+
+    return evicted;
+}
+
+void ValueCache::Clear()
+{
+    for (ULONG32 i = 0; i < ShardCount; i++)
+    {
+        shards_[i]->Clear();
+    }
+}
+
+ValueCache::Shard & ValueCache::GetShard(__in ValueCacheKey const & key) const
+{
+    // The low bits select the hash table bucket within the shard, so the shard is taken from the high bits.
+    ULONG hash = ValueCacheKey::Hash(key);
+    return *shards_[(hash >> 16) % ShardCount];
+}
+
+ValueCache::Shard::Shard(
+    __in ULONG64 capacityInBytes,
+    __in IValueCacheEvictionPolicy & policy)
+    : table_(InitialTableSize, ValueCacheKey::Hash, GetThisAllocator()),
+    policySPtr_(&policy),
+    capacityInBytes_(capacityInBytes),
+    size_(0),
+    count_(0)
+{
+    this->SetConstructorStatus(table_.Status());
+}
+
+ValueCache::Shard::~Shard()
+{
+    Clear();
+}
+
+NTSTATUS ValueCache::Shard::Create(
+    __in ULONG64 capacityInBytes,
+    __in ValueCacheEvictionPolicyKind::Enum policyKind,
+    __in KAllocator & allocator,
+    __out Shard::SPtr & result)
+{
+    IValueCacheEvictionPolicy::SPtr policySPtr = nullptr;
+    NTSTATUS status = ValueCacheEvictionPolicyFactory::Create(policyKind, capacityInBytes, allocator, policySPtr);
+    if (!NT_SUCCESS(status))
+    {
+        return status;
+    }
+
+    result = _new(VALUECACHE_TAG, allocator) Shard(capacityInBytes, *policySPtr);
+
+    if (!result)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    if (!NT_SUCCESS(result->Status()))
+    {
+        return (Shard::SPtr(Ktl::Move(result)))->Status();
+    }
+
+    return STATUS_SUCCESS;
+}
+
+bool ValueCache::Shard::TryGet(
+    __in ValueCacheKey const & key,
+    __out KBuffer::SPtr & value)
+{
+    ValueCacheEntry::SPtr entrySPtr = nullptr;
+
+    K_LOCK_BLOCK(lock_)
+    {
+        NTSTATUS status = table_.Get(key, entrySPtr);
+        if (!NT_SUCCESS(status))
+        {
+            value = nullptr;
+            return false;
+        }
+
+        policySPtr_->OnHit(*entrySPtr);
+    }
+
+    value = entrySPtr->Value;
+    return true;
+}
+
+ULONG32 ValueCache::Shard::Add(__in ValueCacheEntry & entry)
+{
+    if (entry.Charge > capacityInBytes_)
+    {
+        return 0;
+    }
+
+    ValueCacheEntry::SPtr entrySPtr = &entry;
+    ULONG32 evicted = 0;
+
+    K_LOCK_BLOCK(lock_)
+    {
+        // The bytes at a given file and offset never change, so a concurrent load of the same value can simply be dropped.
+        NTSTATUS status = table_.Put(entry.Key, entrySPtr, FALSE);
+        if (status != STATUS_SUCCESS)
+        {
+            return 0;
+        }
+
+        policySPtr_->OnInsert(entry);
+        size_ += entry.Charge;
+        count_++;
+
+        while (size_ > capacityInBytes_)
+        {
+            ValueCacheEntry * victim = policySPtr_->SelectVictim();
+            ASSERT_IFNOT(victim != nullptr, "Value cache shard is over budget with no entries to evict. size={0}", size_);
+            RemoveLocked(*victim);
+            evicted++;
+        }
+
+        // Overflow chains are unbounded, so grow the table once it is well past full to keep lookups short.
+        if (table_.Count() > table_.Size() * 2)
+        {
+            table_.Resize(table_.Size() * 4 + 1);
+        }
+    }
+
+    return evicted;
+}
+
+void ValueCache::Shard::Clear()
+{
+    K_LOCK_BLOCK(lock_)
+    {
+        while (true)
+        {
+            ValueCacheEntry * victim = policySPtr_->SelectVictim();
+            if (victim == nullptr)
+            {
+                break;
+            }
+
+            RemoveLocked(*victim);
+        }
+    }
+}
+
+void ValueCache::Shard::RemoveLocked(__in ValueCacheEntry & entry)
+{
+    // Keep the entry alive until the policy and the table are both done with it.
+    ValueCacheEntry::SPtr entrySPtr = &entry;
+
+    policySPtr_->OnRemove(entry);
+    NTSTATUS status = table_.Remove(entry.Key);
+    ASSERT_IFNOT(NT_SUCCESS(status), "Evicted value cache entry was not in the table. status={0}", status);
+
+    size_ -= entry.Charge;
+    count_--;
+}
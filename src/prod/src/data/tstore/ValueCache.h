@@ -0,0 +1,183 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace TStore
+    {
+        //
+        // Process wide cache of serialized values read from checkpoint files, shared by any number of stores.
+        // All stores charge the same byte budget, and the eviction policy decides which values stay resident,
+        // instead of every store sweeping its own versioned items against its own threshold.
+        //
+        // Values are cached as the serialized bytes returned by the value checkpoint file, so one cache serves stores of any value type.
+        // Checkpoint files are immutable, so an entry never needs to be invalidated; entries of files that were merged away
+        // are never hit again and age out through the eviction policy.
+        //
+        // The cache is split into shards, each with its own lock, eviction policy and an equal share of the budget.
+        //
+        class ValueCache :
+            public KObject<ValueCache>,
+            public KShared<ValueCache>,
+            public KWeakRefType<ValueCache>
+        {
+            K_FORCE_SHARED(ValueCache)
+
+        public:
+
+            static const ULONG32 ShardCount = 16;
+
+            static NTSTATUS Create(
+                __in ULONG64 capacityInBytes,
+                __in ValueCacheEvictionPolicyKind::Enum policyKind,
+                __in KAllocator & allocator,
+                __out ValueCache::SPtr & result);
+
+            //
+            // Returns the cache shared by every store in the process, creating it with the given budget when no store holds it.
+            // A cache already in use keeps its budget until the last store releases it.
+            //
+            static NTSTATUS GetOrCreateProcessCache(
+                __in ULONG64 capacityInBytes,
+                __in KAllocator & allocator,
+                __out ValueCache::SPtr & result);
+
+            //
+            // Allocates the process unique id that identifies a checkpoint file in ValueCacheKey.
+            //
+            static ULONG64 AllocateFileId();
+
+            __declspec(property(get = get_CapacityInBytes)) ULONG64 CapacityInBytes;
+            ULONG64 get_CapacityInBytes() const
+            {
+                return capacityInBytes_;
+            }
+
+            __declspec(property(get = get_PolicyKind)) ValueCacheEvictionPolicyKind::Enum PolicyKind;
+            ValueCacheEvictionPolicyKind::Enum get_PolicyKind() const
+            {
+                return policyKind_;
+            }
+
+            //
+            // Bytes currently charged against the budget.
+            //
+            __declspec(property(get = get_Size)) ULONG64 Size;
+            ULONG64 get_Size() const;
+
+            __declspec(property(get = get_Count)) ULONG64 Count;
+            ULONG64 get_Count() const;
+
+            __declspec(property(get = get_HitCount)) LONG64 HitCount;
+            LONG64 get_HitCount() const
+            {
+                return hitCount_;
+            }
+
+            __declspec(property(get = get_MissCount)) LONG64 MissCount;
+            LONG64 get_MissCount() const
+            {
+                return missCount_;
+            }
+
+            __declspec(property(get = get_EvictionCount)) LONG64 EvictionCount;
+            LONG64 get_EvictionCount() const
+            {
+                return evictionCount_;
+            }
+
+            bool TryGet(
+                __in ValueCacheKey const & key,
+                __out KBuffer::SPtr & value);
+
+            //
+            // Adds the value, evicting other values until the shard is back within its budget.
+            // Values larger than the budget of a shard are not cached.
+            // Returns the number of values evicted.
+            //
+            ULONG32 Add(
+                __in ValueCacheKey const & key,
+                __in KBuffer & value);
+
+            void Clear();
+
+        private:
+
+            class Shard :
+                public KObject<Shard>,
+                public KShared<Shard>
+            {
+                K_FORCE_SHARED(Shard)
+
+            public:
+
+                static NTSTATUS Create(
+                    __in ULONG64 capacityInBytes,
+                    __in ValueCacheEvictionPolicyKind::Enum policyKind,
+                    __in KAllocator & allocator,
+                    __out Shard::SPtr & result);
+
+                __declspec(property(get = get_Size)) ULONG64 Size;
+                ULONG64 get_Size() const
+                {
+                    return size_;
+                }
+
+                __declspec(property(get = get_Count)) ULONG64 Count;
+                ULONG64 get_Count() const
+                {
+                    return count_;
+                }
+
+                bool TryGet(
+                    __in ValueCacheKey const & key,
+                    __out KBuffer::SPtr & value);
+
+                ULONG32 Add(__in ValueCacheEntry & entry);
+
+                void Clear();
+
+            private:
+
+                static const ULONG InitialTableSize = 1021;
+
+                Shard(
+                    __in ULONG64 capacityInBytes,
+                    __in IValueCacheEvictionPolicy & policy);
+
+                void RemoveLocked(__in ValueCacheEntry & entry);
+
+                KSpinLock lock_;
+                KHashTable<ValueCacheKey, ValueCacheEntry::SPtr> table_;
+                IValueCacheEvictionPolicy::SPtr policySPtr_;
+                ULONG64 capacityInBytes_;
+                volatile ULONG64 size_;
+                volatile ULONG64 count_;
+            };
+
+            ValueCache(
+                __in ULONG64 capacityInBytes,
+                __in ValueCacheEvictionPolicyKind::Enum policyKind);
+
+            Shard & GetShard(__in ValueCacheKey const & key) const;
+
+            static volatile LONG64 nextFileId_;
+
+            static KSpinLock processCacheLock_;
+            static ValueCache * processCache_;
+            static KWeakRef<ValueCache>::SPtr processCacheWRef_;
+
+            ULONG64 capacityInBytes_;
+            ValueCacheEvictionPolicyKind::Enum policyKind_;
+            KArray<Shard::SPtr> shards_;
+
+            volatile LONG64 hitCount_;
+            volatile LONG64 missCount_;
+            volatile LONG64 evictionCount_;
+        };
+    }
+}
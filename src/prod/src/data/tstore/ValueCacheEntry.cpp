@@ -0,0 +1,42 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#define VALUECACHEENTRY_TAG 'ecVS'
+
+using namespace Data::TStore;
+
+const ULONG ValueCacheEntry::PolicyListEntryOffset = FIELD_OFFSET(ValueCacheEntry, PolicyListEntry);
+
+ValueCacheEntry::ValueCacheEntry(
+    __in ValueCacheKey const & key,
+    __in KBuffer & value)
+    : PolicyState(0),
+    key_(key),
+    valueSPtr_(&value),
+    charge_(value.QuerySize() + sizeof(ValueCacheEntry))
+{
+}
+
+ValueCacheEntry::~ValueCacheEntry()
+{
+}
+
+NTSTATUS ValueCacheEntry::Create(
+    __in ValueCacheKey const & key,
+    __in KBuffer & value,
+    __in KAllocator & allocator,
+    __out ValueCacheEntry::SPtr & result)
+{
+    result = _new(VALUECACHEENTRY_TAG, allocator) ValueCacheEntry(key, value);
+
+    if (!result)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,110 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace TStore
+    {
+        //
+        // Identifies a value on disk: the process unique cache id of its checkpoint file and its offset in the value file.
+        // Store file ids are only unique within one store and are reused across restore and copy, so they cannot be used here.
+        //
+        struct ValueCacheKey
+        {
+            ValueCacheKey()
+                : FileId(0),
+                Offset(0)
+            {
+            }
+
+            ValueCacheKey(
+                __in ULONG64 fileId,
+                __in LONG64 offset)
+                : FileId(fileId),
+                Offset(offset)
+            {
+            }
+
+            bool operator==(__in ValueCacheKey const & other) const
+            {
+                return FileId == other.FileId && Offset == other.Offset;
+            }
+
+            static ULONG Hash(__in ValueCacheKey const & key)
+            {
+                // Offsets within one file differ mostly in their low bits, so mix them into the whole word.
+                ULONG64 hash = key.FileId * 0x9E3779B97F4A7C15ULL + static_cast<ULONG64>(key.Offset);
+                hash ^= hash >> 33;
+                hash *= 0xFF51AFD7ED558CCDULL;
+                hash ^= hash >> 33;
+                return static_cast<ULONG>(hash);
+            }
+
+            ULONG64 FileId;
+            LONG64 Offset;
+        };
+
+        //
+        // A serialized value held by the ValueCache.
+        // The value bytes are immutable once the entry is created, so readers may use them without holding the cache lock.
+        //
+        class ValueCacheEntry :
+            public KObject<ValueCacheEntry>,
+            public KShared<ValueCacheEntry>
+        {
+            K_FORCE_SHARED(ValueCacheEntry)
+
+        public:
+
+            static NTSTATUS Create(
+                __in ValueCacheKey const & key,
+                __in KBuffer & value,
+                __in KAllocator & allocator,
+                __out ValueCacheEntry::SPtr & result);
+
+            __declspec(property(get = get_Key)) ValueCacheKey const & Key;
+            ValueCacheKey const & get_Key() const
+            {
+                return key_;
+            }
+
+            __declspec(property(get = get_Value)) KBuffer::SPtr Value;
+            KBuffer::SPtr get_Value() const
+            {
+                return valueSPtr_;
+            }
+
+            //
+            // Number of bytes charged against the cache budget, including the bookkeeping overhead of the entry.
+            //
+            __declspec(property(get = get_Charge)) ULONG64 Charge;
+            ULONG64 get_Charge() const
+            {
+                return charge_;
+            }
+
+            //
+            // State owned by the eviction policy of the shard the entry lives in.
+            // Only accessed under the shard lock.
+            //
+            KListEntry PolicyListEntry;
+            ULONG32 PolicyState;
+
+            static const ULONG PolicyListEntryOffset;
+
+        private:
+
+            ValueCacheEntry(
+                __in ValueCacheKey const & key,
+                __in KBuffer & value);
+
+            ValueCacheKey key_;
+            KBuffer::SPtr valueSPtr_;
+            ULONG64 charge_;
+        };
+    }
+}
@@ -0,0 +1,49 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+using namespace Data::TStore;
+
+NTSTATUS ValueCacheEvictionPolicyFactory::Create(
+    __in ValueCacheEvictionPolicyKind::Enum kind,
+    __in ULONG64 capacityInBytes,
+    __in KAllocator & allocator,
+    __out IValueCacheEvictionPolicy::SPtr & result)
+{
+    NTSTATUS status;
+
+    switch (kind)
+    {
+    case ValueCacheEvictionPolicyKind::SegmentedLru:
+    {
+        SegmentedLruEvictionPolicy::SPtr policySPtr = nullptr;
+        status = SegmentedLruEvictionPolicy::Create(capacityInBytes, allocator, policySPtr);
+        if (!NT_SUCCESS(status))
+        {
+            return status;
+        }
+
+        result = policySPtr.RawPtr();
+        return STATUS_SUCCESS;
+    }
+
+    case ValueCacheEvictionPolicyKind::Clock:
+    {
+        ClockEvictionPolicy::SPtr policySPtr = nullptr;
+        status = ClockEvictionPolicy::Create(allocator, policySPtr);
+        if (!NT_SUCCESS(status))
+        {
+            return status;
+        }
+
+        result = policySPtr.RawPtr();
+        return STATUS_SUCCESS;
+    }
+
+    default:
+        return STATUS_NOT_SUPPORTED;
+    }
+}
@@ -0,0 +1,27 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace TStore
+    {
+        class ValueCacheEvictionPolicyFactory
+        {
+        public:
+
+            //
+            // Creates the eviction policy for one ValueCache shard of the given capacity.
+            // Returns STATUS_NOT_SUPPORTED for an unknown kind.
+            //
+            static NTSTATUS Create(
+                __in ValueCacheEvictionPolicyKind::Enum kind,
+                __in ULONG64 capacityInBytes,
+                __in KAllocator & allocator,
+                __out IValueCacheEvictionPolicy::SPtr & result);
+        };
+    }
+}
@@ -17,7 +17,8 @@ ValueCheckpointFile::ValueCheckpointFile(
     __in StoreTraceComponent & traceComponent) : 
     filenameSPtr_(&filename),
     fileSPtr_(&file),
-    traceComponent_(&traceComponent)
+    traceComponent_(&traceComponent),
+    isMappingDisabled_(false)
 {
     StreamPool::StreamFactoryType fileStreamFactoryDelegate;
     fileStreamFactoryDelegate.Bind(this, &ValueCheckpointFile::CreateFileStreamAsync);
@@ -45,7 +46,8 @@ ValueCheckpointFile::ValueCheckpointFile(
     __in StoreTraceComponent & traceComponent) : 
     filenameSPtr_(&filename),
     fileSPtr_(&file),
-    traceComponent_(&traceComponent)
+    traceComponent_(&traceComponent),
+    isMappingDisabled_(false)
 {
     StreamPool::StreamFactoryType fileStreamFactoryDelegate;
     fileStreamFactoryDelegate.Bind(this, &ValueCheckpointFile::CreateFileStreamAsync);
@@ -250,7 +252,8 @@ ktl::Awaitable<void> ValueCheckpointFile::FlushAsync(
     STORE_ASSERT(NT_SUCCESS(status), "Error writing value checkpoint properties block. Status: {1}", status);
 
     // Write the Footer.
-    status = FileFooter::Create(*propertiesHandleSPtr, FileVersion, GetThisAllocator(), footerSPtr_);
+    int fileVersion = compressionCodecSPtr_ == nullptr ? FileVersion : CompressedFileVersion;
+    status = FileFooter::Create(*propertiesHandleSPtr, fileVersion, GetThisAllocator(), footerSPtr_);
     Diagnostics::Validate(status);
 
     BlockHandle::SPtr blockHandleSPtr = nullptr;
@@ -284,6 +287,133 @@ ktl::Awaitable<void> ValueCheckpointFile::FlushMemoryBufferAsync(
 }
 
 
+void ValueCheckpointFile::SetCompressionCodec(__in CompressionCodecId::Enum codecId)
+{
+    STORE_ASSERT(propertiesSPtr_->ValueCount == 0, "Compression codec must be set before values are written. ValueCount={1}", propertiesSPtr_->ValueCount);
+
+    if (codecId == CompressionCodecId::None)
+    {
+        compressionCodecSPtr_ = nullptr;
+    }
+    else
+    {
+        NTSTATUS status = CompressionCodecFactory::Create(codecId, GetThisAllocator(), compressionCodecSPtr_);
+        Diagnostics::Validate(status);
+    }
+
+    propertiesSPtr_->CompressionCodec = codecId;
+}
+
+void ValueCheckpointFile::EncodeValue(
+    __in BinaryWriter& memoryBuffer,
+    __in ULONG valueStartPosition)
+{
+    STORE_ASSERT(compressionCodecSPtr_ != nullptr, "Compression codec should not be null");
+
+    ULONG valueSize = memoryBuffer.Position - valueStartPosition;
+    KBuffer::SPtr valueSPtr = nullptr;
+    if (valueSize > 0)
+    {
+        valueSPtr = memoryBuffer.GetBuffer(valueStartPosition);
+    }
+
+    // Rewind and write the encoded value over the serialized one.
+    memoryBuffer.Position = valueStartPosition;
+
+    if (valueSize >= MinCompressedValueSize)
+    {
+        ULONG32 maxCompressedSize = compressionCodecSPtr_->GetMaxCompressedSize(valueSize);
+        if (compressionBufferSPtr_ == nullptr || compressionBufferSPtr_->QuerySize() < maxCompressedSize)
+        {
+            NTSTATUS status = KBuffer::Create(maxCompressedSize, compressionBufferSPtr_, GetThisAllocator(), VALUECHECKPOINTFILE_TAG);
+            Diagnostics::Validate(status);
+        }
+
+        ULONG32 compressedSize = compressionCodecSPtr_->Compress(
+            static_cast<byte const *>(valueSPtr->GetBuffer()),
+            valueSize,
+            static_cast<byte *>(compressionBufferSPtr_->GetBuffer()),
+            compressionBufferSPtr_->QuerySize());
+
+        // Only keep the compressed form if it saves more than the extra size field.
+        if (compressedSize > 0 && compressedSize + sizeof(ULONG32) < valueSize)
+        {
+            memoryBuffer.Write(static_cast<byte>(ValueEncoding::Compressed));
+            memoryBuffer.Write(static_cast<ULONG32>(valueSize));
+            memoryBuffer.Write(compressionBufferSPtr_.RawPtr(), compressedSize);
+            return;
+        }
+    }
+
+    memoryBuffer.Write(static_cast<byte>(ValueEncoding::Raw));
+    if (valueSPtr != nullptr)
+    {
+        memoryBuffer.Write(*valueSPtr);
+    }
+}
+
+KBuffer::SPtr ValueCheckpointFile::DecodeValue(__in KBuffer const & encodedValue)
+{
+    return DecodeValue(static_cast<byte const *>(encodedValue.GetBuffer()), encodedValue.QuerySize());
+}
+
+KBuffer::SPtr ValueCheckpointFile::DecodeValue(
+    __in byte const * encodedBytes,
+    __in ULONG32 encodedSize)
+{
+    STORE_ASSERT(compressionCodecSPtr_ != nullptr, "Compression codec should not be null");
+
+    if (encodedSize < sizeof(byte))
+    {
+        throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+    }
+
+    KBuffer::SPtr valueSPtr = nullptr;
+    NTSTATUS status;
+
+    if (encodedBytes[0] == ValueEncoding::Raw)
+    {
+        ULONG32 valueSize = encodedSize - sizeof(byte);
+        status = KBuffer::Create(valueSize, valueSPtr, GetThisAllocator(), VALUECHECKPOINTFILE_TAG);
+        Diagnostics::Validate(status);
+
+        if (valueSize > 0)
+        {
+            KMemCpySafe(valueSPtr->GetBuffer(), valueSize, encodedBytes + sizeof(byte), valueSize);
+        }
+
+        return valueSPtr;
+    }
+
+    const ULONG32 headerSize = sizeof(byte) + sizeof(ULONG32);
+    if (encodedBytes[0] != ValueEncoding::Compressed || encodedSize < headerSize)
+    {
+        throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+    }
+
+    ULONG32 valueSize = 0;
+    KMemCpySafe(&valueSize, sizeof(valueSize), encodedBytes + sizeof(byte), sizeof(ULONG32));
+    if (valueSize < MinCompressedValueSize)
+    {
+        throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+    }
+
+    status = KBuffer::Create(valueSize, valueSPtr, GetThisAllocator(), VALUECHECKPOINTFILE_TAG);
+    Diagnostics::Validate(status);
+
+    status = compressionCodecSPtr_->Decompress(
+        encodedBytes + headerSize,
+        encodedSize - headerSize,
+        static_cast<byte *>(valueSPtr->GetBuffer()),
+        valueSize);
+    if (!NT_SUCCESS(status))
+    {
+        throw ktl::Exception(status);
+    }
+
+    return valueSPtr;
+}
+
 ktl::Awaitable<void> ValueCheckpointFile::ReadMetadataAsync()
 {
     ktl::io::KFileStream::SPtr filestreamSPtr = nullptr;
@@ -312,7 +442,7 @@ ktl::Awaitable<void> ValueCheckpointFile::ReadMetadataAsync()
         footerSPtr_ = co_await FileBlock<FileFooter::SPtr>::ReadBlockAsync(*filestreamSPtr, *footerHandleSPtr, footerFunc, GetThisAllocator(), ktl::CancellationToken::None);
 
         // Verify we know how to deserialize this version of the checkpoint file.
-        if (footerSPtr_->Version != FileVersion)
+        if (footerSPtr_->Version != FileVersion && footerSPtr_->Version != CompressedFileVersion)
         {
             throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION); 
         }
@@ -328,6 +458,13 @@ ktl::Awaitable<void> ValueCheckpointFile::ReadMetadataAsync()
             propFunc,
             GetThisAllocator(),
             ktl::CancellationToken::None);
+
+        // Files written before compression was introduced have no codec, and their values are read as is.
+        if (propertiesSPtr_->CompressionCodec != CompressionCodecId::None)
+        {
+            status = CompressionCodecFactory::Create(propertiesSPtr_->CompressionCodec, GetThisAllocator(), compressionCodecSPtr_);
+            Diagnostics::Validate(status);
+        }
     }
     catch (ktl::Exception const& e)
     {
@@ -406,8 +543,117 @@ ktl::Awaitable<ktl::io::KFileStream::SPtr> ValueCheckpointFile::CreateFileStream
     co_return filestreamSPtr;
 }
 
+void ValueCheckpointFile::EnableMappedReads(__in MappedFileBudget & budget)
+{
+    K_LOCK_BLOCK(mappedViewLock_)
+    {
+        if (mappedFileBudgetSPtr_ == nullptr)
+        {
+            mappedFileBudgetSPtr_ = &budget;
+        }
+    }
+}
+
+MappedFileView::SPtr ValueCheckpointFile::TryGetMappedView()
+{
+    MappedFileBudget::SPtr budgetSPtr = nullptr;
+
+    K_LOCK_BLOCK(mappedViewLock_)
+    {
+        if (mappedViewSPtr_ != nullptr || mappedFileBudgetSPtr_ == nullptr || isMappingDisabled_)
+        {
+            return mappedViewSPtr_;
+        }
+
+        budgetSPtr = mappedFileBudgetSPtr_;
+    }
+
+    // Map outside the lock. Racing readers may each map the file; all but the first mapping installed are dropped.
+    // Only the values are mapped, since nothing else in the file is read after it is opened.
+    MappedFileView::SPtr newViewSPtr = nullptr;
+    NTSTATUS status = MappedFileView::Create(
+        *filenameSPtr_,
+        propertiesSPtr_->ValuesHandle->EndOffset(),
+        false,
+        *budgetSPtr,
+        GetThisAllocator(),
+        newViewSPtr);
+
+    K_LOCK_BLOCK(mappedViewLock_)
+    {
+        if (!NT_SUCCESS(status))
+        {
+            // Space may be freed up by other files later on, so a full budget is retried on the next read.
+            if (status != STATUS_QUOTA_EXCEEDED)
+            {
+                isMappingDisabled_ = true;
+            }
+
+            return nullptr;
+        }
+
+        if (isMappingDisabled_)
+        {
+            // Closed while mapping; the view is released as soon as this read completes.
+            return newViewSPtr;
+        }
+
+        if (mappedViewSPtr_ == nullptr)
+        {
+            mappedViewSPtr_ = newViewSPtr;
+        }
+
+        return mappedViewSPtr_;
+    }
+
+    return nullptr;
+}
+
+bool ValueCheckpointFile::TryReadMappedValue(
+    __in MappedFileView const & mappedView,
+    __in LONG64 offset,
+    __in ULONG32 size,
+    __in ULONG64 expectedChecksum,
+    __out KBuffer::SPtr & value)
+{
+    STORE_ASSERT(offset >= 0, "Offset={1} should be non-negative", offset);
+    byte const * bytes = mappedView.GetBytes(static_cast<ULONG64>(offset), size);
+
+    // The checksum covers the bytes on disk, so it is verified in place before anything is copied out of the mapping.
+    if (CRC64::ToCRC64(bytes, 0, size) != expectedChecksum)
+    {
+        return false;
+    }
+
+    if (compressionCodecSPtr_ != nullptr)
+    {
+        value = DecodeValue(bytes, size);
+        return true;
+    }
+
+    NTSTATUS status = KBuffer::Create(size, value, GetThisAllocator(), VALUECHECKPOINTFILE_TAG);
+    Diagnostics::Validate(status);
+
+    if (size > 0)
+    {
+        KMemCpySafe(value->GetBuffer(), size, bytes, size);
+    }
+
+    return true;
+}
+
 ktl::Awaitable<void> ValueCheckpointFile::CloseAsync()
 {
+    // Reads already holding the view keep it alive until they complete.
+    MappedFileView::SPtr mappedViewSPtr = nullptr;
+    K_LOCK_BLOCK(mappedViewLock_)
+    {
+        isMappingDisabled_ = true;
+        mappedViewSPtr = Ktl::Move(mappedViewSPtr_);
+    }
+
+    mappedViewSPtr = nullptr;
+
     co_await streamPool_->CloseAsync();
     if (fileSPtr_ != nullptr)
     {
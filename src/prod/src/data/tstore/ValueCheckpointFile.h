@@ -55,11 +55,31 @@ namespace Data
             //
             static const int FileVersion = 1;
 
+            //
+            // Version written for files with compressed values, so that older binaries refuse them instead of misreading them.
+            //
+            static const int CompressedFileVersion = 2;
+
+            //
+            // Values smaller than this are not worth compressing and are always stored as is.
+            //
+            static const ULONG32 MinCompressedValueSize = 64;
+
             //
             // Buffer in memory approximately 32 KB of data before flushing to disk.
             //
             static const int MemoryBufferFlushSize = 32 * 1024;
 
+            //
+            // ReadValuesAsync reads neighbouring values with one IO as long as the bytes between them are no more than this.
+            //
+            static const LONG64 MaxCoalescedReadGap = 4 * 1024;
+
+            //
+            // Upper bound on the size of a single coalesced read issued by ReadValuesAsync.
+            //
+            static const LONG64 MaxCoalescedReadSize = 256 * 1024;
+
             //
             // The file extension for TStore checkpoint files that hold the serialized values.
             //
@@ -105,12 +125,33 @@ namespace Data
                 return filenameSPtr_.RawPtr();
             }
 
+            //
+            // Gets the codec the values in this file are compressed with.
+            //
+            __declspec(property(get = get_CompressionCodec)) CompressionCodecId::Enum CompressionCodec;
+            CompressionCodecId::Enum get_CompressionCodec() const
+            {
+                return propertiesSPtr_->CompressionCodec;
+            }
+
+            //
+            // Compress the values subsequently written to this file with the given codec.
+            // Must be called before the first value is written.
+            //
+            void SetCompressionCodec(__in CompressionCodecId::Enum codecId);
+
             __declspec(property(get = get_StreamPool)) StreamPool::SPtr StreamPoolSPtr;
             StreamPool::SPtr get_StreamPool() const
             {
                 return streamPool_;
             }
 
+            //
+            // Serve subsequent value reads from a read only mapping of the file, charged against the given budget.
+            // The mapping is made on the first read; while it does not fit in the budget, reads keep going through the stream pool.
+            //
+            void EnableMappedReads(__in MappedFileBudget & budget);
+
             //
             // Opens a ValueCheckpointFile from the given file.
             // The file stream will be disposed when the checkpoint file is disposed.
@@ -139,16 +180,29 @@ namespace Data
                 {
                     throw ktl::Exception(K_STATUS_OUT_OF_BOUNDS);
                 }
-                if (item->GetValueSize() < 0)
+                if (item->GetOnDiskValueSize() < 0)
                 {
                     throw ktl::Exception(K_STATUS_OUT_OF_BOUNDS);
                 }
 
-                if (static_cast<ULONG64>(item->GetOffset() + item->GetValueSize()) > propertiesSPtr_->ValuesHandle->EndOffset())
+                if (static_cast<ULONG64>(item->GetOffset() + item->GetOnDiskValueSize()) > propertiesSPtr_->ValuesHandle->EndOffset())
                 {
                     throw ktl::Exception(K_STATUS_OUT_OF_BOUNDS);
                 }
 
+                MappedFileView::SPtr mappedViewSPtr = TryGetMappedView();
+                if (mappedViewSPtr != nullptr)
+                {
+                    KBuffer::SPtr mappedValueSPtr = nullptr;
+                    if (!TryReadMappedValue(*mappedViewSPtr, *item, mappedValueSPtr))
+                    {
+                        throw ktl::Exception(SF_STATUS_INVALID_OPERATION);
+                    }
+
+                    BinaryReader mappedValueReader(*mappedValueSPtr, GetThisAllocator());
+                    co_return valueSerializer.Read(mappedValueReader);
+                }
+
                 ktl::io::KFileStream::SPtr fileStreamSPtr = nullptr;
                 SharedException::CSPtr exception = nullptr;
 
@@ -159,7 +213,7 @@ namespace Data
                     //read from disk.
                     KBuffer::SPtr bufferSPtr = nullptr;
                     ULONG bytesRead = 0;
-                    ULONG size = static_cast<ULONG>(item->GetValueSize());
+                    ULONG size = static_cast<ULONG>(item->GetOnDiskValueSize());
                     LONG64 offset = item->GetOffset();
 
                     NTSTATUS status = KBuffer::Create(
@@ -176,8 +230,6 @@ namespace Data
                     STORE_ASSERT(NT_SUCCESS(status), "Failed to read from file. status={1}", status);
                     STORE_ASSERT(bytesRead == size, "Did not read correct number of bytes. bytesRead={1} expected={2}", bytesRead, size);
 
-                    BinaryReader reader(*bufferSPtr, GetThisAllocator());
-
                     // Read the checksum from memory.
                     ULONG64 checksum = item->GetValueChecksum();
 
@@ -188,6 +240,14 @@ namespace Data
                         throw ktl::Exception(SF_STATUS_INVALID_OPERATION);
                     }
 
+                    // The checksum covers the bytes on disk, so it is verified before decompressing.
+                    if (compressionCodecSPtr_ != nullptr)
+                    {
+                        bufferSPtr = DecodeValue(*item, *bufferSPtr);
+                    }
+
+                    BinaryReader reader(*bufferSPtr, GetThisAllocator());
+
                     // Deserialize the value into memory.
                     TValue value = valueSerializer.Read(reader);
                     co_await streamPool_->ReleaseStreamAsync(*fileStreamSPtr);
@@ -224,6 +284,18 @@ namespace Data
             {
                 KSharedPtr<VersionedItem<TValue>>item(&versionItem);
 
+                MappedFileView::SPtr mappedViewSPtr = TryGetMappedView();
+                if (mappedViewSPtr != nullptr)
+                {
+                    KBuffer::SPtr mappedValueSPtr = nullptr;
+                    if (!TryReadMappedValue(*mappedViewSPtr, *item, mappedValueSPtr))
+                    {
+                        throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+                    }
+
+                    co_return mappedValueSPtr;
+                }
+
                 ktl::io::KFileStream::SPtr fileStreamSPtr = nullptr;
                 SharedException::CSPtr exception = nullptr;
 
@@ -234,7 +306,7 @@ namespace Data
                     //read from disk.
                     KBuffer::SPtr bufferSPtr = nullptr;
                     ULONG bytesRead = 0;
-                    ULONG size = static_cast<ULONG>(item->GetValueSize());
+                    ULONG size = static_cast<ULONG>(item->GetOnDiskValueSize());
                     LONG64 offset = item->GetOffset();
 
                     NTSTATUS status = KBuffer::Create(
@@ -260,6 +332,12 @@ namespace Data
                     {
                         throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
                     }
+
+                    // Callers get the serialized value, never the compressed bytes.
+                    if (compressionCodecSPtr_ != nullptr)
+                    {
+                        bufferSPtr = DecodeValue(*item, *bufferSPtr);
+                    }
                     
                     co_await streamPool_->ReleaseStreamAsync(*fileStreamSPtr);
                     fileStreamSPtr = nullptr;
@@ -285,6 +363,180 @@ namespace Data
                 }
             }
 
+            //
+            // Read the given values from disk, returning their serialized bytes in the order of the given items.
+            // Values are read in offset order through a single stream, and values that lie close together are fetched with one read.
+            //
+            template<typename TValue>
+            ktl::Awaitable<KSharedPtr<KSharedArray<KBuffer::SPtr>>> ReadValuesAsync(
+                __in KSharedArray<KSharedPtr<VersionedItem<TValue>>>& items)
+            {
+                KSharedPtr<KSharedArray<KSharedPtr<VersionedItem<TValue>>>> itemsSPtr = &items;
+
+                KSharedPtr<KSharedArray<KBuffer::SPtr>> valuesSPtr = _new(VALUECHECKPOINTFILE_TAG, GetThisAllocator()) KSharedArray<KBuffer::SPtr>();
+                Diagnostics::Validate(valuesSPtr);
+
+                NTSTATUS status = valuesSPtr->Reserve(itemsSPtr->Count());
+                Diagnostics::Validate(status);
+
+                status = valuesSPtr->SetCount(itemsSPtr->Count());
+                Diagnostics::Validate(status);
+
+                // Pair each offset with the index of its item, so the reads can be issued in file order.
+                KSharedPtr<KSharedArray<KeyValuePair<LONG64, ULONG32>>> offsetsSPtr = _new(VALUECHECKPOINTFILE_TAG, GetThisAllocator()) KSharedArray<KeyValuePair<LONG64, ULONG32>>();
+                Diagnostics::Validate(offsetsSPtr);
+
+                for (ULONG32 i = 0; i < itemsSPtr->Count(); i++)
+                {
+                    VersionedItem<TValue>& item = *(*itemsSPtr)[i];
+                    STORE_ASSERT(item.GetRecordKind() != RecordKind::DeletedVersion, "VersionedItem should not be DeletedVersion");
+
+                    // Validate that the item's disk properties are valid.
+                    if (item.GetOffset() < 0 || static_cast<ULONG64>(item.GetOffset()) < propertiesSPtr_->ValuesHandle->Offset)
+                    {
+                        throw ktl::Exception(K_STATUS_OUT_OF_BOUNDS);
+                    }
+                    if (item.GetOnDiskValueSize() < 0)
+                    {
+                        throw ktl::Exception(K_STATUS_OUT_OF_BOUNDS);
+                    }
+                    if (static_cast<ULONG64>(item.GetOffset() + item.GetOnDiskValueSize()) > propertiesSPtr_->ValuesHandle->EndOffset())
+                    {
+                        throw ktl::Exception(K_STATUS_OUT_OF_BOUNDS);
+                    }
+
+                    status = offsetsSPtr->Append(KeyValuePair<LONG64, ULONG32>(item.GetOffset(), i));
+                    Diagnostics::Validate(status);
+                }
+
+                // With a mapping there is no IO to order or coalesce.
+                MappedFileView::SPtr mappedViewSPtr = TryGetMappedView();
+                if (mappedViewSPtr != nullptr)
+                {
+                    for (ULONG32 i = 0; i < itemsSPtr->Count(); i++)
+                    {
+                        KBuffer::SPtr mappedValueSPtr = nullptr;
+                        if (!TryReadMappedValue(*mappedViewSPtr, *(*itemsSPtr)[i], mappedValueSPtr))
+                        {
+                            throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+                        }
+
+                        (*valuesSPtr)[i] = mappedValueSPtr;
+                    }
+
+                    co_return valuesSPtr;
+                }
+
+                LongComparer::SPtr longComparerSPtr = nullptr;
+                status = LongComparer::Create(GetThisAllocator(), longComparerSPtr);
+                Diagnostics::Validate(status);
+
+                SortedItemComparer<LONG64, ULONG32>::SPtr offsetComparerSPtr = nullptr;
+                status = SortedItemComparer<LONG64, ULONG32>::Create(*longComparerSPtr, GetThisAllocator(), offsetComparerSPtr);
+                Diagnostics::Validate(status);
+
+                Sorter<KeyValuePair<LONG64, ULONG32>>::QuickSort(true, *offsetComparerSPtr, offsetsSPtr);
+
+                ktl::io::KFileStream::SPtr fileStreamSPtr = nullptr;
+                SharedException::CSPtr exception = nullptr;
+
+                try
+                {
+                    fileStreamSPtr = co_await streamPool_->AcquireStreamAsync();
+
+                    ULONG32 runStart = 0;
+                    while (runStart < offsetsSPtr->Count())
+                    {
+                        // Extend the run while the next value starts close to the end of the previous one.
+                        LONG64 runOffset = (*offsetsSPtr)[runStart].Key;
+                        LONG64 runEndOffset = runOffset + (*itemsSPtr)[(*offsetsSPtr)[runStart].Value]->GetOnDiskValueSize();
+                        ULONG32 runEnd = runStart + 1;
+                        while (runEnd < offsetsSPtr->Count())
+                        {
+                            VersionedItem<TValue>& next = *(*itemsSPtr)[(*offsetsSPtr)[runEnd].Value];
+                            LONG64 nextEndOffset = next.GetOffset() + next.GetOnDiskValueSize();
+                            if (next.GetOffset() - runEndOffset > MaxCoalescedReadGap || nextEndOffset - runOffset > MaxCoalescedReadSize)
+                            {
+                                break;
+                            }
+
+                            if (nextEndOffset > runEndOffset)
+                            {
+                                runEndOffset = nextEndOffset;
+                            }
+
+                            runEnd++;
+                        }
+
+                        ULONG runSize = static_cast<ULONG>(runEndOffset - runOffset);
+                        KBuffer::SPtr runBufferSPtr = nullptr;
+                        status = KBuffer::Create(runSize > 0 ? runSize : 1, runBufferSPtr, GetThisAllocator());
+                        Diagnostics::Validate(status);
+
+                        if (runSize > 0)
+                        {
+                            ULONG bytesRead = 0;
+                            fileStreamSPtr->SetPosition(runOffset);
+                            status = co_await fileStreamSPtr->ReadAsync(*runBufferSPtr, bytesRead, 0, runSize);
+                            STORE_ASSERT(NT_SUCCESS(status), "Failed to read from file. status={1}", status);
+                            STORE_ASSERT(bytesRead == runSize, "Read incorrect number of bytes. bytesRead={1} size={2}", bytesRead, runSize);
+                        }
+
+                        for (ULONG32 i = runStart; i < runEnd; i++)
+                        {
+                            ULONG32 itemIndex = (*offsetsSPtr)[i].Value;
+                            VersionedItem<TValue>& item = *(*itemsSPtr)[itemIndex];
+                            ULONG size = static_cast<ULONG>(item.GetOnDiskValueSize());
+                            ULONG valueOffset = static_cast<ULONG>(item.GetOffset() - runOffset);
+
+                            // The checksum covers the bytes on disk, so it is verified before decompressing.
+                            ULONG64 expectedChecksum = CRC64::ToCRC64(*runBufferSPtr, valueOffset, static_cast<ULONG32>(size));
+                            if (item.GetValueChecksum() != expectedChecksum)
+                            {
+                                throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+                            }
+
+                            // Each value gets its own buffer, so that a cached value does not pin the whole run in memory.
+                            KBuffer::SPtr bufferSPtr = nullptr;
+                            status = KBuffer::Create(size, bufferSPtr, GetThisAllocator());
+                            Diagnostics::Validate(status);
+                            if (size > 0)
+                            {
+                                bufferSPtr->CopyFrom(0, *runBufferSPtr, valueOffset, size);
+                            }
+
+                            if (compressionCodecSPtr_ != nullptr)
+                            {
+                                bufferSPtr = DecodeValue(item, *bufferSPtr);
+                            }
+
+                            (*valuesSPtr)[itemIndex] = bufferSPtr;
+                        }
+
+                        runStart = runEnd;
+                    }
+
+                    co_await streamPool_->ReleaseStreamAsync(*fileStreamSPtr);
+                    fileStreamSPtr = nullptr;
+
+                    co_return valuesSPtr;
+                }
+                catch (ktl::Exception const& e)
+                {
+                    exception = SharedException::Create(e, GetThisAllocator());
+                }
+
+                if (fileStreamSPtr != nullptr && fileStreamSPtr->IsOpen())
+                {
+                    co_await streamPool_->ReleaseStreamAsync(*fileStreamSPtr);
+                    fileStreamSPtr = nullptr;
+                }
+
+                //clang compiler error, needs to assign before throw.
+                auto ex = exception->Info;
+                throw ex;
+            }
+
             //
             // Add a value to the given file stream, using the memory buffer to stage writes before issuing bulk disk IOs.
             //
@@ -349,6 +601,11 @@ namespace Data
                     // Serialize the value.
                     ULONG valueStartPosition = memoryBuffer.Position;
                     valueSerializer.Write(item.GetValue(), memoryBuffer);
+                    if (compressionCodecSPtr_ != nullptr)
+                    {
+                        EncodeValue(memoryBuffer, valueStartPosition);
+                    }
+
                     ULONG valueEndPosition = memoryBuffer.Position;
                     STORE_ASSERT(valueEndPosition >= valueStartPosition, "valueEndPosition={1} >= valueStartPosition={2}", valueEndPosition, valueStartPosition);
 
@@ -356,9 +613,9 @@ namespace Data
                     ULONG32 valueSize = static_cast<ULONG32>(valueEndPosition - valueStartPosition);
                     ULONG64 checksum = CRC64::ToCRC64(*memoryBuffer.GetBuffer(0), static_cast<ULONG32>(valueStartPosition), valueSize);
 
-                    // Update the in-memory offset and size for this item.
+                    // Update the in-memory offset and on-disk size for this item.
                     item.SetOffset(static_cast<LONG64>(basePosition + valueStartPosition), *traceComponent_);
-                    item.SetValueSize(static_cast<int>(valueSize));
+                    item.SetOnDiskValueSize(static_cast<int>(valueSize));
                     item.SetValueChecksum(checksum);
 
                     // Update checkpoint file in-memory metadata.
@@ -383,6 +640,10 @@ namespace Data
                     // Serialize the value.
                     ULONG valueStartPosition = memoryBuffer.Position;
                     memoryBuffer.Write(value);
+                    if (compressionCodecSPtr_ != nullptr)
+                    {
+                        EncodeValue(memoryBuffer, valueStartPosition);
+                    }
 
                     ULONG valueEndPosition = memoryBuffer.Position;
                     STORE_ASSERT(valueEndPosition >= valueStartPosition, "valueEndPosition={1} >= valueStartPosition={2}", valueEndPosition, valueStartPosition);
@@ -391,9 +652,9 @@ namespace Data
                     ULONG32 valueSize = static_cast<ULONG32>(valueEndPosition - valueStartPosition);
                     ULONG64 checksum = CRC64::ToCRC64(*memoryBuffer.GetBuffer(0), static_cast<ULONG32>(valueStartPosition), valueSize);
 
-                    // Update the in-memory offset and size for this item.
+                    // Update the in-memory offset and on-disk size for this item.
                     item.SetOffset(static_cast<LONG64>(basePosition + valueStartPosition), *traceComponent_);
-                    item.SetValueSize(static_cast<int>(valueSize));
+                    item.SetOnDiskValueSize(static_cast<int>(valueSize));
                     item.SetValueChecksum(checksum);
 
                     // Update checkpoint file in-memory metadata.
@@ -404,6 +665,84 @@ namespace Data
                 item.SetFileId(FileId);
             }
 
+            //
+            // Each value in a file with a compression codec is prefixed with its encoding.
+            //
+            enum ValueEncoding : byte
+            {
+                Raw = 0,
+                Compressed = 1
+            };
+
+            //
+            // Replaces the serialized value written at valueStartPosition with its encoded form:
+            // Name                Type        Size
+            //
+            // Encoding            byte        1
+            // ValueSize           int         4          Compressed only, size of the serialized value
+            // Value               bytes       ...        Compressed or raw serialized value
+            //
+            void EncodeValue(
+                __in BinaryWriter& memoryBuffer,
+                __in ULONG valueStartPosition);
+
+            KBuffer::SPtr DecodeValue(__in KBuffer const & encodedValue);
+
+            //
+            // Decodes a value read for the item and records its serialized size, which is what the value takes in memory once loaded.
+            //
+            template<typename TValue>
+            KBuffer::SPtr DecodeValue(
+                __in VersionedItem<TValue>& item,
+                __in KBuffer const & encodedValue)
+            {
+                KBuffer::SPtr valueSPtr = DecodeValue(encodedValue);
+                item.SetValueSize(static_cast<LONG32>(valueSPtr->QuerySize()));
+                return valueSPtr;
+            }
+
+            KBuffer::SPtr DecodeValue(
+                __in byte const * encodedBytes,
+                __in ULONG32 encodedSize);
+
+            //
+            // Returns the mapping of the file, making it first if mapped reads are enabled, or null if reads should use the stream pool.
+            //
+            MappedFileView::SPtr TryGetMappedView();
+
+            //
+            // Copies the serialized value of the item out of the mapping, decompressing it on the way if needed.
+            // Records the serialized size of a decompressed value on the item, like DecodeValue.
+            // Returns false if the bytes in the mapping do not match the item's checksum.
+            //
+            template<typename TValue>
+            bool TryReadMappedValue(
+                __in MappedFileView const & mappedView,
+                __in VersionedItem<TValue> & item,
+                __out KBuffer::SPtr & value)
+            {
+                bool isValid = TryReadMappedValue(
+                    mappedView,
+                    item.GetOffset(),
+                    static_cast<ULONG32>(item.GetOnDiskValueSize()),
+                    item.GetValueChecksum(),
+                    value);
+
+                if (isValid && compressionCodecSPtr_ != nullptr)
+                {
+                    item.SetValueSize(static_cast<LONG32>(value->QuerySize()));
+                }
+
+                return isValid;
+            }
+
+            bool TryReadMappedValue(
+                __in MappedFileView const & mappedView,
+                __in LONG64 offset,
+                __in ULONG32 size,
+                __in ULONG64 expectedChecksum,
+                __out KBuffer::SPtr & value);
+
             //
             // Deserializes the metadata (footer, properties, etc.) for this checkpoint file.
             //
@@ -422,6 +761,18 @@ namespace Data
 
             StoreTraceComponent::SPtr traceComponent_;
 
+            ICompressionCodec::SPtr compressionCodecSPtr_;
+
+            // Scratch space for compressing values, only used by the single writer of the file.
+            KBuffer::SPtr compressionBufferSPtr_;
+
+            KSpinLock mappedViewLock_;
+            MappedFileBudget::SPtr mappedFileBudgetSPtr_;
+            MappedFileView::SPtr mappedViewSPtr_;
+
+            // Set once the file is closed or could not be mapped for a reason other than the budget.
+            bool isMappingDisabled_;
+
             //
             // Create a new key checkpoint file with the given filename.
             //
@@ -13,7 +13,8 @@ using namespace Data::Utilities;
 ValueCheckpointFileProperties::ValueCheckpointFileProperties()
     :valuesHandleSPtr_(nullptr),
     valueCount_(0),
-    fileId_(0)
+    fileId_(0),
+    compressionCodec_(CompressionCodecId::None)
 {
 }
 
@@ -68,6 +69,16 @@ void ValueCheckpointFileProperties::Write(__in BinaryWriter& writer)
     writer.Write(fileId_);
     ByteAlignedReaderWriterHelper::WritePaddingUntilAligned(writer);
 
+    // 'CompressionCodec' - int
+    if (compressionCodec_ != CompressionCodecId::None)
+    {
+        writer.Write(static_cast<ULONG32>(PropertyId::CompressionCodecProp));
+        VarInt::Write(writer, static_cast<ULONG32>(sizeof(ULONG32)));
+        ByteAlignedReaderWriterHelper::WritePaddingUntilAligned(writer);
+        writer.Write(static_cast<ULONG32>(compressionCodec_));
+        ByteAlignedReaderWriterHelper::WritePaddingUntilAligned(writer);
+    }
+
     ByteAlignedReaderWriterHelper::AssertIfNotAligned(writer.Position);
 }
 
@@ -92,6 +103,15 @@ void ValueCheckpointFileProperties::ReadProperty(
         ByteAlignedReaderWriterHelper::ReadPaddingUntilAligned(reader);
         break;
 
+    case PropertyId::CompressionCodecProp:
+    {
+        ULONG32 compressionCodec = 0;
+        reader.Read(compressionCodec);
+        compressionCodec_ = static_cast<CompressionCodecId::Enum>(compressionCodec);
+        ByteAlignedReaderWriterHelper::ReadPaddingUntilAligned(reader);
+        break;
+    }
+
     default:
         FilePropertySection::ReadProperty(reader, property, valueSize);
         ByteAlignedReaderWriterHelper::ReadPaddingUntilAligned(reader);
@@ -54,6 +54,19 @@ namespace Data
                 fileId_ = value;
             }
 
+            //
+            // Codec used to compress the values in the file. Files written without compression do not have this property.
+            //
+            __declspec(property(get = get_CompressionCodec, put = set_CompressionCodec)) CompressionCodecId::Enum CompressionCodec;
+            CompressionCodecId::Enum get_CompressionCodec() const
+            {
+                return compressionCodec_;
+            }
+            void set_CompressionCodec(__in CompressionCodecId::Enum value)
+            {
+                compressionCodec_ = value;
+            }
+
             //
             // Serialize ValueCheckpointFileProperties into the given stream.
             // The data is written is 8 bytes aligned.
@@ -75,6 +88,13 @@ namespace Data
             // FileId              bytes       4
             // RESERVED                        4
             // 
+            // Optional, only written when CompressionCodec is not None:
+            // CompressionCodec.PID int        4
+            // Size                VarInt      1
+            // RESERVED                        3
+            // CompressionCodec    int         4
+            // RESERVED                        4
+            // 
             // RESERVED: Fixed padding that is usable to add fields in future.
             // PADDING:  Due to dynamic size, cannot be used for adding fields.
             //
@@ -95,11 +115,13 @@ namespace Data
                 ValuesHandleProp = 1,
                 ValueCountProp = 2,
                 FileIdProp = 3,
+                CompressionCodecProp = 4,
             };
 
             BlockHandle::SPtr valuesHandleSPtr_;
             ULONG64 valueCount_;
             ULONG32 fileId_;
+            CompressionCodecId::Enum compressionCodec_;
 
         };
     }
@@ -66,6 +66,7 @@ namespace Data
             versionSequenceNumber_ = value;
          }
 
+         // Size of the serialized value, which is what the value is charged for while it is in memory
          virtual LONG32 GetValueSize() const
          {
             return valueSize_;
@@ -76,6 +77,17 @@ namespace Data
             valueSize_ = valueSize;
          }
 
+         // Size of the value in its checkpoint file, which is smaller than the serialized size if the file is compressed
+         virtual LONG32 GetOnDiskValueSize() const
+         {
+            return onDiskValueSize_;
+         }
+
+         virtual void SetOnDiskValueSize(__in LONG32 valueSize)
+         {
+            onDiskValueSize_ = valueSize;
+         }
+
          virtual ULONG64 GetValueChecksum() const
          {
             return valueChecksum_;
@@ -331,6 +343,7 @@ namespace Data
 
          ULONG32     fileId_ = 0;
          LONG32      valueSize_ = -1;
+         LONG32      onDiskValueSize_ = -1;
          ULONG64    valueChecksum_ = 0;
 
       private:
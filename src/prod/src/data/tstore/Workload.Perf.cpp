@@ -0,0 +1,105 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#include <boost/test/unit_test.hpp>
+#include "Common/boost-taef.h"
+
+namespace TStoreTests
+{
+    using namespace ktl;
+    using namespace Data::Utilities;
+
+    class LongBufferWorkloadPerfTest : public TStoreWorkloadPerfTestBase<LONG64, KBuffer::SPtr, LongComparer, TestStateSerializer<LONG64>, KBufferSerializer>
+    {
+    public:
+        Common::CommonConfig config; // load the config object as it's needed for the tracing to work
+
+        LONG64 CreateWorkloadKey(__in ULONG64 keyNumber) override
+        {
+            return static_cast<LONG64>(keyNumber);
+        }
+
+        KBuffer::SPtr CreateWorkloadValue(__in ULONG32 sizeInBytes, __in ULONG64 keyNumber) override
+        {
+            // CreateBuffer fills whole ULONG32s.
+            ULONG32 alignedSize = ((sizeInBytes + sizeof(ULONG32) - 1) / sizeof(ULONG32)) * sizeof(ULONG32);
+            return CreateBuffer(alignedSize, static_cast<ULONG32>(keyNumber));
+        }
+
+        LongBufferWorkloadPerfTest()
+        {
+            Setup(1);
+        }
+
+        ~LongBufferWorkloadPerfTest()
+        {
+            Cleanup();
+        }
+    };
+
+    BOOST_FIXTURE_TEST_SUITE(LongBufferWorkloadPerfSuite, LongBufferWorkloadPerfTest, *boost::unit_test::label("perf-cit"))
+
+    // Naming Convention: Workload_{YCSB core workload}_{variation}
+
+    BOOST_AUTO_TEST_CASE(Workload_YcsbA_Perf)
+    {
+        RunWorkload(WorkloadSpec::CoreWorkload('A'));
+    }
+
+    BOOST_AUTO_TEST_CASE(Workload_YcsbB_Perf)
+    {
+        RunWorkload(WorkloadSpec::CoreWorkload('B'));
+    }
+
+    BOOST_AUTO_TEST_CASE(Workload_YcsbC_Perf)
+    {
+        RunWorkload(WorkloadSpec::CoreWorkload('C'));
+    }
+
+    BOOST_AUTO_TEST_CASE(Workload_YcsbD_Perf)
+    {
+        RunWorkload(WorkloadSpec::CoreWorkload('D'));
+    }
+
+    BOOST_AUTO_TEST_CASE(Workload_YcsbE_Perf)
+    {
+        RunWorkload(WorkloadSpec::CoreWorkload('E'));
+    }
+
+    BOOST_AUTO_TEST_CASE(Workload_YcsbF_Perf)
+    {
+        RunWorkload(WorkloadSpec::CoreWorkload('F'));
+    }
+
+    BOOST_AUTO_TEST_CASE(Workload_YcsbB_Uniform_Perf)
+    {
+        WorkloadSpec spec = WorkloadSpec::CoreWorkload('B');
+        spec.Name += "-uniform";
+        spec.KeyDistribution = WorkloadKeyDistribution::Uniform;
+        RunWorkload(spec);
+    }
+
+    BOOST_AUTO_TEST_CASE(Workload_YcsbA_VariableValueSize_Perf)
+    {
+        WorkloadSpec spec = WorkloadSpec::CoreWorkload('A');
+        spec.Name += "-variable";
+        spec.ValueSizeDistribution = WorkloadValueSizeDistribution::Uniform;
+        spec.MinValueSize = 100;
+        spec.MaxValueSize = 4000;
+        RunWorkload(spec);
+    }
+
+    BOOST_AUTO_TEST_CASE(Workload_YcsbC_FromDisk_Perf)
+    {
+        WorkloadSpec spec = WorkloadSpec::CoreWorkload('C');
+        spec.Name += "-disk";
+        spec.ReadFromDisk = true;
+        RunWorkload(spec);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+}
@@ -100,6 +100,7 @@ namespace Data
 #include "IStore.h"
 #include "StoreFactory.h"
 #include "FileCountMergeConfiguration.h"
+#include "SizeTieredMergeConfiguration.h"
 #include "PropertyId.h"
 #include "ByteAlignedReaderWriterHelper.h"
 #include "FilePropertySection.h"
@@ -109,6 +110,15 @@ namespace Data
 #include "ValueCheckpointFileProperties.h"
 #include "KeyData.h"
 #include "KeyChunkMetadata.h"
+#include "BloomFilter.h"
+#include "ValueCacheEntry.h"
+#include "IValueCacheEvictionPolicy.h"
+#include "SegmentedLruEvictionPolicy.h"
+#include "ClockEvictionPolicy.h"
+#include "ValueCacheEvictionPolicyFactory.h"
+#include "ValueCache.h"
+#include "MappedFileBudget.h"
+#include "MappedFileView.h"
 #include "KeyCheckpointFile.h"
 #include "ValueCheckpointFile.h"
 #include "ValueBlockAlignedWriter.h"
@@ -116,6 +126,7 @@ namespace Data
 #include "KeyCheckpointFileAsyncEnumerator.h"
 #include "BlockAlignedWriter.h"
 #include "CheckpointFile.h"
+#include "KeyRangePartitioner.h"
 #include "FileMetadata.h"
 #include "FileMetaDataComparer.h"
 #include "MetadataTable.h"
@@ -124,6 +135,7 @@ namespace Data
 #include "MemoryBuffer.h"
 #include "IStoreCopyProvider.h"
 #include "ICopyManager.h"
+#include "StoreCopyFileReader.h"
 #include "StoreCopyStream.h"
 #include "CopyManager.h"
 #include "MergeHelper.h"
@@ -178,3 +190,4 @@ namespace TStoreTests
 #include "SharedLong.h"
 #include "DataStructures.Perf.h"
 #include "TStorePerfTestBase.h"
+#include "TStoreWorkloadPerfTestBase.h"
@@ -543,6 +543,8 @@ HRESULT ComTransactionalReplicator::UpdateCatchUpReplicaSetConfiguration(
     __in const FABRIC_REPLICA_SET_CONFIGURATION * currentConfiguration,
     __in const FABRIC_REPLICA_SET_CONFIGURATION * previousConfiguration)
 {
+    transactionalReplicator_->UpdateReplicaSetConfiguration(currentConfiguration, previousConfiguration);
+
     return primaryReplicator_->UpdateCatchUpReplicaSetConfiguration(
         currentConfiguration,
         previousConfiguration);
@@ -568,6 +570,8 @@ HRESULT ComTransactionalReplicator::EndWaitForCatchUpQuorum(
 HRESULT ComTransactionalReplicator::UpdateCurrentReplicaSetConfiguration(
     __in const FABRIC_REPLICA_SET_CONFIGURATION * currentConfiguration)
 {
+    transactionalReplicator_->UpdateReplicaSetConfiguration(currentConfiguration, nullptr);
+
     return primaryReplicator_->UpdateCurrentReplicaSetConfiguration(currentConfiguration);
 }
 
@@ -576,6 +580,11 @@ HRESULT ComTransactionalReplicator::BeginBuildReplica(
     __in IFabricAsyncOperationCallback * callback,
     __out IFabricAsyncOperationContext ** context)
 {
+    if (replica != nullptr)
+    {
+        transactionalReplicator_->OnBuildReplica(replica->Id);
+    }
+
     return primaryReplicator_->BeginBuildReplica(
         replica,
         callback,
@@ -591,6 +600,8 @@ HRESULT ComTransactionalReplicator::EndBuildReplica(
 HRESULT ComTransactionalReplicator::RemoveReplica(
     __in FABRIC_REPLICA_ID replicaId)
 {
+    transactionalReplicator_->OnRemoveReplica(replicaId);
+
     return primaryReplicator_->RemoveReplica(replicaId);
 }
 
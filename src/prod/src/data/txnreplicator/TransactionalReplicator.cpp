@@ -175,6 +175,23 @@ NTSTATUS TransactionalReplicator::UnRegisterTransactionChangeHandler() noexcept
     return loggingReplicator_->UnRegisterTransactionChangeHandler();
 }
 
+void TransactionalReplicator::UpdateReplicaSetConfiguration(
+    __in FABRIC_REPLICA_SET_CONFIGURATION const * currentConfiguration,
+    __in_opt FABRIC_REPLICA_SET_CONFIGURATION const * previousConfiguration) noexcept
+{
+    loggingReplicator_->UpdateReplicaSetConfiguration(currentConfiguration, previousConfiguration);
+}
+
+void TransactionalReplicator::OnBuildReplica(__in LONG64 replicaId) noexcept
+{
+    loggingReplicator_->OnBuildReplica(replicaId);
+}
+
+void TransactionalReplicator::OnRemoveReplica(__in LONG64 replicaId) noexcept
+{
+    loggingReplicator_->OnRemoveReplica(replicaId);
+}
+
 NTSTATUS TransactionalReplicator::RegisterStateManagerChangeHandler(
     __in IStateManagerChangeHandler& stateManagerChangeHandler) noexcept
 {
@@ -865,6 +882,16 @@ bool TransactionalReplicator::get_HasPersistedState() const noexcept
     return loggingReplicator_->HasPersistedState;
 }
 
+ULONG64 TransactionalReplicator::get_StoreValueCacheSizeInBytes() const
+{
+    return static_cast<ULONG64>(transactionalReplicatorConfig_->StoreValueCacheSizeInMB) * 1024 * 1024;
+}
+
+ULONG64 TransactionalReplicator::get_StoreMappedReadBudgetInBytes() const
+{
+    return static_cast<ULONG64>(transactionalReplicatorConfig_->StoreMappedReadBudgetInMB) * 1024 * 1024;
+}
+
 
 IStatefulPartition::SPtr TransactionalReplicator::get_StatefulPartition() const
 {
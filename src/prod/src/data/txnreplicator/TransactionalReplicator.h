@@ -55,6 +55,17 @@ namespace TxnReplicator
 
         NTSTATUS UnRegisterTransactionChangeHandler() noexcept override;
 
+        //
+        // Replica set changes seen by the primary replicator, used to negotiate compression of the replication stream
+        //
+        void UpdateReplicaSetConfiguration(
+            __in FABRIC_REPLICA_SET_CONFIGURATION const * currentConfiguration,
+            __in_opt FABRIC_REPLICA_SET_CONFIGURATION const * previousConfiguration) noexcept;
+
+        void OnBuildReplica(__in LONG64 replicaId) noexcept;
+
+        void OnRemoveReplica(__in LONG64 replicaId) noexcept;
+
         NTSTATUS RegisterStateManagerChangeHandler(
             __in IStateManagerChangeHandler & stateManagerChangeHandler) noexcept override;
 
@@ -95,6 +106,10 @@ namespace TxnReplicator
 
         bool get_HasPersistedState() const noexcept override;
 
+        ULONG64 get_StoreValueCacheSizeInBytes() const override;
+
+        ULONG64 get_StoreMappedReadBudgetInBytes() const override;
+
         Data::Utilities::IStatefulPartition::SPtr get_StatefulPartition() const override;
 
         NTSTATUS GetLastStableSequenceNumber(__out LONG64 & lsn) noexcept override;
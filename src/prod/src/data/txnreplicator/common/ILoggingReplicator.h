@@ -73,6 +73,15 @@ namespace TxnReplicator
 
         virtual NTSTATUS UnRegisterTransactionChangeHandler() noexcept = 0;
 
+    public: // Replica set notifications from the primary replicator
+        virtual void UpdateReplicaSetConfiguration(
+            __in FABRIC_REPLICA_SET_CONFIGURATION const * currentConfiguration,
+            __in_opt FABRIC_REPLICA_SET_CONFIGURATION const * previousConfiguration) noexcept = 0;
+
+        virtual void OnBuildReplica(__in LONG64 replicaId) noexcept = 0;
+
+        virtual void OnRemoveReplica(__in LONG64 replicaId) noexcept = 0;
+
     public: // Test support
         virtual NTSTATUS Test_RequestCheckpointAfterNextTransaction() noexcept
         {
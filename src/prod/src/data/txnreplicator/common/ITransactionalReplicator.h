@@ -27,6 +27,26 @@ namespace TxnReplicator
         __declspec(property(get = get_HasPersistedState)) bool HasPeristedState;
         virtual bool get_HasPersistedState() const = 0;
 
+        //
+        // Budget of the value cache shared by the stores of every replica in the process, from the global configuration.
+        // Zero disables the cache.
+        //
+        __declspec(property(get = get_StoreValueCacheSizeInBytes)) ULONG64 StoreValueCacheSizeInBytes;
+        virtual ULONG64 get_StoreValueCacheSizeInBytes() const
+        {
+            return 0;
+        }
+
+        //
+        // Budget for mapping checkpoint files into memory, shared by the stores of every replica in the process.
+        // Zero disables mapped reads.
+        //
+        __declspec(property(get = get_StoreMappedReadBudgetInBytes)) ULONG64 StoreMappedReadBudgetInBytes;
+        virtual ULONG64 get_StoreMappedReadBudgetInBytes() const
+        {
+            return 0;
+        }
+
         virtual NTSTATUS GetLastStableSequenceNumber(__out LONG64 & lsn) noexcept = 0;
 
         virtual NTSTATUS GetLastCommittedSequenceNumber(__out LONG64 & lsn) noexcept = 0;
@@ -317,6 +317,103 @@ int TRInternalSettings::LoadGlobalSettingsCallerHoldsLock()
     this->flushedRecordsTraceVectorSize_ = globalConfig_->FlushedRecordsTraceVectorSize;
     i += 1;
 
+    this->flushLatencyTargetInMilliseconds_ = globalConfig_->FlushLatencyTargetInMilliseconds;
+    globalConfig_->FlushLatencyTargetInMillisecondsEntry.AddHandler(
+        [&](EventArgs const &)
+    {
+        AcquireExclusiveLock grab(lock_);
+
+        TraceConfigUpdate<int64>(L"FlushLatencyTargetInMilliseconds", this->flushLatencyTargetInMilliseconds_, globalConfig_->FlushLatencyTargetInMilliseconds);
+
+        this->flushLatencyTargetInMilliseconds_ = globalConfig_->FlushLatencyTargetInMilliseconds;
+    });
+
+    i += 1;
+
+    this->maxFlushBatchSizeInKB_ = globalConfig_->MaxFlushBatchSizeInKB;
+    globalConfig_->MaxFlushBatchSizeInKBEntry.AddHandler(
+        [&](EventArgs const &)
+    {
+        AcquireExclusiveLock grab(lock_);
+
+        TraceConfigUpdate<int64>(L"MaxFlushBatchSizeInKB", this->maxFlushBatchSizeInKB_, globalConfig_->MaxFlushBatchSizeInKB);
+
+        this->maxFlushBatchSizeInKB_ = globalConfig_->MaxFlushBatchSizeInKB;
+    });
+
+    i += 1;
+
+    this->maxFlushCoalescingDelayInMilliseconds_ = globalConfig_->MaxFlushCoalescingDelayInMilliseconds;
+    globalConfig_->MaxFlushCoalescingDelayInMillisecondsEntry.AddHandler(
+        [&](EventArgs const &)
+    {
+        AcquireExclusiveLock grab(lock_);
+
+        TraceConfigUpdate<int64>(L"MaxFlushCoalescingDelayInMilliseconds", this->maxFlushCoalescingDelayInMilliseconds_, globalConfig_->MaxFlushCoalescingDelayInMilliseconds);
+
+        this->maxFlushCoalescingDelayInMilliseconds_ = globalConfig_->MaxFlushCoalescingDelayInMilliseconds;
+    });
+
+    i += 1;
+
+    this->replicationCompressionCodec_ = globalConfig_->ReplicationCompressionCodec;
+    globalConfig_->ReplicationCompressionCodecEntry.AddHandler(
+        [&](EventArgs const &)
+    {
+        AcquireExclusiveLock grab(lock_);
+
+        TraceConfigUpdate<int64>(L"ReplicationCompressionCodec", this->replicationCompressionCodec_, globalConfig_->ReplicationCompressionCodec);
+
+        this->replicationCompressionCodec_ = globalConfig_->ReplicationCompressionCodec;
+    });
+
+    i += 1;
+
+    this->minCompressionSizeInBytes_ = globalConfig_->MinCompressionSizeInBytes;
+    globalConfig_->MinCompressionSizeInBytesEntry.AddHandler(
+        [&](EventArgs const &)
+    {
+        AcquireExclusiveLock grab(lock_);
+
+        TraceConfigUpdate<int64>(L"MinCompressionSizeInBytes", this->minCompressionSizeInBytes_, globalConfig_->MinCompressionSizeInBytes);
+
+        this->minCompressionSizeInBytes_ = globalConfig_->MinCompressionSizeInBytes;
+    });
+
+    i += 1;
+
+    this->backupCompressionCodec_ = globalConfig_->BackupCompressionCodec;
+    globalConfig_->BackupCompressionCodecEntry.AddHandler(
+        [&](EventArgs const &)
+    {
+        AcquireExclusiveLock grab(lock_);
+
+        TraceConfigUpdate<int64>(L"BackupCompressionCodec", this->backupCompressionCodec_, globalConfig_->BackupCompressionCodec);
+
+        this->backupCompressionCodec_ = globalConfig_->BackupCompressionCodec;
+    });
+
+    i += 1;
+
+    this->restoreReadAheadSizeInKb_ = globalConfig_->RestoreReadAheadSizeInKb;
+    globalConfig_->RestoreReadAheadSizeInKbEntry.AddHandler(
+        [&](EventArgs const &)
+    {
+        AcquireExclusiveLock grab(lock_);
+
+        TraceConfigUpdate<int64>(L"RestoreReadAheadSizeInKb", this->restoreReadAheadSizeInKb_, globalConfig_->RestoreReadAheadSizeInKb);
+
+        this->restoreReadAheadSizeInKb_ = globalConfig_->RestoreReadAheadSizeInKb;
+    });
+
+    i += 1;
+
+    this->storeValueCacheSizeInMB_ = globalConfig_->StoreValueCacheSizeInMB;
+    i += 1;
+
+    this->storeMappedReadBudgetInMB_ = globalConfig_->StoreMappedReadBudgetInMB;
+    i += 1;
+
     return i;
 }
 
@@ -801,6 +898,60 @@ Common::TimeSpan TRInternalSettings::get_TruncationInterval() const
     return truncationInterval_;
 }
 
+int64 TRInternalSettings::get_FlushLatencyTargetInMilliseconds() const
+{
+    AcquireReadLock grab(lock_);
+    return flushLatencyTargetInMilliseconds_;
+}
+
+int64 TRInternalSettings::get_MaxFlushBatchSizeInKB() const
+{
+    AcquireReadLock grab(lock_);
+    return maxFlushBatchSizeInKB_;
+}
+
+int64 TRInternalSettings::get_MaxFlushCoalescingDelayInMilliseconds() const
+{
+    AcquireReadLock grab(lock_);
+    return maxFlushCoalescingDelayInMilliseconds_;
+}
+
+int64 TRInternalSettings::get_ReplicationCompressionCodec() const
+{
+    AcquireReadLock grab(lock_);
+    return replicationCompressionCodec_;
+}
+
+int64 TRInternalSettings::get_MinCompressionSizeInBytes() const
+{
+    AcquireReadLock grab(lock_);
+    return minCompressionSizeInBytes_;
+}
+
+int64 TRInternalSettings::get_BackupCompressionCodec() const
+{
+    AcquireReadLock grab(lock_);
+    return backupCompressionCodec_;
+}
+
+int64 TRInternalSettings::get_RestoreReadAheadSizeInKb() const
+{
+    AcquireReadLock grab(lock_);
+    return restoreReadAheadSizeInKb_;
+}
+
+int64 TRInternalSettings::get_StoreValueCacheSizeInMB() const
+{
+    AcquireReadLock grab(lock_);
+    return storeValueCacheSizeInMB_;
+}
+
+int64 TRInternalSettings::get_StoreMappedReadBudgetInMB() const
+{
+    AcquireReadLock grab(lock_);
+    return storeMappedReadBudgetInMB_;
+}
+
 std::wstring TRInternalSettings::ToString() const
 {
     std::wstring content;
@@ -908,5 +1059,32 @@ int TRInternalSettings::WriteTo(__in Common::TextWriter & w, Common::FormatOptio
     w.WriteLine("DispatchingMode = {0}, ", this->DispatchingMode);
     i += 1;
 
+    w.WriteLine("FlushLatencyTargetInMilliseconds = {0}, ", this->FlushLatencyTargetInMilliseconds);
+    i += 1;
+
+    w.WriteLine("MaxFlushBatchSizeInKB = {0}, ", this->MaxFlushBatchSizeInKB);
+    i += 1;
+
+    w.WriteLine("MaxFlushCoalescingDelayInMilliseconds = {0}, ", this->MaxFlushCoalescingDelayInMilliseconds);
+    i += 1;
+
+    w.WriteLine("ReplicationCompressionCodec = {0}, ", this->ReplicationCompressionCodec);
+    i += 1;
+
+    w.WriteLine("MinCompressionSizeInBytes = {0}, ", this->MinCompressionSizeInBytes);
+    i += 1;
+
+    w.WriteLine("BackupCompressionCodec = {0}, ", this->BackupCompressionCodec);
+    i += 1;
+
+    w.WriteLine("RestoreReadAheadSizeInKb = {0}, ", this->RestoreReadAheadSizeInKb);
+    i += 1;
+
+    w.WriteLine("StoreValueCacheSizeInMB = {0}, ", this->StoreValueCacheSizeInMB);
+    i += 1;
+
+    w.WriteLine("StoreMappedReadBudgetInMB = {0}, ", this->StoreMappedReadBudgetInMB);
+    i += 1;
+
     return i;
 }
@@ -139,6 +139,52 @@ namespace TxnReplicator
                     L"Avg. Serialization Latency (ms) base",
                     L"Base counter for Average duration of serialization in PhysicalLogWriter flush",
                     noDisplay)
+                COUNTER_DEFINITION(
+                    21,
+                    Common::PerformanceCounterType::RateOfCountPerSecond64,
+                    L"Compression Input Bytes/sec",
+                    L"The number of replication and copy bytes per second offered to the compression codec.")
+                COUNTER_DEFINITION(
+                    22,
+                    Common::PerformanceCounterType::RateOfCountPerSecond64,
+                    L"Compression Output Bytes/sec",
+                    L"The number of bytes per second sent to secondaries for the data offered to the compression codec.")
+                COUNTER_DEFINITION_WITH_BASE(
+                    23,
+                    24,
+                    Common::PerformanceCounterType::AverageCount64,
+                    L"Avg. Compression Ratio (%)",
+                    L"Average size of a compressed replication or copy batch as a percentage of its original size")
+                COUNTER_DEFINITION(
+                    24,
+                    Common::PerformanceCounterType::AverageBase,
+                    L"Avg. Compression Ratio (%) base",
+                    L"Base counter for Average size of a compressed replication or copy batch",
+                    noDisplay)
+                COUNTER_DEFINITION_WITH_BASE(
+                    25,
+                    26,
+                    Common::PerformanceCounterType::AverageCount64,
+                    L"Avg. Compression Latency (us)",
+                    L"Average elapsed time spent compressing a replication or copy batch")
+                COUNTER_DEFINITION(
+                    26,
+                    Common::PerformanceCounterType::AverageBase,
+                    L"Avg. Compression Latency (us) base",
+                    L"Base counter for Average elapsed time spent compressing a replication or copy batch",
+                    noDisplay)
+                COUNTER_DEFINITION_WITH_BASE(
+                    27,
+                    28,
+                    Common::PerformanceCounterType::AverageCount64,
+                    L"Avg. Decompression Latency (us)",
+                    L"Average elapsed time spent decompressing a replication or copy batch")
+                COUNTER_DEFINITION(
+                    28,
+                    Common::PerformanceCounterType::AverageBase,
+                    L"Avg. Decompression Latency (us) base",
+                    L"Base counter for Average elapsed time spent decompressing a replication or copy batch",
+                    noDisplay)
 
             END_COUNTER_SET_DEFINITION()
 
@@ -162,6 +208,14 @@ namespace TxnReplicator
             DECLARE_COUNTER_INSTANCE(AvgFlushLatencyBase)
             DECLARE_COUNTER_INSTANCE(AvgSerializationLatency)
             DECLARE_COUNTER_INSTANCE(AvgSerializationLatencyBase)
+            DECLARE_COUNTER_INSTANCE(CompressionInputBytes)
+            DECLARE_COUNTER_INSTANCE(CompressionOutputBytes)
+            DECLARE_COUNTER_INSTANCE(AvgCompressionRatio)
+            DECLARE_COUNTER_INSTANCE(AvgCompressionRatioBase)
+            DECLARE_COUNTER_INSTANCE(AvgCompressionLatency)
+            DECLARE_COUNTER_INSTANCE(AvgCompressionLatencyBase)
+            DECLARE_COUNTER_INSTANCE(AvgDecompressionLatency)
+            DECLARE_COUNTER_INSTANCE(AvgDecompressionLatencyBase)
 
             BEGIN_COUNTER_SET_INSTANCE(TRPerformanceCounters)
                 DEFINE_COUNTER_INSTANCE(
@@ -224,6 +278,30 @@ namespace TxnReplicator
                 DEFINE_COUNTER_INSTANCE(
                     AvgSerializationLatencyBase,
                     20)
+                DEFINE_COUNTER_INSTANCE(
+                    CompressionInputBytes,
+                    21)
+                DEFINE_COUNTER_INSTANCE(
+                    CompressionOutputBytes,
+                    22)
+                DEFINE_COUNTER_INSTANCE(
+                    AvgCompressionRatio,
+                    23)
+                DEFINE_COUNTER_INSTANCE(
+                    AvgCompressionRatioBase,
+                    24)
+                DEFINE_COUNTER_INSTANCE(
+                    AvgCompressionLatency,
+                    25)
+                DEFINE_COUNTER_INSTANCE(
+                    AvgCompressionLatencyBase,
+                    26)
+                DEFINE_COUNTER_INSTANCE(
+                    AvgDecompressionLatency,
+                    27)
+                DEFINE_COUNTER_INSTANCE(
+                    AvgDecompressionLatencyBase,
+                    28)
             END_COUNTER_SET_INSTANCE()
 
             public:
@@ -0,0 +1,213 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+#include "TestHeaders.h"
+
+#include <boost/test/unit_test.hpp>
+#include "Common/boost-taef.h"
+
+namespace LoggingReplicatorTests
+{
+    using namespace std;
+    using namespace ktl;
+    using namespace Data::LogRecordLib;
+    using namespace Data::LoggingReplicator;
+    using namespace TxnReplicator;
+    using namespace Data::Utilities;
+    using namespace Common;
+
+    #define ADAPTIVEFLUSHSCHEDULERTEST_TAG 'TsfA'
+
+    StringLiteral const TraceComponent = "AdaptiveFlushSchedulerTests";
+
+    class AdaptiveFlushSchedulerTests
+    {
+    protected:
+        void EndTest();
+
+        KSharedArray<LogRecord::SPtr>::SPtr CreateRecords(
+            __in ULONG count,
+            __in KAllocator & allocator);
+
+        KGuid pId_;
+        ::FABRIC_REPLICA_ID rId_;
+        PartitionedReplicaId::SPtr prId_;
+        KtlSystem * underlyingSystem_;
+    };
+
+    void AdaptiveFlushSchedulerTests::EndTest()
+    {
+        prId_.Reset();
+    }
+
+    KSharedArray<LogRecord::SPtr>::SPtr AdaptiveFlushSchedulerTests::CreateRecords(
+        __in ULONG count,
+        __in KAllocator & allocator)
+    {
+        InvalidLogRecords::SPtr invalidRecords = InvalidLogRecords::Create(allocator);
+        BarrierLogRecord::SPtr record = BarrierLogRecord::Create(LogRecordType::Enum::Barrier, 0, 1, *invalidRecords->Inv_PhysicalLogRecord, allocator);
+
+        KSharedArray<LogRecord::SPtr>::SPtr records = _new(ADAPTIVEFLUSHSCHEDULERTEST_TAG, allocator)KSharedArray<LogRecord::SPtr>();
+        CODING_ERROR_ASSERT(records != nullptr);
+
+        for (ULONG i = 0; i < count; i++)
+        {
+            NTSTATUS status = records->Append(record.RawPtr());
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+        }
+
+        return records;
+    }
+
+    BOOST_FIXTURE_TEST_SUITE(AdaptiveFlushSchedulerTestsSuite, AdaptiveFlushSchedulerTests)
+
+    BOOST_AUTO_TEST_CASE(Disabled_DoesNotShapeFlushes)
+    {
+        TEST_TRACE_BEGIN("Disabled_DoesNotShapeFlushes")
+        {
+            AdaptiveFlushScheduler::SPtr scheduler = AdaptiveFlushScheduler::Create(allocator);
+            scheduler->UpdateSettings(0, 4096 * 1024, 2);
+
+            VERIFY_IS_FALSE(scheduler->IsEnabled);
+
+            scheduler->OnFlushCompleted(1024, 100, false);
+
+            KSharedArray<LogRecord::SPtr>::SPtr records = CreateRecords(100, allocator);
+
+            VERIFY_ARE_EQUAL(scheduler->GetCoalescingDelayInMilliseconds(0), 0);
+            VERIFY_ARE_EQUAL(scheduler->GetBatchRecordCount(*records), records->Count());
+
+            // Latency above any target does not change the budget
+            scheduler->OnFlushCompleted(1024, 1000 * 1000, false);
+            VERIFY_ARE_EQUAL(scheduler->BatchSizeBudgetInBytes, 4096 * 1024);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(CoalescingDelay_OnlyWhileFlushesAreBackToBack)
+    {
+        TEST_TRACE_BEGIN("CoalescingDelay_OnlyWhileFlushesAreBackToBack")
+        {
+            AdaptiveFlushScheduler::SPtr scheduler = AdaptiveFlushScheduler::Create(allocator);
+            scheduler->UpdateSettings(1000, 4096 * 1024, 2);
+
+            VERIFY_IS_TRUE(scheduler->IsEnabled);
+
+            // No flush has completed yet
+            VERIFY_ARE_EQUAL(scheduler->GetCoalescingDelayInMilliseconds(0), 0);
+
+            scheduler->OnFlushCompleted(1024, 1000, false);
+
+            VERIFY_ARE_EQUAL(scheduler->GetCoalescingDelayInMilliseconds(1024), 2);
+
+            // A batch that already fills the budget is issued right away
+            VERIFY_ARE_EQUAL(scheduler->GetCoalescingDelayInMilliseconds(scheduler->BatchSizeBudgetInBytes), 0);
+
+            // No delay once the flushes themselves take longer than the target
+            scheduler->OnFlushCompleted(1024, 1000 * 1000 * 10, false);
+            VERIFY_ARE_EQUAL(scheduler->GetCoalescingDelayInMilliseconds(1024), 0);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(BatchBudget_ShrinksAboveTarget_GrowsWithinTarget)
+    {
+        TEST_TRACE_BEGIN("BatchBudget_ShrinksAboveTarget_GrowsWithinTarget")
+        {
+            LONG64 maxBatchSize = 1024 * 1024;
+            LONG64 minBatchSize = AdaptiveFlushScheduler::MinBatchSizeInBytes;
+
+            AdaptiveFlushScheduler::SPtr scheduler = AdaptiveFlushScheduler::Create(allocator);
+            scheduler->UpdateSettings(5, maxBatchSize, 2);
+
+            VERIFY_ARE_EQUAL(scheduler->BatchSizeBudgetInBytes, maxBatchSize);
+
+            for (ULONG i = 0; i < 100; i++)
+            {
+                scheduler->OnFlushCompleted(maxBatchSize, 50 * 1000, true);
+            }
+
+            VERIFY_ARE_EQUAL(scheduler->BatchSizeBudgetInBytes, minBatchSize);
+
+            // Budget limited flushes within the target let the budget grow back up to the maximum
+            for (ULONG i = 0; i < 100; i++)
+            {
+                scheduler->OnFlushCompleted(minBatchSize, 100, false);
+            }
+
+            VERIFY_ARE_EQUAL(scheduler->BatchSizeBudgetInBytes, minBatchSize);
+
+            for (ULONG i = 0; i < 100; i++)
+            {
+                scheduler->OnFlushCompleted(scheduler->BatchSizeBudgetInBytes, 100, true);
+            }
+
+            VERIFY_ARE_EQUAL(scheduler->BatchSizeBudgetInBytes, maxBatchSize);
+
+            // Lowering the maximum caps the current budget
+            scheduler->UpdateSettings(5, minBatchSize * 2, 2);
+            VERIFY_ARE_EQUAL(scheduler->BatchSizeBudgetInBytes, minBatchSize * 2);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(BatchRecordCount_SplitsAtBudget)
+    {
+        TEST_TRACE_BEGIN("BatchRecordCount_SplitsAtBudget")
+        {
+            AdaptiveFlushScheduler::SPtr scheduler = AdaptiveFlushScheduler::Create(allocator);
+            scheduler->UpdateSettings(5, AdaptiveFlushScheduler::MinBatchSizeInBytes, 2);
+
+            KSharedArray<LogRecord::SPtr>::SPtr oneRecord = CreateRecords(1, allocator);
+            ULONG recordSize = (*oneRecord)[0]->ApproximateSizeOnDisk;
+            VERIFY_IS_TRUE(recordSize > 0);
+
+            ULONG recordsPerBatch = static_cast<ULONG>(AdaptiveFlushScheduler::MinBatchSizeInBytes / recordSize);
+
+            KSharedArray<LogRecord::SPtr>::SPtr records = CreateRecords(recordsPerBatch * 2 + 1, allocator);
+
+            VERIFY_ARE_EQUAL(scheduler->GetBatchRecordCount(*records), recordsPerBatch);
+            VERIFY_ARE_EQUAL(scheduler->GetBatchRecordCount(*oneRecord), 1);
+
+            KSharedArray<LogRecord::SPtr>::SPtr smallBatch = CreateRecords(recordsPerBatch, allocator);
+            VERIFY_ARE_EQUAL(scheduler->GetBatchRecordCount(*smallBatch), recordsPerBatch);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(Histograms_BucketByPowersOfTwo)
+    {
+        TEST_TRACE_BEGIN("Histograms_BucketByPowersOfTwo")
+        {
+            AdaptiveFlushScheduler::SPtr scheduler = AdaptiveFlushScheduler::Create(allocator);
+
+            scheduler->OnFlushCompleted(100, 10, false);
+            scheduler->OnFlushCompleted(4 * 1024, 1000, false);
+            scheduler->OnFlushCompleted(5 * 1024, 1999, false);
+            scheduler->OnFlushCompleted(1024 * 1024 * 1024, 10 * 1000 * 1000, false);
+
+            VERIFY_ARE_EQUAL(scheduler->FlushCount, 4);
+
+            VERIFY_ARE_EQUAL(scheduler->GetFlushSizeBucket(0), 1);
+            VERIFY_ARE_EQUAL(scheduler->GetFlushSizeBucket(1), 2);
+            VERIFY_ARE_EQUAL(scheduler->GetFlushSizeBucket(AdaptiveFlushScheduler::FlushSizeBucketCount - 1), 1);
+
+            VERIFY_ARE_EQUAL(scheduler->GetFlushLatencyBucket(0), 1);
+            VERIFY_ARE_EQUAL(scheduler->GetFlushLatencyBucket(1), 2);
+            VERIFY_ARE_EQUAL(scheduler->GetFlushLatencyBucket(AdaptiveFlushScheduler::FlushLatencyBucketCount - 1), 1);
+
+            VERIFY_IS_FALSE(scheduler->FlushSizeHistogramToString().empty());
+            VERIFY_IS_FALSE(scheduler->FlushLatencyHistogramToString().empty());
+            VERIFY_IS_FALSE(scheduler->ShouldTraceHistograms());
+
+            scheduler->ResetHistograms();
+
+            VERIFY_ARE_EQUAL(scheduler->FlushCount, 0);
+            for (ULONG i = 0; i < AdaptiveFlushScheduler::FlushSizeBucketCount; i++)
+            {
+                VERIFY_ARE_EQUAL(scheduler->GetFlushSizeBucket(i), 0);
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+}
@@ -0,0 +1,235 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+using namespace ktl;
+using namespace Data::LoggingReplicator;
+using namespace Data::LogRecordLib;
+using namespace Common;
+
+AdaptiveFlushScheduler::AdaptiveFlushScheduler()
+    : KObject()
+    , KShared()
+    , latencyTargetInMilliseconds_(0)
+    , maxBatchSizeInBytes_(MAXLONG64)
+    , maxCoalescingDelayInMilliseconds_(0)
+    , batchSizeBudgetInBytes_(MAXLONG64)
+    , averageFlushLatencyInMicroseconds_(0)
+    , flushCount_(0)
+    , sinceLastFlushWatch_()
+    , sinceHistogramResetWatch_()
+{
+    ResetHistograms();
+}
+
+AdaptiveFlushScheduler::~AdaptiveFlushScheduler()
+{
+}
+
+AdaptiveFlushScheduler::SPtr AdaptiveFlushScheduler::Create(__in KAllocator & allocator)
+{
+    AdaptiveFlushScheduler * pointer = _new(ADAPTIVEFLUSHSCHEDULER_TAG, allocator)AdaptiveFlushScheduler();
+
+    THROW_ON_ALLOCATION_FAILURE(pointer);
+
+    return AdaptiveFlushScheduler::SPtr(pointer);
+}
+
+LONG64 AdaptiveFlushScheduler::GetFlushSizeBucket(__in ULONG index) const
+{
+    ASSERT_IFNOT(index < FlushSizeBucketCount, "Flush size bucket {0} is out of range", index);
+    return flushSizeHistogram_[index];
+}
+
+LONG64 AdaptiveFlushScheduler::GetFlushLatencyBucket(__in ULONG index) const
+{
+    ASSERT_IFNOT(index < FlushLatencyBucketCount, "Flush latency bucket {0} is out of range", index);
+    return flushLatencyHistogram_[index];
+}
+
+void AdaptiveFlushScheduler::UpdateSettings(
+    __in LONG64 latencyTargetInMilliseconds,
+    __in LONG64 maxBatchSizeInBytes,
+    __in LONG64 maxCoalescingDelayInMilliseconds)
+{
+    latencyTargetInMilliseconds_ = latencyTargetInMilliseconds;
+    maxCoalescingDelayInMilliseconds_ = maxCoalescingDelayInMilliseconds;
+
+    maxBatchSizeInBytes_ = maxBatchSizeInBytes;
+
+    if (maxBatchSizeInBytes_ < MinBatchSizeInBytes)
+    {
+        maxBatchSizeInBytes_ = MinBatchSizeInBytes;
+    }
+
+    if (!IsEnabled || batchSizeBudgetInBytes_ > maxBatchSizeInBytes_)
+    {
+        batchSizeBudgetInBytes_ = maxBatchSizeInBytes_;
+    }
+}
+
+LONG64 AdaptiveFlushScheduler::GetCoalescingDelayInMilliseconds(__in LONG64 batchSizeInBytes) const
+{
+    if (!IsEnabled || maxCoalescingDelayInMilliseconds_ <= 0 || batchSizeInBytes >= batchSizeBudgetInBytes_)
+    {
+        return 0;
+    }
+
+    // A flush that follows a quiet period is issued right away; waiting only pays off when more records are about to arrive.
+    if (!sinceLastFlushWatch_.IsRunning || sinceLastFlushWatch_.ElapsedMilliseconds >= latencyTargetInMilliseconds_)
+    {
+        return 0;
+    }
+
+    LONG64 slackInMilliseconds = (latencyTargetInMilliseconds_ * 1000 - averageFlushLatencyInMicroseconds_) / 1000;
+    if (slackInMilliseconds <= 0)
+    {
+        return 0;
+    }
+
+    return slackInMilliseconds < maxCoalescingDelayInMilliseconds_ ? slackInMilliseconds : maxCoalescingDelayInMilliseconds_;
+}
+
+ULONG AdaptiveFlushScheduler::GetBatchRecordCount(__in KSharedArray<LogRecord::SPtr> const & records) const
+{
+    ULONG count = records.Count();
+
+    if (!IsEnabled || count <= 1)
+    {
+        return count;
+    }
+
+    LONG64 batchSizeInBytes = records[0]->ApproximateSizeOnDisk;
+    ULONG i = 1;
+
+    for (; i < count && i < MaxBatchRecordCount; i++)
+    {
+        batchSizeInBytes += records[i]->ApproximateSizeOnDisk;
+
+        if (batchSizeInBytes > batchSizeBudgetInBytes_)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+void AdaptiveFlushScheduler::OnFlushCompleted(
+    __in ULONG64 flushSizeInBytes,
+    __in LONG64 flushLatencyInMicroseconds,
+    __in bool isBudgetLimited)
+{
+    flushCount_++;
+    sinceLastFlushWatch_.Restart();
+
+    ULONG sizeBucket = 0;
+    for (ULONG64 limit = FirstFlushSizeBucketLimit; sizeBucket < FlushSizeBucketCount - 1 && flushSizeInBytes >= limit; limit <<= 1)
+    {
+        sizeBucket++;
+    }
+
+    ULONG latencyBucket = 0;
+    for (LONG64 limit = FirstFlushLatencyBucketLimitInMicroseconds; latencyBucket < FlushLatencyBucketCount - 1 && flushLatencyInMicroseconds >= limit; limit <<= 1)
+    {
+        latencyBucket++;
+    }
+
+    flushSizeHistogram_[sizeBucket]++;
+    flushLatencyHistogram_[latencyBucket]++;
+
+    // Moving average over roughly the last 8 flushes
+    averageFlushLatencyInMicroseconds_ = averageFlushLatencyInMicroseconds_ == 0 ?
+        flushLatencyInMicroseconds :
+        (averageFlushLatencyInMicroseconds_ * 7 + flushLatencyInMicroseconds) / 8;
+
+    if (!IsEnabled)
+    {
+        return;
+    }
+
+    // Back off quickly when the disk falls behind the target and probe upwards slowly while it keeps up
+    if (averageFlushLatencyInMicroseconds_ > latencyTargetInMilliseconds_ * 1000)
+    {
+        batchSizeBudgetInBytes_ = (batchSizeBudgetInBytes_ / 4) * 3;
+
+        if (batchSizeBudgetInBytes_ < MinBatchSizeInBytes)
+        {
+            batchSizeBudgetInBytes_ = MinBatchSizeInBytes;
+        }
+    }
+    else if (isBudgetLimited)
+    {
+        LONG64 increment = batchSizeBudgetInBytes_ / 8;
+
+        batchSizeBudgetInBytes_ = maxBatchSizeInBytes_ - batchSizeBudgetInBytes_ < increment ?
+            maxBatchSizeInBytes_ :
+            batchSizeBudgetInBytes_ + increment;
+    }
+}
+
+bool AdaptiveFlushScheduler::ShouldTraceHistograms() const
+{
+    return IsEnabled && sinceHistogramResetWatch_.Elapsed >= TimeSpan::FromSeconds(HistogramTraceIntervalInSeconds);
+}
+
+std::wstring AdaptiveFlushScheduler::FlushSizeHistogramToString() const
+{
+    std::wstring result;
+    ULONG64 limit = FirstFlushSizeBucketLimit;
+
+    for (ULONG i = 0; i < FlushSizeBucketCount; i++)
+    {
+        if (i < FlushSizeBucketCount - 1)
+        {
+            result.append(wformatString("<{0}KB:{1} ", limit / 1024, flushSizeHistogram_[i]));
+            limit <<= 1;
+        }
+        else
+        {
+            result.append(wformatString(">={0}KB:{1}", (limit >> 1) / 1024, flushSizeHistogram_[i]));
+        }
+    }
+
+    return result;
+}
+
+std::wstring AdaptiveFlushScheduler::FlushLatencyHistogramToString() const
+{
+    std::wstring result;
+    LONG64 limit = FirstFlushLatencyBucketLimitInMicroseconds;
+
+    for (ULONG i = 0; i < FlushLatencyBucketCount; i++)
+    {
+        if (i < FlushLatencyBucketCount - 1)
+        {
+            result.append(wformatString("<{0}ms:{1} ", limit / 1000, flushLatencyHistogram_[i]));
+            limit <<= 1;
+        }
+        else
+        {
+            result.append(wformatString(">={0}ms:{1}", (limit >> 1) / 1000, flushLatencyHistogram_[i]));
+        }
+    }
+
+    return result;
+}
+
+void AdaptiveFlushScheduler::ResetHistograms()
+{
+    for (ULONG i = 0; i < FlushSizeBucketCount; i++)
+    {
+        flushSizeHistogram_[i] = 0;
+    }
+
+    for (ULONG i = 0; i < FlushLatencyBucketCount; i++)
+    {
+        flushLatencyHistogram_[i] = 0;
+    }
+
+    flushCount_ = 0;
+    sinceHistogramResetWatch_.Restart();
+}
@@ -0,0 +1,132 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace LoggingReplicator
+    {
+        //
+        // Decides how the PhysicalLogWriter batches records into flushes when a commit latency target is configured
+        //  1. Coalescing - While flushes are back to back and the last ones finished well within the target, the next flush waits a short
+        //                  delay (at most MaxFlushCoalescingDelayInMilliseconds) so that more records can join it
+        //  2. Splitting  - A flush never carries more than the current batch budget; the remaining records go to the next flush
+        //  3. Feedback   - The budget shrinks when the moving average flush latency exceeds the target and grows again while flushes
+        //                  are cut by the budget and stay within the target
+        //
+        // It also keeps histograms of the size and latency of every flush, which are traced periodically while a latency target is configured.
+        //
+        // Not thread safe. The PhysicalLogWriter only uses it from the flush task.
+        //
+        class AdaptiveFlushScheduler final
+            : public KObject<AdaptiveFlushScheduler>
+            , public KShared<AdaptiveFlushScheduler>
+        {
+            K_FORCE_SHARED(AdaptiveFlushScheduler)
+
+        public:
+            // Flush size buckets are powers of 2 starting at 4KB: [0, 4KB), [4KB, 8KB), ... and the last bucket holds everything larger
+            static const ULONG FlushSizeBucketCount = 12;
+            static const ULONG64 FirstFlushSizeBucketLimit = 4 * 1024;
+
+            // Flush latency buckets are powers of 2 starting at 1ms: [0, 1ms), [1ms, 2ms), ... and the last bucket holds everything slower
+            static const ULONG FlushLatencyBucketCount = 12;
+            static const LONG64 FirstFlushLatencyBucketLimitInMicroseconds = 1000;
+
+            // The budget never shrinks below this size, so a slow disk still gets reasonably sized writes
+            static const LONG64 MinBatchSizeInBytes = 64 * 1024;
+
+            static const ULONG MaxBatchRecordCount = 16 * 1024;
+
+            static AdaptiveFlushScheduler::SPtr Create(__in KAllocator & allocator);
+
+            __declspec(property(get = get_IsEnabled)) bool IsEnabled;
+            bool get_IsEnabled() const
+            {
+                return latencyTargetInMilliseconds_ > 0;
+            }
+
+            __declspec(property(get = get_BatchSizeBudgetInBytes)) LONG64 BatchSizeBudgetInBytes;
+            LONG64 get_BatchSizeBudgetInBytes() const
+            {
+                return batchSizeBudgetInBytes_;
+            }
+
+            __declspec(property(get = get_AverageFlushLatencyInMicroseconds)) LONG64 AverageFlushLatencyInMicroseconds;
+            LONG64 get_AverageFlushLatencyInMicroseconds() const
+            {
+                return averageFlushLatencyInMicroseconds_;
+            }
+
+            // Number of flushes since the histograms were last reset
+            __declspec(property(get = get_FlushCount)) LONG64 FlushCount;
+            LONG64 get_FlushCount() const
+            {
+                return flushCount_;
+            }
+
+            LONG64 GetFlushSizeBucket(__in ULONG index) const;
+            LONG64 GetFlushLatencyBucket(__in ULONG index) const;
+
+            //
+            // Applies the latest settings. A latency target of 0 disables coalescing, splitting and the histogram traces; the histograms are kept regardless.
+            //
+            void UpdateSettings(
+                __in LONG64 latencyTargetInMilliseconds,
+                __in LONG64 maxBatchSizeInBytes,
+                __in LONG64 maxCoalescingDelayInMilliseconds);
+
+            //
+            // Returns how long the flush of batchSizeInBytes should wait for more records before it is issued, 0 if it should not wait
+            //
+            LONG64 GetCoalescingDelayInMilliseconds(__in LONG64 batchSizeInBytes) const;
+
+            //
+            // Returns how many of the leading records fit in the next flush. Always at least 1
+            //
+            ULONG GetBatchRecordCount(__in KSharedArray<LogRecordLib::LogRecord::SPtr> const & records) const;
+
+            //
+            // Feeds the outcome of a flush back into the budget and the histograms
+            // isBudgetLimited is true when records were left for the next flush because of the budget
+            //
+            void OnFlushCompleted(
+                __in ULONG64 flushSizeInBytes,
+                __in LONG64 flushLatencyInMicroseconds,
+                __in bool isBudgetLimited);
+
+            //
+            // Returns true once HistogramTraceIntervalInSeconds have passed since the last reset and the scheduler is enabled. The caller traces the histograms and resets them
+            //
+            bool ShouldTraceHistograms() const;
+
+            std::wstring FlushSizeHistogramToString() const;
+            std::wstring FlushLatencyHistogramToString() const;
+
+            void ResetHistograms();
+
+        private:
+            static const ULONG64 HistogramTraceIntervalInSeconds = 60;
+
+            AdaptiveFlushScheduler();
+
+            LONG64 latencyTargetInMilliseconds_;
+            LONG64 maxBatchSizeInBytes_;
+            LONG64 maxCoalescingDelayInMilliseconds_;
+
+            LONG64 batchSizeBudgetInBytes_;
+            LONG64 averageFlushLatencyInMicroseconds_;
+            LONG64 flushCount_;
+
+            // Time since the last flush completed. Coalescing only kicks in while flushes are back to back
+            Common::Stopwatch sinceLastFlushWatch_;
+            Common::Stopwatch sinceHistogramResetWatch_;
+
+            LONG64 flushSizeHistogram_[FlushSizeBucketCount];
+            LONG64 flushLatencyHistogram_[FlushLatencyBucketCount];
+        };
+    }
+}
@@ -73,6 +73,24 @@ KString::SPtr BackupFolderInfo::get_FullBackupFolderPath() const
     return fullBackupFolderPath_;
 }
 
+RestoreLogRecordsAsyncEnumerator::SPtr BackupFolderInfo::get_LogRecords() const
+{
+    return logRecordsSPtr_;
+}
+
+void BackupFolderInfo::StartReadingLogRecords(__in ULONG64 readAheadSizeInBytes)
+{
+    ASSERT_IFNOT(logRecordsSPtr_ == nullptr, "{0}: Log records of the backup folder are already being read.", TraceId);
+
+    logRecordsSPtr_ = RestoreLogRecordsAsyncEnumerator::Create(
+        *PartitionedReplicaIdentifier,
+        logFilePathArray_,
+        readAheadSizeInBytes,
+        GetThisAllocator());
+
+    logRecordsSPtr_->StartReadAhead();
+}
+
 // Algorithm:
 // 1. Scan the folder to find all backups and create corresponding sorted arrays.
 // 2. Trim the chain so that it only contains the longest chain.
@@ -52,10 +52,20 @@ namespace Data
             __declspec(property(get = get_FullBackupFolderPath)) KString::SPtr FullBackupFolderPath;
             KString::SPtr get_FullBackupFolderPath() const;
 
+            // Log records of the backup chain. nullptr until StartReadingLogRecords is called.
+            __declspec(property(get = get_LogRecords)) RestoreLogRecordsAsyncEnumerator::SPtr LogRecords;
+            RestoreLogRecordsAsyncEnumerator::SPtr get_LogRecords() const;
+
         public:
             ktl::Awaitable<void> AnalyzeAsync(
                 __in ktl::CancellationToken const & cancellationToken);
 
+            //
+            // Starts reading the log records of the backup chain ahead of the restore of the log.
+            // Must be called after AnalyzeAsync. The caller must close LogRecords.
+            //
+            void StartReadingLogRecords(__in ULONG64 readAheadSizeInBytes);
+
         private:
             BackupFolderInfo(
                 __in Utilities::PartitionedReplicaId const & traceId,
@@ -101,6 +111,7 @@ namespace Data
         private:
             KString::SPtr fullBackupFolderPath_;
             KString::CSPtr stateManagerBackupFolderPath_;
+            RestoreLogRecordsAsyncEnumerator::SPtr logRecordsSPtr_;
 
             /// <summary>
             /// Test only flag - DO NOT USE IN PRODUCTION
@@ -0,0 +1,104 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+using namespace Data::LoggingReplicator;
+using namespace Data::Utilities;
+
+NTSTATUS BackupLogChunkIndex::Create(
+    __in KAllocator & allocator,
+    __out SPtr & result) noexcept
+{
+    result = _new(BACKUP_LOG_CHUNK_INDEX_TAG, allocator) BackupLogChunkIndex();
+    if (result == nullptr)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    if (!NT_SUCCESS(result->Status()))
+    {
+        return (SPtr(Ktl::Move(result)))->Status();
+    }
+
+    return STATUS_SUCCESS;
+}
+
+BackupLogChunkIndex::SPtr BackupLogChunkIndex::Read(
+    __in BinaryReader & reader,
+    __in BlockHandle const & handle,
+    __in KAllocator & allocator)
+{
+    SPtr result = nullptr;
+    NTSTATUS status = Create(allocator, result);
+    THROW_ON_FAILURE(status);
+
+    ULONG32 count = 0;
+    reader.Read(count);
+
+    // Every entry is 16 bytes, so a count that does not fit in the block means the block is corrupt.
+    if (sizeof(ULONG32) + (static_cast<ULONG64>(count) * (sizeof(ULONG64) + sizeof(ULONG32) + sizeof(ULONG32))) > handle.Size)
+    {
+        throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+    }
+
+    for (ULONG32 i = 0; i < count; i++)
+    {
+        ULONG64 offset = 0;
+        ULONG32 size = 0;
+        ULONG32 recordCount = 0;
+
+        reader.Read(offset);
+        reader.Read(size);
+        reader.Read(recordCount);
+
+        result->Append(offset, size, recordCount);
+    }
+
+    return result;
+}
+
+ULONG32 BackupLogChunkIndex::get_Count() const { return static_cast<ULONG32>(entries_.Count()); }
+
+BackupLogChunkIndex::Entry const & BackupLogChunkIndex::operator[](__in ULONG32 index) const
+{
+    return entries_[index];
+}
+
+void BackupLogChunkIndex::Append(
+    __in ULONG64 offset,
+    __in ULONG32 size,
+    __in ULONG32 recordCount)
+{
+    Entry entry;
+    entry.Offset = offset;
+    entry.Size = size;
+    entry.RecordCount = recordCount;
+
+    NTSTATUS status = entries_.Append(entry);
+    THROW_ON_FAILURE(status);
+}
+
+void BackupLogChunkIndex::Write(__in BinaryWriter & writer)
+{
+    writer.Write(static_cast<ULONG32>(entries_.Count()));
+
+    for (ULONG32 i = 0; i < entries_.Count(); i++)
+    {
+        writer.Write(entries_[i].Offset);
+        writer.Write(entries_[i].Size);
+        writer.Write(entries_[i].RecordCount);
+    }
+}
+
+BackupLogChunkIndex::BackupLogChunkIndex()
+    : entries_(GetThisAllocator())
+{
+    SetConstructorStatus(entries_.Status());
+}
+
+BackupLogChunkIndex::~BackupLogChunkIndex()
+{
+}
@@ -0,0 +1,76 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace LoggingReplicator
+    {
+        //
+        // Index block of a chunked backup log file.
+        // Each entry locates one chunk of log records, so a reader can read ahead and decode chunks independently.
+        //
+        // A chunk is laid out as:
+        //
+        //  Header          chunk size (excluding the checksum) | codec id | uncompressed size | record count, each a ULONG32
+        //  Payload         the serialized log records, compressed with the codec in the header (None if they did not compress)
+        //  Checksum        CRC64 of the header and the payload
+        //
+        class BackupLogChunkIndex final
+            : public KObject<BackupLogChunkIndex>
+            , public KShared<BackupLogChunkIndex>
+        {
+            K_FORCE_SHARED(BackupLogChunkIndex)
+
+        public:
+            static const ULONG32 ChunkHeaderSize = 4 * sizeof(ULONG32);
+
+            struct Entry
+            {
+                // Offset of the chunk in the file.
+                ULONG64 Offset;
+
+                // Size of the chunk, excluding its checksum.
+                ULONG32 Size;
+
+                // Number of log records in the chunk.
+                ULONG32 RecordCount;
+            };
+
+        public: // Static functions.
+            static NTSTATUS Create(
+                __in KAllocator & allocator,
+                __out SPtr & result) noexcept;
+
+            static SPtr Read(
+                __in Utilities::BinaryReader & reader,
+                __in Utilities::BlockHandle const & handle,
+                __in KAllocator & allocator);
+
+        public: // Properties.
+            __declspec(property(get = get_Count)) ULONG32 Count;
+            ULONG32 BackupLogChunkIndex::get_Count() const;
+
+        public:
+            Entry const & operator[](__in ULONG32 index) const;
+
+            void Append(
+                __in ULONG64 offset,
+                __in ULONG32 size,
+                __in ULONG32 recordCount);
+
+            //
+            // Serialized layout:
+            // Count        ULONG32
+            // Entries      Count * (Offset ULONG64, Size ULONG32, RecordCount ULONG32)
+            //
+            void Write(__in Utilities::BinaryWriter & writer);
+
+        private:
+            KArray<Entry> entries_;
+        };
+    }
+}
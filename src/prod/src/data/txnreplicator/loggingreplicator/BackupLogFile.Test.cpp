@@ -431,6 +431,83 @@ namespace LoggingReplicatorTests
         File::Delete2(L"BLP_CreateAndOpen_MoreThanOneBlockSize_AllLogRecordsWrittenAndRead.txt");
     }
 
+    // Scenario: Backup log written as compressed chunks is read back in order through the read ahead enumerator.
+    BOOST_AUTO_TEST_CASE(CreateAndOpen_Compressed_MoreThanOneBlockSize_AllLogRecordsWrittenAndRead)
+    {
+        TEST_TRACE_BEGIN("CreateAndOpen_Compressed_MoreThanOneBlockSize_AllLogRecordsWrittenAndRead")
+        {
+            InvalidLogRecords::SPtr invalidLogRecords = InvalidLogRecords::Create(allocator);
+
+            TestLogRecords::SPtr testLogRecords = TestLogRecords::Create(allocator);
+            testLogRecords->InitializeWithNewLogRecords();
+            testLogRecords->AddUpdateEpochLogRecord();
+
+            for (int i = 0; i < 16; i++)
+            {
+                testLogRecords->PopulateWithRandomRecords(32);
+                testLogRecords->AddUpdateEpochLogRecord();
+            }
+
+            IAsyncEnumerator<LogRecord::SPtr>::SPtr logRecordsEnumerator(testLogRecords.RawPtr());
+
+            KWString fileName = CreateFileName(L"BLP_CreateAndOpen_Compressed_MoreThanOneBlockSize_AllLogRecordsWrittenAndRead.txt", allocator);
+
+            // Test write the file
+            BackupLogRecord::SPtr backupLogRecordSPtr = BackupLogRecord::CreateZeroBackupLogRecord(
+                *invalidLogRecords->Inv_PhysicalLogRecord,
+                allocator);
+            BackupLogFile::SPtr backupLogFileSPtr = BackupLogFile::Create(
+                *prId_,
+                fileName,
+                allocator);
+            backupLogFileSPtr->SetCompressionCodec(CompressionCodecId::Lz);
+
+            SyncAwait(backupLogFileSPtr->WriteAsync(
+                *logRecordsEnumerator,
+                *backupLogRecordSPtr,
+                CancellationToken::None));
+
+            // Read Test
+            {
+                // Read the backup file
+                BackupLogFile::SPtr readBackupLogFileSPtr = BackupLogFile::Create(
+                    *prId_,
+                    fileName,
+                    allocator);
+
+                SyncAwait(readBackupLogFileSPtr->ReadAsync(CancellationToken::None));
+
+                // Verification
+                VERIFY_ARE_EQUAL(readBackupLogFileSPtr->CompressionCodec, CompressionCodecId::Lz);
+                VERIFY_ARE_EQUAL(readBackupLogFileSPtr->IndexingRecordLSN, testLogRecords->GetLastIndexingLogRecord()->Lsn);
+                VERIFY_ARE_EQUAL(readBackupLogFileSPtr->LastBackedUpLSN, testLogRecords->GetLSN());
+                VERIFY_ARE_EQUAL(readBackupLogFileSPtr->Count, testLogRecords->GetCount());
+
+                // Verification of the log records and their order.
+                testLogRecords->Reset();
+
+                ULONG32 count = 0;
+                BackupLogFileAsyncEnumerator::SPtr enumerator = readBackupLogFileSPtr->GetAsyncEnumerator();
+                while (SyncAwait(enumerator->MoveNextAsync(CancellationToken::None)) == true)
+                {
+                    bool hasExpected = SyncAwait(testLogRecords->MoveNextAsync(CancellationToken::None));
+                    VERIFY_IS_TRUE(hasExpected);
+
+                    VERIFY_ARE_EQUAL(enumerator->GetCurrent()->RecordType, testLogRecords->GetCurrent()->RecordType);
+                    VERIFY_ARE_EQUAL(enumerator->GetCurrent()->Lsn, testLogRecords->GetCurrent()->Lsn);
+                    count++;
+                }
+
+                SyncAwait(enumerator->CloseAsync());
+
+                VERIFY_ARE_EQUAL(count, testLogRecords->GetCount());
+            }
+        }
+
+        // Ignore error since this is only for clean up.
+        File::Delete2(L"BLP_CreateAndOpen_Compressed_MoreThanOneBlockSize_AllLogRecordsWrittenAndRead.txt");
+    }
+
     // Scenario: Incremental backup from a replica that has full backed up when the log was new born with only UpdateEpoch for election.
     BOOST_AUTO_TEST_CASE(CreateAndOpen_IncrementalBackup_BaseWithoutElectionBarrier_AllLogRecordsWrittenAndRead)
     {
@@ -40,6 +40,27 @@ TxnReplicator::Epoch BackupLogFile::get_LastBackedUpEpoch() const { return prope
 
 FABRIC_SEQUENCE_NUMBER BackupLogFile::get_LastBackedUpLSN() const { return propertiesSPtr_->LastBackedUpLSN; }
 
+CompressionCodecId::Enum BackupLogFile::get_CompressionCodec() const { return propertiesSPtr_->CompressionCodec; }
+
+void BackupLogFile::SetCompressionCodec(__in CompressionCodecId::Enum codecId)
+{
+    if (codecId == CompressionCodecId::None)
+    {
+        compressionCodecSPtr_ = nullptr;
+        chunkIndexSPtr_ = nullptr;
+        propertiesSPtr_->CompressionCodec = CompressionCodecId::None;
+        return;
+    }
+
+    NTSTATUS status = CompressionCodecFactory::Create(codecId, GetThisAllocator(), compressionCodecSPtr_);
+    THROW_ON_FAILURE(status);
+
+    status = BackupLogChunkIndex::Create(GetThisAllocator(), chunkIndexSPtr_);
+    THROW_ON_FAILURE(status);
+
+    propertiesSPtr_->CompressionCodec = codecId;
+}
+
 // This function writes a backup log file.
 // Algorithm
 // 1. Create file and file stream.
@@ -120,6 +141,9 @@ ktl::Awaitable<void> BackupLogFile::WriteAsync(
             propertiesSPtr_->LastBackedUpLSN = incrementalLogRecordsPtr->HighestBackedUpLSN;
         }
 
+        // Wait for the last chunk to be written before the properties and the chunk index.
+        co_await this->DrainChunkWriteAsync();
+
         // Step 3: Write properties.
         BlockHandle::SPtr propertiesHandleSPtr = co_await this->WritePropertiesAsync(*fileStreamSPtr, cancellationToken);
 
@@ -143,6 +167,21 @@ ktl::Awaitable<void> BackupLogFile::WriteAsync(
         LR_TRACE_UNEXPECTEDEXCEPTION(
             L"BackupLogFile::WriteAsync failed",
             e.GetStatus());
+
+        exceptionSPtr = SharedException::Create(e, GetThisAllocator());
+    }
+
+    // A chunk may still be in flight if writing the log records failed. It must complete before the stream is closed.
+    if (isChunkWritePending_)
+    {
+        try
+        {
+            co_await this->DrainChunkWriteAsync();
+        }
+        catch (ktl::Exception &)
+        {
+            // The first exception is already captured.
+        }
     }
 
     // Note: CloseAsync may fail in two situation, 1. OOM 2. Flush-on-close.
@@ -208,6 +247,24 @@ ktl::Awaitable<void> BackupLogFile::ReadAsync(
 
         // Step 3: Read and populate the properties.
         co_await ReadPropertiesAsync(*fileStreamSPtr, cancellationToken);
+
+        // Chunked files also carry the chunk index used to read them.
+        if (footerSPtr_->Version == ChunkedVersion)
+        {
+            BlockHandle::SPtr chunkIndexHandle = propertiesSPtr_->ChunkIndexHandle;
+            if (chunkIndexHandle == nullptr)
+            {
+                throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+            }
+
+            FileBlock<BackupLogChunkIndex::SPtr>::DeserializerFunc chunkIndexDeserializerFunction(&BackupLogChunkIndex::Read);
+            chunkIndexSPtr_ = co_await FileBlock<BackupLogChunkIndex::SPtr>::ReadBlockAsync(
+                *fileStreamSPtr,
+                *chunkIndexHandle,
+                chunkIndexDeserializerFunction,
+                GetThisAllocator(),
+                cancellationToken);
+        }
     }
     catch (ktl::Exception & e)
     {
@@ -237,6 +294,8 @@ BackupLogFileAsyncEnumerator::SPtr BackupLogFile::GetAsyncEnumerator() const
         filePath_,
         propertiesSPtr_->Count,
         *propertiesSPtr_->RecordsHandle,
+        chunkIndexSPtr_.RawPtr(),
+        propertiesSPtr_->CompressionCodec,
         GetThisAllocator());
 }
 
@@ -467,6 +526,12 @@ ktl::Awaitable<void> BackupLogFile::WriteLogRecordBlockAsync(
 {
     KCoShared$ApiEntry();
 
+    if (compressionCodecSPtr_ != nullptr)
+    {
+        co_await this->WriteLogRecordChunkAsync(operationDataArray, outputStream);
+        co_return;
+    }
+
     // Serialize block size.
     binaryWriter.Position = 0;
     binaryWriter.Write(blockSize);
@@ -502,6 +567,144 @@ ktl::Awaitable<void> BackupLogFile::WriteLogRecordBlockAsync(
     co_return;
 }
 
+// Hands the block over to be compressed and written as a chunk, while the caller serializes the next block.
+// Algorithm:
+// 1. Wait for the previous chunk. This keeps the chunks in order and bounds the memory to two blocks.
+// 2. Take a copy of the block, since the caller reuses the array.
+// 3. Start compressing and writing the chunk without awaiting it.
+ktl::Awaitable<void> BackupLogFile::WriteLogRecordChunkAsync(
+    __in KArray<OperationData::CSPtr> const & operationDataArray,
+    __inout ktl::io::KStream & outputStream)
+{
+    KShared$ApiEntry();
+
+    // Step 1: Wait for the previous chunk.
+    co_await this->DrainChunkWriteAsync();
+
+    // Step 2: Take a copy of the block.
+    KSharedArray<OperationData::CSPtr>::SPtr chunkRecords = _new(GetThisAllocationTag(), GetThisAllocator()) KSharedArray<OperationData::CSPtr>();
+    THROW_ON_ALLOCATION_FAILURE(chunkRecords);
+    THROW_ON_FAILURE(chunkRecords->Status());
+
+    for (ULONG32 i = 0; i < operationDataArray.Count(); i++)
+    {
+        NTSTATUS status = chunkRecords->Append(operationDataArray[i]);
+        THROW_ON_FAILURE(status);
+    }
+
+    // Step 3: Compress and write in the background.
+    chunkWriteAwaitable_ = this->CompressAndWriteChunkAsync(*chunkRecords, outputStream);
+    isChunkWritePending_ = true;
+
+    co_return;
+}
+
+ktl::Awaitable<void> BackupLogFile::CompressAndWriteChunkAsync(
+    __in KSharedArray<OperationData::CSPtr> & operationDataArray,
+    __inout ktl::io::KStream & outputStream)
+{
+    KShared$ApiEntry();
+
+    KSharedArray<OperationData::CSPtr>::SPtr operationDataArraySPtr(&operationDataArray);
+    ktl::io::KStream::SPtr outputStreamSPtr(&outputStream);
+
+    // Compression is CPU bound, so move off the thread that serializes the log records.
+    co_await CorHelper::ThreadPoolThread(GetThisKtlSystem().DefaultThreadPool());
+
+    ULONG32 chunkSize = 0;
+    KBuffer::SPtr chunk = CreateChunk(*operationDataArraySPtr, chunkSize);
+
+    // Chunks are written one at a time, so the position is the offset of this chunk.
+    ULONG64 offset = static_cast<ULONG64>(outputStreamSPtr->GetPosition());
+
+    NTSTATUS status = co_await outputStreamSPtr->WriteAsync(*chunk, 0, chunkSize + CheckSumSectionSize);
+    THROW_ON_FAILURE(status);
+
+    chunkIndexSPtr_->Append(offset, chunkSize, operationDataArraySPtr->Count());
+
+    co_return;
+}
+
+ktl::Awaitable<void> BackupLogFile::DrainChunkWriteAsync()
+{
+    KShared$ApiEntry();
+
+    if (isChunkWritePending_ == false)
+    {
+        co_return;
+    }
+
+    isChunkWritePending_ = false;
+    co_await chunkWriteAwaitable_;
+
+    co_return;
+}
+
+KBuffer::SPtr BackupLogFile::CreateChunk(
+    __in KSharedArray<OperationData::CSPtr> const & operationDataArray,
+    __out ULONG32 & chunkSize)
+{
+    ULONG64 totalSize = 0;
+    for (OperationData::CSPtr const & operationData : operationDataArray)
+    {
+        totalSize += static_cast<ULONG64>(OperationData::GetOperationSize(*operationData));
+    }
+
+    // Blocks are flushed well below 4 GB unless a single record is close to the maximum log record size.
+    if (totalSize + BackupLogChunkIndex::ChunkHeaderSize + CheckSumSectionSize > MAXULONG32)
+    {
+        throw ktl::Exception(STATUS_INVALID_PARAMETER);
+    }
+
+    ULONG32 uncompressedSize = static_cast<ULONG32>(totalSize);
+
+    // Gather the serialized records into one contiguous block for the codec.
+    KBuffer::SPtr source = nullptr;
+    NTSTATUS status = KBuffer::Create(uncompressedSize, source, GetThisAllocator());
+    THROW_ON_FAILURE(status);
+
+    ULONG32 sourceOffset = 0;
+    for (OperationData::CSPtr const & operationData : operationDataArray)
+    {
+        for (ULONG32 bufferIndex = 0; bufferIndex < operationData->BufferCount; bufferIndex++)
+        {
+            KBuffer::CSPtr buffer((*operationData)[bufferIndex]);
+            memcpy(static_cast<byte *>(source->GetBuffer()) + sourceOffset, buffer->GetBuffer(), buffer->QuerySize());
+            sourceOffset += buffer->QuerySize();
+        }
+    }
+
+    KBuffer::SPtr chunk = nullptr;
+    status = KBuffer::Create(BackupLogChunkIndex::ChunkHeaderSize + uncompressedSize + CheckSumSectionSize, chunk, GetThisAllocator());
+    THROW_ON_FAILURE(status);
+
+    byte * chunkBytes = static_cast<byte *>(chunk->GetBuffer());
+    byte * payload = chunkBytes + BackupLogChunkIndex::ChunkHeaderSize;
+
+    // Keep the compressed payload only if it is smaller, otherwise store the records as is.
+    CompressionCodecId::Enum codecId = compressionCodecSPtr_->Id;
+    ULONG32 payloadSize = uncompressedSize > 0 ?
+        compressionCodecSPtr_->Compress(static_cast<byte const *>(source->GetBuffer()), uncompressedSize, payload, uncompressedSize - 1) :
+        0;
+
+    if (payloadSize == 0)
+    {
+        codecId = CompressionCodecId::None;
+        payloadSize = uncompressedSize;
+        memcpy(payload, source->GetBuffer(), uncompressedSize);
+    }
+
+    chunkSize = BackupLogChunkIndex::ChunkHeaderSize + payloadSize;
+
+    ULONG32 header[4] = { chunkSize, static_cast<ULONG32>(codecId), uncompressedSize, static_cast<ULONG32>(operationDataArray.Count()) };
+    memcpy(chunkBytes, header, BackupLogChunkIndex::ChunkHeaderSize);
+
+    ULONG64 checksum = CRC64::ToCRC64(chunkBytes, 0, chunkSize);
+    memcpy(chunkBytes + chunkSize, &checksum, CheckSumSectionSize);
+
+    return chunk;
+}
+
 ktl::Awaitable<void> BackupLogFile::WriteFooterAsync(
     __in ktl::io::KFileStream& fileStream, 
     __in BlockHandle& propertiesBlockHandle, 
@@ -514,10 +717,16 @@ ktl::Awaitable<void> BackupLogFile::WriteFooterAsync(
     NTSTATUS status = STATUS_UNSUCCESSFUL;
     ktl::io::KFileStream::SPtr fileStreamSPtr(&fileStream);
 
+    ULONG32 version = Version;
+    if (chunkIndexSPtr_ != nullptr)
+    {
+        version = ChunkedVersion;
+    }
+
     FileFooter::SPtr fileFooterSPtr;
     status = FileFooter::Create(
         propertiesBlockHandle,
-        Version,
+        version,
         GetThisAllocator(),
         fileFooterSPtr);
     THROW_ON_FAILURE(status);
@@ -582,7 +791,7 @@ ktl::Awaitable<void> BackupLogFile::ReadFooterAsync(
     cancellationToken.ThrowIfCancellationRequested();
 
     // Verify we know how to deserialize this version of the state manager checkpoint file.
-    if (footerSPtr_->Version != Version)
+    if (footerSPtr_->Version != Version && footerSPtr_->Version != ChunkedVersion)
     {
         throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
     }
@@ -609,6 +818,25 @@ ktl::Awaitable<BlockHandle::SPtr> BackupLogFile::WritePropertiesAsync(
 
     propertiesSPtr_->RecordsHandle = *recordsHandleSPtr;
 
+    // The chunk index follows the records and is located through the properties.
+    if (chunkIndexSPtr_ != nullptr)
+    {
+        FileBlock<BackupLogChunkIndex::SPtr>::SerializerFunc chunkIndexSerializerFunction(
+            chunkIndexSPtr_.RawPtr(),
+            &BackupLogChunkIndex::Write);
+
+        BlockHandle::SPtr chunkIndexHandleSPtr = nullptr;
+        status = co_await FileBlock<BackupLogChunkIndex::SPtr>::WriteBlockAsync(
+            fileStream,
+            chunkIndexSerializerFunction,
+            GetThisAllocator(),
+            cancellationToken,
+            chunkIndexHandleSPtr);
+        THROW_ON_FAILURE(status);
+
+        propertiesSPtr_->ChunkIndexHandle = *chunkIndexHandleSPtr;
+    }
+
     FileBlock<BackupLogFileProperties::SPtr>::SerializerFunc serializerFunction(
         propertiesSPtr_.RawPtr(),
         &BackupLogFileProperties::Write);
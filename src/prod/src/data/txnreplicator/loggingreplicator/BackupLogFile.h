@@ -50,7 +50,18 @@ namespace Data
             __declspec(property(get = get_LastBackedUpLSN)) FABRIC_SEQUENCE_NUMBER LastBackedUpLSN;
             FABRIC_SEQUENCE_NUMBER BackupLogFile::get_LastBackedUpLSN() const;
 
+            __declspec(property(get = get_CompressionCodec)) Utilities::CompressionCodecId::Enum CompressionCodec;
+            Utilities::CompressionCodecId::Enum BackupLogFile::get_CompressionCodec() const;
+
         public: 
+            //
+            // Sets the codec used by WriteAsync. Any codec other than None writes a chunked (version 2) file:
+            // the log records are written as compressed, checksummed chunks followed by a chunk index block,
+            // so that restore can read ahead and decode the chunks in parallel.
+            // None (default) writes the version 1 format.
+            //
+            void SetCompressionCodec(__in Utilities::CompressionCodecId::Enum codecId);
+
             // Create a new CheckpointFile and write it to the given file.    
             ktl::Awaitable<void> WriteAsync(
                 __in Utilities::IAsyncEnumerator<LogRecordLib::LogRecord::SPtr> & logRecords,
@@ -89,6 +100,20 @@ namespace Data
                 __inout KArray<Utilities::OperationData::CSPtr> & operationDataArray,
                 __inout ktl::io::KStream & outputStream);
 
+            ktl::Awaitable<void> WriteLogRecordChunkAsync(
+                __in KArray<Utilities::OperationData::CSPtr> const & operationDataArray,
+                __inout ktl::io::KStream & outputStream);
+
+            ktl::Awaitable<void> CompressAndWriteChunkAsync(
+                __in KSharedArray<Utilities::OperationData::CSPtr> & operationDataArray,
+                __inout ktl::io::KStream & outputStream);
+
+            ktl::Awaitable<void> DrainChunkWriteAsync();
+
+            KBuffer::SPtr CreateChunk(
+                __in KSharedArray<Utilities::OperationData::CSPtr> const & operationDataArray,
+                __out ULONG32 & chunkSize);
+
             ktl::Awaitable<void> WriteFooterAsync(
                 __in ktl::io::KFileStream & fileStream,
                 __in Data::Utilities::BlockHandle & propertiesBlockHandle,
@@ -111,6 +136,7 @@ namespace Data
             static const ULONG32 InitialSizeOfMemoryStream = 32 * NumberOfBytesInKB;
             static const ULONG32 MinimumIntermediateFlushSize = InitialSizeOfMemoryStream;
             static const ULONG32 Version = 1;
+            static const ULONG32 ChunkedVersion = 2;
             static const UINT8 BlockSizeSectionSize = sizeof(ULONG32);
             static const UINT8 CheckSumSectionSize = sizeof(ULONG64);
 
@@ -127,6 +153,14 @@ namespace Data
 
             // footerSPtr has the infomation about version and offset and size of properties
             Utilities::FileFooter::SPtr footerSPtr_;
+
+            // Set for chunked files only.
+            Utilities::ICompressionCodec::SPtr compressionCodecSPtr_;
+            BackupLogChunkIndex::SPtr chunkIndexSPtr_;
+
+            // Compression and write of the last chunk. At most one chunk is in flight while the next one is serialized.
+            ktl::Awaitable<void> chunkWriteAwaitable_;
+            bool isChunkWritePending_ = false;
         };
     }
 }
@@ -14,12 +14,16 @@ BackupLogFileAsyncEnumerator::SPtr BackupLogFileAsyncEnumerator::Create(
     __in KWString const & fileName,
     __in ULONG32 logRecordCount,
     __in BlockHandle & blockHandle,
+    __in_opt BackupLogChunkIndex const * chunkIndex,
+    __in CompressionCodecId::Enum compressionCodec,
     __in KAllocator & allocator)
 {
     BackupLogFileAsyncEnumerator * pointer = _new(BACKUP_LOG_FILE_ASYNC_ENUMERATOR_TAG, allocator) BackupLogFileAsyncEnumerator(
         fileName,
         logRecordCount,
-        blockHandle);
+        blockHandle,
+        chunkIndex,
+        compressionCodec);
 
     THROW_ON_ALLOCATION_FAILURE(pointer);
     THROW_ON_FAILURE(pointer->Status());
@@ -89,6 +93,13 @@ ktl::Awaitable<bool> BackupLogFileAsyncEnumerator::MoveNextAsync(
 
     // Step 3: Since there are no items in the cache, read the next block.
     // This call populates the cache (currentLogRecordsSPtr_) if there is another block.
+    // Chunked files are read through their chunk index instead.
+    if (chunkIndexCSPtr_ != nullptr)
+    {
+        bool hasChunk = co_await ReadChunkAsync();
+        co_return hasChunk;
+    }
+
     bool isDrained = co_await ReadBlockAsync();
     co_return isDrained;
 }
@@ -114,6 +125,20 @@ ktl::Awaitable<void> BackupLogFileAsyncEnumerator::CloseAsync()
         co_return;
     }
 
+    // Chunks that were read ahead may still be decoding. Failures are ignored since their records will not be returned.
+    while (nextChunkToConsume_ < nextChunkToRead_)
+    {
+        try
+        {
+            co_await decodeAwaitables_[nextChunkToConsume_ % MaxChunksInFlight];
+        }
+        catch (ktl::Exception &)
+        {
+        }
+
+        nextChunkToConsume_++;
+    }
+
     // In the case of creating FileStream failed, fileStreamSPtr_ is nullptr, close call on it will AV.
     if (fileStreamSPtr_ != nullptr)
     {
@@ -242,16 +267,178 @@ ktl::Awaitable<bool> BackupLogFileAsyncEnumerator::ReadBlockAsync()
     co_return true;
 }
 
+// Returns the records of the next chunk of a chunked file.
+// Algorithm:
+// 1. Read ahead until MaxChunksInFlight chunks are being decoded or all chunks have been read.
+//    Reads are sequential on the file stream, decoding runs on the thread pool.
+// 2. If every chunk has been consumed return false.
+// 3. Wait for the oldest chunk and make its records the cache.
+ktl::Awaitable<bool> BackupLogFileAsyncEnumerator::ReadChunkAsync()
+{
+    KShared$ApiEntry();
+
+    // Step 1: Read ahead.
+    while (nextChunkToRead_ < chunkIndexCSPtr_->Count && nextChunkToRead_ - nextChunkToConsume_ < MaxChunksInFlight)
+    {
+        BackupLogChunkIndex::Entry const & entry = (*chunkIndexCSPtr_)[nextChunkToRead_];
+
+        KBuffer::SPtr chunk = co_await ReadChunkBytesAsync(entry);
+        decodeAwaitables_[nextChunkToRead_ % MaxChunksInFlight] = DecodeChunkAsync(*chunk, entry.RecordCount);
+        nextChunkToRead_++;
+    }
+
+    // Step 2: Check if all chunks are consumed.
+    if (nextChunkToConsume_ == nextChunkToRead_)
+    {
+        co_return false;
+    }
+
+    // Step 3: Replace the cache with the records of the oldest chunk.
+    ULONG32 chunkIndex = nextChunkToConsume_ % MaxChunksInFlight;
+    nextChunkToConsume_++;
+
+    currentLogRecordsSPtr_ = co_await decodeAwaitables_[chunkIndex];
+    currentIndex_ = 0;
+
+    co_return true;
+}
+
+ktl::Awaitable<KBuffer::SPtr> BackupLogFileAsyncEnumerator::ReadChunkBytesAsync(
+    __in BackupLogChunkIndex::Entry const & entry)
+{
+    KShared$ApiEntry();
+
+    // The index is checksummed, but the chunk must still fit the records section and hold at least its header.
+    if (entry.Size < BackupLogChunkIndex::ChunkHeaderSize ||
+        entry.Offset + entry.Size + CheckSumSectionSize > blockHandeCSPtr_->EndOffset())
+    {
+        throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+    }
+
+    ULONG32 chunkSizeWithChecksum = entry.Size + CheckSumSectionSize;
+
+    KBuffer::SPtr buffer = nullptr;
+    NTSTATUS status = KBuffer::Create(chunkSizeWithChecksum, buffer, GetThisAllocator());
+    THROW_ON_FAILURE(status);
+
+    fileStreamSPtr_->SetPosition(static_cast<LONGLONG>(entry.Offset));
+
+    ULONG bytesRead = 0;
+    status = co_await fileStreamSPtr_->ReadAsync(*buffer, bytesRead, 0, chunkSizeWithChecksum);
+    THROW_ON_FAILURE(status);
+    if (bytesRead != chunkSizeWithChecksum)
+    {
+        throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+    }
+
+    co_return buffer;
+}
+
+// Verifies, decompresses and deserializes a chunk on the thread pool.
+ktl::Awaitable<KSharedArray<LogRecord::SPtr>::SPtr> BackupLogFileAsyncEnumerator::DecodeChunkAsync(
+    __in KBuffer & chunk,
+    __in ULONG32 recordCount)
+{
+    KShared$ApiEntry();
+
+    KBuffer::SPtr chunkSPtr(&chunk);
+
+    co_await CorHelper::ThreadPoolThread(GetThisKtlSystem().DefaultThreadPool());
+
+    byte const * chunkBytes = static_cast<byte const *>(chunkSPtr->GetBuffer());
+    ULONG32 chunkSize = chunkSPtr->QuerySize() - CheckSumSectionSize;
+
+    // Verify the checksum before trusting any of the header.
+    ULONG64 checksum = 0;
+    memcpy(&checksum, chunkBytes + chunkSize, CheckSumSectionSize);
+    if (checksum != CRC64::ToCRC64(chunkBytes, 0, chunkSize))
+    {
+        throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+    }
+
+    ULONG32 header[4];
+    memcpy(header, chunkBytes, BackupLogChunkIndex::ChunkHeaderSize);
+
+    ULONG32 headerChunkSize = header[0];
+    CompressionCodecId::Enum codecId = static_cast<CompressionCodecId::Enum>(header[1]);
+    ULONG32 uncompressedSize = header[2];
+    ULONG32 headerRecordCount = header[3];
+
+    if (headerChunkSize != chunkSize || headerRecordCount != recordCount)
+    {
+        throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+    }
+
+    byte const * payload = chunkBytes + BackupLogChunkIndex::ChunkHeaderSize;
+    ULONG32 payloadSize = chunkSize - BackupLogChunkIndex::ChunkHeaderSize;
+
+    KBuffer::SPtr records = nullptr;
+    NTSTATUS status = KBuffer::Create(uncompressedSize, records, GetThisAllocator());
+    THROW_ON_FAILURE(status);
+
+    if (codecId == CompressionCodecId::None)
+    {
+        if (payloadSize != uncompressedSize)
+        {
+            throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+        }
+
+        memcpy(records->GetBuffer(), payload, payloadSize);
+    }
+    else
+    {
+        if (compressionCodecSPtr_ == nullptr || codecId != compressionCodecSPtr_->Id)
+        {
+            throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+        }
+
+        status = compressionCodecSPtr_->Decompress(payload, payloadSize, static_cast<byte *>(records->GetBuffer()), uncompressedSize);
+        THROW_ON_FAILURE(status);
+    }
+
+    KSharedArray<LogRecord::SPtr>::SPtr logRecords = _new(GetThisAllocationTag(), GetThisAllocator()) KSharedArray<LogRecord::SPtr>();
+    THROW_ON_ALLOCATION_FAILURE(logRecords);
+    THROW_ON_FAILURE(logRecords->Status());
+
+    MemoryStream::SPtr memoryStream = nullptr;
+    status = MemoryStream::Create(*records, GetThisAllocator(), memoryStream);
+    THROW_ON_FAILURE(status);
+
+    while (static_cast<ULONG32>(memoryStream->GetPosition()) < uncompressedSize)
+    {
+        LogRecord::SPtr logRecord = co_await LogRecord::ReadNextRecordAsync(
+            *memoryStream,
+            *invalidLogRecords_,
+            GetThisAllocator(),
+            false,  // isPhysicalRead
+            true,   // useInvalidRecordPosition
+            false); // setRecordLength
+
+        status = logRecords->Append(logRecord);
+        THROW_ON_FAILURE(status);
+    }
+
+    if (logRecords->Count() != recordCount || recordCount == 0)
+    {
+        throw ktl::Exception(STATUS_INTERNAL_DB_CORRUPTION);
+    }
+
+    co_return logRecords;
+}
+
 BackupLogFileAsyncEnumerator::BackupLogFileAsyncEnumerator(
     __in KWString const & fileName,
     __in ULONG32 logRecordCount,
-    __in BlockHandle & blockHandle) noexcept
+    __in BlockHandle & blockHandle,
+    __in_opt BackupLogChunkIndex const * chunkIndex,
+    __in CompressionCodecId::Enum compressionCodec) noexcept
     : KObject<BackupLogFileAsyncEnumerator>()
     , KShared<BackupLogFileAsyncEnumerator>()
     , fileName_(fileName)
     , logRecordCount_(logRecordCount)
     , blockHandeCSPtr_(&blockHandle)
     , invalidLogRecords_(InvalidLogRecords::Create(GetThisAllocator()))
+    , chunkIndexCSPtr_(chunkIndex)
 {
     if (NT_SUCCESS(invalidLogRecords_->Status()) == false)
     {
@@ -259,6 +446,16 @@ BackupLogFileAsyncEnumerator::BackupLogFileAsyncEnumerator(
         return;
     }
 
+    if (compressionCodec != CompressionCodecId::None)
+    {
+        NTSTATUS status = CompressionCodecFactory::Create(compressionCodec, GetThisAllocator(), compressionCodecSPtr_);
+        if (NT_SUCCESS(status) == false)
+        {
+            SetConstructorStatus(status);
+            return;
+        }
+    }
+
     currentLogRecordsSPtr_ = _new(GetThisAllocationTag(), GetThisAllocator())KSharedArray<LogRecord::SPtr>;
     if (currentLogRecordsSPtr_ == nullptr)
     {
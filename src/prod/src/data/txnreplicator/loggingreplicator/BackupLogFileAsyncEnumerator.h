@@ -12,6 +12,9 @@ namespace Data
         //
         // An abstraction for an iterator over log records that are created from a valid physical log reader
         //
+        // For chunked backup log files, up to MaxChunksInFlight chunks are read ahead and verified, decompressed and
+        // deserialized on the thread pool in parallel. Records are still returned in log order.
+        //
         class BackupLogFileAsyncEnumerator
             : public KObject<BackupLogFileAsyncEnumerator>
             , public KShared<BackupLogFileAsyncEnumerator>
@@ -26,6 +29,8 @@ namespace Data
                 __in KWString const & fileName,
                 __in ULONG32 logRecordCount,
                 __in Utilities::BlockHandle & blockHandle,
+                __in_opt BackupLogChunkIndex const * chunkIndex,
+                __in Utilities::CompressionCodecId::Enum compressionCodec,
                 __in KAllocator & allocator);
 
         public: // IAsyncEnumerator
@@ -45,29 +50,47 @@ namespace Data
         private:
             ktl::Awaitable<bool> ReadBlockAsync();
 
+            ktl::Awaitable<bool> ReadChunkAsync();
+
+            ktl::Awaitable<KBuffer::SPtr> ReadChunkBytesAsync(__in BackupLogChunkIndex::Entry const & entry);
+
+            ktl::Awaitable<KSharedArray<LogRecordLib::LogRecord::SPtr>::SPtr> DecodeChunkAsync(
+                __in KBuffer & chunk,
+                __in ULONG32 recordCount);
+
         private: // Constructor
             BackupLogFileAsyncEnumerator(
                 __in KWString const & fileName,
                 __in ULONG32 logRecordCount,
-                __in Utilities::BlockHandle & blockHandle) noexcept;
+                __in Utilities::BlockHandle & blockHandle,
+                __in_opt BackupLogChunkIndex const * chunkIndex,
+                __in Utilities::CompressionCodecId::Enum compressionCodec) noexcept;
 
         private: // Static constants
             static const UINT8 BlockSizeSectionSize = sizeof(ULONG32);
             static const UINT8 CheckSumSectionSize = sizeof(ULONG64);
+            static const ULONG32 MaxChunksInFlight = 4;
 
         private: // Initializer list initialized constants.
             const KWString fileName_;
             const ULONG32 logRecordCount_;
             const Utilities::BlockHandle::CSPtr blockHandeCSPtr_;
             const LogRecordLib::InvalidLogRecords::SPtr invalidLogRecords_;
+            const BackupLogChunkIndex::CSPtr chunkIndexCSPtr_;
 
         private: // Default initialized values
             LONG32 currentIndex_ = -1;
             bool isBlockDrained_ = false;
             bool isDisposed_ = false;
 
+            // Chunks [nextChunkToConsume_, nextChunkToRead_) are being decoded in decodeAwaitables_[chunk % MaxChunksInFlight].
+            ULONG32 nextChunkToRead_ = 0;
+            ULONG32 nextChunkToConsume_ = 0;
+            ktl::Awaitable<KSharedArray<LogRecordLib::LogRecord::SPtr>::SPtr> decodeAwaitables_[MaxChunksInFlight];
+
         private: // Constructor initialized
             KSharedArray<LogRecordLib::LogRecord::SPtr>::SPtr currentLogRecordsSPtr_;
+            Utilities::ICompressionCodec::SPtr compressionCodecSPtr_;
 
         private:
             KBlockFile::SPtr fileSPtr_;
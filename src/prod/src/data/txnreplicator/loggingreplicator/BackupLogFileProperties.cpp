@@ -44,6 +44,12 @@ void BackupLogFileProperties::put_LastBackedUpLSN(__in FABRIC_SEQUENCE_NUMBER LS
 BlockHandle::SPtr BackupLogFileProperties::get_RecordsHandle() const { return recordsHandle_.Get(); }
 void BackupLogFileProperties::put_RecordsHandle(__in BlockHandle & blocksHandle) { recordsHandle_.Put(&blocksHandle); }
 
+BlockHandle::SPtr BackupLogFileProperties::get_ChunkIndexHandle() const { return chunkIndexHandle_.Get(); }
+void BackupLogFileProperties::put_ChunkIndexHandle(__in BlockHandle & blocksHandle) { chunkIndexHandle_.Put(&blocksHandle); }
+
+CompressionCodecId::Enum BackupLogFileProperties::get_CompressionCodec() const { return compressionCodec_; }
+void BackupLogFileProperties::put_CompressionCodec(__in CompressionCodecId::Enum codecId) { compressionCodec_ = codecId; }
+
 void BackupLogFileProperties::Write(__in BinaryWriter& writer)
 {
     // Allow the base class to write first.    
@@ -80,6 +86,21 @@ void BackupLogFileProperties::Write(__in BinaryWriter& writer)
     writer.Write(LastBackedUpLsnPropertyName);
     VarInt::Write(writer, static_cast<ULONG32>(sizeof(FABRIC_SEQUENCE_NUMBER)));
     writer.Write(lastBackedUpLSN_);
+
+    // Chunked files only. Older versions skip unknown properties, but refuse the file based on the footer version.
+    BlockHandle::SPtr chunkIndexHandle = chunkIndexHandle_.Get();
+    if (chunkIndexHandle != nullptr)
+    {
+        // 'chunkindex' - BlockHandle
+        writer.Write(ChunkIndexHandlePropertyName);
+        VarInt::Write(writer, BlockHandle::SerializedSize());
+        chunkIndexHandle->Write(writer);
+
+        // 'codec' - ULONG32
+        writer.Write(CompressionCodecPropertyName);
+        VarInt::Write(writer, static_cast<ULONG32>(sizeof(ULONG32)));
+        writer.Write(static_cast<ULONG32>(compressionCodec_));
+    }
 }
 
 void BackupLogFileProperties::ReadProperty(
@@ -120,6 +141,16 @@ void BackupLogFileProperties::ReadProperty(
     {
         recordsHandle_.Put(BlockHandle::Read(reader, GetThisAllocator()));
     }
+    else if (property.Compare(ChunkIndexHandlePropertyName) == 0)
+    {
+        chunkIndexHandle_.Put(BlockHandle::Read(reader, GetThisAllocator()));
+    }
+    else if (property.Compare(CompressionCodecPropertyName) == 0)
+    {
+        ULONG32 compressionCodec = 0;
+        reader.Read(compressionCodec);
+        compressionCodec_ = static_cast<CompressionCodecId::Enum>(compressionCodec);
+    }
     else
     {
         // If the properties is unknown, just skip it.
@@ -129,6 +160,7 @@ void BackupLogFileProperties::ReadProperty(
 
 BackupLogFileProperties::BackupLogFileProperties()
     : recordsHandle_(nullptr)
+    , chunkIndexHandle_(nullptr)
 {
 }
 
@@ -44,6 +44,16 @@ namespace Data
             Utilities::BlockHandle::SPtr BackupLogFileProperties::get_RecordsHandle() const;
             void BackupLogFileProperties::put_RecordsHandle(__in Utilities::BlockHandle & blocksHandle);
 
+            // Handle of the chunk index block. Only set for chunked backup log files.
+            __declspec(property(get = get_ChunkIndexHandle, put = put_ChunkIndexHandle)) Utilities::BlockHandle::SPtr ChunkIndexHandle;
+            Utilities::BlockHandle::SPtr BackupLogFileProperties::get_ChunkIndexHandle() const;
+            void BackupLogFileProperties::put_ChunkIndexHandle(__in Utilities::BlockHandle & blocksHandle);
+
+            // Codec the chunks are compressed with. Only set for chunked backup log files.
+            __declspec(property(get = get_CompressionCodec, put = put_CompressionCodec)) Utilities::CompressionCodecId::Enum CompressionCodec;
+            Utilities::CompressionCodecId::Enum BackupLogFileProperties::get_CompressionCodec() const;
+            void BackupLogFileProperties::put_CompressionCodec(__in Utilities::CompressionCodecId::Enum codecId);
+
         public: // Override FileProperties virtual functions.
             // Writes all the properties into the target writer.
             void Write(__in Utilities::BinaryWriter & writer) override;
@@ -61,6 +71,8 @@ namespace Data
             const KStringView LastBackedUpEpochPropertyName = L"backupepoch";
             const KStringView LastBackedUpLsnPropertyName = L"backuplsn";
             const KStringView RecordsHandlePropertyName = L"records";
+            const KStringView ChunkIndexHandlePropertyName = L"chunkindex";
+            const KStringView CompressionCodecPropertyName = L"codec";
 
         private:
             // The number of log records.
@@ -78,8 +90,12 @@ namespace Data
             // The logical sequence number of the last record in the backup log.
             FABRIC_SEQUENCE_NUMBER lastBackedUpLSN_ = FABRIC_INVALID_SEQUENCE_NUMBER;
 
+            // The codec the chunks are compressed with.
+            Utilities::CompressionCodecId::Enum compressionCodec_ = Utilities::CompressionCodecId::None;
+
             // Values for the properties
             Utilities::ThreadSafeSPtrCache<Utilities::BlockHandle> recordsHandle_;
+            Utilities::ThreadSafeSPtrCache<Utilities::BlockHandle> chunkIndexHandle_;
         };
     }
 }
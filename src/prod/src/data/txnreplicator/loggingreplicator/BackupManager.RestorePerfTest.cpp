@@ -0,0 +1,309 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+#include "TestHeaders.h"
+
+#include <stdlib.h>
+#include <boost/test/unit_test.hpp>
+#include "Common/boost-taef.h"
+
+namespace LoggingReplicatorTests
+{
+    using namespace Common;
+    using namespace ktl;
+    using namespace Data::LogRecordLib;
+    using namespace Data::LoggingReplicator;
+    using namespace Data::Utilities;
+    using namespace TxnReplicator;
+
+    StringLiteral const TraceComponent("BackupManagerRestorePerfTests");
+
+    class BackupManagerRestorePerfTests
+    {
+    public:
+        Awaitable<void> Test_Restore_Performance(
+            __in KString const & backupFolder,
+            __in ULONG transactionCount,
+            __in int bufferSize,
+            __in Common::Random & rndNumber,
+            __in int seed);
+
+    protected:
+        Awaitable<void> MeasureReadAheadAsync(
+            __in BackupFolderInfo & backupFolderInfo,
+            __in KAllocator & allocator);
+
+        void AddOperationToTransaction(
+            __in Transaction & transaction,
+            __in int bufferSize,
+            __in TestStateProviderManager & stateManager);
+
+        void TraceThroughput(
+            __in std::wstring const & step,
+            __in ULONG64 bytes,
+            __in ULONG64 records,
+            __in int64 elapsedMilliseconds);
+
+        wstring CreateFileName(__in wstring const & folderName);
+
+        void EndTest();
+
+        CommonConfig config; // load the config object as its needed for the tracing to work
+        FABRIC_REPLICA_ID rId_;
+        KGuid pId_;
+        PartitionedReplicaId::SPtr prId_;
+        KtlSystem * underlyingSystem_;
+    };
+
+    //
+    // Goal: Measure the throughput of restoring a full backup, reported in MB/s and records/s of backup log.
+    //
+    // Algorithm:
+    //    1. Bring up a primary replica, commit the transactions and take a full backup.
+    //    2. Read the backup log records through the restore read ahead alone.
+    //    3. Restore the backup into a new replica end to end: checkpoint restore, log restore and replay.
+    //
+    Awaitable<void> BackupManagerRestorePerfTests::Test_Restore_Performance(
+        __in KString const & backupFolder,
+        __in ULONG transactionCount,
+        __in int bufferSize,
+        __in Common::Random & rndNumber,
+        __in int seed)
+    {
+        UNREFERENCED_PARAMETER(rndNumber);
+
+        KAllocator & allocator = underlyingSystem_->PagedAllocator();
+
+        // 1. Take a full backup.
+        {
+            InvalidLogRecords::SPtr invalidLogRecords = InvalidLogRecords::Create(allocator);
+            ApiFaultUtility::SPtr apiFaultUtility = ApiFaultUtility::Create(allocator);
+            TestBackupCallbackHandler::SPtr backupCallbackHandler = TestBackupCallbackHandler::Create(backupFolder, allocator);
+
+            TestReplica::SPtr replica = TestReplica::Create(
+                pId_,
+                *invalidLogRecords,
+                true, // isPrimary
+                nullptr,
+                *apiFaultUtility,
+                allocator);
+
+            co_await replica->InitializeAsync(
+                seed,
+                false, // skipRecovery
+                true); // delayApis
+
+            BackupManager::SPtr backupManager(replica->BackupManager);
+            backupManager->EnableBackup();
+
+            for (ULONG i = 0; i < transactionCount; i++)
+            {
+                Transaction::SPtr transaction = Transaction::CreateTransaction(*replica->TestTransactionManager, allocator);
+                KFinally([&] { transaction->Dispose(); });
+                AddOperationToTransaction(*transaction, bufferSize, *replica->StateManager);
+                co_await transaction->CommitAsync();
+            }
+
+            co_await backupManager->BackupAsync(*backupCallbackHandler);
+
+            co_await backupManager->DisableBackupAndDrainAsync();
+            co_await replica->CloseAndQuiesceReplica();
+            co_await replica->EndTestAsync(false, true);
+        }
+
+        // 2. Read the backup log records alone.
+        ULONG64 logSize = 0;
+        ULONG64 logRecordCount = 0;
+        {
+            KGuid readId;
+            readId.CreateNew();
+            BackupFolderInfo::SPtr backupFolderInfoSPtr = BackupFolderInfo::Create(*prId_, readId, backupFolder, allocator);
+            co_await backupFolderInfoSPtr->AnalyzeAsync(CancellationToken::None);
+
+            KArray<KString::CSPtr> const & logPathList = backupFolderInfoSPtr->LogPathList;
+            for (ULONG32 i = 0; i < logPathList.Count(); i++)
+            {
+                KString::CSPtr logFilePath = logPathList[i];
+
+                int64 fileSize = 0;
+                ErrorCode errorCode = File::GetSize(wstring(static_cast<LPCWSTR>(*logFilePath)), fileSize);
+                VERIFY_IS_TRUE(errorCode.IsSuccess());
+                logSize += fileSize;
+
+                KWString backupLogFilePath(allocator, *logFilePath);
+                BackupLogFile::SPtr backupLogFileSPtr = BackupLogFile::Create(*prId_, backupLogFilePath, allocator);
+                co_await backupLogFileSPtr->ReadAsync(CancellationToken::None);
+                logRecordCount += backupLogFileSPtr->Count;
+            }
+
+            co_await MeasureReadAheadAsync(*backupFolderInfoSPtr, allocator);
+        }
+
+        // 3. Restore into a new (empty) replica.
+        {
+            InvalidLogRecords::SPtr invalidLogRecords = InvalidLogRecords::Create(allocator);
+            ApiFaultUtility::SPtr apiFaultUtility = ApiFaultUtility::Create(allocator);
+
+            TestReplica::SPtr replica = TestReplica::Create(
+                pId_,
+                *invalidLogRecords,
+                true, // isPrimary
+                nullptr,
+                *apiFaultUtility,
+                allocator);
+
+            co_await replica->InitializeAsync(
+                seed,
+                false, // skipRecovery
+                true); // delayApis
+
+            BackupManager::SPtr backupManager(replica->BackupManager);
+            backupManager->EnableRestore();
+
+            Stopwatch stopwatch;
+            stopwatch.Start();
+
+            co_await backupManager->RestoreAsync(backupFolder);
+
+            stopwatch.Stop();
+            TraceThroughput(L"RestoreAsync", logSize, logRecordCount, stopwatch.ElapsedMilliseconds);
+
+            backupManager->DisableRestore();
+
+            co_await backupManager->DisableBackupAndDrainAsync();
+            co_await replica->CloseAndQuiesceReplica();
+            co_await replica->EndTestAsync(false, true);
+        }
+
+        co_return;
+    }
+
+    Awaitable<void> BackupManagerRestorePerfTests::MeasureReadAheadAsync(
+        __in BackupFolderInfo & backupFolderInfo,
+        __in KAllocator & allocator)
+    {
+        RestoreLogRecordsAsyncEnumerator::SPtr logRecords = RestoreLogRecordsAsyncEnumerator::Create(
+            *prId_,
+            backupFolderInfo.LogPathList,
+            64 * 1024 * 1024,
+            allocator);
+
+        Stopwatch stopwatch;
+        stopwatch.Start();
+
+        while (co_await logRecords->MoveNextAsync(CancellationToken::None))
+        {
+        }
+
+        stopwatch.Stop();
+
+        co_await logRecords->CloseAsync();
+
+        TraceThroughput(L"ReadAhead", logRecords->Size, logRecords->Count, stopwatch.ElapsedMilliseconds);
+    }
+
+    void BackupManagerRestorePerfTests::AddOperationToTransaction(
+        __in Transaction & transaction,
+        __in int bufferSize,
+        __in TestStateProviderManager & stateManager)
+    {
+        TestStateProviderManager::SPtr stateManagerPtr = &stateManager;
+        KAllocator & allocator = underlyingSystem_->NonPagedAllocator();
+
+        OperationData::CSPtr data = TestTransaction::GenerateOperationData(1, bufferSize, allocator).RawPtr();
+
+        stateManagerPtr->AddExpectedTransactionApplyData(
+            transaction.TransactionId,
+            data,
+            data);
+
+        TestTransaction::TestOperationContext::CSPtr context = TestTransaction::TestOperationContext::Create(allocator);
+        LONG64 stateProviderId = KDateTime::Now();
+
+        transaction.AddOperation(
+            data.RawPtr(),
+            data.RawPtr(),
+            data.RawPtr(),
+            stateProviderId,
+            context.RawPtr());
+    }
+
+    void BackupManagerRestorePerfTests::TraceThroughput(
+        __in std::wstring const & step,
+        __in ULONG64 bytes,
+        __in ULONG64 records,
+        __in int64 elapsedMilliseconds)
+    {
+        double seconds = (elapsedMilliseconds > 0 ? elapsedMilliseconds : 1) / 1000.0;
+
+        Trace.WriteInfo(
+            TraceComponent,
+            "{0}: {1}: {2} records, {3} bytes in {4} ms. {5} MB/s, {6} records/s",
+            prId_->TraceId,
+            step,
+            records,
+            bytes,
+            elapsedMilliseconds,
+            (bytes / (1024.0 * 1024.0)) / seconds,
+            records / seconds);
+    }
+
+    wstring BackupManagerRestorePerfTests::CreateFileName(
+        __in wstring const & folderName)
+    {
+        wstring testFolderPath = Directory::GetCurrentDirectoryW();
+        Path::CombineInPlace(testFolderPath, folderName);
+
+        return testFolderPath;
+    }
+
+    void BackupManagerRestorePerfTests::EndTest()
+    {
+        prId_.Reset();
+    }
+
+    BOOST_FIXTURE_TEST_SUITE(BackupManagerRestorePerfTestSuite, BackupManagerRestorePerfTests);
+
+    BOOST_AUTO_TEST_CASE(Restore_SmallRecords_Performance)
+    {
+        // Setup
+        wstring testName(L"Restore_SmallRecords_Performance");
+        wstring testFolderPath = CreateFileName(testName);
+
+        // Pre-clean up
+        Directory::Delete_WithRetry(testFolderPath, true, true);
+
+        TEST_TRACE_BEGIN(testName)
+        {
+            KString::SPtr folderPath = KPath::CreatePath(testFolderPath.c_str(), allocator);
+            SyncAwait(Test_Restore_Performance(*folderPath, 4096, 64, r, seed));
+        }
+
+        // Post clean up
+        Directory::Delete_WithRetry(testFolderPath, true, true);
+    }
+
+    BOOST_AUTO_TEST_CASE(Restore_LargeRecords_Performance)
+    {
+        // Setup
+        wstring testName(L"Restore_LargeRecords_Performance");
+        wstring testFolderPath = CreateFileName(testName);
+
+        // Pre-clean up
+        Directory::Delete_WithRetry(testFolderPath, true, true);
+
+        TEST_TRACE_BEGIN(testName)
+        {
+            KString::SPtr folderPath = KPath::CreatePath(testFolderPath.c_str(), allocator);
+            SyncAwait(Test_Restore_Performance(*folderPath, 512, 16 * 1024, r, seed));
+        }
+
+        // Post clean up
+        Directory::Delete_WithRetry(testFolderPath, true, true);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END();
+}
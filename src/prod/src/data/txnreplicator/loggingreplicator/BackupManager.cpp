@@ -232,28 +232,26 @@ ktl::Awaitable<TxnReplicator::BackupInfo> BackupManager::BackupAsync(
         replicateBackupLogRecordDuration);
 
     // Step 2: Backup SM if Full. Get log records and backup.
-    IAsyncEnumerator<LogRecord::SPtr>::SPtr logRecords = nullptr;
+    ReplicatorBackup replicatorBackupInfo = ReplicatorBackup::Invalid();
     if (backupOption == FABRIC_BACKUP_OPTION_FULL)
     {
         // This call will be drained in case of change role or close.
-        logRecords = co_await BackupStateManagerAndGetReplicatorLogsToBeBackedUpAsync(
+        // The state manager checkpoint and the log records are backed up concurrently.
+        replicatorBackupInfo = co_await BackupStateManagerAndReplicatorAsync(
             backupId,
             *smBackupFolderCSPtr_,
+            *replicatorLogBackupFilePathCSPtr_,
             timeout,
-            cancellationToken);
-
-        stateManagerBackupDuration = backupStopwatch.ElapsedMilliseconds - lastStepElapsedTime;
+            cancellationToken,
+            stateManagerBackupDuration);
     }
     else
     {
-        logRecords = co_await GetIncrementalLogRecordsAsync(
+        IAsyncEnumerator<LogRecord::SPtr>::SPtr logRecords = co_await GetIncrementalLogRecordsAsync(
             backupId,
             timeout,
             cancellationToken);
-    }
 
-    ReplicatorBackup replicatorBackupInfo = ReplicatorBackup::Invalid();
-    {
         KFinally([&] {logRecords->Dispose(); });
 
         replicatorBackupInfo = co_await BackupReplicatorAsync(backupId, backupOption, *replicatorLogBackupFilePathCSPtr_, *logRecords, cancellationToken);
@@ -491,36 +489,56 @@ ktl::Awaitable<void> BackupManager::RestoreAsync(
         becomePrimaryDuration);
 
     // Step 2: StateManager Restore
-    status = co_await stateManagerSPtr_->RestoreCheckpointAsync(*backupFolderInfoSPtr->StateManagerBackupFolderPath, cancellationToken);
-    THROW_ON_FAILURE(status);
+    // The backup logs are read ahead while the state manager checkpoint is restored and consumed when the log is restored in step 3.
+    backupFolderInfoSPtr->StartReadingLogRecords(transactionalReplicatorConfig_->RestoreReadAheadSizeInKb * 1024);
+    RestoreLogRecordsAsyncEnumerator::SPtr restoreLogRecords = backupFolderInfoSPtr->LogRecords;
 
-    // Update step 2 time duration and trace.
-    stateManagerRestoreDuration = stopwatch.ElapsedMilliseconds - lastStepElapsedTime;
-    lastStepElapsedTime = stopwatch.ElapsedMilliseconds;
-    EventSource::Events->IBM_RestoreAsync(
-        TracePartitionId,
-        ReplicaId,
-        restoreId,
-        argValidateDuration,
-        stateManagerRestoreDuration,
-        replicatorRestoreDuration,
-        becomePrimaryDuration);
+    Epoch dataLossEpoch = Epoch::InvalidEpoch();
+    SharedException::CSPtr exceptionSPtr = nullptr;
+    try
+    {
+        status = co_await stateManagerSPtr_->RestoreCheckpointAsync(*backupFolderInfoSPtr->StateManagerBackupFolderPath, cancellationToken);
+        THROW_ON_FAILURE(status);
 
-    Epoch dataLossEpoch = replicatedLogManagerSPtr_->CurrentLogTailEpoch;
+        // Update step 2 time duration and trace.
+        stateManagerRestoreDuration = stopwatch.ElapsedMilliseconds - lastStepElapsedTime;
+        lastStepElapsedTime = stopwatch.ElapsedMilliseconds;
+        EventSource::Events->IBM_RestoreAsync(
+            TracePartitionId,
+            ReplicaId,
+            restoreId,
+            argValidateDuration,
+            stateManagerRestoreDuration,
+            replicatorRestoreDuration,
+            becomePrimaryDuration);
 
-    // Step 3: Replicator Restore
-    // Close the replicator, delete log.
-    status = co_await loggingReplicator->CloseAsync();
-    THROW_ON_FAILURE(status);
+        dataLossEpoch = replicatedLogManagerSPtr_->CurrentLogTailEpoch;
 
-    ASSERT_IFNOT(isLogUnavailableDueToRestore_ == false, "{0}: isLogUnavailableDueToRestore is excepted to be false", TraceId);
-    isLogUnavailableDueToRestore_ = true;
+        // Step 3: Replicator Restore
+        // Close the replicator, delete log.
+        status = co_await loggingReplicator->CloseAsync();
+        THROW_ON_FAILURE(status);
 
-    status = co_await loggingReplicator->PrepareForRestoreAsync();
-    THROW_ON_FAILURE(status);
+        ASSERT_IFNOT(isLogUnavailableDueToRestore_ == false, "{0}: isLogUnavailableDueToRestore is excepted to be false", TraceId);
+        isLogUnavailableDueToRestore_ = true;
 
-    status = co_await RecoverRestoreDataAsync(*loggingReplicator, restoreId, *backupFolderInfoSPtr);
-    THROW_ON_FAILURE(status);
+        status = co_await loggingReplicator->PrepareForRestoreAsync();
+        THROW_ON_FAILURE(status);
+
+        status = co_await RecoverRestoreDataAsync(*loggingReplicator, restoreId, *backupFolderInfoSPtr);
+        THROW_ON_FAILURE(status);
+    }
+    catch (Exception & exception)
+    {
+        exceptionSPtr = SharedException::Create(exception, GetThisAllocator());
+    }
+
+    co_await restoreLogRecords->CloseAsync();
+
+    if (exceptionSPtr != nullptr)
+    {
+        throw exceptionSPtr->get_Info();
+    }
 
     // Port Note: Finish restore before changing role.
     status = co_await FinishRestoreAsync(*loggingReplicator, dataLossEpoch);
@@ -902,17 +920,26 @@ ktl::Awaitable<void> BackupManager::PrepareBackupFolderAsync(
     }
 }
 
-ktl::Awaitable<IAsyncEnumerator<LogRecord::SPtr>::SPtr> BackupManager::BackupStateManagerAndGetReplicatorLogsToBeBackedUpAsync(
+// Backs up the state manager checkpoint and the log records of a full backup.
+// Algorithm:
+// 1. Acquire the backup and copy consistency lock, so the last completed checkpoint cannot change.
+// 2. Find the indexing log record to start from and snap the log records up to the current tail.
+//    The tail is past the last completed checkpoint, so the log records cover the checkpoint being backed up.
+// 3. Start the state manager backup and write the backup log while it runs.
+// 4. Wait for both before releasing the locks.
+ktl::Awaitable<ReplicatorBackup> BackupManager::BackupStateManagerAndReplicatorAsync(
     __in Common::Guid backupId,
     __in KString const & stateManagerBackupFolderPath,
+    __in KString const & replicatorBackupFolder,
     __in Common::TimeSpan const & timeout,
-    __in CancellationToken const & cancellationToken)
+    __in CancellationToken const & cancellationToken,
+    __out int64 & stateManagerBackupDuration)
 {
     KShared$ApiEntry();
 
     NTSTATUS status = STATUS_UNSUCCESSFUL;
 
-    IAsyncEnumerator<LogRecord::SPtr>::SPtr logRecords = nullptr;
+    ReplicatorBackup replicatorBackup = ReplicatorBackup::Invalid();
 
     KString::SPtr lockTakerName = nullptr;
     status = KString::Create(lockTakerName, GetThisAllocator(), backupId.ToString().c_str());
@@ -970,17 +997,84 @@ ktl::Awaitable<IAsyncEnumerator<LogRecord::SPtr>::SPtr> BackupManager::BackupSta
             throw ktl::Exception(status);
         }
         
+        IAsyncEnumerator<LogRecord::SPtr>::SPtr logRecords = nullptr;
+        try
+        {
+            logRecords = GetLogRecordsCallerHoldsLock(*indexinLogRecord, *lockTakerName);
+        }
+        catch (Exception &)
+        {
+            checkpointManagerSPtr->ReleaseStateManagerApiLock(*lockTakerName);
+            throw;
+        }
+
+        KFinally([&] {logRecords->Dispose(); });
+
+        // Releases the state manager api lock once the state manager backup completes.
+        Awaitable<NTSTATUS> stateManagerBackupAwaitable = BackupStateManagerCallerHoldsLockAsync(
+            *checkpointManagerSPtr,
+            *lockTakerName,
+            stateManagerBackupFolderPath,
+            cancellationToken,
+            stateManagerBackupDuration);
+
+        SharedException::CSPtr exceptionSPtr = nullptr;
+        try
+        {
+            replicatorBackup = co_await WriteReplicatorBackupCallerHoldsDrainablePhaseAsync(
+                FABRIC_BACKUP_OPTION_FULL,
+                replicatorBackupFolder,
+                *logRecords,
+                cancellationToken);
+        }
+        catch (Exception & exception)
         {
-            KFinally([&] {checkpointManagerSPtr->ReleaseStateManagerApiLock(*lockTakerName); });
+            exceptionSPtr = SharedException::Create(exception, GetThisAllocator());
+        }
+
+        // The state manager backup must complete even if writing the log failed, since it holds the locks.
+        status = co_await stateManagerBackupAwaitable;
 
-            status = co_await stateManagerSPtr_->BackupCheckpointAsync(stateManagerBackupFolderPath, cancellationToken);
-            THROW_ON_FAILURE(status);
+        if (exceptionSPtr != nullptr)
+        {
+            throw exceptionSPtr->get_Info();
         }
 
-        logRecords = GetLogRecordsCallerHoldsLock(*indexinLogRecord, *lockTakerName);
+        THROW_ON_FAILURE(status);
     }
 
-    co_return logRecords;
+    co_return replicatorBackup;
+}
+
+ktl::Awaitable<NTSTATUS> BackupManager::BackupStateManagerCallerHoldsLockAsync(
+    __in ICheckpointManager & checkpointManager,
+    __in KString const & lockTakerName,
+    __in KString const & stateManagerBackupFolderPath,
+    __in CancellationToken const & cancellationToken,
+    __out int64 & stateManagerBackupDuration) noexcept
+{
+    KShared$ApiEntry();
+
+    ICheckpointManager::SPtr checkpointManagerSPtr(&checkpointManager);
+    KString::CSPtr lockTakerNameCSPtr(&lockTakerName);
+    KFinally([&] {checkpointManagerSPtr->ReleaseStateManagerApiLock(*lockTakerNameCSPtr); });
+
+    Stopwatch stopwatch;
+    stopwatch.Start();
+
+    NTSTATUS status = STATUS_UNSUCCESSFUL;
+    try
+    {
+        status = co_await stateManagerSPtr_->BackupCheckpointAsync(stateManagerBackupFolderPath, cancellationToken);
+    }
+    catch (Exception & exception)
+    {
+        status = exception.GetStatus();
+    }
+
+    stateManagerBackupDuration = stopwatch.ElapsedMilliseconds;
+
+    co_return status;
 }
 
 /// <summary>
@@ -1227,13 +1321,6 @@ ktl::Awaitable<ReplicatorBackup> BackupManager::BackupReplicatorAsync(
     KShared$ApiEntry();
 
     NTSTATUS status = STATUS_UNSUCCESSFUL;
-    
-    KWString backupLogFilePath(GetThisAllocator(), replicatorBackupFolder.ToUNICODE_STRING());
-
-    BackupLogFile::SPtr backupLogFileSPtr = BackupLogFile::Create(*PartitionedReplicaIdentifier, backupLogFilePath, GetThisAllocator());
-    Stopwatch stopWatch;
-
-    BackupLogRecord::CSPtr lastCompletedBackupLogRecord = lastCompletedBackupLogRecordThreadSafeCache_.Get();
 
     status = StartDrainableBackupPhase();
     if (NT_SUCCESS(status) == false)
@@ -1249,9 +1336,33 @@ ktl::Awaitable<ReplicatorBackup> BackupManager::BackupReplicatorAsync(
         throw ktl::Exception(status);
     }
 
-    {
-        KFinally([&] { CompleteDrainableBackupPhase(); });
+    KFinally([&] { CompleteDrainableBackupPhase(); });
+
+    ReplicatorBackup replicatorBackup = co_await WriteReplicatorBackupCallerHoldsDrainablePhaseAsync(
+        backupOption,
+        replicatorBackupFolder,
+        logRecordsAsyncEnumerator,
+        cancellationToken);
+
+    co_return replicatorBackup;
+}
+
+ktl::Awaitable<ReplicatorBackup> BackupManager::WriteReplicatorBackupCallerHoldsDrainablePhaseAsync(
+    __in FABRIC_BACKUP_OPTION backupOption,
+    __in KString const & replicatorBackupFolder,
+    __in Data::Utilities::IAsyncEnumerator<LogRecord::SPtr> & logRecordsAsyncEnumerator,
+    __in CancellationToken const & cancellationToken)
+{
+    KShared$ApiEntry();
+
+    KWString backupLogFilePath(GetThisAllocator(), replicatorBackupFolder.ToUNICODE_STRING());
+
+    BackupLogFile::SPtr backupLogFileSPtr = BackupLogFile::Create(*PartitionedReplicaIdentifier, backupLogFilePath, GetThisAllocator());
+    backupLogFileSPtr->SetCompressionCodec(static_cast<CompressionCodecId::Enum>(transactionalReplicatorConfig_->BackupCompressionCodec));
 
+    BackupLogRecord::CSPtr lastCompletedBackupLogRecord = lastCompletedBackupLogRecordThreadSafeCache_.Get();
+
+    {
         // Port Note: Difference with managed
         // We do not need to dispose the logRecordsAsyncEnumerator since it is disposed above.
         {
@@ -121,11 +121,20 @@ namespace Data
                 __in FABRIC_BACKUP_OPTION backupOption,
                 __in Common::Guid backupId);
 
-            ktl::Awaitable<Utilities::IAsyncEnumerator<LogRecordLib::LogRecord::SPtr>::SPtr> BackupStateManagerAndGetReplicatorLogsToBeBackedUpAsync(
+            ktl::Awaitable<ReplicatorBackup> BackupStateManagerAndReplicatorAsync(
                 __in Common::Guid backupId,
                 __in KString const & stateManagerBackupFolderPath,
+                __in KString const & replicatorBackupFolder,
                 __in Common::TimeSpan const & timeout,
-                __in ktl::CancellationToken const & cancellationToken);
+                __in ktl::CancellationToken const & cancellationToken,
+                __out int64 & stateManagerBackupDuration);
+
+            ktl::Awaitable<NTSTATUS> BackupStateManagerCallerHoldsLockAsync(
+                __in ICheckpointManager & checkpointManager,
+                __in KString const & lockTakerName,
+                __in KString const & stateManagerBackupFolderPath,
+                __in ktl::CancellationToken const & cancellationToken,
+                __out int64 & stateManagerBackupDuration) noexcept;
 
             ktl::Awaitable<Utilities::IAsyncEnumerator<LogRecordLib::LogRecord::SPtr>::SPtr> GetIncrementalLogRecordsAsync(
                 __in Common::Guid backupId,
@@ -146,6 +155,12 @@ namespace Data
                 __in Utilities::IAsyncEnumerator<LogRecordLib::LogRecord::SPtr> & logRecordsAsyncEnumerator,
                 __in ktl::CancellationToken const & cancellationToken);
 
+            ktl::Awaitable<ReplicatorBackup> WriteReplicatorBackupCallerHoldsDrainablePhaseAsync(
+                __in FABRIC_BACKUP_OPTION backupOption,
+                __in KString const & replicatorBackupFolder,
+                __in Utilities::IAsyncEnumerator<LogRecordLib::LogRecord::SPtr> & logRecordsAsyncEnumerator,
+                __in ktl::CancellationToken const & cancellationToken);
+
             LogRecordLib::LogRecord::CSPtr FindFirstLogRecordForIncrementalBackup(
                 __in FABRIC_SEQUENCE_NUMBER highestBackedUpLSN,
                 __in Common::Guid const & backupId);
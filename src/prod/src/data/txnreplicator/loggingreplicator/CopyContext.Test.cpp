@@ -71,6 +71,7 @@ namespace LoggingReplicatorTests
                 *expectedLogHeadRecord, 
                 expectedLogTailLsn, 
                 expectedLatestRecoveredAtomicRedoOperationLsn, 
+                ReplicationCompressor::GetSupportedCodecs(),
                 allocator);
 
             OperationData::CSPtr operationData;
@@ -81,6 +82,7 @@ namespace LoggingReplicatorTests
             LONG64 replicaId;
             LONG64 logTailLsn;
             LONG64 latestRecoveredAtomicRedoOperationLsn;
+            ULONG32 supportedCompressionCodecs;
             LONG64 epochDataLossNumber;
             LONG64 epochConfigurationNumber;
             ProgressVector::SPtr progressVector = ProgressVector::Create(allocator);
@@ -94,6 +96,7 @@ namespace LoggingReplicatorTests
             br.Read(logHeadRecordLsn);
             br.Read(logTailLsn);
             br.Read(latestRecoveredAtomicRedoOperationLsn);
+            br.Read(supportedCompressionCodecs);
 
             VERIFY_ARE_EQUAL(expectedReplicaId, replicaId);
 
@@ -108,6 +111,8 @@ namespace LoggingReplicatorTests
             VERIFY_ARE_EQUAL(expectedLogHeadRecord->Lsn, logHeadRecordLsn);
             VERIFY_ARE_EQUAL(expectedLogTailLsn, logTailLsn);
             VERIFY_ARE_EQUAL(expectedLatestRecoveredAtomicRedoOperationLsn, latestRecoveredAtomicRedoOperationLsn);
+            VERIFY_ARE_EQUAL(ReplicationCompressor::GetSupportedCodecs(), supportedCompressionCodecs);
+            VERIFY_ARE_EQUAL(buffer->QuerySize(), br.Position);
         }
     }
 
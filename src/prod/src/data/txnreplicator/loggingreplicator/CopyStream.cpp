@@ -48,6 +48,7 @@ CopyStream::CopyStream(
     , targetReplicaId_(0)
     , targetStartingLsn_(Constants::InvalidLsn)
     , uptoLsn_(uptoLsn)
+    , copyCompressionCodec_(CompressionCodecId::None)
     , bw_(allocator)
     , hasPersistedState_(hasPersistedState)
 #ifdef DBG
@@ -196,6 +197,20 @@ Awaitable<NTSTATUS> CopyStream::GetNextAsyncSafe(
             br.Read(targetLogHeadLsn_);
             br.Read(currentTargetLsn_);
             br.Read(latestRecoveredAtomicRedoOperationLsn_);
+
+            // Secondaries running an older version do not advertise any codecs
+            ULONG32 targetSupportedCompressionCodecs = 0;
+            if (br.Position < buffer->QuerySize())
+            {
+                br.Read(targetSupportedCompressionCodecs);
+            }
+
+            ReplicationCompressor::SPtr compressor = replicatedLogManager_->Compressor;
+            if (compressor != nullptr)
+            {
+                compressor->OnCopyContextReceived(targetReplicaId_, targetSupportedCompressionCodecs);
+                copyCompressionCodec_ = compressor->GetCopyCodec(targetSupportedCompressionCodecs);
+            }
         }
         else
         {
@@ -314,6 +329,12 @@ Awaitable<NTSTATUS> CopyStream::GetNextAsyncSafe(
             OperationData::SPtr dataCast = const_cast<OperationData *>(data.RawPtr());
             dataCast->Append(*copyStageBuffers_->CopyStateOperation);
 
+            if (copyCompressionCodec_ != CompressionCodecId::None)
+            {
+                data = replicatedLogManager_->Compressor->CompressCopyData(*dataCast, copyCompressionCodec_, 1);
+                dataCast = const_cast<OperationData *>(data.RawPtr());
+            }
+
             EventSource::Events->CopyStreamGetNextState(
                 TracePartitionId,
                 ReplicaId,
@@ -477,6 +498,12 @@ Awaitable<NTSTATUS> CopyStream::GetNextAsyncSafe(
         // data will not be nullptr as records.Count() is > 0
         copyData->Append(*copyStageBuffers_->CopyLogOperation);
 
+        if (copyCompressionCodec_ != CompressionCodecId::None)
+        {
+            OperationData::CSPtr compressedData = replicatedLogManager_->Compressor->CompressCopyData(*copyData, copyCompressionCodec_, 1);
+            copyData = const_cast<OperationData *>(compressedData.RawPtr());
+        }
+
         logPreparationWatch.Stop();
 
         EventSource::Events->CopyStreamGetNextLogRecord(
@@ -511,9 +538,20 @@ OperationData::CSPtr CopyStream::GetCopyMetadata(__in CopyStage::Enum copyStageT
 {
     BinaryWriter bw(GetThisAllocator());
 
-    bw.Write(copyMetadataVersion_);
-    bw.Write(static_cast<int>(copyStageToWrite));
-    bw.Write(replicaId_);
+    // The header stays at version 1 unless compression was negotiated, since only newer secondaries advertise codecs
+    if (copyCompressionCodec_ == CompressionCodecId::None)
+    {
+        bw.Write(copyMetadataVersion_);
+        bw.Write(static_cast<int>(copyStageToWrite));
+        bw.Write(replicaId_);
+    }
+    else
+    {
+        bw.Write(CopyHeader::CompressionCodecVersion);
+        bw.Write(static_cast<int>(copyStageToWrite));
+        bw.Write(replicaId_);
+        bw.Write(static_cast<ULONG32>(copyCompressionCodec_));
+    }
 
     KArray<KBuffer::CSPtr> buffers(GetThisAllocator());
     THROW_ON_CONSTRUCTOR_FAILURE(buffers);
@@ -114,6 +114,10 @@ namespace Data
             LONG64 targetStartingLsn_;
             
             LONG64 uptoLsn_;
+
+            // Codec negotiated with the target, written to the copy header. State and log copy operations are compressed with it.
+            Utilities::CompressionCodecId::Enum copyCompressionCodec_;
+
             Utilities::BinaryWriter bw_;
 
 #ifdef DBG
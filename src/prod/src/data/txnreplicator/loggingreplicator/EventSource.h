@@ -125,6 +125,7 @@ namespace Data
             DECLARE_LR_STRUCTURED_TRACE(FlushEndWarning, Common::Guid, LONG64, ULONG32, ULONG32, LONG64, LONG64, double, double, LONG64);
             DECLARE_LR_STRUCTURED_TRACE(PendingFlushWarning, Common::Guid, LONG64, LONG64, LONG64);
             DECLARE_LR_STRUCTURED_TRACE(FlushInvoke, Common::Guid, LONG64, Common::WStringLiteral);
+            DECLARE_LR_STRUCTURED_TRACE(FlushHistogram, Common::Guid, LONG64, LONG64, LONG64, LONG64, std::wstring, std::wstring);
 
             // FileLogManager
             DECLARE_LR_STRUCTURED_TRACE(FileLogManagerDeleteLogFailed, Common::Guid, LONG64, Common::ErrorCode, Common::WStringLiteral);
@@ -332,6 +333,7 @@ namespace Data
                 LR_STRUCTURED_TRACE(FlushEndWarning, 114, Info, "{1}: Flush Ended. Bytes: {2} LSR: {3} FlushTime(ms): {4} SerializationTime(ms): {5} Avg. Byte/sec: {6} Avg. Latency Milliseconds: {7}. WritePosition: {8}", "id","replicaid", "numberofbytes", "latencysensitiverecords", "flushms", "serializationms", "avg bytes/sec", "avg latency ms", "pos"),
                 LR_STRUCTURED_TRACE(PendingFlushWarning, 115, Warning, "{1}: Pending Flush Size {2} greater than MaxWriteCacheSize {3}. Throttling writes", "id", "replicaid", "pendingflushbytes", "maxwritecachesizeinbytes"),
                 LR_STRUCTURED_TRACE(FlushInvoke, 116, Noise, "{1}:{2} invoking flush", "id", "replicaid", "initiator"),
+                LR_STRUCTURED_TRACE(FlushHistogram, 117, Info, "{1}: Flushes: {2} BatchBudget: {3} Avg. Latency Microseconds: {4}\r\nSize: {5}\r\nLatency: {6}", "id", "replicaid", "flushcount", "batchbudget", "avglatencyus", "sizehistogram", "latencyhistogram"),
 
                 // FileLogManager
                 LR_STRUCTURED_TRACE(FileLogManagerDeleteLogFailed, 121, Warning, "{1}: CreateCopyLog: Delete logical log failed with EC: {2} for file {3}", "id", "replicaid", "errorcode", "filename"),
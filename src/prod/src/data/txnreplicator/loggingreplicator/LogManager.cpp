@@ -342,7 +342,7 @@ Awaitable<NTSTATUS> LogManager::OpenAsync(__out RecoveryPhysicalLogReader::SPtr
 }
 
 Awaitable<NTSTATUS> LogManager::OpenWithRestoreFilesAsync(
-    __in KArray<KString::CSPtr> const & restoreFileArray,
+    __in IAsyncEnumerator<LogRecord::SPtr> & restoreLogRecords,
     __in LONG64 blockSizeInKB,
     __in Data::LogRecordLib::InvalidLogRecords & invalidLogRecords,
     __in ktl::CancellationToken const & cancellationToken,
@@ -390,115 +390,65 @@ Awaitable<NTSTATUS> LogManager::OpenWithRestoreFilesAsync(
 
     KFinally([&] {logWriter->Dispose(); });
 
-    LogRecordsMap::SPtr logRecordsMapSPtr = nullptr;
     LONG64 bufferedRecordsSizeBytes = 0;
     LONG64 backupRecordIndex = 0;
 
-    for (KString::CSPtr logFilePath : restoreFileArray)
+    try
     {
-        BackupLogFileAsyncEnumerator::SPtr enumeratorSPtr = nullptr;
-        try
-        {
-            KWString backupLogFilePath(GetThisAllocator(), *logFilePath);
-
-            CO_RETURN_ON_FAILURE(backupLogFilePath.Status());
-
-            BackupLogFile::SPtr backupLogFileSPtr = BackupLogFile::Create(
-                *PartitionedReplicaIdentifier,
-                backupLogFilePath,
-                GetThisAllocator());
-
-            co_await backupLogFileSPtr->ReadAsync(cancellationToken);
-            enumeratorSPtr = backupLogFileSPtr->GetAsyncEnumerator();
-        }
-        catch (Exception const & exception)
-        {
-            ASSERT_IFNOT(enumeratorSPtr == nullptr, "{0}. Enumerator must be null if above threw.", TraceId);
-            co_return exception.GetStatus();
-        }
-
-        try
-        {
-            // If this is the first record in the full backup log.
-            if (logRecordsMapSPtr == nullptr)
-            {
-                bool hasFirstRecord = co_await enumeratorSPtr->MoveNextAsync(cancellationToken);
-                ASSERT_IFNOT(hasFirstRecord, "{0}. Full backup log empty.", TraceId);
-
-                // If the log is being restored.
-                // First record must be a indexing log record. Flush it.
-                LogRecord::SPtr firstRecordFromBackupLog = enumeratorSPtr->GetCurrent();
-                ASSERT_IFNOT(firstRecordFromBackupLog != nullptr, "{0}. BackupLogEnumerator will never return null", TraceId);
-                ASSERT_IFNOT(
-                    LogRecord::IsInvalid(firstRecordFromBackupLog.RawPtr()) == false,
-                    "{0}. First record read from the backup log cannot be invalid.",
-                    TraceId);
-                ASSERT_IFNOT(
-                    firstRecordFromBackupLog->RecordType == LogRecordType::Indexing,
-                    "{0}. First record read from the backup log must be indexing log record: Type: {1} LSN: {2} PSN: {3}",
-                    TraceId,
-                    firstRecordFromBackupLog->RecordType,
-                    firstRecordFromBackupLog->Lsn,
-                    firstRecordFromBackupLog->Psn);
-
-                bufferedRecordsSizeBytes = logWriter->InsertBufferedRecord(*firstRecordFromBackupLog);
-                backupRecordIndex++;
-
-                // Note that indexingLogRecord->PreviousPhysicalRecord is an InvalidLogRecord.
-                IndexingLogRecord::SPtr logHeadIndexingRecord = dynamic_cast<IndexingLogRecord *>(firstRecordFromBackupLog.RawPtr());
-
-                // Used for linking the transactions.
-                logRecordsMapSPtr = LogRecordsMap::Create(*PartitionedReplicaIdentifier, *logHeadIndexingRecord, invalidLogRecords, GetThisAllocator());
-
-                logRecordsMapSPtr->ProcessLogRecord(*firstRecordFromBackupLog);
-
-                EventSource::Events->RestoreRecord(
-                    TracePartitionId,
-                    ReplicaId,
-                    static_cast<LONG64>(firstRecordFromBackupLog->RecordType),
-                    firstRecordFromBackupLog->Lsn,
-                    firstRecordFromBackupLog->Psn,
-                    LONG64_MAX);
-            }
+        // The first record of the backup chain is the first record of the full backup log.
+        bool hasFirstRecord = co_await restoreLogRecords.MoveNextAsync(cancellationToken);
+        ASSERT_IFNOT(hasFirstRecord, "{0}. Full backup log empty.", TraceId);
+
+        // If the log is being restored.
+        // First record must be a indexing log record. Flush it.
+        LogRecord::SPtr firstRecordFromBackupLog = restoreLogRecords.GetCurrent();
+        ASSERT_IFNOT(firstRecordFromBackupLog != nullptr, "{0}. BackupLogEnumerator will never return null", TraceId);
+        ASSERT_IFNOT(
+            LogRecord::IsInvalid(firstRecordFromBackupLog.RawPtr()) == false,
+            "{0}. First record read from the backup log cannot be invalid.",
+            TraceId);
+        ASSERT_IFNOT(
+            firstRecordFromBackupLog->RecordType == LogRecordType::Indexing,
+            "{0}. First record read from the backup log must be indexing log record: Type: {1} LSN: {2} PSN: {3}",
+            TraceId,
+            firstRecordFromBackupLog->RecordType,
+            firstRecordFromBackupLog->Lsn,
+            firstRecordFromBackupLog->Psn);
 
-            // Process remaining records in the backup log.
-            LogRecord::SPtr logRecordSPtr = nullptr;
-            while (co_await enumeratorSPtr->MoveNextAsync(cancellationToken))
-            {
-                logRecordSPtr = enumeratorSPtr->GetCurrent();
-                logRecordsMapSPtr->ProcessLogRecord(*logRecordSPtr);
+        bufferedRecordsSizeBytes = logWriter->InsertBufferedRecord(*firstRecordFromBackupLog);
+        backupRecordIndex++;
 
-                // Insert the record
-                bufferedRecordsSizeBytes += logWriter->InsertBufferedRecord(*logRecordSPtr);
-                backupRecordIndex++;
+        // Note that indexingLogRecord->PreviousPhysicalRecord is an InvalidLogRecord.
+        IndexingLogRecord::SPtr logHeadIndexingRecord = dynamic_cast<IndexingLogRecord *>(firstRecordFromBackupLog.RawPtr());
 
-                // TODO: Use a backup config for this flush size determination
-                if (bufferedRecordsSizeBytes >= blockSizeInBytes)
-                {
-                    co_await logWriter->FlushAsync(L"Intermediate restore flush for file");
+        // Used for linking the transactions.
+        LogRecordsMap::SPtr logRecordsMapSPtr = LogRecordsMap::Create(*PartitionedReplicaIdentifier, *logHeadIndexingRecord, invalidLogRecords, GetThisAllocator());
 
-                    // This additional await is required to ensure the log record was indeed flushed.
-                    // Without this, the flushasync could succeed, but the log record flush could have failed due to a write error
-                    status = co_await logRecordSPtr->AwaitFlush();
+        logRecordsMapSPtr->ProcessLogRecord(*firstRecordFromBackupLog);
 
-                    CO_RETURN_ON_FAILURE(status);
+        EventSource::Events->RestoreRecord(
+            TracePartitionId,
+            ReplicaId,
+            static_cast<LONG64>(firstRecordFromBackupLog->RecordType),
+            firstRecordFromBackupLog->Lsn,
+            firstRecordFromBackupLog->Psn,
+            LONG64_MAX);
 
-                    bufferedRecordsSizeBytes = 0;
-                }
+        // Process remaining records in the backup chain.
+        LogRecord::SPtr logRecordSPtr = firstRecordFromBackupLog;
+        while (co_await restoreLogRecords.MoveNextAsync(cancellationToken))
+        {
+            logRecordSPtr = restoreLogRecords.GetCurrent();
+            logRecordsMapSPtr->ProcessLogRecord(*logRecordSPtr);
 
-                EventSource::Events->RestoreRecord(
-                    TracePartitionId,
-                    ReplicaId,
-                    static_cast<LONG64>(logRecordSPtr->RecordType),
-                    logRecordSPtr->Lsn,
-                    logRecordSPtr->Psn,
-                    logRecordSPtr->PreviousPhysicalRecord->Psn);
-            }
+            // Insert the record
+            bufferedRecordsSizeBytes += logWriter->InsertBufferedRecord(*logRecordSPtr);
+            backupRecordIndex++;
 
-            // Flush any remaining buffers.
-            if (bufferedRecordsSizeBytes > 0)
+            // TODO: Use a backup config for this flush size determination
+            if (bufferedRecordsSizeBytes >= blockSizeInBytes)
             {
-                co_await logWriter->FlushAsync(L"Final restore flush for file");
+                co_await logWriter->FlushAsync(L"Intermediate restore flush");
 
                 // This additional await is required to ensure the log record was indeed flushed.
                 // Without this, the flushasync could succeed, but the log record flush could have failed due to a write error
@@ -508,22 +458,33 @@ Awaitable<NTSTATUS> LogManager::OpenWithRestoreFilesAsync(
 
                 bufferedRecordsSizeBytes = 0;
             }
-        }
-        catch (Exception const & exception)
-        {
-            status = exception.GetStatus();
-        }
 
-        try
-        {
-            co_await enumeratorSPtr->CloseAsync();
+            EventSource::Events->RestoreRecord(
+                TracePartitionId,
+                ReplicaId,
+                static_cast<LONG64>(logRecordSPtr->RecordType),
+                logRecordSPtr->Lsn,
+                logRecordSPtr->Psn,
+                logRecordSPtr->PreviousPhysicalRecord->Psn);
         }
-        catch (Exception const & exception)
+
+        // Flush any remaining buffers.
+        if (bufferedRecordsSizeBytes > 0)
         {
-            co_return exception.GetStatus();
-        }
+            co_await logWriter->FlushAsync(L"Final restore flush");
 
-        CO_RETURN_ON_FAILURE(status);
+            // This additional await is required to ensure the log record was indeed flushed.
+            // Without this, the flushasync could succeed, but the log record flush could have failed due to a write error
+            status = co_await logRecordSPtr->AwaitFlush();
+
+            CO_RETURN_ON_FAILURE(status);
+
+            bufferedRecordsSizeBytes = 0;
+        }
+    }
+    catch (Exception const & exception)
+    {
+        co_return exception.GetStatus();
     }
 
     result = RecoveryPhysicalLogReader::Create(*this, GetThisAllocator());
@@ -117,10 +117,10 @@ namespace Data
             virtual ktl::Awaitable<NTSTATUS> OpenAsync(__out KSharedPtr<LogRecordLib::RecoveryPhysicalLogReader> & result);
 
             //
-            // OpenAsync is where the log file is created with the log records from the restoreFileArray.
+            // OpenAsync is where the log file is created with the log records of the restored backup chain.
             //
             virtual ktl::Awaitable<NTSTATUS> OpenWithRestoreFilesAsync(
-                __in KArray<KString::CSPtr> const & restoreFileArray,
+                __in Utilities::IAsyncEnumerator<LogRecordLib::LogRecord::SPtr> & restoreLogRecords,
                 __in LONG64 blockSizeInKB,
                 __in LogRecordLib::InvalidLogRecords & invalidLogRecords,
                 __in ktl::CancellationToken const & cancellationToken,
@@ -52,6 +52,7 @@ LoggingReplicatorImpl::LoggingReplicatorImpl(
     , versionManager_(&versionManager)
     , copyStageBuffers_(CopyStageBuffers::Create(GetThisAllocator()))
     , logFlushCallbackManager_(PhysicalLogWriterCallbackManager::Create(traceId, GetThisAllocator()))
+    , logRecordAllocator_(nullptr)
     , logTruncationManager_(nullptr)
     , checkpointManager_(nullptr)
     , logRecordsDispatcher_(nullptr)
@@ -87,6 +88,9 @@ LoggingReplicatorImpl::LoggingReplicatorImpl(
 
     KAllocator & allocator = GetThisAllocator();
 
+    NTSTATUS status = SlabAllocator::Create(LogRecordSlabBytes, allocator, logRecordAllocator_);
+    THROW_ON_FAILURE(status);
+
     logTruncationManager_ = LogTruncationManager::Create(
         traceId,
         *replicatedLogManager_,
@@ -284,13 +288,48 @@ Awaitable<NTSTATUS> LoggingReplicatorImpl::OpenAsync(
     }
     else
     {
+        // The backup manager starts reading the backup logs while the state manager checkpoint is restored.
+        // Otherwise, start reading them now so reading still overlaps with writing the log.
+        RestoreLogRecordsAsyncEnumerator::SPtr restoreLogRecords = nullptr;
+        bool isRestoreLogRecordsOwner = false;
+
+        BackupFolderInfo const * backupFolderInfo = dynamic_cast<BackupFolderInfo const *>(backupFolderInfoPtr);
+        if (backupFolderInfo != nullptr)
+        {
+            restoreLogRecords = backupFolderInfo->LogRecords;
+        }
+
+        if (restoreLogRecords == nullptr)
+        {
+            try
+            {
+                restoreLogRecords = RestoreLogRecordsAsyncEnumerator::Create(
+                    *PartitionedReplicaIdentifier,
+                    backupFolderInfoPtr->LogPathList,
+                    transactionalReplicatorConfig_->RestoreReadAheadSizeInKb * 1024,
+                    GetThisAllocator());
+            }
+            catch (Exception const & exception)
+            {
+                co_return exception.GetStatus();
+            }
+
+            isRestoreLogRecordsOwner = true;
+        }
+
         // TODO: Add a RestoreBatchSizeInKB into the configuration.
         status = co_await logManager_->OpenWithRestoreFilesAsync(
-            backupFolderInfoPtr->LogPathList, 
+            *restoreLogRecords,
             transactionalReplicatorConfig_->CopyBatchSizeInKb,
             *invalidLogRecords_,
             CancellationToken::None, 
             recoveryReader);
+
+        if (isRestoreLogRecordsOwner)
+        {
+            co_await restoreLogRecords->CloseAsync();
+        }
+
         CO_RETURN_ON_FAILURE(status);
     }
 
@@ -997,6 +1036,13 @@ Awaitable<NTSTATUS> LoggingReplicatorImpl::BecomePrimaryAsync(bool isForRestore)
         "{0}: Cannot transition to primary because remove state is pending",
         TraceId);
 
+    // The replication stream stays uncompressed until the configuration of this primary is known
+    ReplicationCompressor::SPtr compressor = replicatedLogManager_->Compressor;
+    if (compressor != nullptr)
+    {
+        compressor->ResetReplicaSet();
+    }
+
     ASSERT_IFNOT(
         NT_SUCCESS(recoveryManager_->RecoveryError),
         "{0}: Recovery error must be null. It is {1:x}",
@@ -1613,6 +1659,7 @@ Awaitable<NTSTATUS> LoggingReplicatorImpl::UpdateEpochAsync(
         *replicatedLogManager_->CurrentLogHeadRecord,
         replicatedLogManager_->CurrentLogTailLsn,
         recoveryManager_->LastRecoveredAtomicRedoOperationLsn,
+        ReplicationCompressor::GetSupportedCodecs(),
         GetThisAllocator());
     
     result = IOperationDataStream::SPtr(copyContext.RawPtr());
@@ -1852,9 +1899,11 @@ void LoggingReplicatorImpl::CreateAllManagers()
         TracePartitionId,
         ReplicaId);
 
+    // The transaction map, the transaction manager and the secondary drain manager create and read the begin, operation and end
+    // transaction records of every replicated operation, so their allocations are served from the per partition slabs
     TransactionMap::SPtr transactionMap = TransactionMap::Create(
         *PartitionedReplicaIdentifier,
-        GetThisAllocator());
+        *logRecordAllocator_);
 
     checkpointManager_ = CheckpointManager::Create(
         *PartitionedReplicaIdentifier,
@@ -1899,7 +1948,7 @@ void LoggingReplicatorImpl::CreateAllManagers()
         *invalidLogRecords_,
         transactionalReplicatorConfig_,
         perfCounters_,
-        GetThisAllocator());
+        *logRecordAllocator_);
 
     secondaryDrainManager_ = SecondaryDrainManager::Create(
         *PartitionedReplicaIdentifier,
@@ -1915,12 +1964,19 @@ void LoggingReplicatorImpl::CreateAllManagers()
         *recoveryManager_,
         transactionalReplicatorConfig_,
         *invalidLogRecords_,
-        GetThisAllocator());
+        *logRecordAllocator_);
 
     // Update the dependencies of several components.
     ReplicatedLogManager::AppendCheckpointCallback callback(checkpointManager_.RawPtr(), &CheckpointManager::CheckpointIfNecessary);
     replicatedLogManager_->SetCheckpointCallback(callback);
 
+    ReplicationCompressor::SPtr replicationCompressor = ReplicationCompressor::Create(
+        ReplicaId,
+        transactionalReplicatorConfig_,
+        perfCounters_,
+        GetThisAllocator());
+    replicatedLogManager_->SetReplicationCompressor(*replicationCompressor);
+
     logFlushCallbackManager_->FlushCallbackProcessor = *this;
     checkpointManager_->CompletedRecordsProcessor = *this;
     backupManager_->Initialize(*this, *checkpointManager_, *operationProcessor_);
@@ -2022,6 +2078,35 @@ NTSTATUS LoggingReplicatorImpl::RegisterTransactionChangeHandler(
 //      OperationProcessor != nullptr && Cache == nullptr: un-register the handler from operation processor
 // Invariant:
 //      OperationProcessor != nullptr && Cache != nullptr: only put handler to cache if OperationProcessor is nullptr
+void LoggingReplicatorImpl::UpdateReplicaSetConfiguration(
+    __in FABRIC_REPLICA_SET_CONFIGURATION const * currentConfiguration,
+    __in_opt FABRIC_REPLICA_SET_CONFIGURATION const * previousConfiguration) noexcept
+{
+    ReplicationCompressor::SPtr compressor = replicatedLogManager_->Compressor;
+    if (compressor != nullptr)
+    {
+        compressor->UpdateReplicaSetConfiguration(currentConfiguration, previousConfiguration);
+    }
+}
+
+void LoggingReplicatorImpl::OnBuildReplica(__in LONG64 replicaId) noexcept
+{
+    ReplicationCompressor::SPtr compressor = replicatedLogManager_->Compressor;
+    if (compressor != nullptr)
+    {
+        compressor->OnBuildReplica(replicaId);
+    }
+}
+
+void LoggingReplicatorImpl::OnRemoveReplica(__in LONG64 replicaId) noexcept
+{
+    ReplicationCompressor::SPtr compressor = replicatedLogManager_->Compressor;
+    if (compressor != nullptr)
+    {
+        compressor->OnRemoveReplica(replicaId);
+    }
+}
+
 NTSTATUS LoggingReplicatorImpl::UnRegisterTransactionChangeHandler() noexcept
 {
     NTSTATUS status = STATUS_UNSUCCESSFUL;
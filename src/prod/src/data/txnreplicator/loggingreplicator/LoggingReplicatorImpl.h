@@ -281,6 +281,15 @@ namespace Data
 
             NTSTATUS UnRegisterTransactionChangeHandler() noexcept override;
 
+        public: // Replica set notifications
+            void UpdateReplicaSetConfiguration(
+                __in FABRIC_REPLICA_SET_CONFIGURATION const * currentConfiguration,
+                __in_opt FABRIC_REPLICA_SET_CONFIGURATION const * previousConfiguration) noexcept override;
+
+            void OnBuildReplica(__in LONG64 replicaId) noexcept override;
+
+            void OnRemoveReplica(__in LONG64 replicaId) noexcept override;
+
         public: // Test Support
 
             NTSTATUS Test_RequestCheckpointAfterNextTransaction() noexcept override;
@@ -386,6 +395,8 @@ namespace Data
 
             void CreateOperationProcessor();
 
+            static const ULONG64 LogRecordSlabBytes = 16 * 1024 * 1024;
+
             bool hasPersistedState_ = true;
 
             TxnReplicator::IRuntimeFolders::CSPtr runtimeFolders_;
@@ -402,6 +413,11 @@ namespace Data
             TxnReplicator::IInternalVersionManager::SPtr const versionManager_;
             LogRecordLib::CopyStageBuffers::SPtr const copyStageBuffers_;
             PhysicalLogWriterCallbackManager::SPtr const logFlushCallbackManager_;
+
+            // Serves the hot transaction log records of this partition. Blocks are recycled once the last reference to a record is
+            // released, which for most records happens when the log is truncated past them
+            Utilities::SlabAllocator::SPtr logRecordAllocator_;
+
             Data::LoggingReplicator::IStateReplicator::SPtr const iStateReplicator_;
             Reliability::ReplicationComponent::IReplicatorHealthClientSPtr const healthClient_;
 
@@ -295,6 +295,19 @@ Awaitable<NTSTATUS> MemoryLog::AppendAsync(
     co_return STATUS_SUCCESS;
 }
 
+Awaitable<NTSTATUS> MemoryLog::AppendAsync(
+    __in OperationData const & Buffers,
+    __in CancellationToken const & cancellationToken)
+{
+    for (ULONG32 i = 0; i < Buffers.BufferCount; i++)
+    {
+        NTSTATUS status = co_await AppendAsync(*Buffers[i], 0, Buffers[i]->QuerySize(), cancellationToken);
+        CO_RETURN_ON_FAILURE(status);
+    }
+
+    co_return STATUS_SUCCESS;
+}
+
 Awaitable<NTSTATUS> MemoryLog::FlushWithMarkerAsync(__in CancellationToken const &)
 {
     co_return STATUS_SUCCESS;
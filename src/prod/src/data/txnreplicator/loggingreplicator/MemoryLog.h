@@ -101,6 +101,10 @@ namespace Data
                 __in ULONG Count,
                 __in ktl::CancellationToken const & cancellationToken = ktl::CancellationToken::None) override;
 
+            ktl::Awaitable<NTSTATUS> AppendAsync(
+                __in Utilities::OperationData const & Buffers,
+                __in ktl::CancellationToken const & cancellationToken = ktl::CancellationToken::None) override;
+
             ktl::Awaitable<NTSTATUS> FlushWithMarkerAsync(__in ktl::CancellationToken const & cancellationToken = ktl::CancellationToken::None) override;
 
             ktl::Awaitable<NTSTATUS> FlushAsync(__in ktl::CancellationToken const & cancellationToken = ktl::CancellationToken::None) override;
@@ -42,7 +42,8 @@ namespace LoggingReplicatorTests
 
         Awaitable<void> CreatePLWAsync(
             PartitionedReplicaId const & traceId,
-            wstring const & fileName);
+            wstring const & fileName,
+            ULONG flushLatencyTargetInMilliseconds = 0);
 
         Awaitable<void> CreateAndFlushLogHead();
 
@@ -257,7 +258,8 @@ namespace LoggingReplicatorTests
 
     Awaitable<void> PhysicalLogWriterTests::CreatePLWAsync(
         PartitionedReplicaId const & traceId,
-        std::wstring const & fileName)
+        std::wstring const & fileName,
+        ULONG flushLatencyTargetInMilliseconds)
     {
         KAllocator & allocator = underlyingSystem_->NonPagedAllocator();
         NTSTATUS status;
@@ -304,9 +306,12 @@ namespace LoggingReplicatorTests
         TransactionalReplicatorSettingsUPtr tmp;
         TransactionalReplicatorSettings::FromPublicApi(txrSettings, tmp);
 
+        std::shared_ptr<TransactionalReplicatorConfig> globalConfig = make_shared<TransactionalReplicatorConfig>();
+        globalConfig->FlushLatencyTargetInMilliseconds = flushLatencyTargetInMilliseconds;
+
         TxnReplicator::TRInternalSettingsSPtr config = TRInternalSettings::Create(
             move(tmp),
-            make_shared<TransactionalReplicatorConfig>());
+            globalConfig);
 
         TestHealthClientSPtr healthClient = TestHealthClient::Create();
 
@@ -436,6 +441,72 @@ namespace LoggingReplicatorTests
         }
     }
 
+    BOOST_AUTO_TEST_CASE(LogRecords_ReadAheadWindows_AllRecordsReadInOrder)
+    {
+        TEST_TRACE_BEGIN("LogRecords_ReadAheadWindows_AllRecordsReadInOrder")
+        {
+            SyncAwait(this->CreatePLWAsync(*prId_, L"LogRecords_ReadAheadWindows_AllRecordsReadInOrder"));
+            SyncAwait(this->CreateAndFlushLogHead());
+
+            LogRecord::SPtr tailRecord = SyncAwait(CreateLogRecordsAsync(1000, L"LogRecords_ReadAheadWindows_AllRecordsReadInOrder"));
+
+            TRANSACTIONAL_REPLICATOR_SETTINGS txrSettings = { 0 };
+            TransactionalReplicatorSettingsUPtr tmp;
+            TransactionalReplicatorSettings::FromPublicApi(txrSettings, tmp);
+
+            TxnReplicator::TRInternalSettingsSPtr config = TRInternalSettings::Create(
+                move(tmp),
+                make_shared<TransactionalReplicatorConfig>());
+
+            TestHealthClientSPtr healthClient = TestHealthClient::Create();
+
+            // Windows smaller than a record, windows that split records and the default window holding the whole log
+            LONG64 readAheadSizes[] = { 16, 1000, 0 };
+
+            for (LONG64 readAheadSize : readAheadSizes)
+            {
+                ILogicalLogReadStream::SPtr readStream;
+                status = fileLog_->CreateReadStream(readStream, 1);
+                CODING_ERROR_ASSERT(status == STATUS_SUCCESS);
+
+                LogRecords::SPtr records = LogRecords::Create(
+                    *prId_,
+                    *readStream,
+                    *invalidRecords_,
+                    logHead_->RecordPosition,
+                    tailRecord->RecordPosition,
+                    readAheadSize,
+                    healthClient,
+                    config,
+                    allocator);
+
+                LONG64 expectedPsn = logHead_->Psn;
+                ULONG64 expectedRecordPosition = logHead_->RecordPosition;
+
+                while (SyncAwait(records->MoveNextAsync(CancellationToken::None)))
+                {
+                    LogRecord::SPtr record = records->GetCurrent();
+
+                    VERIFY_ARE_EQUAL(record->Psn, expectedPsn);
+                    VERIFY_ARE_EQUAL(record->RecordPosition, expectedRecordPosition);
+
+                    expectedPsn++;
+                    expectedRecordPosition += record->RecordLength + 2 * sizeof(ULONG32);
+                }
+
+                VERIFY_ARE_EQUAL(expectedPsn, tailRecord->Psn + 1);
+
+                records->Dispose();
+
+                status = SyncAwait(readStream->CloseAsync());
+                CODING_ERROR_ASSERT(status == STATUS_SUCCESS);
+            }
+
+            SyncAwait(fileLog_->CloseAsync());
+            WaitForRecordFlushToPSN(tailRecord->Psn);
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(MultiThreaded)
     {
         TEST_TRACE_BEGIN("MultiThreaded")
@@ -466,6 +537,36 @@ namespace LoggingReplicatorTests
         }
     }
 
+    BOOST_AUTO_TEST_CASE(MultiThreaded_FlushLatencyTarget)
+    {
+        TEST_TRACE_BEGIN("MultiThreaded_FlushLatencyTarget")
+        {
+            SyncAwait(this->CreatePLWAsync(*prId_, L"MultiThreaded_FlushLatencyTarget", 10));
+            SyncAwait(this->CreateAndFlushLogHead());
+
+            KArray<Awaitable<LogRecord::SPtr>> tasks(allocator);
+            status = STATUS_SUCCESS;
+
+            for (ULONG i = 0; i < 100; i++)
+            {
+                Awaitable<LogRecord::SPtr> task = CreateLogRecordsAsync(10, L"MultiThreaded_FlushLatencyTarget");
+                status = tasks.Append(Ktl::Move(task));
+                CODING_ERROR_ASSERT(status == STATUS_SUCCESS);
+            }
+
+            for (ULONG i = 0; i < tasks.Count(); i++)
+            {
+                SyncAwait(tasks[i]);
+            }
+
+            auto tailRecord = SyncAwait(CreateLogRecordsAsync(1, L"MultiThreaded_FlushLatencyTargetLast"));
+
+            VERIFY_ARE_EQUAL(writer_->CurrentLogTailRecord->Psn, tailRecord->Psn);
+            SyncAwait(fileLog_->CloseAsync());
+            WaitForRecordFlushToPSN(tailRecord->Psn);
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(SetTailRecord_LogicalRecord)
     {
         TEST_TRACE_BEGIN("SetTailRecord_LogicalRecord")
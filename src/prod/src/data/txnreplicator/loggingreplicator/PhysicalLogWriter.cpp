@@ -72,6 +72,8 @@ PhysicalLogWriter::PhysicalLogWriter(
 
     ASSERT_IFNOT(ioMonitor_ != nullptr, "Failed to initialize health tracker");
 
+    flushScheduler_ = AdaptiveFlushScheduler::Create(GetThisAllocator());
+
     THROW_ON_CONSTRUCTOR_FAILURE(avgRunningLatencyMilliseconds_);
     THROW_ON_CONSTRUCTOR_FAILURE(avgWriteSpeedBytesPerSecond_);
 
@@ -151,6 +153,8 @@ PhysicalLogWriter::PhysicalLogWriter(
 
     ASSERT_IFNOT(ioMonitor_ != nullptr, "Failed to initialize health tracker");
 
+    flushScheduler_ = AdaptiveFlushScheduler::Create(GetThisAllocator());
+
     InitializeMovingAverageKArray();
 
     InitializeCompletedTcs(completedFlushNotificationTcs_, GetThisAllocator());
@@ -581,6 +585,8 @@ Task PhysicalLogWriter::FlushTask(__in AwaitableCompletionSource<void> & initiat
             "{0}:FlushTask | Unexpected logging exception before starting FlushTask",
             TraceId);
 
+        bool isBudgetLimited = co_await PrepareFlushBatchAsync(flushingTasks);
+
         ULONG latencySensitiveRecords = 0;
         ULONG numberOfBytes = 0;
 
@@ -622,18 +628,18 @@ Task PhysicalLogWriter::FlushTask(__in AwaitableCompletionSource<void> & initiat
             for (ULONG j = 0; j < operationData->BufferCount; j++)
             {
                 numberOfBytes += (*operationData)[j]->QuerySize();
+            }
 
-                status = co_await logicalLogStream_->AppendAsync(
-                    *(*operationData)[j],
-                    0,
-                    (*operationData)[j]->QuerySize(),
-                    CancellationToken());
+            // The serialized record references the user's buffers; they are handed to the log as they are and only copied into its write buffer
+            status = co_await logicalLogStream_->AppendAsync(
+                *operationData,
+                CancellationToken());
 
-                if (!NT_SUCCESS(status))
-                {
-                    goto FlushComplete;
-                }
+            if (!NT_SUCCESS(status))
+            {
+                goto FlushComplete;
             }
+
             flushWatch.Stop();
         }
 
@@ -649,6 +655,22 @@ Task PhysicalLogWriter::FlushTask(__in AwaitableCompletionSource<void> & initiat
 
         UpdateWriteStats(flushWatch, numberOfBytes);
 
+        flushScheduler_->OnFlushCompleted(numberOfBytes, flushWatch.ElapsedMicroseconds, isBudgetLimited);
+
+        if (flushScheduler_->ShouldTraceHistograms())
+        {
+            EventSource::Events->FlushHistogram(
+                TracePartitionId,
+                ReplicaId,
+                flushScheduler_->FlushCount,
+                flushScheduler_->BatchSizeBudgetInBytes,
+                flushScheduler_->AverageFlushLatencyInMicroseconds,
+                flushScheduler_->FlushSizeHistogramToString(),
+                flushScheduler_->FlushLatencyHistogramToString());
+
+            flushScheduler_->ResetHistograms();
+        }
+
         currentLogTailPosition_ += numberOfBytes;
         newTail = (*flushingRecords_)[flushingRecords_->Count() - 1];
         currentLogTailRecord_.Put(Ktl::Move(newTail));
@@ -728,6 +750,115 @@ Task PhysicalLogWriter::FlushTask(__in AwaitableCompletionSource<void> & initiat
     co_return;
 }
 
+Awaitable<bool> PhysicalLogWriter::PrepareFlushBatchAsync(__inout KSharedArray<AwaitableCompletionSource<void>::SPtr>::SPtr & flushingTasks)
+{
+    NTSTATUS status = STATUS_SUCCESS;
+
+    // Settings are dynamic, pick up the latest values for every flush
+    flushScheduler_->UpdateSettings(
+        transactionalReplicatorConfig_->FlushLatencyTargetInMilliseconds,
+        transactionalReplicatorConfig_->MaxFlushBatchSizeInKB * 1024,
+        transactionalReplicatorConfig_->MaxFlushCoalescingDelayInMilliseconds);
+
+    if (!flushScheduler_->IsEnabled)
+    {
+        co_return false;
+    }
+
+    LONG64 coalescingDelay = flushScheduler_->GetCoalescingDelayInMilliseconds(pendingFlushRecordsBytes_.load());
+
+    if (coalescingDelay > 0)
+    {
+        status = co_await KTimer::StartTimerAsync(
+            GetThisAllocator(),
+            PHYSICALLOGWRITER_TAG,
+            static_cast<ULONG>(coalescingDelay),
+            nullptr);
+        THROW_ON_FAILURE(status);
+
+        // Records that were flushed while waiting join this flush. So do the tasks waiting for them
+        K_LOCK_BLOCK(flushLock_)
+        {
+            if (pendingFlushRecords_ != nullptr)
+            {
+                for (ULONG i = 0; i < pendingFlushRecords_->Count(); i++)
+                {
+                    status = flushingRecords_->Append((*pendingFlushRecords_)[i]);
+                    THROW_ON_FAILURE(status);
+                }
+
+                pendingFlushRecords_ = nullptr;
+            }
+
+            if (pendingFlushTasks_ != nullptr)
+            {
+                for (ULONG i = 0; i < pendingFlushTasks_->Count(); i++)
+                {
+                    status = flushingTasks->Append((*pendingFlushTasks_)[i]);
+                    THROW_ON_FAILURE(status);
+                }
+
+                pendingFlushTasks_ = nullptr;
+            }
+        }
+    }
+
+    ULONG batchRecordCount = flushScheduler_->GetBatchRecordCount(*flushingRecords_);
+
+    if (batchRecordCount == flushingRecords_->Count())
+    {
+        co_return false;
+    }
+
+    KSharedArray<LogRecord::SPtr>::SPtr batchRecords = _new(PHYSICALLOGWRITER_TAG, GetThisAllocator())KSharedArray<LogRecord::SPtr>();
+    THROW_ON_ALLOCATION_FAILURE(batchRecords);
+
+    KSharedArray<LogRecord::SPtr>::SPtr remainingRecords = _new(PHYSICALLOGWRITER_TAG, GetThisAllocator())KSharedArray<LogRecord::SPtr>();
+    THROW_ON_ALLOCATION_FAILURE(remainingRecords);
+
+    for (ULONG i = 0; i < flushingRecords_->Count(); i++)
+    {
+        status = i < batchRecordCount ?
+            batchRecords->Append((*flushingRecords_)[i]) :
+            remainingRecords->Append((*flushingRecords_)[i]);
+        THROW_ON_FAILURE(status);
+    }
+
+    KSharedArray<AwaitableCompletionSource<void>::SPtr>::SPtr batchTasks = _new(PHYSICALLOGWRITER_TAG, GetThisAllocator())KSharedArray<AwaitableCompletionSource<void>::SPtr>();
+    THROW_ON_ALLOCATION_FAILURE(batchTasks);
+
+    // The flushing tasks wait for all the flushing records, so they move to the next flush with the remaining records.
+    // The remaining records precede any pending record and the pending tasks wait for both
+    K_LOCK_BLOCK(flushLock_)
+    {
+        if (pendingFlushRecords_ != nullptr)
+        {
+            for (ULONG i = 0; i < pendingFlushRecords_->Count(); i++)
+            {
+                status = remainingRecords->Append((*pendingFlushRecords_)[i]);
+                THROW_ON_FAILURE(status);
+            }
+        }
+
+        if (pendingFlushTasks_ != nullptr)
+        {
+            for (ULONG i = 0; i < pendingFlushTasks_->Count(); i++)
+            {
+                status = flushingTasks->Append((*pendingFlushTasks_)[i]);
+                THROW_ON_FAILURE(status);
+            }
+        }
+
+        flushingRecords_ = batchRecords;
+        pendingFlushRecords_ = remainingRecords;
+        pendingFlushTasks_ = flushingTasks;
+    }
+
+    flushingTasks = batchTasks;
+
+    co_return true;
+}
+
 void PhysicalLogWriter::FailedFlushTask(__inout KSharedArray<AwaitableCompletionSource<void>::SPtr>::SPtr & flushingTasks)
 {
     ASSERT_IF(
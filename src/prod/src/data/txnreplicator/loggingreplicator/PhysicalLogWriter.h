@@ -213,6 +213,13 @@ namespace Data
 
             ktl::Task FlushTask(__in ktl::AwaitableCompletionSource<void> & initiatingTcs);
 
+            //
+            // Shapes the next flush when a flush latency target is configured. Waits briefly for more records to join the flush and
+            // leaves the records beyond the batch budget for the next flush, along with the flushing tasks.
+            // Returns true if records were left for the next flush
+            //
+            ktl::Awaitable<bool> PrepareFlushBatchAsync(__inout KSharedArray<ktl::AwaitableCompletionSource<void>::SPtr>::SPtr & flushingTasks);
+
             void FailedFlushTask(__inout KSharedArray<ktl::AwaitableCompletionSource<void>::SPtr>::SPtr & flushingTasks);
 
             void ProcessFlushedRecords(__in LoggedRecords const & loggedRecords);
@@ -311,6 +318,9 @@ namespace Data
             TxnReplicator::IOMonitor::SPtr ioMonitor_;
             TxnReplicator::TRInternalSettingsSPtr const transactionalReplicatorConfig_;
 
+            // Only used by the flush task
+            AdaptiveFlushScheduler::SPtr flushScheduler_;
+
             // Recalculate offsets between log records
             // Used during restore to ensure backwards compatiblity if additional fields are added
             bool const recomputeOffsets_;
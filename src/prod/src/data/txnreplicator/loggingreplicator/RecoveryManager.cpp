@@ -406,6 +406,7 @@ Awaitable<NTSTATUS> RecoveryManager::PerformRecoveryAsync(
             *invalidLogRecords_,
             recoveryStartingPosition,
             tailRecordAtStart_->RecordPosition,
+            readAheadSize,
             healthClient,
             config,
             GetThisAllocator());
@@ -35,6 +35,7 @@ ReplicatedLogManager::ReplicatedLogManager(
     , lsnOrderingTcs_()
     , operationAcceptedCount_(0)
     , appendCheckpointCallback_()
+    , replicationCompressor_(nullptr)
     , currentLogHeadRecord_(currentHead)
     , currentLogTailEpoch_()
     , currentLogTailLsn_(0)
@@ -433,6 +434,11 @@ void ReplicatedLogManager::SetCheckpointCallback(__in AppendCheckpointCallback c
     appendCheckpointCallback_ = appendCheckpointCallback;
 }
 
+void ReplicatedLogManager::SetReplicationCompressor(__in ReplicationCompressor & replicationCompressor)
+{
+    replicationCompressor_ = &replicationCompressor;
+}
+
 void ReplicatedLogManager::SetTailEpoch(__in Epoch const & epoch)
 {
     K_LOCK_BLOCK(lsnOrderingLock_)
@@ -936,6 +942,11 @@ NTSTATUS ReplicatedLogManager::BeginReplicate(__in LogicalLogRecord & record)
     ValidateOperationData(*operationData);
 #endif
 
+    if (replicationCompressor_ != nullptr)
+    {
+        operationData = replicationCompressor_->CompressReplicationData(*operationData);
+    }
+
     LONG64 sequenceNumber = Constants::ZeroLsn;
 
     OnOperationAcceptance();
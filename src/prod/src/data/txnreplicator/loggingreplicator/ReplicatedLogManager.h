@@ -135,6 +135,13 @@ namespace Data
                 return roleContextDrainState_;
             }
 
+            // Null until the logging replicator sets it, in which case operations are replicated uncompressed
+            __declspec(property(get = get_Compressor)) ReplicationCompressor::SPtr Compressor;
+            ReplicationCompressor::SPtr get_Compressor() const
+            {
+                return replicationCompressor_;
+            }
+
             // IStateReplicator::SPtr const stateReplicator_
             __declspec(property(get = get_StateReplicator)) IStateReplicator::SPtr const StateReplicator;
             IStateReplicator::SPtr get_StateReplicator() const
@@ -200,6 +207,8 @@ namespace Data
 
             void SetCheckpointCallback(__in AppendCheckpointCallback const & appendCheckpointCallback);
 
+            void SetReplicationCompressor(__in ReplicationCompressor & replicationCompressor);
+
             void SetTailEpoch(__in TxnReplicator::Epoch const & epoch);
 
             void SetTailLsn(__in LONG64 lsn);
@@ -283,6 +292,7 @@ namespace Data
             ktl::AwaitableCompletionSource<void>::SPtr lsnOrderingTcs_;
             Common::atomic_long operationAcceptedCount_;
             AppendCheckpointCallback appendCheckpointCallback_;
+            ReplicationCompressor::SPtr replicationCompressor_;
 
             Data::Utilities::ThreadSafeSPtrCache<LogRecordLib::IndexingLogRecord> currentLogHeadRecord_;
             TxnReplicator::Epoch currentLogTailEpoch_;
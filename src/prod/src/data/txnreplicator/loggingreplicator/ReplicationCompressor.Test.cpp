@@ -0,0 +1,340 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+#include "TestHeaders.h"
+
+#include <boost/test/unit_test.hpp>
+#include "Common/boost-taef.h"
+
+namespace LoggingReplicatorTests
+{
+    using namespace std;
+    using namespace ktl;
+    using namespace Data::LogRecordLib;
+    using namespace Data::LoggingReplicator;
+    using namespace TxnReplicator;
+    using namespace Data::Utilities;
+    using namespace Common;
+
+    StringLiteral const TraceComponent = "ReplicationCompressorTests";
+
+    LONG64 const PrimaryReplicaId = 1;
+
+    class ReplicationCompressorTests
+    {
+    protected:
+        void EndTest();
+
+        //
+        // Creates the compressor of a primary whose configuration has one secondary, which advertised every supported codec
+        //
+        ReplicationCompressor::SPtr CreateCompressor(
+            __in CompressionCodecId::Enum codecId,
+            __in ULONG minCompressionSizeInBytes,
+            __in KAllocator & allocator);
+
+        void UpdateConfiguration(
+            __in ReplicationCompressor & compressor,
+            __in vector<LONG64> const & replicaIds);
+
+        KBuffer::SPtr CreateBuffer(
+            __in ULONG32 size,
+            __in bool isCompressible,
+            __in KAllocator & allocator);
+
+        void VerifyAreEqual(
+            __in OperationData const & expected,
+            __in OperationData const & actual);
+
+        KGuid pId_;
+        ::FABRIC_REPLICA_ID rId_;
+        PartitionedReplicaId::SPtr prId_;
+        KtlSystem * underlyingSystem_;
+    };
+
+    void ReplicationCompressorTests::EndTest()
+    {
+        prId_.Reset();
+    }
+
+    ReplicationCompressor::SPtr ReplicationCompressorTests::CreateCompressor(
+        __in CompressionCodecId::Enum codecId,
+        __in ULONG minCompressionSizeInBytes,
+        __in KAllocator & allocator)
+    {
+        TRANSACTIONAL_REPLICATOR_SETTINGS txrSettings = { 0 };
+        TransactionalReplicatorSettingsUPtr tmp;
+        TransactionalReplicatorSettings::FromPublicApi(txrSettings, tmp);
+
+        std::shared_ptr<TransactionalReplicatorConfig> globalConfig = make_shared<TransactionalReplicatorConfig>();
+        globalConfig->ReplicationCompressionCodec = codecId;
+        globalConfig->MinCompressionSizeInBytes = minCompressionSizeInBytes;
+
+        TxnReplicator::TRInternalSettingsSPtr config = TRInternalSettings::Create(
+            move(tmp),
+            globalConfig);
+
+        ReplicationCompressor::SPtr compressor = ReplicationCompressor::Create(PrimaryReplicaId, config, nullptr, allocator);
+
+        UpdateConfiguration(*compressor, { PrimaryReplicaId, 2 });
+        compressor->OnCopyContextReceived(2, ReplicationCompressor::GetSupportedCodecs());
+
+        return compressor;
+    }
+
+    void ReplicationCompressorTests::UpdateConfiguration(
+        __in ReplicationCompressor & compressor,
+        __in vector<LONG64> const & replicaIds)
+    {
+        vector<FABRIC_REPLICA_INFORMATION> replicas(replicaIds.size());
+        for (size_t i = 0; i < replicaIds.size(); i++)
+        {
+            replicas[i] = { 0 };
+            replicas[i].Id = replicaIds[i];
+        }
+
+        FABRIC_REPLICA_SET_CONFIGURATION configuration = { 0 };
+        configuration.ReplicaCount = static_cast<ULONG>(replicas.size());
+        configuration.Replicas = replicas.data();
+
+        compressor.UpdateReplicaSetConfiguration(&configuration, nullptr);
+    }
+
+    KBuffer::SPtr ReplicationCompressorTests::CreateBuffer(
+        __in ULONG32 size,
+        __in bool isCompressible,
+        __in KAllocator & allocator)
+    {
+        KBuffer::SPtr buffer = nullptr;
+        NTSTATUS status = KBuffer::Create(size, buffer, allocator);
+        CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+        Common::Random random(size);
+        byte * bytes = static_cast<byte *>(buffer->GetBuffer());
+
+        for (ULONG32 i = 0; i < size; i++)
+        {
+            bytes[i] = isCompressible ? static_cast<byte>((i / 16) % 8) : static_cast<byte>(random.Next(256));
+        }
+
+        return buffer;
+    }
+
+    void ReplicationCompressorTests::VerifyAreEqual(
+        __in OperationData const & expected,
+        __in OperationData const & actual)
+    {
+        VERIFY_ARE_EQUAL(expected.BufferCount, actual.BufferCount);
+
+        for (ULONG32 i = 0; i < expected.BufferCount; i++)
+        {
+            VERIFY_ARE_EQUAL(expected[i]->QuerySize(), actual[i]->QuerySize());
+            VERIFY_ARE_EQUAL(memcmp(expected[i]->GetBuffer(), actual[i]->GetBuffer(), expected[i]->QuerySize()), 0);
+        }
+    }
+
+    BOOST_FIXTURE_TEST_SUITE(ReplicationCompressorTestsSuite, ReplicationCompressorTests)
+
+    BOOST_AUTO_TEST_CASE(ReplicationData_Disabled_IsNotCompressed)
+    {
+        TEST_TRACE_BEGIN("ReplicationData_Disabled_IsNotCompressed")
+        {
+            ReplicationCompressor::SPtr compressor = CreateCompressor(CompressionCodecId::None, 0, allocator);
+
+            OperationData::SPtr data = OperationData::Create(allocator);
+            data->Append(*CreateBuffer(16 * 1024, true, allocator));
+
+            OperationData::CSPtr result = compressor->CompressReplicationData(*data);
+
+            VERIFY_ARE_EQUAL(result.RawPtr(), data.RawPtr());
+            VERIFY_IS_FALSE(ReplicationCompressor::IsCompressed(*result));
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(ReplicationData_RoundTrip_PreservesBuffers)
+    {
+        TEST_TRACE_BEGIN("ReplicationData_RoundTrip_PreservesBuffers")
+        {
+            ReplicationCompressor::SPtr compressor = CreateCompressor(CompressionCodecId::Lz, 1024, allocator);
+
+            OperationData::SPtr data = OperationData::Create(allocator);
+            data->Append(*CreateBuffer(100, true, allocator));
+            data->Append(*CreateBuffer(0, true, allocator));
+            data->Append(*CreateBuffer(16 * 1024, true, allocator));
+            data->Append(*CreateBuffer(3000, true, allocator));
+
+            OperationData::CSPtr compressed = compressor->CompressReplicationData(*data);
+
+            VERIFY_IS_TRUE(ReplicationCompressor::IsCompressed(*compressed));
+            VERIFY_ARE_EQUAL(compressed->BufferCount, 2);
+            VERIFY_IS_TRUE(OperationData::GetOperationSize(*compressed) < OperationData::GetOperationSize(*data));
+
+            OperationData::CSPtr decompressed = compressor->Decompress(*compressed);
+            VerifyAreEqual(*data, *decompressed);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(ReplicationData_SmallOrIncompressible_IsNotFramed)
+    {
+        TEST_TRACE_BEGIN("ReplicationData_SmallOrIncompressible_IsNotFramed")
+        {
+            ReplicationCompressor::SPtr compressor = CreateCompressor(CompressionCodecId::Lz, 1024, allocator);
+
+            OperationData::SPtr small = OperationData::Create(allocator);
+            small->Append(*CreateBuffer(512, true, allocator));
+
+            OperationData::CSPtr result = compressor->CompressReplicationData(*small);
+            VERIFY_ARE_EQUAL(result.RawPtr(), small.RawPtr());
+
+            OperationData::SPtr random = OperationData::Create(allocator);
+            random->Append(*CreateBuffer(16 * 1024, false, allocator));
+
+            result = compressor->CompressReplicationData(*random);
+            VERIFY_ARE_EQUAL(result.RawPtr(), random.RawPtr());
+
+            // Data that is not framed is passed through
+            result = compressor->Decompress(*random);
+            VERIFY_ARE_EQUAL(result.RawPtr(), random.RawPtr());
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(ReplicationData_LogicalLogRecord_IsNotMistakenForFrame)
+    {
+        TEST_TRACE_BEGIN("ReplicationData_LogicalLogRecord_IsNotMistakenForFrame")
+        {
+            InvalidLogRecords::SPtr invalidRecords = InvalidLogRecords::Create(allocator);
+            BarrierLogRecord::SPtr record = BarrierLogRecord::Create(LogRecordType::Enum::Barrier, 0, 1, *invalidRecords->Inv_PhysicalLogRecord, allocator);
+
+            OperationData::CSPtr data = record->SerializeLogicalData();
+
+            VERIFY_IS_FALSE(ReplicationCompressor::IsCompressed(*data));
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(CopyData_AlwaysFramed_TrailingBuffersUnchanged)
+    {
+        TEST_TRACE_BEGIN("CopyData_AlwaysFramed_TrailingBuffersUnchanged")
+        {
+            ReplicationCompressor::SPtr compressor = CreateCompressor(CompressionCodecId::Lz, 1024, allocator);
+            KBuffer::SPtr copyStage = CreateBuffer(sizeof(ULONG32), true, allocator);
+
+            // Compressible, too small and incompressible copy operations must all be framed and keep the copy stage last
+            OperationData::SPtr compressible = OperationData::Create(allocator);
+            compressible->Append(*CreateBuffer(8 * 1024, true, allocator));
+            compressible->Append(*CreateBuffer(8 * 1024, true, allocator));
+            compressible->Append(*copyStage);
+
+            OperationData::SPtr small = OperationData::Create(allocator);
+            small->Append(*CreateBuffer(10, true, allocator));
+            small->Append(*copyStage);
+
+            OperationData::SPtr incompressible = OperationData::Create(allocator);
+            incompressible->Append(*CreateBuffer(8 * 1024, false, allocator));
+            incompressible->Append(*copyStage);
+
+            OperationData::SPtr empty = OperationData::Create(allocator);
+            empty->Append(*copyStage);
+
+            OperationData::SPtr inputs[] = { compressible, small, incompressible, empty };
+
+            for (OperationData::SPtr const & input : inputs)
+            {
+                OperationData::CSPtr compressed = compressor->CompressCopyData(*input, CompressionCodecId::Lz, 1);
+
+                VERIFY_IS_TRUE(ReplicationCompressor::IsCompressed(*compressed));
+                VERIFY_ARE_EQUAL((*compressed)[compressed->BufferCount - 1].RawPtr(), copyStage.RawPtr());
+
+                OperationData::CSPtr decompressed = compressor->Decompress(*compressed);
+                VerifyAreEqual(*input, *decompressed);
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(ReplicationData_EveryReplicaMustAdvertiseCodec)
+    {
+        TEST_TRACE_BEGIN("ReplicationData_EveryReplicaMustAdvertiseCodec")
+        {
+            ReplicationCompressor::SPtr compressor = CreateCompressor(CompressionCodecId::Lz, 0, allocator);
+            ULONG32 supportedCodecs = ReplicationCompressor::GetSupportedCodecs();
+
+            OperationData::SPtr data = OperationData::Create(allocator);
+            data->Append(*CreateBuffer(16 * 1024, true, allocator));
+
+            VERIFY_IS_TRUE(ReplicationCompressor::IsCompressed(*compressor->CompressReplicationData(*data)));
+
+            // Replica 3 has not advertised any codec yet
+            UpdateConfiguration(*compressor, { PrimaryReplicaId, 2, 3 });
+            VERIFY_ARE_EQUAL(compressor->ReplicationTargetCodecs, 0u);
+            VERIFY_IS_FALSE(ReplicationCompressor::IsCompressed(*compressor->CompressReplicationData(*data)));
+
+            compressor->OnCopyContextReceived(3, supportedCodecs);
+            VERIFY_ARE_EQUAL(compressor->ReplicationTargetCodecs, supportedCodecs);
+            VERIFY_IS_TRUE(ReplicationCompressor::IsCompressed(*compressor->CompressReplicationData(*data)));
+
+            // An idle replica on an older version keeps the stream uncompressed until it is removed
+            compressor->OnBuildReplica(4);
+            VERIFY_IS_FALSE(ReplicationCompressor::IsCompressed(*compressor->CompressReplicationData(*data)));
+
+            compressor->OnCopyContextReceived(4, 0);
+            VERIFY_IS_FALSE(ReplicationCompressor::IsCompressed(*compressor->CompressReplicationData(*data)));
+
+            compressor->OnRemoveReplica(4);
+            VERIFY_IS_TRUE(ReplicationCompressor::IsCompressed(*compressor->CompressReplicationData(*data)));
+
+            // A rebuilt replica must advertise its codecs again
+            compressor->OnBuildReplica(3);
+            VERIFY_IS_FALSE(ReplicationCompressor::IsCompressed(*compressor->CompressReplicationData(*data)));
+
+            compressor->OnCopyContextReceived(3, supportedCodecs);
+            UpdateConfiguration(*compressor, { PrimaryReplicaId, 2, 3 });
+            VERIFY_IS_TRUE(ReplicationCompressor::IsCompressed(*compressor->CompressReplicationData(*data)));
+
+            // A new primary term starts without a known configuration
+            compressor->ResetReplicaSet();
+            VERIFY_IS_FALSE(ReplicationCompressor::IsCompressed(*compressor->CompressReplicationData(*data)));
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(CopyCodec_Negotiation)
+    {
+        TEST_TRACE_BEGIN("CopyCodec_Negotiation")
+        {
+            ReplicationCompressor::SPtr enabled = CreateCompressor(CompressionCodecId::Lz, 1024, allocator);
+            ReplicationCompressor::SPtr disabled = CreateCompressor(CompressionCodecId::None, 1024, allocator);
+
+            // A secondary running an older version does not advertise any codec
+            VERIFY_ARE_EQUAL(enabled->GetCopyCodec(0), CompressionCodecId::None);
+            VERIFY_ARE_EQUAL(enabled->GetCopyCodec(ReplicationCompressor::GetSupportedCodecs()), CompressionCodecId::Lz);
+            VERIFY_ARE_EQUAL(disabled->GetCopyCodec(ReplicationCompressor::GetSupportedCodecs()), CompressionCodecId::None);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(CopyHeader_CompressionCodec_SerializeDeserialize)
+    {
+        TEST_TRACE_BEGIN("CopyHeader_CompressionCodec_SerializeDeserialize")
+        {
+            CopyHeader::SPtr copyHeader = CopyHeader::Create(
+                CopyHeader::CompressionCodecVersion,
+                CopyStage::Enum::CopyState,
+                12345,
+                CompressionCodecId::Lz,
+                allocator);
+
+            KArray<KBuffer::CSPtr> buffers(allocator);
+            buffers.Append(CopyHeader::Serialize(*copyHeader, allocator).RawPtr());
+
+            OperationData::CSPtr opData = OperationData::Create(buffers, allocator);
+            CopyHeader::SPtr readCopyHeader = CopyHeader::Deserialize(*opData, allocator);
+
+            VERIFY_ARE_EQUAL(readCopyHeader->Version, CopyHeader::CompressionCodecVersion);
+            VERIFY_ARE_EQUAL(readCopyHeader->CopyStageValue, CopyStage::Enum::CopyState);
+            VERIFY_ARE_EQUAL(readCopyHeader->PrimaryReplicaId, 12345);
+            VERIFY_ARE_EQUAL(readCopyHeader->CompressionCodec, CompressionCodecId::Lz);
+        }
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+}
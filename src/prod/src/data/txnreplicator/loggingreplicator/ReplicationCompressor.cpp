@@ -0,0 +1,533 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+using namespace ktl;
+using namespace Data::LoggingReplicator;
+using namespace Data::Utilities;
+using namespace TxnReplicator;
+
+ReplicationCompressor::ReplicationCompressor(
+    __in LONG64 replicaId,
+    __in TRInternalSettingsSPtr const & transactionalReplicatorConfig,
+    __in TRPerformanceCountersSPtr const & perfCounters)
+    : KObject()
+    , KShared()
+    , replicaId_(replicaId)
+    , transactionalReplicatorConfig_(transactionalReplicatorConfig)
+    , perfCounters_(perfCounters)
+    , lzCodec_(nullptr)
+    , replicaSetLock_()
+    , isConfigurationKnown_(false)
+    , advertisedCodecs_()
+    , configurationReplicaIds_()
+    , idleReplicaIds_()
+    , replicationTargetCodecs_(0)
+{
+    NTSTATUS status = CompressionCodecFactory::Create(CompressionCodecId::Lz, GetThisAllocator(), lzCodec_);
+    THROW_ON_FAILURE(status);
+}
+
+ReplicationCompressor::~ReplicationCompressor()
+{
+}
+
+ReplicationCompressor::SPtr ReplicationCompressor::Create(
+    __in LONG64 replicaId,
+    __in TRInternalSettingsSPtr const & transactionalReplicatorConfig,
+    __in TRPerformanceCountersSPtr const & perfCounters,
+    __in KAllocator & allocator)
+{
+    ReplicationCompressor * pointer = _new(REPLICATIONCOMPRESSOR_TAG, allocator)ReplicationCompressor(
+        replicaId,
+        transactionalReplicatorConfig,
+        perfCounters);
+
+    THROW_ON_ALLOCATION_FAILURE(pointer);
+
+    return ReplicationCompressor::SPtr(pointer);
+}
+
+ULONG32 ReplicationCompressor::GetSupportedCodecs()
+{
+    return 1 << CompressionCodecId::Lz;
+}
+
+bool ReplicationCompressor::IsCodecSupported(
+    __in ULONG32 supportedCodecs,
+    __in CompressionCodecId::Enum codecId)
+{
+    return codecId < 32 && (supportedCodecs & (1 << codecId)) != 0;
+}
+
+bool ReplicationCompressor::IsCompressed(__in OperationData const & operationData)
+{
+    if (operationData.BufferCount < 2)
+    {
+        return false;
+    }
+
+    KBuffer::CSPtr header = operationData[0];
+    if (header->QuerySize() < 4 * sizeof(ULONG32))
+    {
+        return false;
+    }
+
+    ULONG32 const * fields = static_cast<ULONG32 const *>(header->GetBuffer());
+    return fields[0] == FrameMarker && fields[1] == FrameSignature;
+}
+
+CompressionCodecId::Enum ReplicationCompressor::get_ReplicationCodec() const
+{
+    return static_cast<CompressionCodecId::Enum>(transactionalReplicatorConfig_->ReplicationCompressionCodec);
+}
+
+CompressionCodecId::Enum ReplicationCompressor::GetCopyCodec(__in ULONG32 targetSupportedCodecs) const
+{
+    CompressionCodecId::Enum codecId = ReplicationCodec;
+
+    if (codecId == CompressionCodecId::None ||
+        GetCodec(codecId) == nullptr ||
+        !IsCodecSupported(targetSupportedCodecs, codecId))
+    {
+        return CompressionCodecId::None;
+    }
+
+    return codecId;
+}
+
+void ReplicationCompressor::OnCopyContextReceived(
+    __in LONG64 replicaId,
+    __in ULONG32 supportedCodecs)
+{
+    K_LOCK_BLOCK(replicaSetLock_)
+    {
+        advertisedCodecs_[replicaId] = supportedCodecs;
+        UpdateReplicationTargetCodecsCallerHoldsLock();
+    }
+}
+
+void ReplicationCompressor::UpdateReplicaSetConfiguration(
+    __in FABRIC_REPLICA_SET_CONFIGURATION const * currentConfiguration,
+    __in_opt FABRIC_REPLICA_SET_CONFIGURATION const * previousConfiguration)
+{
+    K_LOCK_BLOCK(replicaSetLock_)
+    {
+        configurationReplicaIds_.clear();
+
+        for (FABRIC_REPLICA_SET_CONFIGURATION const * configuration : { currentConfiguration, previousConfiguration })
+        {
+            if (configuration == nullptr)
+            {
+                continue;
+            }
+
+            for (ULONG i = 0; i < configuration->ReplicaCount; i++)
+            {
+                LONG64 replicaId = configuration->Replicas[i].Id;
+                if (replicaId == replicaId_)
+                {
+                    continue;
+                }
+
+                configurationReplicaIds_.insert(replicaId);
+                idleReplicaIds_.erase(replicaId);
+            }
+        }
+
+        isConfigurationKnown_ = true;
+        UpdateReplicationTargetCodecsCallerHoldsLock();
+    }
+}
+
+void ReplicationCompressor::OnBuildReplica(__in LONG64 replicaId)
+{
+    K_LOCK_BLOCK(replicaSetLock_)
+    {
+        advertisedCodecs_.erase(replicaId);
+        idleReplicaIds_.insert(replicaId);
+        UpdateReplicationTargetCodecsCallerHoldsLock();
+    }
+}
+
+void ReplicationCompressor::OnRemoveReplica(__in LONG64 replicaId)
+{
+    K_LOCK_BLOCK(replicaSetLock_)
+    {
+        advertisedCodecs_.erase(replicaId);
+        idleReplicaIds_.erase(replicaId);
+        configurationReplicaIds_.erase(replicaId);
+        UpdateReplicationTargetCodecsCallerHoldsLock();
+    }
+}
+
+void ReplicationCompressor::ResetReplicaSet()
+{
+    K_LOCK_BLOCK(replicaSetLock_)
+    {
+        isConfigurationKnown_ = false;
+        advertisedCodecs_.clear();
+        configurationReplicaIds_.clear();
+        idleReplicaIds_.clear();
+        UpdateReplicationTargetCodecsCallerHoldsLock();
+    }
+}
+
+void ReplicationCompressor::UpdateReplicationTargetCodecsCallerHoldsLock()
+{
+    ULONG32 codecs = isConfigurationKnown_ ? GetSupportedCodecs() : 0;
+
+    for (std::unordered_set<LONG64> const * replicaIds : { &configurationReplicaIds_, &idleReplicaIds_ })
+    {
+        for (LONG64 replicaId : *replicaIds)
+        {
+            auto advertised = advertisedCodecs_.find(replicaId);
+            codecs &= advertised == advertisedCodecs_.end() ? 0 : advertised->second;
+        }
+    }
+
+    InterlockedExchange(&replicationTargetCodecs_, static_cast<LONG>(codecs));
+}
+
+OperationData::CSPtr ReplicationCompressor::CompressReplicationData(__in OperationData const & operationData)
+{
+    CompressionCodecId::Enum codecId = ReplicationCodec;
+
+    if (codecId == CompressionCodecId::None ||
+        GetCodec(codecId) == nullptr ||
+        !IsCodecSupported(ReplicationTargetCodecs, codecId))
+    {
+        return &operationData;
+    }
+
+    return Compress(operationData, codecId, 0, false);
+}
+
+OperationData::CSPtr ReplicationCompressor::CompressCopyData(
+    __in OperationData const & operationData,
+    __in CompressionCodecId::Enum codecId,
+    __in ULONG32 trailingBufferCount)
+{
+    ASSERT_IFNOT(
+        trailingBufferCount <= operationData.BufferCount,
+        "Copy operation with {0} buffers cannot have {1} trailing buffers",
+        operationData.BufferCount,
+        trailingBufferCount);
+
+    return Compress(operationData, codecId, trailingBufferCount, true);
+}
+
+OperationData::CSPtr ReplicationCompressor::Decompress(__in OperationData const & operationData)
+{
+    if (!IsCompressed(operationData))
+    {
+        return &operationData;
+    }
+
+    Common::Stopwatch watch;
+    watch.Start();
+
+    KBuffer::CSPtr header = operationData[0];
+    BinaryReader br(*header, GetThisAllocator());
+
+    ULONG32 frameMarker;
+    ULONG32 frameSignature;
+    ULONG32 codecIdValue;
+    ULONG32 compressedBufferCount;
+
+    br.Read(frameMarker);
+    br.Read(frameSignature);
+    br.Read(codecIdValue);
+    br.Read(compressedBufferCount);
+
+    // The frame header is followed by the size of each compressed buffer
+    ASSERT_IFNOT(
+        static_cast<ULONG64>(header->QuerySize()) >= (4 + static_cast<ULONG64>(compressedBufferCount)) * sizeof(ULONG32),
+        "Corrupt compressed operation data frame: header of {0} bytes cannot hold {1} buffer sizes",
+        header->QuerySize(),
+        compressedBufferCount);
+
+    CompressionCodecId::Enum codecId = static_cast<CompressionCodecId::Enum>(codecIdValue);
+
+    OperationData::SPtr result = OperationData::Create(GetThisAllocator());
+    ULONG32 trailingIndex;
+
+    if (codecId == CompressionCodecId::None)
+    {
+        ASSERT_IFNOT(
+            static_cast<ULONG64>(compressedBufferCount) + 1 <= operationData.BufferCount,
+            "Corrupt compressed operation data frame: {0} uncompressed buffers in operation data with {1} buffers",
+            compressedBufferCount,
+            operationData.BufferCount);
+
+        for (ULONG32 i = 0; i < compressedBufferCount; i++)
+        {
+            result->Append(*operationData[i + 1]);
+        }
+
+        trailingIndex = compressedBufferCount + 1;
+    }
+    else
+    {
+        ICompressionCodec::SPtr codec = GetCodec(codecId);
+
+        ASSERT_IFNOT(
+            codec != nullptr,
+            "Received operation data compressed with unsupported codec {0}",
+            codecIdValue);
+
+        KBuffer::CSPtr compressedBuffer = operationData[1];
+        byte const * source = static_cast<byte const *>(compressedBuffer->GetBuffer());
+        ULONG32 sourceSize = compressedBuffer->QuerySize();
+
+        // The codec decodes a block as a whole, so it is decoded into one buffer that is then split at the original boundaries
+        ULONG64 totalSize = 0;
+        KArray<ULONG32> sizes(GetThisAllocator(), compressedBufferCount);
+        THROW_ON_CONSTRUCTOR_FAILURE(sizes);
+
+        for (ULONG32 i = 0; i < compressedBufferCount; i++)
+        {
+            ULONG32 size;
+            br.Read(size);
+            totalSize += size;
+
+            NTSTATUS status = sizes.Append(size);
+            THROW_ON_FAILURE(status);
+        }
+
+        ASSERT_IFNOT(
+            totalSize <= MaxCompressedInputSize,
+            "Corrupt compressed operation data frame: {0} buffers of {1} bytes in total exceed {2} bytes",
+            compressedBufferCount,
+            totalSize,
+            static_cast<ULONG32>(MaxCompressedInputSize));
+
+        ULONG32 decompressedSize = static_cast<ULONG32>(totalSize);
+
+        KBuffer::SPtr decompressed = nullptr;
+        NTSTATUS status = KBuffer::Create(decompressedSize, decompressed, GetThisAllocator(), REPLICATIONCOMPRESSOR_TAG);
+        THROW_ON_FAILURE(status);
+
+        status = codec->Decompress(
+            source,
+            sourceSize,
+            static_cast<byte *>(decompressed->GetBuffer()),
+            decompressedSize);
+
+        ASSERT_IFNOT(
+            NT_SUCCESS(status),
+            "Failed to decompress operation data of {0} bytes into {1} bytes with codec {2}. Status {3:x}",
+            sourceSize,
+            decompressedSize,
+            codecIdValue,
+            status);
+
+        if (compressedBufferCount == 1)
+        {
+            result->Append(*decompressed);
+        }
+        else
+        {
+            ULONG32 offset = 0;
+            for (ULONG32 i = 0; i < compressedBufferCount; i++)
+            {
+                KBuffer::SPtr buffer = nullptr;
+                status = KBuffer::Create(sizes[i], buffer, GetThisAllocator(), REPLICATIONCOMPRESSOR_TAG);
+                THROW_ON_FAILURE(status);
+
+                if (sizes[i] > 0)
+                {
+                    memcpy(buffer->GetBuffer(), static_cast<byte const *>(decompressed->GetBuffer()) + offset, sizes[i]);
+                }
+
+                offset += sizes[i];
+                result->Append(*buffer);
+            }
+        }
+
+        trailingIndex = 2;
+    }
+
+    for (ULONG32 i = trailingIndex; i < operationData.BufferCount; i++)
+    {
+        result->Append(*operationData[i]);
+    }
+
+    watch.Stop();
+
+    if (perfCounters_)
+    {
+        perfCounters_->AvgDecompressionLatency.IncrementBy(watch.ElapsedMicroseconds);
+        perfCounters_->AvgDecompressionLatencyBase.Increment();
+    }
+
+    return result.RawPtr();
+}
+
+ICompressionCodec::SPtr ReplicationCompressor::GetCodec(__in CompressionCodecId::Enum codecId) const
+{
+    switch (codecId)
+    {
+    case CompressionCodecId::Lz:
+        return lzCodec_;
+    default:
+        return nullptr;
+    }
+}
+
+OperationData::CSPtr ReplicationCompressor::Compress(
+    __in OperationData const & operationData,
+    __in CompressionCodecId::Enum codecId,
+    __in ULONG32 trailingBufferCount,
+    __in bool isFrameRequired)
+{
+    ULONG32 compressedBufferCount = operationData.BufferCount - trailingBufferCount;
+    ULONG64 totalSize = 0;
+
+    for (ULONG32 i = 0; i < compressedBufferCount; i++)
+    {
+        totalSize += operationData[i]->QuerySize();
+    }
+
+    ICompressionCodec::SPtr codec = GetCodec(codecId);
+
+    if (codec == nullptr ||
+        totalSize < static_cast<ULONG64>(transactionalReplicatorConfig_->MinCompressionSizeInBytes) ||
+        totalSize > MaxCompressedInputSize)
+    {
+        return isFrameRequired ?
+            CreateFrame(operationData, CompressionCodecId::None, compressedBufferCount, nullptr) :
+            &operationData;
+    }
+
+    Common::Stopwatch watch;
+    watch.Start();
+
+    ULONG32 sourceSize = static_cast<ULONG32>(totalSize);
+    KBuffer::CSPtr source = nullptr;
+
+    if (compressedBufferCount == 1)
+    {
+        source = operationData[0];
+    }
+    else
+    {
+        KBuffer::SPtr gathered = nullptr;
+        NTSTATUS status = KBuffer::Create(sourceSize, gathered, GetThisAllocator(), REPLICATIONCOMPRESSOR_TAG);
+        THROW_ON_FAILURE(status);
+
+        ULONG32 offset = 0;
+        for (ULONG32 i = 0; i < compressedBufferCount; i++)
+        {
+            KBuffer::CSPtr buffer = operationData[i];
+            if (buffer->QuerySize() > 0)
+            {
+                memcpy(static_cast<byte *>(gathered->GetBuffer()) + offset, buffer->GetBuffer(), buffer->QuerySize());
+            }
+
+            offset += buffer->QuerySize();
+        }
+
+        source = gathered.RawPtr();
+    }
+
+    // Anything that does not save at least a quarter is sent uncompressed, since the secondary would pay for decoding it
+    ULONG32 destinationCapacity = sourceSize - (sourceSize / 4);
+
+    KBuffer::SPtr destination = nullptr;
+    NTSTATUS status = KBuffer::Create(codec->GetMaxCompressedSize(sourceSize), destination, GetThisAllocator(), REPLICATIONCOMPRESSOR_TAG);
+    THROW_ON_FAILURE(status);
+
+    ULONG32 compressedSize = codec->Compress(
+        static_cast<byte const *>(source->GetBuffer()),
+        sourceSize,
+        static_cast<byte *>(destination->GetBuffer()),
+        destinationCapacity);
+
+    if (compressedSize == 0)
+    {
+        watch.Stop();
+        UpdateCompressionCounters(sourceSize, sourceSize, watch.ElapsedMicroseconds);
+
+        return isFrameRequired ?
+            CreateFrame(operationData, CompressionCodecId::None, compressedBufferCount, nullptr) :
+            &operationData;
+    }
+
+    KBuffer::SPtr compressed = nullptr;
+    status = KBuffer::Create(compressedSize, compressed, GetThisAllocator(), REPLICATIONCOMPRESSOR_TAG);
+    THROW_ON_FAILURE(status);
+
+    memcpy(compressed->GetBuffer(), destination->GetBuffer(), compressedSize);
+
+    OperationData::CSPtr result = CreateFrame(operationData, codecId, compressedBufferCount, compressed.RawPtr());
+
+    watch.Stop();
+    UpdateCompressionCounters(sourceSize, compressedSize, watch.ElapsedMicroseconds);
+
+    return result;
+}
+
+OperationData::CSPtr ReplicationCompressor::CreateFrame(
+    __in OperationData const & operationData,
+    __in CompressionCodecId::Enum codecId,
+    __in ULONG32 compressedBufferCount,
+    __in_opt KBuffer const * compressedBuffer)
+{
+    BinaryWriter bw(GetThisAllocator());
+
+    bw.Write(FrameMarker);
+    bw.Write(FrameSignature);
+    bw.Write(static_cast<ULONG32>(codecId));
+    bw.Write(compressedBufferCount);
+
+    for (ULONG32 i = 0; i < compressedBufferCount; i++)
+    {
+        bw.Write(static_cast<ULONG32>(operationData[i]->QuerySize()));
+    }
+
+    OperationData::SPtr result = OperationData::Create(GetThisAllocator());
+
+    KBuffer::SPtr header = bw.GetBuffer(0);
+    result->Append(*header);
+
+    if (compressedBuffer == nullptr)
+    {
+        for (ULONG32 i = 0; i < compressedBufferCount; i++)
+        {
+            result->Append(*operationData[i]);
+        }
+    }
+    else
+    {
+        result->Append(*compressedBuffer);
+    }
+
+    for (ULONG32 i = compressedBufferCount; i < operationData.BufferCount; i++)
+    {
+        result->Append(*operationData[i]);
+    }
+
+    return result.RawPtr();
+}
+
+void ReplicationCompressor::UpdateCompressionCounters(
+    __in ULONG64 inputSize,
+    __in ULONG64 outputSize,
+    __in LONG64 elapsedMicroseconds)
+{
+    if (!perfCounters_)
+    {
+        return;
+    }
+
+    perfCounters_->CompressionInputBytes.IncrementBy(inputSize);
+    perfCounters_->CompressionOutputBytes.IncrementBy(outputSize);
+    perfCounters_->AvgCompressionRatio.IncrementBy(inputSize == 0 ? 100 : (outputSize * 100) / inputSize);
+    perfCounters_->AvgCompressionRatioBase.Increment();
+    perfCounters_->AvgCompressionLatency.IncrementBy(elapsedMicroseconds);
+    perfCounters_->AvgCompressionLatencyBase.Increment();
+}
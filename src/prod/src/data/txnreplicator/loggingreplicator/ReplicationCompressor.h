@@ -0,0 +1,174 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace LoggingReplicator
+    {
+        //
+        // Compresses the operation data sent to secondaries, one replicated operation or copy batch at a time.
+        //
+        // A compressed operation data is framed as:
+        //
+        //  Buffer 0        FrameMarker | FrameSignature | codec id | N | size of each of the N original buffers
+        //  Buffer 1        the N original buffers compressed as one block, or the N original buffers themselves if the codec is None
+        //  Trailing        buffers that were excluded from compression (e.g. the copy stage of a copy operation), unchanged
+        //
+        // The frame marker sits where the logical metadata section size of a log record is, which can never be MAXULONG32, so
+        // a frame can always be told apart from an uncompressed replicated log record.
+        //
+        // The codec of the replication stream is TransactionalReplicator/ReplicationCompressionCodec. The fabric replicator broadcasts
+        // the same replication stream to every secondary, so the primary only compresses it once every replica in the configuration,
+        // and every idle replica being built, has advertised the codec in its copy context. A replica that has not, such as one running
+        // an older version or one built by a previous primary, keeps the whole stream uncompressed until it leaves the configuration or
+        // is rebuilt. The copy stream is negotiated per secondary through the copy context and the copy header.
+        //
+        // Thread safe.
+        //
+        class ReplicationCompressor final
+            : public KObject<ReplicationCompressor>
+            , public KShared<ReplicationCompressor>
+        {
+            K_FORCE_SHARED(ReplicationCompressor)
+
+        public:
+            static const ULONG32 FrameMarker = MAXULONG32;
+            static const ULONG32 FrameSignature = 'pmCR';
+
+            // Larger inputs are sent uncompressed, and a frame that claims more is corrupt
+            static const ULONG32 MaxCompressedInputSize = MAXULONG32 / 2;
+
+            static ReplicationCompressor::SPtr Create(
+                __in LONG64 replicaId,
+                __in TxnReplicator::TRInternalSettingsSPtr const & transactionalReplicatorConfig,
+                __in TxnReplicator::TRPerformanceCountersSPtr const & perfCounters,
+                __in KAllocator & allocator);
+
+            //
+            // Bit mask of the codecs this binary can decode, advertised by a secondary in its copy context
+            //
+            static ULONG32 GetSupportedCodecs();
+
+            static bool IsCodecSupported(
+                __in ULONG32 supportedCodecs,
+                __in Utilities::CompressionCodecId::Enum codecId);
+
+            static bool IsCompressed(__in Utilities::OperationData const & operationData);
+
+            // Codec configured for the replication stream
+            __declspec(property(get = get_ReplicationCodec)) Utilities::CompressionCodecId::Enum ReplicationCodec;
+            Utilities::CompressionCodecId::Enum get_ReplicationCodec() const;
+
+            // Codecs that every replica receiving the replication stream can decode
+            __declspec(property(get = get_ReplicationTargetCodecs)) ULONG32 ReplicationTargetCodecs;
+            ULONG32 get_ReplicationTargetCodecs() const
+            {
+                return static_cast<ULONG32>(replicationTargetCodecs_);
+            }
+
+            //
+            // Records the codecs a secondary advertised in its copy context
+            //
+            void OnCopyContextReceived(
+                __in LONG64 replicaId,
+                __in ULONG32 supportedCodecs);
+
+            //
+            // Replaces the secondaries of the configuration with those of the current and, during a reconfiguration, previous configuration
+            //
+            void UpdateReplicaSetConfiguration(
+                __in FABRIC_REPLICA_SET_CONFIGURATION const * currentConfiguration,
+                __in_opt FABRIC_REPLICA_SET_CONFIGURATION const * previousConfiguration);
+
+            //
+            // An idle replica receives the replication stream from the start of its build, before it joins the configuration.
+            // Its codecs are forgotten until the copy context of the build arrives, since it may have restarted on another version.
+            //
+            void OnBuildReplica(__in LONG64 replicaId);
+
+            void OnRemoveReplica(__in LONG64 replicaId);
+
+            //
+            // Forgets the replica set when the replica stops being primary
+            //
+            void ResetReplicaSet();
+
+            //
+            // Codec to use for the copy stream to a secondary that advertised the given codecs.
+            // Returns CompressionCodecId::None if the secondary is running an older version or does not support the configured codec.
+            //
+            Utilities::CompressionCodecId::Enum GetCopyCodec(__in ULONG32 targetSupportedCodecs) const;
+
+            //
+            // Compresses a replicated operation with the configured codec.
+            // Returns the operation data as is if compression is disabled, a replica cannot decode the codec, or the operation is small
+            // or does not compress.
+            //
+            Utilities::OperationData::CSPtr CompressReplicationData(__in Utilities::OperationData const & operationData);
+
+            //
+            // Compresses all but the last trailingBufferCount buffers of a copy operation with the given codec.
+            // The result is always framed, so the secondary can decode every operation of a copy stream that negotiated compression.
+            //
+            Utilities::OperationData::CSPtr CompressCopyData(
+                __in Utilities::OperationData const & operationData,
+                __in Utilities::CompressionCodecId::Enum codecId,
+                __in ULONG32 trailingBufferCount);
+
+            //
+            // Returns the original operation data of a frame, followed by its trailing buffers.
+            // Operation data that is not framed is returned as is.
+            //
+            Utilities::OperationData::CSPtr Decompress(__in Utilities::OperationData const & operationData);
+
+        private:
+            ReplicationCompressor(
+                __in LONG64 replicaId,
+                __in TxnReplicator::TRInternalSettingsSPtr const & transactionalReplicatorConfig,
+                __in TxnReplicator::TRPerformanceCountersSPtr const & perfCounters);
+
+            Utilities::ICompressionCodec::SPtr GetCodec(__in Utilities::CompressionCodecId::Enum codecId) const;
+
+            Utilities::OperationData::CSPtr Compress(
+                __in Utilities::OperationData const & operationData,
+                __in Utilities::CompressionCodecId::Enum codecId,
+                __in ULONG32 trailingBufferCount,
+                __in bool isFrameRequired);
+
+            Utilities::OperationData::CSPtr CreateFrame(
+                __in Utilities::OperationData const & operationData,
+                __in Utilities::CompressionCodecId::Enum codecId,
+                __in ULONG32 compressedBufferCount,
+                __in_opt KBuffer const * compressedBuffer);
+
+            void UpdateReplicationTargetCodecsCallerHoldsLock();
+
+            void UpdateCompressionCounters(
+                __in ULONG64 inputSize,
+                __in ULONG64 outputSize,
+                __in LONG64 elapsedMicroseconds);
+
+            // The primary itself is part of the configuration but never receives the replication stream
+            LONG64 const replicaId_;
+            TxnReplicator::TRInternalSettingsSPtr const transactionalReplicatorConfig_;
+            TxnReplicator::TRPerformanceCountersSPtr const perfCounters_;
+
+            // Codecs are stateless, so one instance per id is shared by all callers
+            Utilities::ICompressionCodec::SPtr lzCodec_;
+
+            // Protects the replica set below
+            KSpinLock replicaSetLock_;
+            bool isConfigurationKnown_;
+            std::unordered_map<LONG64, ULONG32> advertisedCodecs_;
+            std::unordered_set<LONG64> configurationReplicaIds_;
+            std::unordered_set<LONG64> idleReplicaIds_;
+
+            // Zero until the configuration is known
+            volatile LONG replicationTargetCodecs_;
+        };
+    }
+}
@@ -0,0 +1,428 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+using namespace Data::LogRecordLib;
+using namespace Data::LoggingReplicator;
+using namespace Data::Utilities;
+using namespace ktl;
+
+RestoreLogRecordsAsyncEnumerator::SPtr RestoreLogRecordsAsyncEnumerator::Create(
+    __in PartitionedReplicaId const & traceId,
+    __in KArray<KString::CSPtr> const & restoreFileArray,
+    __in ULONG64 readAheadSizeInBytes,
+    __in KAllocator & allocator)
+{
+    RestoreLogRecordsAsyncEnumerator * pointer = _new(RESTORE_LOG_RECORDS_ASYNC_ENUMERATOR_TAG, allocator) RestoreLogRecordsAsyncEnumerator(
+        traceId,
+        restoreFileArray,
+        readAheadSizeInBytes);
+
+    THROW_ON_ALLOCATION_FAILURE(pointer);
+    THROW_ON_FAILURE(pointer->Status());
+
+    return SPtr(pointer);
+}
+
+ULONG64 RestoreLogRecordsAsyncEnumerator::get_Count() const
+{
+    return count_;
+}
+
+ULONG64 RestoreLogRecordsAsyncEnumerator::get_Size() const
+{
+    return size_;
+}
+
+LogRecord::SPtr RestoreLogRecordsAsyncEnumerator::GetCurrent()
+{
+    ASSERT_IFNOT(currentBatchSPtr_ != nullptr, "{0}: GetCurrent called before MoveNextAsync.", TraceId);
+
+    return (*currentBatchSPtr_)[currentIndex_];
+}
+
+// Move to the next log record.
+// Algorithm:
+// 1. Return the next record of the current batch if available.
+// 2. Take the oldest batch that was read ahead, waking up the read ahead if it waits for buffer space.
+// 3. If there is no batch, return false if the read ahead completed (or rethrow its failure), otherwise wait for it.
+ktl::Awaitable<bool> RestoreLogRecordsAsyncEnumerator::MoveNextAsync(
+    __in CancellationToken const & cancellationToken)
+{
+    UNREFERENCED_PARAMETER(cancellationToken);
+
+    KShared$ApiEntry();
+
+    StartReadAhead();
+
+    // Step 1: Return from the current batch.
+    if (currentBatchSPtr_ != nullptr && currentIndex_ + 1 < currentBatchSPtr_->Count())
+    {
+        currentIndex_++;
+        count_++;
+        size_ += (*currentBatchSPtr_)[currentIndex_]->RecordSize;
+        co_return true;
+    }
+
+    while (true)
+    {
+        Batch batch;
+        batch.Size = 0;
+
+        bool isBatchTaken = false;
+        bool isDrained = false;
+        SharedException::CSPtr exceptionSPtr = nullptr;
+        AwaitableCompletionSource<void>::SPtr readAheadWaiter = nullptr;
+        AwaitableCompletionSource<void>::SPtr consumerWaiter = nullptr;
+
+        K_LOCK_BLOCK(lock_)
+        {
+            if (batches_.Count() > 0)
+            {
+                // Step 2: Take the oldest batch.
+                batch = batches_[0];
+                batches_.Remove(0);
+                bufferedSize_ -= batch.Size;
+                isBatchTaken = true;
+
+                readAheadWaiter = Ktl::Move(readAheadWaiterAcsSPtr_);
+            }
+            else if (isReadAheadCompleted_)
+            {
+                // Step 3: Nothing left to read.
+                isDrained = true;
+                exceptionSPtr = readAheadExceptionSPtr_;
+            }
+            else
+            {
+                consumerWaiterAcsSPtr_ = CompletionTask::CreateAwaitableCompletionSource<void>(RESTORE_LOG_RECORDS_ASYNC_ENUMERATOR_TAG, GetThisAllocator());
+                consumerWaiter = consumerWaiterAcsSPtr_;
+            }
+        }
+
+        if (readAheadWaiter != nullptr)
+        {
+            readAheadWaiter->Set();
+        }
+
+        if (isBatchTaken)
+        {
+            currentBatchSPtr_ = Ktl::Move(batch.Records);
+            currentIndex_ = 0;
+            count_++;
+            size_ += (*currentBatchSPtr_)[0]->RecordSize;
+            co_return true;
+        }
+
+        if (isDrained)
+        {
+            currentBatchSPtr_ = nullptr;
+
+            if (exceptionSPtr != nullptr)
+            {
+                throw exceptionSPtr->get_Info();
+            }
+
+            co_return false;
+        }
+
+        co_await consumerWaiter->GetAwaitable();
+    }
+}
+
+void RestoreLogRecordsAsyncEnumerator::Reset()
+{
+    throw ktl::Exception(STATUS_NOT_IMPLEMENTED);
+}
+
+void RestoreLogRecordsAsyncEnumerator::Dispose()
+{
+    CloseInBackground();
+}
+
+void RestoreLogRecordsAsyncEnumerator::StartReadAhead()
+{
+    if (isReadAheadStarted_)
+    {
+        return;
+    }
+
+    isReadAheadStarted_ = true;
+    readAheadAwaitable_ = ReadAheadAsync();
+}
+
+ktl::Awaitable<void> RestoreLogRecordsAsyncEnumerator::CloseAsync()
+{
+    KShared$ApiEntry();
+
+    AwaitableCompletionSource<void>::SPtr closeAcs = CompletionTask::CreateAwaitableCompletionSource<void>(RESTORE_LOG_RECORDS_ASYNC_ENUMERATOR_TAG, GetThisAllocator());
+    AwaitableCompletionSource<void>::SPtr readAheadWaiter = nullptr;
+    bool isFirstClose = false;
+
+    K_LOCK_BLOCK(lock_)
+    {
+        if (closeAcsSPtr_ == nullptr)
+        {
+            closeAcsSPtr_ = closeAcs;
+            isFirstClose = true;
+            isClosing_ = true;
+            readAheadWaiter = Ktl::Move(readAheadWaiterAcsSPtr_);
+        }
+        else
+        {
+            closeAcs = closeAcsSPtr_;
+        }
+    }
+
+    if (isFirstClose == false)
+    {
+        // Dispose or a previous CloseAsync is draining the read ahead.
+        co_await closeAcs->GetAwaitable();
+        co_return;
+    }
+
+    if (readAheadWaiter != nullptr)
+    {
+        readAheadWaiter->Set();
+    }
+
+    if (isReadAheadStarted_)
+    {
+        // ReadAheadAsync does not throw: its failure is returned by MoveNextAsync.
+        co_await readAheadAwaitable_;
+    }
+
+    K_LOCK_BLOCK(lock_)
+    {
+        batches_.Clear();
+        bufferedSize_ = 0;
+    }
+
+    currentBatchSPtr_ = nullptr;
+
+    closeAcs->Set();
+
+    co_return;
+}
+
+ktl::Task RestoreLogRecordsAsyncEnumerator::CloseInBackground()
+{
+    KShared$ApiEntry();
+
+    co_await CloseAsync();
+}
+
+ktl::Awaitable<void> RestoreLogRecordsAsyncEnumerator::ReadAheadAsync()
+{
+    KShared$ApiEntry();
+
+    SharedException::CSPtr exceptionSPtr = nullptr;
+
+    try
+    {
+        for (ULONG32 i = 0; i < restoreFileArray_.Count(); i++)
+        {
+            bool isClosing = false;
+            K_LOCK_BLOCK(lock_)
+            {
+                isClosing = isClosing_;
+            }
+
+            if (isClosing)
+            {
+                break;
+            }
+
+            co_await ReadFileAsync(*restoreFileArray_[i]);
+        }
+    }
+    catch (Exception & exception)
+    {
+        exceptionSPtr = SharedException::Create(exception, GetThisAllocator());
+    }
+
+    CompleteReadAhead(exceptionSPtr.RawPtr());
+
+    co_return;
+}
+
+ktl::Awaitable<void> RestoreLogRecordsAsyncEnumerator::ReadFileAsync(__in KString const & logFilePath)
+{
+    KShared$ApiEntry();
+
+    KWString backupLogFilePath(GetThisAllocator(), logFilePath);
+    THROW_ON_FAILURE(backupLogFilePath.Status());
+
+    BackupLogFile::SPtr backupLogFileSPtr = BackupLogFile::Create(
+        *PartitionedReplicaIdentifier,
+        backupLogFilePath,
+        GetThisAllocator());
+
+    co_await backupLogFileSPtr->ReadAsync(CancellationToken::None);
+
+    BackupLogFileAsyncEnumerator::SPtr enumeratorSPtr = backupLogFileSPtr->GetAsyncEnumerator();
+
+    SharedException::CSPtr exceptionSPtr = nullptr;
+    try
+    {
+        KSharedArray<LogRecord::SPtr>::SPtr records = nullptr;
+        ULONG64 size = 0;
+        bool isAccepted = true;
+
+        while (isAccepted)
+        {
+            bool hasNext = co_await enumeratorSPtr->MoveNextAsync(CancellationToken::None);
+            if (hasNext == false)
+            {
+                break;
+            }
+
+            if (records == nullptr)
+            {
+                records = _new(RESTORE_LOG_RECORDS_ASYNC_ENUMERATOR_TAG, GetThisAllocator()) KSharedArray<LogRecord::SPtr>();
+                THROW_ON_ALLOCATION_FAILURE(records);
+                THROW_ON_FAILURE(records->Status());
+            }
+
+            LogRecord::SPtr logRecord = enumeratorSPtr->GetCurrent();
+            size += logRecord->RecordSize;
+
+            NTSTATUS status = records->Append(Ktl::Move(logRecord));
+            THROW_ON_FAILURE(status);
+
+            if (size >= BatchSizeInBytes)
+            {
+                isAccepted = co_await PublishBatchAsync(*records, size);
+                records = nullptr;
+                size = 0;
+            }
+        }
+
+        if (isAccepted && records != nullptr)
+        {
+            co_await PublishBatchAsync(*records, size);
+        }
+    }
+    catch (Exception & exception)
+    {
+        exceptionSPtr = SharedException::Create(exception, GetThisAllocator());
+    }
+
+    co_await enumeratorSPtr->CloseAsync();
+
+    if (exceptionSPtr != nullptr)
+    {
+        throw exceptionSPtr->get_Info();
+    }
+
+    co_return;
+}
+
+// Hands a batch to the consumer.
+// Waits while more than readAheadSizeInBytes is buffered. A batch is always accepted when nothing is buffered,
+// so a batch larger than the read ahead size cannot block the restore.
+// Returns false if the enumerator is closing and the batch was dropped.
+ktl::Awaitable<bool> RestoreLogRecordsAsyncEnumerator::PublishBatchAsync(
+    __in KSharedArray<LogRecord::SPtr> & records,
+    __in ULONG64 size)
+{
+    KShared$ApiEntry();
+
+    KSharedArray<LogRecord::SPtr>::SPtr recordsSPtr(&records);
+
+    while (true)
+    {
+        bool isPublished = false;
+        bool isClosing = false;
+        AwaitableCompletionSource<void>::SPtr consumerWaiter = nullptr;
+        AwaitableCompletionSource<void>::SPtr readAheadWaiter = nullptr;
+
+        K_LOCK_BLOCK(lock_)
+        {
+            if (isClosing_)
+            {
+                isClosing = true;
+            }
+            else if (bufferedSize_ == 0 || bufferedSize_ + size <= readAheadSizeInBytes_)
+            {
+                Batch batch;
+                batch.Records = recordsSPtr;
+                batch.Size = size;
+
+                NTSTATUS status = batches_.Append(batch);
+                THROW_ON_FAILURE(status);
+
+                bufferedSize_ += size;
+                isPublished = true;
+
+                consumerWaiter = Ktl::Move(consumerWaiterAcsSPtr_);
+            }
+            else
+            {
+                readAheadWaiterAcsSPtr_ = CompletionTask::CreateAwaitableCompletionSource<void>(RESTORE_LOG_RECORDS_ASYNC_ENUMERATOR_TAG, GetThisAllocator());
+                readAheadWaiter = readAheadWaiterAcsSPtr_;
+            }
+        }
+
+        if (consumerWaiter != nullptr)
+        {
+            consumerWaiter->Set();
+        }
+
+        if (isPublished)
+        {
+            co_return true;
+        }
+
+        if (isClosing)
+        {
+            co_return false;
+        }
+
+        co_await readAheadWaiter->GetAwaitable();
+    }
+}
+
+void RestoreLogRecordsAsyncEnumerator::CompleteReadAhead(__in_opt SharedException const * exception)
+{
+    AwaitableCompletionSource<void>::SPtr consumerWaiter = nullptr;
+
+    K_LOCK_BLOCK(lock_)
+    {
+        isReadAheadCompleted_ = true;
+        readAheadExceptionSPtr_ = exception;
+        consumerWaiter = Ktl::Move(consumerWaiterAcsSPtr_);
+    }
+
+    if (consumerWaiter != nullptr)
+    {
+        consumerWaiter->Set();
+    }
+}
+
+RestoreLogRecordsAsyncEnumerator::RestoreLogRecordsAsyncEnumerator(
+    __in PartitionedReplicaId const & traceId,
+    __in KArray<KString::CSPtr> const & restoreFileArray,
+    __in ULONG64 readAheadSizeInBytes) noexcept
+    : KObject()
+    , KShared()
+    , PartitionedReplicaTraceComponent(traceId)
+    , readAheadSizeInBytes_(readAheadSizeInBytes)
+    , restoreFileArray_(restoreFileArray)
+    , batches_(GetThisAllocator())
+{
+    if (NT_SUCCESS(restoreFileArray_.Status()) == false)
+    {
+        SetConstructorStatus(restoreFileArray_.Status());
+        return;
+    }
+
+    SetConstructorStatus(batches_.Status());
+}
+
+RestoreLogRecordsAsyncEnumerator::~RestoreLogRecordsAsyncEnumerator()
+{
+}
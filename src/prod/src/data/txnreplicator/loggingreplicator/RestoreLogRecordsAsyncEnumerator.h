@@ -0,0 +1,133 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace LoggingReplicator
+    {
+        //
+        // Iterator over the log records of a backup chain, in the order of the restore files.
+        //
+        // Once started, a read ahead task reads and decodes the backup log files in batches of BatchSizeInBytes and
+        // buffers up to readAheadSizeInBytes of log records. Restore starts it before the state manager checkpoint is
+        // restored, so reading the backup logs overlaps with the checkpoint restore and later with writing the log.
+        //
+        // Single consumer. CloseAsync or Dispose must be called once the read ahead was started; Dispose drains the
+        // read ahead in the background and CloseAsync waits for it.
+        //
+        class RestoreLogRecordsAsyncEnumerator final
+            : public KObject<RestoreLogRecordsAsyncEnumerator>
+            , public KShared<RestoreLogRecordsAsyncEnumerator>
+            , public Utilities::IAsyncEnumerator<LogRecordLib::LogRecord::SPtr>
+            , public Utilities::PartitionedReplicaTraceComponent<Common::TraceTaskCodes::LR>
+        {
+            K_FORCE_SHARED(RestoreLogRecordsAsyncEnumerator);
+            K_SHARED_INTERFACE_IMP(IDisposable);
+            K_SHARED_INTERFACE_IMP(IAsyncEnumerator);
+
+        public: // Statics
+            static SPtr Create(
+                __in Utilities::PartitionedReplicaId const & traceId,
+                __in KArray<KString::CSPtr> const & restoreFileArray,
+                __in ULONG64 readAheadSizeInBytes,
+                __in KAllocator & allocator);
+
+        public: // Properties
+            // Number of log records returned so far.
+            __declspec(property(get = get_Count)) ULONG64 Count;
+            ULONG64 get_Count() const;
+
+            // Size of the log records returned so far.
+            __declspec(property(get = get_Size)) ULONG64 Size;
+            ULONG64 get_Size() const;
+
+        public: // IAsyncEnumerator
+            LogRecordLib::LogRecord::SPtr GetCurrent() override;
+
+            ktl::Awaitable<bool> MoveNextAsync(
+                __in ktl::CancellationToken const & cancellationToken) override;
+
+            void Reset() override;
+
+        public: // IDisposable
+            void Dispose() override;
+
+        public:
+            //
+            // Starts reading the backup log files ahead of the consumer.
+            // No-op if the read ahead was already started.
+            //
+            void StartReadAhead();
+
+            //
+            // Stops the read ahead and waits for it to drain.
+            // Can be called more than once, and after Dispose.
+            //
+            ktl::Awaitable<void> CloseAsync();
+
+        private:
+            struct Batch
+            {
+                KSharedArray<LogRecordLib::LogRecord::SPtr>::SPtr Records;
+                ULONG64 Size;
+            };
+
+            ktl::Awaitable<void> ReadAheadAsync();
+
+            ktl::Awaitable<void> ReadFileAsync(__in KString const & logFilePath);
+
+            ktl::Awaitable<bool> PublishBatchAsync(
+                __in KSharedArray<LogRecordLib::LogRecord::SPtr> & records,
+                __in ULONG64 size);
+
+            void CompleteReadAhead(__in_opt Utilities::SharedException const * exception);
+
+            ktl::Task CloseInBackground();
+
+        private: // Constructor
+            RestoreLogRecordsAsyncEnumerator(
+                __in Utilities::PartitionedReplicaId const & traceId,
+                __in KArray<KString::CSPtr> const & restoreFileArray,
+                __in ULONG64 readAheadSizeInBytes) noexcept;
+
+        private: // Static constants
+            static const ULONG64 BatchSizeInBytes = 256 * 1024;
+
+        private: // Initializer list initialized constants.
+            const ULONG64 readAheadSizeInBytes_;
+
+        private: // Constructor initialized
+            KArray<KString::CSPtr> restoreFileArray_;
+
+            // Batches that were read ahead and not yet consumed, protected by lock_.
+            KArray<Batch> batches_;
+
+        private: // Default initialized values
+            KSpinLock lock_;
+            ULONG64 bufferedSize_ = 0;
+            bool isReadAheadStarted_ = false;
+            bool isReadAheadCompleted_ = false;
+            bool isClosing_ = false;
+            Utilities::SharedException::CSPtr readAheadExceptionSPtr_;
+
+            // Set when the consumer waits for a batch or the read ahead waits for buffer space.
+            ktl::AwaitableCompletionSource<void>::SPtr consumerWaiterAcsSPtr_;
+            ktl::AwaitableCompletionSource<void>::SPtr readAheadWaiterAcsSPtr_;
+
+            // Set by the first close once the read ahead is drained.
+            ktl::AwaitableCompletionSource<void>::SPtr closeAcsSPtr_;
+
+            ktl::Awaitable<void> readAheadAwaitable_;
+
+            // Consumer state.
+            KSharedArray<LogRecordLib::LogRecord::SPtr>::SPtr currentBatchSPtr_;
+            ULONG32 currentIndex_ = 0;
+            ULONG64 count_ = 0;
+            ULONG64 size_ = 0;
+        };
+    }
+}
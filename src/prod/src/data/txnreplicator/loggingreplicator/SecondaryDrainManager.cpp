@@ -65,6 +65,7 @@ SecondaryDrainManager::SecondaryDrainManager(
     , roleContextDrainState_(&roleContextDrainState)
     , recordsProcessor_(&recordsProcessor)
     , copiedUptoLsn_(Constants::InvalidLsn)
+    , copyCompressionCodec_(CompressionCodecId::None)
     , invalidLogRecords_(&invalidLogRecords)
     , recoveredOrCopiedCheckpointState_(&recoveredOrCopiedCheckpointState)
     , readConsistentAfterLsn_(Constants::InvalidLsn)
@@ -338,6 +339,14 @@ Awaitable<NTSTATUS> SecondaryDrainManager::CopyOrBuildReplicaAsync(
 
     CopyHeader::SPtr copyHeader = CopyHeader::Deserialize(*(operation->Data), GetThisAllocator());
 
+    copyCompressionCodec_ = copyHeader->CompressionCodec;
+
+    ASSERT_IFNOT(
+        copyCompressionCodec_ == CompressionCodecId::None || replicatedLogManager_->Compressor != nullptr,
+        "{0}: Primary negotiated copy compression codec {1} without a compressor",
+        TraceId,
+        static_cast<ULONG32>(copyCompressionCodec_));
+
     operation->Acknowledge();
 
     if (copyHeader->CopyStageValue == CopyStage::Enum::CopyNone)
@@ -553,6 +562,11 @@ Awaitable<NTSTATUS> SecondaryDrainManager::DrainCopyStreamAsync(
         {
             OperationData::CSPtr data = operationPtr->Data;
 
+            if (copyCompressionCodec_ != CompressionCodecId::None)
+            {
+                data = replicatedLogManager_->Compressor->Decompress(*data);
+            }
+
 #ifdef DBG
             ReplicatedLogManager::ValidateOperationData(*data);
 #endif
@@ -820,6 +834,17 @@ Awaitable<NTSTATUS> SecondaryDrainManager::DrainReplicationStreamAsync(__in IOpe
         if (operation != nullptr)
         {
             OperationData::CSPtr data = operation->Data;
+
+            if (ReplicationCompressor::IsCompressed(*data))
+            {
+                ASSERT_IFNOT(
+                    replicatedLogManager_->Compressor != nullptr,
+                    "{0}: Received a compressed replication operation without a compressor",
+                    TraceId);
+
+                data = replicatedLogManager_->Compressor->Decompress(*data);
+            }
+
 #ifdef DBG
             ReplicatedLogManager::ValidateOperationData(*data);
 #endif
@@ -1015,6 +1040,11 @@ Awaitable<NTSTATUS> SecondaryDrainManager::DrainStateStreamAsync(
 
         if (copyStage == CopyStage::Enum::CopyState)
         {
+            if (copyCompressionCodec_ != CompressionCodecId::None)
+            {
+                data = replicatedLogManager_->Compressor->Decompress(*data);
+            }
+
             KArray<KBuffer::CSPtr> buffers(GetThisAllocator());
 
             CO_RETURN_ON_FAILURE(buffers.Status());
@@ -155,6 +155,9 @@ namespace Data
             OperationProcessor::SPtr const recordsProcessor_;
             LONG64 copiedUptoLsn_;
 
+            // Codec the primary compresses state and log copy operations with, from the copy header of the current build
+            Utilities::CompressionCodecId::Enum copyCompressionCodec_;
+
             LogRecordLib::InvalidLogRecords::SPtr const invalidLogRecords_;
 
             RecoveredOrCopiedCheckpointState::SPtr const recoveredOrCopiedCheckpointState_;
@@ -635,6 +635,7 @@ CopyContext::SPtr TestReplica::CreateACopyContext(
         *expectedLogHeadRecord,
         logTailLsn,
         latestRecoveredAtomicRedoOperationLsn,
+        ReplicationCompressor::GetSupportedCodecs(),
         allocator);
 }
 
@@ -32,6 +32,7 @@ namespace LoggingReplicatorTests
         BeginTransactionOperationLogRecord::SPtr CreateBeginTx(__in Transaction & transaction, __in LONG64 lsn, __in bool isSingleOperationTx);
         OperationLogRecord::SPtr CreateOperation(__in Transaction & transaction, __in LONG64 lsn);
         EndTransactionLogRecord::SPtr CreateEndTx(__in Transaction & transaction, __in bool isCommitted, __in LONG64 lsn);
+        LONG64 MeasureContention(__in ULONG threadCount, __in ULONG txPerThread, __in KAllocator & allocator);
 
         Common::CommonConfig config; // load the config object as its needed for the tracing to work
         ::FABRIC_REPLICA_ID rId_;
@@ -48,9 +49,25 @@ namespace LoggingReplicatorTests
 
     void TransactionMapTest::VerifyPendingTxStats(__in TransactionMap & map, __in ULONG expected)
     {
-        VERIFY_ARE_EQUAL(map.latestRecords_.size(), expected);
-        VERIFY_ARE_EQUAL(map.lsnPendingTransactions_.size(), expected);
-        VERIFY_ARE_EQUAL(map.transactionIdPendingTransactionsPair_.size(), expected);
+        ULONG latestRecordsCount = 0;
+        ULONG lsnPendingTransactionsCount = 0;
+        ULONG transactionIdPendingTransactionsPairCount = 0;
+
+        for (ULONG i = 0; i < TransactionMap::ShardCount; i++)
+        {
+            TransactionMap::Shard & shard = map.shards_[i];
+
+            latestRecordsCount += static_cast<ULONG>(shard.latestRecords.size());
+            lsnPendingTransactionsCount += static_cast<ULONG>(shard.lsnPendingTransactions.size());
+            transactionIdPendingTransactionsPairCount += static_cast<ULONG>(shard.transactionIdPendingTransactionsPair.size());
+
+            LONG64 expectedEarliestPendingLsn = shard.lsnPendingTransactions.empty() ? MAXLONG64 : shard.lsnPendingTransactions.begin()->first.value;
+            VERIFY_ARE_EQUAL(shard.earliestPendingLsn, expectedEarliestPendingLsn);
+        }
+
+        VERIFY_ARE_EQUAL(latestRecordsCount, expected);
+        VERIFY_ARE_EQUAL(lsnPendingTransactionsCount, expected);
+        VERIFY_ARE_EQUAL(transactionIdPendingTransactionsPairCount, expected);
     }
 
     void TransactionMapTest::VerifyCompletedTxStats(__in TransactionMap & map, __in ULONG expected)
@@ -136,6 +153,66 @@ namespace LoggingReplicatorTests
         return endTxLog;
     }
 
+    //
+    // Each thread runs its own transactions through create, two operations and complete, the way concurrent transactions on a primary do.
+    // All records are created up front so that only the map operations are timed. Returns the number of map operations per second.
+    //
+    LONG64 TransactionMapTest::MeasureContention(__in ULONG threadCount, __in ULONG txPerThread, __in KAllocator & allocator)
+    {
+        TransactionMap::SPtr map = TransactionMap::Create(*prId_, allocator);
+        LONG64 lsn = 2;
+
+        vector<vector<TransactionLogRecord::SPtr>> threadRecords(threadCount);
+        for (ULONG i = 0; i < txPerThread; i++)
+        {
+            for (ULONG t = 0; t < threadCount; t++)
+            {
+                TestTransaction::SPtr transaction = TestTransaction::Create(*invalidLogRecords_, 1, 1, false, STATUS_SUCCESS, allocator);
+                threadRecords[t].push_back(CreateBeginTx(*transaction->Tx, lsn++, false).RawPtr());
+                threadRecords[t].push_back(CreateOperation(*transaction->Tx, lsn++).RawPtr());
+                threadRecords[t].push_back(CreateOperation(*transaction->Tx, lsn++).RawPtr());
+                threadRecords[t].push_back(CreateEndTx(*transaction->Tx, true, lsn++).RawPtr());
+            }
+        }
+
+        Common::atomic_long completedCount(0);
+        Stopwatch stopwatch;
+        stopwatch.Start();
+
+        for (ULONG t = 0; t < threadCount; t++)
+        {
+            vector<TransactionLogRecord::SPtr> & records = threadRecords[t];
+
+            Threadpool::Post([&map, &records, &completedCount]
+            {
+                for (size_t i = 0; i < records.size(); i += 4)
+                {
+                    map->CreateTransaction(dynamic_cast<BeginTransactionOperationLogRecord &>(*records[i]));
+                    map->AddOperation(dynamic_cast<OperationLogRecord &>(*records[i + 1]));
+                    map->AddOperation(dynamic_cast<OperationLogRecord &>(*records[i + 2]));
+                    map->CompleteTransaction(dynamic_cast<EndTransactionLogRecord &>(*records[i + 3]));
+                }
+
+                ++completedCount;
+            });
+        }
+
+        while (completedCount.load() < static_cast<LONG>(threadCount))
+        {
+            Sleep(1);
+        }
+
+        stopwatch.Stop();
+
+        VerifyPendingTxStats(*map, 0);
+        VerifyCompletedTxStats(*map, threadCount * txPerThread);
+
+        map->RemoveStableTransactions(lsn);
+
+        LONG64 duration = stopwatch.ElapsedMilliseconds == 0 ? 1 : stopwatch.ElapsedMilliseconds;
+        return (static_cast<LONG64>(threadCount) * txPerThread * 4 * 1000) / duration;
+    }
+
     BOOST_FIXTURE_TEST_SUITE(TransactionMapTestSuite, TransactionMapTest)
 
     BOOST_AUTO_TEST_CASE(TxMap_VerifyChainOfTransactions_1OpTx)
@@ -399,6 +476,32 @@ namespace LoggingReplicatorTests
         }
     }
 
+    BOOST_AUTO_TEST_CASE(TxMap_ConcurrentTransactions_Contention)
+    {
+        TEST_TRACE_BEGIN("TxMap_ConcurrentTransactions_Contention")
+
+        {
+            invalidLogRecords_ = InvalidLogRecords::Create(allocator);
+
+            ULONG txPerThread = 2000;
+            ULONG maxThreadCount = 2 * Environment::GetNumberOfProcessors();
+
+            for (ULONG threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+            {
+                LONG64 opsPerSecond = MeasureContention(threadCount, txPerThread, allocator);
+
+                Trace.WriteInfo(
+                    TraceComponent,
+                    "TxMap_ConcurrentTransactions_Contention: Threads: {0} Transactions: {1} Throughput: {2} ops/sec",
+                    threadCount,
+                    threadCount * txPerThread,
+                    opsPerSecond);
+            }
+
+            invalidLogRecords_.Reset();
+        }
+    }
+
     // TODO: Add false progress API test cases in the future
 
     BOOST_AUTO_TEST_SUITE_END()
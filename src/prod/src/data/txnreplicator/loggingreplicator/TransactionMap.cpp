@@ -14,11 +14,8 @@ TransactionMap::TransactionMap(__in Data::Utilities::PartitionedReplicaId const
     : KObject()
     , KShared()
     , PartitionedReplicaTraceComponent(traceId)
-    , lock_()
+    , unstableTransactionsLock_()
     , completedTransactions_(GetThisAllocator())
-    , latestRecords_()
-    , lsnPendingTransactions_()
-    , transactionIdPendingTransactionsPair_()
     , unstableTransactions_(GetThisAllocator())
 {
     EventSource::Events->Ctor(
@@ -49,13 +46,45 @@ TransactionMap::SPtr TransactionMap::Create(
     return TransactionMap::SPtr(pointer);
 }
 
+TransactionMap::Shard::Shard()
+    : lock()
+    , latestRecords()
+    , lsnPendingTransactions()
+    , transactionIdPendingTransactionsPair()
+    , earliestPendingLsn(MAXLONG64)
+{
+}
+
+void TransactionMap::Shard::Clear()
+{
+    latestRecords.clear();
+    transactionIdPendingTransactionsPair.clear();
+    lsnPendingTransactions.clear();
+    earliestPendingLsn = MAXLONG64;
+}
+
+void TransactionMap::Shard::UpdateEarliestPendingLsnCallerHoldsLock()
+{
+    auto lowestLsnIterator = lsnPendingTransactions.begin();
+    LONG64 lsn = lowestLsnIterator == lsnPendingTransactions.end() ? MAXLONG64 : lowestLsnIterator->first.value;
+
+    InterlockedExchange64(&earliestPendingLsn, lsn);
+}
+
+TransactionMap::Shard & TransactionMap::GetShard(__in LONG64 transactionId)
+{
+    return shards_[static_cast<ULONG64>(transactionId) % ShardCount];
+}
+
 void TransactionMap::Reuse()
 {
-    latestRecords_.clear();
-    transactionIdPendingTransactionsPair_.clear();
+    for (ULONG i = 0; i < ShardCount; i++)
+    {
+        shards_[i].Clear();
+    }
+
     completedTransactions_.Clear();
     unstableTransactions_.Clear();
-    lsnPendingTransactions_.clear();
 }
 
 void TransactionMap::AddOperation(__in OperationLogRecord & record)
@@ -71,13 +100,15 @@ void TransactionMap::AddOperation(__in OperationLogRecord & record)
         OperationLogRecord::SPtr recordSPtr = &record;
         TransactionLogRecord::SPtr upcastedRecord = recordSPtr.RawPtr();
 
-        K_LOCK_BLOCK(lock_)
+        LONG64 txId = record.BaseTransaction.TransactionId;
+        Shard & shard = GetShard(txId);
+
+        K_LOCK_BLOCK(shard.lock)
         {
-            LONG64 txId = record.BaseTransaction.TransactionId;
             TransactionLogRecord::SPtr keyFound = nullptr;
-            auto keyFoundIter = latestRecords_.find(txId);
+            auto keyFoundIter = shard.latestRecords.find(txId);
 
-            if (keyFoundIter != latestRecords_.end())
+            if (keyFoundIter != shard.latestRecords.end())
             {
                 keyFound = keyFoundIter->second;
                 ASSERT_IF(keyFound == nullptr, "Log record not found during add op for xactid: {0}", txId);
@@ -85,12 +116,12 @@ void TransactionMap::AddOperation(__in OperationLogRecord & record)
                 record.IsEnlistedTransaction = keyFound->IsEnlistedTransaction;
                 record.ParentTransactionRecord = keyFound.RawPtr();
                 keyFound->ChildTransactionRecord = record;
-                latestRecords_[txId] = upcastedRecord;
+                keyFoundIter->second = upcastedRecord;
                 
                 return;
             }
             
-            latestRecords_[txId] = upcastedRecord;
+            shard.latestRecords[txId] = upcastedRecord;
         }
 
         ASSERT_IFNOT(!record.IsEnlistedTransaction, "Unexpected enlisted xact found during add op");
@@ -103,13 +134,15 @@ void TransactionMap::CompleteTransaction(__in EndTransactionLogRecord & record)
 {
     ASSERT_IFNOT(!record.BaseTransaction.IsAtomicOperation, "Unexpected atomic op xact during complete xact");
 
-    K_LOCK_BLOCK(lock_)
+    LONG64 txId = record.BaseTransaction.TransactionId;
+    Shard & shard = GetShard(txId);
+
+    K_LOCK_BLOCK(shard.lock)
     {
-        LONG64 txId = record.BaseTransaction.TransactionId;
         TransactionLogRecord::SPtr keyFound = nullptr;
-        auto keyFoundIter = latestRecords_.find(txId);
+        auto keyFoundIter = shard.latestRecords.find(txId);
 
-        if (keyFoundIter != latestRecords_.end())
+        if (keyFoundIter != shard.latestRecords.end())
         {
             keyFound = keyFoundIter->second;
             ASSERT_IF(keyFound == nullptr, "Log record not found during complete xact for xactid: {0}", txId);
@@ -117,7 +150,7 @@ void TransactionMap::CompleteTransaction(__in EndTransactionLogRecord & record)
             record.IsEnlistedTransaction = keyFound->IsEnlistedTransaction;
             record.ParentTransactionRecord = keyFound.RawPtr();
             keyFound->ChildTransactionRecord = record;
-            latestRecords_.erase(txId);
+            shard.latestRecords.erase(keyFoundIter);
         }
         else
         {
@@ -126,16 +159,17 @@ void TransactionMap::CompleteTransaction(__in EndTransactionLogRecord & record)
         }
 
         BeginTransactionOperationLogRecord::SPtr beginTransactionRecord = nullptr;
-        auto txIdFoundIter = transactionIdPendingTransactionsPair_.find(txId);
+        auto txIdFoundIter = shard.transactionIdPendingTransactionsPair.find(txId);
 
-        if (txIdFoundIter != transactionIdPendingTransactionsPair_.end())
+        if (txIdFoundIter != shard.transactionIdPendingTransactionsPair.end())
         {
             beginTransactionRecord = txIdFoundIter->second;
             ASSERT_IFNOT(beginTransactionRecord != nullptr, "Could not find begin xact log record: {0}", txId);
 
-            auto elementsErased = lsnPendingTransactions_.erase(LsnKeyType(beginTransactionRecord->Lsn));
+            auto elementsErased = shard.lsnPendingTransactions.erase(LsnKeyType(beginTransactionRecord->Lsn));
             ASSERT_IFNOT(elementsErased == 1, "Could not remove lsn from pending list: {0} {1}", beginTransactionRecord->Lsn, elementsErased);
-            transactionIdPendingTransactionsPair_.erase(txId);
+            shard.transactionIdPendingTransactionsPair.erase(txIdFoundIter);
+            shard.UpdateEarliestPendingLsnCallerHoldsLock();
         }
 
         ASSERT_IFNOT(
@@ -144,7 +178,11 @@ void TransactionMap::CompleteTransaction(__in EndTransactionLogRecord & record)
 
         if (beginTransactionRecord != nullptr)
         {
-            AddUnstableTransactionCallerHoldsLock(*beginTransactionRecord, record);
+            // Moved to the unstable transactions while the shard lock is still held, so the transaction is always in one of the two
+            K_LOCK_BLOCK(unstableTransactionsLock_)
+            {
+                AddUnstableTransactionCallerHoldsLock(*beginTransactionRecord, record);
+            }
         }
     }
 }
@@ -160,25 +198,28 @@ void TransactionMap::CreateTransaction(__in BeginTransactionOperationLogRecord &
     }
     else
     {
-        K_LOCK_BLOCK(lock_)
+        LONG64 txId = record.BaseTransaction.TransactionId;
+        Shard & shard = GetShard(txId);
+
+        K_LOCK_BLOCK(shard.lock)
         {
-            LONG64 txId = record.BaseTransaction.TransactionId;
             BeginTransactionOperationLogRecord::SPtr recordSPtr = &record;
             TransactionLogRecord::SPtr upcastedRecord = recordSPtr.RawPtr();
 
-            latestRecords_[txId] = upcastedRecord;
+            shard.latestRecords[txId] = upcastedRecord;
             record.IsEnlistedTransaction = true;
 
-            transactionIdPendingTransactionsPair_[txId] = recordSPtr;
+            shard.transactionIdPendingTransactionsPair[txId] = recordSPtr;
             
-            lsnPendingTransactions_[LsnKeyType(record.Lsn)] = recordSPtr;
+            shard.lsnPendingTransactions[LsnKeyType(record.Lsn)] = recordSPtr;
+            shard.UpdateEarliestPendingLsnCallerHoldsLock();
         }
     }
 }
 
 void TransactionMap::RemoveStableTransactions(__in LONG64 lastStableLsn)
 {
-    K_LOCK_BLOCK(lock_)
+    K_LOCK_BLOCK(unstableTransactionsLock_)
     {
         for (LONG i = unstableTransactions_.Count() - 1; i >= 0; i--)
         {
@@ -273,29 +314,31 @@ BeginTransactionOperationLogRecord::SPtr TransactionMap::DeleteTransaction(__in
         return recordSPtr;
     }
 
-    K_LOCK_BLOCK(lock_)
-    {
-        LONG64 txId = recordSPtr->BaseTransaction.TransactionId;
+    LONG64 txId = recordSPtr->BaseTransaction.TransactionId;
+    Shard & shard = GetShard(txId);
 
-        ASSERT_IFNOT(latestRecords_.count(txId) > 0, "Transaction log record not found in latest records");
-        ASSERT_IFNOT(transactionIdPendingTransactionsPair_.count(txId) > 0, "Transaction log record not found in pending transaction pairs");
+    K_LOCK_BLOCK(shard.lock)
+    {
+        ASSERT_IFNOT(shard.latestRecords.count(txId) > 0, "Transaction log record not found in latest records");
+        ASSERT_IFNOT(shard.transactionIdPendingTransactionsPair.count(txId) > 0, "Transaction log record not found in pending transaction pairs");
 
-        TransactionLogRecord::SPtr keyFoundInLatestRecords = latestRecords_[txId];
-        BeginTransactionOperationLogRecord::SPtr keyFoundInPendingTxPair = transactionIdPendingTransactionsPair_[txId];
+        TransactionLogRecord::SPtr keyFoundInLatestRecords = shard.latestRecords[txId];
+        BeginTransactionOperationLogRecord::SPtr keyFoundInPendingTxPair = shard.transactionIdPendingTransactionsPair[txId];
 
         recordSPtr = dynamic_cast<BeginTransactionOperationLogRecord *>(keyFoundInLatestRecords.RawPtr());
         ASSERT_IFNOT(recordSPtr != nullptr, "Invalid begin xact op log record during delete");
 
         ASSERT_IFNOT(recordSPtr.RawPtr() == keyFoundInPendingTxPair.RawPtr(), "Invalid log record"); // TODO: Verify validity of this assert
 
-        latestRecords_.erase(txId);
+        shard.latestRecords.erase(txId);
 
         recordSPtr->IsEnlistedTransaction = true;
 
-        auto elementsErased = lsnPendingTransactions_.erase(LsnKeyType(recordSPtr->Lsn));
+        auto elementsErased = shard.lsnPendingTransactions.erase(LsnKeyType(recordSPtr->Lsn));
         ASSERT_IFNOT(elementsErased == 1, "Could not remove lsn from pending list: {0} {1}", recordSPtr->Lsn, elementsErased)
 
-        transactionIdPendingTransactionsPair_.erase(txId);
+        shard.transactionIdPendingTransactionsPair.erase(txId);
+        shard.UpdateEarliestPendingLsnCallerHoldsLock();
     }
 
     return recordSPtr;
@@ -316,12 +359,14 @@ OperationLogRecord::SPtr TransactionMap::FindOperation(__in OperationLogRecord &
 
     ASSERT_IFNOT(LogRecord::IsInvalid(recordSPtr->ParentTransactionRecord.RawPtr()), "Invalid parent log record in find op");
     
-    K_LOCK_BLOCK(lock_)
+    LONG64 txId = recordSPtr->BaseTransaction.TransactionId;
+    Shard & shard = GetShard(txId);
+
+    K_LOCK_BLOCK(shard.lock)
     {
-        LONG64 txId = recordSPtr->BaseTransaction.TransactionId;
-        ASSERT_IFNOT(latestRecords_.count(txId) > 0, "Transaction log record not found in latest records during find");
+        ASSERT_IFNOT(shard.latestRecords.count(txId) > 0, "Transaction log record not found in latest records during find");
 
-        TransactionLogRecord::SPtr keyFoundInLatestRecords = latestRecords_[txId];
+        TransactionLogRecord::SPtr keyFoundInLatestRecords = shard.latestRecords[txId];
 
         recordSPtr = dynamic_cast<OperationLogRecord *>(keyFoundInLatestRecords.RawPtr());
         ASSERT_IFNOT(recordSPtr != nullptr, "Invalid op log record in find op");
@@ -343,12 +388,14 @@ BeginTransactionOperationLogRecord::SPtr TransactionMap::FindTransaction(__in Be
         return recordSPtr;
     }
 
-    K_LOCK_BLOCK(lock_)
+    LONG64 txId = recordSPtr->BaseTransaction.TransactionId;
+    Shard & shard = GetShard(txId);
+
+    K_LOCK_BLOCK(shard.lock)
     {
-        LONG64 txId = recordSPtr->BaseTransaction.TransactionId;
-        ASSERT_IFNOT(latestRecords_.count(txId) > 0, "Transaction log record not found in latest records during find");
+        ASSERT_IFNOT(shard.latestRecords.count(txId) > 0, "Transaction log record not found in latest records during find");
 
-        TransactionLogRecord::SPtr keyFoundInLatestRecords = latestRecords_[txId];
+        TransactionLogRecord::SPtr keyFoundInLatestRecords = shard.latestRecords[txId];
 
         recordSPtr = dynamic_cast<BeginTransactionOperationLogRecord *>(keyFoundInLatestRecords.RawPtr());
         ASSERT_IFNOT(recordSPtr != nullptr, "Invalid begin xact op log record in find xact");
@@ -366,7 +413,7 @@ EndTransactionLogRecord::SPtr TransactionMap::FindUnstableTransaction(__in EndTr
     
     LONG i = 0;
 
-    K_LOCK_BLOCK(lock_)
+    K_LOCK_BLOCK(unstableTransactionsLock_)
     {
         for (i = unstableTransactions_.Count() - 1; i >= 0; i--)
         {
@@ -393,57 +440,103 @@ BeginTransactionOperationLogRecord::SPtr TransactionMap::GetEarliestPendingTrans
     __in LONG64 barrierLsn,
     __out bool & failedBarrierCheck)
 {
-    K_LOCK_BLOCK(lock_)
+    // Read before the barrier check. A transaction that completes in between is then seen as unstable and fails the check
+    BeginTransactionOperationLogRecord::SPtr result = FindEarliestPendingTransaction();
+
+    K_LOCK_BLOCK(unstableTransactionsLock_)
     {
-        if (unstableTransactions_.Count() == 0 ||
-            unstableTransactions_[unstableTransactions_.Count() - 1]->Lsn <= barrierLsn)
+        if (unstableTransactions_.Count() != 0 &&
+            unstableTransactions_[unstableTransactions_.Count() - 1]->Lsn > barrierLsn)
         {
-            failedBarrierCheck = false;
+            failedBarrierCheck = true;
+            return nullptr;
+        }
+    }
+
+    failedBarrierCheck = false;
 
-            auto lowestLsnIterator = lsnPendingTransactions_.begin();
-            if (lowestLsnIterator != lsnPendingTransactions_.end())
+    if (result != nullptr && result->Lsn < barrierLsn)
+    {
+        return result;
+    }
+
+    return nullptr;
+}
+
+BeginTransactionOperationLogRecord::SPtr TransactionMap::FindEarliestPendingTransaction()
+{
+    for (;;)
+    {
+        // Pick the shard with the lowest pending lsn without taking any lock
+        LONG64 earliestLsn = MAXLONG64;
+        ULONG earliestShardIndex = ShardCount;
+
+        for (ULONG i = 0; i < ShardCount; i++)
+        {
+            LONG64 lsn = shards_[i].earliestPendingLsn;
+            if (lsn < earliestLsn)
             {
-                LsnKeyType lsn = lowestLsnIterator->first;
-                if (lsn.value < barrierLsn)
-                {
-                    BeginTransactionOperationLogRecord::SPtr result = lowestLsnIterator->second;
-                    return result;
-                }
+                earliestLsn = lsn;
+                earliestShardIndex = i;
             }
+        }
 
+        if (earliestShardIndex == ShardCount)
+        {
             return nullptr;
         }
 
-        failedBarrierCheck = true;
-    }
+        Shard & shard = shards_[earliestShardIndex];
 
-    return nullptr;
+        K_LOCK_BLOCK(shard.lock)
+        {
+            auto lowestLsnIterator = shard.lsnPendingTransactions.begin();
+            if (lowestLsnIterator != shard.lsnPendingTransactions.end() &&
+                lowestLsnIterator->first.value == earliestLsn)
+            {
+                BeginTransactionOperationLogRecord::SPtr result = lowestLsnIterator->second;
+                return result;
+            }
+        }
+
+        // The transaction completed after its shard was picked. Look again
+    }
 }
 
 void TransactionMap::GetPendingRecords(__out KArray<TransactionLogRecord::SPtr> & pendingRecords)
 {
-    K_LOCK_BLOCK(lock_)
+    for (ULONG i = 0; i < ShardCount; i++)
     {
-        NTSTATUS status;
+        Shard & shard = shards_[i];
 
-        for (auto const & pair : latestRecords_)
+        K_LOCK_BLOCK(shard.lock)
         {
-            status = pendingRecords.Append(pair.second);
-            THROW_ON_FAILURE(status);
+            NTSTATUS status;
+
+            for (auto const & pair : shard.latestRecords)
+            {
+                status = pendingRecords.Append(pair.second);
+                THROW_ON_FAILURE(status);
+            }
         }
     }
 }
 
 void TransactionMap::GetPendingTransactions(__out KArray<BeginTransactionOperationLogRecord::SPtr> & pendingTransactions)
 {
-    K_LOCK_BLOCK(lock_)
+    for (ULONG i = 0; i < ShardCount; i++)
     {
-        NTSTATUS status;
+        Shard & shard = shards_[i];
 
-        for (auto const & pair : transactionIdPendingTransactionsPair_)
+        K_LOCK_BLOCK(shard.lock)
         {
-            status = pendingTransactions.Append(pair.second);
-            THROW_ON_FAILURE(status);
+            NTSTATUS status;
+
+            for (auto const & pair : shard.transactionIdPendingTransactionsPair)
+            {
+                status = pendingTransactions.Append(pair.second);
+                THROW_ON_FAILURE(status);
+            }
         }
     }
 }
@@ -452,16 +545,33 @@ void TransactionMap::GetPendingTransactionsOlderThanPosition(
     __in ULONG64 recordPosition,
     __out KArray<BeginTransactionOperationLogRecord::SPtr> & pendingTransactions)
 {
-    K_LOCK_BLOCK(lock_)
+    // Usually no transaction is old enough, which is answered by the earliest pending one alone
+    BeginTransactionOperationLogRecord::SPtr earliestPendingTransaction = FindEarliestPendingTransaction();
+    if (earliestPendingTransaction == nullptr || earliestPendingTransaction->RecordPosition > recordPosition)
+    {
+        return;
+    }
+
+    for (ULONG i = 0; i < ShardCount; i++)
     {
-        NTSTATUS status;
+        Shard & shard = shards_[i];
+
+        if (shard.earliestPendingLsn == MAXLONG64)
+        {
+            continue;
+        }
 
-        for (auto lsnIterator = lsnPendingTransactions_.begin(); lsnIterator != lsnPendingTransactions_.end(); lsnIterator++)
+        K_LOCK_BLOCK(shard.lock)
         {
-            if (lsnIterator->second->RecordPosition <= recordPosition)
+            NTSTATUS status;
+
+            for (auto lsnIterator = shard.lsnPendingTransactions.begin(); lsnIterator != shard.lsnPendingTransactions.end(); lsnIterator++)
             {
-                status = pendingTransactions.Append(lsnIterator->second);
-                THROW_ON_FAILURE(status);
+                if (lsnIterator->second->RecordPosition <= recordPosition)
+                {
+                    status = pendingTransactions.Append(lsnIterator->second);
+                    THROW_ON_FAILURE(status);
+                }
             }
         }
     }
@@ -484,18 +594,20 @@ OperationLogRecord::SPtr TransactionMap::RedactOperation(
 
     ASSERT_IFNOT(LogRecord::IsInvalid(recordSPtr->ParentTransactionRecord.RawPtr()), "Invalid parent log record during redact");
     
-    K_LOCK_BLOCK(lock_)
+    LONG64 txId = recordSPtr->BaseTransaction.TransactionId;
+    Shard & shard = GetShard(txId);
+
+    K_LOCK_BLOCK(shard.lock)
     {
-        LONG64 txId = recordSPtr->BaseTransaction.TransactionId;
-        ASSERT_IFNOT(latestRecords_.count(txId) > 0, "Transaction log record not found in redact operation");
+        ASSERT_IFNOT(shard.latestRecords.count(txId) > 0, "Transaction log record not found in redact operation");
 
-        TransactionLogRecord::SPtr keyFoundInLatestRecords = latestRecords_[txId];
+        TransactionLogRecord::SPtr keyFoundInLatestRecords = shard.latestRecords[txId];
 
         recordSPtr = dynamic_cast<OperationLogRecord *>(keyFoundInLatestRecords.RawPtr());
         ASSERT_IFNOT(recordSPtr != nullptr, "Invalid op log record during redact");
 
         TransactionLogRecord::SPtr parentRecord = recordSPtr->ParentTransactionRecord;
-        latestRecords_[txId] = parentRecord;
+        shard.latestRecords[txId] = parentRecord;
         parentRecord->ChildTransactionRecord = invalidTransactionLogRecord;
     }
 
@@ -513,40 +625,44 @@ EndTransactionLogRecord::SPtr TransactionMap::ReifyTransaction(
     EndTransactionLogRecord::SPtr reifiedEndTransactionRecord = nullptr;
 
     LONG i;
+    LONG64 txId = record.BaseTransaction.TransactionId;
+    Shard & shard = GetShard(txId);
 
-    K_LOCK_BLOCK(lock_)
+    K_LOCK_BLOCK(shard.lock)
     {
-        for (i = completedTransactions_.Count() - 1; i >= 0; i--)
+        K_LOCK_BLOCK(unstableTransactionsLock_)
         {
-            if (completedTransactions_[i]->BaseTransaction == record.BaseTransaction)
+            for (i = completedTransactions_.Count() - 1; i >= 0; i--)
             {
-                reifiedBeginTransactionRecord = completedTransactions_[i];
+                if (completedTransactions_[i]->BaseTransaction == record.BaseTransaction)
+                {
+                    reifiedBeginTransactionRecord = completedTransactions_[i];
 
-                ASSERT_IFNOT(!reifiedBeginTransactionRecord->IsSingleOperationTransaction, "Unexpected single op xact");
+                    ASSERT_IFNOT(!reifiedBeginTransactionRecord->IsSingleOperationTransaction, "Unexpected single op xact");
 
-                completedTransactions_.Remove(i);
-                break;
+                    completedTransactions_.Remove(i);
+                    break;
+                }
             }
-        }
 
-        ASSERT_IFNOT(i >= 0, "Begin xact record is not present in completed xacts");
+            ASSERT_IFNOT(i >= 0, "Begin xact record is not present in completed xacts");
 
-        for (i = unstableTransactions_.Count() - 1; i >= 0; i--)
-        {
-            if (unstableTransactions_[i]->BaseTransaction == record.BaseTransaction)
+            for (i = unstableTransactions_.Count() - 1; i >= 0; i--)
             {
-                reifiedEndTransactionRecord = unstableTransactions_[i];
-                unstableTransactions_.Remove(i);
-                break;
+                if (unstableTransactions_[i]->BaseTransaction == record.BaseTransaction)
+                {
+                    reifiedEndTransactionRecord = unstableTransactions_[i];
+                    unstableTransactions_.Remove(i);
+                    break;
+                }
             }
-        }
 
-        ASSERT_IFNOT(i >= 0, "End xact record is not present in unstable xacts");
+            ASSERT_IFNOT(i >= 0, "End xact record is not present in unstable xacts");
+        }
 
-        LONG64 txId = record.BaseTransaction.TransactionId;
         TransactionLogRecord::SPtr parentRecord = reifiedEndTransactionRecord->ParentTransactionRecord;
 
-        latestRecords_[txId] = parentRecord;
+        shard.latestRecords[txId] = parentRecord;
         parentRecord->ChildTransactionRecord = invalidTransactionLogRecord;
         parentRecord = reifiedEndTransactionRecord.RawPtr();
 
@@ -558,8 +674,9 @@ EndTransactionLogRecord::SPtr TransactionMap::ReifyTransaction(
         ASSERT_IFNOT(reifiedBeginTransactionRecord.RawPtr() == parentRecord.RawPtr(), "Invalid refied being xact log record");
         ASSERT_IFNOT(reifiedBeginTransactionRecord->IsEnlistedTransaction, "Non enlisted xact in reified xact record");
 
-        transactionIdPendingTransactionsPair_[txId] = reifiedBeginTransactionRecord;
-        lsnPendingTransactions_[LsnKeyType(reifiedBeginTransactionRecord->Lsn)] = reifiedBeginTransactionRecord;
+        shard.transactionIdPendingTransactionsPair[txId] = reifiedBeginTransactionRecord;
+        shard.lsnPendingTransactions[LsnKeyType(reifiedBeginTransactionRecord->Lsn)] = reifiedBeginTransactionRecord;
+        shard.UpdateEarliestPendingLsnCallerHoldsLock();
     }
 
     return reifiedEndTransactionRecord;
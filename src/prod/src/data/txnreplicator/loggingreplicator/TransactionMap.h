@@ -13,6 +13,9 @@ namespace Data
         // Maintains state of pending/unstable transactions which are used to link new operations on existing transactions and also
         // to find oldest transaction during checkpoints
         //
+        // Pending transaction state is sharded by transaction id. Each shard publishes the lsn of its earliest pending transaction,
+        // so the earliest pending transaction of the map is found by locking a single shard.
+        //
         class TransactionMap final
             : public KObject<TransactionMap>
             , public KShared<TransactionMap>
@@ -85,11 +88,16 @@ namespace Data
 
         private:
 
+            // Pending transactions are spread over shards by transaction id, so that operations on different transactions do not contend on one lock
+            static const ULONG ShardCount = 16;
+
             TransactionMap(__in Data::Utilities::PartitionedReplicaId const & traceId);
             
             void AddUnstableTransactionCallerHoldsLock(
                 __in LogRecordLib::BeginTransactionOperationLogRecord & beginTransactionRecord,
                 __in LogRecordLib::EndTransactionLogRecord & endTransactionRecord);
+
+            LogRecordLib::BeginTransactionOperationLogRecord::SPtr FindEarliestPendingTransaction();
             
             struct LsnKeyType
             {
@@ -109,16 +117,36 @@ namespace Data
                 }
             };
 
-            KSpinLock lock_;
+            struct Shard
+            {
+                Shard();
+
+                void Clear();
 
-            KArray<LogRecordLib::BeginTransactionOperationLogRecord::SPtr> completedTransactions_;
+                // Must be called after lsnPendingTransactions changes
+                void UpdateEarliestPendingLsnCallerHoldsLock();
 
-            std::unordered_map<LONG64, LogRecordLib::TransactionLogRecord::SPtr> latestRecords_;
+                KSpinLock lock;
 
-            std::map<LsnKeyType, LogRecordLib::BeginTransactionOperationLogRecord::SPtr, LsnKeyTypeCmp> lsnPendingTransactions_;
-            
-            // needed to quickly find earliest pending tx. Order by lsn
-            std::unordered_map<LONG64, LogRecordLib::BeginTransactionOperationLogRecord::SPtr> transactionIdPendingTransactionsPair_;
+                std::unordered_map<LONG64, LogRecordLib::TransactionLogRecord::SPtr> latestRecords;
+
+                std::map<LsnKeyType, LogRecordLib::BeginTransactionOperationLogRecord::SPtr, LsnKeyTypeCmp> lsnPendingTransactions;
+
+                std::unordered_map<LONG64, LogRecordLib::BeginTransactionOperationLogRecord::SPtr> transactionIdPendingTransactionsPair;
+
+                // Lsn of the first entry in lsnPendingTransactions or MAXLONG64 if there is none.
+                // Written under the shard lock and read without it to find the earliest pending transaction
+                volatile LONG64 earliestPendingLsn;
+            };
+
+            Shard & GetShard(__in LONG64 transactionId);
+
+            Shard shards_[ShardCount];
+
+            // Protects completedTransactions_ and unstableTransactions_. When a shard lock is needed too, it is acquired first
+            KSpinLock unstableTransactionsLock_;
+
+            KArray<LogRecordLib::BeginTransactionOperationLogRecord::SPtr> completedTransactions_;
 
             // lsn ordered
             KArray<LogRecordLib::EndTransactionLogRecord::SPtr> unstableTransactions_;
@@ -16,6 +16,7 @@
 #define LOGRECORDS_DISPATCHER_TAG 'DgoL'
 #define PHYSICALLOGWRITER_TAG 'WyhP'
 #define PHYSICALLOGWRITERCALLBACKMGR_TAG 'CyhP'
+#define ADAPTIVEFLUSHSCHEDULER_TAG 'SlfA'
 #define OPERATIONPROCESSOR_TAG 'rPpO'
 #define REPLICATEDLOGMANAGER_TAG 'LpeR'
 #define TXMAP_TAG 'paMT'
@@ -28,6 +29,7 @@
 #define V1REPLICATOR_TAG 'LPER'
 #define TRUNCATETAILMANAGER_TAG 'MtrT'
 #define SECONDARYDRAINMANAGER_TAG 'MrDS'
+#define REPLICATIONCOMPRESSOR_TAG 'pmCR'
 
 #define VERSION_MANAGER_TAG 'rgMV'
 #define NOTIFICATION_KEY_TAG 'yeKN'
@@ -39,7 +41,9 @@
 #define BACKUP_LOG_FILE_PROPERTIES_TAG 'pfLB' // BackupLogFilePropeRties 
 #define BACKUP_LOG_FILE_TAG 'ifLB' // BackupLogFIle 
 #define BACKUP_LOG_FILE_ASYNC_ENUMERATOR_TAG 'eaLB' // BackupLogfileAsyncEnumerator
+#define BACKUP_LOG_CHUNK_INDEX_TAG 'icLB' // BackupLogChunkIndex
 #define INCREMENTAL_BACKUP_LOG_RECORDS_ASYNC_ENUMERATOR 'eaBI' // IncrementalBackuplogrecordsAsyncEnumerator
+#define RESTORE_LOG_RECORDS_ASYNC_ENUMERATOR_TAG 'eaLR' // RestoreLogrecordsAsyncEnumerator
 #define BACKUP_MANAGER_TAG 'rgMB' // BackupManaGeR
 #define BACKUP_FOLDER_INFO_TAG 'niFB' // BackupFolderINfo
 
@@ -195,11 +199,13 @@
 #include "IFlushCallbackProcessor.h"
 #include "ICompletedRecordsProcessor.h"
 #include "PhysicalLogWriterCallbackManager.h"
+#include "AdaptiveFlushScheduler.h"
 #include "PhysicalLogWriter.h"
 #include "LogManager.h"
 #include "FileLogManager.h"
 #include "KLogManager.h"
 #include "MemoryLogManager.h"
+#include "ReplicationCompressor.h"
 #include "IReplicatedLogManager.h"
 #include "ReplicatedLogManager.h"
 #include "RecordProcessingMode.h"
@@ -221,6 +227,7 @@
 #include "ReplicatorBackup.h"
 #include "BackupMetadataFileProperties.h"
 #include "BackupMetadataFile.h"
+#include "RestoreLogRecordsAsyncEnumerator.h"
 #include "BackupFolderInfo.h"
 #include "BackupManager.h"
 #include "LoggingReplicatorImpl.h"
@@ -228,6 +235,7 @@
 
 // Backup Headers.
 #include "BackupLogFileProperties.h"
+#include "BackupLogChunkIndex.h"
 #include "BackupLogFileAsyncEnumerator.h"
 #include "IncrementalBackupLogRecordsAsyncEnumerator.h"
 #include "BackupLogFile.h"
@@ -17,6 +17,7 @@ CopyContext::CopyContext(
     __in IndexingLogRecord const & logHeadRecord,
     __in LONG64 logTailLsn,
     __in LONG64 latestRecoveredAtomicRedoOperationLsn,
+    __in ULONG32 supportedCompressionCodecs,
     __in KAllocator & allocator)
     : OperationDataStream()
     , PartitionedReplicaTraceComponent(traceId)
@@ -31,6 +32,7 @@ CopyContext::CopyContext(
     bw.Write(logHeadRecord.Lsn);
     bw.Write(logTailLsn);
     bw.Write(latestRecoveredAtomicRedoOperationLsn);
+    bw.Write(supportedCompressionCodecs);
 
     KArray<KBuffer::CSPtr> buffers(allocator);
     THROW_ON_CONSTRUCTOR_FAILURE(buffers);
@@ -53,6 +55,7 @@ CopyContext::SPtr CopyContext::Create(
     __in IndexingLogRecord const & logHeadRecord,
     __in LONG64 logTailLsn,
     __in LONG64 latestRecoveredAtomicRedoOperationLsn,
+    __in ULONG32 supportedCompressionCodecs,
     __in KAllocator & allocator)
 {
     CopyContext * pointer = _new(COPYCONTEXT_TAG, allocator) CopyContext(
@@ -62,6 +65,7 @@ CopyContext::SPtr CopyContext::Create(
         logHeadRecord, 
         logTailLsn, 
         latestRecoveredAtomicRedoOperationLsn, 
+        supportedCompressionCodecs,
         allocator);
     
     THROW_ON_ALLOCATION_FAILURE(pointer);
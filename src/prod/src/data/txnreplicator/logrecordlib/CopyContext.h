@@ -9,6 +9,10 @@ namespace Data
 {
     namespace LogRecordLib
     {
+        //
+        // Sent by an idle secondary to the primary at the start of a build.
+        // The bit mask of compression codecs the secondary can decode is appended after the fields older primaries read, so they ignore it.
+        //
         class CopyContext final
             : public TxnReplicator::OperationDataStream 
             , public Utilities::PartitionedReplicaTraceComponent<Common::TraceTaskCodes::LR>
@@ -24,6 +28,7 @@ namespace Data
                 __in IndexingLogRecord const & logHeadRecord,
                 __in LONG64 logTailLsn,
                 __in LONG64 latestRecoveredAtomicRedoOperationLsn,
+                __in ULONG32 supportedCompressionCodecs,
                 __in KAllocator & allocator);
 
             ktl::Awaitable<NTSTATUS> GetNextAsync(
@@ -40,6 +45,7 @@ namespace Data
                 __in IndexingLogRecord const & logHeadRecord,
                 __in LONG64 logTailLsn,
                 __in LONG64 LatestRecoveredAtomicRedoOperationLsn,
+                __in ULONG32 supportedCompressionCodecs,
                 __in KAllocator & allocator);
 
             Utilities::OperationData::CSPtr copyData_;
@@ -13,10 +13,12 @@ using namespace Data::Utilities;
 CopyHeader::CopyHeader(
     __in ULONG32 version,
     __in CopyStage::Enum copyStage,
-    __in LONG64 primaryReplicaId)
+    __in LONG64 primaryReplicaId,
+    __in CompressionCodecId::Enum compressionCodec)
     : version_(version)
     , copyStage_(copyStage)
     , primaryReplicaId_(primaryReplicaId)
+    , compressionCodec_(compressionCodec)
 {
 }
 
@@ -30,10 +32,27 @@ CopyHeader::SPtr CopyHeader::Create(
     __in LONG64 primaryReplicaId,
     __in KAllocator & allocator)
 {
+    return Create(version, copyStage, primaryReplicaId, CompressionCodecId::None, allocator);
+}
+
+CopyHeader::SPtr CopyHeader::Create(
+    __in ULONG32 version,
+    __in CopyStage::Enum copyStage,
+    __in LONG64 primaryReplicaId,
+    __in CompressionCodecId::Enum compressionCodec,
+    __in KAllocator & allocator)
+{
+    ASSERT_IFNOT(
+        compressionCodec == CompressionCodecId::None || version >= CompressionCodecVersion,
+        "Copy header version {0} cannot carry compression codec {1}",
+        version,
+        static_cast<ULONG32>(compressionCodec));
+
     CopyHeader* pointer = _new(COPYHEADER_TAG, allocator)CopyHeader(
         version, 
         copyStage, 
-        primaryReplicaId);
+        primaryReplicaId,
+        compressionCodec);
 
     THROW_ON_ALLOCATION_FAILURE(pointer);
     return CopyHeader::SPtr(pointer);
@@ -58,12 +77,20 @@ CopyHeader::SPtr CopyHeader::Deserialize(
 
     br.Read(copyPrimaryReplicaId);
 
+    CompressionCodecId::Enum compressionCodec = CompressionCodecId::None;
+    if (copyMetadataVersion >= CompressionCodecVersion)
+    {
+        ULONG32 compressionCodecValue;
+        br.Read(compressionCodecValue);
+        compressionCodec = static_cast<CompressionCodecId::Enum>(compressionCodecValue);
+    }
+
     ASSERT_IFNOT(
         copyMetadataVersion != 1 || buffer->QuerySize() == br.Position,
         "Invalid copy header during deserialization, version:{0}", 
         copyMetadataVersion);
 
-    return Create(copyMetadataVersion, copyStage, copyPrimaryReplicaId, allocator);
+    return Create(copyMetadataVersion, copyStage, copyPrimaryReplicaId, compressionCodec, allocator);
 }
 
 KBuffer::SPtr CopyHeader::Serialize(
@@ -76,6 +103,11 @@ KBuffer::SPtr CopyHeader::Serialize(
     bw.Write(copyHeader.copyStage_);
     bw.Write(copyHeader.primaryReplicaId_);
 
+    if (copyHeader.version_ >= CompressionCodecVersion)
+    {
+        bw.Write(static_cast<ULONG32>(copyHeader.compressionCodec_));
+    }
+
     KBuffer::SPtr buffer;
     NTSTATUS status = KBuffer::Create(bw.Position, buffer, allocator);
 
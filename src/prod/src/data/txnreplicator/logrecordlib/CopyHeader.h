@@ -19,10 +19,20 @@ namespace Data
             K_FORCE_SHARED(CopyHeader)
 
         public:
+            // Version 2 appends the codec the copy operations that follow the header are compressed with
+            static const ULONG32 CompressionCodecVersion = 2;
+
+            static CopyHeader::SPtr Create(
+                __in ULONG32 version,
+                __in CopyStage::Enum copyStage,
+                __in LONG64 primaryReplicaId,
+                __in KAllocator & allocator);
+
             static CopyHeader::SPtr Create(
                 __in ULONG32 version,
                 __in CopyStage::Enum copyStage,
                 __in LONG64 primaryReplicaId,
+                __in Utilities::CompressionCodecId::Enum compressionCodec,
                 __in KAllocator & allocator);
             
             static CopyHeader::SPtr Deserialize(
@@ -51,12 +61,19 @@ namespace Data
                 return primaryReplicaId_;
             }
 
+            __declspec(property(get = get_CompressionCodec)) Utilities::CompressionCodecId::Enum CompressionCodec;
+            Utilities::CompressionCodecId::Enum get_CompressionCodec() const
+            {
+                return compressionCodec_;
+            }
+
         private:
             // Initializes a new instance of the CopyHeader class.
             CopyHeader(
                 __in ULONG32 version,
                 __in CopyStage::Enum copyStage,
-                __in LONG64 primaryReplicaId);
+                __in LONG64 primaryReplicaId,
+                __in Utilities::CompressionCodecId::Enum compressionCodec);
 
             // The version.
             ULONG32 version_;
@@ -66,6 +83,9 @@ namespace Data
 
             // The primary replica id.
             LONG64 primaryReplicaId_;
+
+            // The codec of the copy operations. Always None before version 2.
+            Utilities::CompressionCodecId::Enum compressionCodec_;
         };
     }
 }
@@ -331,6 +331,38 @@ Awaitable<LogRecord::SPtr> LogRecord::ReadPreviousRecordAsync(
         allocator);
 }
 
+LogRecord::SPtr LogRecord::ReadNextRecord(
+    __in BinaryReader & binaryReader,
+    __in ULONG64 recordPosition,
+    __in InvalidLogRecords & invalidLogRecords,
+    __in KAllocator & allocator)
+{
+    ULONG32 recordLength = 0;
+    binaryReader.Read(recordLength);
+
+    ASSERT_IFNOT(
+        binaryReader.Position + recordLength + sizeof(ULONG32) <= binaryReader.Length,
+        "Record length exceeds the buffer: {0} {1} {2}", recordLength, binaryReader.Position, binaryReader.Length);
+
+    LogRecord::SPtr record = ReadRecord(
+        binaryReader,
+        recordPosition,
+        invalidLogRecords,
+        true,
+        allocator);
+
+    ULONG32 trailingRecordLength = 0;
+    binaryReader.Read(trailingRecordLength);
+
+    ASSERT_IFNOT(
+        recordLength == trailingRecordLength,
+        "Incorrect record length: {0} {1}", recordLength, trailingRecordLength);
+
+    record->RecordLength = recordLength;
+
+    return record;
+}
+
 std::wstring LogRecord::get_RecordTypeName() const
 {
     wstring name;
@@ -111,6 +111,17 @@ namespace Data
                 __in InvalidLogRecords & invalidLogRecords,
                 __in KAllocator & allocator);
 
+            //
+            // Used by the log readers that read ahead to deserialize the next record of a buffer holding consecutive records
+            //      binaryReader - positioned at the leading record length. Left positioned at the next record
+            //      recordPosition - position of the record in the log
+            //
+            static LogRecord::SPtr ReadNextRecord(
+                __in Utilities::BinaryReader & binaryReader,
+                __in ULONG64 recordPosition,
+                __in InvalidLogRecords & invalidLogRecords,
+                __in KAllocator & allocator);
+
             __declspec(property(get = get_RecordType)) LogRecordType::Enum RecordType;
             LogRecordType::Enum get_RecordType() const
             {
@@ -32,12 +32,20 @@ LogRecords::LogRecords(
     , readerName_()
     , readerType_(readerType)
     , readStream_(logManager.CreateReaderStream())
+    , readAheadWindowSize_(GetReadAheadWindowSize(readAheadCacheSize))
     , enumerationStartingPosition_(enumerationStartingPosition)
     , enumerationStartAtLsn_(enumerationStartedAtLsn)
     , currentRecord_()
     , lastPhysicalRecord_()
     , invalidLogRecords_(logManager.InvalidLogRecords)
     , transactionalReplicatorConfig_(config)
+    , readPosition_(enumerationStartingPosition)
+    , carryOverSPtr_()
+    , isReadCompleted_(false)
+    , nextWindowToRead_(0)
+    , nextWindowToConsume_(0)
+    , currentWindowSPtr_()
+    , currentIndex_(0)
 {
     ASSERT_IFNOT(
         enumerationStartingPosition <= enumerationEndingPosition,
@@ -80,6 +88,7 @@ LogRecords::LogRecords(
     __in InvalidLogRecords & invalidLogRecords,
     __in ULONG64 enumerationStartingPosition,
     __in ULONG64 enumerationEndingPosition,
+    __in LONG64 readAheadCacheSize,
     __in Reliability::ReplicationComponent::IReplicatorHealthClientSPtr const & healthClient,
     __in TRInternalSettingsSPtr const & config)
     : IAsyncEnumerator()
@@ -91,12 +100,20 @@ LogRecords::LogRecords(
     , readerName_()
     , readerType_(LogReaderType::Enum::Default)
     , readStream_(&readStream)
+    , readAheadWindowSize_(GetReadAheadWindowSize(readAheadCacheSize))
     , enumerationStartingPosition_(enumerationStartingPosition)
     , enumerationStartAtLsn_(MAXLONG64)
     , currentRecord_()
     , lastPhysicalRecord_()
     , invalidLogRecords_(&invalidLogRecords)
     , transactionalReplicatorConfig_(config)
+    , readPosition_(enumerationStartingPosition)
+    , carryOverSPtr_()
+    , isReadCompleted_(false)
+    , nextWindowToRead_(0)
+    , nextWindowToConsume_(0)
+    , currentWindowSPtr_()
+    , currentIndex_(0)
 {
     ASSERT_IFNOT(
         enumerationStartingPosition <= enumerationEndingPosition,
@@ -155,6 +172,7 @@ LogRecords::SPtr LogRecords::Create(
     __in InvalidLogRecords & invalidLogRecords,
     __in ULONG64 enumerationStartingPosition,
     __in ULONG64 enumerationEndingPosition,
+    __in LONG64 readAheadCacheSize,
     __in Reliability::ReplicationComponent::IReplicatorHealthClientSPtr const & healthClient,
     __in TRInternalSettingsSPtr const & transactionalReplicatorConfig,
     __in KAllocator & allocator)
@@ -165,6 +183,7 @@ LogRecords::SPtr LogRecords::Create(
         invalidLogRecords, 
         enumerationStartingPosition, 
         enumerationEndingPosition,
+        readAheadCacheSize,
         healthClient,
         transactionalReplicatorConfig);
 
@@ -182,103 +201,330 @@ void LogRecords::Dispose()
     if (logManager_ != nullptr)
     {
         logManager_->RemoveLogReader(enumerationStartingPosition_);
+    }
 
-        if (readStream_ != nullptr)
-        {
-            DisposeReadStream();
-        }
+    if (nextWindowToConsume_ < nextWindowToRead_ || (logManager_ != nullptr && readStream_ != nullptr))
+    {
+        DisposeReadStream();
     }
 
     isDisposed_ = true;
 }
 
+ULONG32 LogRecords::GetReadAheadWindowSize(__in LONG64 readAheadCacheSize)
+{
+    if (readAheadCacheSize <= 0)
+    {
+        return DefaultReadAheadWindowSize;
+    }
+
+    if (readAheadCacheSize > MAXLONG)
+    {
+        return MAXLONG;
+    }
+
+    return static_cast<ULONG32>(readAheadCacheSize);
+}
+
 Task LogRecords::DisposeReadStream()
 {
     KCoShared$ApiEntry()
 
-    co_await readStream_->CloseAsync();
+    // Windows that were read ahead may still be decoding. Failures are ignored since their records will not be returned.
+    while (nextWindowToConsume_ < nextWindowToRead_)
+    {
+        try
+        {
+            co_await decodeAwaitables_[nextWindowToConsume_ % MaxWindowsInFlight];
+        }
+        catch (ktl::Exception &)
+        {
+        }
+
+        nextWindowToConsume_++;
+    }
+
+    if (logManager_ != nullptr && readStream_ != nullptr)
+    {
+        co_await readStream_->CloseAsync();
+    }
+
     co_return;
 }
 
 void LogRecords::Reset()
 { 
+    ASSERT_IFNOT(
+        nextWindowToConsume_ == nextWindowToRead_,
+        "LogRecords::Reset : Cannot reset while {0} windows are read ahead",
+        nextWindowToRead_ - nextWindowToConsume_);
+
     readStream_->SetPosition(LONGLONG(enumerationStartingPosition_));
+    readPosition_ = enumerationStartingPosition_;
+    carryOverSPtr_ = nullptr;
+    isReadCompleted_ = false;
+    currentWindowSPtr_ = nullptr;
+    currentIndex_ = 0;
+
     currentRecord_ = invalidLogRecords_->Inv_LogRecord;
     lastPhysicalRecord_ = nullptr;
 }
 
 Awaitable<bool> LogRecords::MoveNextAsync(__in CancellationToken const & cancellationToken)
 {
-    if (readStream_->GetPosition() <= (LONG64)enumerationEndingPosition_ && !isDisposed_)
+    if (isDisposed_)
+    {
+        co_return false;
+    }
+
+    LogRecord::SPtr record = co_await GetNextRecordAsync();
+
+    if (record == nullptr)
     {
-        Common::Stopwatch logReadWatch;
-        logReadWatch.Start();
+        co_return false;
+    }
 
-        LogRecord::SPtr record = co_await LogRecord::ReadNextRecordAsync(
-            *readStream_,
-            *invalidLogRecords_,
-            GetThisAllocator());
+    PhysicalLogRecord * physicalRecord = record->AsPhysicalLogRecord();
+
+    if (lastPhysicalRecord_ != nullptr)
+    {
+        record->PreviousPhysicalRecord = lastPhysicalRecord_.RawPtr();
 
-        logReadWatch.Stop();
-        if (logReadWatch.Elapsed > transactionalReplicatorConfig_->SlowLogIODuration)
+        if (physicalRecord != nullptr)
         {
-            ioMonitor_->OnSlowOperation();   
+            lastPhysicalRecord_->NextPhysicalRecord = physicalRecord;
+            lastPhysicalRecord_ = physicalRecord;
         }
+    }
+    else if (physicalRecord != nullptr)
+    {
+        lastPhysicalRecord_ = physicalRecord;
+    }
+
+    currentRecord_ = record;
+
+    // If the starting lsn is not initialized (recovery reader case), initialize it to the first record's lsn
+    if (enumerationStartAtLsn_ == MAXLONG64)
+    {
+        enumerationStartAtLsn_ = currentRecord_->Lsn;
+    }
+
+    // Trim the starting position for enabling possible truncations
+
+    if (logManager_ != nullptr &&
+        currentRecord_->RecordPosition - enumerationStartingPosition_ > UpdateStartingPositionAfterBytes)
+    {
+        // First add the new range and only then remove the older range
+
+        bool isValid = logManager_->AddLogReader(
+            enumerationStartAtLsn_,
+            currentRecord_->RecordPosition,
+            enumerationEndingPosition_,
+            readerName_,
+            readerType_);
 
         ASSERT_IFNOT(
-            record != nullptr,
-            "LogRecords::MoveNextAsync : record must not be null");
+            isValid,
+            "LogRecords::MoveNextAsync : logManager_->AddLogReader must be valid");
 
-        PhysicalLogRecord * physicalRecord = record->AsPhysicalLogRecord();
+        logManager_->RemoveLogReader(enumerationStartingPosition_);
 
-        if (lastPhysicalRecord_ != nullptr)
-        {
-            record->PreviousPhysicalRecord = lastPhysicalRecord_.RawPtr();
+        enumerationStartingPosition_ = currentRecord_->RecordPosition;
+    }
 
-            if (physicalRecord != nullptr)
-            {
-                lastPhysicalRecord_->NextPhysicalRecord = physicalRecord;
-                lastPhysicalRecord_ = physicalRecord;
-            }
-        }
-        else if (physicalRecord != nullptr)
-        {
-            lastPhysicalRecord_ = physicalRecord;
-        }
+    co_return true;
+}
 
-        currentRecord_ = record;
+// Returns the next record in log order, or nullptr once every record up to the ending position was returned.
+// Algorithm:
+// 1. Return the next record of the current window if available.
+// 2. Read ahead until MaxWindowsInFlight windows are being decoded or the ending position was read.
+//    Reads are sequential on the read stream, decoding runs on the thread pool.
+// 3. If every window has been consumed return nullptr.
+// 4. Wait for the oldest window and make its records the current window.
+Awaitable<LogRecord::SPtr> LogRecords::GetNextRecordAsync()
+{
+    KShared$ApiEntry();
+
+    // Step 1: Return from the current window.
+    if (currentWindowSPtr_ != nullptr && currentIndex_ < currentWindowSPtr_->Count())
+    {
+        co_return (*currentWindowSPtr_)[currentIndex_++];
+    }
 
-        // If the starting lsn is not initialized (recovery reader case), initialize it to the first record's lsn
-        if (enumerationStartAtLsn_ == MAXLONG64)
+    // Step 2: Read ahead.
+    while (!isReadCompleted_ && nextWindowToRead_ - nextWindowToConsume_ < MaxWindowsInFlight)
+    {
+        co_await ReadWindowAsync();
+    }
+
+    // Step 3: Check if all windows are consumed.
+    if (nextWindowToConsume_ == nextWindowToRead_)
+    {
+        currentWindowSPtr_ = nullptr;
+        co_return nullptr;
+    }
+
+    // Step 4: Replace the current window with the records of the oldest window.
+    ULONG32 windowIndex = nextWindowToConsume_ % MaxWindowsInFlight;
+    nextWindowToConsume_++;
+
+    currentWindowSPtr_ = co_await decodeAwaitables_[windowIndex];
+    currentIndex_ = 0;
+
+    ASSERT_IFNOT(
+        currentWindowSPtr_->Count() > 0,
+        "LogRecords::GetNextRecordAsync : decoded window must not be empty");
+
+    co_return (*currentWindowSPtr_)[currentIndex_++];
+}
+
+// Reads the next window of the log and starts decoding the records it completes.
+// Only the leading record lengths are looked at here, to find the records that end in the window and
+// the ending position. A record split by the end of the window is carried over to the next window.
+Awaitable<void> LogRecords::ReadWindowAsync()
+{
+    KShared$ApiEntry();
+
+    ULONG32 carryOverSize = carryOverSPtr_ == nullptr ? 0 : carryOverSPtr_->QuerySize();
+    ULONG64 windowPosition = readPosition_ - carryOverSize;
+
+    // Bytes needed to complete the record that was split by the last window: its length first, then the rest of it
+    ULONG32 bytesNeeded = 0;
+    if (carryOverSize < sizeof(ULONG32))
+    {
+        bytesNeeded = static_cast<ULONG32>(sizeof(ULONG32)) - carryOverSize;
+    }
+    else
+    {
+        ULONG32 recordLength = 0;
+        memcpy(&recordLength, carryOverSPtr_->GetBuffer(), sizeof(ULONG32));
+        bytesNeeded = static_cast<ULONG32>(2 * sizeof(ULONG32)) + recordLength - carryOverSize;
+    }
+
+    ULONG64 logLength = static_cast<ULONG64>(readStream_->GetLength());
+    ULONG64 bytesAvailable = logLength > readPosition_ ? logLength - readPosition_ : 0;
+
+    if (carryOverSize == 0 && bytesAvailable == 0)
+    {
+        isReadCompleted_ = true;
+        co_return;
+    }
+
+    // Read a full window when the log has it, and never less than the split record
+    ULONG32 bytesToRead = static_cast<ULONG32>(__min(bytesAvailable, static_cast<ULONG64>(readAheadWindowSize_)));
+    bytesToRead = __max(bytesToRead, bytesNeeded);
+
+    KBuffer::SPtr window = nullptr;
+    NTSTATUS status = KBuffer::Create(
+        carryOverSize + bytesToRead,
+        window,
+        GetThisAllocator());
+    THROW_ON_FAILURE(status);
+
+    if (carryOverSize > 0)
+    {
+        memcpy(window->GetBuffer(), carryOverSPtr_->GetBuffer(), carryOverSize);
+        carryOverSPtr_ = nullptr;
+    }
+
+    Common::Stopwatch logReadWatch;
+    logReadWatch.Start();
+
+    ULONG bytesRead = 0;
+    readStream_->SetPosition(static_cast<LONGLONG>(readPosition_));
+    status = co_await readStream_->ReadAsync(
+        *window,
+        bytesRead,
+        carryOverSize,
+        bytesToRead);
+
+    logReadWatch.Stop();
+    if (logReadWatch.Elapsed > transactionalReplicatorConfig_->SlowLogIODuration)
+    {
+        ioMonitor_->OnSlowOperation();
+    }
+
+    ASSERT_IFNOT(
+        status == STATUS_SUCCESS && bytesRead == bytesToRead,
+        "Incorrect bytes read: {0} {1}", bytesRead, bytesToRead);
+
+    readPosition_ += bytesToRead;
+
+    // Find the records that end in this window
+    byte const * windowBytes = static_cast<byte const *>(window->GetBuffer());
+    ULONG32 windowSize = carryOverSize + bytesToRead;
+    ULONG32 decodeSize = 0;
+
+    while (decodeSize + sizeof(ULONG32) <= windowSize && windowPosition + decodeSize <= enumerationEndingPosition_)
+    {
+        ULONG32 recordLength = 0;
+        memcpy(&recordLength, windowBytes + decodeSize, sizeof(ULONG32));
+
+        ULONG64 recordSize = 2 * sizeof(ULONG32) + static_cast<ULONG64>(recordLength);
+        if (decodeSize + recordSize > windowSize)
         {
-            enumerationStartAtLsn_ = currentRecord_->Lsn;
+            break;
         }
 
-        // Trim the starting position for enabling possible truncations
+        decodeSize += static_cast<ULONG32>(recordSize);
+    }
 
-        if (logManager_ != nullptr &&
-            currentRecord_->RecordPosition - enumerationStartingPosition_ > UpdateStartingPositionAfterBytes)
-        {
-            // First add the new range and only then remove the older range
+    if (windowPosition + decodeSize > enumerationEndingPosition_)
+    {
+        isReadCompleted_ = true;
+    }
+    else if (decodeSize < windowSize)
+    {
+        status = KBuffer::Create(
+            windowSize - decodeSize,
+            carryOverSPtr_,
+            GetThisAllocator());
+        THROW_ON_FAILURE(status);
 
-            bool isValid = logManager_->AddLogReader(
-                enumerationStartAtLsn_,
-                currentRecord_->RecordPosition,
-                enumerationEndingPosition_,
-                readerName_,
-                readerType_);
+        memcpy(carryOverSPtr_->GetBuffer(), windowBytes + decodeSize, windowSize - decodeSize);
+    }
 
-            ASSERT_IFNOT(
-                isValid,
-                "LogRecords::MoveNextAsync : logManager_->AddLogReader must be valid");
+    if (decodeSize == 0)
+    {
+        co_return;
+    }
 
-            logManager_->RemoveLogReader(enumerationStartingPosition_);
+    decodeAwaitables_[nextWindowToRead_ % MaxWindowsInFlight] = DecodeWindowAsync(*window, windowPosition, decodeSize);
+    nextWindowToRead_++;
 
-            enumerationStartingPosition_ = currentRecord_->RecordPosition;
-        }
+    co_return;
+}
+
+// Parses, validates and deserializes the records of a window on the thread pool.
+Awaitable<KSharedArray<LogRecord::SPtr>::SPtr> LogRecords::DecodeWindowAsync(
+    __in KBuffer & window,
+    __in ULONG64 windowPosition,
+    __in ULONG32 decodeSize)
+{
+    KShared$ApiEntry();
+
+    KBuffer::SPtr windowSPtr(&window);
+
+    co_await CorHelper::ThreadPoolThread(GetThisKtlSystem().DefaultThreadPool());
+
+    KSharedArray<LogRecord::SPtr>::SPtr records = _new(LOGRECORDS_TAG, GetThisAllocator()) KSharedArray<LogRecord::SPtr>();
+    THROW_ON_ALLOCATION_FAILURE(records);
+    THROW_ON_FAILURE(records->Status());
+
+    BinaryReader binaryReader(*windowSPtr, GetThisAllocator());
+
+    while (binaryReader.Position < decodeSize)
+    {
+        LogRecord::SPtr record = LogRecord::ReadNextRecord(
+            binaryReader,
+            windowPosition + binaryReader.Position,
+            *invalidLogRecords_,
+            GetThisAllocator());
 
-        co_return true;
+        NTSTATUS status = records->Append(record);
+        THROW_ON_FAILURE(status);
     }
 
-    co_return false;
+    co_return records;
 }
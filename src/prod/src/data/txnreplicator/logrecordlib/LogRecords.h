@@ -12,6 +12,10 @@ namespace Data
         //
         // An abstraction for an iterator over log records that are created from a valid physical log reader
         //
+        // The log is read in windows of the read ahead size rather than one record at a time. Up to MaxWindowsInFlight
+        // windows are read ahead and their records are parsed, validated and deserialized on the thread pool while the
+        // next window is read. Records are still returned in log order.
+        //
         class LogRecords
             : public Utilities::IAsyncEnumerator<LogRecord::SPtr>
             , public KObject<LogRecords>
@@ -43,6 +47,7 @@ namespace Data
                 __in InvalidLogRecords & invalidLogRecords,
                 __in ULONG64 enumerationStartingPosition,
                 __in ULONG64 enumerationEndingPosition,
+                __in LONG64 readAheadCacheSize,
                 __in Reliability::ReplicationComponent::IReplicatorHealthClientSPtr const & healthClient,
                 __in TxnReplicator::TRInternalSettingsSPtr const & transactionalReplicatorConfig,
                 __in KAllocator & allocator);
@@ -84,17 +89,33 @@ namespace Data
                 __in InvalidLogRecords & invalidLogRecords,
                 __in ULONG64 enumerationStartingPosition,
                 __in ULONG64 enumerationEndingPosition,
+                __in LONG64 readAheadCacheSize,
                 __in Reliability::ReplicationComponent::IReplicatorHealthClientSPtr const & healthClient,
                 __in TxnReplicator::TRInternalSettingsSPtr const & transactionalReplicatorConfig);
 
+            static ULONG32 GetReadAheadWindowSize(__in LONG64 readAheadCacheSize);
+
             ktl::Task DisposeReadStream();
 
+            ktl::Awaitable<LogRecord::SPtr> GetNextRecordAsync();
+
+            ktl::Awaitable<void> ReadWindowAsync();
+
+            ktl::Awaitable<KSharedArray<LogRecord::SPtr>::SPtr> DecodeWindowAsync(
+                __in KBuffer & window,
+                __in ULONG64 windowPosition,
+                __in ULONG32 decodeSize);
+
+            static const ULONG32 MaxWindowsInFlight = 2;
+            static const ULONG32 DefaultReadAheadWindowSize = 1024 * 1024;
+
             bool isDisposed_;
             ILogManagerReadOnly::SPtr const logManager_;
             ULONG64 const enumerationEndingPosition_;
             KLocalString<Constants::LogReaderNameMaxLength> readerName_;
             LogReaderType::Enum const readerType_;
             Data::Log::ILogicalLogReadStream::SPtr const readStream_;
+            ULONG32 const readAheadWindowSize_;
             
             ULONG64 enumerationStartingPosition_;
             LONG64 enumerationStartAtLsn_;
@@ -104,6 +125,21 @@ namespace Data
             InvalidLogRecords::SPtr invalidLogRecords_;
             TxnReplicator::IOMonitor::SPtr ioMonitor_;
             TxnReplicator::TRInternalSettingsSPtr transactionalReplicatorConfig_;
+
+            // Read ahead state.
+            // readPosition_ is the position of the next byte to read. The bytes of a record split by the end of the
+            // last window are kept in carryOverSPtr_ and prepended to the next window.
+            ULONG64 readPosition_;
+            KBuffer::SPtr carryOverSPtr_;
+            bool isReadCompleted_;
+
+            // Windows [nextWindowToConsume_, nextWindowToRead_) are being decoded in decodeAwaitables_[window % MaxWindowsInFlight].
+            ULONG32 nextWindowToRead_;
+            ULONG32 nextWindowToConsume_;
+            ktl::Awaitable<KSharedArray<LogRecord::SPtr>::SPtr> decodeAwaitables_[MaxWindowsInFlight];
+
+            KSharedArray<LogRecord::SPtr>::SPtr currentWindowSPtr_;
+            ULONG32 currentIndex_;
         };
     }
 }
@@ -630,6 +630,24 @@ NTSTATUS MockLoggingReplicator::UnRegisterTransactionChangeHandler() noexcept
     CODING_ASSERT("NOT IMPLEMENTED");
 }
 
+void MockLoggingReplicator::UpdateReplicaSetConfiguration(
+    __in FABRIC_REPLICA_SET_CONFIGURATION const * currentConfiguration,
+    __in_opt FABRIC_REPLICA_SET_CONFIGURATION const * previousConfiguration) noexcept
+{
+    UNREFERENCED_PARAMETER(currentConfiguration);
+    UNREFERENCED_PARAMETER(previousConfiguration);
+}
+
+void MockLoggingReplicator::OnBuildReplica(__in LONG64 replicaId) noexcept
+{
+    UNREFERENCED_PARAMETER(replicaId);
+}
+
+void MockLoggingReplicator::OnRemoveReplica(__in LONG64 replicaId) noexcept
+{
+    UNREFERENCED_PARAMETER(replicaId);
+}
+
 MockLoggingReplicator::MockLoggingReplicator(__in bool hasPersistedState)
     : KAsyncServiceBase()
     , KWeakRefType<MockLoggingReplicator>()
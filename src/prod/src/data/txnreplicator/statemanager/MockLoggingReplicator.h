@@ -199,6 +199,15 @@ namespace StateManagerTests
 
         NTSTATUS UnRegisterTransactionChangeHandler() noexcept override;
 
+    public: // Replica set notifications
+        void UpdateReplicaSetConfiguration(
+            __in FABRIC_REPLICA_SET_CONFIGURATION const * currentConfiguration,
+            __in_opt FABRIC_REPLICA_SET_CONFIGURATION const * previousConfiguration) noexcept override;
+
+        void OnBuildReplica(__in LONG64 replicaId) noexcept override;
+
+        void OnRemoveReplica(__in LONG64 replicaId) noexcept override;
+
 
     private:
         NTSTATUS InjectFaultIfNecessary() noexcept;
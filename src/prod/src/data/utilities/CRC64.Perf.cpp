@@ -0,0 +1,123 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#include <boost/test/unit_test.hpp>
+#include "Common/boost-taef.h"
+
+namespace UtilitiesTests
+{
+    using namespace ktl;
+    using namespace Data::Utilities;
+
+    class CRC64PerfTest
+    {
+    public:
+        Common::CommonConfig config; // load the config object as it's needed for the tracing to work
+
+        CRC64PerfTest()
+        {
+            NTSTATUS status;
+            status = KtlSystem::Initialize(FALSE, &ktlSystem_);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            ktlSystem_->SetStrictAllocationChecks(TRUE);
+        }
+
+        ~CRC64PerfTest()
+        {
+            ktlSystem_->Shutdown();
+        }
+
+        KAllocator& GetAllocator()
+        {
+            return ktlSystem_->PagedAllocator();
+        }
+
+        //
+        // Checksums bufferSize bytes with every supported implementation until totalBytes have been processed and prints the throughput.
+        //
+        void ThroughputPerfTest(
+            __in ULONG32 bufferSize,
+            __in ULONG64 totalBytes)
+        {
+            KBuffer::SPtr bufferSPtr = nullptr;
+            NTSTATUS status = KBuffer::Create(bufferSize, bufferSPtr, GetAllocator());
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            byte * data = static_cast<byte *>(bufferSPtr->GetBuffer());
+            for (ULONG32 i = 0; i < bufferSize; i++)
+            {
+                data[i] = static_cast<byte>(i * 131);
+            }
+
+            ULONG64 iterations = totalBytes / bufferSize;
+            ULONG64 expected = CRC64::ToCRC64(*bufferSPtr, 0, bufferSize);
+
+            CRC64Implementation::Enum implementations[] = { CRC64Implementation::Table, CRC64Implementation::SliceBy8, CRC64Implementation::CarrylessMultiply };
+            const char * names[] = { "Table", "SliceBy8", "CarrylessMultiply" };
+
+            for (ULONG32 i = 0; i < ARRAYSIZE(implementations); i++)
+            {
+                if (!CRC64::IsSupported(implementations[i]))
+                {
+                    cout << Common::formatString("CRC64 {0}: not supported", names[i]) << endl;
+                    continue;
+                }
+
+                ULONG64 checksum = 0;
+
+                Common::Stopwatch stopwatch;
+                stopwatch.Start();
+
+                for (ULONG64 n = 0; n < iterations; n++)
+                {
+                    checksum = CRC64::Finalize(CRC64::Update(implementations[i], CRC64::InitialValue, data, 0, bufferSize));
+                }
+
+                stopwatch.Stop();
+                CODING_ERROR_ASSERT(checksum == expected);
+
+                LONG64 duration = stopwatch.ElapsedMilliseconds == 0 ? 1 : stopwatch.ElapsedMilliseconds;
+                ULONG64 megabytesPerSecond = (iterations * bufferSize * 1000) / (duration * 1024 * 1024);
+
+                cout << Common::formatString(
+                    "CRC64 {0}: BufferSize: {1} Iterations: {2} Duration: {3} ms Throughput: {4} MB/s",
+                    names[i],
+                    bufferSize,
+                    iterations,
+                    stopwatch.ElapsedMilliseconds,
+                    megabytesPerSecond) << endl;
+            }
+
+            cout << Common::formatString("CRC64 selected implementation: {0}", names[CRC64::GetImplementation()]) << endl;
+        }
+
+    private:
+        KtlSystem* ktlSystem_;
+    };
+
+    BOOST_FIXTURE_TEST_SUITE(CRC64PerfTestSuite, CRC64PerfTest);
+
+    // Typical log record
+    BOOST_AUTO_TEST_CASE(Perf_CRC64_Throughput_64B)
+    {
+        ThroughputPerfTest(64, 256 * 1024 * 1024);
+    }
+
+    // Checkpoint block
+    BOOST_AUTO_TEST_CASE(Perf_CRC64_Throughput_4KB)
+    {
+        ThroughputPerfTest(4 * 1024, 1024 * 1024 * 1024);
+    }
+
+    // Backup log file block
+    BOOST_AUTO_TEST_CASE(Perf_CRC64_Throughput_1MB)
+    {
+        ThroughputPerfTest(1024 * 1024, 1024 * 1024 * 1024);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+}
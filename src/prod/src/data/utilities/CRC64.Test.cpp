@@ -34,4 +34,51 @@ namespace UtilitiesTests
         result = CRC64::ToCRC64(buffer, 2, 5);
         CODING_ERROR_ASSERT(result == 14226437255121905647);
     }
+
+    BOOST_AUTO_TEST_CASE(ToCRC64_AllImplementations_SameChecksum)
+    {
+        const ULONG32 bufferSize = 1024;
+        byte buffer[bufferSize];
+        for (ULONG32 i = 0; i < bufferSize; i++)
+        {
+            buffer[i] = static_cast<byte>((i * 31) ^ (i >> 3));
+        }
+
+        // Cover every remainder of the 8 and 64 byte steps, and unaligned starts.
+        for (ULONG32 offset = 0; offset < 9; offset += 4)
+        {
+            for (ULONG32 count = 0; count <= bufferSize - offset; count++)
+            {
+                ULONG64 expected = CRC64::Finalize(CRC64::Update(CRC64Implementation::Table, CRC64::InitialValue, buffer, offset, count));
+
+                CODING_ERROR_ASSERT(CRC64::ToCRC64(buffer, offset, count) == expected);
+                CODING_ERROR_ASSERT(CRC64::Finalize(CRC64::Update(CRC64Implementation::SliceBy8, CRC64::InitialValue, buffer, offset, count)) == expected);
+
+                if (CRC64::IsSupported(CRC64Implementation::CarrylessMultiply))
+                {
+                    CODING_ERROR_ASSERT(CRC64::Finalize(CRC64::Update(CRC64Implementation::CarrylessMultiply, CRC64::InitialValue, buffer, offset, count)) == expected);
+                }
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(Update_Incremental_SameChecksum)
+    {
+        const ULONG32 bufferSize = 777;
+        byte buffer[bufferSize];
+        for (ULONG32 i = 0; i < bufferSize; i++)
+        {
+            buffer[i] = static_cast<byte>(i * 7);
+        }
+
+        ULONG64 expected = CRC64::ToCRC64(buffer, 0, bufferSize);
+
+        for (ULONG32 split = 0; split <= bufferSize; split += 37)
+        {
+            ULONG64 crc = CRC64::InitialValue;
+            crc = CRC64::Update(crc, buffer, 0, split);
+            crc = CRC64::Update(crc, buffer, split, bufferSize - split);
+            CODING_ERROR_ASSERT(CRC64::Finalize(crc) == expected);
+        }
+    }
 }
@@ -5,6 +5,18 @@
 
 #include "stdafx.h"
 
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+#define CRC64_CARRYLESS_MULTIPLY_ENABLED
+#if defined(PLATFORM_UNIX)
+#include <cpuid.h>
+#include <immintrin.h>
+#define CRC64_CARRYLESS_MULTIPLY_TARGET __attribute__((target("pclmul,ssse3")))
+#else
+#include <intrin.h>
+#define CRC64_CARRYLESS_MULTIPLY_TARGET
+#endif
+#endif
+
 using namespace Data::Utilities;
 
 static const ULONG64 Crc64Table[] = {
@@ -266,6 +278,314 @@ static const ULONG64 Crc64Table[] = {
     0x9AFCE626CE85B507
 };
 
+static const ULONG64 Crc64Polynomial = 0x42F0E1EBA9EA3693;
+
+// Inputs shorter than this are not worth setting up the carry-less multiply folds for.
+static const ULONG32 CarrylessMultiplyMinimumCount = 64;
+
+namespace
+{
+    //
+    // Tables and constants derived from Crc64Table, computed once on first use.
+    //
+    struct Crc64Tables
+    {
+        // SliceTable[k][b] is the CRC register contribution of byte b followed by k zero bytes. SliceTable[0] is Crc64Table.
+        ULONG64 SliceTable[8][256];
+
+        // x^n mod P for the distances the carry-less multiply folds over.
+        ULONG64 Fold128Low;
+        ULONG64 Fold128High;
+        ULONG64 Fold512Low;
+        ULONG64 Fold512High;
+
+        CRC64Implementation::Enum Implementation;
+        bool IsCarrylessMultiplySupported;
+
+        Crc64Tables()
+        {
+            for (ULONG32 i = 0; i < 256; i++)
+            {
+                SliceTable[0][i] = Crc64Table[i];
+            }
+
+            for (ULONG32 k = 1; k < 8; k++)
+            {
+                for (ULONG32 i = 0; i < 256; i++)
+                {
+                    ULONG64 previous = SliceTable[k - 1][i];
+                    SliceTable[k][i] = (previous << 8) ^ Crc64Table[previous >> 56];
+                }
+            }
+
+            Fold128Low = XPowerModPolynomial(128);
+            Fold128High = XPowerModPolynomial(128 + 64);
+            Fold512Low = XPowerModPolynomial(512);
+            Fold512High = XPowerModPolynomial(512 + 64);
+
+            IsCarrylessMultiplySupported = DetectCarrylessMultiply();
+            Implementation = IsCarrylessMultiplySupported ? CRC64Implementation::CarrylessMultiply : CRC64Implementation::SliceBy8;
+        }
+
+        static ULONG64 XPowerModPolynomial(__in ULONG32 power)
+        {
+            // x^64 mod P is the polynomial without its leading term.
+            ULONG64 result = Crc64Polynomial;
+            for (ULONG32 i = 64; i < power; i++)
+            {
+                bool carry = (result & 0x8000000000000000) != 0;
+                result <<= 1;
+                if (carry)
+                {
+                    result ^= Crc64Polynomial;
+                }
+            }
+
+            return result;
+        }
+
+        static bool DetectCarrylessMultiply()
+        {
+#if defined(CRC64_CARRYLESS_MULTIPLY_ENABLED)
+            // CPUID leaf 1, ECX: bit 1 is PCLMULQDQ and bit 9 is SSSE3 (needed for the byte shuffle).
+            unsigned int ecx = 0;
+#if defined(PLATFORM_UNIX)
+            unsigned int eax = 0;
+            unsigned int ebx = 0;
+            unsigned int edx = 0;
+            if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0)
+            {
+                return false;
+            }
+#else
+            int cpuInfo[4] = { 0 };
+            __cpuid(cpuInfo, 1);
+            ecx = static_cast<unsigned int>(cpuInfo[2]);
+#endif
+            return (ecx & (1 << 1)) != 0 && (ecx & (1 << 9)) != 0;
+#else
+            return false;
+#endif
+        }
+    };
+
+    Crc64Tables const & GetCrc64Tables()
+    {
+        static Crc64Tables const tables;
+        return tables;
+    }
+
+    ULONG64 UpdateTable(
+        __in ULONG64 crc,
+        __in byte const * value,
+        __in ULONG32 count)
+    {
+        for (ULONG32 i = 0; i < count; i++)
+        {
+            ULONG64 tableIndex = (static_cast<ULONG64>(crc >> 56) ^ value[i]) & 0xff;
+            crc = Crc64Table[tableIndex] ^ (crc << 8);
+        }
+
+        return crc;
+    }
+
+    ULONG64 UpdateSliceBy8(
+        __in Crc64Tables const & tables,
+        __in ULONG64 crc,
+        __in byte const * value,
+        __in ULONG32 count)
+    {
+        while (count >= 8)
+        {
+            // The CRC is most significant bit first, so the input is consumed as a big endian word.
+            ULONG64 word =
+                (static_cast<ULONG64>(value[0]) << 56) |
+                (static_cast<ULONG64>(value[1]) << 48) |
+                (static_cast<ULONG64>(value[2]) << 40) |
+                (static_cast<ULONG64>(value[3]) << 32) |
+                (static_cast<ULONG64>(value[4]) << 24) |
+                (static_cast<ULONG64>(value[5]) << 16) |
+                (static_cast<ULONG64>(value[6]) << 8) |
+                static_cast<ULONG64>(value[7]);
+
+            word ^= crc;
+
+            crc =
+                tables.SliceTable[7][word >> 56] ^
+                tables.SliceTable[6][(word >> 48) & 0xff] ^
+                tables.SliceTable[5][(word >> 40) & 0xff] ^
+                tables.SliceTable[4][(word >> 32) & 0xff] ^
+                tables.SliceTable[3][(word >> 24) & 0xff] ^
+                tables.SliceTable[2][(word >> 16) & 0xff] ^
+                tables.SliceTable[1][(word >> 8) & 0xff] ^
+                tables.SliceTable[0][word & 0xff];
+
+            value += 8;
+            count -= 8;
+        }
+
+        return UpdateTable(crc, value, count);
+    }
+
+#if defined(CRC64_CARRYLESS_MULTIPLY_ENABLED)
+    CRC64_CARRYLESS_MULTIPLY_TARGET
+    inline __m128i LoadBigEndian(__in byte const * value, __in __m128i const & byteSwapMask)
+    {
+        return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const *>(value)), byteSwapMask);
+    }
+
+    //
+    // Returns x * x^n + next mod P, without reducing below 128 bits. The constants hold x^(n+64) mod P in the high and x^n mod P in the low half.
+    //
+    CRC64_CARRYLESS_MULTIPLY_TARGET
+    inline __m128i Fold(__in __m128i const & x, __in __m128i const & constants, __in __m128i const & next)
+    {
+        __m128i high = _mm_clmulepi64_si128(x, constants, 0x11);
+        __m128i low = _mm_clmulepi64_si128(x, constants, 0x00);
+        return _mm_xor_si128(_mm_xor_si128(high, low), next);
+    }
+
+    //
+    // Folds the input 64 bytes at a time into four 128 bit accumulators, then folds those into one
+    // and reduces its 16 bytes with the slice tables. Requires count >= CarrylessMultiplyMinimumCount.
+    //
+    CRC64_CARRYLESS_MULTIPLY_TARGET
+    ULONG64 UpdateCarrylessMultiply(
+        __in Crc64Tables const & tables,
+        __in ULONG64 crc,
+        __in byte const * value,
+        __in ULONG32 count)
+    {
+        __m128i const byteSwapMask = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        __m128i const fold512 = _mm_set_epi64x(static_cast<LONG64>(tables.Fold512High), static_cast<LONG64>(tables.Fold512Low));
+        __m128i const fold128 = _mm_set_epi64x(static_cast<LONG64>(tables.Fold128High), static_cast<LONG64>(tables.Fold128Low));
+
+        // Continuing from a CRC register is the same as xoring it into the first 8 bytes of the input.
+        __m128i x0 = _mm_xor_si128(LoadBigEndian(value, byteSwapMask), _mm_set_epi64x(static_cast<LONG64>(crc), 0));
+        __m128i x1 = LoadBigEndian(value + 16, byteSwapMask);
+        __m128i x2 = LoadBigEndian(value + 32, byteSwapMask);
+        __m128i x3 = LoadBigEndian(value + 48, byteSwapMask);
+        value += 64;
+        count -= 64;
+
+        while (count >= 64)
+        {
+            x0 = Fold(x0, fold512, LoadBigEndian(value, byteSwapMask));
+            x1 = Fold(x1, fold512, LoadBigEndian(value + 16, byteSwapMask));
+            x2 = Fold(x2, fold512, LoadBigEndian(value + 32, byteSwapMask));
+            x3 = Fold(x3, fold512, LoadBigEndian(value + 48, byteSwapMask));
+            value += 64;
+            count -= 64;
+        }
+
+        x0 = Fold(x0, fold128, x1);
+        x0 = Fold(x0, fold128, x2);
+        x0 = Fold(x0, fold128, x3);
+
+        while (count >= 16)
+        {
+            x0 = Fold(x0, fold128, LoadBigEndian(value, byteSwapMask));
+            value += 16;
+            count -= 16;
+        }
+
+        // The accumulator is congruent to the input so far; its CRC from a zero register is the CRC of that input.
+        byte remainder[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(remainder), _mm_shuffle_epi8(x0, byteSwapMask));
+        crc = UpdateSliceBy8(tables, 0, remainder, sizeof(remainder));
+
+        return UpdateSliceBy8(tables, crc, value, count);
+    }
+#endif
+}
+
+CRC64Implementation::Enum CRC64::GetImplementation()
+{
+    return GetCrc64Tables().Implementation;
+}
+
+bool CRC64::IsSupported(__in CRC64Implementation::Enum implementation)
+{
+    switch (implementation)
+    {
+    case CRC64Implementation::Table:
+    case CRC64Implementation::SliceBy8:
+        return true;
+    case CRC64Implementation::CarrylessMultiply:
+        return GetCrc64Tables().IsCarrylessMultiplySupported;
+    default:
+        return false;
+    }
+}
+
+ULONG64 CRC64::Update(
+    __in CRC64Implementation::Enum implementation,
+    __in ULONG64 crc,
+    __in byte const value[],
+    __in ULONG32 offset,
+    __in ULONG32 count)
+{
+    Crc64Tables const & tables = GetCrc64Tables();
+    byte const * start = value + offset;
+
+    switch (implementation)
+    {
+    case CRC64Implementation::Table:
+        return UpdateTable(crc, start, count);
+    case CRC64Implementation::SliceBy8:
+        return UpdateSliceBy8(tables, crc, start, count);
+    case CRC64Implementation::CarrylessMultiply:
+#if defined(CRC64_CARRYLESS_MULTIPLY_ENABLED)
+        ASSERT_IFNOT(tables.IsCarrylessMultiplySupported, "Carry-less multiply CRC64 is not supported by this processor");
+        if (count >= CarrylessMultiplyMinimumCount)
+        {
+            return UpdateCarrylessMultiply(tables, crc, start, count);
+        }
+
+        return UpdateSliceBy8(tables, crc, start, count);
+#else
+        ASSERT_IFNOT(false, "Carry-less multiply CRC64 is not supported on this architecture");
+        return crc;
+#endif
+    default:
+        ASSERT_IFNOT(false, "Unknown CRC64 implementation {0}", static_cast<int>(implementation));
+        return crc;
+    }
+}
+
+ULONG64 CRC64::Update(
+    __in ULONG64 crc,
+    __in byte const value[],
+    __in ULONG32 offset,
+    __in ULONG32 count)
+{
+    Crc64Tables const & tables = GetCrc64Tables();
+    byte const * start = value + offset;
+
+#if defined(CRC64_CARRYLESS_MULTIPLY_ENABLED)
+    if (count >= CarrylessMultiplyMinimumCount && tables.IsCarrylessMultiplySupported)
+    {
+        return UpdateCarrylessMultiply(tables, crc, start, count);
+    }
+#endif
+
+    return UpdateSliceBy8(tables, crc, start, count);
+}
+
+ULONG64 CRC64::Update(
+    __in ULONG64 crc,
+    __in KBuffer const & buffer,
+    __in ULONG32 offset,
+    __in ULONG32 count)
+{
+    return CRC64::Update(crc, static_cast<byte const *>(buffer.GetBuffer()), offset, count);
+}
+
+ULONG64 CRC64::Finalize(__in ULONG64 crc)
+{
+    return crc ^ 0xffffffffffffffff;
+}
+
 ULONG64 CRC64::ToCRC64(
    __in KBuffer const & buffer,
    __in ULONG32 offset,
@@ -279,15 +599,7 @@ ULONG64 CRC64::ToCRC64(
     __in ULONG32 offset,
     __in ULONG32 count)
 {
-    ULONG64 crc = 0xffffffffffffffff;
-
-    for (ULONG32 i = offset; i < offset + count; i++)
-    {
-        ULONG64 tableIndex = (static_cast<ULONG64>(crc >> 56) ^ value[i]) & 0xff;
-        crc = Crc64Table[tableIndex] ^ (crc << 8);
-    }
-
-    return crc ^ 0xffffffffffffffff;
+    return CRC64::Finalize(CRC64::Update(CRC64::InitialValue, value, offset, count));
 }
 
 ULONG64 CRC64::ToCRC64(
@@ -295,23 +607,17 @@ ULONG64 CRC64::ToCRC64(
     __in ULONG32 offset,
     __in ULONG32 count)
 {
-    ULONG64 crc = 0xffffffffffffffff;
+    ULONG64 crc = CRC64::InitialValue;
 
     ASSERT_IF(offset + count > operationData.BufferCount, "Offset + Count cannot be larger than BufferCount");
 
     for (ULONG32 bufferIndex = offset; bufferIndex < count + offset; bufferIndex++)
     {
         KBuffer::CSPtr bufferCSPtr = operationData[bufferIndex];
-        for (ULONG32 byteIndex = 0; byteIndex < bufferCSPtr->QuerySize(); byteIndex++)
-        {
-            void const * rawBuffer = bufferCSPtr->GetBuffer();
-            byte const * byteBuffer = static_cast<byte const *>(rawBuffer);
-            ULONG64 tableIndex = (static_cast<ULONG64>(crc >> 56) ^ byteBuffer[byteIndex]) & 0xff;
-            crc = Crc64Table[tableIndex] ^ (crc << 8);
-        }
+        crc = CRC64::Update(crc, *bufferCSPtr, 0, bufferCSPtr->QuerySize());
     }
 
-    return crc ^ 0xffffffffffffffff;
+    return CRC64::Finalize(crc);
 }
 
 ULONG64 CRC64::ToCRC64(
@@ -319,7 +625,7 @@ ULONG64 CRC64::ToCRC64(
     __in ULONG32 offset,
     __in ULONG32 count)
 {
-    ULONG64 crc = 0xffffffffffffffff;
+    ULONG64 crc = CRC64::InitialValue;
 
     ASSERT_IF(offset + count > operationDataArray.Count(), "Offset + Count cannot be larger than Count");
 
@@ -330,14 +636,9 @@ ULONG64 CRC64::ToCRC64(
         for (ULONG32 bufferIndex = 0; bufferIndex < operationDataCSPtr->BufferCount; bufferIndex++)
         {
             KBuffer::CSPtr bufferCSPtr = (*operationDataCSPtr)[bufferIndex];
-            for (ULONG32 byteIndex = 0; byteIndex < bufferCSPtr->QuerySize(); byteIndex++)
-            {
-                byte const * byteBuffer = static_cast<byte const *>(bufferCSPtr->GetBuffer());
-                ULONG64 tableIndex = (static_cast<ULONG64>(crc >> 56) ^ byteBuffer[byteIndex]) & 0xff;
-                crc = Crc64Table[tableIndex] ^ (crc << 8);
-            }
+            crc = CRC64::Update(crc, *bufferCSPtr, 0, bufferCSPtr->QuerySize());
         }
     }
 
-    return crc ^ 0xffffffffffffffff;
+    return CRC64::Finalize(crc);
 }
@@ -11,9 +11,63 @@ namespace Data
     {
         class OperationData;
 
+        namespace CRC64Implementation
+        {
+            enum Enum
+            {
+                // One byte per step through a 256 entry table.
+                Table = 0,
+
+                // Eight bytes per step through eight 256 entry tables.
+                SliceBy8 = 1,
+
+                // Folds 64 bytes per step with carry-less multiplication (PCLMULQDQ). Only available on x64 processors that support it.
+                CarrylessMultiply = 2,
+            };
+        }
+
+        //
+        // CRC-64 with polynomial 0x42F0E1EBA9EA3693, most significant bit first.
+        // The fastest implementation supported by the processor is selected on first use; all of them produce identical checksums.
+        //
+        // ToCRC64 checksums a whole input. Inputs that arrive in pieces can be checksummed incrementally instead:
+        //      ULONG64 crc = CRC64::InitialValue;
+        //      crc = CRC64::Update(crc, ...);
+        //      ULONG64 checksum = CRC64::Finalize(crc);
+        //
         class CRC64
         {
         public:
+            static const ULONG64 InitialValue = 0xffffffffffffffff;
+
+            static ULONG64 Update(
+                __in ULONG64 crc,
+                __in byte const value[],
+                __in ULONG32 offset,
+                __in ULONG32 count);
+
+            static ULONG64 Update(
+                __in ULONG64 crc,
+                __in KBuffer const & buffer,
+                __in ULONG32 offset,
+                __in ULONG32 count);
+
+            static ULONG64 Finalize(__in ULONG64 crc);
+
+            static CRC64Implementation::Enum GetImplementation();
+
+            static bool IsSupported(__in CRC64Implementation::Enum implementation);
+
+            //
+            // Update using the given implementation instead of the selected one. Exposed for testing and benchmarks.
+            //
+            static ULONG64 Update(
+                __in CRC64Implementation::Enum implementation,
+                __in ULONG64 crc,
+                __in byte const value[],
+                __in ULONG32 offset,
+                __in ULONG32 count);
+
             static ULONG64 ToCRC64(
                 __in KBuffer const & buffer,
                 __in ULONG32 offset,
@@ -29,7 +83,7 @@ namespace Data
                 __in ULONG32 offset,
                 __in ULONG32 count);
 
-            static::ULONG64 ToCRC64(
+            static ULONG64 ToCRC64(
                 __in KArray<KSharedPtr<const OperationData>> const & operationDataArray,
                 __in ULONG32 offset,
                 __in ULONG32 count);
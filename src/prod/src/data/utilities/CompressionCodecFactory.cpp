@@ -0,0 +1,36 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+using namespace Data;
+using namespace Data::Utilities;
+
+NTSTATUS CompressionCodecFactory::Create(
+    __in CompressionCodecId::Enum codecId,
+    __in KAllocator & allocator,
+    __out ICompressionCodec::SPtr & result)
+{
+    NTSTATUS status;
+
+    switch (codecId)
+    {
+    case CompressionCodecId::Lz:
+    {
+        LzCompressionCodec::SPtr lzCodecSPtr = nullptr;
+        status = LzCompressionCodec::Create(allocator, lzCodecSPtr);
+        if (!NT_SUCCESS(status))
+        {
+            return status;
+        }
+
+        result = lzCodecSPtr.RawPtr();
+        return STATUS_SUCCESS;
+    }
+
+    default:
+        return STATUS_NOT_SUPPORTED;
+    }
+}
@@ -0,0 +1,25 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace Utilities
+    {
+        class CompressionCodecFactory
+        {
+        public:
+            //
+            // Creates the codec for the given id.
+            // Returns STATUS_NOT_SUPPORTED for CompressionCodecId::None and for ids this binary does not know about.
+            //
+            static NTSTATUS Create(
+                __in CompressionCodecId::Enum codecId,
+                __in KAllocator & allocator,
+                __out ICompressionCodec::SPtr & result);
+        };
+    }
+}
@@ -95,6 +95,10 @@ namespace Data
 #include "ReaderWriterAsyncLock.h"
 #include "TaskUtilities.h"
 #include "CRC64.h"
+#include "ICompressionCodec.h"
+#include "LzCompressionCodec.h"
+#include "CompressionCodecFactory.h"
+#include "SlabAllocator.h"
 #include "BlockHandle.h"
 #include "FileBlock.h"
 #include "FileProperties.h"
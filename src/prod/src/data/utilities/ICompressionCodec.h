@@ -0,0 +1,64 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+namespace Data
+{
+    namespace Utilities
+    {
+        //
+        // Identifies a compression codec on disk and on the wire.
+        // Values are persisted, so existing entries must never be renumbered.
+        //
+        namespace CompressionCodecId
+        {
+            enum Enum : ULONG32
+            {
+                None = 0,
+                Lz = 1
+            };
+        }
+
+        //
+        // A self-contained, deterministic block compression codec.
+        // Implementations must not depend on external libraries, so that data written on one node can be decoded on any other.
+        //
+        interface ICompressionCodec
+        {
+            K_SHARED_INTERFACE(ICompressionCodec)
+
+        public:
+
+            __declspec(property(get = get_Id)) CompressionCodecId::Enum Id;
+            virtual CompressionCodecId::Enum get_Id() const = 0;
+
+            //
+            // Upper bound of the compressed size for an input of the given size.
+            //
+            virtual ULONG32 GetMaxCompressedSize(__in ULONG32 sourceSize) const = 0;
+
+            //
+            // Compresses source into destination.
+            // Returns the number of bytes written, or 0 if the output does not fit into destinationCapacity.
+            //
+            virtual ULONG32 Compress(
+                __in_bcount(sourceSize) byte const * source,
+                __in ULONG32 sourceSize,
+                __out_bcount(destinationCapacity) byte * destination,
+                __in ULONG32 destinationCapacity) const = 0;
+
+            //
+            // Decompresses source into destination, which must be exactly the original size.
+            // Returns STATUS_INTERNAL_DB_CORRUPTION if the input is malformed or does not decode to destinationSize bytes.
+            //
+            virtual NTSTATUS Decompress(
+                __in_bcount(sourceSize) byte const * source,
+                __in ULONG32 sourceSize,
+                __out_bcount(destinationSize) byte * destination,
+                __in ULONG32 destinationSize) const = 0;
+        };
+    }
+}
@@ -9,6 +9,7 @@
 using namespace Data::Utilities;
 
 LockHashValue::LockHashValue()
+   : fastPathGrant_(nullptr)
 {
    NTSTATUS status = LockResourceControlBlock::Create(this->GetThisAllocator(), lockResourceControlBlock_);
    this->SetConstructorStatus(status);
@@ -16,6 +17,11 @@ LockHashValue::LockHashValue()
 
 LockHashValue::~LockHashValue()
 {
+   PVOID grant = fastPathGrant_;
+   if (grant != nullptr && grant != this)
+   {
+      static_cast<LockControlBlock *>(grant)->Release();
+   }
 }
 
 NTSTATUS LockHashValue::Create(
@@ -38,24 +44,79 @@ NTSTATUS LockHashValue::Create(
    return STATUS_SUCCESS;
 }
 
+bool LockHashValue::TryAcquireFastPath(__in LockControlBlock & lockControlBlock)
+{
+   // The reference is owned by fastPathGrant_ as soon as the exchange succeeds, since another thread can move it to the granted list right away
+   lockControlBlock.AddRef();
+
+   if (InterlockedCompareExchangePointer(&fastPathGrant_, &lockControlBlock, nullptr) != nullptr)
+   {
+      lockControlBlock.Release();
+      return false;
+   }
+
+   return true;
+}
+
+bool LockHashValue::TryReleaseFastPath(__in LockControlBlock & lockControlBlock)
+{
+   if (InterlockedCompareExchangePointer(&fastPathGrant_, nullptr, &lockControlBlock) != &lockControlBlock)
+   {
+      return false;
+   }
+
+   lockControlBlock.Release();
+   return true;
+}
+
 void LockHashValue::EnterWriteLock()
 {
    lock_.Acquire();
+   MoveFastPathGrantToGrantedList();
 }
 
 void LockHashValue::ExitWriteLock()
 {
+   if (!lockResourceControlBlock_->HasClients())
+   {
+      // Open the resource to the fast path again
+      InterlockedExchangePointer(&fastPathGrant_, nullptr);
+   }
+
    lock_.Release();
 }
 
 void LockHashValue::EnterReadLock()
 {
-   lock_.Acquire();
+   EnterWriteLock();
 }
 
 void LockHashValue::ExitReadLock()
 {
-   lock_.Release();
+   ExitWriteLock();
+}
+
+void LockHashValue::MoveFastPathGrantToGrantedList()
+{
+   PVOID grant = InterlockedExchangePointer(&fastPathGrant_, this);
+   if (grant == nullptr || grant == this)
+   {
+      return;
+   }
+
+   // Takes over the reference held by fastPathGrant_
+   LockControlBlock::SPtr lockControlBlockSPtr;
+   lockControlBlockSPtr.Attach(static_cast<LockControlBlock *>(grant));
+
+   ASSERT_IFNOT(
+      lockResourceControlBlock_->GrantedList->Count() == 0 && lockResourceControlBlock_->WaitingQueue->Count() == 0,
+      "Resource granted on the fast path has other clients");
+
+   NTSTATUS status = lockResourceControlBlock_->GrantedList->Append(lockControlBlockSPtr);
+   ASSERT_IFNOT(NT_SUCCESS(status), "Failed to append to granted list. status={0}", status);
+
+   // A single grant is also the max lock mode of the resource
+   lockResourceControlBlock_->LockModeGranted = lockControlBlockSPtr->GetLockMode();
 }
 
 void LockHashValue::Close()
@@ -9,6 +9,18 @@ namespace Data
 {
    namespace Utilities
    {
+      //
+      // Second level lock entry for a single lock resource.
+      //
+      // A resource that is granted to a single lock control block and has no waiters is held in fastPathGrant_ instead of the granted list.
+      // Such a grant is taken and released with one interlocked compare exchange, without acquiring lock_.
+      // Any other request goes through EnterWriteLock, which moves the fast path grant into the granted list and keeps the
+      // resource on the slow path until it has no clients again:
+      //
+      //  nullptr             No clients. The next request can be granted on the fast path.
+      //  LockControlBlock*   Granted on the fast path to that lock control block, which is referenced by fastPathGrant_.
+      //  this                Granted list and waiting queue are in use and protected by lock_.
+      //
       class LockHashValue : public KObject<LockHashValue>, public KShared<LockHashValue>
       {
          K_FORCE_SHARED(LockHashValue)
@@ -30,6 +42,22 @@ namespace Data
             lockResourceControlBlock_ = &value;
          }
 
+         //
+         // Grants the resource to the given lock control block if it has no clients. Does not acquire the second level lock.
+         //
+         bool TryAcquireFastPath(__in LockControlBlock & lockControlBlock);
+
+         //
+         // Releases a grant taken by TryAcquireFastPath. Returns false if the grant has been moved to the granted list in the meantime.
+         //
+         bool TryReleaseFastPath(__in LockControlBlock & lockControlBlock);
+
+         __declspec(property(get = get_IsFastPathFree)) bool IsFastPathFree;
+         bool get_IsFastPathFree() const
+         {
+            return fastPathGrant_ == nullptr;
+         }
+
          void EnterWriteLock();
          void ExitWriteLock();
          void EnterReadLock();
@@ -37,8 +65,11 @@ namespace Data
          void Close();
 
       private:
+         void MoveFastPathGrantToGrantedList();
+
          LockResourceControlBlock::SPtr lockResourceControlBlock_;
          KSpinLock lock_;
+         PVOID volatile fastPathGrant_;
       };
    }
 }
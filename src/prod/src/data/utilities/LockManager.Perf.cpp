@@ -303,6 +303,104 @@ namespace UtilitiesTests
                 globalOpCount / duration.TotalSeconds());
         }
 
+        ktl::Awaitable<void> LockManager_AcquireReleaseMode_UntilCancelled(
+            __in ULONG32 taskId,
+            __in LockManager & lockManager,
+            __in ULONG64 key,
+            __in LockMode::Enum mode,
+            __in LONG64 & globalOpCount,
+            __in CancellationToken token)
+        {
+            co_await CorHelper::ThreadPoolThread(this->GetAllocator().GetKtlSystem().DefaultThreadPool());
+            LONG64 localOpCount = 0;
+            while (!token.IsCancellationRequested)
+            {
+                auto lock = co_await lockManager.AcquireLockAsync(
+                    taskId,
+                    key,
+                    mode,
+                    Common::TimeSpan::FromSeconds(4)
+                );
+
+                lockManager.ReleaseLock(*lock);
+                lock->Close();
+
+                localOpCount++;
+            }
+
+            InterlockedAdd64(&globalOpCount, localOpCount);
+        }
+
+        //
+        // Runs numTasks tasks that acquire and release locks in the given mode for the given duration and returns the total throughput.
+        // Tasks either share a single key, or each use a key of their own so that no two requests conflict.
+        //
+        ktl::Awaitable<LONG64> LockManager_Throughput(
+            __in Common::TimeSpan duration,
+            __in ULONG numTasks,
+            __in LockMode::Enum mode,
+            __in bool singleKey)
+        {
+            LockManager::SPtr lockManagerSPtr = nullptr;
+            NTSTATUS status = LockManager::Create(GetAllocator(), lockManagerSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            co_await lockManagerSPtr->OpenAsync();
+
+            ktl::CancellationTokenSource::SPtr tokenSource = nullptr;
+            status = ktl::CancellationTokenSource::Create(this->GetAllocator(), ALLOC_TAG, tokenSource);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            LONG64 globalOpCount = 0;
+
+            KSharedArray<ktl::Awaitable<void>>::SPtr tasks = _new(ALLOC_TAG, this->GetAllocator()) KSharedArray<ktl::Awaitable<void>>();
+            for (ULONG i = 0; i < numTasks; i++)
+            {
+                ULONG64 key = singleKey ? 5 : i;
+                tasks->Append(LockManager_AcquireReleaseMode_UntilCancelled(i, *lockManagerSPtr, key, mode, globalOpCount, tokenSource->Token));
+            }
+
+            // Offloading cancellation to Common Threadpool because current KTL 
+            // threadpool may starve this coroutine from running
+            Common::Threadpool::Post([&] {
+                tokenSource->Cancel();
+            }, duration);
+
+            co_await TaskUtilities<void>::WhenAll(*tasks);
+
+            co_await lockManagerSPtr->CloseAsync();
+            co_return static_cast<LONG64>(globalOpCount / duration.TotalSeconds());
+        }
+
+        //
+        // Prints read-lock and write-lock throughput for 1, 2, 4, ... tasks up to twice the processor count.
+        // Scaling is reported relative to the single task throughput of the same mode.
+        //
+        void LockManager_MultiCoreScaling(
+            __in Common::TimeSpan duration,
+            __in LockMode::Enum mode,
+            __in bool singleKey)
+        {
+            ULONG maxTasks = 2 * Common::Environment::GetNumberOfProcessors();
+            LONG64 baseline = 0;
+
+            for (ULONG numTasks = 1; numTasks <= maxTasks; numTasks *= 2)
+            {
+                LONG64 opsPerSecond = SyncAwait(LockManager_Throughput(duration, numTasks, mode, singleKey));
+                if (numTasks == 1)
+                {
+                    baseline = opsPerSecond == 0 ? 1 : opsPerSecond;
+                }
+
+                cout << Common::formatString(
+                    "LockManager {0} {1}: Tasks: {2} Throughput: {3} ops/sec Scaling: {4}",
+                    mode == LockMode::Enum::Shared ? "read-lock" : "write-lock",
+                    singleKey ? "single key" : "key per task",
+                    numTasks,
+                    opsPerSecond,
+                    static_cast<double>(opsPerSecond) / baseline) << endl;
+            }
+        }
+
     private:
         KtlSystem* ktlSystem_;
         LockManager::SPtr lockManagerSPtr_;
@@ -381,5 +479,17 @@ namespace UtilitiesTests
         SyncAwait(LockManager_SingleKeyRead_Throughput(Common::TimeSpan::FromSeconds(180), 12));
     }
 
+    BOOST_AUTO_TEST_CASE(LockManagerPerf_ReadLock_MultiCoreScaling, *boost::unit_test::label("perf-cit"))
+    {
+        LockManager_MultiCoreScaling(Common::TimeSpan::FromSeconds(10), LockMode::Enum::Shared, true);
+        LockManager_MultiCoreScaling(Common::TimeSpan::FromSeconds(10), LockMode::Enum::Shared, false);
+    }
+
+    BOOST_AUTO_TEST_CASE(LockManagerPerf_WriteLock_MultiCoreScaling, *boost::unit_test::label("perf-cit"))
+    {
+        LockManager_MultiCoreScaling(Common::TimeSpan::FromSeconds(10), LockMode::Enum::Exclusive, true);
+        LockManager_MultiCoreScaling(Common::TimeSpan::FromSeconds(10), LockMode::Enum::Exclusive, false);
+    }
+
     BOOST_AUTO_TEST_SUITE_END()
 }
@@ -1651,6 +1651,57 @@ namespace UtilitiesTests
            existingTxn1Writer->Close();
            co_return;
        }
+
+        ktl::Awaitable<void> AcquireRelease_FastPathAndWaiters_SameKey_ShouldSucceed_Test()
+       {
+           LockManager::SPtr lockManagerSPtr = LockManagerTest::CreateLockManager();
+           ULONG64 key = 100;
+
+           for (ULONG32 round = 0; round < 3; round++)
+           {
+               // Uncontended writer is granted without touching the granted list
+               auto writer = co_await lockManagerSPtr->AcquireLockAsync(1, key, LockMode::Enum::Exclusive, TimeSpan::MaxValue);
+               CODING_ERROR_ASSERT(writer->GetStatus() == LockStatus::Enum::Granted);
+
+               // Conflicting readers have to wait for the writer
+               auto reader1Awaitable = lockManagerSPtr->AcquireLockAsync(2, key, LockMode::Enum::Shared, TimeSpan::MaxValue);
+               auto reader2Awaitable = lockManagerSPtr->AcquireLockAsync(3, key, LockMode::Enum::Shared, TimeSpan::MaxValue);
+               CODING_ERROR_ASSERT(reader1Awaitable.IsComplete() == false);
+               CODING_ERROR_ASSERT(reader2Awaitable.IsComplete() == false);
+
+               // Duplicate request from the writer is granted from the granted list
+               auto duplicateWriter = co_await lockManagerSPtr->AcquireLockAsync(1, key, LockMode::Enum::Exclusive, TimeSpan::MaxValue);
+               CODING_ERROR_ASSERT(duplicateWriter.RawPtr() == writer.RawPtr());
+               CODING_ERROR_ASSERT(duplicateWriter->LockCount == 2);
+
+               CODING_ERROR_ASSERT(UnlockStatus::Enum::Success == lockManagerSPtr->ReleaseLock(*writer));
+               CODING_ERROR_ASSERT(reader1Awaitable.IsComplete() == false);
+               CODING_ERROR_ASSERT(UnlockStatus::Enum::Success == lockManagerSPtr->ReleaseLock(*writer));
+               writer->Close();
+
+               auto reader1 = co_await reader1Awaitable;
+               auto reader2 = co_await reader2Awaitable;
+               CODING_ERROR_ASSERT(reader1->GetStatus() == LockStatus::Enum::Granted);
+               CODING_ERROR_ASSERT(reader2->GetStatus() == LockStatus::Enum::Granted);
+
+               CODING_ERROR_ASSERT(UnlockStatus::Enum::Success == lockManagerSPtr->ReleaseLock(*reader1));
+               CODING_ERROR_ASSERT(UnlockStatus::Enum::Success == lockManagerSPtr->ReleaseLock(*reader2));
+               reader1->Close();
+               reader2->Close();
+
+               // Released locks are not granted anymore, whichever path granted them
+               CODING_ERROR_ASSERT(UnlockStatus::Enum::NotGranted == lockManagerSPtr->ReleaseLock(*reader1));
+
+               // Once the resource has no clients again, a writer from another owner is granted immediately
+               auto otherWriter = co_await lockManagerSPtr->AcquireLockAsync(4, key, LockMode::Enum::Exclusive, TimeSpan::Zero);
+               CODING_ERROR_ASSERT(otherWriter->GetStatus() == LockStatus::Enum::Granted);
+               CODING_ERROR_ASSERT(UnlockStatus::Enum::Success == lockManagerSPtr->ReleaseLock(*otherWriter));
+               CODING_ERROR_ASSERT(UnlockStatus::Enum::NotGranted == lockManagerSPtr->ReleaseLock(*otherWriter));
+               otherWriter->Close();
+           }
+
+           co_return;
+       }
     #pragma endregion
    };
 
@@ -1991,6 +2042,11 @@ namespace UtilitiesTests
        SyncAwait(AcquireLocks_AfterReleasingWriter_WithExistingWriter_ShouldBeExclusiveMode_Test());
    }
 
+   BOOST_AUTO_TEST_CASE(AcquireRelease_FastPathAndWaiters_SameKey_ShouldSucceed)
+   {
+       SyncAwait(AcquireRelease_FastPathAndWaiters_SameKey_ShouldSucceed_Test());
+   }
+
    BOOST_AUTO_TEST_SUITE_END()
 }
 
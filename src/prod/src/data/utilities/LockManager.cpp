@@ -10,48 +10,15 @@ using namespace Data::Utilities;
 
 #define LOCKMANAGER_TAG 'rgML'
 
-ULONG MyHashFunction(const LockMode::Enum& Val)
-{
-   return ~Val;
-}
+constexpr LockCompatibility::Enum LockManager::LockCompatibilityTable[LockManager::LockModeCount][LockManager::LockModeCount];
+constexpr LockMode::Enum LockManager::LockConversionTable[LockManager::LockModeCount][LockManager::LockModeCount];
 
 LockManager::LockManager() :
     tableLockSPtr_(nullptr),
     lockReleasedCleanupInProgress_(GetThisAllocator(), lockHashTableCount_),
     lockHashTables_(GetThisAllocator(), lockHashTableCount_),
-    status_(false),
-    lockCompatibilityTableSPtr_(nullptr),
-    lockConversionTableSPtr_(nullptr),
-    lockModeComparerSPtr_(nullptr)
+    status_(false)
 {
-    NTSTATUS status = LockModeComparer::Create(this->GetThisAllocator(), lockModeComparerSPtr_);
-    if (!NT_SUCCESS(status))
-    {
-        this->SetConstructorStatus(status);
-        return;
-    }
-
-    status = Dictionary<LockMode::Enum, KSharedPtr<Dictionary<LockMode::Enum, LockCompatibility::Enum>>>::Create(32, MyHashFunction, *lockModeComparerSPtr_, this->GetThisAllocator(), lockCompatibilityTableSPtr_);
-    if (!NT_SUCCESS(status))
-    {
-        this->SetConstructorStatus(status);
-        return;
-    }
-
-    status = Dictionary<LockMode::Enum, KSharedPtr<Dictionary<LockMode::Enum, LockMode::Enum>>>::Create(32, MyHashFunction, *lockModeComparerSPtr_, this->GetThisAllocator(), lockConversionTableSPtr_);
-    if (!NT_SUCCESS(status))
-    {
-       this->SetConstructorStatus(status);
-    }
-
-    status = LoadCompatibilityMatrix();
-    if (!NT_SUCCESS(status))
-    {
-       this->SetConstructorStatus(status);
-    }
-
-    status = LoadConversionMatrix();
-    this->SetConstructorStatus(status);
 }
 
 LockManager::~LockManager()
@@ -210,6 +177,46 @@ ktl::Awaitable<void> LockManager::CloseAsync() noexcept
        tableLockMode = LockMode::Enum::Exclusive;
     }
 
+    //
+    // A resource without clients is granted on the fast path, without acquiring the second level lock.
+    //
+    if (lockHashFound && lockHashValueSPtr->IsFastPathFree)
+    {
+       LockControlBlock::SPtr lockControlBlockSPtr = nullptr;
+       status = LockControlBlock::Create(*this, owner, resourceNameHash, mode, timeout, LockStatus::Granted, false, GetThisAllocator(), lockControlBlockSPtr);
+       THROW_ON_FAILURE(status);
+       lockControlBlockSPtr->SetGrantedTime(KDateTime::Now());
+
+       if (lockHashValueSPtr->TryAcquireFastPath(*lockControlBlockSPtr))
+       {
+          // The resource had no clients, so it was counted as an empty lock
+          lockHashTableSPtr->DecrementEmptyLocksCount();
+
+          //
+          // Release first level lock.
+          //
+          switch (tableLockMode)
+          {
+          case LockMode::Shared:
+              lockHashTableSPtr->ExitReadLock();
+              break;
+          case LockMode::Exclusive:
+              lockHashTableSPtr->ExitWriteLock();
+              break;
+          default:
+              ASSERT_IFNOT(false, "Unhandled lock mode={0}", static_cast<int>(tableLockMode));
+          }
+
+          //
+          // Return immediately.
+          //
+          waiterTcs->SetResult(lockControlBlockSPtr);
+          return waiterTcs->GetAwaitable();
+       }
+
+       // Lost the race against another request for the same resource
+    }
+
     //
     // Find the lock resource entry, if it exists.
     //
@@ -466,19 +473,14 @@ ktl::Awaitable<void> LockManager::CloseAsync() noexcept
        lockControlBlockSPtr->SetGrantedTime(KDateTime::Now());
 
        //
-       // Add the new lock control block to the granted list.
+       // Grant the new resource on the fast path. It is only visible under the first level lock, which is held exclusively.
        //
-       status = lockHashValueSPtr->ResourceControlBlock->GrantedList->Append(lockControlBlockSPtr);
-       KInvariant(NT_SUCCESS(status));
+       bool isGrantedOnFastPath = lockHashValueSPtr->TryAcquireFastPath(*lockControlBlockSPtr);
+       KInvariant(isGrantedOnFastPath);
 
        // Lock is no longer empty, cancelling out increment above
        // lockHashTableSPtr->DecrementEmptyLocksCount();
 
-       //
-       // Set the lock resource granted lock status.
-       //
-       lockHashValueSPtr->ResourceControlBlock->LockModeGranted = ConvertToMaxLockMode(mode, LockMode::Enum::Free);
-
        //
        // Release first level lock.
        //
@@ -527,6 +529,34 @@ ktl::Awaitable<void> LockManager::CloseAsync() noexcept
             ASSERT_IFNOT(task.IsTaskStarted(), "Failed to start clear locks background task");
         }
 
+       //
+       // A lock granted on the fast path is released without acquiring the second level lock.
+       // The resource is counted as empty before the grant is given up, so a fast path acquire that follows cannot decrement the count first.
+       //
+       lockHashTableSPtr->IncrementEmptyLocksCount();
+       if (lockHashValueSPtr->TryReleaseFastPath(acquiredLock))
+       {
+          //
+          // Release first level lock.
+          //
+          lockHashTableSPtr->ExitReadLock();
+
+          acquiredLock.LockCount--;
+          ASSERT_IFNOT(acquiredLock.LockCount == 0, "Lock granted on the fast path has count={0}", acquiredLock.LockCount);
+
+          //
+          // This lock control block cannot be reused after this call.
+          //
+          if (acquiredLock.StopExpire())
+          {
+             acquiredLock.Close();
+          }
+
+          return UnlockStatus::Enum::Success;
+       }
+
+       lockHashTableSPtr->DecrementEmptyLocksCount();
+
        //
        // Acquire second level lock.
        //
@@ -1100,158 +1130,16 @@ ktl::Awaitable<void> LockManager::CloseAsync() noexcept
     __in LockMode::Enum modeRequested,
     __in LockMode::Enum modeGranted)
  {
-    Dictionary<LockMode::Enum, LockCompatibility::Enum>::SPtr  grantedModeSPtr = nullptr;
-    bool result = lockCompatibilityTableSPtr_->TryGetValue(modeGranted, grantedModeSPtr);
-    KInvariant(result == true);
-
-    LockCompatibility::Enum compatibility;
-    result = grantedModeSPtr->TryGetValue(modeRequested, compatibility);
-    KInvariant(result == true);
-
-    return compatibility == LockCompatibility::Enum::NoConflict;
+    KInvariant(modeRequested < LockModeCount && modeGranted < LockModeCount);
+    return LockCompatibilityTable[modeGranted][modeRequested] == LockCompatibility::Enum::NoConflict;
  }
 
  LockMode::Enum LockManager::ConvertToMaxLockMode(
     __in LockMode::Enum modeRequested,
     __in LockMode::Enum modeGranted)
  {
-    Dictionary<LockMode::Enum, LockMode::Enum>::SPtr  grantedModeSPtr = nullptr;
-    bool result = lockConversionTableSPtr_->TryGetValue(modeGranted, grantedModeSPtr);
-    KInvariant(result == true);
-
-    LockMode::Enum newMode;
-    result = grantedModeSPtr->TryGetValue(modeRequested, newMode);
-    return newMode;
- }  
-
- NTSTATUS LockManager::LoadCompatibilityMatrix()
- {
-    // Free mode
-    Dictionary<LockMode::Enum, LockCompatibility::Enum>::SPtr freeTableSPtr;
-    NTSTATUS status = Dictionary<LockMode::Enum, LockCompatibility::Enum>::Create(32, MyHashFunction, *lockModeComparerSPtr_, GetThisAllocator(), freeTableSPtr);
-    if (!NT_SUCCESS(status))
-    {
-       return status;
-    }
-
-    Add(*lockCompatibilityTableSPtr_, LockMode::Enum::Free, freeTableSPtr);
-
-    Add(*freeTableSPtr, LockMode::Enum::Free, LockCompatibility::Enum::NoConflict);
-    Add(*freeTableSPtr, LockMode::Enum::Shared, LockCompatibility::Enum::NoConflict);
-    Add(*freeTableSPtr, LockMode::Enum::Exclusive, LockCompatibility::Enum::NoConflict);
-    Add(*freeTableSPtr, LockMode::Enum::Update, LockCompatibility::Enum::NoConflict);
-
-    // Shared mode
-    Dictionary<LockMode::Enum, LockCompatibility::Enum>::SPtr sharedTableSPtr;
-    status = Dictionary<LockMode::Enum, LockCompatibility::Enum>::Create(32, MyHashFunction, *lockModeComparerSPtr_, GetThisAllocator(), sharedTableSPtr);
-    if (!NT_SUCCESS(status))
-    {
-       return status;
-    }
-
-    Add(*lockCompatibilityTableSPtr_, LockMode::Enum::Shared, sharedTableSPtr);
-
-    Add(*sharedTableSPtr, LockMode::Enum::Free, LockCompatibility::Enum::NoConflict);
-    Add(*sharedTableSPtr, LockMode::Enum::Shared, LockCompatibility::Enum::NoConflict);
-    Add(*sharedTableSPtr, LockMode::Enum::Exclusive, LockCompatibility::Enum::Conflict);
-    Add(*sharedTableSPtr, LockMode::Enum::Update, LockCompatibility::Enum::NoConflict);
-
-    // Exclusive mode
-    Dictionary<LockMode::Enum, LockCompatibility::Enum>::SPtr exclusiveTableSPtr;
-    status = Dictionary<LockMode::Enum, LockCompatibility::Enum>::Create(32, MyHashFunction, *lockModeComparerSPtr_, GetThisAllocator(), exclusiveTableSPtr);
-    if (!NT_SUCCESS(status))
-    {
-       return status;
-    }
-
-    Add(*lockCompatibilityTableSPtr_, LockMode::Enum::Exclusive, exclusiveTableSPtr);
-
-    Add(*exclusiveTableSPtr, LockMode::Enum::Free, LockCompatibility::Enum::NoConflict);
-    Add(*exclusiveTableSPtr, LockMode::Enum::Shared, LockCompatibility::Enum::Conflict);
-    Add(*exclusiveTableSPtr, LockMode::Enum::Exclusive, LockCompatibility::Enum::Conflict);
-    Add(*exclusiveTableSPtr, LockMode::Enum::Update, LockCompatibility::Enum::Conflict);
-
-    // Update mode
-    Dictionary<LockMode::Enum, LockCompatibility::Enum>::SPtr updateTableSPtr;
-    status = Dictionary<LockMode::Enum, LockCompatibility::Enum>::Create(32, MyHashFunction, *lockModeComparerSPtr_, GetThisAllocator(), updateTableSPtr);
-    if (!NT_SUCCESS(status))
-    {
-       return status;
-    }
-
-    Add(*lockCompatibilityTableSPtr_, LockMode::Enum::Update, updateTableSPtr);
-
-    Add(*updateTableSPtr, LockMode::Enum::Free, LockCompatibility::Enum::NoConflict);
-    Add(*updateTableSPtr, LockMode::Enum::Shared, LockCompatibility::Enum::Conflict);
-    Add(*updateTableSPtr, LockMode::Enum::Exclusive, LockCompatibility::Enum::Conflict);
-    Add(*updateTableSPtr, LockMode::Enum::Update, LockCompatibility::Enum::Conflict);
-
-    return status;
- }
-
- NTSTATUS LockManager::LoadConversionMatrix()
- {
-    // Free mode
-    Dictionary<LockMode::Enum, LockMode::Enum>::SPtr freeTableSPtr;
-    NTSTATUS status = Dictionary<LockMode::Enum, LockMode::Enum>::Create(32, MyHashFunction, *lockModeComparerSPtr_, GetThisAllocator(), freeTableSPtr);
-    if (!NT_SUCCESS(status))
-    {
-       return status;
-    }
-
-    Add(*lockConversionTableSPtr_, LockMode::Enum::Free, freeTableSPtr);
-
-    Add(*freeTableSPtr, LockMode::Enum::Free, LockMode::Enum::Free);
-    Add(*freeTableSPtr, LockMode::Enum::Shared, LockMode::Enum::Shared);
-    Add(*freeTableSPtr, LockMode::Enum::Exclusive, LockMode::Enum::Exclusive);
-    Add(*freeTableSPtr, LockMode::Enum::Update, LockMode::Enum::Update);
-
-    // Shared mode
-    Dictionary<LockMode::Enum, LockMode::Enum>::SPtr sharedTableSPtr;
-    status = Dictionary<LockMode::Enum, LockMode::Enum>::Create(32, MyHashFunction, *lockModeComparerSPtr_, GetThisAllocator(), sharedTableSPtr);
-    if (!NT_SUCCESS(status))
-    {
-       return status;
-    }
-
-    Add(*lockConversionTableSPtr_,LockMode::Enum::Shared, sharedTableSPtr);
-
-    Add(*sharedTableSPtr, LockMode::Enum::Free, LockMode::Enum::Shared);
-    Add(*sharedTableSPtr, LockMode::Enum::Shared, LockMode::Enum::Shared);
-    Add(*sharedTableSPtr, LockMode::Enum::Exclusive, LockMode::Enum::Exclusive);
-    Add(*sharedTableSPtr, LockMode::Enum::Update, LockMode::Enum::Update);
-
-    // Exclusive mode
-    Dictionary<LockMode::Enum, LockMode::Enum>::SPtr exclusiveTableSPtr;
-    status = Dictionary<LockMode::Enum, LockMode::Enum>::Create(32, MyHashFunction, *lockModeComparerSPtr_, GetThisAllocator(), exclusiveTableSPtr);
-    if (!NT_SUCCESS(status))
-    {
-       return status;
-    }
-
-    Add(*lockConversionTableSPtr_, LockMode::Enum::Exclusive, exclusiveTableSPtr);
-
-    Add(*exclusiveTableSPtr, LockMode::Enum::Free, LockMode::Enum::Exclusive);
-    Add(*exclusiveTableSPtr, LockMode::Enum::Shared, LockMode::Enum::Exclusive);
-    Add(*exclusiveTableSPtr, LockMode::Enum::Exclusive, LockMode::Enum::Exclusive);
-    Add(*exclusiveTableSPtr, LockMode::Enum::Update, LockMode::Enum::Exclusive);
-
-    // Update mode
-    Dictionary<LockMode::Enum, LockMode::Enum>::SPtr updateTableSPtr;
-    status = Dictionary<LockMode::Enum, LockMode::Enum>::Create(32, MyHashFunction, *lockModeComparerSPtr_, GetThisAllocator(), updateTableSPtr);
-    if (!NT_SUCCESS(status))
-    {
-       return status;
-    }
-
-    Add(*lockConversionTableSPtr_, LockMode::Enum::Update, updateTableSPtr);
-
-    Add(*updateTableSPtr, LockMode::Enum::Free, LockMode::Enum::Update);
-    Add(*updateTableSPtr, LockMode::Enum::Shared, LockMode::Enum::Update);
-    Add(*updateTableSPtr, LockMode::Enum::Exclusive, LockMode::Enum::Exclusive);
-    Add(*updateTableSPtr, LockMode::Enum::Update, LockMode::Enum::Update);
-
-    return status;
+    KInvariant(modeRequested < LockModeCount && modeGranted < LockModeCount);
+    return LockConversionTable[modeGranted][modeRequested];
  }
 
  bool LockManager::IsShared(__in LockMode::Enum mode)
@@ -1429,35 +1317,3 @@ ktl::Awaitable<void> LockManager::CloseAsync() noexcept
          lockHashTableSPtr->ExitWriteLock();
      }
  }
-
- void LockManager::Add(
-    __in Dictionary<LockMode::Enum, LockMode::Enum>& dictionary,
-    __in LockMode::Enum key,
-    __in LockMode::Enum value)
- {
-    dictionary.Add(key, value);
- }
-
- void LockManager::Add(
-    __in Dictionary<LockMode::Enum, LockCompatibility::Enum>& dictionary,
-    __in LockMode::Enum key,
-    __in LockCompatibility::Enum value)
- {
-    dictionary.Add(key, value);
- }
-
- void LockManager::Add(
-    __in Dictionary<LockMode::Enum, KSharedPtr<Dictionary<LockMode::Enum, LockCompatibility::Enum>>>& dictionary,
-    __in LockMode::Enum key,
-    __in KSharedPtr<Dictionary<LockMode::Enum, LockCompatibility::Enum>> value)
- {
-    dictionary.Add(key, value);
- }
-
- void LockManager::Add(
-    __in Dictionary<LockMode::Enum, KSharedPtr<Dictionary<LockMode::Enum, LockMode::Enum>>>& dictionary,
-    __in LockMode::Enum key,
-    __in KSharedPtr<Dictionary<LockMode::Enum, LockMode::Enum>> value)
- {
-    dictionary.Add(key, value);
- }
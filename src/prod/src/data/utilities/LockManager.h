@@ -71,31 +71,11 @@ namespace Data
             void Open();
             void Close();
 
-            static void Add(
-                __in Dictionary<LockMode::Enum, LockMode::Enum>& dictionary,
-                __in LockMode::Enum key,
-                __in LockMode::Enum value);
-
-            static void Add(
-                __in Dictionary<LockMode::Enum, LockCompatibility::Enum>& dictionary,
-                __in LockMode::Enum key,
-                __in LockCompatibility::Enum value);
-
-            static void Add(
-                __in Dictionary<LockMode::Enum, KSharedPtr<Dictionary<LockMode::Enum, LockCompatibility::Enum>>>& dictionary,
-                __in LockMode::Enum key,
-                __in KSharedPtr<Dictionary<LockMode::Enum, LockCompatibility::Enum>> value);
-
-            static void Add(
-                __in Dictionary<LockMode::Enum, KSharedPtr<Dictionary<LockMode::Enum, LockMode::Enum>>>& dictionary,
-                __in LockMode::Enum key,
-                __in KSharedPtr<Dictionary<LockMode::Enum, LockMode::Enum>> value);
-
-            bool IsCompatible(
+            static bool IsCompatible(
                 __in LockMode::Enum modeRequested,
                 __in LockMode::Enum modeGranted);
 
-            LockMode::Enum ConvertToMaxLockMode(
+            static LockMode::Enum ConvertToMaxLockMode(
                 __in LockMode::Enum modeRequested,
                 __in LockMode::Enum modeGranted);
 
@@ -111,10 +91,6 @@ namespace Data
                 __in LockResourceControlBlock & lockResourceControlBlock,
                 __in LockControlBlock & releasedLock);
 
-            NTSTATUS LoadCompatibilityMatrix();
-
-            NTSTATUS LoadConversionMatrix();
-
             LONG32 GetIndex(
                 __in KSharedArray<KSharedPtr<LockControlBlock>> const & array, 
                 __in LockControlBlock const & item);
@@ -129,16 +105,37 @@ namespace Data
             KArray<LONG64> lockReleasedCleanupInProgress_;
             KArray<LockHashTable::SPtr> lockHashTables_;
             bool status_;
-            KSharedPtr<IComparer<LockMode::Enum>> lockModeComparerSPtr_;
 
             //
             // Minimum numbers of entries in the hash table whose locks can be cleared.
             //
             ULONG32 clearLocksThreshold_ = 128;
 
-            Dictionary<LockMode::Enum, KSharedPtr<Dictionary<LockMode::Enum, LockCompatibility::Enum>>>::SPtr lockCompatibilityTableSPtr_;
+            static const ULONG32 LockModeCount = LockMode::Enum::Update + 1;
 
-            Dictionary<LockMode::Enum, KSharedPtr<Dictionary<LockMode::Enum, LockMode::Enum>>>::SPtr lockConversionTableSPtr_;
+            //
+            // Indexed by [modeGranted][modeRequested].
+            //
+            static constexpr LockCompatibility::Enum LockCompatibilityTable[LockModeCount][LockModeCount] =
+            {
+                //                    Free                                 Shared                               Exclusive                            Update
+                /* Free */          { LockCompatibility::Enum::NoConflict, LockCompatibility::Enum::NoConflict, LockCompatibility::Enum::NoConflict, LockCompatibility::Enum::NoConflict },
+                /* Shared */        { LockCompatibility::Enum::NoConflict, LockCompatibility::Enum::NoConflict, LockCompatibility::Enum::Conflict,   LockCompatibility::Enum::NoConflict },
+                /* Exclusive */     { LockCompatibility::Enum::NoConflict, LockCompatibility::Enum::Conflict,   LockCompatibility::Enum::Conflict,   LockCompatibility::Enum::Conflict },
+                /* Update */        { LockCompatibility::Enum::NoConflict, LockCompatibility::Enum::Conflict,   LockCompatibility::Enum::Conflict,   LockCompatibility::Enum::Conflict },
+            };
+
+            //
+            // Indexed by [modeGranted][modeRequested].
+            //
+            static constexpr LockMode::Enum LockConversionTable[LockModeCount][LockModeCount] =
+            {
+                //                    Free                        Shared                      Exclusive                   Update
+                /* Free */          { LockMode::Enum::Free,       LockMode::Enum::Shared,     LockMode::Enum::Exclusive,  LockMode::Enum::Update },
+                /* Shared */        { LockMode::Enum::Shared,     LockMode::Enum::Shared,     LockMode::Enum::Exclusive,  LockMode::Enum::Update },
+                /* Exclusive */     { LockMode::Enum::Exclusive,  LockMode::Enum::Exclusive,  LockMode::Enum::Exclusive,  LockMode::Enum::Exclusive },
+                /* Update */        { LockMode::Enum::Update,     LockMode::Enum::Update,     LockMode::Enum::Exclusive,  LockMode::Enum::Update },
+            };
         };
     }
 }
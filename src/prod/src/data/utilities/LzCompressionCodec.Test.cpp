@@ -0,0 +1,191 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+#include <boost/test/unit_test.hpp>
+#include "Common/boost-taef.h"
+
+namespace UtilitiesTests
+{
+    using namespace ktl;
+    using namespace Data;
+    using namespace Data::Utilities;
+
+    class LzCompressionCodecTest
+    {
+    public:
+        Common::CommonConfig config; // load the config object as its needed for the tracing to work
+
+        LzCompressionCodecTest()
+        {
+            NTSTATUS status;
+            status = KtlSystem::Initialize(FALSE, &ktlSystem_);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            ktlSystem_->SetStrictAllocationChecks(TRUE);
+        }
+
+        ~LzCompressionCodecTest()
+        {
+            ktlSystem_->Shutdown();
+        }
+
+        KAllocator& GetAllocator()
+        {
+            return ktlSystem_->NonPagedAllocator();
+        }
+
+        ICompressionCodec::SPtr CreateCodec()
+        {
+            ICompressionCodec::SPtr codecSPtr = nullptr;
+            NTSTATUS status = CompressionCodecFactory::Create(CompressionCodecId::Lz, GetAllocator(), codecSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            CODING_ERROR_ASSERT(codecSPtr->Id == CompressionCodecId::Lz);
+            return codecSPtr;
+        }
+
+        KBuffer::SPtr CreateBuffer(__in ULONG32 size)
+        {
+            KBuffer::SPtr bufferSPtr = nullptr;
+            NTSTATUS status = KBuffer::Create(size, bufferSPtr, GetAllocator());
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            return bufferSPtr;
+        }
+
+        ULONG32 Compress(
+            __in ICompressionCodec & codec,
+            __in KBuffer & source,
+            __out KBuffer::SPtr & compressed)
+        {
+            compressed = CreateBuffer(codec.GetMaxCompressedSize(source.QuerySize()) + 1);
+            return codec.Compress(
+                static_cast<byte const *>(source.GetBuffer()),
+                source.QuerySize(),
+                static_cast<byte *>(compressed->GetBuffer()),
+                compressed->QuerySize());
+        }
+
+        void VerifyRoundTrip(__in KBuffer & source)
+        {
+            ICompressionCodec::SPtr codecSPtr = CreateCodec();
+
+            KBuffer::SPtr compressedSPtr = nullptr;
+            ULONG32 compressedSize = Compress(*codecSPtr, source, compressedSPtr);
+            CODING_ERROR_ASSERT(compressedSize > 0);
+            CODING_ERROR_ASSERT(compressedSize <= codecSPtr->GetMaxCompressedSize(source.QuerySize()));
+
+            KBuffer::SPtr decompressedSPtr = CreateBuffer(source.QuerySize());
+            NTSTATUS status = codecSPtr->Decompress(
+                static_cast<byte const *>(compressedSPtr->GetBuffer()),
+                compressedSize,
+                static_cast<byte *>(decompressedSPtr->GetBuffer()),
+                source.QuerySize());
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            CODING_ERROR_ASSERT(memcmp(decompressedSPtr->GetBuffer(), source.GetBuffer(), source.QuerySize()) == 0);
+        }
+
+    private:
+        KtlSystem* ktlSystem_;
+    };
+
+    BOOST_FIXTURE_TEST_SUITE(LzCompressionCodecTestSuite, LzCompressionCodecTest)
+
+    BOOST_AUTO_TEST_CASE(LzCompressionCodec_RepetitiveInput_ShouldShrinkAndRoundTrip)
+    {
+        ULONG32 size = 64 * 1024;
+        KBuffer::SPtr sourceSPtr = CreateBuffer(size);
+        byte * source = static_cast<byte *>(sourceSPtr->GetBuffer());
+        for (ULONG32 i = 0; i < size; i++)
+        {
+            source[i] = static_cast<byte>((i / 16) % 7);
+        }
+
+        KBuffer::SPtr compressedSPtr = nullptr;
+        ULONG32 compressedSize = Compress(*CreateCodec(), *sourceSPtr, compressedSPtr);
+        CODING_ERROR_ASSERT(compressedSize > 0);
+        CODING_ERROR_ASSERT(compressedSize < size / 10);
+
+        VerifyRoundTrip(*sourceSPtr);
+    }
+
+    BOOST_AUTO_TEST_CASE(LzCompressionCodec_RandomInput_ShouldRoundTrip)
+    {
+        Common::Random random(7);
+
+        for (ULONG32 size = 1; size < 20000; size = size * 3 + 1)
+        {
+            KBuffer::SPtr sourceSPtr = CreateBuffer(size);
+            byte * source = static_cast<byte *>(sourceSPtr->GetBuffer());
+            for (ULONG32 i = 0; i < size; i++)
+            {
+                source[i] = static_cast<byte>(random.Next());
+            }
+
+            VerifyRoundTrip(*sourceSPtr);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(LzCompressionCodec_SmallDestination_ShouldReturnZero)
+    {
+        ULONG32 size = 4096;
+        KBuffer::SPtr sourceSPtr = CreateBuffer(size);
+        Common::Random random(11);
+        byte * source = static_cast<byte *>(sourceSPtr->GetBuffer());
+        for (ULONG32 i = 0; i < size; i++)
+        {
+            source[i] = static_cast<byte>(random.Next());
+        }
+
+        ICompressionCodec::SPtr codecSPtr = CreateCodec();
+        KBuffer::SPtr destinationSPtr = CreateBuffer(size / 2);
+        ULONG32 compressedSize = codecSPtr->Compress(source, size, static_cast<byte *>(destinationSPtr->GetBuffer()), size / 2);
+        CODING_ERROR_ASSERT(compressedSize == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(LzCompressionCodec_CorruptInput_ShouldFailDecompress)
+    {
+        ULONG32 size = 8192;
+        KBuffer::SPtr sourceSPtr = CreateBuffer(size);
+        byte * source = static_cast<byte *>(sourceSPtr->GetBuffer());
+        for (ULONG32 i = 0; i < size; i++)
+        {
+            source[i] = static_cast<byte>(i % 251);
+        }
+
+        ICompressionCodec::SPtr codecSPtr = CreateCodec();
+        KBuffer::SPtr compressedSPtr = nullptr;
+        ULONG32 compressedSize = Compress(*codecSPtr, *sourceSPtr, compressedSPtr);
+        CODING_ERROR_ASSERT(compressedSize > 0);
+
+        KBuffer::SPtr decompressedSPtr = CreateBuffer(size);
+
+        // Truncated input.
+        NTSTATUS status = codecSPtr->Decompress(
+            static_cast<byte const *>(compressedSPtr->GetBuffer()),
+            compressedSize - 1,
+            static_cast<byte *>(decompressedSPtr->GetBuffer()),
+            size);
+        CODING_ERROR_ASSERT(status == STATUS_INTERNAL_DB_CORRUPTION);
+
+        // Wrong expected size.
+        status = codecSPtr->Decompress(
+            static_cast<byte const *>(compressedSPtr->GetBuffer()),
+            compressedSize,
+            static_cast<byte *>(decompressedSPtr->GetBuffer()),
+            size - 1);
+        CODING_ERROR_ASSERT(status == STATUS_INTERNAL_DB_CORRUPTION);
+    }
+
+    BOOST_AUTO_TEST_CASE(CompressionCodecFactory_UnknownCodec_ShouldNotBeSupported)
+    {
+        ICompressionCodec::SPtr codecSPtr = nullptr;
+        NTSTATUS status = CompressionCodecFactory::Create(CompressionCodecId::None, GetAllocator(), codecSPtr);
+        CODING_ERROR_ASSERT(status == STATUS_NOT_SUPPORTED);
+
+        status = CompressionCodecFactory::Create(static_cast<CompressionCodecId::Enum>(1000), GetAllocator(), codecSPtr);
+        CODING_ERROR_ASSERT(status == STATUS_NOT_SUPPORTED);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+}
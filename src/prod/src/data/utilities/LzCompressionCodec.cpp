@@ -0,0 +1,316 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+using namespace Data;
+using namespace Data::Utilities;
+
+LzCompressionCodec::LzCompressionCodec()
+{
+}
+
+LzCompressionCodec::~LzCompressionCodec()
+{
+}
+
+NTSTATUS LzCompressionCodec::Create(
+    __in KAllocator & allocator,
+    __out LzCompressionCodec::SPtr & result)
+{
+    result = _new(LZ_COMPRESSION_CODEC_TAG, allocator) LzCompressionCodec();
+
+    if (!result)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+ULONG32 LzCompressionCodec::GetMaxCompressedSize(__in ULONG32 sourceSize) const
+{
+    // Worst case is a single literal run: one token, one length byte per 255 literals and the literals themselves.
+    return sourceSize + (sourceSize / 255) + 16;
+}
+
+ULONG32 LzCompressionCodec::Compress(
+    __in_bcount(sourceSize) byte const * source,
+    __in ULONG32 sourceSize,
+    __out_bcount(destinationCapacity) byte * destination,
+    __in ULONG32 destinationCapacity) const
+{
+    // Positions are stored one based so that zero marks an empty slot.
+    ULONG32 hashTable[HashTableSize];
+    RtlZeroMemory(hashTable, sizeof(hashTable));
+
+    ULONG32 inputPosition = 0;
+    ULONG32 anchor = 0;
+    ULONG32 outputPosition = 0;
+
+    if (sourceSize >= MinMatchLength + LastLiteralsLength)
+    {
+        ULONG32 matchLimit = sourceSize - LastLiteralsLength;
+
+        while (inputPosition + MinMatchLength <= matchLimit)
+        {
+            ULONG32 sequence = ReadSequence(source + inputPosition);
+            ULONG32 hash = Hash(sequence);
+            ULONG32 candidate = hashTable[hash];
+            hashTable[hash] = inputPosition + 1;
+
+            if (candidate == 0 ||
+                inputPosition - (candidate - 1) > MaxMatchOffset ||
+                ReadSequence(source + candidate - 1) != sequence)
+            {
+                inputPosition++;
+                continue;
+            }
+
+            ULONG32 matchPosition = candidate - 1;
+            ULONG32 matchLength = MinMatchLength;
+            while (inputPosition + matchLength < matchLimit && source[matchPosition + matchLength] == source[inputPosition + matchLength])
+            {
+                matchLength++;
+            }
+
+            bool fits = TryWriteSequence(
+                outputPosition,
+                destination,
+                destinationCapacity,
+                source + anchor,
+                inputPosition - anchor,
+                inputPosition - matchPosition,
+                matchLength);
+
+            if (!fits)
+            {
+                return 0;
+            }
+
+            inputPosition += matchLength;
+            anchor = inputPosition;
+        }
+    }
+
+    // The remaining bytes are written as the final, literal only, sequence.
+    if (!TryWriteSequence(outputPosition, destination, destinationCapacity, source + anchor, sourceSize - anchor, 0, 0))
+    {
+        return 0;
+    }
+
+    return outputPosition;
+}
+
+NTSTATUS LzCompressionCodec::Decompress(
+    __in_bcount(sourceSize) byte const * source,
+    __in ULONG32 sourceSize,
+    __out_bcount(destinationSize) byte * destination,
+    __in ULONG32 destinationSize) const
+{
+    ULONG32 inputPosition = 0;
+    ULONG32 outputPosition = 0;
+
+    while (true)
+    {
+        if (inputPosition >= sourceSize)
+        {
+            return STATUS_INTERNAL_DB_CORRUPTION;
+        }
+
+        byte token = source[inputPosition++];
+
+        ULONG32 literalLength = token >> 4;
+        if (literalLength == 15 && !TryReadLength(inputPosition, source, sourceSize, literalLength))
+        {
+            return STATUS_INTERNAL_DB_CORRUPTION;
+        }
+
+        if (sourceSize - inputPosition < literalLength || destinationSize - outputPosition < literalLength)
+        {
+            return STATUS_INTERNAL_DB_CORRUPTION;
+        }
+
+        if (literalLength > 0)
+        {
+            memcpy(destination + outputPosition, source + inputPosition, literalLength);
+            inputPosition += literalLength;
+            outputPosition += literalLength;
+        }
+
+        if (inputPosition == sourceSize)
+        {
+            break;
+        }
+
+        if (sourceSize - inputPosition < 2)
+        {
+            return STATUS_INTERNAL_DB_CORRUPTION;
+        }
+
+        ULONG32 matchOffset = static_cast<ULONG32>(source[inputPosition]) | (static_cast<ULONG32>(source[inputPosition + 1]) << 8);
+        inputPosition += 2;
+
+        if (matchOffset == 0 || matchOffset > outputPosition)
+        {
+            return STATUS_INTERNAL_DB_CORRUPTION;
+        }
+
+        ULONG32 matchLength = token & 0x0F;
+        if (matchLength == 15 && !TryReadLength(inputPosition, source, sourceSize, matchLength))
+        {
+            return STATUS_INTERNAL_DB_CORRUPTION;
+        }
+
+        if (destinationSize - outputPosition < MinMatchLength || destinationSize - outputPosition - MinMatchLength < matchLength)
+        {
+            return STATUS_INTERNAL_DB_CORRUPTION;
+        }
+
+        matchLength += MinMatchLength;
+
+        // The match may overlap the bytes it produces, so it has to be copied forward one byte at a time.
+        byte const * match = destination + outputPosition - matchOffset;
+        for (ULONG32 i = 0; i < matchLength; i++)
+        {
+            destination[outputPosition + i] = match[i];
+        }
+
+        outputPosition += matchLength;
+    }
+
+    if (outputPosition != destinationSize)
+    {
+        return STATUS_INTERNAL_DB_CORRUPTION;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+ULONG32 LzCompressionCodec::Hash(__in ULONG32 sequence)
+{
+    return (sequence * 2654435761U) >> (32 - HashTableBits);
+}
+
+ULONG32 LzCompressionCodec::ReadSequence(__in byte const * position)
+{
+    ULONG32 sequence;
+    memcpy(&sequence, position, sizeof(sequence));
+    return sequence;
+}
+
+bool LzCompressionCodec::TryWriteLength(
+    __inout ULONG32 & outputPosition,
+    __out_bcount(destinationCapacity) byte * destination,
+    __in ULONG32 destinationCapacity,
+    __in ULONG32 length)
+{
+    while (length >= 255)
+    {
+        if (outputPosition >= destinationCapacity)
+        {
+            return false;
+        }
+
+        destination[outputPosition++] = 255;
+        length -= 255;
+    }
+
+    if (outputPosition >= destinationCapacity)
+    {
+        return false;
+    }
+
+    destination[outputPosition++] = static_cast<byte>(length);
+    return true;
+}
+
+bool LzCompressionCodec::TryWriteSequence(
+    __inout ULONG32 & outputPosition,
+    __out_bcount(destinationCapacity) byte * destination,
+    __in ULONG32 destinationCapacity,
+    __in_bcount(literalLength) byte const * literals,
+    __in ULONG32 literalLength,
+    __in ULONG32 matchOffset,
+    __in ULONG32 matchLength)
+{
+    ULONG32 literalNibble = literalLength >= 15 ? 15 : literalLength;
+    ULONG32 matchNibble = 0;
+    if (matchLength > 0)
+    {
+        ASSERT_IFNOT(matchLength >= MinMatchLength, "Match length {0} is smaller than the minimum match length", matchLength);
+        ASSERT_IFNOT(matchOffset > 0 && matchOffset <= MaxMatchOffset, "Invalid match offset {0}", matchOffset);
+        matchNibble = (matchLength - MinMatchLength) >= 15 ? 15 : (matchLength - MinMatchLength);
+    }
+
+    if (outputPosition >= destinationCapacity)
+    {
+        return false;
+    }
+
+    destination[outputPosition++] = static_cast<byte>((literalNibble << 4) | matchNibble);
+
+    if (literalNibble == 15 && !TryWriteLength(outputPosition, destination, destinationCapacity, literalLength - 15))
+    {
+        return false;
+    }
+
+    if (destinationCapacity - outputPosition < literalLength)
+    {
+        return false;
+    }
+
+    if (literalLength > 0)
+    {
+        memcpy(destination + outputPosition, literals, literalLength);
+        outputPosition += literalLength;
+    }
+
+    if (matchLength == 0)
+    {
+        return true;
+    }
+
+    if (destinationCapacity - outputPosition < 2)
+    {
+        return false;
+    }
+
+    destination[outputPosition++] = static_cast<byte>(matchOffset & 0xFF);
+    destination[outputPosition++] = static_cast<byte>(matchOffset >> 8);
+
+    if (matchNibble == 15 && !TryWriteLength(outputPosition, destination, destinationCapacity, matchLength - MinMatchLength - 15))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool LzCompressionCodec::TryReadLength(
+    __inout ULONG32 & inputPosition,
+    __in_bcount(sourceSize) byte const * source,
+    __in ULONG32 sourceSize,
+    __inout ULONG32 & length)
+{
+    while (inputPosition < sourceSize)
+    {
+        // Callers bound the length by the output size, this only keeps the sum from overflowing.
+        if (length > MAXULONG32 - 255)
+        {
+            return false;
+        }
+
+        byte value = source[inputPosition++];
+        length += value;
+
+        if (value != 255)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
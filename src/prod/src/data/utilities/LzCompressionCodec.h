@@ -0,0 +1,97 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+#define LZ_COMPRESSION_CODEC_TAG 'cmZL'
+
+namespace Data
+{
+    namespace Utilities
+    {
+        //
+        // Byte oriented LZ77 codec tuned for speed over ratio.
+        //
+        // The compressed stream is a sequence of
+        //
+        //  Token           byte        1           high nibble: literal length, low nibble: match length - MinMatchLength
+        //  LiteralLength   byte[]      0..n        present if the literal nibble is 15; 255 continues, anything else ends
+        //  Literals        byte[]      LiteralLength
+        //  MatchOffset     ushort      2           distance back from the current output position
+        //  MatchLength     byte[]      0..n        present if the match nibble is 15; same encoding as LiteralLength
+        //
+        // The last sequence always carries only literals and ends the stream.
+        //
+        class LzCompressionCodec
+            : public ICompressionCodec
+            , public KObject<LzCompressionCodec>
+            , public KShared<LzCompressionCodec>
+        {
+            K_FORCE_SHARED(LzCompressionCodec)
+            K_SHARED_INTERFACE_IMP(ICompressionCodec)
+
+        public:
+
+            static NTSTATUS Create(
+                __in KAllocator & allocator,
+                __out LzCompressionCodec::SPtr & result);
+
+            CompressionCodecId::Enum get_Id() const override
+            {
+                return CompressionCodecId::Lz;
+            }
+
+            ULONG32 GetMaxCompressedSize(__in ULONG32 sourceSize) const override;
+
+            ULONG32 Compress(
+                __in_bcount(sourceSize) byte const * source,
+                __in ULONG32 sourceSize,
+                __out_bcount(destinationCapacity) byte * destination,
+                __in ULONG32 destinationCapacity) const override;
+
+            NTSTATUS Decompress(
+                __in_bcount(sourceSize) byte const * source,
+                __in ULONG32 sourceSize,
+                __out_bcount(destinationSize) byte * destination,
+                __in ULONG32 destinationSize) const override;
+
+        private:
+
+            static const ULONG32 MinMatchLength = 4;
+            static const ULONG32 MaxMatchOffset = 65535;
+
+            // Matches may not extend into the last bytes of the input, so that the tail is always emitted as literals.
+            static const ULONG32 LastLiteralsLength = 5;
+
+            static const ULONG32 HashTableBits = 12;
+            static const ULONG32 HashTableSize = 1 << HashTableBits;
+
+            static ULONG32 Hash(__in ULONG32 sequence);
+
+            static ULONG32 ReadSequence(__in byte const * position);
+
+            static bool TryWriteLength(
+                __inout ULONG32 & outputPosition,
+                __out_bcount(destinationCapacity) byte * destination,
+                __in ULONG32 destinationCapacity,
+                __in ULONG32 length);
+
+            static bool TryWriteSequence(
+                __inout ULONG32 & outputPosition,
+                __out_bcount(destinationCapacity) byte * destination,
+                __in ULONG32 destinationCapacity,
+                __in_bcount(literalLength) byte const * literals,
+                __in ULONG32 literalLength,
+                __in ULONG32 matchOffset,
+                __in ULONG32 matchLength);
+
+            static bool TryReadLength(
+                __inout ULONG32 & inputPosition,
+                __in_bcount(sourceSize) byte const * source,
+                __in ULONG32 sourceSize,
+                __inout ULONG32 & length);
+        };
+    }
+}
@@ -0,0 +1,157 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+#include <boost/test/unit_test.hpp>
+#include "Common/boost-taef.h"
+
+namespace UtilitiesTests
+{
+    using namespace ktl;
+    using namespace Data::Utilities;
+
+    #define SLAB_ALLOCATOR_PERF_TAG 'fpAS'
+
+    // Roughly the size of an OperationLogRecord
+    class PerfObject
+        : public KObject<PerfObject>
+        , public KShared<PerfObject>
+    {
+        K_FORCE_SHARED(PerfObject)
+
+    public:
+        static SPtr Create(__in KAllocator & allocator)
+        {
+            SPtr result = _new(SLAB_ALLOCATOR_PERF_TAG, allocator) PerfObject();
+            CODING_ERROR_ASSERT(result != nullptr);
+            return result;
+        }
+
+    private:
+        byte payload_[256];
+    };
+
+    PerfObject::PerfObject()
+    {
+    }
+
+    PerfObject::~PerfObject()
+    {
+    }
+
+    class SlabAllocatorPerfTest
+    {
+    public:
+        Common::CommonConfig config; // load the config object as it's needed for the tracing to work
+
+        SlabAllocatorPerfTest()
+        {
+            NTSTATUS status;
+            status = KtlSystem::Initialize(FALSE, &ktlSystem_);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            ktlSystem_->SetStrictAllocationChecks(TRUE);
+        }
+
+        ~SlabAllocatorPerfTest()
+        {
+            ktlSystem_->Shutdown();
+        }
+
+        KAllocator& GetAllocator()
+        {
+            return ktlSystem_->PagedAllocator();
+        }
+
+        //
+        // Allocates objects from the given allocator on threadCount threads, keeping the last windowSize objects of each thread alive
+        // the way the log keeps records alive until they are truncated, and prints the allocation rate.
+        //
+        void AllocationRatePerfTest(
+            __in KAllocator & allocator,
+            __in char const * name,
+            __in int threadCount,
+            __in ULONG32 windowSize,
+            __in ULONG64 allocationsPerThread)
+        {
+            Common::atomic_long completedCount(0);
+
+            Common::Stopwatch stopwatch;
+            stopwatch.Start();
+
+            for (int t = 0; t < threadCount; t++)
+            {
+                Common::Threadpool::Post([&]
+                {
+                    KArray<PerfObject::SPtr> window(GetAllocator(), windowSize);
+                    for (ULONG32 i = 0; i < windowSize; i++)
+                    {
+                        NTSTATUS status = window.Append(nullptr);
+                        CODING_ERROR_ASSERT(NT_SUCCESS(status));
+                    }
+
+                    for (ULONG64 i = 0; i < allocationsPerThread; i++)
+                    {
+                        window[static_cast<ULONG32>(i % windowSize)] = PerfObject::Create(allocator);
+                    }
+
+                    ++completedCount;
+                });
+            }
+
+            while (completedCount.load() < threadCount)
+            {
+                Sleep(10);
+            }
+
+            stopwatch.Stop();
+
+            LONG64 duration = stopwatch.ElapsedMilliseconds == 0 ? 1 : stopwatch.ElapsedMilliseconds;
+            ULONG64 allocationsPerSecond = (allocationsPerThread * threadCount * 1000) / duration;
+
+            cout << Common::formatString(
+                "{0}: Threads: {1} Window: {2} Allocations: {3} Duration: {4} ms Rate: {5} allocations/s",
+                name,
+                threadCount,
+                windowSize,
+                allocationsPerThread * threadCount,
+                stopwatch.ElapsedMilliseconds,
+                allocationsPerSecond) << endl;
+        }
+
+        void CompareAllocationRate(
+            __in int threadCount,
+            __in ULONG32 windowSize,
+            __in ULONG64 allocationsPerThread)
+        {
+            AllocationRatePerfTest(GetAllocator(), "Backing allocator", threadCount, windowSize, allocationsPerThread);
+
+            SlabAllocator::SPtr slabAllocatorSPtr = nullptr;
+            NTSTATUS status = SlabAllocator::Create(MAXULONG64, GetAllocator(), slabAllocatorSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+
+            AllocationRatePerfTest(*slabAllocatorSPtr, "Slab allocator", threadCount, windowSize, allocationsPerThread);
+
+            cout << Common::formatString("Slabs: {0} Fallbacks: {1}", slabAllocatorSPtr->SlabCount, slabAllocatorSPtr->FallbackCount) << endl;
+        }
+
+    private:
+        KtlSystem* ktlSystem_;
+    };
+
+    BOOST_FIXTURE_TEST_SUITE(SlabAllocatorPerfTestSuite, SlabAllocatorPerfTest);
+
+    BOOST_AUTO_TEST_CASE(Perf_SlabAllocator_AllocationRate_SingleThread)
+    {
+        CompareAllocationRate(1, 1024, 10 * 1000 * 1000);
+    }
+
+    BOOST_AUTO_TEST_CASE(Perf_SlabAllocator_AllocationRate_MultiThread)
+    {
+        CompareAllocationRate(8, 1024, 2 * 1000 * 1000);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+}
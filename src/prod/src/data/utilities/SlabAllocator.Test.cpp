@@ -0,0 +1,326 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+#include <boost/test/unit_test.hpp>
+#include "Common/boost-taef.h"
+
+namespace UtilitiesTests
+{
+    using namespace ktl;
+    using namespace Data;
+    using namespace Data::Utilities;
+
+    #define SLAB_ALLOCATOR_TEST_TAG 'tsAS'
+
+    //
+    // Object whose stamp is overwritten when it is destructed, so a block that is reused while still referenced shows up as a changed stamp
+    //
+    template<ULONG32 PayloadSize>
+    class StampedObject
+        : public KObject<StampedObject<PayloadSize>>
+        , public KShared<StampedObject<PayloadSize>>
+    {
+        K_FORCE_SHARED(StampedObject)
+
+    public:
+        static SPtr Create(
+            __in ULONG64 stamp,
+            __in KAllocator & allocator)
+        {
+            SPtr result = _new(SLAB_ALLOCATOR_TEST_TAG, allocator) StampedObject(stamp);
+            CODING_ERROR_ASSERT(result != nullptr);
+            return result;
+        }
+
+        ULONG64 get_Stamp() const
+        {
+            return stamp_;
+        }
+
+        bool IsValid() const
+        {
+            return check_ == ~stamp_ && payload_[0] == static_cast<byte>(stamp_) && payload_[PayloadSize - 1] == static_cast<byte>(stamp_);
+        }
+
+    private:
+        StampedObject(__in ULONG64 stamp)
+            : stamp_(stamp)
+            , check_(~stamp)
+        {
+            memset(payload_, static_cast<byte>(stamp), PayloadSize);
+        }
+
+        ULONG64 stamp_;
+        ULONG64 check_;
+        byte payload_[PayloadSize];
+    };
+
+    template<ULONG32 PayloadSize>
+    StampedObject<PayloadSize>::~StampedObject()
+    {
+        stamp_ = 0;
+        check_ = 0;
+        memset(payload_, 0xDD, PayloadSize);
+    }
+
+    typedef StampedObject<100> SmallObject;
+    typedef StampedObject<2000> LargeObject;
+
+    class SlabAllocatorTest
+    {
+    public:
+        Common::CommonConfig config; // load the config object as its needed for the tracing to work
+
+        SlabAllocatorTest()
+        {
+            NTSTATUS status;
+            status = KtlSystem::Initialize(FALSE, &ktlSystem_);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            ktlSystem_->SetStrictAllocationChecks(TRUE);
+        }
+
+        ~SlabAllocatorTest()
+        {
+            ktlSystem_->Shutdown();
+        }
+
+        KAllocator& GetAllocator()
+        {
+            return ktlSystem_->NonPagedAllocator();
+        }
+
+        SlabAllocator::SPtr CreateSlabAllocator(__in ULONG64 maxSlabBytes)
+        {
+            SlabAllocator::SPtr slabAllocatorSPtr = nullptr;
+            NTSTATUS status = SlabAllocator::Create(maxSlabBytes, GetAllocator(), slabAllocatorSPtr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+            return slabAllocatorSPtr;
+        }
+
+    private:
+        KtlSystem* ktlSystem_;
+    };
+
+    BOOST_FIXTURE_TEST_SUITE(SlabAllocatorTestSuite, SlabAllocatorTest)
+
+    BOOST_AUTO_TEST_CASE(SlabAllocator_SmallObjects_ShouldBeServedFromSlabsAndRecycled)
+    {
+        SlabAllocator::SPtr slabAllocatorSPtr = CreateSlabAllocator(MAXULONG64);
+
+        KArray<SmallObject::SPtr> objects(GetAllocator());
+        for (ULONG64 i = 0; i < 100; i++)
+        {
+            NTSTATUS status = objects.Append(SmallObject::Create(i, *slabAllocatorSPtr));
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+        }
+
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->SlabCount == 1);
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->FallbackCount == 0);
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->OutstandingCount == 100);
+
+        for (ULONG32 i = 0; i < objects.Count(); i++)
+        {
+            CODING_ERROR_ASSERT(objects[i]->get_Stamp() == i);
+            CODING_ERROR_ASSERT(objects[i]->IsValid());
+            CODING_ERROR_ASSERT(&objects[i]->GetThisAllocator() == slabAllocatorSPtr.RawPtr());
+        }
+
+        objects.Clear();
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->OutstandingCount == 0);
+
+        // Freed blocks are reused before another slab is taken
+        for (ULONG64 i = 0; i < 100; i++)
+        {
+            NTSTATUS status = objects.Append(SmallObject::Create(i, *slabAllocatorSPtr));
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+        }
+
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->SlabCount == 1);
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->OutstandingCount == 100);
+    }
+
+    BOOST_AUTO_TEST_CASE(SlabAllocator_LargeObjects_ShouldFallBack)
+    {
+        SlabAllocator::SPtr slabAllocatorSPtr = CreateSlabAllocator(MAXULONG64);
+
+        LargeObject::SPtr largeObject = LargeObject::Create(7, *slabAllocatorSPtr);
+        CODING_ERROR_ASSERT(largeObject->IsValid());
+
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->SlabCount == 0);
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->FallbackCount == 1);
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->OutstandingCount == 1);
+
+        largeObject = nullptr;
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->OutstandingCount == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(SlabAllocator_MaxSlabBytes_ShouldFallBack)
+    {
+        SlabAllocator::SPtr slabAllocatorSPtr = CreateSlabAllocator(SlabAllocator::SlabSize);
+
+        KArray<SmallObject::SPtr> objects(GetAllocator());
+        for (ULONG64 i = 0; i < 2000; i++)
+        {
+            NTSTATUS status = objects.Append(SmallObject::Create(i, *slabAllocatorSPtr));
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+        }
+
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->SlabCount == 1);
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->FallbackCount > 0);
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->OutstandingCount == 2000);
+
+        for (ULONG32 i = 0; i < objects.Count(); i++)
+        {
+            CODING_ERROR_ASSERT(objects[i]->get_Stamp() == i);
+            CODING_ERROR_ASSERT(objects[i]->IsValid());
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(SlabAllocator_ObjectsOutliveOwner_ShouldKeepAllocatorAlive)
+    {
+        SlabAllocator::SPtr slabAllocatorSPtr = CreateSlabAllocator(MAXULONG64);
+
+        SmallObject::SPtr smallObject = SmallObject::Create(1, *slabAllocatorSPtr);
+        LargeObject::SPtr largeObject = LargeObject::Create(2, *slabAllocatorSPtr);
+
+        slabAllocatorSPtr = nullptr;
+
+        CODING_ERROR_ASSERT(smallObject->IsValid());
+        CODING_ERROR_ASSERT(largeObject->IsValid());
+
+        // The last free destructs the allocator. Strict allocation checks at shutdown catch anything that is leaked
+        smallObject = nullptr;
+        largeObject = nullptr;
+    }
+
+    //
+    // Writers keep allocating and releasing objects while readers take references to them out of shared slots.
+    // A reader checks the stamp again after giving the writers time to free and reallocate, so a block that is
+    // handed out again while a reference is still held fails the check.
+    //
+    BOOST_AUTO_TEST_CASE(SlabAllocator_Stress_ShouldNotReuseReferencedBlocks)
+    {
+        const int writerCount = 4;
+        const int readerCount = 4;
+        const ULONG32 slotCount = 64;
+        const ULONG64 allocationsPerWriter = 200000;
+
+        SlabAllocator::SPtr slabAllocatorSPtr = CreateSlabAllocator(16 * SlabAllocator::SlabSize);
+
+        KSpinLock slotsLock;
+        KArray<SmallObject::SPtr> slots(GetAllocator(), slotCount);
+        for (ULONG32 i = 0; i < slotCount; i++)
+        {
+            NTSTATUS status = slots.Append(nullptr);
+            CODING_ERROR_ASSERT(NT_SUCCESS(status));
+        }
+
+        Common::atomic_long writersRunning(writerCount);
+        Common::atomic_long completedCount(0);
+        Common::atomic_long failureCount(0);
+
+        for (int w = 0; w < writerCount; w++)
+        {
+            Common::Threadpool::Post([&, w]
+            {
+                Common::Random random(w);
+
+                for (ULONG64 i = 0; i < allocationsPerWriter; i++)
+                {
+                    SmallObject::SPtr object = SmallObject::Create((static_cast<ULONG64>(w) << 32) | i, *slabAllocatorSPtr);
+                    ULONG32 slot = static_cast<ULONG32>(random.Next(static_cast<int>(slotCount)));
+
+                    // The previous occupant of the slot is released outside the lock, possibly freeing its block
+                    SmallObject::SPtr previous = nullptr;
+
+                    K_LOCK_BLOCK(slotsLock)
+                    {
+                        previous = Ktl::Move(slots[slot]);
+                        slots[slot] = Ktl::Move(object);
+                    }
+
+                    if (previous != nullptr && !previous->IsValid())
+                    {
+                        ++failureCount;
+                    }
+                }
+
+                --writersRunning;
+                ++completedCount;
+            });
+        }
+
+        for (int r = 0; r < readerCount; r++)
+        {
+            Common::Threadpool::Post([&, r]
+            {
+                Common::Random random(writerCount + r);
+
+                while (writersRunning.load() > 0)
+                {
+                    ULONG32 slot = static_cast<ULONG32>(random.Next(static_cast<int>(slotCount)));
+                    SmallObject::SPtr object = nullptr;
+
+                    K_LOCK_BLOCK(slotsLock)
+                    {
+                        object = slots[slot];
+                    }
+
+                    if (object == nullptr)
+                    {
+                        continue;
+                    }
+
+                    ULONG64 stamp = object->get_Stamp();
+                    if (!object->IsValid())
+                    {
+                        ++failureCount;
+                    }
+
+                    Sleep(0);
+
+                    if (object->get_Stamp() != stamp || !object->IsValid())
+                    {
+                        ++failureCount;
+                    }
+                }
+
+                ++completedCount;
+            });
+        }
+
+        while (completedCount.load() < writerCount + readerCount)
+        {
+            Sleep(100);
+        }
+
+        VERIFY_ARE_EQUAL(failureCount.load(), 0);
+
+        LONG64 liveCount = 0;
+        for (ULONG32 i = 0; i < slotCount; i++)
+        {
+            if (slots[i] != nullptr)
+            {
+                liveCount++;
+                CODING_ERROR_ASSERT(slots[i]->IsValid());
+
+                // Every object is put in one slot only, so two slots sharing an address means a block was handed out twice
+                for (ULONG32 j = i + 1; j < slotCount; j++)
+                {
+                    CODING_ERROR_ASSERT(slots[i].RawPtr() != slots[j].RawPtr());
+                }
+            }
+        }
+
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->OutstandingCount == liveCount);
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->SlabCount <= 16);
+
+        slots.Clear();
+        CODING_ERROR_ASSERT(slabAllocatorSPtr->OutstandingCount == 0);
+    }
+
+    BOOST_AUTO_TEST_SUITE_END()
+}
@@ -0,0 +1,273 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#include "stdafx.h"
+
+using namespace Data;
+using namespace Data::Utilities;
+
+// Sizes include the KAllocatorSupport preamble, so the smallest class fits an empty KShared object
+const ULONG32 SlabAllocator::SizeClasses[SlabAllocator::SizeClassCount] = { 64, 128, 192, 256, 384, 512, 768, 1024 };
+
+SlabAllocator::SlabAllocator(
+    __in ULONG64 maxSlabBytes,
+    __in KAllocator & backingAllocator)
+    : backingAllocator_(backingAllocator)
+    , maxSlabBytes_(maxSlabBytes)
+    , slabsLock_()
+    , slabs_(nullptr)
+    , slabCount_(0)
+    , fallbackCount_(0)
+    , outstandingCount_(0)
+{
+    for (ULONG32 i = 0; i < SizeClassCount; i++)
+    {
+        for (ULONG32 j = 0; j < FreeListShardCount; j++)
+        {
+            freeLists_[i][j].Head = nullptr;
+        }
+    }
+}
+
+SlabAllocator::~SlabAllocator()
+{
+    ASSERT_IFNOT(outstandingCount_ == 0, "SlabAllocator destructed with {0} outstanding blocks", outstandingCount_);
+
+    BlockHeader * slab = slabs_;
+    while (slab != nullptr)
+    {
+        BlockHeader * next = slab->Next;
+        backingAllocator_.Free(slab);
+        slab = next;
+    }
+}
+
+NTSTATUS SlabAllocator::Create(
+    __in ULONG64 maxSlabBytes,
+    __in KAllocator & backingAllocator,
+    __out SlabAllocator::SPtr & result)
+{
+    result = _new(SLAB_ALLOCATOR_TAG, backingAllocator) SlabAllocator(maxSlabBytes, backingAllocator);
+
+    if (!result)
+    {
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+PVOID SlabAllocator::Alloc(__in size_t size)
+{
+    return AllocWithTag(size, SLAB_ALLOCATOR_TAG);
+}
+
+PVOID SlabAllocator::AllocWithTag(
+    __in size_t size,
+    __in ULONG tag)
+{
+    ULONG32 sizeClass = GetSizeClass(size);
+
+    if (sizeClass == FallbackSizeClass)
+    {
+        return AllocateFallback(size, tag);
+    }
+
+    ULONG32 shard = GetCurrentShard();
+    BlockHeader * block = PopFreeBlock(sizeClass, shard);
+
+    if (block == nullptr)
+    {
+        block = AllocateFromSlab(sizeClass, shard, tag);
+
+        if (block == nullptr)
+        {
+            return AllocateFallback(size, tag);
+        }
+    }
+
+    block->SizeClass = sizeClass;
+
+    AddRef();
+    InterlockedIncrement64(&outstandingCount_);
+
+    return block + 1;
+}
+
+VOID SlabAllocator::Free(__in PVOID mem)
+{
+    BlockHeader * block = static_cast<BlockHeader *>(mem) - 1;
+    ULONG32 sizeClass = block->SizeClass;
+
+    if (sizeClass == FallbackSizeClass)
+    {
+        backingAllocator_.Free(block);
+    }
+    else
+    {
+        ASSERT_IFNOT(sizeClass < SizeClassCount, "Freeing a block with invalid size class {0}", sizeClass);
+
+        PushFreeBlocks(sizeClass, GetCurrentShard(), block, block);
+    }
+
+    InterlockedDecrement64(&outstandingCount_);
+
+    // May destruct this allocator if the owner has already released it
+    Release();
+}
+
+KtlSystem & SlabAllocator::GetKtlSystem()
+{
+    return backingAllocator_.GetKtlSystem();
+}
+
+ULONGLONG SlabAllocator::GetAllocsRemaining()
+{
+    return backingAllocator_.GetAllocsRemaining();
+}
+
+#if KTL_USER_MODE
+#if DBG
+ULONGLONG SlabAllocator::GetTotalAllocations()
+{
+    return backingAllocator_.GetTotalAllocations();
+}
+#endif
+#endif
+
+ULONG32 SlabAllocator::GetSizeClass(__in size_t size)
+{
+    for (ULONG32 i = 0; i < SizeClassCount; i++)
+    {
+        if (size <= SizeClasses[i])
+        {
+            return i;
+        }
+    }
+
+    return FallbackSizeClass;
+}
+
+ULONG32 SlabAllocator::GetCurrentShard()
+{
+    return GetCurrentProcessorNumber() % FreeListShardCount;
+}
+
+// Takes a block from the free list of the given shard, or from another shard of the size class if that one is empty
+SlabAllocator::BlockHeader * SlabAllocator::PopFreeBlock(
+    __in ULONG32 sizeClass,
+    __in ULONG32 shard)
+{
+    for (ULONG32 i = 0; i < FreeListShardCount; i++)
+    {
+        FreeList & freeList = freeLists_[sizeClass][(shard + i) % FreeListShardCount];
+
+        // Empty lists of other shards are skipped without taking their lock
+        if (i > 0 && freeList.Head == nullptr)
+        {
+            continue;
+        }
+
+        BlockHeader * block = nullptr;
+
+        freeList.Lock.Acquire();
+        block = freeList.Head;
+        if (block != nullptr)
+        {
+            freeList.Head = block->Next;
+        }
+        freeList.Lock.Release();
+
+        if (block != nullptr)
+        {
+            return block;
+        }
+    }
+
+    return nullptr;
+}
+
+// Pushes a chain of blocks linked from first to last onto the free list of the given shard
+void SlabAllocator::PushFreeBlocks(
+    __in ULONG32 sizeClass,
+    __in ULONG32 shard,
+    __in BlockHeader * first,
+    __in BlockHeader * last)
+{
+    FreeList & freeList = freeLists_[sizeClass][shard];
+
+    freeList.Lock.Acquire();
+    last->Next = freeList.Head;
+    freeList.Head = first;
+    freeList.Lock.Release();
+}
+
+SlabAllocator::BlockHeader * SlabAllocator::AllocateFromSlab(
+    __in ULONG32 sizeClass,
+    __in ULONG32 shard,
+    __in ULONG tag)
+{
+    if (static_cast<ULONG64>(slabCount_ + 1) * SlabSize > maxSlabBytes_)
+    {
+        return nullptr;
+    }
+
+    BlockHeader * slab = static_cast<BlockHeader *>(backingAllocator_.AllocWithTag(SlabSize, tag));
+    if (slab == nullptr)
+    {
+        return nullptr;
+    }
+
+    InterlockedIncrement64(&slabCount_);
+
+    slabsLock_.Acquire();
+    slab->Next = slabs_;
+    slabs_ = slab;
+    slabsLock_.Release();
+
+    // The first header links the slab, the rest of it is carved into blocks of this size class.
+    // The first block is returned to the caller and the others are chained and pushed onto the free list of the shard in one step.
+    ULONG32 stride = sizeof(BlockHeader) + SizeClasses[sizeClass];
+    ULONG32 blockCount = (SlabSize - sizeof(BlockHeader)) / stride;
+
+    byte * start = reinterpret_cast<byte *>(slab + 1);
+    BlockHeader * first = reinterpret_cast<BlockHeader *>(start);
+
+    if (blockCount == 1)
+    {
+        return first;
+    }
+
+    BlockHeader * second = reinterpret_cast<BlockHeader *>(start + stride);
+    BlockHeader * last = reinterpret_cast<BlockHeader *>(start + ((blockCount - 1) * stride));
+
+    for (ULONG32 i = 1; i < blockCount - 1; i++)
+    {
+        reinterpret_cast<BlockHeader *>(start + (i * stride))->Next = reinterpret_cast<BlockHeader *>(start + ((i + 1) * stride));
+    }
+
+    PushFreeBlocks(sizeClass, shard, second, last);
+
+    return first;
+}
+
+PVOID SlabAllocator::AllocateFallback(
+    __in size_t size,
+    __in ULONG tag)
+{
+    BlockHeader * block = static_cast<BlockHeader *>(backingAllocator_.AllocWithTag(size + sizeof(BlockHeader), tag));
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+
+    block->SizeClass = FallbackSizeClass;
+
+    AddRef();
+    InterlockedIncrement64(&fallbackCount_);
+    InterlockedIncrement64(&outstandingCount_);
+
+    return block + 1;
+}
@@ -0,0 +1,134 @@
+// ------------------------------------------------------------
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT License (MIT). See License.txt in the repo root for license information.
+// ------------------------------------------------------------
+
+#pragma once
+
+#define SLAB_ALLOCATOR_TAG 'alSU'
+
+namespace Data
+{
+    namespace Utilities
+    {
+        //
+        // KAllocator that serves small, frequently allocated objects from fixed size blocks carved out of 64KB slabs.
+        //
+        // Each block is preceded by a 16 byte header that records its size class, so Free needs no lookup:
+        //
+        //  Slab            SlabSize bytes from the backing allocator, linked through its first 16 bytes
+        //  Block           BlockHeader | payload of the size class
+        //
+        // Freed blocks go back to a free list of their size class and are reused by the next allocation of that class; slabs
+        // are only returned to the backing allocator when the SlabAllocator is destructed.
+        // Each size class has FreeListShardCount free lists, each with its own lock, and a thread uses the one of the processor it runs on.
+        // An allocation only takes blocks from the other shards before carving a new slab, so threads on different processors
+        // rarely contend on the same lock.
+        // Requests larger than the largest size class, or made once MaxSlabBytes are in use, go to the backing allocator.
+        //
+        // Every outstanding block holds a reference on the SlabAllocator, so it lives until the last object allocated from it is freed.
+        // A block can only be reused once KAllocatorSupport::Free has been called on it, i.e. after the last reference to the object is gone.
+        //
+        class SlabAllocator final
+            : public KAllocator
+            , public KObject<SlabAllocator>
+            , public KShared<SlabAllocator>
+        {
+            K_FORCE_SHARED(SlabAllocator)
+
+        public:
+            static const ULONG32 SlabSize = 64 * 1024;
+            static const ULONG32 SizeClassCount = 8;
+            static const ULONG32 MaxBlockSize = 1024;
+            static const ULONG32 FreeListShardCount = 16;
+
+            static NTSTATUS Create(
+                __in ULONG64 maxSlabBytes,
+                __in KAllocator & backingAllocator,
+                __out SlabAllocator::SPtr & result);
+
+            PVOID Alloc(__in size_t size) override;
+            PVOID AllocWithTag(__in size_t size, __in ULONG tag) override;
+            VOID Free(__in PVOID mem) override;
+            KtlSystem & GetKtlSystem() override;
+            ULONGLONG GetAllocsRemaining() override;
+
+#if KTL_USER_MODE
+#if DBG
+            ULONGLONG GetTotalAllocations() override;
+#endif
+#endif
+
+            // Number of slabs taken from the backing allocator
+            __declspec(property(get = get_SlabCount)) LONG64 SlabCount;
+            LONG64 get_SlabCount() const
+            {
+                return slabCount_;
+            }
+
+            // Number of allocations that were passed through to the backing allocator
+            __declspec(property(get = get_FallbackCount)) LONG64 FallbackCount;
+            LONG64 get_FallbackCount() const
+            {
+                return fallbackCount_;
+            }
+
+            // Number of blocks, pooled or passed through, that have not been freed yet
+            __declspec(property(get = get_OutstandingCount)) LONG64 OutstandingCount;
+            LONG64 get_OutstandingCount() const
+            {
+                return outstandingCount_;
+            }
+
+        private:
+            struct BlockHeader
+            {
+                union
+                {
+                    BlockHeader * Next;     // While the block is on a free list
+                    ULONG32 SizeClass;      // While the block is allocated. FallbackSizeClass for pass through allocations
+                };
+
+                void * Reserved;            // Keeps the payload 16 byte aligned
+            };
+
+            static_assert(sizeof(BlockHeader) == 16, "BlockHeader size not correct");
+
+            // A free list of one size class, padded so the locks of different shards do not share a cache line
+            struct FreeList
+            {
+                KSpinLock Lock;
+                BlockHeader * volatile Head;
+                byte Padding[64 - ((sizeof(KSpinLock) + sizeof(BlockHeader *)) % 64)];
+            };
+
+            static const ULONG32 FallbackSizeClass = MAXULONG32;
+            static const ULONG32 SizeClasses[SizeClassCount];
+
+            static ULONG32 GetSizeClass(__in size_t size);
+            static ULONG32 GetCurrentShard();
+
+            SlabAllocator(
+                __in ULONG64 maxSlabBytes,
+                __in KAllocator & backingAllocator);
+
+            BlockHeader * PopFreeBlock(__in ULONG32 sizeClass, __in ULONG32 shard);
+            void PushFreeBlocks(__in ULONG32 sizeClass, __in ULONG32 shard, __in BlockHeader * first, __in BlockHeader * last);
+            BlockHeader * AllocateFromSlab(__in ULONG32 sizeClass, __in ULONG32 shard, __in ULONG tag);
+            PVOID AllocateFallback(__in size_t size, __in ULONG tag);
+
+            KAllocator & backingAllocator_;
+            ULONG64 const maxSlabBytes_;
+
+            FreeList freeLists_[SizeClassCount][FreeListShardCount];
+
+            // Slabs are linked through their first BlockHeader and protected by slabsLock_
+            KSpinLock slabsLock_;
+            BlockHeader * slabs_;
+
+            volatile LONG64 slabCount_;
+            volatile LONG64 fallbackCount_;
+            volatile LONG64 outstandingCount_;
+        };
+    }
+}